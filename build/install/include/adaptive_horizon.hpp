@@ -0,0 +1,147 @@
+// Adaptive horizon for the MPT reference points
+#ifndef PATH_OPTIMIZER__ADAPTIVE_HORIZON_HPP_
+#define PATH_OPTIMIZER__ADAPTIVE_HORIZON_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+struct AdaptiveHorizonParam
+{
+  bool enable{false};
+
+  // Horizon length = ego velocity * horizon_time, clamped to [min_length, max_length]
+  double horizon_time{6.0};
+  double min_length{30.0};
+  double max_length{150.0};
+
+  // Point spacing: near_interval up to near_length, then growing linearly to far_interval at the
+  // end of the horizon
+  double near_length{15.0};
+  double near_interval{0.5};
+  double far_interval{2.0};
+
+  // Bounds of the number of reference points chosen by the latency control
+  size_t min_points{30};
+  size_t max_points{150};
+
+  // Target QP solve time per cycle
+  double solve_time_budget_ms{10.0};
+};
+
+/**
+ * AdaptiveHorizon: arc lengths of the MPT reference points from ego velocity and latency budget
+ *
+ * The QP has (N_ref - 1) * D_u inputs, and its solve time grows superlinearly with N_ref. Instead
+ * of a fixed number of points at a fixed interval, the horizon follows the velocity and the points
+ * are dense near ego and sparse far ahead; the state equation takes the spacing of every point
+ * from ReferencePoint::delta_arc_length, so the spacing may vary along the path.
+ *
+ * The number of points is limited by a point budget that is adapted to the measured solve time:
+ * above the budget it is reduced right away assuming solve time ~ N^1.5, well below it grows back
+ * slowly. The budget only stretches the far spacing; the near field up to near_length always keeps
+ * near_interval, so near-field accuracy does not depend on the load.
+ *
+ *   horizon.calcArcLengths(ego_velocity, path_length, sample_s);
+ *   resampler.resample(traj_points, sample_s, resampled);   // -> reference points
+ *   ... solve ...
+ *   horizon.update(solve_time_ms, ref_points.size());
+ */
+class AdaptiveHorizon
+{
+public:
+  explicit AdaptiveHorizon(const AdaptiveHorizonParam & param = AdaptiveHorizonParam{})
+  : param_(param), point_limit_(static_cast<double>(param.max_points))
+  {
+  }
+
+  const AdaptiveHorizonParam & getParam() const { return param_; }
+
+  double calcHorizonLength(const double ego_velocity, const double path_length) const
+  {
+    const double length = std::clamp(
+      std::abs(ego_velocity) * param_.horizon_time, param_.min_length, param_.max_length);
+    return std::min(length, path_length);
+  }
+
+  /**
+   * @brief Increasing arc lengths of the reference points from the path start (0 and the horizon
+   * end included)
+   * @param sample_s overwritten, keeps its capacity across calls
+   */
+  void calcArcLengths(
+    const double ego_velocity, const double path_length, std::vector<double> & sample_s) const
+  {
+    sample_s.clear();
+    const double length = calcHorizonLength(ego_velocity, path_length);
+    if (!(length > 0.0)) {
+      sample_s.push_back(0.0);
+      return;
+    }
+
+    const double near_interval = std::max(param_.near_interval, 1e-3);
+    const double near_length = std::min(param_.near_length, length);
+    const double far_length = length - near_length;
+    const auto num_near = static_cast<size_t>(std::ceil(near_length / near_interval));
+
+    // Far part: m steps growing linearly from near_interval, ds_k = a + (b - a) * (k + 1) / m for
+    // k = 0 .. m - 1, which sum up to far_length for b = a + 2 * (far_length - m * a) / (m + 1).
+    // m follows from far_interval and is limited by the point budget.
+    const double a = near_interval;
+    const double b_max = std::max(param_.far_interval, a);
+    size_t m = static_cast<size_t>(std::ceil(2.0 * far_length / (a + b_max)));
+    const double remaining = point_limit_ - static_cast<double>(num_near) - 1.0;
+    m = std::min(m, static_cast<size_t>(std::max(remaining, 1.0)));
+    m = std::min(m, static_cast<size_t>(std::max(far_length / a, 1.0)));
+
+    for (size_t i = 0; i < num_near; ++i) {
+      sample_s.push_back(static_cast<double>(i) * a);
+    }
+    if (far_length > 0.0) {
+      const double b = a + 2.0 * (far_length - static_cast<double>(m) * a) / (m + 1.0);
+      double s = near_length;
+      for (size_t k = 0; k + 1 < m; ++k) {
+        sample_s.push_back(s);
+        s += a + (b - a) * (k + 1.0) / static_cast<double>(m);
+      }
+      sample_s.push_back(s);
+    }
+    sample_s.push_back(length);
+  }
+
+  /**
+   * @brief Adapts the point budget to the solve time of the last cycle
+   * @param num_points number of reference points of that cycle
+   */
+  void update(const double solve_time_ms, const size_t num_points)
+  {
+    const double budget = param_.solve_time_budget_ms;
+    if (!(solve_time_ms > 0.0) || num_points == 0 || !(budget > 0.0)) {
+      return;
+    }
+    const auto n = static_cast<double>(num_points);
+    if (solve_time_ms > budget) {
+      // solve time ~ N^1.5, with some margin below the budget
+      point_limit_ = std::min(point_limit_, n * std::pow(0.9 * budget / solve_time_ms, 1.0 / 1.5));
+    } else if (solve_time_ms < 0.7 * budget) {
+      point_limit_ += std::max(1.0, 0.05 * point_limit_);
+    }
+    point_limit_ = std::clamp(
+      point_limit_, static_cast<double>(param_.min_points), static_cast<double>(param_.max_points));
+  }
+
+  // Current maximum number of reference points
+  size_t getPointLimit() const { return static_cast<size_t>(point_limit_); }
+
+private:
+  AdaptiveHorizonParam param_;
+  double point_limit_;
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__ADAPTIVE_HORIZON_HPP_
@@ -0,0 +1,178 @@
+// Debug hook for heap allocations in the planning cycle
+#ifndef PATH_OPTIMIZER__ALLOCATION_GUARD_HPP_
+#define PATH_OPTIMIZER__ALLOCATION_GUARD_HPP_
+
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+#include <Eigen/Core>
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * AllocationGuard: counts (or aborts on) heap allocations of the current thread while in scope
+ *
+ * Meant for the allocation-free steady state: after the warm-up cycles, the planning cycle is run
+ * inside a guard, and any allocation is a buffer that was not sized at startup.
+ *
+ *   for (size_t cycle = 0;; ++cycle) {
+ *     AllocationGuard guard(cycle < warm_up_cycles ? AllocationGuard::Mode::Off
+ *                                                  : AllocationGuard::Mode::Count);
+ *     planningCycle();
+ *     if (guard.allocations() > 0) { ... }
+ *   }
+ *
+ * The counting operator new/delete replacements are only compiled where
+ * PATH_OPTIMIZER_ALLOCATION_GUARD_IMPLEMENTATION is defined before including this header, which
+ * must be exactly one translation unit of a debug build. Without it the guard counts nothing. The
+ * check is one thread local load per allocation, so release builds should not define it.
+ *
+ * Eigen allocates with malloc, not operator new. If EIGEN_RUNTIME_NO_MALLOC is defined, Mode::Abort
+ * also disables Eigen heap allocation (Eigen asserts on it) for the scope of the guard.
+ */
+class AllocationGuard
+{
+public:
+  enum class Mode : uint8_t { Off, Count, Abort };
+
+  explicit AllocationGuard(const Mode mode = Mode::Count)
+  : previous_mode_(state().mode), previous_count_(state().count)
+  {
+    state().mode = mode;
+    state().count = 0;
+    setEigenMallocAllowed(mode != Mode::Abort);
+  }
+
+  AllocationGuard(const AllocationGuard &) = delete;
+  AllocationGuard & operator=(const AllocationGuard &) = delete;
+
+  ~AllocationGuard()
+  {
+    // Allocations of a nested scope also count for the enclosing one
+    const uint64_t count = state().count;
+    state().mode = previous_mode_;
+    state().count = previous_count_ + count;
+    setEigenMallocAllowed(previous_mode_ != Mode::Abort);
+    total_.fetch_add(count, std::memory_order_relaxed);
+  }
+
+  // Allocations of this thread since the guard was created
+  uint64_t allocations() const { return state().count; }
+
+  // Allocations inside all guards that have been destroyed, over all threads
+  static uint64_t totalAllocations() { return total_.load(std::memory_order_relaxed); }
+
+  // Called by the operator new replacement only
+  static void onAllocation(const size_t size);
+
+private:
+  struct State
+  {
+    Mode mode{Mode::Off};
+    uint64_t count{0};
+  };
+
+  static State & state()
+  {
+    thread_local State s;
+    return s;
+  }
+
+  static void setEigenMallocAllowed([[maybe_unused]] const bool allowed)
+  {
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+    Eigen::internal::set_is_malloc_allowed(allowed);
+#endif
+  }
+
+  Mode previous_mode_;
+  uint64_t previous_count_;
+  static inline std::atomic<uint64_t> total_{0};
+};
+
+}  // namespace autoware::path_optimizer
+
+#ifdef PATH_OPTIMIZER_ALLOCATION_GUARD_IMPLEMENTATION
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+void autoware::path_optimizer::AllocationGuard::onAllocation(const size_t size)
+{
+  State & s = state();
+  if (s.mode == Mode::Off) {
+    return;
+  }
+  ++s.count;
+  if (s.mode == Mode::Abort) {
+    s.mode = Mode::Off;  // fprintf may allocate
+    std::fprintf(stderr, "AllocationGuard: heap allocation of %zu bytes in guarded scope\n", size);
+    std::abort();
+  }
+}
+
+namespace autoware::path_optimizer::allocation_guard_detail
+{
+inline void * allocate(const std::size_t size)
+{
+  AllocationGuard::onAllocation(size);
+  return std::malloc(size == 0 ? 1 : size);
+}
+}  // namespace autoware::path_optimizer::allocation_guard_detail
+
+// noinline: inlined into callers of this translation unit, GCC reports the malloc/free pairs as
+// mismatched new/delete
+[[gnu::noinline]] void * operator new(const std::size_t size)
+{
+  if (void * p = autoware::path_optimizer::allocation_guard_detail::allocate(size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void * operator new[](const std::size_t size)
+{
+  if (void * p = autoware::path_optimizer::allocation_guard_detail::allocate(size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void * operator new(const std::size_t size, const std::nothrow_t &) noexcept
+{
+  return autoware::path_optimizer::allocation_guard_detail::allocate(size);
+}
+
+[[gnu::noinline]] void * operator new[](const std::size_t size, const std::nothrow_t &) noexcept
+{
+  return autoware::path_optimizer::allocation_guard_detail::allocate(size);
+}
+
+[[gnu::noinline]] void operator delete(void * p) noexcept
+{
+  std::free(p);
+}
+
+[[gnu::noinline]] void operator delete[](void * p) noexcept
+{
+  std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void * p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+[[gnu::noinline]] void operator delete[](void * p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+#endif  // PATH_OPTIMIZER_ALLOCATION_GUARD_IMPLEMENTATION
+
+#endif  // PATH_OPTIMIZER__ALLOCATION_GUARD_HPP_
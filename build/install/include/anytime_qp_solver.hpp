@@ -0,0 +1,187 @@
+// Deadline-bounded QP solve with fallback for the MPT cycle
+#ifndef PATH_OPTIMIZER__ANYTIME_QP_SOLVER_HPP_
+#define PATH_OPTIMIZER__ANYTIME_QP_SOLVER_HPP_
+
+#include "instrumentation.hpp"
+#include "qp_solver_backend.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+struct AnytimeQPSolverParam
+{
+  // Time from startCycle() until the solve has to return
+  double cycle_budget_ms{50.0};
+  int max_iter{4000};
+  // Largest violation of l <= A x <= u for which a limited (not converged) solution is used
+  double feasibility_tolerance{1e-3};
+};
+
+enum class AnytimeSolveOutcome {
+  SOLVED,    // Converged
+  ACCEPTED,  // Stopped at the budget, but within the feasibility tolerance
+  FALLBACK,  // Stopped or failed, the shifted previous solution is used
+  FAILED,    // Stopped or failed without a previous solution
+};
+
+/**
+ * AnytimeQPSolver: runs the MPT QP within what is left of the cycle budget
+ *
+ * The backend gets the remaining time as its limit (OSQP time_limit / max_iter), so a hard
+ * problem cannot stall the path optimizer and the downstream stages. A solution that did not
+ * converge is still used if it is primal feasible within the tolerance; otherwise the previous
+ * solution shifted onto the current reference points (WarmStartShifter) is returned instead.
+ *
+ *   anytime_solver.startCycle();                  // at the start of optimize()
+ *   ...
+ *   backend.setProblem(P, A, q, l, u);
+ *   const auto outcome = anytime_solver.solve(backend, A, l, u, shifted_prev_solution, result);
+ *
+ * The outcomes are counted (getCounts()) and exported as "mpt.solve.<outcome>" counters and the
+ * "mpt.solve.time_us" histogram through Instrumentation.
+ */
+class AnytimeQPSolver
+{
+public:
+  struct Counts
+  {
+    uint64_t solved{0};
+    uint64_t accepted{0};
+    uint64_t fallback{0};
+    uint64_t failed{0};
+  };
+
+  explicit AnytimeQPSolver(const AnytimeQPSolverParam & param = AnytimeQPSolverParam{})
+  : param_(param)
+  {
+  }
+
+  void setParam(const AnytimeQPSolverParam & param) { param_ = param; }
+  const AnytimeQPSolverParam & getParam() const { return param_; }
+
+  void startCycle() { cycle_start_ = std::chrono::steady_clock::now(); }
+
+  double getRemainingTimeMs() const
+  {
+    const auto elapsed = std::chrono::steady_clock::now() - cycle_start_;
+    return param_.cycle_budget_ms - std::chrono::duration<double, std::milli>(elapsed).count();
+  }
+
+  /**
+   * @brief Solves the problem set on backend within the remaining budget
+   * @param A, l, u constraints of that problem, for the feasibility check
+   * @param fallback_primal shifted previous solution in the same variables (may be empty)
+   * @param result solver result, or the fallback as primal for FALLBACK
+   */
+  AnytimeSolveOutcome solve(
+    QPSolverBackend & backend, const CSC_Matrix & A, const std::vector<double> & l,
+    const std::vector<double> & u, const std::vector<double> & fallback_primal, QPResult & result)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    const double remaining_ms = getRemainingTimeMs();
+    AnytimeSolveOutcome outcome = AnytimeSolveOutcome::FAILED;
+    if (remaining_ms > 0.0) {
+      backend.setSolveLimits(remaining_ms * 1e-3, param_.max_iter);
+      result = backend.solve();
+      if (result.is_solved) {
+        outcome = AnytimeSolveOutcome::SOLVED;
+      } else if (calcConstraintViolation(A, result.primal, l, u) <= param_.feasibility_tolerance) {
+        outcome = AnytimeSolveOutcome::ACCEPTED;
+      }
+    } else {
+      result = QPResult{};  // budget used up before the solve, e.g. by the matrix build
+    }
+
+    if (outcome == AnytimeSolveOutcome::FAILED && !fallback_primal.empty()) {
+      if (fallback_primal.size() + 1 == A.m_col_idxs.size()) {
+        result.primal = fallback_primal;
+        result.dual.clear();
+        outcome = AnytimeSolveOutcome::FALLBACK;
+      }
+    }
+
+    const auto time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+    record(outcome, time_us.count());
+    return outcome;
+  }
+
+  Counts getCounts() const
+  {
+    Counts counts;
+    counts.solved = solved_.load(std::memory_order_relaxed);
+    counts.accepted = accepted_.load(std::memory_order_relaxed);
+    counts.fallback = fallback_.load(std::memory_order_relaxed);
+    counts.failed = failed_.load(std::memory_order_relaxed);
+    return counts;
+  }
+
+  // max(l - A x, A x - u, 0) over all rows, infinity if x does not match A
+  static double calcConstraintViolation(
+    const CSC_Matrix & A, const std::vector<double> & x, const std::vector<double> & l,
+    const std::vector<double> & u)
+  {
+    if (x.empty() || x.size() + 1 != A.m_col_idxs.size() || l.size() != u.size()) {
+      return INFINITY;
+    }
+    thread_local std::vector<double> Ax;
+    Ax.assign(l.size(), 0.0);
+    for (size_t col = 0; col < x.size(); ++col) {
+      for (auto k = A.m_col_idxs[col]; k < A.m_col_idxs[col + 1]; ++k) {
+        const auto row = static_cast<size_t>(A.m_row_idxs[k]);
+        if (row >= Ax.size()) {
+          return INFINITY;
+        }
+        Ax[row] += A.m_vals[k] * x[col];
+      }
+    }
+    double violation = 0.0;
+    for (size_t row = 0; row < Ax.size(); ++row) {
+      violation = std::max({violation, l[row] - Ax[row], Ax[row] - u[row]});
+    }
+    return violation;
+  }
+
+private:
+  void record(const AnytimeSolveOutcome outcome, const int64_t time_us)
+  {
+    auto & instrumentation = Instrumentation::instance();
+    switch (outcome) {
+      case AnytimeSolveOutcome::SOLVED:
+        solved_.fetch_add(1, std::memory_order_relaxed);
+        instrumentation.count("mpt.solve.solved");
+        break;
+      case AnytimeSolveOutcome::ACCEPTED:
+        accepted_.fetch_add(1, std::memory_order_relaxed);
+        instrumentation.count("mpt.solve.accepted");
+        break;
+      case AnytimeSolveOutcome::FALLBACK:
+        fallback_.fetch_add(1, std::memory_order_relaxed);
+        instrumentation.count("mpt.solve.fallback");
+        break;
+      case AnytimeSolveOutcome::FAILED:
+        failed_.fetch_add(1, std::memory_order_relaxed);
+        instrumentation.count("mpt.solve.failed");
+        break;
+    }
+    instrumentation.observe("mpt.solve.time_us", time_us);
+  }
+
+  AnytimeQPSolverParam param_;
+  std::chrono::steady_clock::time_point cycle_start_{std::chrono::steady_clock::now()};
+  std::atomic<uint64_t> solved_{0};
+  std::atomic<uint64_t> accepted_{0};
+  std::atomic<uint64_t> fallback_{0};
+  std::atomic<uint64_t> failed_{0};
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__ANYTIME_QP_SOLVER_HPP_
@@ -0,0 +1,137 @@
+// Fixed capacity, trivially copyable point sequences for the trajectory ports
+#ifndef PATH_OPTIMIZER__BOUNDED_TRAJECTORY_HPP_
+#define PATH_OPTIMIZER__BOUNDED_TRAJECTORY_HPP_
+
+#include "path_optimizer_types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * BoundedSequence: at most Capacity elements in place, plus their count
+ *
+ * Replaces the variable length point sequences of the port data types. The object has a fixed
+ * size and no pointers, so for trivially copyable elements it is itself trivially copyable: it
+ * can be constructed directly in a shared memory chunk and sent as one blob, and neither side
+ * allocates. Elements beyond size() are left as they are (not cleared) to keep clear() O(1).
+ *
+ * Filling it never overflows: assign() and push_back() stop at the capacity and report whether
+ * everything fit, so a producer can log the truncation instead of corrupting the message.
+ */
+template <typename T, size_t Capacity>
+class BoundedSequence
+{
+  static_assert(std::is_trivially_copyable_v<T>, "elements must be trivially copyable");
+  static_assert(Capacity > 0 && Capacity <= UINT32_MAX, "capacity out of range");
+
+public:
+  using value_type = T;
+  using iterator = T *;
+  using const_iterator = const T *;
+
+  static constexpr size_t capacity() { return Capacity; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  bool full() const { return size_ == Capacity; }
+
+  T & operator[](const size_t i) { return data_[i]; }
+  const T & operator[](const size_t i) const { return data_[i]; }
+  T & front() { return data_[0]; }
+  const T & front() const { return data_[0]; }
+  T & back() { return data_[size_ - 1]; }
+  const T & back() const { return data_[size_ - 1]; }
+  T * data() { return data_.data(); }
+  const T * data() const { return data_.data(); }
+
+  iterator begin() { return data_.data(); }
+  iterator end() { return data_.data() + size_; }
+  const_iterator begin() const { return data_.data(); }
+  const_iterator end() const { return data_.data() + size_; }
+
+  void clear() { size_ = 0; }
+
+  // false (and nothing added) if the sequence is full
+  bool push_back(const T & value)
+  {
+    if (full()) {
+      return false;
+    }
+    data_[size_++] = value;
+    return true;
+  }
+
+  // Grows with value initialized elements or shrinks; false if n was clamped to the capacity
+  bool resize(const size_t n)
+  {
+    const size_t clamped = n < Capacity ? n : Capacity;
+    for (size_t i = size_; i < clamped; ++i) {
+      data_[i] = T{};
+    }
+    size_ = static_cast<uint32_t>(clamped);
+    return clamped == n;
+  }
+
+  // Copies the first capacity() elements of [first, last); false if the range was truncated
+  template <typename It>
+  bool assign(It first, const It last)
+  {
+    size_ = 0;
+    for (; first != last && size_ < Capacity; ++first) {
+      data_[size_++] = *first;
+    }
+    return first == last;
+  }
+  bool assign(const std::vector<T> & values) { return assign(values.begin(), values.end()); }
+
+  std::vector<T> toVector() const { return std::vector<T>(begin(), end()); }
+  // Capacity preserving, for consumers that keep working on std::vector
+  void toVector(std::vector<T> & values) const { values.assign(begin(), end()); }
+
+private:
+  uint32_t size_{0};
+  std::array<T, Capacity> data_;
+};
+
+// Number of points needed for a horizon of length_m sampled every interval_m (both ends included)
+constexpr size_t calcBoundedCapacity(const double length_m, const double interval_m)
+{
+  const double n = length_m / interval_m;
+  const auto whole = static_cast<size_t>(n);
+  return (static_cast<double>(whole) < n ? whole + 1 : whole) + 1;
+}
+
+/**
+ * Capacities of the trajectory ports, from the horizon limits of the producing stages
+ *
+ * BVP -> EBS and EBS -> PO carry the behavior path, up to 300 m ahead and 10 m behind the ego at
+ * 0.5 m. PO -> MVP and MVP -> OCP carry the optimized trajectory over the same horizon at up to
+ * 0.25 m. A stage configured for a longer horizon or a finer interval has to resample before
+ * publishing.
+ */
+constexpr size_t bounded_path_capacity = calcBoundedCapacity(310.0, 0.5);        // 621
+constexpr size_t bounded_trajectory_capacity = calcBoundedCapacity(310.0, 0.25);  // 1241
+
+// Port payloads: the point sequence and the stamp of the input it was planned from
+template <size_t Capacity>
+struct BoundedTrajectoryT
+{
+  int64_t stamp_ns{0};
+  BoundedSequence<TrajectoryPoint, Capacity> points;
+};
+
+using BoundedPathTrajectory = BoundedTrajectoryT<bounded_path_capacity>;  // bvp2ebs, ebs2po
+using BoundedTrajectory = BoundedTrajectoryT<bounded_trajectory_capacity>;  // po2mvp, mvp2ocp
+
+static_assert(
+  std::is_trivially_copyable_v<BoundedTrajectory>,
+  "port payloads are sent as blobs, they must stay trivially copyable");
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__BOUNDED_TRAJECTORY_HPP_
@@ -0,0 +1,150 @@
+// Lateral drivable bounds of the MPT reference points
+#ifndef PATH_OPTIMIZER__BOUNDS_CALCULATOR_HPP_
+#define PATH_OPTIMIZER__BOUNDS_CALCULATOR_HPP_
+
+#include "path_optimizer_types.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * BoundsCalculator: lateral distance from reference points to the left and right bound
+ *
+ * The bound of a query point c with heading t is where the normal line through c crosses the
+ * bound polyline: the segment [b_i, b_i+1] with (b_i - c).t <= 0 < (b_i+1 - c).t. Reference
+ * points are ordered along the path like the bound vertices, so that segment is found with one
+ * cursor per polyline that only moves forward (and steps back by a few segments at most in tight
+ * curves): all queries together cost O(points + vertices) instead of a search per point.
+ * Outside the polyline the first or last segment is extended.
+ *
+ * For the vehicle circles the centers are computed for one circle offset at a time in flat arrays
+ * (vectorizable), and every circle gets its own sweep. Bounds::upper_bound is the distance to the
+ * left bound (positive to the left), lower_bound the one to the right bound.
+ */
+class BoundsCalculator
+{
+public:
+  // Bounds at the reference point poses; with begin > 0 only the points from begin on are
+  // computed and the bounds before it are left as they are (reused from the previous cycle)
+  void calcBounds(
+    const std::vector<ReferencePoint> & ref_points, const std::vector<Point> & left_bound,
+    const std::vector<Point> & right_bound, std::vector<Bounds> & bounds, const size_t begin = 0)
+  {
+    setQueries(ref_points, 0.0, begin);
+    bounds.resize(ref_points.size());
+    sweep(left_bound, lateral_);
+    for (size_t i = 0; i < lateral_.size(); ++i) {
+      bounds[begin + i].upper_bound = lateral_[i];
+    }
+    sweep(right_bound, lateral_);
+    for (size_t i = 0; i < lateral_.size(); ++i) {
+      bounds[begin + i].lower_bound = lateral_[i];
+    }
+  }
+
+  /**
+   * @brief Bounds of the vehicle circles, written to bounds_on_constraints of every reference point
+   *
+   * The circle poses (pose_on_constraints) are only needed for debug output and are filled by
+   * calcPosesOnConstraints (reference_point_fields.hpp) when requested.
+   * @param circle_offsets longitudinal offsets of the circle centers from the reference point
+   * @param begin first point to compute, as for calcBounds
+   */
+  void calcBoundsOnCircles(
+    std::vector<ReferencePoint> & ref_points, const std::vector<Point> & left_bound,
+    const std::vector<Point> & right_bound, const std::vector<double> & circle_offsets,
+    const size_t begin = 0)
+  {
+    for (size_t i = std::min(begin, ref_points.size()); i < ref_points.size(); ++i) {
+      ref_points[i].bounds_on_constraints.resize(circle_offsets.size());
+    }
+    for (size_t j = 0; j < circle_offsets.size(); ++j) {
+      setQueries(ref_points, circle_offsets[j], begin);
+      sweep(left_bound, lateral_);
+      for (size_t i = 0; i < lateral_.size(); ++i) {
+        ref_points[begin + i].bounds_on_constraints[j].upper_bound = lateral_[i];
+      }
+      sweep(right_bound, lateral_);
+      for (size_t i = 0; i < lateral_.size(); ++i) {
+        ref_points[begin + i].bounds_on_constraints[j].lower_bound = lateral_[i];
+      }
+    }
+  }
+
+private:
+  static double calcYaw(const Quaternion & q)
+  {
+    return std::atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+  }
+
+  // Query points offset along the heading, and the heading as unit vector, for the points from
+  // begin on (query i is point begin + i)
+  void setQueries(
+    const std::vector<ReferencePoint> & ref_points, const double offset, const size_t begin)
+  {
+    const size_t first = std::min(begin, ref_points.size());
+    const size_t n = ref_points.size() - first;
+    tx_.resize(n);
+    ty_.resize(n);
+    cx_.resize(n);
+    cy_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      const double yaw = calcYaw(ref_points[first + i].pose.orientation);
+      tx_[i] = std::cos(yaw);
+      ty_[i] = std::sin(yaw);
+    }
+    for (size_t i = 0; i < n; ++i) {
+      cx_[i] = ref_points[first + i].pose.position.x + offset * tx_[i];
+      cy_[i] = ref_points[first + i].pose.position.y + offset * ty_[i];
+    }
+  }
+
+  // Longitudinal coordinate of bound vertex k relative to query i
+  double along(const std::vector<Point> & bound, const size_t k, const size_t i) const
+  {
+    return (bound[k].x - cx_[i]) * tx_[i] + (bound[k].y - cy_[i]) * ty_[i];
+  }
+
+  void sweep(const std::vector<Point> & bound, std::vector<double> & lateral) const
+  {
+    const size_t n = cx_.size();
+    lateral.assign(n, 0.0);
+    if (bound.size() < 2) {
+      return;
+    }
+    const size_t last_seg = bound.size() - 2;
+    size_t seg = 0;
+    for (size_t i = 0; i < n; ++i) {
+      while (seg > 0 && along(bound, seg, i) > 0.0) {
+        --seg;
+      }
+      while (seg < last_seg && along(bound, seg + 1, i) <= 0.0) {
+        ++seg;
+      }
+
+      // Crossing of the normal line with the (extended) segment
+      const double f0 = along(bound, seg, i);
+      const double f1 = along(bound, seg + 1, i);
+      const double df = f1 - f0;
+      const double ratio = std::abs(df) > 1e-9 ? -f0 / df : 0.0;
+      const double qx = bound[seg].x + ratio * (bound[seg + 1].x - bound[seg].x);
+      const double qy = bound[seg].y + ratio * (bound[seg + 1].y - bound[seg].y);
+      lateral[i] = -(qx - cx_[i]) * ty_[i] + (qy - cy_[i]) * tx_[i];
+    }
+  }
+
+  std::vector<double> tx_;  // Heading of the queries
+  std::vector<double> ty_;
+  std::vector<double> cx_;  // Query positions
+  std::vector<double> cy_;
+  std::vector<double> lateral_;
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__BOUNDS_CALCULATOR_HPP_
@@ -0,0 +1,285 @@
+// Quantized trajectory encoding for links between machines
+#ifndef PATH_OPTIMIZER__COMPACT_TRAJECTORY_HPP_
+#define PATH_OPTIMIZER__COMPACT_TRAJECTORY_HPP_
+
+#include "path_optimizer_types.hpp"
+#include "trajectory_soa.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * Compact trajectory message: one header, then one column per field (little endian)
+ *
+ *   header : magic "TRAJCMP1" (8 bytes), stamp_ns (int64), num_points (uint32),
+ *            origin x, y, z (float64, the first point)
+ *   columns: x, y, z            int32, 1 mm, relative to the origin
+ *            yaw                int16, 2 pi / 65536
+ *            longitudinal_velocity_mps  int16, 0.01 m/s, difference to the previous point
+ *            lateral_velocity_mps, acceleration_mps2  int16, 0.01 m/s (m/s^2)
+ *            heading_rate_rps, front_wheel_angle_rad, rear_wheel_angle_rad  int16, 1e-4 rad(/s)
+ *            time_from_start    int32, 1 us
+ *
+ * 30 bytes per point instead of the 13 doubles (and the duration) of a TrajectoryPoint. The
+ * difference coding of the velocity is done on the quantized values, so it does not drift.
+ * Orientation is reduced to the yaw angle: decoded points are planar. Values outside of the
+ * range of their column saturate.
+ */
+constexpr char compact_trajectory_magic[8] = {'T', 'R', 'A', 'J', 'C', 'M', 'P', '1'};
+constexpr size_t compact_trajectory_header_size = 8 + sizeof(int64_t) + sizeof(uint32_t) + 24;
+constexpr size_t compact_trajectory_point_size = 3 * 4 + 7 * 2 + 4;
+
+namespace compact_trajectory
+{
+constexpr double position_resolution = 1e-3;
+constexpr double yaw_resolution = 2.0 * M_PI / 65536.0;
+constexpr double velocity_resolution = 1e-2;
+constexpr double angle_resolution = 1e-4;
+constexpr double time_resolution = 1e-6;
+
+template <typename IntT>
+IntT quantize(const double value, const double resolution)
+{
+  const double q = std::round(value / resolution);
+  return static_cast<IntT>(std::clamp(
+    q, static_cast<double>(std::numeric_limits<IntT>::min()),
+    static_cast<double>(std::numeric_limits<IntT>::max())));
+}
+
+inline double yawOf(const Quaternion & q)
+{
+  return std::atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+}
+}  // namespace compact_trajectory
+
+/**
+ * @brief Encodes the points into out (resized, capacity is kept)
+ * @return the message size in bytes
+ */
+inline size_t encodeCompactTrajectory(
+  const int64_t stamp_ns, const std::vector<TrajectoryPoint> & points, std::vector<uint8_t> & out)
+{
+  using compact_trajectory::quantize;
+  namespace ct = compact_trajectory;
+  const auto n = static_cast<uint32_t>(points.size());
+  out.resize(compact_trajectory_header_size + n * compact_trajectory_point_size);
+  uint8_t * cursor = out.data();
+  auto put = [&cursor](const auto value) {
+    std::memcpy(cursor, &value, sizeof(value));
+    cursor += sizeof(value);
+  };
+  std::memcpy(cursor, compact_trajectory_magic, sizeof(compact_trajectory_magic));
+  cursor += sizeof(compact_trajectory_magic);
+  put(stamp_ns);
+  put(n);
+  const Point origin = n > 0 ? points.front().pose.position : Point{};
+  put(origin.x);
+  put(origin.y);
+  put(origin.z);
+  for (const auto & p : points) {
+    put(quantize<int32_t>(p.pose.position.x - origin.x, ct::position_resolution));
+  }
+  for (const auto & p : points) {
+    put(quantize<int32_t>(p.pose.position.y - origin.y, ct::position_resolution));
+  }
+  for (const auto & p : points) {
+    put(quantize<int32_t>(p.pose.position.z - origin.z, ct::position_resolution));
+  }
+  for (const auto & p : points) {
+    put(quantize<int16_t>(ct::yawOf(p.pose.orientation), ct::yaw_resolution));
+  }
+  int32_t prev_velocity = 0;
+  for (const auto & p : points) {
+    const auto v = quantize<int32_t>(p.longitudinal_velocity_mps, ct::velocity_resolution);
+    const auto delta = static_cast<int16_t>(std::clamp<int32_t>(
+      v - prev_velocity, std::numeric_limits<int16_t>::min(), std::numeric_limits<int16_t>::max()));
+    put(delta);
+    prev_velocity += delta;
+  }
+  for (const auto & p : points) {
+    put(quantize<int16_t>(p.lateral_velocity_mps, ct::velocity_resolution));
+  }
+  for (const auto & p : points) {
+    put(quantize<int16_t>(p.acceleration_mps2, ct::velocity_resolution));
+  }
+  for (const auto & p : points) {
+    put(quantize<int16_t>(p.heading_rate_rps, ct::angle_resolution));
+  }
+  for (const auto & p : points) {
+    put(quantize<int16_t>(p.front_wheel_angle_rad, ct::angle_resolution));
+  }
+  for (const auto & p : points) {
+    put(quantize<int16_t>(p.rear_wheel_angle_rad, ct::angle_resolution));
+  }
+  for (const auto & p : points) {
+    const double t = p.time_from_start.sec + p.time_from_start.nanosec * 1e-9;
+    put(quantize<int32_t>(t, ct::time_resolution));
+  }
+  return out.size();
+}
+
+/**
+ * CompactTrajectoryView: reads a compact trajectory message in place
+ *
+ * parse() only checks the header and the size; the fields are decoded on access, so a receiver
+ * that needs the positions (or the points near the ego) does not decode the whole trajectory.
+ * The buffer has to outlive the view.
+ */
+class CompactTrajectoryView
+{
+public:
+  // false if the buffer is not a complete compact trajectory message
+  bool parse(const uint8_t * data, const size_t size)
+  {
+    data_ = nullptr;
+    n_ = 0;
+    if (
+      size < compact_trajectory_header_size ||
+      std::memcmp(data, compact_trajectory_magic, sizeof(compact_trajectory_magic)) != 0) {
+      return false;
+    }
+    const uint8_t * cursor = data + sizeof(compact_trajectory_magic);
+    get(cursor, stamp_ns_);
+    uint32_t n = 0;
+    get(cursor, n);
+    get(cursor, origin_.x);
+    get(cursor, origin_.y);
+    get(cursor, origin_.z);
+    if (size != compact_trajectory_header_size + size_t(n) * compact_trajectory_point_size) {
+      return false;
+    }
+    data_ = data;
+    n_ = n;
+    size_t offset = compact_trajectory_header_size;
+    for (size_t c = 0; c < num_columns; ++c) {
+      offsets_[c] = offset;
+      offset += column_widths[c] * n_;
+    }
+    return true;
+  }
+  bool parse(const std::vector<uint8_t> & buffer) { return parse(buffer.data(), buffer.size()); }
+
+  size_t size() const { return n_; }
+  int64_t getStamp() const { return stamp_ns_; }
+
+  double getX(const size_t i) const
+  {
+    return origin_.x + column<int32_t>(0, i) * compact_trajectory::position_resolution;
+  }
+  double getY(const size_t i) const
+  {
+    return origin_.y + column<int32_t>(1, i) * compact_trajectory::position_resolution;
+  }
+  double getZ(const size_t i) const
+  {
+    return origin_.z + column<int32_t>(2, i) * compact_trajectory::position_resolution;
+  }
+  double getYaw(const size_t i) const
+  {
+    return column<int16_t>(3, i) * compact_trajectory::yaw_resolution;
+  }
+
+  // The velocity is difference coded: decodes all of them, out is resized (capacity is kept)
+  template <typename Vector>
+  void decodeVelocities(Vector & out) const
+  {
+    out.resize(n_);
+    int32_t v = 0;
+    for (size_t i = 0; i < n_; ++i) {
+      v += column<int16_t>(4, i);
+      out[i] = v * compact_trajectory::velocity_resolution;
+    }
+  }
+
+  void decode(TrajectorySoA & out) const
+  {
+    namespace ct = compact_trajectory;
+    out.resize(n_);
+    for (size_t i = 0; i < n_; ++i) {
+      out.x[i] = getX(i);
+      out.y[i] = getY(i);
+      out.z[i] = getZ(i);
+      const double yaw = getYaw(i);
+      out.qx[i] = 0.0;
+      out.qy[i] = 0.0;
+      out.qz[i] = std::sin(0.5 * yaw);
+      out.qw[i] = std::cos(0.5 * yaw);
+    }
+    decodeVelocities(out.longitudinal_velocity_mps);
+    for (size_t i = 0; i < n_; ++i) {
+      out.lateral_velocity_mps[i] = column<int16_t>(5, i) * ct::velocity_resolution;
+      out.acceleration_mps2[i] = column<int16_t>(6, i) * ct::velocity_resolution;
+      out.heading_rate_rps[i] = column<int16_t>(7, i) * ct::angle_resolution;
+      out.front_wheel_angle_rad[i] = column<int16_t>(8, i) * ct::angle_resolution;
+      out.rear_wheel_angle_rad[i] = column<int16_t>(9, i) * ct::angle_resolution;
+      out.time_from_start_ns[i] = static_cast<int64_t>(column<int32_t>(10, i)) * 1000;
+    }
+  }
+
+  void decode(std::vector<TrajectoryPoint> & out) const
+  {
+    namespace ct = compact_trajectory;
+    out.resize(n_);
+    int32_t v = 0;
+    for (size_t i = 0; i < n_; ++i) {
+      auto & p = out[i];
+      p.pose.position.x = getX(i);
+      p.pose.position.y = getY(i);
+      p.pose.position.z = getZ(i);
+      const double yaw = getYaw(i);
+      p.pose.orientation.x = 0.0;
+      p.pose.orientation.y = 0.0;
+      p.pose.orientation.z = std::sin(0.5 * yaw);
+      p.pose.orientation.w = std::cos(0.5 * yaw);
+      v += column<int16_t>(4, i);
+      p.longitudinal_velocity_mps = v * ct::velocity_resolution;
+      p.lateral_velocity_mps = column<int16_t>(5, i) * ct::velocity_resolution;
+      p.acceleration_mps2 = column<int16_t>(6, i) * ct::velocity_resolution;
+      p.heading_rate_rps = column<int16_t>(7, i) * ct::angle_resolution;
+      p.front_wheel_angle_rad = column<int16_t>(8, i) * ct::angle_resolution;
+      p.rear_wheel_angle_rad = column<int16_t>(9, i) * ct::angle_resolution;
+      const int64_t us = column<int32_t>(10, i);
+      const int64_t sec = us >= 0 ? us / 1000000 : (us - 999999) / 1000000;
+      p.time_from_start.sec = static_cast<decltype(p.time_from_start.sec)>(sec);
+      p.time_from_start.nanosec =
+        static_cast<decltype(p.time_from_start.nanosec)>((us - sec * 1000000) * 1000);
+    }
+  }
+
+private:
+  template <typename T>
+  static void get(const uint8_t *& cursor, T & value)
+  {
+    std::memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+  }
+
+  static constexpr size_t num_columns = 11;
+  static constexpr size_t column_widths[num_columns] = {4, 4, 4, 2, 2, 2, 2, 2, 2, 2, 4};
+
+  // Column c in the order of the layout, element i
+  template <typename T>
+  T column(const size_t c, const size_t i) const
+  {
+    T value;
+    std::memcpy(&value, data_ + offsets_[c] + i * sizeof(T), sizeof(T));
+    return value;
+  }
+
+  const uint8_t * data_{nullptr};
+  size_t n_{0};
+  int64_t stamp_ns_{0};
+  Point origin_;
+  size_t offsets_[num_columns]{};
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__COMPACT_TRAJECTORY_HPP_
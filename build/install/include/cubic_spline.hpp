@@ -40,62 +40,39 @@ public:
    */
   void calcSplineCoefficients(const std::vector<double> & x, const std::vector<double> & y)
   {
-    const size_t n = x.size();
-    if (n < 2) {
+    if (x.size() < 2) {
       return;
     }
-    
-    x_ = x;
-    y_ = y;
-    
-    // 계수 벡터 초기화
-    a_ = y;
-    b_.resize(n);
-    c_.resize(n);
-    d_.resize(n);
-    
-    if (n == 2) {
-      // 선형 보간
-      b_[0] = (y[1] - y[0]) / (x[1] - x[0]);
-      c_[0] = 0.0;
-      d_[0] = 0.0;
+
+    setKnots(x);
+    fitValues(y);
+  }
+
+  /**
+   * @brief 기존 x 좌표(knot)를 유지한 채 y 값만 바꿔 계수 재계산
+   *
+   * knot에만 의존하는 tridiagonal 분해 결과(h, l, mu)를 재사용하며,
+   * 내부 버퍼의 capacity가 유지되므로 같은 크기 이하에서는 힙 할당이 없다.
+   * @param y 현재 knot 개수와 같은 크기의 y 값 배열
+   */
+  void refitValues(const std::vector<double> & y)
+  {
+    if (x_.size() < 2 || y.size() != x_.size()) {
       return;
     }
-    
-    // Tridiagonal 행렬 시스템 구성
-    std::vector<double> h(n - 1);
-    for (size_t i = 0; i < n - 1; ++i) {
-      h[i] = x[i + 1] - x[i];
-    }
-    
-    // 자연 경계 조건: 양 끝에서 2차 미분 = 0
-    std::vector<double> alpha(n);
-    for (size_t i = 1; i < n - 1; ++i) {
-      alpha[i] = 3.0 / h[i] * (y[i + 1] - y[i]) - 3.0 / h[i - 1] * (y[i] - y[i - 1]);
-    }
-    
-    // Thomas 알고리즘으로 tridiagonal 시스템 풀기
-    std::vector<double> l(n), mu(n), z(n);
-    l[0] = 1.0;
-    mu[0] = 0.0;
-    z[0] = 0.0;
-    
-    for (size_t i = 1; i < n - 1; ++i) {
-      l[i] = 2.0 * (x[i + 1] - x[i - 1]) - h[i - 1] * mu[i - 1];
-      mu[i] = h[i] / l[i];
-      z[i] = (alpha[i] - h[i - 1] * z[i - 1]) / l[i];
-    }
-    
-    l[n - 1] = 1.0;
-    z[n - 1] = 0.0;
-    c_[n - 1] = 0.0;
-    
-    // Back substitution
-    for (int i = static_cast<int>(n) - 2; i >= 0; --i) {
-      c_[i] = z[i] - mu[i] * c_[i + 1];
-      b_[i] = (y[i + 1] - y[i]) / h[i] - h[i] * (c_[i + 1] + 2.0 * c_[i]) / 3.0;
-      d_[i] = (c_[i + 1] - c_[i]) / (3.0 * h[i]);
-    }
+
+    fitValues(y);
+  }
+
+  /**
+   * @brief 다른 spline의 knot과 tridiagonal 분해 결과를 복사 (계수는 refitValues로 계산)
+   */
+  void copyKnots(const CubicSpline & other)
+  {
+    x_.assign(other.x_.begin(), other.x_.end());
+    h_.assign(other.h_.begin(), other.h_.end());
+    l_.assign(other.l_.begin(), other.l_.end());
+    mu_.assign(other.mu_.begin(), other.mu_.end());
   }
   
   /**
@@ -142,7 +119,159 @@ public:
     return 2.0 * c_[i] + 6.0 * d_[i] * dx;
   }
   
+  /**
+   * @brief 정렬된 x 배열에 대해 값, 1차 미분, 2차 미분을 한 번에 계산
+   *
+   * 구간 인덱스를 단조 증가시키며 한 번만 순회하므로 쿼리당 binary search가 필요 없다.
+   * 결과는 호출자가 할당한 버퍼에 기록하며, 필요 없는 출력은 nullptr로 전달한다.
+   * 각 결과는 interpolate/derivative/secondDerivative 단일 쿼리와 동일하다.
+   *
+   * @param sorted_x 오름차순으로 정렬된 쿼리 x 배열
+   * @param size 쿼리 개수
+   * @param values spline 값 출력 버퍼 (size 이상)
+   * @param first_derivatives 1차 미분 출력 버퍼 (size 이상)
+   * @param second_derivatives 2차 미분 출력 버퍼 (size 이상)
+   */
+  void evaluate(
+    const double * sorted_x, const size_t size, double * values, double * first_derivatives,
+    double * second_derivatives) const
+  {
+    if (x_.empty()) {
+      for (size_t k = 0; k < size; ++k) {
+        if (values) values[k] = 0.0;
+        if (first_derivatives) first_derivatives[k] = 0.0;
+        if (second_derivatives) second_derivatives[k] = 0.0;
+      }
+      return;
+    }
+
+    const size_t n = x_.size();
+    const double x_front = x_.front();
+    const double x_back = x_.back();
+    size_t i = 0;
+    for (size_t k = 0; k < size; ++k) {
+      const double x = sorted_x[k];
+      if (x <= x_front || x >= x_back) {
+        const bool is_front = x <= x_front;
+        if (values) values[k] = is_front ? y_.front() : y_.back();
+        if (first_derivatives) first_derivatives[k] = is_front ? b_.front() : b_.back();
+        if (second_derivatives) second_derivatives[k] = 0.0;
+        continue;
+      }
+
+      // x_[i] < x <= x_[i + 1] (findSegment과 동일한 구간)
+      while (i + 2 < n && x_[i + 1] < x) {
+        ++i;
+      }
+
+      const double dx = x - x_[i];
+      const double a = a_[i];
+      const double b = b_[i];
+      const double c = c_[i];
+      const double d = d_[i];
+      if (values) values[k] = a + dx * (b + dx * (c + dx * d));
+      if (first_derivatives) first_derivatives[k] = b + dx * (2.0 * c + 3.0 * d * dx);
+      if (second_derivatives) second_derivatives[k] = 2.0 * c + 6.0 * d * dx;
+    }
+  }
+
+  /**
+   * @brief 정렬된 x 배열에 대한 spline 값 계산 (batch)
+   */
+  std::vector<double> interpolate(const std::vector<double> & sorted_x) const
+  {
+    std::vector<double> values(sorted_x.size());
+    evaluate(sorted_x.data(), sorted_x.size(), values.data(), nullptr, nullptr);
+    return values;
+  }
+
+  /**
+   * @brief 정렬된 x 배열에 대한 1차 미분 계산 (batch)
+   */
+  std::vector<double> derivative(const std::vector<double> & sorted_x) const
+  {
+    std::vector<double> values(sorted_x.size());
+    evaluate(sorted_x.data(), sorted_x.size(), nullptr, values.data(), nullptr);
+    return values;
+  }
+
+  /**
+   * @brief 정렬된 x 배열에 대한 2차 미분 계산 (batch)
+   */
+  std::vector<double> secondDerivative(const std::vector<double> & sorted_x) const
+  {
+    std::vector<double> values(sorted_x.size());
+    evaluate(sorted_x.data(), sorted_x.size(), nullptr, nullptr, values.data());
+    return values;
+  }
+
 private:
+  /**
+   * @brief knot 설정 및 y와 무관한 Thomas 알고리즘 forward elimination 계수(l, mu) 계산
+   */
+  void setKnots(const std::vector<double> & x)
+  {
+    const size_t n = x.size();
+    x_.assign(x.begin(), x.end());
+
+    h_.resize(n - 1);
+    for (size_t i = 0; i < n - 1; ++i) {
+      h_[i] = x[i + 1] - x[i];
+    }
+
+    // 자연 경계 조건: 양 끝에서 2차 미분 = 0
+    l_.resize(n);
+    mu_.resize(n);
+    l_[0] = 1.0;
+    mu_[0] = 0.0;
+    for (size_t i = 1; i + 1 < n; ++i) {
+      l_[i] = 2.0 * (x[i + 1] - x[i - 1]) - h_[i - 1] * mu_[i - 1];
+      mu_[i] = h_[i] / l_[i];
+    }
+    l_[n - 1] = 1.0;
+    mu_[n - 1] = 0.0;
+  }
+
+  /**
+   * @brief 설정된 knot에 대해 y 값의 spline 계수 계산
+   */
+  void fitValues(const std::vector<double> & y)
+  {
+    const size_t n = x_.size();
+
+    y_.assign(y.begin(), y.end());
+
+    // 계수 벡터 초기화
+    a_.assign(y.begin(), y.end());
+    b_.assign(n, 0.0);
+    c_.assign(n, 0.0);
+    d_.assign(n, 0.0);
+
+    if (n == 2) {
+      // 선형 보간
+      b_[0] = (y[1] - y[0]) / h_[0];
+      return;
+    }
+
+    // Thomas 알고리즘으로 tridiagonal 시스템 풀기 (l, mu는 setKnots에서 계산됨)
+    z_.resize(n);
+    z_[0] = 0.0;
+    for (size_t i = 1; i < n - 1; ++i) {
+      const double alpha =
+        3.0 / h_[i] * (y[i + 1] - y[i]) - 3.0 / h_[i - 1] * (y[i] - y[i - 1]);
+      z_[i] = (alpha - h_[i - 1] * z_[i - 1]) / l_[i];
+    }
+    z_[n - 1] = 0.0;
+    c_[n - 1] = 0.0;
+
+    // Back substitution
+    for (int i = static_cast<int>(n) - 2; i >= 0; --i) {
+      c_[i] = z_[i] - mu_[i] * c_[i + 1];
+      b_[i] = (y[i + 1] - y[i]) / h_[i] - h_[i] * (c_[i + 1] + 2.0 * c_[i]) / 3.0;
+      d_[i] = (c_[i + 1] - c_[i]) / (3.0 * h_[i]);
+    }
+  }
+
   /**
    * @brief x가 속한 구간의 인덱스 찾기 (binary search)
    */
@@ -160,6 +289,60 @@ private:
   std::vector<double> b_;
   std::vector<double> c_;
   std::vector<double> d_;
+
+  // 재사용되는 작업 버퍼 (knot에만 의존: h, l, mu / y에 의존: z)
+  std::vector<double> h_;
+  std::vector<double> l_;
+  std::vector<double> mu_;
+  std::vector<double> z_;
+};
+
+/**
+ * @brief x(s), y(s) 형태의 2차원 parametric cubic spline
+ *
+ * 두 좌표의 spline이 같은 knot(s)을 공유하므로 tridiagonal 분해는 한 번만 수행하고
+ * 좌표별로는 forward/back substitution만 수행한다.
+ */
+class CubicSpline2D
+{
+public:
+  CubicSpline2D() = default;
+
+  /**
+   * @brief Spline 계수 계산
+   * @param s 매개변수 배열 (보통 누적 arc length, strictly increasing이어야 함)
+   * @param x s에 대응하는 x 좌표 배열
+   * @param y s에 대응하는 y 좌표 배열
+   */
+  void calcSplineCoefficients(
+    const std::vector<double> & s, const std::vector<double> & x, const std::vector<double> & y)
+  {
+    if (s.size() < 2 || x.size() != s.size() || y.size() != s.size()) {
+      return;
+    }
+
+    x_spline_.calcSplineCoefficients(s, x);
+    y_spline_.copyKnots(x_spline_);
+    y_spline_.refitValues(y);
+  }
+
+  /**
+   * @brief 정렬된 s 배열에 대해 좌표와 미분값을 한 번에 계산 (필요 없는 출력은 nullptr)
+   */
+  void evaluate(
+    const double * sorted_s, const size_t size, double * x, double * y, double * dx, double * dy,
+    double * ddx, double * ddy) const
+  {
+    x_spline_.evaluate(sorted_s, size, x, dx, ddx);
+    y_spline_.evaluate(sorted_s, size, y, dy, ddy);
+  }
+
+  const CubicSpline & getXSpline() const { return x_spline_; }
+  const CubicSpline & getYSpline() const { return y_spline_; }
+
+private:
+  CubicSpline x_spline_;
+  CubicSpline y_spline_;
 };
 
 }  // namespace autoware::path_optimizer
@@ -0,0 +1,209 @@
+// Alive and deadline supervision of the planning cycle, with performance counters for telemetry
+#ifndef PATH_OPTIMIZER__CYCLE_SUPERVISION_HPP_
+#define PATH_OPTIMIZER__CYCLE_SUPERVISION_HPP_
+
+#include "instrumentation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace autoware::path_optimizer
+{
+
+struct CycleSupervisionParam
+{
+  int64_t deadline_ns{100'000'000};       // begin -> end of one cycle
+  int64_t alive_timeout_ns{300'000'000};  // begin -> next begin
+
+  // Mitigation: degrade after overrun_threshold misses within the last overrun_window cycles,
+  // recover one level after recover_cycles cycles without a miss
+  size_t overrun_window{20};
+  size_t overrun_threshold{3};
+  size_t recover_cycles{50};
+  size_t max_degradation_level{3};
+};
+
+// Checkpoint ids reported to PHM, as configured for the supervised entity of the SWC
+enum class SupervisionCheckpoint : uint32_t { CycleBegin = 1, CycleEnd = 2 };
+
+/**
+ * CycleSupervisor: checkpoints around the cycle of one SWC and the counters derived from them
+ *
+ * begin() and end() (or a Cycle guard) bracket the cycle. Each is forwarded to the reporter, which
+ * the SWC binds to ReportCheckpoint of its PHM supervised entity, so PHM runs alive and deadline
+ * supervision on them. The same time stamps are also checked locally. This lets the SWC react to
+ * degradation itself and not only through the PHM recovery action. The execution manifests
+ * (opt/Exe_<name>/etc/exec) have no supervision section; the checkpoint ids and the alive/deadline
+ * limits belong into the PHM configuration of the supervised entity and should match param_.
+ *
+ *   - cycle time, miss of the deadline and of the alive timeout;
+ *   - solver fallbacks (reportSolverFallback) and queue depths (observeQueueDepth);
+ *   - a degradation level, raised while deadlines are missed repeatedly and lowered again once
+ *     the cycle keeps its deadline; the SWC maps it to a mitigation, e.g. a shorter horizon.
+ *
+ * Every value also goes to Instrumentation (one process per SWC, so the metric names need no SWC
+ * prefix). counters() can be read from another thread to feed the fleet telemetry. The cycle
+ * itself has to be driven from one thread.
+ */
+class CycleSupervisor
+{
+public:
+  using Reporter = std::function<void(SupervisionCheckpoint)>;
+
+  struct Counters
+  {
+    uint64_t cycles{0};
+    uint64_t deadline_misses{0};
+    uint64_t alive_misses{0};
+    uint64_t solver_fallbacks{0};
+    int64_t last_cycle_ns{0};
+    int64_t max_cycle_ns{0};
+    size_t max_queue_depth{0};
+    size_t degradation_level{0};
+  };
+
+  explicit CycleSupervisor(const CycleSupervisionParam & param = {}, Reporter reporter = {})
+  : param_(param), reporter_(std::move(reporter))
+  {
+  }
+
+  CycleSupervisor(const CycleSupervisor &) = delete;
+  CycleSupervisor & operator=(const CycleSupervisor &) = delete;
+
+  void begin(const int64_t now_ns = Instrumentation::now())
+  {
+    report(SupervisionCheckpoint::CycleBegin);
+    if (last_begin_ns_ >= 0 && now_ns - last_begin_ns_ > param_.alive_timeout_ns) {
+      alive_misses_.fetch_add(1, std::memory_order_relaxed);
+      Instrumentation::instance().count("supervision.alive_miss");
+    }
+    last_begin_ns_ = now_ns;
+  }
+
+  // Returns whether the cycle kept its deadline
+  bool end(const int64_t now_ns = Instrumentation::now())
+  {
+    report(SupervisionCheckpoint::CycleEnd);
+    if (last_begin_ns_ < 0) {
+      return true;
+    }
+    const int64_t cycle_ns = now_ns - last_begin_ns_;
+    const bool missed = cycle_ns > param_.deadline_ns;
+    cycles_.fetch_add(1, std::memory_order_relaxed);
+    last_cycle_ns_.store(cycle_ns, std::memory_order_relaxed);
+    if (cycle_ns > max_cycle_ns_.load(std::memory_order_relaxed)) {
+      max_cycle_ns_.store(cycle_ns, std::memory_order_relaxed);
+    }
+    auto & instrumentation = Instrumentation::instance();
+    instrumentation.observe("supervision.cycle_time", cycle_ns);
+    if (missed) {
+      deadline_misses_.fetch_add(1, std::memory_order_relaxed);
+      instrumentation.count("supervision.deadline_miss");
+    }
+    updateDegradation(missed);
+    return !missed;
+  }
+
+  // The solver (QP, spline fit, ...) gave up and a fallback result was used
+  void reportSolverFallback()
+  {
+    solver_fallbacks_.fetch_add(1, std::memory_order_relaxed);
+    Instrumentation::instance().count("supervision.solver_fallback");
+  }
+
+  // name: static storage duration, as for Instrumentation
+  void observeQueueDepth(const char * name, const size_t depth)
+  {
+    if (depth > max_queue_depth_.load(std::memory_order_relaxed)) {
+      max_queue_depth_.store(depth, std::memory_order_relaxed);
+    }
+    Instrumentation::instance().observe(name, static_cast<int64_t>(depth));
+  }
+
+  // 0 while the cycle keeps its deadline, up to max_degradation_level
+  size_t getDegradationLevel() const { return degradation_level_.load(std::memory_order_relaxed); }
+
+  Counters counters() const
+  {
+    Counters c;
+    c.cycles = cycles_.load(std::memory_order_relaxed);
+    c.deadline_misses = deadline_misses_.load(std::memory_order_relaxed);
+    c.alive_misses = alive_misses_.load(std::memory_order_relaxed);
+    c.solver_fallbacks = solver_fallbacks_.load(std::memory_order_relaxed);
+    c.last_cycle_ns = last_cycle_ns_.load(std::memory_order_relaxed);
+    c.max_cycle_ns = max_cycle_ns_.load(std::memory_order_relaxed);
+    c.max_queue_depth = max_queue_depth_.load(std::memory_order_relaxed);
+    c.degradation_level = getDegradationLevel();
+    return c;
+  }
+
+  // Brackets one cycle: begin() on construction, end() on destruction
+  class Cycle
+  {
+  public:
+    explicit Cycle(CycleSupervisor & supervisor) : supervisor_(supervisor) { supervisor_.begin(); }
+    Cycle(const Cycle &) = delete;
+    Cycle & operator=(const Cycle &) = delete;
+    ~Cycle() { supervisor_.end(); }
+
+  private:
+    CycleSupervisor & supervisor_;
+  };
+
+private:
+  void report(const SupervisionCheckpoint checkpoint) const
+  {
+    if (reporter_) {
+      reporter_(checkpoint);
+    }
+  }
+
+  void updateDegradation(const bool missed)
+  {
+    // misses of the last overrun_window cycles, as a bit mask (window up to 64 cycles)
+    const size_t window = std::clamp<size_t>(param_.overrun_window, 1, 64);
+    const uint64_t mask = window == 64 ? ~uint64_t{0} : (uint64_t{1} << window) - 1;
+    recent_misses_ = ((recent_misses_ << 1U) | (missed ? 1U : 0U)) & mask;
+    size_t level = degradation_level_.load(std::memory_order_relaxed);
+    if (missed) {
+      cycles_without_miss_ = 0;
+      if (
+        static_cast<size_t>(__builtin_popcountll(recent_misses_)) >= param_.overrun_threshold &&
+        level < param_.max_degradation_level) {
+        ++level;
+        recent_misses_ = 0;  // the next step needs new misses at the reduced load
+        Instrumentation::instance().count("supervision.degrade");
+      }
+    } else if (++cycles_without_miss_ >= param_.recover_cycles && level > 0) {
+      --level;
+      cycles_without_miss_ = 0;
+    }
+    degradation_level_.store(level, std::memory_order_relaxed);
+  }
+
+  CycleSupervisionParam param_;
+  Reporter reporter_;
+
+  // owned by the cycle thread
+  int64_t last_begin_ns_{-1};
+  uint64_t recent_misses_{0};
+  size_t cycles_without_miss_{0};
+
+  // also read by counters()
+  std::atomic<uint64_t> cycles_{0};
+  std::atomic<uint64_t> deadline_misses_{0};
+  std::atomic<uint64_t> alive_misses_{0};
+  std::atomic<uint64_t> solver_fallbacks_{0};
+  std::atomic<int64_t> last_cycle_ns_{0};
+  std::atomic<int64_t> max_cycle_ns_{0};
+  std::atomic<size_t> max_queue_depth_{0};
+  std::atomic<size_t> degradation_level_{0};
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__CYCLE_SUPERVISION_HPP_
@@ -0,0 +1,692 @@
+// Structure-reusing QP of the elastic band smoother
+#ifndef PATH_OPTIMIZER__ELASTIC_BAND_QP_HPP_
+#define PATH_OPTIMIZER__ELASTIC_BAND_QP_HPP_
+
+#include "path_optimizer_types.hpp"
+#include "osqp_interface.hpp"
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+struct ElasticBandQPParam
+{
+  double smooth_weight{1.0};       // Squared second difference of the band points
+  double lat_error_weight{0.001};  // Squared displacement from the reference points
+
+  // ADMM settings of solve()
+  double rho{0.1};
+  double sigma{1e-6};
+  double alpha{1.6};  // Over-relaxation
+  double eps_abs{1e-4};
+  double eps_rel{1e-4};
+  int max_iter{4000};
+  int check_interval{10};  // Iterations between two convergence checks
+
+  // fixUnchangedPrefix: largest change of a reference point (position against the last reference
+  // at the same arc length, or the last band for a pinned point, and clearance) for which it
+  // counts as unchanged, and the number of unchanged points before the first change that are
+  // still optimized
+  double reuse_tolerance{0.01};
+  size_t reuse_margin_points{10};
+};
+
+/**
+ * ElasticBandQP: elastic band QP with the structure cached across cycles
+ *
+ * The variables are the displacements d_i = p_i - r_i of the N band points from the reference
+ * points, x components first, then y components:
+ *
+ *   minimize    smooth_weight * sum_i |p_i-1 - 2 p_i + p_i+1|^2 + lat_error_weight * sum_i |d_i|^2
+ *   subject to  -c_i <= t_i . d_i <= c_i,  -c_i <= n_i . d_i <= c_i
+ *
+ * with the tangent t_i and normal n_i of reference point i and its clearance c_i (0 fixes the
+ * point). With displacements the Hessian only depends on N and the weights, and A is one rotation
+ * per point; between cycles with the same N only q, the rotation values and the bounds change,
+ * and the CSC patterns stay the same (a QPSolverBackend keeps its workspace).
+ *
+ * solve() runs ADMM in the OSQP form. As A^T A = I for a rotation per point, its KKT matrix
+ * H + diag(sigma + rho_i) does not depend on the path either: H is the N x N pentadiagonal
+ * Hessian shared by both coordinates, so one banded LDL^T (no fill-in) serves x and y. The band
+ * layout is set up once per N, the factorization is redone only when rho changes, and an
+ * iteration costs two O(N) band substitutions. Nothing is allocated after the first cycle.
+ *
+ * When the reference only changed towards the end (the usual case on a straight road),
+ * fixUnchangedPrefix() keeps the last band on the unchanged beginning: those points leave the
+ * ADMM iteration (their smoothness coupling moves into q of the first free points) and only the
+ * changed part plus reuse_margin_points is optimized. In the QPSolverBackend form they are
+ * pinned by equal bounds instead.
+ *
+ *   band_qp_.setProblem(ref_points, clearance);
+ *   band_qp_.fixUnchangedPrefix(ego_travel_distance);  // or only shiftWarmStart(...)
+ *   band_qp_.solve(band_points, iterations);
+ */
+class ElasticBandQP
+{
+public:
+  explicit ElasticBandQP(const ElasticBandQPParam & param = ElasticBandQPParam{})
+  : param_(param), rho_(param.rho)
+  {
+  }
+
+  // Weight changes rebuild the Hessian at the next setProblem
+  void setParam(const ElasticBandQPParam & param)
+  {
+    if (
+      param.smooth_weight != param_.smooth_weight ||
+      param.lat_error_weight != param_.lat_error_weight) {
+      num_points_ = 0;
+    }
+    if (param.rho != param_.rho) {
+      rho_ = param.rho;
+    }
+    param_ = param;
+  }
+  const ElasticBandQPParam & getParam() const { return param_; }
+
+  /**
+   * @brief Updates the problem for the reference points; resets the iterates to the reference
+   * @param clearance allowed displacement of every point along its tangent and normal
+   */
+  void setProblem(
+    const std::vector<TrajectoryPoint> & ref_points, const std::vector<double> & clearance)
+  {
+    const size_t N = ref_points.size();
+    if (N != num_points_) {
+      setStructure(N);
+    }
+
+    ref_s_.resize(N);
+    bool rho_changed = false;
+    first_ = 0;
+    for (size_t i = 0; i < N; ++i) {
+      const auto & pose = ref_points[i].pose;
+      r_(i) = pose.position.x;
+      r_(N + i) = pose.position.y;
+      const double yaw = calcYaw(pose.orientation);
+      cos_(i) = std::cos(yaw);
+      sin_(i) = std::sin(yaw);
+      c_(i) = i < clearance.size() ? std::max(clearance[i], 0.0) : 0.0;
+
+      // OSQP style: equality rows get a larger rho
+      const double rho_i = c_(i) > 0.0 ? rho_ : 1e3 * rho_;
+      rho_changed = rho_changed || rho_i != rho_vec_(i);
+      rho_vec_(i) = rho_i;
+      ref_s_[i] =
+        i == 0 ? 0.0 : ref_s_[i - 1] + std::hypot(r_(i) - r_(i - 1), r_(N + i) - r_(N + i - 1));
+    }
+    if (rho_changed) {
+      factorize();
+    }
+
+    // q = H_smooth r per coordinate; H_smooth is H without the lat_error_weight diagonal
+    const double lat_diag = 2.0 * param_.lat_error_weight;
+    multiplyH(r_, 0, q_);
+    multiplyH(r_, N, q_);
+    q_ -= lat_diag * r_;
+
+    // A: per point i, row 2i = t_i . d_i, row 2i+1 = n_i . d_i
+    for (size_t i = 0; i < N; ++i) {
+      const auto x_col = A_csc_.m_col_idxs[i];
+      const auto y_col = A_csc_.m_col_idxs[N + i];
+      A_csc_.m_vals[x_col] = cos_(i);
+      A_csc_.m_vals[x_col + 1] = -sin_(i);
+      A_csc_.m_vals[y_col] = sin_(i);
+      A_csc_.m_vals[y_col + 1] = cos_(i);
+      l_[2 * i] = l_[2 * i + 1] = -c_(i);
+      u_[2 * i] = u_[2 * i + 1] = c_(i);
+    }
+    std::copy(q_.data(), q_.data() + q_.size(), q_vec_.begin());
+
+    x_.setZero();
+    z_.setZero();
+    y_.setZero();
+  }
+
+  /**
+   * @brief Starts from the last solution, shifted by the distance ego traveled along the path
+   * since it was computed: point i takes the tangential/normal displacement and duals of the last
+   * band at arc length s_i + travel_distance, and holds its end values beyond it
+   * @return false if there is no last solution; the iterates are left at the reference then
+   */
+  bool shiftWarmStart(const double travel_distance)
+  {
+    const size_t N = num_points_;
+    const size_t prev_N = prev_s_.size();
+    if (N == 0 || prev_N < 2) {
+      return false;
+    }
+    size_t seg = 0;
+    for (size_t i = 0; i < N; ++i) {
+      double ratio = 0.0;
+      findPrevSegment(ref_s_[i] + travel_distance, seg, ratio);
+      const auto lerp = [&](const std::vector<double> & v) {
+        return v[seg] + ratio * (v[seg + 1] - v[seg]);
+      };
+      // Feasible start: clamped to the box and rotated back
+      const double d_t = std::clamp(lerp(prev_offset_t_), -c_(i), c_(i));
+      const double d_n = std::clamp(lerp(prev_offset_n_), -c_(i), c_(i));
+      x_(i) = cos_(i) * d_t - sin_(i) * d_n;
+      x_(N + i) = sin_(i) * d_t + cos_(i) * d_n;
+      z_(2 * i) = d_t;
+      z_(2 * i + 1) = d_n;
+      y_(2 * i) = lerp(prev_dual_t_);
+      y_(2 * i + 1) = lerp(prev_dual_n_);
+    }
+    return true;
+  }
+
+  /**
+   * @brief shiftWarmStart, then fixes the points of the unchanged beginning to the last band; the
+   * first changed point and the reuse_margin_points before it stay free
+   *
+   * As in ReplanChecker, the points are matched by projection onto the last reference (onto the
+   * last band for points pinned by clearance 0), with a segment cursor that only moves forward.
+   * @return number of fixed points (0 without a last solution)
+   */
+  size_t fixUnchangedPrefix(const double travel_distance)
+  {
+    if (!shiftWarmStart(travel_distance)) {
+      return 0;
+    }
+    const size_t N = num_points_;
+    const double tol = param_.reuse_tolerance;
+    size_t num_unchanged = 0;
+    size_t ref_seg = 0;
+    size_t band_seg = 0;
+    for (; num_unchanged < N; ++num_unchanged) {
+      const size_t i = num_unchanged;
+      const double px = r_(i);
+      const double py = r_(N + i);
+      double ratio = 0.0;
+      if (c_(i) == 0.0) {
+        // Pinned onto the last band: the last optimum is unchanged
+        if (projectOnPrev(prev_band_x_, prev_band_y_, px, py, band_seg, ratio) > tol) {
+          break;
+        }
+        x_(i) = x_(N + i) = 0.0;
+        z_(2 * i) = z_(2 * i + 1) = 0.0;
+        continue;
+      }
+      if (projectOnPrev(prev_ref_x_, prev_ref_y_, px, py, ref_seg, ratio) > tol) {
+        break;
+      }
+      const auto lerp = [&](const std::vector<double> & v) {
+        return v[ref_seg] + ratio * (v[ref_seg + 1] - v[ref_seg]);
+      };
+      if (std::abs(c_(i) - lerp(prev_clearance_)) > tol) {
+        break;
+      }
+      const double d_t = std::clamp(lerp(prev_offset_t_), -c_(i), c_(i));
+      const double d_n = std::clamp(lerp(prev_offset_n_), -c_(i), c_(i));
+      x_(i) = cos_(i) * d_t - sin_(i) * d_n;
+      x_(N + i) = sin_(i) * d_t + cos_(i) * d_n;
+      z_(2 * i) = d_t;
+      z_(2 * i + 1) = d_n;
+    }
+
+    first_ = num_unchanged > param_.reuse_margin_points
+               ? num_unchanged - param_.reuse_margin_points
+               : 0;
+    for (size_t i = 0; i < first_; ++i) {
+      l_[2 * i] = u_[2 * i] = z_(2 * i);
+      l_[2 * i + 1] = u_[2 * i + 1] = z_(2 * i + 1);
+    }
+    return first_;
+  }
+
+  /**
+   * @brief Runs ADMM from the current iterates and stores the result for shiftWarmStart
+   * @param band_points optimized positions
+   * @return true if the residuals reached the tolerances within max_iter
+   */
+  bool solve(std::vector<Point> & band_points, int & iterations)
+  {
+    const size_t N = num_points_;
+    iterations = 0;
+    band_points.clear();
+    if (N == 0) {
+      return false;
+    }
+    if (factor_first_ != first_) {
+      factorize();
+    }
+
+    // Fixed points enter the smoothness terms of the first two free points as constants
+    q_active_ = q_;
+    for (const size_t o : {size_t{0}, N}) {
+      for (size_t j = first_; j < std::min(first_ + 2, N); ++j) {
+        if (j >= 1 && j - 1 < first_) {
+          q_active_(o + j) += h1_(j) * x_(o + j - 1);
+        }
+        if (j >= 2 && j - 2 < first_) {
+          q_active_(o + j) += h2_(j) * x_(o + j - 2);
+        }
+      }
+    }
+
+    const double sigma = param_.sigma;
+    const double alpha = param_.alpha;
+    bool converged = false;
+    while (iterations < param_.max_iter && !converged && first_ < N) {
+      ++iterations;
+
+      // x_tilde = K^-1 (sigma x - q + A^T (rho z - y)), per coordinate
+      for (size_t i = first_; i < N; ++i) {
+        const double rho_i = rho_vec_(i);
+        work_(2 * i) = rho_i * z_(2 * i) - y_(2 * i);
+        work_(2 * i + 1) = rho_i * z_(2 * i + 1) - y_(2 * i + 1);
+      }
+      applyAT(work_, first_, rhs_);
+      for (const size_t o : {size_t{0}, N}) {
+        for (size_t j = o + first_; j < o + N; ++j) {
+          rhs_(j) += sigma * x_(j) - q_active_(j);
+        }
+      }
+      solveK(rhs_, 0, x_tilde_);
+      solveK(rhs_, N, x_tilde_);
+      applyA(x_tilde_, first_, z_tilde_);
+
+      for (const size_t o : {size_t{0}, N}) {
+        for (size_t j = o + first_; j < o + N; ++j) {
+          x_(j) = alpha * x_tilde_(j) + (1.0 - alpha) * x_(j);
+        }
+      }
+      for (size_t i = 2 * first_; i < 2 * N; ++i) {
+        const double rho_i = rho_vec_(i / 2);
+        const double z_hat = alpha * z_tilde_(i) + (1.0 - alpha) * z_(i);
+        const double z_next = std::clamp(z_hat + y_(i) / rho_i, l_[i], u_[i]);
+        y_(i) += rho_i * (z_hat - z_next);
+        z_(i) = z_next;
+      }
+
+      if (iterations % param_.check_interval == 0) {
+        converged = checkConvergence();
+      }
+    }
+
+    // Result, kept for the next shiftWarmStart
+    band_points.resize(N);
+    prev_offset_t_.resize(N);
+    prev_offset_n_.resize(N);
+    prev_dual_t_.resize(N);
+    prev_dual_n_.resize(N);
+    prev_ref_x_.resize(N);
+    prev_ref_y_.resize(N);
+    prev_clearance_.resize(N);
+    prev_band_x_.resize(N);
+    prev_band_y_.resize(N);
+    applyA(x_, 0, z_tilde_);
+    for (size_t i = 0; i < N; ++i) {
+      prev_ref_x_[i] = r_(i);
+      prev_ref_y_[i] = r_(N + i);
+      prev_clearance_[i] = c_(i);
+      band_points[i].x = prev_band_x_[i] = r_(i) + x_(i);
+      band_points[i].y = prev_band_y_[i] = r_(N + i) + x_(N + i);
+      prev_offset_t_[i] = z_tilde_(2 * i);
+      prev_offset_n_[i] = z_tilde_(2 * i + 1);
+      prev_dual_t_[i] = y_(2 * i);
+      prev_dual_n_[i] = y_(2 * i + 1);
+    }
+    prev_s_ = ref_s_;
+    return converged || first_ == N;
+  }
+
+  // The problem in the QPSolverBackend form; the patterns only change with N
+  const CSC_Matrix & getP() const { return P_csc_; }
+  const CSC_Matrix & getA() const { return A_csc_; }
+  const std::vector<double> & getQ() const { return q_vec_; }
+  const std::vector<double> & getLowerBound() const { return l_; }
+  const std::vector<double> & getUpperBound() const { return u_; }
+
+  // Current iterates as QPSolverBackend::setWarmStart arguments
+  void getWarmStart(std::vector<double> & primal, std::vector<double> & dual) const
+  {
+    primal.assign(x_.data(), x_.data() + x_.size());
+    dual.assign(y_.data(), y_.data() + y_.size());
+  }
+
+  size_t getNumStructureSetups() const { return num_structure_setups_; }
+  size_t getNumFactorizations() const { return num_factorizations_; }
+  size_t getNumFixedPoints() const { return first_; }
+
+private:
+  static double calcYaw(const Quaternion & q)
+  {
+    return std::atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+  }
+
+  /**
+   * @brief Distance of (px, py) from the polyline (prev_x, prev_y), infinity if it projects
+   * outside of it
+   * @param seg nearest segment, only moves forward from its value on input
+   * @param ratio position of the projection on the segment
+   */
+  static double projectOnPrev(
+    const std::vector<double> & prev_x, const std::vector<double> & prev_y, const double px,
+    const double py, size_t & seg, double & ratio)
+  {
+    const auto calcSquaredDistance = [&](const size_t k, double & t) {
+      const double seg_x = prev_x[k + 1] - prev_x[k];
+      const double seg_y = prev_y[k + 1] - prev_y[k];
+      const double seg_len_sq = seg_x * seg_x + seg_y * seg_y;
+      t = seg_len_sq > 1e-12
+            ? ((px - prev_x[k]) * seg_x + (py - prev_y[k]) * seg_y) / seg_len_sq
+            : 0.0;
+      const double clamped_t = std::clamp(t, 0.0, 1.0);
+      const double dx = prev_x[k] + clamped_t * seg_x - px;
+      const double dy = prev_y[k] + clamped_t * seg_y - py;
+      return dx * dx + dy * dy;
+    };
+    const size_t num_segs = prev_x.size() - 1;
+    double dist_sq = calcSquaredDistance(seg, ratio);
+    while (seg + 1 < num_segs) {
+      double next_ratio = 0.0;
+      const double next_dist_sq = calcSquaredDistance(seg + 1, next_ratio);
+      if (next_dist_sq > dist_sq) {
+        break;
+      }
+      ++seg;
+      dist_sq = next_dist_sq;
+      ratio = next_ratio;
+    }
+    if ((seg == 0 && ratio < 0.0) || (seg + 1 == num_segs && ratio > 1.0)) {
+      return INFINITY;
+    }
+    ratio = std::clamp(ratio, 0.0, 1.0);
+    return std::sqrt(dist_sq);
+  }
+
+  // Segment of the last band at arc length s (clamped to it); seg only moves forward
+  void findPrevSegment(const double s, size_t & seg, double & ratio) const
+  {
+    const double clamped_s = std::clamp(s, prev_s_.front(), prev_s_.back());
+    while (seg + 2 < prev_s_.size() && prev_s_[seg + 1] < clamped_s) {
+      ++seg;
+    }
+    const double len = prev_s_[seg + 1] - prev_s_[seg];
+    ratio = len > 1e-9 ? (clamped_s - prev_s_[seg]) / len : 0.0;
+  }
+
+  // Hessian bands and CSC patterns for N points
+  void setStructure(const size_t N)
+  {
+    num_points_ = N;
+    r_.resize(2 * N);
+    q_.resize(2 * N);
+    x_.setZero(2 * N);
+    z_.setZero(2 * N);
+    y_.setZero(2 * N);
+    x_tilde_.resize(2 * N);
+    z_tilde_.resize(2 * N);
+    work_.resize(2 * N);
+    rhs_.resize(2 * N);
+    cos_.resize(N);
+    sin_.resize(N);
+    c_.resize(N);
+    rho_vec_.setConstant(N, rho_);
+    q_active_.resize(2 * N);
+    q_vec_.resize(2 * N);
+    l_.resize(2 * N);
+    u_.resize(2 * N);
+    ldl_d_.resize(N);
+    ldl_l1_.setZero(N);
+    ldl_l2_.setZero(N);
+    prev_s_.clear();
+
+    // H = 2 smooth_weight D^T D + 2 lat_error_weight I, D the (N - 2) x N second difference
+    h0_.setConstant(N, 2.0 * param_.lat_error_weight);
+    h1_.setZero(N);
+    h2_.setZero(N);
+    const double w = 2.0 * param_.smooth_weight;
+    for (size_t k = 0; k + 2 < N; ++k) {
+      h0_(k) += w;
+      h0_(k + 1) += 4.0 * w;
+      h0_(k + 2) += w;
+      h1_(k + 1) -= 2.0 * w;
+      h1_(k + 2) -= 2.0 * w;
+      h2_(k + 2) += w;
+    }
+
+    // P = blkdiag(H, H), upper triangle: column j holds the rows j - 2, j - 1, j of its block
+    P_csc_.m_vals.clear();
+    P_csc_.m_row_idxs.clear();
+    P_csc_.m_col_idxs.assign(1, 0);
+    for (size_t col = 0; col < 2 * N; ++col) {
+      const size_t j = col % N;
+      const size_t block = col - j;
+      if (j >= 2) {
+        P_csc_.m_vals.push_back(h2_(j));
+        P_csc_.m_row_idxs.push_back(static_cast<long long>(block + j - 2));
+      }
+      if (j >= 1) {
+        P_csc_.m_vals.push_back(h1_(j));
+        P_csc_.m_row_idxs.push_back(static_cast<long long>(block + j - 1));
+      }
+      P_csc_.m_vals.push_back(h0_(j));
+      P_csc_.m_row_idxs.push_back(static_cast<long long>(col));
+      P_csc_.m_col_idxs.push_back(static_cast<long long>(P_csc_.m_vals.size()));
+    }
+
+    // A: column i (x_i) and N + i (y_i) have the rows 2i and 2i + 1, values set per problem
+    A_csc_.m_vals.assign(4 * N, 0.0);
+    A_csc_.m_row_idxs.resize(4 * N);
+    A_csc_.m_col_idxs.resize(2 * N + 1);
+    for (size_t col = 0; col < 2 * N; ++col) {
+      const size_t i = col % N;
+      A_csc_.m_col_idxs[col] = static_cast<long long>(2 * col);
+      A_csc_.m_row_idxs[2 * col] = static_cast<long long>(2 * i);
+      A_csc_.m_row_idxs[2 * col + 1] = static_cast<long long>(2 * i + 1);
+    }
+    A_csc_.m_col_idxs[2 * N] = static_cast<long long>(4 * N);
+
+    ++num_structure_setups_;
+    factorize();
+  }
+
+  // Banded LDL^T of K = H + diag(sigma + rho_i) over the free points; L has the two
+  // subdiagonals l1, l2
+  void factorize()
+  {
+    const Eigen::Index N = ldl_d_.size();
+    const auto first = static_cast<Eigen::Index>(first_);
+    for (Eigen::Index j = first; j < N; ++j) {
+      double d = h0_(j) + param_.sigma + rho_vec_(j);
+      if (j >= first + 2) {
+        ldl_l2_(j) = h2_(j) / ldl_d_(j - 2);
+        d -= ldl_l2_(j) * ldl_l2_(j) * ldl_d_(j - 2);
+      }
+      if (j >= first + 1) {
+        const double l2_term =
+          j >= first + 2 ? ldl_l2_(j) * ldl_l1_(j - 1) * ldl_d_(j - 2) : 0.0;
+        ldl_l1_(j) = (h1_(j) - l2_term) / ldl_d_(j - 1);
+        d -= ldl_l1_(j) * ldl_l1_(j) * ldl_d_(j - 1);
+      }
+      ldl_d_(j) = d;
+    }
+    factor_first_ = first_;
+    ++num_factorizations_;
+  }
+
+  // out[offset + .] = K^-1 b[offset + .] for the free points of one coordinate block
+  void solveK(const Eigen::VectorXd & b, const size_t offset, Eigen::VectorXd & out) const
+  {
+    const auto N = static_cast<Eigen::Index>(num_points_);
+    const auto o = static_cast<Eigen::Index>(offset);
+    const auto first = static_cast<Eigen::Index>(first_);
+    for (Eigen::Index j = first; j < N; ++j) {
+      double v = b(o + j);
+      if (j >= first + 1) {
+        v -= ldl_l1_(j) * out(o + j - 1);
+      }
+      if (j >= first + 2) {
+        v -= ldl_l2_(j) * out(o + j - 2);
+      }
+      out(o + j) = v;
+    }
+    for (Eigen::Index j = N - 1; j >= first; --j) {
+      double v = out(o + j) / ldl_d_(j);
+      if (j + 1 < N) {
+        v -= ldl_l1_(j + 1) * out(o + j + 1);
+      }
+      if (j + 2 < N) {
+        v -= ldl_l2_(j + 2) * out(o + j + 2);
+      }
+      out(o + j) = v;
+    }
+  }
+
+  // out[offset + .] = H v[offset + .] over the free points of one coordinate block
+  void multiplyH(const Eigen::VectorXd & v, const size_t offset, Eigen::VectorXd & out) const
+  {
+    const auto N = static_cast<Eigen::Index>(num_points_);
+    const auto o = static_cast<Eigen::Index>(offset);
+    const auto first = static_cast<Eigen::Index>(first_);
+    for (Eigen::Index j = first; j < N; ++j) {
+      double sum = h0_(j) * v(o + j);
+      if (j >= first + 1) {
+        sum += h1_(j) * v(o + j - 1);
+      }
+      if (j >= first + 2) {
+        sum += h2_(j) * v(o + j - 2);
+      }
+      if (j + 1 < N) {
+        sum += h1_(j + 1) * v(o + j + 1);
+      }
+      if (j + 2 < N) {
+        sum += h2_(j + 2) * v(o + j + 2);
+      }
+      out(o + j) = sum;
+    }
+  }
+
+  void applyA(const Eigen::VectorXd & d, const size_t begin, Eigen::VectorXd & out) const
+  {
+    const size_t N = num_points_;
+    for (size_t i = begin; i < N; ++i) {
+      out(2 * i) = cos_(i) * d(i) + sin_(i) * d(N + i);
+      out(2 * i + 1) = -sin_(i) * d(i) + cos_(i) * d(N + i);
+    }
+  }
+
+  void applyAT(const Eigen::VectorXd & v, const size_t begin, Eigen::VectorXd & out) const
+  {
+    const size_t N = num_points_;
+    for (size_t i = begin; i < N; ++i) {
+      out(i) = cos_(i) * v(2 * i) - sin_(i) * v(2 * i + 1);
+      out(N + i) = sin_(i) * v(2 * i) + cos_(i) * v(2 * i + 1);
+    }
+  }
+
+  // OSQP termination criteria over the free points; rebalances rho (refactorization) if far off
+  bool checkConvergence()
+  {
+    const size_t N = num_points_;
+    const size_t first = first_;
+    // Infinity norms over the free points of [x; y] (by_row false) or per-row vectors
+    const auto norm = [N, first](const Eigen::VectorXd & v, const bool by_row) {
+      if (by_row) {
+        return v.segment(2 * first, 2 * (N - first)).lpNorm<Eigen::Infinity>();
+      }
+      return std::max(
+        v.segment(first, N - first).lpNorm<Eigen::Infinity>(),
+        v.segment(N + first, N - first).lpNorm<Eigen::Infinity>());
+    };
+
+    applyA(x_, first, z_tilde_);
+    const double Ax_norm = norm(z_tilde_, true);
+    z_tilde_ -= z_;
+    const double primal_res = norm(z_tilde_, true);
+
+    multiplyH(x_, 0, work_);
+    multiplyH(x_, N, work_);
+    const double Px_norm = norm(work_, false);
+    applyAT(y_, first, rhs_);
+    const double ATy_norm = norm(rhs_, false);
+    work_ += q_active_ + rhs_;
+    const double dual_res = norm(work_, false);
+
+    const double primal_scale = std::max(Ax_norm, norm(z_, true));
+    const double dual_scale = std::max({Px_norm, ATy_norm, norm(q_active_, false)});
+    if (
+      primal_res <= param_.eps_abs + param_.eps_rel * primal_scale &&
+      dual_res <= param_.eps_abs + param_.eps_rel * dual_scale) {
+      return true;
+    }
+
+    const double primal_ratio = primal_res / std::max(primal_scale, 1e-10);
+    const double dual_ratio = dual_res / std::max(dual_scale, 1e-10);
+    const double ratio = std::sqrt(primal_ratio / std::max(dual_ratio, 1e-10));
+    if (ratio > 5.0 || ratio < 0.2) {
+      rho_ = std::clamp(rho_ * ratio, 1e-6, 1e6);
+      for (size_t i = 0; i < N; ++i) {
+        rho_vec_(i) = c_(i) > 0.0 ? rho_ : 1e3 * rho_;
+      }
+      factorize();
+    }
+    return false;
+  }
+
+  ElasticBandQPParam param_;
+  double rho_;
+  size_t num_points_{0};
+  size_t first_{0};         // Points before first_ are fixed (fixUnchangedPrefix)
+  size_t factor_first_{0};  // first_ of the current factorization
+
+  // Hessian of one coordinate by bands H(j, j), H(j, j - 1), H(j, j - 2), and LDL^T of K
+  Eigen::VectorXd h0_;
+  Eigen::VectorXd h1_;
+  Eigen::VectorXd h2_;
+  Eigen::VectorXd ldl_d_;
+  Eigen::VectorXd ldl_l1_;
+  Eigen::VectorXd ldl_l2_;
+  size_t num_structure_setups_{0};
+  size_t num_factorizations_{0};
+
+  // Per problem: reference [x; y], direction and clearance per point
+  Eigen::VectorXd r_;
+  Eigen::VectorXd q_;
+  Eigen::VectorXd q_active_;  // q with the coupling to the fixed points
+  Eigen::VectorXd cos_;
+  Eigen::VectorXd sin_;
+  Eigen::VectorXd c_;
+  Eigen::VectorXd rho_vec_;
+  std::vector<double> ref_s_;
+
+  // ADMM iterates and scratch
+  Eigen::VectorXd x_;
+  Eigen::VectorXd z_;
+  Eigen::VectorXd y_;
+  Eigen::VectorXd x_tilde_;
+  Eigen::VectorXd z_tilde_;
+  Eigen::VectorXd work_;
+  Eigen::VectorXd rhs_;
+
+  CSC_Matrix P_csc_;
+  CSC_Matrix A_csc_;
+  std::vector<double> q_vec_;
+  std::vector<double> l_;
+  std::vector<double> u_;
+
+  // Last solution in the frames of its reference points, by their arc length
+  std::vector<double> prev_s_;
+  std::vector<double> prev_offset_t_;
+  std::vector<double> prev_offset_n_;
+  std::vector<double> prev_ref_x_;
+  std::vector<double> prev_ref_y_;
+  std::vector<double> prev_clearance_;
+  std::vector<double> prev_band_x_;
+  std::vector<double> prev_band_y_;
+  std::vector<double> prev_dual_t_;
+  std::vector<double> prev_dual_n_;
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__ELASTIC_BAND_QP_HPP_
@@ -0,0 +1,359 @@
+// Batched ego footprint vs obstacle polygon collision check
+#ifndef PATH_OPTIMIZER__FOOTPRINT_COLLISION_HPP_
+#define PATH_OPTIMIZER__FOOTPRINT_COLLISION_HPP_
+
+#include "path_optimizer_types.hpp"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PATH_OPTIMIZER_FOOTPRINT_COLLISION_NEON
+#endif
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define PATH_OPTIMIZER_FOOTPRINT_COLLISION_AVX2
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * FootprintBatch: ego footprint rectangles at the trajectory poses, structure of arrays
+ *
+ * Rectangle i is centered at (cx[i], cy[i]) with the heading (ux[i], uy[i]); all rectangles have
+ * the same half extents (vehicle outline from VehicleInfo plus margin).
+ */
+struct FootprintBatch
+{
+  std::vector<double> cx;
+  std::vector<double> cy;
+  std::vector<double> ux;
+  std::vector<double> uy;
+  double half_length{0.0};
+  double half_width{0.0};
+  double radius{0.0};  // Bounding circle
+
+  size_t size() const { return cx.size(); }
+
+  // Capacity preserving, so steady-state updates do not allocate
+  template <typename PointT>
+  void assign(
+    const std::vector<PointT> & points, const VehicleInfo & vehicle_info, const double margin = 0.0)
+  {
+    const double front = vehicle_info.wheel_base_m + vehicle_info.front_overhang_m;
+    const double rear = vehicle_info.rear_overhang_m;
+    const double center_offset = 0.5 * (front - rear);  // from the rear axle
+    half_length = 0.5 * (front + rear) + margin;
+    half_width = 0.5 * vehicle_info.vehicle_width_m + margin;
+    radius = std::hypot(half_length, half_width);
+
+    const size_t n = points.size();
+    cx.resize(n);
+    cy.resize(n);
+    ux.resize(n);
+    uy.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      const auto & q = points[i].pose.orientation;
+      const double yaw =
+        std::atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+      ux[i] = std::cos(yaw);
+      uy[i] = std::sin(yaw);
+      cx[i] = points[i].pose.position.x + center_offset * ux[i];
+      cy[i] = points[i].pose.position.y + center_offset * uy[i];
+    }
+  }
+};
+
+/**
+ * CollisionPolygon: convex obstacle polygon prepared for separating axis tests
+ *
+ * Keeps the vertices as arrays, the edge normals with the projection interval of the polygon on
+ * each of them, and a bounding circle. Non-convex shapes have to be passed as their convex hull
+ * (conservative) or split.
+ */
+struct CollisionPolygon
+{
+  std::vector<double> vx;
+  std::vector<double> vy;
+  std::vector<double> nx;  // Edge normals (not normalized)
+  std::vector<double> ny;
+  std::vector<double> n_min;  // Projection interval of the polygon on the normal
+  std::vector<double> n_max;
+  double center_x{0.0};
+  double center_y{0.0};
+  double radius{0.0};
+
+  size_t size() const { return vx.size(); }
+
+  // Vertices in any orientation, closed implicitly
+  template <typename PointT>
+  void assign(const std::vector<PointT> & polygon)
+  {
+    const size_t n = polygon.size();
+    vx.resize(n);
+    vy.resize(n);
+    nx.resize(n);
+    ny.resize(n);
+    n_min.resize(n);
+    n_max.resize(n);
+    center_x = center_y = radius = 0.0;
+    if (n == 0) {
+      return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      vx[i] = polygon[i].x;
+      vy[i] = polygon[i].y;
+      center_x += vx[i] / static_cast<double>(n);
+      center_y += vy[i] / static_cast<double>(n);
+    }
+    for (size_t e = 0; e < n; ++e) {
+      const size_t next = (e + 1) % n;
+      nx[e] = -(vy[next] - vy[e]);
+      ny[e] = vx[next] - vx[e];
+      n_min[e] = n_max[e] = vx[0] * nx[e] + vy[0] * ny[e];
+      for (size_t i = 1; i < n; ++i) {
+        const double p = vx[i] * nx[e] + vy[i] * ny[e];
+        n_min[e] = std::min(n_min[e], p);
+        n_max[e] = std::max(n_max[e], p);
+      }
+      radius = std::max(radius, std::hypot(vx[e] - center_x, vy[e] - center_y));
+    }
+  }
+};
+
+namespace footprint_collision
+{
+/**
+ * @brief Reference kernel: out[i] = 1 if footprint i overlaps the polygon (touching counts),
+ * for i in [begin, end)
+ *
+ * Bounding circles first, then the separating axis test on the two rectangle axes and the
+ * polygon edge normals. The SIMD kernels evaluate the same expressions for several poses at once
+ * and give identical results.
+ */
+inline void collideScalar(
+  const FootprintBatch & fp, const CollisionPolygon & poly, const size_t begin, const size_t end,
+  uint8_t * out)
+{
+  const double reach = fp.radius + poly.radius;
+  for (size_t i = begin; i < end; ++i) {
+    const double dcx = fp.cx[i] - poly.center_x;
+    const double dcy = fp.cy[i] - poly.center_y;
+    bool separated = poly.size() == 0 || dcx * dcx + dcy * dcy > reach * reach;
+
+    // Rectangle axes: polygon interval relative to the rectangle center
+    double u_min = INFINITY;
+    double u_max = -INFINITY;
+    double v_min = INFINITY;
+    double v_max = -INFINITY;
+    for (size_t k = 0; k < poly.size() && !separated; ++k) {
+      const double rx = poly.vx[k] - fp.cx[i];
+      const double ry = poly.vy[k] - fp.cy[i];
+      const double pu = rx * fp.ux[i] + ry * fp.uy[i];
+      const double pv = ry * fp.ux[i] - rx * fp.uy[i];
+      u_min = std::min(u_min, pu);
+      u_max = std::max(u_max, pu);
+      v_min = std::min(v_min, pv);
+      v_max = std::max(v_max, pv);
+    }
+    separated = separated || u_min > fp.half_length || u_max < -fp.half_length ||
+                v_min > fp.half_width || v_max < -fp.half_width;
+
+    // Polygon edge normals: rectangle interval center +- extent
+    for (size_t e = 0; e < poly.size() && !separated; ++e) {
+      const double c = fp.cx[i] * poly.nx[e] + fp.cy[i] * poly.ny[e];
+      const double r =
+        fp.half_length * std::abs(fp.ux[i] * poly.nx[e] + fp.uy[i] * poly.ny[e]) +
+        fp.half_width * std::abs(fp.ux[i] * poly.ny[e] - fp.uy[i] * poly.nx[e]);
+      separated = c - r > poly.n_max[e] || c + r < poly.n_min[e];
+    }
+    out[i] = separated ? 0 : 1;
+  }
+}
+
+#ifdef PATH_OPTIMIZER_FOOTPRINT_COLLISION_NEON
+// NEON kernel, two poses per iteration
+inline void collideNeon(
+  const FootprintBatch & fp, const CollisionPolygon & poly, const size_t begin, const size_t end,
+  uint8_t * out)
+{
+  if (poly.size() == 0) {
+    collideScalar(fp, poly, begin, end, out);
+    return;
+  }
+  const double reach = fp.radius + poly.radius;
+  const float64x2_t reach_sq = vdupq_n_f64(reach * reach);
+  const float64x2_t hl = vdupq_n_f64(fp.half_length);
+  const float64x2_t hw = vdupq_n_f64(fp.half_width);
+  const float64x2_t neg_hl = vdupq_n_f64(-fp.half_length);
+  const float64x2_t neg_hw = vdupq_n_f64(-fp.half_width);
+  size_t i = begin;
+  for (; i + 2 <= end; i += 2) {
+    const float64x2_t cx = vld1q_f64(fp.cx.data() + i);
+    const float64x2_t cy = vld1q_f64(fp.cy.data() + i);
+    const float64x2_t ux = vld1q_f64(fp.ux.data() + i);
+    const float64x2_t uy = vld1q_f64(fp.uy.data() + i);
+    const float64x2_t dcx = vsubq_f64(cx, vdupq_n_f64(poly.center_x));
+    const float64x2_t dcy = vsubq_f64(cy, vdupq_n_f64(poly.center_y));
+    uint64x2_t separated =
+      vcgtq_f64(vaddq_f64(vmulq_f64(dcx, dcx), vmulq_f64(dcy, dcy)), reach_sq);
+    if (vgetq_lane_u64(separated, 0) && vgetq_lane_u64(separated, 1)) {
+      out[i] = out[i + 1] = 0;
+      continue;
+    }
+
+    float64x2_t u_min = vdupq_n_f64(INFINITY);
+    float64x2_t u_max = vdupq_n_f64(-INFINITY);
+    float64x2_t v_min = vdupq_n_f64(INFINITY);
+    float64x2_t v_max = vdupq_n_f64(-INFINITY);
+    for (size_t k = 0; k < poly.size(); ++k) {
+      const float64x2_t rx = vsubq_f64(vdupq_n_f64(poly.vx[k]), cx);
+      const float64x2_t ry = vsubq_f64(vdupq_n_f64(poly.vy[k]), cy);
+      const float64x2_t pu = vaddq_f64(vmulq_f64(rx, ux), vmulq_f64(ry, uy));
+      const float64x2_t pv = vsubq_f64(vmulq_f64(ry, ux), vmulq_f64(rx, uy));
+      u_min = vminq_f64(u_min, pu);
+      u_max = vmaxq_f64(u_max, pu);
+      v_min = vminq_f64(v_min, pv);
+      v_max = vmaxq_f64(v_max, pv);
+    }
+    separated = vorrq_u64(separated, vcgtq_f64(u_min, hl));
+    separated = vorrq_u64(separated, vcltq_f64(u_max, neg_hl));
+    separated = vorrq_u64(separated, vcgtq_f64(v_min, hw));
+    separated = vorrq_u64(separated, vcltq_f64(v_max, neg_hw));
+
+    for (size_t e = 0; e < poly.size(); ++e) {
+      const float64x2_t pnx = vdupq_n_f64(poly.nx[e]);
+      const float64x2_t pny = vdupq_n_f64(poly.ny[e]);
+      const float64x2_t c = vaddq_f64(vmulq_f64(cx, pnx), vmulq_f64(cy, pny));
+      const float64x2_t r = vaddq_f64(
+        vmulq_f64(hl, vabsq_f64(vaddq_f64(vmulq_f64(ux, pnx), vmulq_f64(uy, pny)))),
+        vmulq_f64(hw, vabsq_f64(vsubq_f64(vmulq_f64(ux, pny), vmulq_f64(uy, pnx)))));
+      separated = vorrq_u64(separated, vcgtq_f64(vsubq_f64(c, r), vdupq_n_f64(poly.n_max[e])));
+      separated = vorrq_u64(separated, vcltq_f64(vaddq_f64(c, r), vdupq_n_f64(poly.n_min[e])));
+    }
+    out[i] = vgetq_lane_u64(separated, 0) ? 0 : 1;
+    out[i + 1] = vgetq_lane_u64(separated, 1) ? 0 : 1;
+  }
+  collideScalar(fp, poly, i, end, out);
+}
+#endif
+
+#ifdef PATH_OPTIMIZER_FOOTPRINT_COLLISION_AVX2
+// AVX2 kernel, four poses per iteration. Only called if the cpu supports it.
+__attribute__((target("avx2"))) inline void collideAvx2(
+  const FootprintBatch & fp, const CollisionPolygon & poly, const size_t begin, const size_t end,
+  uint8_t * out)
+{
+  if (poly.size() == 0) {
+    collideScalar(fp, poly, begin, end, out);
+    return;
+  }
+  const double reach = fp.radius + poly.radius;
+  const __m256d reach_sq = _mm256_set1_pd(reach * reach);
+  const __m256d hl = _mm256_set1_pd(fp.half_length);
+  const __m256d hw = _mm256_set1_pd(fp.half_width);
+  const __m256d neg_hl = _mm256_set1_pd(-fp.half_length);
+  const __m256d neg_hw = _mm256_set1_pd(-fp.half_width);
+  const __m256d sign_mask = _mm256_set1_pd(-0.0);
+  size_t i = begin;
+  for (; i + 4 <= end; i += 4) {
+    const __m256d cx = _mm256_loadu_pd(fp.cx.data() + i);
+    const __m256d cy = _mm256_loadu_pd(fp.cy.data() + i);
+    const __m256d ux = _mm256_loadu_pd(fp.ux.data() + i);
+    const __m256d uy = _mm256_loadu_pd(fp.uy.data() + i);
+    const __m256d dcx = _mm256_sub_pd(cx, _mm256_set1_pd(poly.center_x));
+    const __m256d dcy = _mm256_sub_pd(cy, _mm256_set1_pd(poly.center_y));
+    __m256d separated = _mm256_cmp_pd(
+      _mm256_add_pd(_mm256_mul_pd(dcx, dcx), _mm256_mul_pd(dcy, dcy)), reach_sq, _CMP_GT_OQ);
+    if (_mm256_movemask_pd(separated) == 0xF) {
+      out[i] = out[i + 1] = out[i + 2] = out[i + 3] = 0;
+      continue;
+    }
+
+    __m256d u_min = _mm256_set1_pd(INFINITY);
+    __m256d u_max = _mm256_set1_pd(-INFINITY);
+    __m256d v_min = _mm256_set1_pd(INFINITY);
+    __m256d v_max = _mm256_set1_pd(-INFINITY);
+    for (size_t k = 0; k < poly.size(); ++k) {
+      const __m256d rx = _mm256_sub_pd(_mm256_set1_pd(poly.vx[k]), cx);
+      const __m256d ry = _mm256_sub_pd(_mm256_set1_pd(poly.vy[k]), cy);
+      const __m256d pu = _mm256_add_pd(_mm256_mul_pd(rx, ux), _mm256_mul_pd(ry, uy));
+      const __m256d pv = _mm256_sub_pd(_mm256_mul_pd(ry, ux), _mm256_mul_pd(rx, uy));
+      u_min = _mm256_min_pd(u_min, pu);
+      u_max = _mm256_max_pd(u_max, pu);
+      v_min = _mm256_min_pd(v_min, pv);
+      v_max = _mm256_max_pd(v_max, pv);
+    }
+    separated = _mm256_or_pd(separated, _mm256_cmp_pd(u_min, hl, _CMP_GT_OQ));
+    separated = _mm256_or_pd(separated, _mm256_cmp_pd(u_max, neg_hl, _CMP_LT_OQ));
+    separated = _mm256_or_pd(separated, _mm256_cmp_pd(v_min, hw, _CMP_GT_OQ));
+    separated = _mm256_or_pd(separated, _mm256_cmp_pd(v_max, neg_hw, _CMP_LT_OQ));
+
+    for (size_t e = 0; e < poly.size() && _mm256_movemask_pd(separated) != 0xF; ++e) {
+      const __m256d pnx = _mm256_set1_pd(poly.nx[e]);
+      const __m256d pny = _mm256_set1_pd(poly.ny[e]);
+      const __m256d c = _mm256_add_pd(_mm256_mul_pd(cx, pnx), _mm256_mul_pd(cy, pny));
+      const __m256d proj_u = _mm256_add_pd(_mm256_mul_pd(ux, pnx), _mm256_mul_pd(uy, pny));
+      const __m256d proj_v = _mm256_sub_pd(_mm256_mul_pd(ux, pny), _mm256_mul_pd(uy, pnx));
+      const __m256d r = _mm256_add_pd(
+        _mm256_mul_pd(hl, _mm256_andnot_pd(sign_mask, proj_u)),
+        _mm256_mul_pd(hw, _mm256_andnot_pd(sign_mask, proj_v)));
+      separated = _mm256_or_pd(
+        separated,
+        _mm256_cmp_pd(_mm256_sub_pd(c, r), _mm256_set1_pd(poly.n_max[e]), _CMP_GT_OQ));
+      separated = _mm256_or_pd(
+        separated,
+        _mm256_cmp_pd(_mm256_add_pd(c, r), _mm256_set1_pd(poly.n_min[e]), _CMP_LT_OQ));
+    }
+    const int mask = _mm256_movemask_pd(separated);
+    for (size_t lane = 0; lane < 4; ++lane) {
+      out[i + lane] = (mask >> lane) & 1 ? 0 : 1;
+    }
+  }
+  collideScalar(fp, poly, i, end, out);
+}
+#endif
+
+using CollideKernel = void (*)(
+  const FootprintBatch &, const CollisionPolygon &, size_t, size_t, uint8_t *);
+
+// Fastest kernel the cpu supports; NEON is part of every aarch64 cpu, AVX2 is checked at runtime
+inline CollideKernel selectCollideKernel()
+{
+#ifdef PATH_OPTIMIZER_FOOTPRINT_COLLISION_AVX2
+  if (__builtin_cpu_supports("avx2")) {
+    return &collideAvx2;
+  }
+#endif
+#ifdef PATH_OPTIMIZER_FOOTPRINT_COLLISION_NEON
+  return &collideNeon;
+#else
+  return &collideScalar;
+#endif
+}
+}  // namespace footprint_collision
+
+/**
+ * @brief Marks the footprints overlapping the convex polygon
+ * @param collides resized to the number of footprints, 1 for a collision
+ * @return number of colliding footprints
+ */
+inline size_t checkFootprintCollision(
+  const FootprintBatch & footprints, const CollisionPolygon & polygon,
+  std::vector<uint8_t> & collides)
+{
+  static const footprint_collision::CollideKernel kernel =
+    footprint_collision::selectCollideKernel();
+  collides.resize(footprints.size());
+  kernel(footprints, polygon, 0, footprints.size(), collides.data());
+  return static_cast<size_t>(std::count(collides.begin(), collides.end(), uint8_t{1}));
+}
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__FOOTPRINT_COLLISION_HPP_
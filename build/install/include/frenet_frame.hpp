@@ -0,0 +1,274 @@
+// Frenet frame of a reference path, shared by the stages that plan against the same path
+#ifndef PATH_OPTIMIZER__FRENET_FRAME_HPP_
+#define PATH_OPTIMIZER__FRENET_FRAME_HPP_
+
+#include "path_optimizer_types.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+// Arc length along the path and signed lateral offset (positive to the left)
+struct FrenetPoint
+{
+  double s{0.0};
+  double d{0.0};
+};
+
+/**
+ * FrenetFrame: arc length / lateral offset coordinates against one reference path
+ *
+ * Built once per path: cumulative arc length, unit direction of every segment and a segment
+ * index of blocks of block_size consecutive segments with their bounding boxes. toFrenet finds
+ * the exact nearest segment, but only tests the segments of blocks whose box is closer than the
+ * best segment so far, so an unordered obstacle point costs one box test per block and the
+ * segments of a few blocks instead of a scan of all segments. fromFrenet is a binary search on
+ * the arc length.
+ * Before the first and after the last point the first and last segment are extended.
+ *
+ * The batched versions take the result of the previous element as hint: for points ordered along
+ * the path (another trajectory, a predicted path) the hinted segment and its neighbours give a
+ * tight bound first, so the index only tests the segments of the block around them.
+ *
+ * All queries are const and keep no scratch state, so one frame can be shared by concurrent
+ * stages: stages that receive a path together with its frame (std::shared_ptr<const FrenetFrame>)
+ * check it with isBuiltFrom instead of rebuilding it.
+ */
+class FrenetFrame
+{
+public:
+  static constexpr size_t block_size = 16;
+
+  FrenetFrame() = default;
+
+  template <typename PointT>
+  explicit FrenetFrame(const std::vector<PointT> & points)
+  {
+    assign(points);
+  }
+
+  // Capacity preserving, so steady-state updates do not allocate
+  template <typename PointT>
+  void assign(const std::vector<PointT> & points)
+  {
+    const size_t n = points.size();
+    x_.resize(n);
+    y_.resize(n);
+    s_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      x_[i] = points[i].pose.position.x;
+      y_[i] = points[i].pose.position.y;
+      s_[i] = i == 0 ? 0.0 : s_[i - 1] + std::hypot(x_[i] - x_[i - 1], y_[i] - y_[i - 1]);
+    }
+    const size_t num_segments = n >= 2 ? n - 1 : 0;
+    ux_.resize(num_segments);
+    uy_.resize(num_segments);
+    for (size_t i = 0; i < num_segments; ++i) {
+      const double len = s_[i + 1] - s_[i];
+      // a zero length segment keeps the direction of the previous one
+      ux_[i] = len > 1e-9 ? (x_[i + 1] - x_[i]) / len : (i > 0 ? ux_[i - 1] : 1.0);
+      uy_[i] = len > 1e-9 ? (y_[i + 1] - y_[i]) / len : (i > 0 ? uy_[i - 1] : 0.0);
+    }
+    blocks_.resize((num_segments + block_size - 1) / block_size);
+    for (size_t b = 0; b < blocks_.size(); ++b) {
+      auto & block = blocks_[b];
+      const size_t first = b * block_size;
+      const size_t last = std::min(first + block_size, num_segments);  // segments [first, last)
+      block.min_x = block.max_x = x_[first];
+      block.min_y = block.max_y = y_[first];
+      for (size_t i = first + 1; i <= last; ++i) {
+        block.min_x = std::min(block.min_x, x_[i]);
+        block.max_x = std::max(block.max_x, x_[i]);
+        block.min_y = std::min(block.min_y, y_[i]);
+        block.max_y = std::max(block.max_y, y_[i]);
+      }
+    }
+  }
+
+  // Whether the frame was built from these points (same positions), O(n) without square roots
+  template <typename PointT>
+  bool isBuiltFrom(const std::vector<PointT> & points) const
+  {
+    if (points.size() != x_.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < points.size(); ++i) {
+      if (points[i].pose.position.x != x_[i] || points[i].pose.position.y != y_[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  size_t size() const { return s_.size(); }
+  bool empty() const { return s_.size() < 2; }
+  double getLength() const { return s_.empty() ? 0.0 : s_.back(); }
+  double getArcLength(const size_t i) const { return s_[i]; }
+
+  // Segment i is [point i, point i + 1]; the nearest segment to p
+  size_t findNearestSegmentIndex(
+    const Point & p, const std::optional<size_t> hint = std::nullopt) const
+  {
+    if (empty()) {
+      return 0;
+    }
+    size_t best = 0;
+    double best_dist = std::numeric_limits<double>::max();
+    if (hint) {
+      // the hinted segment and its neighbours bound the search, usually nothing else is visited
+      const size_t center = std::min(*hint, numSegments() - 1);
+      const size_t last = std::min(center + 1, numSegments() - 1);
+      for (size_t i = center > 0 ? center - 1 : 0; i <= last; ++i) {
+        updateBest(i, p, best, best_dist);
+      }
+    }
+    for (size_t b = 0; b < blocks_.size(); ++b) {
+      if (blocks_[b].squaredDistance(p.x, p.y) > best_dist) {
+        continue;
+      }
+      const size_t first = b * block_size;
+      const size_t last = std::min(first + block_size, numSegments());
+      for (size_t i = first; i < last; ++i) {
+        updateBest(i, p, best, best_dist);
+      }
+    }
+    return best;
+  }
+
+  FrenetPoint toFrenet(const Point & p, const std::optional<size_t> hint = std::nullopt) const
+  {
+    if (empty()) {
+      return {};
+    }
+    return toFrenet(findNearestSegmentIndex(p, hint), p);
+  }
+
+  // Frenet coordinates of p relative to segment seg (extended beyond its end points)
+  FrenetPoint toFrenet(const size_t seg, const Point & p) const
+  {
+    const double dx = p.x - x_[seg];
+    const double dy = p.y - y_[seg];
+    return {s_[seg] + dx * ux_[seg] + dy * uy_[seg], ux_[seg] * dy - uy_[seg] * dx};
+  }
+
+  Point fromFrenet(const FrenetPoint & f) const
+  {
+    if (empty()) {
+      return s_.empty() ? Point{} : Point{x_[0], y_[0], 0.0};
+    }
+    return fromFrenet(findSegmentAt(f.s), f);
+  }
+
+  Point fromFrenet(const size_t seg, const FrenetPoint & f) const
+  {
+    const double ds = f.s - s_[seg];
+    Point p;
+    p.x = x_[seg] + ds * ux_[seg] - f.d * uy_[seg];
+    p.y = y_[seg] + ds * uy_[seg] + f.d * ux_[seg];
+    return p;
+  }
+
+  // Segment containing arc length s, the first or last segment outside of the path
+  size_t findSegmentAt(const double s) const
+  {
+    if (empty()) {
+      return 0;
+    }
+    const auto it = std::upper_bound(s_.begin() + 1, s_.end() - 1, s);
+    return static_cast<size_t>(it - s_.begin()) - 1;
+  }
+
+  // Heading of the path at arc length s (of the segment, not interpolated)
+  double getYawAt(const double s) const
+  {
+    if (empty()) {
+      return 0.0;
+    }
+    const size_t seg = findSegmentAt(s);
+    return std::atan2(uy_[seg], ux_[seg]);
+  }
+
+  // Batched conversions; the output vectors are resized and keep their capacity
+  void toFrenet(const std::vector<Point> & points, std::vector<FrenetPoint> & output) const
+  {
+    output.resize(points.size());
+    if (empty()) {
+      std::fill(output.begin(), output.end(), FrenetPoint{});
+      return;
+    }
+    std::optional<size_t> hint;
+    for (size_t i = 0; i < points.size(); ++i) {
+      const size_t seg = findNearestSegmentIndex(points[i], hint);
+      output[i] = toFrenet(seg, points[i]);
+      hint = seg;
+    }
+  }
+
+  void fromFrenet(const std::vector<FrenetPoint> & coords, std::vector<Point> & output) const
+  {
+    output.resize(coords.size());
+    if (empty()) {
+      std::fill(output.begin(), output.end(), fromFrenet(FrenetPoint{}));
+      return;
+    }
+    size_t seg = 0;
+    for (size_t i = 0; i < coords.size(); ++i) {
+      // sorted input mostly stays on the previous segment or moves to the next one
+      if (!inSegment(seg, coords[i].s)) {
+        const bool next = seg + 1 < numSegments() && inSegment(seg + 1, coords[i].s);
+        seg = next ? seg + 1 : findSegmentAt(coords[i].s);
+      }
+      output[i] = fromFrenet(seg, coords[i]);
+    }
+  }
+
+private:
+  struct Block
+  {
+    double min_x, min_y, max_x, max_y;
+    double squaredDistance(const double px, const double py) const
+    {
+      const double dx = std::max({min_x - px, 0.0, px - max_x});
+      const double dy = std::max({min_y - py, 0.0, py - max_y});
+      return dx * dx + dy * dy;
+    }
+  };
+
+  size_t numSegments() const { return ux_.size(); }
+
+  // whether findSegmentAt(s) is seg
+  bool inSegment(const size_t seg, const double s) const
+  {
+    return (seg == 0 || s >= s_[seg]) && (seg + 1 == numSegments() || s < s_[seg + 1]);
+  }
+
+  void updateBest(const size_t seg, const Point & p, size_t & best, double & best_dist) const
+  {
+    const double len = s_[seg + 1] - s_[seg];
+    const double t = std::clamp((p.x - x_[seg]) * ux_[seg] + (p.y - y_[seg]) * uy_[seg], 0.0, len);
+    const double dx = x_[seg] + t * ux_[seg] - p.x;
+    const double dy = y_[seg] + t * uy_[seg] - p.y;
+    const double d = dx * dx + dy * dy;
+    if (d < best_dist) {
+      best_dist = d;
+      best = seg;
+    }
+  }
+
+  std::vector<double> x_;
+  std::vector<double> y_;
+  std::vector<double> s_;
+  std::vector<double> ux_;  // unit direction of segment i
+  std::vector<double> uy_;
+  std::vector<Block> blocks_;
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__FRENET_FRAME_HPP_
@@ -0,0 +1,327 @@
+// Low overhead counters, histograms and scoped timers for hot paths
+#ifndef PATH_OPTIMIZER__INSTRUMENTATION_HPP_
+#define PATH_OPTIMIZER__INSTRUMENTATION_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * Instrumentation: process wide metrics that can stay enabled in the planning cycle
+ *
+ * count(), observe() and ScopedTimer only push a small sample into a single-producer ring buffer
+ * owned by the calling thread, so the hot path takes no lock and shares no cache line with other
+ * threads. A background thread drains the buffers every period, aggregates counters (sums) and
+ * histograms (log2 buckets, min/max/mean) and appends one JSON line per metric to the output file.
+ * Unless start() was called every call returns after one relaxed load.
+ *
+ * Metric names must point to strings with static storage duration (usually literals); they are
+ * compared by content when aggregating, so the same name may be used from several threads.
+ *
+ * Usage:
+ *   Instrumentation::instance().start("instrumentation.jsonl");
+ *   {
+ *     Instrumentation::ScopedTimer timer("mpt.optimize");
+ *     ...
+ *   }
+ *   Instrumentation::instance().count("mpt.fallback");
+ */
+class Instrumentation
+{
+public:
+  static constexpr size_t num_buckets = 64;
+
+  struct Histogram
+  {
+    uint64_t count{0};
+    int64_t sum{0};
+    int64_t min{std::numeric_limits<int64_t>::max()};
+    int64_t max{std::numeric_limits<int64_t>::min()};
+    std::array<uint64_t, num_buckets> buckets{};  // bucket b holds values in [2^(b-1), 2^b)
+
+    // Upper bound of the bucket that contains the given quantile
+    int64_t quantile(const double q) const
+    {
+      if (count == 0) {
+        return 0;
+      }
+      const auto target = static_cast<uint64_t>(q * static_cast<double>(count - 1)) + 1;
+      uint64_t seen = 0;
+      for (size_t b = 0; b < num_buckets; ++b) {
+        seen += buckets[b];
+        if (seen >= target) {
+          return b == 0 ? 0 : std::min(max, static_cast<int64_t>((uint64_t{1} << (b - 1)) * 2 - 1));
+        }
+      }
+      return max;
+    }
+  };
+
+  struct Snapshot
+  {
+    std::map<std::string, int64_t> counters;
+    std::map<std::string, Histogram> histograms;
+  };
+
+  static Instrumentation & instance()
+  {
+    static Instrumentation instrumentation;
+    return instrumentation;
+  }
+
+  Instrumentation(const Instrumentation &) = delete;
+  Instrumentation & operator=(const Instrumentation &) = delete;
+
+  ~Instrumentation() { stop(); }
+
+  /**
+   * @brief Enables recording and starts the drain thread
+   * @param path output file, opened for appending; empty to only aggregate (see snapshot())
+   * @param period drain and write period
+   */
+  void start(
+    const std::string & path,
+    const std::chrono::milliseconds period = std::chrono::milliseconds(1000))
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (drain_thread_.joinable()) {
+      return;
+    }
+    if (!path.empty()) {
+      file_.open(path, std::ios::app);
+    }
+    period_ = period;
+    stop_ = false;
+    enabled_.store(true, std::memory_order_relaxed);
+    drain_thread_ = std::thread([this] { drainLoop(); });
+  }
+
+  // Disables recording, drains the remaining samples and writes them
+  void stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!drain_thread_.joinable()) {
+        return;
+      }
+      enabled_.store(false, std::memory_order_relaxed);
+      stop_ = true;
+    }
+    cv_.notify_one();
+    drain_thread_.join();
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.close();
+  }
+
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  void count(const char * name, const int64_t delta = 1) { push(name, Kind::Counter, delta); }
+
+  void observe(const char * name, const int64_t value) { push(name, Kind::Histogram, value); }
+
+  // Aggregated metrics since start(), including samples not yet written
+  Snapshot snapshot()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    drainBuffers();
+    return total_;
+  }
+
+  // Number of samples dropped because a thread buffer was full
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+  static int64_t now()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+  }
+
+  // Observes the elapsed time of its scope in nanoseconds
+  class ScopedTimer
+  {
+  public:
+    explicit ScopedTimer(const char * name)
+    : name_(name), start_ns_(Instrumentation::instance().enabled() ? now() : -1)
+    {
+    }
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer & operator=(const ScopedTimer &) = delete;
+    ~ScopedTimer()
+    {
+      if (start_ns_ >= 0) {
+        Instrumentation::instance().observe(name_, now() - start_ns_);
+      }
+    }
+
+  private:
+    const char * name_;
+    int64_t start_ns_;
+  };
+
+private:
+  enum class Kind : uint8_t { Counter, Histogram };
+
+  struct Sample
+  {
+    const char * name;
+    int64_t value;
+    Kind kind;
+  };
+
+  // Single producer (the owning thread), single consumer (the drain thread, under mutex_)
+  struct ThreadBuffer
+  {
+    static constexpr size_t capacity = 1U << 12U;
+    std::array<Sample, capacity> samples;
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+    std::atomic<bool> alive{true};
+  };
+
+  // Registers the buffer on first use in a thread and marks it for removal at thread exit
+  struct ThreadHandle
+  {
+    std::shared_ptr<ThreadBuffer> buffer;
+    ~ThreadHandle()
+    {
+      if (buffer) {
+        buffer->alive.store(false, std::memory_order_release);
+      }
+    }
+  };
+
+  Instrumentation() = default;
+
+  ThreadBuffer & threadBuffer()
+  {
+    thread_local ThreadHandle handle;
+    if (!handle.buffer) {
+      handle.buffer = std::make_shared<ThreadBuffer>();
+      std::lock_guard<std::mutex> lock(mutex_);
+      buffers_.push_back(handle.buffer);
+    }
+    return *handle.buffer;
+  }
+
+  void push(const char * name, const Kind kind, const int64_t value)
+  {
+    if (!enabled_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    ThreadBuffer & buffer = threadBuffer();
+    const size_t head = buffer.head.load(std::memory_order_relaxed);
+    if (head - buffer.tail.load(std::memory_order_acquire) >= ThreadBuffer::capacity) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    buffer.samples[head & (ThreadBuffer::capacity - 1)] = Sample{name, value, kind};
+    buffer.head.store(head + 1, std::memory_order_release);
+  }
+
+  static size_t bucketOf(const int64_t value)
+  {
+    size_t bucket = 0;
+    for (auto v = static_cast<uint64_t>(std::max<int64_t>(value, 0)); v != 0; v >>= 1U) {
+      ++bucket;
+    }
+    return std::min(bucket, num_buckets - 1);
+  }
+
+  static void add(Snapshot & snapshot, const Sample & sample)
+  {
+    if (sample.kind == Kind::Counter) {
+      snapshot.counters[sample.name] += sample.value;
+      return;
+    }
+    auto & h = snapshot.histograms[sample.name];
+    ++h.count;
+    h.sum += sample.value;
+    h.min = std::min(h.min, sample.value);
+    h.max = std::max(h.max, sample.value);
+    ++h.buckets[bucketOf(sample.value)];
+  }
+
+  // Requires mutex_
+  void drainBuffers()
+  {
+    for (auto it = buffers_.begin(); it != buffers_.end();) {
+      ThreadBuffer & buffer = **it;
+      const bool alive = buffer.alive.load(std::memory_order_acquire);
+      const size_t head = buffer.head.load(std::memory_order_acquire);
+      size_t tail = buffer.tail.load(std::memory_order_relaxed);
+      for (; tail != head; ++tail) {
+        const Sample & sample = buffer.samples[tail & (ThreadBuffer::capacity - 1)];
+        add(period_total_, sample);
+        add(total_, sample);
+      }
+      buffer.tail.store(tail, std::memory_order_release);
+      it = alive ? std::next(it) : buffers_.erase(it);
+    }
+  }
+
+  // Requires mutex_
+  void write(const int64_t stamp_ns)
+  {
+    if (file_.is_open()) {
+      for (const auto & [name, value] : period_total_.counters) {
+        file_ << "{\"stamp\":" << stamp_ns << ",\"name\":\"" << name
+              << "\",\"type\":\"counter\",\"value\":" << value << "}\n";
+      }
+      for (const auto & [name, h] : period_total_.histograms) {
+        file_ << "{\"stamp\":" << stamp_ns << ",\"name\":\"" << name
+              << "\",\"type\":\"histogram\",\"count\":" << h.count
+              << ",\"mean\":" << h.sum / static_cast<int64_t>(std::max<uint64_t>(h.count, 1))
+              << ",\"min\":" << h.min << ",\"p50\":" << h.quantile(0.5)
+              << ",\"p99\":" << h.quantile(0.99) << ",\"max\":" << h.max << "}\n";
+      }
+      file_.flush();
+    }
+    period_total_ = Snapshot{};
+  }
+
+  void drainLoop()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+      cv_.wait_for(lock, period_, [this] { return stop_; });
+      drainBuffers();
+      write(std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::system_clock::now().time_since_epoch())
+              .count());
+    }
+  }
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<uint64_t> dropped_{0};
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_{false};
+  std::chrono::milliseconds period_{1000};
+  std::thread drain_thread_;
+  std::ofstream file_;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+  Snapshot period_total_;
+  Snapshot total_;
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__INSTRUMENTATION_HPP_
@@ -0,0 +1,133 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "lanelet2_core/LaneletMap.h"
+
+namespace lanelet {
+
+/**
+ * @brief Compact handle of a primitive in a DenseIdIndex: its position 0..n-1 in the index.
+ *
+ * Four bytes instead of a shared pointer handle or a 64 bit id, usable directly as index of side tables
+ * (IdIndexTable). Only meaningful together with the index that produced it.
+ */
+struct IdIndex {
+  static constexpr uint32_t Invalid = std::numeric_limits<uint32_t>::max();
+  uint32_t value{Invalid};
+
+  constexpr IdIndex() noexcept = default;
+  constexpr explicit IdIndex(uint32_t value) noexcept : value{value} {}
+  constexpr bool valid() const noexcept { return value != Invalid; }
+  constexpr explicit operator bool() const noexcept { return valid(); }
+  friend constexpr bool operator==(IdIndex lhs, IdIndex rhs) noexcept { return lhs.value == rhs.value; }
+  friend constexpr bool operator!=(IdIndex lhs, IdIndex rhs) noexcept { return lhs.value != rhs.value; }
+  friend constexpr bool operator<(IdIndex lhs, IdIndex rhs) noexcept { return lhs.value < rhs.value; }
+};
+
+/**
+ * @brief Remaps the ids of one layer to 0..n-1, in ascending id order.
+ *
+ * Built once after the map is loaded. find(Id) is an array access if the ids of the layer are compact enough (at most
+ * DenseFactor times more ids in [min, max] than elements, the usual case for maps from one tool), otherwise a binary
+ * search over the sorted ids. Going back from an IdIndex to the primitive or its id is always an array access.
+ *
+ * Like the other frozen structures, the index keeps copies of the primitive handles and has to be rebuilt when the
+ * layer changes.
+ */
+template <typename T>
+class DenseIdIndex {
+ public:
+  using PrimitiveT = T;
+  using ConstPrimitiveT = traits::ConstPrimitiveType<T>;
+  static constexpr uint64_t DenseFactor = 16;
+
+  DenseIdIndex() = default;
+  explicit DenseIdIndex(const PrimitiveLayer<T>& layer) {
+    std::vector<std::pair<Id, ConstPrimitiveT>> items;
+    items.reserve(layer.size());
+    for (const auto& prim : layer) {
+      items.emplace_back(idOf(prim), prim);
+    }
+    std::sort(items.begin(), items.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    ids_.reserve(items.size());
+    elements_.reserve(items.size());
+    for (auto& item : items) {
+      ids_.push_back(item.first);
+      elements_.push_back(std::move(item.second));
+    }
+    if (!ids_.empty()) {
+      const auto range = static_cast<uint64_t>(ids_.back()) - static_cast<uint64_t>(ids_.front()) + 1;
+      if (range <= DenseFactor * ids_.size()) {
+        minId_ = ids_.front();
+        direct_.assign(range, IdIndex::Invalid);
+        for (uint32_t i = 0; i < ids_.size(); ++i) {
+          direct_[static_cast<uint64_t>(ids_[i]) - static_cast<uint64_t>(minId_)] = i;
+        }
+      }
+    }
+  }
+
+  size_t size() const noexcept { return ids_.size(); }
+  bool empty() const noexcept { return ids_.empty(); }
+
+  //! the index of the primitive with this id, invalid if the layer has none
+  IdIndex find(Id id) const {
+    if (!direct_.empty()) {
+      const auto offset = static_cast<uint64_t>(id) - static_cast<uint64_t>(minId_);
+      return id >= minId_ && offset < direct_.size() ? IdIndex(direct_[offset]) : IdIndex();
+    }
+    const auto it = std::lower_bound(ids_.begin(), ids_.end(), id);
+    return it != ids_.end() && *it == id ? IdIndex(static_cast<uint32_t>(it - ids_.begin())) : IdIndex();
+  }
+  bool contains(Id id) const { return find(id).valid(); }
+
+  Id id(IdIndex idx) const { return ids_[idx.value]; }
+  const ConstPrimitiveT& operator[](IdIndex idx) const { return elements_[idx.value]; }
+  //! all primitives in index order
+  const std::vector<ConstPrimitiveT>& elements() const noexcept { return elements_; }
+
+ private:
+  static Id idOf(const RegulatoryElementConstPtr& regElem) { return regElem->id(); }
+  template <typename PrimT>
+  static Id idOf(const PrimT& prim) {
+    return prim.id();
+  }
+
+  std::vector<Id> ids_;  //!< sorted
+  std::vector<ConstPrimitiveT> elements_;
+  Id minId_{0};
+  std::vector<uint32_t> direct_;  //!< id - minId_ -> index, only for compact id ranges
+};
+
+/**
+ * @brief Per primitive side table of a DenseIdIndex, replacing std::unordered_map<Id, V>.
+ *
+ * Sized for the index on construction, every primitive has a (default constructed) value.
+ */
+template <typename V>
+class IdIndexTable {
+  static_assert(!std::is_same<V, bool>::value, "use uint8_t, std::vector<bool> has no element references");
+
+ public:
+  IdIndexTable() = default;
+  template <typename T>
+  explicit IdIndexTable(const DenseIdIndex<T>& index, const V& init = V()) : values_(index.size(), init) {}
+
+  size_t size() const noexcept { return values_.size(); }
+  V& operator[](IdIndex idx) { return values_[idx.value]; }
+  const V& operator[](IdIndex idx) const { return values_[idx.value]; }
+  typename std::vector<V>::iterator begin() noexcept { return values_.begin(); }
+  typename std::vector<V>::iterator end() noexcept { return values_.end(); }
+  typename std::vector<V>::const_iterator begin() const noexcept { return values_.begin(); }
+  typename std::vector<V>::const_iterator end() const noexcept { return values_.end(); }
+
+ private:
+  std::vector<V> values_;
+};
+
+}  // namespace lanelet
@@ -0,0 +1,257 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "lanelet2_core/LaneletMap.h"
+
+namespace lanelet {
+
+/**
+ * @brief Stores every distinct string once and identifies it by a dense id.
+ *
+ * Ids are assigned in insertion order and the strings never move, so references returned by str() stay valid for the
+ * lifetime of the pool. The names of the AttributeName enum are interned on construction, so looking them up needs no
+ * string at all.
+ */
+class StringPool {
+ public:
+  static constexpr uint32_t InvalId = std::numeric_limits<uint32_t>::max();
+
+  StringPool() {
+    for (const auto& item : AttributeNamesString::Map) {
+      names_[static_cast<size_t>(item.second)] = intern(item.first);
+    }
+  }
+
+  uint32_t intern(const std::string& s) {
+    auto it = ids_.find(s);
+    if (it != ids_.end()) {
+      return it->second;
+    }
+    const auto id = static_cast<uint32_t>(strings_.size());
+    strings_.push_back(s);
+    ids_.emplace(s, id);
+    return id;
+  }
+
+  //! id of the string or InvalId if it was never interned
+  uint32_t find(const std::string& s) const {
+    auto it = ids_.find(s);
+    return it == ids_.end() ? InvalId : it->second;
+  }
+  uint32_t find(AttributeName name) const { return names_[static_cast<size_t>(name)]; }
+
+  const std::string& str(uint32_t id) const { return strings_[id]; }
+  size_t size() const noexcept { return strings_.size(); }
+
+ private:
+  std::deque<std::string> strings_;
+  std::unordered_map<std::string, uint32_t> ids_;
+  std::array<uint32_t, std::extent<decltype(AttributeNamesString::Map)>::value> names_{};
+};
+
+/**
+ * @brief An attribute with interned key and value and its numeric interpretations parsed up front.
+ *
+ * Unlike Attribute, it has no lazily filled cache, so it can be read from many threads without synchronization.
+ */
+struct FrozenAttribute {
+  uint32_t key{StringPool::InvalId};
+  uint32_t value{StringPool::InvalId};
+  double number{std::numeric_limits<double>::quiet_NaN()};  //!< NaN if the value is not a number
+  int64_t integer{0};
+  bool isNumber{false};
+  bool isInteger{false};
+
+  Optional<double> asDouble() const { return isNumber ? Optional<double>(number) : Optional<double>(); }
+  Optional<int> asInt() const { return isInteger ? Optional<int>(static_cast<int>(integer)) : Optional<int>(); }
+  Optional<Id> asId() const { return isInteger ? Optional<Id>(static_cast<Id>(integer)) : Optional<Id>(); }
+};
+
+/**
+ * @brief Read only view on the frozen attributes of one primitive, sorted by key id.
+ *
+ * Keys are compared as ids, a lookup by string costs one hash lookup in the pool and a binary search over the (few)
+ * attributes of the primitive.
+ */
+class FrozenAttributes {
+ public:
+  using const_iterator = const FrozenAttribute*;  // NOLINT
+
+  FrozenAttributes() = default;
+  FrozenAttributes(const FrozenAttribute* begin, const FrozenAttribute* end, const StringPool* pool)
+      : begin_{begin}, end_{end}, pool_{pool} {}
+
+  const_iterator begin() const noexcept { return begin_; }
+  const_iterator end() const noexcept { return end_; }
+  size_t size() const noexcept { return static_cast<size_t>(end_ - begin_); }
+  bool empty() const noexcept { return begin_ == end_; }
+
+  const FrozenAttribute* find(uint32_t key) const {
+    auto it = std::lower_bound(begin_, end_, key, [](const FrozenAttribute& a, uint32_t k) { return a.key < k; });
+    return it != end_ && it->key == key ? it : nullptr;
+  }
+  const FrozenAttribute* find(const std::string& key) const { return pool_ ? find(pool_->find(key)) : nullptr; }
+  const FrozenAttribute* find(AttributeName name) const { return pool_ ? find(pool_->find(name)) : nullptr; }
+
+  //! value of the attribute or an empty string if it does not exist
+  template <typename KeyT>
+  const std::string& value(const KeyT& key) const {
+    static const std::string Empty;
+    const auto* attr = find(key);
+    return attr ? pool_->str(attr->value) : Empty;
+  }
+  template <typename KeyT>
+  bool has(const KeyT& key) const {
+    return find(key) != nullptr;
+  }
+  template <typename KeyT>
+  Optional<double> asDouble(const KeyT& key) const {
+    const auto* attr = find(key);
+    return attr ? attr->asDouble() : Optional<double>();
+  }
+  template <typename KeyT>
+  Optional<int> asInt(const KeyT& key) const {
+    const auto* attr = find(key);
+    return attr ? attr->asInt() : Optional<int>();
+  }
+
+  const std::string& key(const FrozenAttribute& attr) const { return pool_->str(attr.key); }
+  const std::string& value(const FrozenAttribute& attr) const { return pool_->str(attr.value); }
+
+ private:
+  const FrozenAttribute* begin_{nullptr};
+  const FrozenAttribute* end_{nullptr};
+  const StringPool* pool_{nullptr};
+};
+
+/**
+ * @brief Interned, immutable copy of the attributes of all primitives of a map.
+ *
+ * The attributes of all primitives of a layer are stored in one flat array, grouped by primitive and sorted by key.
+ * Primitives are looked up by id with a binary search. Built once, the index is never modified, so it is safe for
+ * concurrent reads. Changes to the attributes of the map after construction are not reflected.
+ */
+class FrozenAttributeIndex {
+ public:
+  explicit FrozenAttributeIndex(const LaneletMap& map) {
+    build(lanelets_, map.laneletLayer);
+    build(areas_, map.areaLayer);
+    build(regulatoryElements_, map.regulatoryElementLayer);
+    build(polygons_, map.polygonLayer);
+    build(lineStrings_, map.lineStringLayer);
+    build(points_, map.pointLayer);
+  }
+
+  FrozenAttributes lanelet(Id id) const { return lanelets_.get(id, pool_); }
+  FrozenAttributes area(Id id) const { return areas_.get(id, pool_); }
+  FrozenAttributes regulatoryElement(Id id) const { return regulatoryElements_.get(id, pool_); }
+  FrozenAttributes polygon(Id id) const { return polygons_.get(id, pool_); }
+  FrozenAttributes lineString(Id id) const { return lineStrings_.get(id, pool_); }
+  FrozenAttributes point(Id id) const { return points_.get(id, pool_); }
+
+  FrozenAttributes attributes(const ConstLanelet& llt) const { return lanelet(llt.id()); }
+  FrozenAttributes attributes(const ConstArea& area) const { return this->area(area.id()); }
+  FrozenAttributes attributes(const RegulatoryElementConstPtr& regElem) const {
+    return regulatoryElement(regElem->id());
+  }
+  FrozenAttributes attributes(const ConstPolygon3d& poly) const { return polygon(poly.id()); }
+  FrozenAttributes attributes(const ConstLineString3d& ls) const { return lineString(ls.id()); }
+  FrozenAttributes attributes(const ConstPoint3d& p) const { return point(p.id()); }
+
+  const StringPool& strings() const noexcept { return pool_; }
+
+  //! parses like Attribute::asDouble/asInt: the whole value has to be a number
+  static void parse(FrozenAttribute& attr, const std::string& value) {
+    if (value.empty()) {
+      return;
+    }
+    const char* begin = value.c_str();
+    char* end = nullptr;
+    errno = 0;
+    const double number = std::strtod(begin, &end);
+    if (end != begin && *end == '\0' && errno == 0) {
+      attr.number = number;
+      attr.isNumber = true;
+    }
+    errno = 0;
+    const long long integer = std::strtoll(begin, &end, 10);  // NOLINT
+    if (end != begin && *end == '\0' && errno == 0) {
+      attr.integer = integer;
+      attr.isInteger = true;
+    }
+  }
+
+ private:
+  struct Table {
+    std::vector<std::pair<Id, uint32_t>> offsets;  //!< (id, first attribute), sorted by id
+    std::vector<FrozenAttribute> attributes;
+
+    FrozenAttributes get(Id id, const StringPool& pool) const {
+      auto it = std::lower_bound(offsets.begin(), offsets.end(), id,
+                                 [](const std::pair<Id, uint32_t>& e, Id i) { return e.first < i; });
+      if (it == offsets.end() || it->first != id) {
+        return {nullptr, nullptr, &pool};
+      }
+      const auto end = std::next(it) == offsets.end() ? attributes.size() : std::next(it)->second;
+      return {attributes.data() + it->second, attributes.data() + end, &pool};
+    }
+  };
+
+  static Id idOf(const RegulatoryElementConstPtr& regElem) { return regElem->id(); }
+  static const AttributeMap& attributesOf(const RegulatoryElementConstPtr& regElem) { return regElem->attributes(); }
+  template <typename PrimT>
+  static Id idOf(const PrimT& prim) {
+    return prim.id();
+  }
+  template <typename PrimT>
+  static const AttributeMap& attributesOf(const PrimT& prim) {
+    return prim.attributes();
+  }
+
+  template <typename LayerT>
+  void build(Table& table, const LayerT& layer) {
+    std::vector<std::pair<Id, const AttributeMap*>> prims;
+    prims.reserve(layer.size());
+    for (const auto& prim : layer) {
+      prims.emplace_back(idOf(prim), &attributesOf(prim));
+    }
+    std::sort(prims.begin(), prims.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    table.offsets.reserve(prims.size());
+    for (const auto& prim : prims) {
+      const auto first = table.attributes.size();
+      table.offsets.emplace_back(prim.first, static_cast<uint32_t>(first));
+      for (const auto& attr : *prim.second) {
+        FrozenAttribute frozen;
+        frozen.key = pool_.intern(attr.first);
+        frozen.value = pool_.intern(attr.second.value());
+        parse(frozen, attr.second.value());
+        table.attributes.push_back(frozen);
+      }
+      std::sort(table.attributes.begin() + first, table.attributes.end(),
+                [](const FrozenAttribute& lhs, const FrozenAttribute& rhs) { return lhs.key < rhs.key; });
+    }
+  }
+
+  StringPool pool_;
+  Table lanelets_;
+  Table areas_;
+  Table regulatoryElements_;
+  Table polygons_;
+  Table lineStrings_;
+  Table points_;
+};
+
+}  // namespace lanelet
@@ -0,0 +1,87 @@
+#pragma once
+#include <array>
+
+#include <boost/geometry/algorithms/covered_by.hpp>
+#include <boost/geometry/algorithms/intersects.hpp>
+
+#include "lanelet2_core/DenseIdIndex.h"
+#include "lanelet2_core/geometry/Area.h"
+#include "lanelet2_core/geometry/Lanelet.h"
+
+namespace lanelet {
+
+/**
+ * @brief 2d geometry of a lanelet that the geometry functions need on every call, computed once.
+ *
+ * The polygon is the open ring of the left bound followed by the inverted right bound as plain points (the points of
+ * ConstLanelet::polygon2d()). Inverting a lanelet only rotates this ring, so one entry serves both orientations. The
+ * 2d centerline is kept in both orientations, so LaneletRef can use the one of an inverted lanelet without creating
+ * handles of the inverted centerline.
+ *
+ * Kept in a side table (see FrozenLaneletMap) instead of on LaneletData, so the layout of the data objects and the
+ * prebuilt libraries stay in sync. Like the other frozen structures, it is not updated when the bounds change.
+ */
+struct FrozenLaneletGeometry {
+  BoundingBox2d boundingBox;
+  BasicPolygon2d polygon;
+  std::array<BasicLineString2d, 2> centerline;  //!< [0] in the direction of the lanelet in the map, [1] inverted
+  double length{0.};                            //!< 2d length of the centerline
+
+  FrozenLaneletGeometry() = default;
+  explicit FrozenLaneletGeometry(const ConstLanelet& llt) : polygon{llt.polygon2d().basicPolygon()} {
+    for (const auto& p : polygon) {
+      boundingBox.extend(p);
+    }
+    const auto centerline2d = llt.centerline2d();
+    centerline[0].assign(centerline2d.basicBegin(), centerline2d.basicEnd());
+    centerline[1].assign(centerline[0].rbegin(), centerline[0].rend());
+    length = static_cast<double>(geometry::length(centerline[0]));
+  }
+
+  //! same as geometry::inside(lanelet, point), rejects on the bounding box first
+  bool inside(const BasicPoint2d& point) const {
+    return boundingBox.contains(point) && boost::geometry::covered_by(point, polygon);
+  }
+
+  //! same as geometry::intersects2d(lanelet, other), rejects on the bounding boxes first
+  bool intersects2d(const FrozenLaneletGeometry& other) const {
+    return this == &other || (!boundingBox.intersection(other.boundingBox).isEmpty() &&
+                              boost::geometry::intersects(polygon, other.polygon));
+  }
+};
+
+//! @brief 2d geometry of an area (outer and inner bounds as plain points), computed once. See FrozenLaneletGeometry.
+struct FrozenAreaGeometry {
+  BoundingBox2d boundingBox;
+  BasicPolygonWithHoles2d polygon;
+
+  FrozenAreaGeometry() = default;
+  explicit FrozenAreaGeometry(const ConstArea& area) : polygon{area.basicPolygonWithHoles2d()} {
+    for (const auto& p : polygon.outer) {
+      boundingBox.extend(p);
+    }
+  }
+
+  //! same as geometry::inside(area, point), rejects on the bounding box first
+  bool inside(const BasicPoint2d& point) const {
+    return boundingBox.contains(point) && boost::geometry::covered_by(point, polygon);
+  }
+
+  //! same as geometry::intersects2d(area, other), rejects on the bounding boxes first
+  bool intersects2d(const FrozenAreaGeometry& other) const {
+    return this == &other || (!boundingBox.intersection(other.boundingBox).isEmpty() &&
+                              boost::geometry::intersects(polygon, other.polygon));
+  }
+};
+
+//! Computes the geometry of every primitive of the index, in index order
+template <typename GeometryT, typename T>
+IdIndexTable<GeometryT> makeFrozenGeometry(const DenseIdIndex<T>& index) {
+  IdIndexTable<GeometryT> table(index);
+  for (uint32_t i = 0; i < index.size(); ++i) {
+    table[IdIndex(i)] = GeometryT(index[IdIndex(i)]);
+  }
+  return table;
+}
+
+}  // namespace lanelet
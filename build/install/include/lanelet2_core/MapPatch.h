@@ -0,0 +1,584 @@
+#pragma once
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "lanelet2_core/LaneletMap.h"
+
+namespace lanelet {
+
+/**
+ * @brief A set of changes to a LaneletMap.
+ *
+ * The changed primitives are given as a (small) LaneletMap and are matched with the primitives of the target map by
+ * id: primitives that exist in the target are modified, all others are added. Like every map, the patch has to contain
+ * all primitives its primitives reference, e.g. the bounds and points of a changed lanelet, even if only its attributes
+ * changed. Primitives listed in removed are deleted from the target, no matter in which layer they are.
+ *
+ * A patch can be written as an ordinary map file: use fromMap() to turn every primitive that is tagged with
+ * ActionTag=DeleteAction into a removal.
+ */
+struct MapPatch {
+  static constexpr const char ActionTag[] = "patch:action";
+  static constexpr const char DeleteAction[] = "delete";
+
+  MapPatch() : changes{std::make_unique<LaneletMap>()} {}
+  explicit MapPatch(LaneletMapUPtr changes, std::vector<Id> removed = {})
+      : changes{changes ? std::move(changes) : std::make_unique<LaneletMap>()}, removed{std::move(removed)} {}
+
+  //! Creates a patch from a map in which the primitives to remove are tagged with ActionTag=DeleteAction
+  static MapPatch fromMap(LaneletMapUPtr map) {
+    MapPatch patch(std::move(map));
+    auto collect = [&patch](const auto& layer) {
+      for (const auto& prim : layer) {
+        const auto& attrs = attributesOf(prim);
+        auto action = attrs.find(ActionTag);
+        if (action != attrs.end() && action->second.value() == DeleteAction) {
+          patch.removed.push_back(traits::getId(prim));
+        }
+      }
+    };
+    auto& layers = *patch.changes;
+    collect(layers.pointLayer);
+    collect(layers.lineStringLayer);
+    collect(layers.polygonLayer);
+    collect(layers.laneletLayer);
+    collect(layers.areaLayer);
+    collect(layers.regulatoryElementLayer);
+    return patch;
+  }
+
+  LaneletMapUPtr changes;  //!< new and modified primitives
+  std::vector<Id> removed;
+
+ private:
+  static const AttributeMap& attributesOf(const RegulatoryElementConstPtr& regElem) { return regElem->attributes(); }
+  template <typename PrimT>
+  static const AttributeMap& attributesOf(const PrimT& prim) {
+    return prim.attributes();
+  }
+};
+
+//! What applyPatch did to a map
+struct MapPatchResult {
+  Ids added;     //!< ids of the new primitives
+  Ids modified;  //!< ids of the primitives whose data was replaced by the patch
+  Ids removed;   //!< ids of the primitives that were deleted
+
+  //! lanelets that were added or modified or whose geometry or regulatory elements changed through other primitives
+  Ids affectedLanelets;
+  //! lanelets that were deleted
+  Ids removedLanelets;
+
+  bool empty() const noexcept { return added.empty() && modified.empty() && removed.empty(); }
+
+  //! true if one of the lanelets was changed or removed by the patch
+  bool affects(const ConstLanelets& lanelets) const {
+    std::unordered_set<Id> ids(affectedLanelets.begin(), affectedLanelets.end());
+    ids.insert(removedLanelets.begin(), removedLanelets.end());
+    return std::any_of(lanelets.begin(), lanelets.end(), [&ids](const ConstLanelet& llt) { return ids.count(llt.id()); });
+  }
+};
+
+namespace internal {
+//! Gives the patch access to adding and removing single layer entries. Only the map itself can do that otherwise.
+template <typename T>
+class PatchLayerAccess : public PrimitiveLayer<T> {
+ public:
+  static void insert(PrimitiveLayer<T>& layer, const T& prim) { (layer.*(&PatchLayerAccess::add))(prim); }
+  static void erase(PrimitiveLayer<T>& layer, Id id) { (layer.*(&PatchLayerAccess::remove))(id); }
+};
+
+class MapPatcher {
+ public:
+  MapPatcher(LaneletMap& map, const MapPatch& patch) : map_{map}, patch_{*patch.changes} {
+    removed_.insert(patch.removed.begin(), patch.removed.end());
+  }
+
+  MapPatchResult apply() {
+    collectUpserts();
+    validate();
+    collectAffected();
+    unindex();
+    updatePoints();
+    updateLineStrings(patch_.lineStringLayer, upsertedLineStrings_, lineStrings_);
+    updateLineStrings(patch_.polygonLayer, upsertedPolygons_, polygons_);
+    updateLanelets();
+    updateAreas();
+    updateRegulatoryElements();
+    relinkRegulatoryElements();
+    reindex();
+    return std::move(result_);
+  }
+
+ private:
+  template <typename T>
+  using IdMap = std::unordered_map<Id, T>;
+
+  // ---- collection ----
+  template <typename PatchLayerT, typename TargetLayerT>
+  void collectUpserts(const PatchLayerT& patchLayer, const TargetLayerT& targetLayer, std::vector<Id>& upserts) {
+    for (const auto& prim : patchLayer) {
+      const auto id = traits::getId(prim);
+      if (removed_.count(id) != 0) {
+        continue;
+      }
+      upserts.push_back(id);
+      (targetLayer.exists(id) ? result_.modified : result_.added).push_back(id);
+    }
+  }
+
+  void collectUpserts() {
+    collectUpserts(patch_.pointLayer, map_.pointLayer, upsertedPoints_);
+    collectUpserts(patch_.lineStringLayer, map_.lineStringLayer, upsertedLineStrings_);
+    collectUpserts(patch_.polygonLayer, map_.polygonLayer, upsertedPolygons_);
+    collectUpserts(patch_.laneletLayer, map_.laneletLayer, upsertedLanelets_);
+    collectUpserts(patch_.areaLayer, map_.areaLayer, upsertedAreas_);
+    collectUpserts(patch_.regulatoryElementLayer, map_.regulatoryElementLayer, upsertedRegElems_);
+    upserted_.insert(result_.added.begin(), result_.added.end());
+    upserted_.insert(result_.modified.begin(), result_.modified.end());
+  }
+
+  //! a primitive may only be removed if everything in the patched map that referenced it is removed or replaced
+  void validate() {
+    std::vector<std::string> errors;
+    auto check = [&](Id id, const auto& users) {
+      for (const auto& user : users) {
+        const auto userId = traits::getId(user);
+        if (removed_.count(userId) == 0 && upserted_.count(userId) == 0) {
+          errors.push_back("Primitive " + std::to_string(id) + " can not be removed, it is still used by " +
+                           std::to_string(userId));
+        }
+      }
+    };
+    for (auto id : removed_) {
+      if (map_.pointLayer.exists(id)) {
+        auto p = map_.pointLayer.get(id);
+        check(id, map_.lineStringLayer.findUsages(p));
+        check(id, map_.polygonLayer.findUsages(p));
+        check(id, map_.regulatoryElementLayer.findUsages(ConstPoint3d(p)));
+      } else if (map_.lineStringLayer.exists(id)) {
+        auto ls = map_.lineStringLayer.get(id);
+        check(id, usages(map_.laneletLayer, ls));
+        check(id, usages(map_.areaLayer, ls));
+        check(id, map_.regulatoryElementLayer.findUsages(ConstLineString3d(ls)));
+      } else if (map_.polygonLayer.exists(id)) {
+        check(id, map_.regulatoryElementLayer.findUsages(ConstPolygon3d(map_.polygonLayer.get(id))));
+      } else if (map_.laneletLayer.exists(id)) {
+        check(id, map_.regulatoryElementLayer.findUsages(ConstWeakLanelet(map_.laneletLayer.get(id))));
+      } else if (map_.areaLayer.exists(id)) {
+        check(id, map_.regulatoryElementLayer.findUsages(ConstWeakArea(map_.areaLayer.get(id))));
+      }
+    }
+    // the new version of a primitive must not reference a removed one either
+    auto refersToRemoved = [&](Id user, Id ref) {
+      if (removed_.count(ref) != 0) {
+        errors.push_back("Primitive " + std::to_string(user) + " of the patch references the removed primitive " +
+                         std::to_string(ref));
+      }
+    };
+    auto checkPoints = [&](const auto& layer) {
+      for (const auto& ls : layer) {
+        for (const auto& p : ls) {
+          refersToRemoved(ls.id(), p.id());
+        }
+      }
+    };
+    checkPoints(patch_.lineStringLayer);
+    checkPoints(patch_.polygonLayer);
+    for (const auto& llt : patch_.laneletLayer) {
+      refersToRemoved(llt.id(), llt.leftBound().id());
+      refersToRemoved(llt.id(), llt.rightBound().id());
+    }
+    for (const auto& ar : patch_.areaLayer) {
+      for (const auto& ls : ar.outerBound()) {
+        refersToRemoved(ar.id(), ls.id());
+      }
+      for (const auto& inner : ar.innerBounds()) {
+        for (const auto& ls : inner) {
+          refersToRemoved(ar.id(), ls.id());
+        }
+      }
+    }
+    for (const auto& regElem : patch_.regulatoryElementLayer) {
+      for (const auto& param : regElem->getParameters()) {
+        for (const auto& prim : param.second) {
+          refersToRemoved(regElem->id(), traits::getId(prim));
+        }
+      }
+    }
+    if (!errors.empty()) {
+      throw InvalidInputError("Invalid map patch:\n" + [&errors] {
+        std::string msg;
+        for (const auto& e : errors) {
+          msg += e + '\n';
+        }
+        return msg;
+      }());
+    }
+  }
+
+  template <typename LayerT>
+  static std::vector<typename LayerT::PrimitiveT> usages(LayerT& layer, const LineString3d& ls) {
+    auto result = layer.findUsages(ls);
+    auto inverted = layer.findUsages(ls.invert());
+    result.insert(result.end(), inverted.begin(), inverted.end());
+    return result;
+  }
+
+  template <typename T>
+  static void insert(IdMap<T>& into, const T& prim) {
+    into.emplace(traits::getId(prim), prim);
+  }
+
+  /**
+   * Everything whose data or geometry changes has to be taken out of the spatial index before it is modified, otherwise
+   * the old entries can not be found anymore. This collects the existing primitives that are modified, removed or
+   * depend on one of them.
+   */
+  void collectAffected() {
+    std::vector<Id> touched(upserted_.begin(), upserted_.end());
+    touched.insert(touched.end(), removed_.begin(), removed_.end());
+    auto collectTouched = [&touched](auto& layer, auto& into) {
+      for (auto id : touched) {
+        if (layer.exists(id)) {
+          insert(into, layer.get(id));
+        }
+      }
+    };
+    collectTouched(map_.pointLayer, points_);
+    collectTouched(map_.lineStringLayer, lineStrings_);
+    collectTouched(map_.polygonLayer, polygons_);
+    collectTouched(map_.laneletLayer, lanelets_);
+    collectTouched(map_.areaLayer, areas_);
+    collectTouched(map_.regulatoryElementLayer, regElems_);
+    for (auto& p : points_) {
+      for (auto& ls : map_.lineStringLayer.findUsages(p.second)) {
+        insert(lineStrings_, ls);
+      }
+      for (auto& poly : map_.polygonLayer.findUsages(p.second)) {
+        insert(polygons_, poly);
+      }
+    }
+    for (auto& ls : lineStrings_) {
+      for (auto& llt : usages(map_.laneletLayer, ls.second)) {
+        insert(lanelets_, map_.laneletLayer.get(llt.id()));
+      }
+      for (auto& ar : usages(map_.areaLayer, ls.second)) {
+        insert(areas_, ar);
+      }
+    }
+    auto addRegElemUsers = [this](const ConstRuleParameter& param) {
+      for (auto& regElem : map_.regulatoryElementLayer.findUsages(param)) {
+        insert(regElems_, regElem);
+      }
+    };
+    for (auto& p : points_) {
+      addRegElemUsers(ConstPoint3d(p.second));
+    }
+    for (auto& ls : lineStrings_) {
+      addRegElemUsers(ConstLineString3d(ls.second));
+    }
+    for (auto& poly : polygons_) {
+      addRegElemUsers(ConstPolygon3d(poly.second));
+    }
+    for (auto& llt : lanelets_) {
+      addRegElemUsers(ConstWeakLanelet(llt.second));
+    }
+    for (auto& ar : areas_) {
+      addRegElemUsers(ConstWeakArea(ar.second));
+    }
+    // regulatory elements are replaced, so everything referencing one of them has to be relinked
+    for (auto& regElem : regElems_) {
+      for (auto& llt : map_.laneletLayer.findUsages(regElem.second)) {
+        insert(lanelets_, llt);
+      }
+      for (auto& ar : map_.areaLayer.findUsages(regElem.second)) {
+        insert(areas_, ar);
+      }
+    }
+    for (auto& llt : lanelets_) {
+      (removed_.count(llt.first) != 0 ? result_.removedLanelets : result_.affectedLanelets).push_back(llt.first);
+    }
+    for (auto id : upsertedLanelets_) {
+      if (lanelets_.count(id) == 0) {
+        result_.affectedLanelets.push_back(id);
+      }
+    }
+  }
+
+  template <typename T>
+  static void unindex(PrimitiveLayer<T>& layer, const IdMap<T>& prims) {
+    for (const auto& prim : prims) {
+      PatchLayerAccess<T>::erase(layer, prim.first);
+    }
+  }
+
+  void unindex() {
+    unindex(map_.regulatoryElementLayer, regElems_);
+    unindex(map_.areaLayer, areas_);
+    unindex(map_.laneletLayer, lanelets_);
+    unindex(map_.polygonLayer, polygons_);
+    unindex(map_.lineStringLayer, lineStrings_);
+    unindex(map_.pointLayer, points_);
+    for (auto id : removed_) {
+      if (points_.count(id) + lineStrings_.count(id) + polygons_.count(id) + lanelets_.count(id) + areas_.count(id) +
+              regElems_.count(id) !=
+          0) {
+        result_.removed.push_back(id);
+      }
+    }
+  }
+
+  // ---- modification ----
+  RegulatoryElementPtr regulatoryElement(Id id) {
+    auto it = regElems_.find(id);
+    return it != regElems_.end() ? it->second : map_.regulatoryElementLayer.get(id);
+  }
+
+  void updatePoints() {
+    for (auto id : upsertedPoints_) {
+      const auto newPoint = patch_.pointLayer.get(id);
+      auto it = points_.find(id);
+      if (it == points_.end()) {
+        points_.emplace(id, Point3d(id, newPoint.basicPoint(), newPoint.attributes()));
+        continue;
+      }
+      it->second.basicPoint() = newPoint.basicPoint();
+      it->second.attributes() = newPoint.attributes();
+    }
+  }
+
+  //! points that are not part of the patch are taken from the target map
+  Point3d resolve(const ConstPoint3d& p) {
+    auto it = points_.find(p.id());
+    if (it == points_.end()) {
+      it = points_.emplace(p.id(), map_.pointLayer.get(p.id())).first;
+      untouched_.insert(p.id());
+    }
+    return it->second;
+  }
+
+  template <typename PatchLayerT, typename PrimT>
+  void updateLineStrings(const PatchLayerT& patchLayer, const std::vector<Id>& upserts, IdMap<PrimT>& prims) {
+    for (auto id : upserts) {
+      const auto newLs = patchLayer.get(id);
+      Points3d points = utils::transform(newLs, [this](const auto& p) { return resolve(p); });
+      auto it = prims.find(id);
+      if (it == prims.end()) {
+        prims.emplace(id, PrimT(id, points, newLs.attributes()));
+        continue;
+      }
+      auto& ls = it->second;
+      ls.clear();
+      for (auto& p : points) {
+        ls.push_back(p);
+      }
+      ls.attributes() = newLs.attributes();
+    }
+  }
+  LineString3d resolve(const ConstLineString3d& ls) {
+    auto it = lineStrings_.find(ls.id());
+    if (it == lineStrings_.end()) {
+      it = lineStrings_.emplace(ls.id(), map_.lineStringLayer.get(ls.id())).first;
+      untouched_.insert(ls.id());
+    }
+    return ls.inverted() ? it->second.invert() : it->second;
+  }
+  LineStrings3d resolve(const ConstLineStrings3d& lss) {
+    return utils::transform(lss, [this](const auto& ls) { return resolve(ls); });
+  }
+
+  void updateLanelets() {
+    for (auto id : upsertedLanelets_) {
+      const auto newLlt = patch_.laneletLayer.get(id);
+      auto left = resolve(newLlt.leftBound());
+      auto right = resolve(newLlt.rightBound());
+      auto it = lanelets_.find(id);
+      if (it == lanelets_.end()) {
+        lanelets_.emplace(id, Lanelet(id, left, right, newLlt.attributes()));
+        continue;
+      }
+      auto& llt = it->second;
+      llt.setLeftBound(left);
+      llt.setRightBound(right);
+      llt.attributes() = newLlt.attributes();
+    }
+    // lanelets whose points moved have outdated centerlines
+    for (auto& llt : lanelets_) {
+      llt.second.resetCache();
+    }
+  }
+
+  void updateAreas() {
+    for (auto id : upsertedAreas_) {
+      const auto newArea = patch_.areaLayer.get(id);
+      auto outer = resolve(utils::addConst(newArea).outerBound());
+      auto inner = utils::transform(utils::addConst(newArea).innerBounds(),
+                                    [this](const auto& bound) { return resolve(bound); });
+      auto it = areas_.find(id);
+      if (it == areas_.end()) {
+        areas_.emplace(id, Area(id, outer, inner, newArea.attributes()));
+        continue;
+      }
+      auto& ar = it->second;
+      ar.setOuterBound(outer);
+      ar.setInnerBounds(inner);
+      ar.attributes() = newArea.attributes();
+    }
+    // recompute the cached polygons of areas whose points moved
+    for (auto& ar : areas_) {
+      ar.second.setOuterBound(ar.second.outerBound());
+    }
+  }
+
+  Lanelet resolve(const ConstWeakLanelet& weak) {
+    const auto llt = weak.lock();
+    auto it = lanelets_.find(llt.id());
+    auto result = it != lanelets_.end() ? it->second : map_.laneletLayer.get(llt.id());
+    return llt.inverted() != result.inverted() ? result.invert() : result;
+  }
+  Area resolve(const ConstWeakArea& weak) {
+    const auto id = weak.lock().id();
+    auto it = areas_.find(id);
+    return it != areas_.end() ? it->second : map_.areaLayer.get(id);
+  }
+
+  RuleParameter resolve(const ConstRuleParameter& param) {
+    struct Visitor : boost::static_visitor<RuleParameter> {
+      explicit Visitor(MapPatcher* self) : self{self} {}
+      RuleParameter operator()(const ConstPoint3d& p) const { return self->resolve(p); }
+      RuleParameter operator()(const ConstLineString3d& ls) const { return self->resolve(ls); }
+      RuleParameter operator()(const ConstPolygon3d& poly) const {
+        auto it = self->polygons_.find(poly.id());
+        return it != self->polygons_.end() ? it->second : self->map_.polygonLayer.get(poly.id());
+      }
+      RuleParameter operator()(const ConstWeakLanelet& llt) const { return WeakLanelet(self->resolve(llt)); }
+      RuleParameter operator()(const ConstWeakArea& ar) const { return WeakArea(self->resolve(ar)); }
+      MapPatcher* self;
+    };
+    return boost::apply_visitor(Visitor(this), param);
+  }
+
+  RegulatoryElementPtr create(Id id, const RuleParameterMap& params, const AttributeMap& attrs) {
+    auto subtype = attrs.find(AttributeName::Subtype);
+    return subtype != attrs.end() ? RegulatoryElementFactory::create(subtype->second.value(), id, params, attrs)
+                                  : std::make_shared<GenericRegulatoryElement>(id, params, attrs);
+  }
+
+  /**
+   * Regulatory elements may keep state derived from their parameters, so they are replaced by new objects instead of
+   * being modified. Elements that only depend on changed primitives are recreated with the same content.
+   */
+  void updateRegulatoryElements() {
+    std::unordered_set<Id> upserts(upsertedRegElems_.begin(), upsertedRegElems_.end());
+    auto rebuild = [this](const RegulatoryElementConstPtr& source) {
+      RuleParameterMap params;
+      for (const auto& role : source->getParameters()) {
+        auto& target = params[role.first];
+        for (const auto& param : role.second) {
+          target.push_back(resolve(param));
+        }
+      }
+      return create(source->id(), params, source->attributes());
+    };
+    for (auto& regElem : regElems_) {
+      if (removed_.count(regElem.first) == 0 && upserts.count(regElem.first) == 0) {
+        regElem.second = rebuild(regElem.second);
+      }
+    }
+    for (auto id : upsertedRegElems_) {
+      regElems_[id] = rebuild(patch_.regulatoryElementLayer.get(id));
+    }
+  }
+
+  template <typename PrimT, typename PatchLayerT>
+  void relink(PrimT& prim, const PatchLayerT& patchLayer) {
+    RegulatoryElementConstPtrs wanted;
+    if (patchLayer.exists(prim.id())) {
+      wanted = patchLayer.get(prim.id()).regulatoryElements();
+    } else {
+      wanted = utils::addConst(prim).regulatoryElements();
+    }
+    auto current = prim.regulatoryElements();
+    for (const auto& regElem : current) {
+      prim.removeRegulatoryElement(regElem);
+    }
+    for (const auto& regElem : wanted) {
+      if (removed_.count(regElem->id()) == 0) {
+        prim.addRegulatoryElement(regulatoryElement(regElem->id()));
+      }
+    }
+  }
+
+  void relinkRegulatoryElements() {
+    for (auto& llt : lanelets_) {
+      if (removed_.count(llt.first) == 0) {
+        relink(llt.second, patch_.laneletLayer);
+      }
+    }
+    for (auto& ar : areas_) {
+      if (removed_.count(ar.first) == 0) {
+        relink(ar.second, patch_.areaLayer);
+      }
+    }
+  }
+
+  template <typename T>
+  void reindex(PrimitiveLayer<T>& layer, const IdMap<T>& prims) {
+    for (const auto& prim : prims) {
+      if (removed_.count(prim.first) != 0 || untouched_.count(prim.first) != 0) {
+        continue;
+      }
+      utils::registerId(prim.first);
+      PatchLayerAccess<T>::insert(layer, prim.second);
+    }
+  }
+
+  void reindex() {
+    reindex(map_.pointLayer, points_);
+    reindex(map_.lineStringLayer, lineStrings_);
+    reindex(map_.polygonLayer, polygons_);
+    reindex(map_.laneletLayer, lanelets_);
+    reindex(map_.areaLayer, areas_);
+    reindex(map_.regulatoryElementLayer, regElems_);
+  }
+
+  LaneletMap& map_;
+  const LaneletMap& patch_;
+  std::unordered_set<Id> removed_;
+  std::unordered_set<Id> upserted_;
+  std::unordered_set<Id> untouched_;  //!< primitives of the target only looked up to resolve references
+  std::vector<Id> upsertedPoints_, upsertedLineStrings_, upsertedPolygons_, upsertedLanelets_, upsertedAreas_,
+      upsertedRegElems_;
+  IdMap<Point3d> points_;
+  IdMap<LineString3d> lineStrings_;
+  IdMap<Polygon3d> polygons_;
+  IdMap<Lanelet> lanelets_;
+  IdMap<Area> areas_;
+  IdMap<RegulatoryElementPtr> regElems_;
+  MapPatchResult result_;
+};
+}  // namespace internal
+
+/**
+ * @brief Applies a patch to a map in place.
+ *
+ * Modified primitives keep their identity: their data objects are updated, so all Lanelet, LineString3d, etc. objects
+ * referring to them see the new data without reloading. Regulatory elements are the exception, they are recreated and
+ * relinked. All layers of the map, including their spatial index and the usage lookups, are updated for the changed
+ * primitives and everything depending on them.
+ *
+ * Derived structures (routing graphs, frozen or packed indices) are not updated, rebuild them from the returned
+ * affected lanelets or from the whole map. The map must not be read by other threads while the patch is applied.
+ *
+ * @throws InvalidInputError if a removed primitive is still referenced after the patch. The map is unchanged then.
+ */
+inline MapPatchResult applyPatch(LaneletMap& map, const MapPatch& patch) {
+  return internal::MapPatcher(map, patch).apply();
+}
+
+}  // namespace lanelet
@@ -0,0 +1,457 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "lanelet2_core/DenseIdIndex.h"
+#include "lanelet2_core/FrozenAttributes.h"
+#include "lanelet2_core/FrozenGeometry.h"
+#include "lanelet2_core/LaneletMap.h"
+#include "lanelet2_core/UsageIndex.h"
+#include "lanelet2_core/geometry/Area.h"
+#include "lanelet2_core/geometry/BoundingBox.h"
+#include "lanelet2_core/geometry/Lanelet.h"
+#include "lanelet2_core/geometry/LineString.h"
+#include "lanelet2_core/geometry/Point.h"
+#include "lanelet2_core/geometry/Polygon.h"
+#include "lanelet2_core/geometry/RegulatoryElement.h"
+#include "lanelet2_core/primitives/LaneletRef.h"
+
+namespace lanelet {
+namespace internal {
+template <typename T>
+inline BoundingBox2d packedBox(const T& prim) {
+  return geometry::boundingBox2d(traits::to2D(prim));
+}
+inline BoundingBox2d packedBox(const RegulatoryElementPtr& regElem) { return geometry::boundingBox2d(regElem); }
+
+template <typename T>
+inline const SearchBoxT<T>& toSearchBox(const BoundingBox2d& box) {
+  return box;
+}
+template <>
+inline const SearchBoxT<Point3d>& toSearchBox<Point3d>(const BoundingBox2d& box) {
+  return box.min();
+}
+}  // namespace internal
+
+/**
+ * @brief Immutable, bulk loaded R-Tree for one layer of a map that is no longer modified.
+ *
+ * The tree is packed with the sort-tile-recursive (STR) algorithm, so every node except the last one per level is
+ * full and the tree has minimal height. All nodes are stored in one contiguous vector, the bounding boxes of the
+ * children of a node are kept as separate coordinate arrays so that the intersection and distance tests of a node are
+ * branch free loops over NodeCapacity lanes that the compiler vectorizes.
+ *
+ * The query interface is the one of PrimitiveLayer (search, searchUntil, nearest, nearestUntil), so functions like
+ * geometry::findWithin2d can be used with it. The tree keeps copies of the primitives, not of the layer; it has to be
+ * rebuilt if the map changes.
+ */
+template <typename T>
+class PackedRTree {
+ public:
+  using PrimitiveT = T;
+  using ConstPrimitiveT = traits::ConstPrimitiveType<T>;
+  using ConstPrimitiveVec = std::vector<ConstPrimitiveT>;
+  using PrimitiveVec = std::vector<PrimitiveT>;
+  using OptConstPrimitiveT = Optional<ConstPrimitiveT>;
+  using OptPrimitiveT = Optional<PrimitiveT>;
+  using ConstSearchFunction = typename PrimitiveLayer<T>::ConstSearchFunction;
+  using SearchFunction = typename PrimitiveLayer<T>::SearchFunction;
+
+  static constexpr uint32_t NodeCapacity = 8;
+
+  PackedRTree() = default;
+  explicit PackedRTree(PrimitiveLayer<T>& layer) {
+    std::vector<std::pair<BoundingBox2d, PrimitiveT>> items;
+    items.reserve(layer.size());
+    for (auto& prim : layer) {
+      items.emplace_back(internal::packedBox(prim), prim);
+    }
+    build(std::move(items));
+  }
+
+  size_t size() const noexcept { return elements_.size(); }
+  bool empty() const noexcept { return elements_.empty(); }
+
+  //! @see PrimitiveLayer::search
+  ConstPrimitiveVec search(const BoundingBox2d& area) const {
+    ConstPrimitiveVec result;
+    forEachIntersecting(area, [&](uint32_t idx) {
+      result.push_back(elements_[idx]);
+      return false;
+    });
+    return result;
+  }
+  PrimitiveVec search(const BoundingBox2d& area) {
+    PrimitiveVec result;
+    forEachIntersecting(area, [&](uint32_t idx) {
+      result.push_back(elements_[idx]);
+      return false;
+    });
+    return result;
+  }
+
+  //! @see PrimitiveLayer::searchUntil
+  OptConstPrimitiveT searchUntil(const BoundingBox2d& area, const ConstSearchFunction& func) const {
+    OptConstPrimitiveT result;
+    forEachIntersecting(area, [&](uint32_t idx) {
+      if (func(internal::toSearchBox<T>(boxes_[idx]), elements_[idx])) {
+        result = elements_[idx];
+        return true;
+      }
+      return false;
+    });
+    return result;
+  }
+  OptPrimitiveT searchUntil(const BoundingBox2d& area, const SearchFunction& func) {
+    OptPrimitiveT result;
+    forEachIntersecting(area, [&](uint32_t idx) {
+      if (func(internal::toSearchBox<T>(boxes_[idx]), elements_[idx])) {
+        result = elements_[idx];
+        return true;
+      }
+      return false;
+    });
+    return result;
+  }
+
+  //! @see PrimitiveLayer::nearest
+  ConstPrimitiveVec nearest(const BasicPoint2d& point, unsigned n) const {
+    ConstPrimitiveVec result;
+    result.reserve(std::min<size_t>(n, size()));
+    forEachNearest(point, [&](uint32_t idx, double /*dist*/) {
+      result.push_back(elements_[idx]);
+      return result.size() >= n;
+    });
+    return result;
+  }
+  PrimitiveVec nearest(const BasicPoint2d& point, unsigned n) {
+    PrimitiveVec result;
+    result.reserve(std::min<size_t>(n, size()));
+    forEachNearest(point, [&](uint32_t idx, double /*dist*/) {
+      result.push_back(elements_[idx]);
+      return result.size() >= n;
+    });
+    return result;
+  }
+
+  //! @see PrimitiveLayer::nearestUntil
+  OptConstPrimitiveT nearestUntil(const BasicPoint2d& point, const ConstSearchFunction& func) const {
+    OptConstPrimitiveT result;
+    forEachNearest(point, [&](uint32_t idx, double /*dist*/) {
+      if (func(internal::toSearchBox<T>(boxes_[idx]), elements_[idx])) {
+        result = elements_[idx];
+        return true;
+      }
+      return false;
+    });
+    return result;
+  }
+  OptPrimitiveT nearestUntil(const BasicPoint2d& point, const SearchFunction& func) {
+    OptPrimitiveT result;
+    forEachNearest(point, [&](uint32_t idx, double /*dist*/) {
+      if (func(internal::toSearchBox<T>(boxes_[idx]), elements_[idx])) {
+        result = elements_[idx];
+        return true;
+      }
+      return false;
+    });
+    return result;
+  }
+
+  /**
+   * @brief Visits the elements in ascending order of the distance of their bounding box to the point
+   * @param func called with (element index, squared bounding box distance), stops the traversal by returning true
+   */
+  template <typename Func>
+  void forEachNearest(const BasicPoint2d& point, Func&& func) const {
+    if (nodes_.empty()) {
+      return;
+    }
+    // entries with children < 0 are elements (~index), otherwise nodes
+    using Entry = std::pair<double, int64_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+    queue.emplace(0., static_cast<int64_t>(nodes_.size() - 1));
+    double dist[NodeCapacity];
+    while (!queue.empty()) {
+      const auto entry = queue.top();
+      queue.pop();
+      if (entry.second < 0) {
+        if (func(static_cast<uint32_t>(~entry.second), entry.first)) {
+          return;
+        }
+        continue;
+      }
+      const auto& node = nodes_[static_cast<size_t>(entry.second)];
+      node.squaredDistances(point.x(), point.y(), dist);
+      for (uint32_t i = 0; i < node.count; ++i) {
+        queue.emplace(dist[i], node.leaf ? ~static_cast<int64_t>(node.children[i]) : node.children[i]);
+      }
+    }
+  }
+
+  //! Visits all elements whose bounding box intersects the area, stops as soon as func returns true
+  template <typename Func>
+  void forEachIntersecting(const BoundingBox2d& area, Func&& func) const {
+    if (nodes_.empty() || area.isEmpty()) {
+      return;
+    }
+    std::vector<uint32_t> stack{static_cast<uint32_t>(nodes_.size() - 1)};
+    bool hits[NodeCapacity];
+    while (!stack.empty()) {
+      const auto& node = nodes_[stack.back()];
+      stack.pop_back();
+      node.intersects(area.min().x(), area.min().y(), area.max().x(), area.max().y(), hits);
+      for (uint32_t i = 0; i < node.count; ++i) {
+        if (!hits[i]) {
+          continue;
+        }
+        if (!node.leaf) {
+          stack.push_back(node.children[i]);
+        } else if (func(node.children[i])) {
+          return;
+        }
+      }
+    }
+  }
+
+  const PrimitiveT& element(uint32_t idx) const { return elements_[idx]; }
+  const BoundingBox2d& box(uint32_t idx) const { return boxes_[idx]; }
+
+ private:
+  struct alignas(64) Node {
+    double minX[NodeCapacity];
+    double minY[NodeCapacity];
+    double maxX[NodeCapacity];
+    double maxY[NodeCapacity];
+    uint32_t children[NodeCapacity];  //!< element indices for leaves, node indices otherwise
+    uint32_t count{0};
+    bool leaf{true};
+
+    // unused lanes hold an empty box (min > max), so the loops can always run over all lanes
+    void intersects(double qMinX, double qMinY, double qMaxX, double qMaxY, bool* hits) const {
+      for (uint32_t i = 0; i < NodeCapacity; ++i) {
+        hits[i] = (minX[i] <= qMaxX) & (maxX[i] >= qMinX) & (minY[i] <= qMaxY) & (maxY[i] >= qMinY);
+      }
+    }
+    void squaredDistances(double x, double y, double* dist) const {
+      for (uint32_t i = 0; i < NodeCapacity; ++i) {
+        const double dx = std::max(std::max(minX[i] - x, x - maxX[i]), 0.);
+        const double dy = std::max(std::max(minY[i] - y, y - maxY[i]), 0.);
+        dist[i] = dx * dx + dy * dy;
+      }
+    }
+  };
+
+  struct Entry {
+    double minX, minY, maxX, maxY;
+    uint32_t index;
+    double centerX() const { return minX + maxX; }
+    double centerY() const { return minY + maxY; }
+  };
+
+  void build(std::vector<std::pair<BoundingBox2d, PrimitiveT>> items) {
+    elements_.reserve(items.size());
+    boxes_.reserve(items.size());
+    std::vector<Entry> level;
+    level.reserve(items.size());
+    for (auto& item : items) {
+      const auto& box = item.first;
+      level.push_back({box.min().x(), box.min().y(), box.max().x(), box.max().y(),
+                       static_cast<uint32_t>(elements_.size())});
+      boxes_.push_back(box);
+      elements_.push_back(std::move(item.second));
+    }
+    if (level.empty()) {
+      return;
+    }
+    bool leaf = true;
+    do {
+      level = packLevel(std::move(level), leaf);
+      leaf = false;
+    } while (level.size() > 1);
+  }
+
+  //! Sort-tile-recursive packing of one level, returns the entries of the next level
+  std::vector<Entry> packLevel(std::vector<Entry> level, bool leaf) {
+    const auto numNodes = (level.size() + NodeCapacity - 1) / NodeCapacity;
+    const auto numSlices = static_cast<size_t>(std::ceil(std::sqrt(double(numNodes))));
+    const auto sliceSize = numSlices * NodeCapacity;
+    std::sort(level.begin(), level.end(), [](const Entry& a, const Entry& b) { return a.centerX() < b.centerX(); });
+    for (size_t begin = 0; begin < level.size(); begin += sliceSize) {
+      const auto end = std::min(begin + sliceSize, level.size());
+      std::sort(level.begin() + begin, level.begin() + end,
+                [](const Entry& a, const Entry& b) { return a.centerY() < b.centerY(); });
+    }
+
+    std::vector<Entry> next;
+    next.reserve(numNodes);
+    for (size_t begin = 0; begin < level.size(); begin += NodeCapacity) {
+      Node node;
+      node.leaf = leaf;
+      std::fill(std::begin(node.minX), std::end(node.minX), std::numeric_limits<double>::max());
+      std::fill(std::begin(node.minY), std::end(node.minY), std::numeric_limits<double>::max());
+      std::fill(std::begin(node.maxX), std::end(node.maxX), std::numeric_limits<double>::lowest());
+      std::fill(std::begin(node.maxY), std::end(node.maxY), std::numeric_limits<double>::lowest());
+      Entry parent{std::numeric_limits<double>::max(), std::numeric_limits<double>::max(),
+                   std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(),
+                   static_cast<uint32_t>(nodes_.size())};
+      const auto end = std::min<size_t>(begin + NodeCapacity, level.size());
+      for (auto i = begin; i < end; ++i) {
+        const auto& e = level[i];
+        node.minX[node.count] = e.minX;
+        node.minY[node.count] = e.minY;
+        node.maxX[node.count] = e.maxX;
+        node.maxY[node.count] = e.maxY;
+        node.children[node.count] = e.index;
+        ++node.count;
+        parent.minX = std::min(parent.minX, e.minX);
+        parent.minY = std::min(parent.minY, e.minY);
+        parent.maxX = std::max(parent.maxX, e.maxX);
+        parent.maxY = std::max(parent.maxY, e.maxY);
+      }
+      nodes_.push_back(node);
+      next.push_back(parent);
+    }
+    return next;
+  }
+
+  std::vector<Node> nodes_;  //!< bottom up, the root is the last node
+  std::vector<PrimitiveT> elements_;
+  std::vector<BoundingBox2d> boxes_;
+};
+
+/**
+ * @brief A map that is no longer modified, together with packed R-Trees for its layers.
+ *
+ * Use this after loading a map that stays static for the lifetime of the process. The layers of the map itself still
+ * work, but queries should go through the packed trees, attribute lookups through `attributes` and usage lookups
+ * (which lanelets use this bound, which regulatory elements this stop line) through `usages`. The `...Ids` indices
+ * remap the ids of lanelets, areas and regulatory elements to 0..n-1 for compact references and side tables.
+ *
+ * @section concurrency Concurrent reads
+ * A FrozenLaneletMap can be shared by any number of threads that only read from it. To make this safe, the hidden
+ * mutations of the const interfaces are done once on construction or avoided:
+ *  - the centerlines of all lanelets are computed eagerly, so ConstLanelet::centerline() only reads the cache. Do not
+ *    call resetCache() or modify bounds afterwards.
+ *  - the 2d bounding boxes and polygons of lanelets and areas and the 2d centerlines of lanelets are computed once
+ *    into side tables, use geometry(...) and laneletRef(...) instead of walking the bound points on every call.
+ *  - Attribute::as*() writes the mutable cache of the attribute, use `attributes` (FrozenAttributeIndex) instead.
+ *  - the map is only accessible as const.
+ * A RoutingGraph built from map() only reads in its const queries and can be shared as well. Per query state (a
+ * LaneletLocator, a PackedLineStringCache, a CenterlineIndexCache, LaneletSequence) has to be kept per thread.
+ */
+class FrozenLaneletMap {
+ public:
+  explicit FrozenLaneletMap(std::unique_ptr<LaneletMap> map)
+      : map_{prepareForConcurrentReads(std::move(map))},
+        laneletLayer{map_->laneletLayer},
+        areaLayer{map_->areaLayer},
+        regulatoryElementLayer{map_->regulatoryElementLayer},
+        polygonLayer{map_->polygonLayer},
+        lineStringLayer{map_->lineStringLayer},
+        pointLayer{map_->pointLayer},
+        attributes{*map_},
+        usages{*map_},
+        laneletIds{map_->laneletLayer},
+        areaIds{map_->areaLayer},
+        regulatoryElementIds{map_->regulatoryElementLayer},
+        laneletGeometry{makeFrozenGeometry<FrozenLaneletGeometry>(laneletIds)},
+        areaGeometry{makeFrozenGeometry<FrozenAreaGeometry>(areaIds)} {}
+
+  const LaneletMap& map() const noexcept { return *map_; }
+
+  //! cached 2d geometry of a lanelet of this map (both orientations), throws NoSuchPrimitiveError for other lanelets
+  const FrozenLaneletGeometry& geometry(const ConstLanelet& llt) const {
+    return laneletGeometry[checked(laneletIds.find(llt.id()), llt.id())];
+  }
+  //! cached 2d geometry of an area of this map, throws NoSuchPrimitiveError for other areas
+  const FrozenAreaGeometry& geometry(const ConstArea& area) const {
+    return areaGeometry[checked(areaIds.find(area.id()), area.id())];
+  }
+  //! non owning view on a lanelet of this map with its cached geometry, valid as long as the map
+  LaneletRef laneletRef(const ConstLanelet& llt) const {
+    const auto idx = checked(laneletIds.find(llt.id()), llt.id());
+    return {llt, laneletGeometry[idx]};
+  }
+
+ private:
+  static std::unique_ptr<LaneletMap> prepareForConcurrentReads(std::unique_ptr<LaneletMap> map) {
+    for (const auto& llt : map->laneletLayer) {
+      llt.centerline();
+    }
+    return map;
+  }
+
+  static IdIndex checked(IdIndex idx, Id id) {
+    if (!idx) {
+      throw NoSuchPrimitiveError("Primitive with id " + std::to_string(id) + " is not part of the frozen map");
+    }
+    return idx;
+  }
+
+  std::unique_ptr<LaneletMap> map_;
+
+ public:
+  const PackedRTree<Lanelet> laneletLayer;
+  const PackedRTree<Area> areaLayer;
+  const PackedRTree<RegulatoryElementPtr> regulatoryElementLayer;
+  const PackedRTree<Polygon3d> polygonLayer;
+  const PackedRTree<LineString3d> lineStringLayer;
+  const PackedRTree<Point3d> pointLayer;
+  const FrozenAttributeIndex attributes;
+  const UsageIndex usages;
+  const DenseIdIndex<Lanelet> laneletIds;
+  const DenseIdIndex<Area> areaIds;
+  const DenseIdIndex<RegulatoryElementPtr> regulatoryElementIds;
+  const IdIndexTable<FrozenLaneletGeometry> laneletGeometry;  //!< by laneletIds
+  const IdIndexTable<FrozenAreaGeometry> areaGeometry;        //!< by areaIds
+};
+
+//! Freezes a freshly loaded map, e.g. `auto frozen = freeze(lanelet::load(file, projector));`
+inline std::unique_ptr<FrozenLaneletMap> freeze(std::unique_ptr<LaneletMap> map) {
+  return std::make_unique<FrozenLaneletMap>(std::move(map));
+}
+
+namespace geometry {
+/**
+ * @brief findNearest for packed trees: the n primitives with the smallest actual 2d distance to the point
+ *
+ * Elements are visited by bounding box distance, the traversal stops once the bounding box distance exceeds the
+ * n-th best actual distance.
+ */
+template <typename PrimT>
+std::vector<std::pair<double, traits::ConstPrimitiveType<PrimT>>> findNearest(const PackedRTree<PrimT>& tree,
+                                                                              const BasicPoint2d& pt, unsigned count) {
+  std::vector<std::pair<double, traits::ConstPrimitiveType<PrimT>>> closest;
+  if (count == 0) {
+    return closest;
+  }
+  closest.reserve(count + 1);
+  tree.forEachNearest(pt, [&](uint32_t idx, double boxDistSq) {
+    if (closest.size() == count && boxDistSq > closest.back().first * closest.back().first) {
+      return true;
+    }
+    const auto& elem = tree.element(idx);
+    const auto dist = distance2d(traits::to2D(elem), pt);
+    if (closest.size() < count || dist < closest.back().first) {
+      auto it = std::upper_bound(closest.begin(), closest.end(), dist,
+                                 [](double d, const auto& entry) { return d < entry.first; });
+      closest.emplace(it, dist, elem);
+      if (closest.size() > count) {
+        closest.pop_back();
+      }
+    }
+    return false;
+  });
+  return closest;
+}
+}  // namespace geometry
+}  // namespace lanelet
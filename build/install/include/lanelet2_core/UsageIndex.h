@@ -0,0 +1,175 @@
+#pragma once
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "lanelet2_core/LaneletMap.h"
+
+namespace lanelet {
+
+/**
+ * @brief Reverse adjacency of a map: for every primitive, the primitives that reference it.
+ *
+ * Answers "which lanelets have this bound", "which regulatory elements use this stop line" or "which lanelets are
+ * controlled by this traffic light" with one hash lookup, O(number of users), instead of a scan of a layer like
+ * utils::findUsages(layer, id). Points, line strings, polygons, lanelets and areas have their own id spaces, so each
+ * kind of referenced primitive has its own table.
+ *
+ * Built from a whole map (FrozenLaneletMap builds one on freeze). For a map that is still growing, call add() for every
+ * primitive added to the map after LaneletMap::add. Removing or changing primitives (applyPatch) is not tracked,
+ * rebuild the index afterwards.
+ */
+class UsageIndex {
+ public:
+  UsageIndex() = default;
+  explicit UsageIndex(const LaneletMapLayers& map) {
+    for (const auto& ls : map.lineStringLayer) {
+      add(ls);
+    }
+    for (const auto& poly : map.polygonLayer) {
+      add(poly);
+    }
+    for (const auto& llt : map.laneletLayer) {
+      add(llt);
+    }
+    for (const auto& area : map.areaLayer) {
+      add(area);
+    }
+    for (const auto& regElem : map.regulatoryElementLayer) {
+      add(regElem);
+    }
+  }
+
+  void add(const ConstLineString3d& ls) {
+    for (const auto& p : ls) {
+      lineStringsByPoint_.emplace(p.id(), ls);
+    }
+  }
+  void add(const ConstPolygon3d& poly) {
+    for (const auto& p : poly) {
+      polygonsByPoint_.emplace(p.id(), poly);
+    }
+  }
+  void add(const ConstLanelet& llt) {
+    const ConstLanelet lanelet = llt.inverted() ? llt.invert() : llt;
+    laneletsByLineString_.emplace(lanelet.leftBound().id(), lanelet);
+    if (lanelet.rightBound().id() != lanelet.leftBound().id()) {
+      laneletsByLineString_.emplace(lanelet.rightBound().id(), lanelet);
+    }
+    for (const auto& regElem : lanelet.regulatoryElements()) {
+      laneletsByRegElem_.emplace(regElem->id(), lanelet);
+    }
+  }
+  void add(const ConstArea& area) {
+    for (const auto& ls : area.outerBound()) {
+      areasByLineString_.emplace(ls.id(), area);
+    }
+    for (const auto& inner : area.innerBounds()) {
+      for (const auto& ls : inner) {
+        areasByLineString_.emplace(ls.id(), area);
+      }
+    }
+    for (const auto& regElem : area.regulatoryElements()) {
+      areasByRegElem_.emplace(regElem->id(), area);
+    }
+  }
+  void add(const RegulatoryElementConstPtr& regElem) {
+    struct Visitor : boost::static_visitor<void> {
+      Visitor(UsageIndex* self, const RegulatoryElementConstPtr& regElem) : self{self}, regElem{regElem} {}
+      void operator()(const ConstPoint3d& p) const { self->regElemsByPoint_.emplace(p.id(), regElem); }
+      void operator()(const ConstLineString3d& ls) const { self->regElemsByLineString_.emplace(ls.id(), regElem); }
+      void operator()(const ConstPolygon3d& poly) const { self->regElemsByPolygon_.emplace(poly.id(), regElem); }
+      void operator()(const ConstWeakLanelet& llt) const {
+        if (!llt.expired()) {
+          self->regElemsByLanelet_.emplace(llt.lock().id(), regElem);
+        }
+      }
+      void operator()(const ConstWeakArea& area) const {
+        if (!area.expired()) {
+          self->regElemsByArea_.emplace(area.lock().id(), regElem);
+        }
+      }
+      UsageIndex* self;
+      const RegulatoryElementConstPtr& regElem;
+    };
+    const Visitor visitor(this, regElem);
+    for (const auto& role : regElem->getParameters()) {
+      for (const auto& param : role.second) {
+        boost::apply_visitor(visitor, param);
+      }
+    }
+  }
+
+  //! line strings (not polygons) containing the point
+  ConstLineStrings3d lineStrings(const ConstPoint3d& p) const { return find(lineStringsByPoint_, p.id()); }
+  //! polygons containing the point
+  ConstPolygons3d polygons(const ConstPoint3d& p) const { return find(polygonsByPoint_, p.id()); }
+  //! lanelets with the line string as left or right bound, in either orientation
+  ConstLanelets lanelets(const ConstLineString3d& ls) const { return find(laneletsByLineString_, ls.id()); }
+  //! lanelets that have a bound containing the point
+  ConstLanelets lanelets(const ConstPoint3d& p) const {
+    ConstLanelets result;
+    for (const auto& ls : lineStrings(p)) {
+      for (const auto& llt : lanelets(ls)) {
+        if (std::find(result.begin(), result.end(), llt) == result.end()) {
+          result.push_back(llt);
+        }
+      }
+    }
+    return result;
+  }
+  //! lanelets referencing the regulatory element
+  ConstLanelets lanelets(const RegulatoryElementConstPtr& regElem) const {
+    return find(laneletsByRegElem_, regElem->id());
+  }
+  //! areas with the line string in their outer or inner bounds
+  ConstAreas areas(const ConstLineString3d& ls) const { return find(areasByLineString_, ls.id()); }
+  //! areas referencing the regulatory element
+  ConstAreas areas(const RegulatoryElementConstPtr& regElem) const { return find(areasByRegElem_, regElem->id()); }
+
+  //! regulatory elements having the primitive as parameter (any role)
+  RegulatoryElementConstPtrs regulatoryElements(const ConstPoint3d& p) const { return find(regElemsByPoint_, p.id()); }
+  RegulatoryElementConstPtrs regulatoryElements(const ConstLineString3d& ls) const {
+    return find(regElemsByLineString_, ls.id());
+  }
+  RegulatoryElementConstPtrs regulatoryElements(const ConstPolygon3d& poly) const {
+    return find(regElemsByPolygon_, poly.id());
+  }
+  RegulatoryElementConstPtrs regulatoryElements(const ConstLanelet& llt) const {
+    return find(regElemsByLanelet_, llt.id());
+  }
+  RegulatoryElementConstPtrs regulatoryElements(const ConstArea& area) const {
+    return find(regElemsByArea_, area.id());
+  }
+
+ private:
+  template <typename T>
+  using Table = std::unordered_multimap<Id, T>;
+
+  //! users of an id, without duplicates (a closed line string has its first point twice)
+  template <typename T>
+  static std::vector<T> find(const Table<T>& table, Id id) {
+    std::vector<T> result;
+    const auto range = table.equal_range(id);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (std::find(result.begin(), result.end(), it->second) == result.end()) {
+        result.push_back(it->second);
+      }
+    }
+    return result;
+  }
+
+  Table<ConstLineString3d> lineStringsByPoint_;
+  Table<ConstPolygon3d> polygonsByPoint_;
+  Table<ConstLanelet> laneletsByLineString_;
+  Table<ConstLanelet> laneletsByRegElem_;
+  Table<ConstArea> areasByLineString_;
+  Table<ConstArea> areasByRegElem_;
+  Table<RegulatoryElementConstPtr> regElemsByPoint_;
+  Table<RegulatoryElementConstPtr> regElemsByLineString_;
+  Table<RegulatoryElementConstPtr> regElemsByPolygon_;
+  Table<RegulatoryElementConstPtr> regElemsByLanelet_;
+  Table<RegulatoryElementConstPtr> regElemsByArea_;
+};
+
+}  // namespace lanelet
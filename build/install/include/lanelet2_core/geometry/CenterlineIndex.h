@@ -0,0 +1,215 @@
+#pragma once
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "lanelet2_core/geometry/PackedLineString.h"
+#include "lanelet2_core/primitives/Lanelet.h"
+
+namespace lanelet {
+namespace geometry {
+
+/**
+ * @brief PackedLineString with a bounding box hierarchy over its segments.
+ *
+ * The leaves are the segments, each level above merges pairs of consecutive boxes. Since consecutive segments of a
+ * polyline are close to each other, the boxes stay tight and the closest segment to a point is found by a best first
+ * search in O(log n) instead of checking every segment. Together with the cumulated length of PackedLineString this
+ * makes toArcCoordinates O(log n).
+ */
+class IndexedLineString {
+ public:
+  IndexedLineString() = default;
+  explicit IndexedLineString(const ConstLineString3d& lineString) { assign(lineString); }
+
+  void assign(const ConstLineString3d& lineString) {
+    packed_.assign(lineString);
+    levels_.clear();
+    if (packed_.size() < 2) {
+      return;
+    }
+    const auto* x = packed_.x();
+    const auto* y = packed_.y();
+    std::vector<Box> leaves(packed_.size() - 1);
+    for (size_t i = 0; i + 1 < packed_.size(); ++i) {
+      leaves[i] = {std::min(x[i], x[i + 1]), std::min(y[i], y[i + 1]), std::max(x[i], x[i + 1]),
+                   std::max(y[i], y[i + 1])};
+    }
+    levels_.push_back(std::move(leaves));
+    while (levels_.back().size() > 1) {
+      const auto& below = levels_.back();
+      std::vector<Box> level((below.size() + 1) / 2);
+      for (size_t i = 0; i < level.size(); ++i) {
+        level[i] = below[2 * i];
+        if (2 * i + 1 < below.size()) {
+          level[i].extend(below[2 * i + 1]);
+        }
+      }
+      levels_.push_back(std::move(level));
+    }
+  }
+
+  const PackedLineString& packed() const noexcept { return packed_; }
+  size_t size() const noexcept { return packed_.size(); }
+  double length2d() const noexcept { return packed_.length2d(); }
+
+  /**
+   * @brief closest segment to the point
+   * @return segment index and position t in [0, 1] of the closest point on it. If several segments have the same
+   * distance, the first one is returned (as in the linear search).
+   */
+  std::pair<size_t, double> closestSegment(const BasicPoint2d& point) const {
+    if (levels_.empty()) {
+      return {0, 0.};
+    }
+    const double px = point.x();
+    const double py = point.y();
+    using Entry = std::pair<double, std::pair<size_t, size_t>>;  // lower bound, (level, index)
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+    queue.push({0., {levels_.size() - 1, 0}});
+    double best = std::numeric_limits<double>::max();
+    std::pair<size_t, double> result{0, 0.};
+    while (!queue.empty() && queue.top().first <= best) {
+      const auto level = queue.top().second.first;
+      const auto idx = queue.top().second.second;
+      queue.pop();
+      if (level == 0) {
+        const auto proj = packed_.projectOnSegment2d(idx, px, py);
+        if (proj.second < best || (proj.second == best && idx < result.first)) {
+          best = proj.second;
+          result = {idx, proj.first};
+        }
+        continue;
+      }
+      const auto& children = levels_[level - 1];
+      for (auto child = 2 * idx; child < std::min(2 * idx + 2, children.size()); ++child) {
+        const auto bound = children[child].squaredDistance(px, py);
+        if (bound <= best) {
+          queue.push({bound, {level - 1, child}});
+        }
+      }
+    }
+    return result;
+  }
+
+  //! Same result as geometry::toArcCoordinates on the 2d linestring
+  ArcCoordinates toArcCoordinates(const BasicPoint2d& point) const {
+    if (packed_.size() < 2) {
+      return packed_.toArcCoordinates(point);
+    }
+    const auto seg = closestSegment(point);
+    return packed_.toArcCoordinates(point, seg.first, seg.second);
+  }
+
+  //! Same result as geometry::project on the 2d linestring
+  BasicPoint2d project(const BasicPoint2d& point) const {
+    if (packed_.size() < 2) {
+      return packed_.project(point);
+    }
+    const auto seg = closestSegment(point);
+    const auto i = seg.first;
+    const auto* x = packed_.x();
+    const auto* y = packed_.y();
+    return {x[i] + seg.second * (x[i + 1] - x[i]), y[i] + seg.second * (y[i + 1] - y[i])};
+  }
+
+  //! Absolute 2d distance of the point to the linestring
+  double distance2d(const BasicPoint2d& point) const {
+    if (packed_.size() < 2) {
+      return std::abs(packed_.toArcCoordinates(point).distance);
+    }
+    const auto seg = closestSegment(point);
+    return std::sqrt(packed_.projectOnSegment2d(seg.first, point.x(), point.y()).second);
+  }
+
+ private:
+  struct Box {
+    double minX, minY, maxX, maxY;
+    void extend(const Box& other) {
+      minX = std::min(minX, other.minX);
+      minY = std::min(minY, other.minY);
+      maxX = std::max(maxX, other.maxX);
+      maxY = std::max(maxY, other.maxY);
+    }
+    double squaredDistance(double x, double y) const {
+      const double dx = std::max(std::max(minX - x, x - maxX), 0.);
+      const double dy = std::max(std::max(minY - y, y - maxY), 0.);
+      return dx * dx + dy * dy;
+    }
+  };
+
+  PackedLineString packed_;
+  std::vector<std::vector<Box>> levels_;  //!< levels_[0] are the segments, the last level is the root
+};
+
+/**
+ * @brief Keeps an IndexedLineString of the (cached) centerline of every lanelet it is asked for.
+ *
+ * The lanelet caches its centerline and creates a new one when its bounds change, so an entry is rebuilt whenever the
+ * centerline data is not the one the entry was built from.
+ */
+class CenterlineIndexCache {
+ public:
+  const IndexedLineString& get(const ConstLanelet& lanelet) {
+    auto centerline = lanelet.centerline();
+    auto& entry = cache_[Key{lanelet.constData().get(), lanelet.inverted()}];
+    if (entry.centerline.constData() != centerline.constData() || entry.centerline.inverted() != centerline.inverted()) {
+      entry.centerline = centerline;
+      entry.index.assign(centerline);
+    }
+    return entry.index;
+  }
+
+  void clear() { cache_.clear(); }
+  size_t size() const noexcept { return cache_.size(); }
+
+ private:
+  using Key = std::pair<const LaneletData*, bool>;
+  struct KeyHash {
+    size_t operator()(const Key& k) const noexcept {
+      return std::hash<const void*>()(k.first) ^ static_cast<size_t>(k.second);
+    }
+  };
+  struct Entry {
+    ConstLineString3d centerline;  //!< keeps the centerline data alive, see get()
+    IndexedLineString index;
+  };
+
+  std::unordered_map<Key, Entry, KeyHash> cache_;
+};
+
+/**
+ * @brief Arc coordinates of a point along a sequence of lanelets, as lanelet::utils::getArcCoordinates
+ *
+ * The point is related to the lanelet whose centerline is closest to it (first one on ties). The result length is the
+ * length of this centerline up to the projected point plus the centerline lengths of all lanelets before it.
+ */
+inline ArcCoordinates getArcCoordinates(CenterlineIndexCache& cache, const ConstLanelets& lanelets,
+                                        const BasicPoint2d& point) {
+  size_t closest = 0;
+  double minDist = std::numeric_limits<double>::max();
+  for (size_t i = 0; i < lanelets.size(); ++i) {
+    const auto dist = cache.get(lanelets[i]).distance2d(point);
+    if (dist < minDist) {
+      minDist = dist;
+      closest = i;
+    }
+  }
+  ArcCoordinates result;
+  if (lanelets.empty()) {
+    return result;
+  }
+  double length = 0.;
+  for (size_t i = 0; i < closest; ++i) {
+    length += cache.get(lanelets[i]).length2d();
+  }
+  result = cache.get(lanelets[closest]).toArcCoordinates(point);
+  result.length += length;
+  return result;
+}
+
+}  // namespace geometry
+}  // namespace lanelet
@@ -0,0 +1,168 @@
+#pragma once
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#include "lanelet2_core/primitives/Lanelet.h"
+
+namespace lanelet {
+namespace geometry {
+
+/**
+ * @brief Left and right bound of a moving window of lanelets, updated incrementally.
+ *
+ * Meant for a sequence that moves forward along a route from cycle to cycle (e.g. the lanelets of a drivable area).
+ * update() compares the new sequence to the current one: lanelets that left the window at the front are dropped,
+ * lanelets that entered it at the back are appended, nothing is done if the sequence is unchanged. Only if the new
+ * sequence does not continue the current one, the bounds are rebuilt. trimBehind() removes the part of the bounds that
+ * lies behind a position (usually the ego pose).
+ *
+ * Consecutive lanelets share the end point of their bounds, these points are stored once. The bound coordinates of
+ * every lanelet are cached, so a lanelet that enters the window again costs no conversion. Call clearCache() after
+ * the map changed.
+ */
+class LaneletBoundsWindow {
+ public:
+  struct Entry {
+    ConstLanelet lanelet;
+    size_t leftPoints;   //!< number of points this lanelet currently contributes to the left bound
+    size_t rightPoints;  //!< number of points this lanelet currently contributes to the right bound
+    bool leftJoined;     //!< the first left point is shared with the previous lanelet and not stored again
+    bool rightJoined;
+  };
+
+  /**
+   * @brief Makes the window cover the sequence
+   * @return false if the sequence equals the current one and nothing was done
+   */
+  bool update(const ConstLanelets& sequence) {
+    if (sequence.size() == entries_.size() &&
+        std::equal(sequence.begin(), sequence.end(), entries_.begin(),
+                   [](const ConstLanelet& llt, const Entry& e) { return llt == e.lanelet; })) {
+      return false;
+    }
+    const auto start = sequence.empty() ? entries_.end()
+                                        : std::find_if(entries_.begin(), entries_.end(), [&](const Entry& e) {
+                                            return e.lanelet == sequence.front();
+                                          });
+    const auto overlap = static_cast<size_t>(std::distance(start, entries_.end()));
+    const bool continues =
+        start != entries_.end() && overlap <= sequence.size() &&
+        std::equal(start, entries_.end(), sequence.begin(), [](const Entry& e, const ConstLanelet& llt) {
+          return e.lanelet == llt;
+        });
+    if (!continues) {
+      clear();
+    } else {
+      while (entries_.begin()->lanelet != sequence.front()) {
+        popFront();
+      }
+    }
+    for (auto it = sequence.begin() + static_cast<std::ptrdiff_t>(entries_.size()); it != sequence.end(); ++it) {
+      pushBack(*it);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Removes the points of the bounds that lie behind the position
+   *
+   * A point is removed if the position is ahead of the following point along their segment. Each bound keeps at least
+   * two points and lanelets that lie completely behind the position stay in the window until update() drops them.
+   */
+  void trimBehind(const BasicPoint2d& position) {
+    trim(left_, position, &Entry::leftPoints);
+    trim(right_, position, &Entry::rightPoints);
+  }
+
+  void clear() {
+    entries_.clear();
+    left_.clear();
+    right_.clear();
+  }
+  void clearCache() { cache_.clear(); }
+
+  const std::deque<Entry>& entries() const noexcept { return entries_; }
+  const std::deque<BasicPoint3d>& leftBound() const noexcept { return left_; }
+  const std::deque<BasicPoint3d>& rightBound() const noexcept { return right_; }
+  BasicLineString3d leftBoundLineString() const { return {left_.begin(), left_.end()}; }
+  BasicLineString3d rightBoundLineString() const { return {right_.begin(), right_.end()}; }
+
+ private:
+  struct CachedBounds {
+    BasicLineString3d left;
+    BasicLineString3d right;
+  };
+
+  const CachedBounds& bounds(const ConstLanelet& llt) {
+    auto it = cache_.find(llt);
+    if (it == cache_.end()) {
+      auto toBasic = [](const ConstLineString3d& ls) { return BasicLineString3d(ls.basicBegin(), ls.basicEnd()); };
+      it = cache_.emplace(llt, CachedBounds{toBasic(llt.leftBound()), toBasic(llt.rightBound())}).first;
+    }
+    return it->second;
+  }
+
+  static bool append(std::deque<BasicPoint3d>& points, const BasicLineString3d& bound, size_t& count) {
+    const bool joined = !points.empty() && !bound.empty() && points.back() == bound.front();
+    points.insert(points.end(), bound.begin() + (joined ? 1 : 0), bound.end());
+    count = bound.size() - (joined ? 1 : 0);
+    return joined;
+  }
+
+  void pushBack(const ConstLanelet& llt) {
+    const auto& b = bounds(llt);
+    Entry entry{llt, 0, 0, false, false};
+    entry.leftJoined = append(left_, b.left, entry.leftPoints);
+    entry.rightJoined = append(right_, b.right, entry.rightPoints);
+    entries_.push_back(entry);
+  }
+
+  //! the last point of the front lanelet stays if the next lanelet shares it
+  static void dropPoints(std::deque<BasicPoint3d>& points, size_t count, bool nextJoined, size_t& nextCount) {
+    const auto keep = nextJoined && count > 0 ? 1 : 0;
+    points.erase(points.begin(), points.begin() + static_cast<std::ptrdiff_t>(count - keep));
+    nextCount += keep;
+  }
+
+  void popFront() {
+    const auto front = entries_.front();
+    entries_.pop_front();
+    if (entries_.empty()) {
+      left_.clear();
+      right_.clear();
+      return;
+    }
+    auto& next = entries_.front();
+    dropPoints(left_, front.leftPoints, next.leftJoined, next.leftPoints);
+    dropPoints(right_, front.rightPoints, next.rightJoined, next.rightPoints);
+    next.leftJoined = false;
+    next.rightJoined = false;
+  }
+
+  void trim(std::deque<BasicPoint3d>& points, const BasicPoint2d& position, size_t Entry::*count) {
+    auto entry = entries_.begin();
+    while (points.size() > 2 && entry != entries_.end()) {
+      if ((*entry).*count == 0) {
+        ++entry;
+        continue;
+      }
+      const BasicPoint2d p0 = points[0].head<2>();
+      const BasicPoint2d p1 = points[1].head<2>();
+      if ((p1 - p0).dot(position - p1) <= 0.) {
+        break;
+      }
+      points.pop_front();
+      --((*entry).*count);
+    }
+  }
+
+  std::deque<Entry> entries_;
+  std::deque<BasicPoint3d> left_;
+  std::deque<BasicPoint3d> right_;
+  std::unordered_map<ConstLanelet, CachedBounds> cache_;
+};
+
+}  // namespace geometry
+}  // namespace lanelet
@@ -0,0 +1,79 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+
+#include "lanelet2_core/geometry/Lanelet.h"
+#include "lanelet2_core/geometry/PackedLineString.h"
+#include "lanelet2_core/primitives/LaneletSequence.h"
+
+namespace lanelet {
+namespace geometry {
+
+/**
+ * @brief Materialized centerline and bounds of a LaneletSequence.
+ *
+ * LaneletSequence returns its centerline and bounds as CompoundLineStrings, so every access walks the lanelets through
+ * the compound iterators and lengths are recomputed. This object copies them once into contiguous PackedLineStrings
+ * with cumulated lengths and remembers where along the centerline each lanelet starts. Keep it next to the sequence
+ * (e.g. per planning cycle or per route) and pass it to the geometry code instead of the sequence.
+ */
+class PackedLaneletSequence {
+ public:
+  PackedLaneletSequence() = default;
+  explicit PackedLaneletSequence(const LaneletSequence& sequence) { assign(sequence); }
+
+  void assign(const LaneletSequence& sequence) {
+    lanelets_ = sequence.lanelets();
+    centerline_.assign(sequence.centerline());
+    leftBound_.assign(sequence.leftBound());
+    rightBound_.assign(sequence.rightBound());
+    laneletStart_.clear();
+    laneletStart_.reserve(lanelets_.size() + 1);
+    // the centerline of the sequence is computed from the combined bounds, so the lanelet borders are projected onto it
+    // instead of summing up the lengths of the individual centerlines
+    for (const auto& llt : lanelets_) {
+      if (laneletStart_.empty() || centerline_.size() < 2) {
+        laneletStart_.push_back(0.);
+        continue;
+      }
+      const BasicPoint2d start = 0.5 * (utils::to2D(llt.leftBound().front()).basicPoint() +
+                                        utils::to2D(llt.rightBound().front()).basicPoint());
+      laneletStart_.push_back(std::max(laneletStart_.back(), centerline_.toArcCoordinates(start).length));
+    }
+    laneletStart_.push_back(centerline_.length2d());
+  }
+
+  //! true if the object was built from a sequence with the same lanelets
+  bool matches(const LaneletSequence& sequence) const { return sequence.lanelets() == lanelets_; }
+
+  const ConstLanelets& lanelets() const noexcept { return lanelets_; }
+  const PackedLineString& centerline() const noexcept { return centerline_; }
+  const PackedLineString& leftBound() const noexcept { return leftBound_; }
+  const PackedLineString& rightBound() const noexcept { return rightBound_; }
+  double length2d() const noexcept { return centerline_.length2d(); }
+
+  //! arc length along the centerline at which lanelet i starts
+  double laneletStart(size_t i) const { return laneletStart_[i]; }
+
+  //! index of the lanelet at arc length s along the centerline, clamped to the first and last lanelet
+  size_t laneletAt(double s) const {
+    if (lanelets_.empty()) {
+      return 0;
+    }
+    const auto it = std::upper_bound(laneletStart_.begin(), laneletStart_.end() - 1, s);
+    return static_cast<size_t>(std::max<std::ptrdiff_t>(std::distance(laneletStart_.begin(), it) - 1, 0));
+  }
+
+  ArcCoordinates toArcCoordinates(const BasicPoint2d& point) const { return centerline_.toArcCoordinates(point); }
+  BasicPoint3d centerlinePointAt(double s) const { return centerline_.interpolatedPointAtDistance(s); }
+
+ private:
+  ConstLanelets lanelets_;
+  PackedLineString centerline_;
+  PackedLineString leftBound_;
+  PackedLineString rightBound_;
+  std::vector<double> laneletStart_;  //!< plus the total length
+};
+
+}  // namespace geometry
+}  // namespace lanelet
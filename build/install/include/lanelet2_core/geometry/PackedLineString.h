@@ -0,0 +1,263 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "lanelet2_core/Exceptions.h"
+#include "lanelet2_core/geometry/impl/SegmentProjection.h"
+#include "lanelet2_core/primitives/CompoundLineString.h"
+#include "lanelet2_core/primitives/LineString.h"
+
+namespace lanelet {
+namespace geometry {
+
+/**
+ * @brief Contiguous copy of the coordinates of a linestring for geometry hot loops.
+ *
+ * A LineString stores one shared PointData per vertex, so each vertex access in length, toArcCoordinates or project is
+ * a pointer chase. PackedLineString keeps x, y and z in separate arrays together with the cumulated 2d length, so
+ * these functions run over contiguous memory and the arc length is not recomputed per call.
+ *
+ * The coordinates are a snapshot. Use PackedLineStringCache to keep packed versions of many linestrings and to
+ * refresh them after the original points have been modified.
+ */
+class PackedLineString {
+ public:
+  PackedLineString() = default;
+  explicit PackedLineString(const ConstLineString3d& lineString) { assign(lineString); }
+
+  void assign(const ConstLineString3d& lineString) { assignPoints(lineString); }
+  void assign(const CompoundLineString3d& lineString) { assignPoints(lineString); }
+
+  //! copies any range of 3d points, e.g. a CompoundLineString3d or BasicLineString3d
+  template <typename PointRangeT>
+  void assignPoints(const PointRangeT& lineString) {
+    const auto n = static_cast<size_t>(std::distance(lineString.begin(), lineString.end()));
+    x_.resize(n);
+    y_.resize(n);
+    z_.resize(n);
+    s_.resize(n);
+    size_t i = 0;
+    for (const auto& p : lineString) {
+      x_[i] = p.x();
+      y_[i] = p.y();
+      z_[i] = p.z();
+      ++i;
+    }
+    double s = 0.;
+    for (i = 0; i < n; ++i) {
+      if (i > 0) {
+        s += std::hypot(x_[i] - x_[i - 1], y_[i] - y_[i - 1]);
+      }
+      s_[i] = s;
+    }
+  }
+
+  size_t size() const noexcept { return x_.size(); }
+  bool empty() const noexcept { return x_.empty(); }
+  const double* x() const noexcept { return x_.data(); }
+  const double* y() const noexcept { return y_.data(); }
+  const double* z() const noexcept { return z_.data(); }
+  //! cumulated 2d length up to each point
+  const double* arcLength() const noexcept { return s_.data(); }
+
+  double length2d() const noexcept { return s_.empty() ? 0. : s_.back(); }
+
+  double length3d() const noexcept {
+    double l = 0.;
+    for (size_t i = 1; i < size(); ++i) {
+      const double dx = x_[i] - x_[i - 1];
+      const double dy = y_[i] - y_[i - 1];
+      const double dz = z_[i] - z_[i - 1];
+      l += std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+    return l;
+  }
+
+  //! Same result as geometry::toArcCoordinates on the 2d linestring
+  ArcCoordinates toArcCoordinates(const BasicPoint2d& point) const {
+    if (size() < 2) {
+      if (empty()) {
+        throw InvalidInputError("Can not compute arc coordinates on an empty linestring");
+      }
+      return {0., std::hypot(point.x() - x_[0], point.y() - y_[0])};
+    }
+    const auto seg = closestSegment2d(point.x(), point.y());
+    return toArcCoordinates(point, seg.first, seg.second);
+  }
+
+  //! Arc coordinates of a point whose closest point on the linestring is at position t of segment i
+  ArcCoordinates toArcCoordinates(const BasicPoint2d& point, size_t i, double t) const {
+    const double px = x_[i] + t * (x_[i + 1] - x_[i]);
+    const double py = y_[i] + t * (y_[i + 1] - y_[i]);
+    const double dist = std::hypot(point.x() - px, point.y() - py);
+    bool isLeft = isLeftOf(i, i + 1, point.x(), point.y());
+    // the point is projected onto the end of the segment: the side is decided by the corner (as in isLeftOf)
+    if (t >= 1. && i + 2 < size()) {
+      if (isLeft != isLeftOf(i + 1, i + 2, point.x(), point.y()) && isLeft == isLeftOf(i, i + 1, x_[i + 2], y_[i + 2])) {
+        isLeft = !isLeft;
+      }
+    }
+    return {s_[i] + t * (s_[i + 1] - s_[i]), isLeft ? dist : -dist};
+  }
+
+  //! Same result as geometry::project on the 2d linestring
+  BasicPoint2d project(const BasicPoint2d& point) const {
+    if (size() < 2) {
+      return empty() ? point : BasicPoint2d(x_[0], y_[0]);
+    }
+    const auto seg = closestSegment2d(point.x(), point.y());
+    const auto i = seg.first;
+    return {x_[i] + seg.second * (x_[i + 1] - x_[i]), y_[i] + seg.second * (y_[i + 1] - y_[i])};
+  }
+
+  //! Same result as geometry::project on the 3d linestring
+  BasicPoint3d project(const BasicPoint3d& point) const {
+    if (size() < 2) {
+      return empty() ? point : BasicPoint3d(x_[0], y_[0], z_[0]);
+    }
+    double best = std::numeric_limits<double>::max();
+    BasicPoint3d result;
+    for (size_t i = 0; i + 1 < size(); ++i) {
+      const double dx = x_[i + 1] - x_[i];
+      const double dy = y_[i + 1] - y_[i];
+      const double dz = z_[i + 1] - z_[i];
+      const double len2 = dx * dx + dy * dy + dz * dz;
+      double t = 0.;
+      if (len2 > 0.) {
+        t = ((point.x() - x_[i]) * dx + (point.y() - y_[i]) * dy + (point.z() - z_[i]) * dz) / len2;
+        t = std::min(std::max(t, 0.), 1.);
+      }
+      const BasicPoint3d p(x_[i] + t * dx, y_[i] + t * dy, z_[i] + t * dz);
+      const double d = (p - point).squaredNorm();
+      if (d < best) {
+        best = d;
+        result = p;
+      }
+    }
+    return result;
+  }
+
+  //! Point at the given 2d arc length, clamped to the ends; same as interpolatedPointAtDistance for positive distances
+  BasicPoint3d interpolatedPointAtDistance(double dist) const {
+    if (empty()) {
+      throw InvalidInputError("Can not interpolate on an empty linestring");
+    }
+    if (dist <= 0. || size() == 1) {
+      return {x_.front(), y_.front(), z_.front()};
+    }
+    if (dist >= s_.back()) {
+      return {x_.back(), y_.back(), z_.back()};
+    }
+    const auto i = static_cast<size_t>(std::upper_bound(s_.begin(), s_.end(), dist) - s_.begin()) - 1;
+    const double ds = s_[i + 1] - s_[i];
+    const double t = ds > 0. ? (dist - s_[i]) / ds : 0.;
+    return {x_[i] + t * (x_[i + 1] - x_[i]), y_[i] + t * (y_[i + 1] - y_[i]), z_[i] + t * (z_[i + 1] - z_[i])};
+  }
+
+  //! position t in [0, 1] of the closest point on segment i and its squared 2d distance
+  std::pair<double, double> projectOnSegment2d(size_t i, double px, double py) const {
+    const double dx = x_[i + 1] - x_[i];
+    const double dy = y_[i + 1] - y_[i];
+    const double len2 = dx * dx + dy * dy;
+    double t = 0.;
+    if (len2 > 0.) {
+      t = ((px - x_[i]) * dx + (py - y_[i]) * dy) / len2;
+      t = std::min(std::max(t, 0.), 1.);
+    }
+    const double ex = x_[i] + t * dx - px;
+    const double ey = y_[i] + t * dy - py;
+    return {t, ex * ex + ey * ey};
+  }
+
+ private:
+  //! index of the closest segment and the (clamped) position of the projected point on it
+  std::pair<size_t, double> closestSegment2d(double px, double py) const {
+    const auto proj = internal::closestSegment(x_.data(), y_.data(), size(), px, py);
+    return {proj.segment, proj.t};
+  }
+
+  bool isLeftOf(size_t i1, size_t i2, double px, double py) const {
+    return (x_[i2] - x_[i1]) * (py - y_[i1]) - (y_[i2] - y_[i1]) * (px - x_[i1]) > 0;
+  }
+
+  std::vector<double> x_;
+  std::vector<double> y_;
+  std::vector<double> z_;
+  std::vector<double> s_;
+};
+
+/**
+ * @brief Keeps packed copies of linestrings, keyed by their data and orientation.
+ *
+ * LineStringData has no modification counter, so an entry is revalidated cheaply on access: it is rebuilt if the
+ * number of points or the coordinates of the end points changed. Modifications of inner points have to be announced
+ * with invalidate() (or clear()).
+ */
+class PackedLineStringCache {
+ public:
+  const PackedLineString& get(const ConstLineString3d& lineString) {
+    auto& entry = cache_[Key{lineString.constData().get(), lineString.inverted()}];
+    if (!isValid(entry.packed, lineString)) {
+      entry.lineString = lineString;
+      entry.packed.assign(lineString);
+    }
+    return entry.packed;
+  }
+
+  void invalidate(const ConstLineString3d& lineString) {
+    cache_.erase(Key{lineString.constData().get(), false});
+    cache_.erase(Key{lineString.constData().get(), true});
+  }
+
+  void clear() { cache_.clear(); }
+  size_t size() const noexcept { return cache_.size(); }
+
+ private:
+  using Key = std::pair<const LineStringData*, bool>;
+  struct KeyHash {
+    size_t operator()(const Key& k) const noexcept {
+      return std::hash<const void*>()(k.first) ^ static_cast<size_t>(k.second);
+    }
+  };
+
+  static bool isValid(const PackedLineString& packed, const ConstLineString3d& lineString) {
+    if (packed.size() != lineString.size() || packed.empty()) {
+      return false;
+    }
+    const auto& front = lineString.front();
+    const auto& back = lineString.back();
+    const auto last = packed.size() - 1;
+    return packed.x()[0] == front.x() && packed.y()[0] == front.y() && packed.z()[0] == front.z() &&
+           packed.x()[last] == back.x() && packed.y()[last] == back.y() && packed.z()[last] == back.z();
+  }
+
+  struct Entry {
+    ConstLineString3d lineString;  //!< keeps the data alive, so the key can not be reused by another linestring
+    PackedLineString packed;
+  };
+
+  std::unordered_map<Key, Entry, KeyHash> cache_;
+};
+
+//! @name geometry functions for PackedLineString
+//! These overloads are picked instead of the generic linestring templates when called with a packed linestring.
+//! geometry::length is boost::geometry::length and can not be overloaded, use length2d()/length3d() instead.
+//! @{
+inline ArcCoordinates toArcCoordinates(const PackedLineString& lineString, const BasicPoint2d& point) {
+  return lineString.toArcCoordinates(point);
+}
+inline BasicPoint2d project(const PackedLineString& lineString, const BasicPoint2d& point) {
+  return lineString.project(point);
+}
+inline BasicPoint3d project(const PackedLineString& lineString, const BasicPoint3d& point) {
+  return lineString.project(point);
+}
+//! @}
+
+}  // namespace geometry
+}  // namespace lanelet
@@ -0,0 +1,266 @@
+#pragma once
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "lanelet2_core/geometry/Polygon.h"
+#include "lanelet2_core/primitives/Area.h"
+
+namespace lanelet {
+namespace geometry {
+
+/**
+ * @brief Triangles of a ring with a bounding box hierarchy over them, for point in polygon queries.
+ *
+ * The ring is triangulated once (geometry::triangulate), the triangles are ordered by recursive median splits of their
+ * centroids and, as in IndexedLineString, each level above the triangles merges the boxes of pairs of consecutive
+ * elements. A point query only visits the boxes containing the point and is O(log n) for reasonably shaped polygons
+ * instead of the O(n) ring walk of boost::geometry::covered_by.
+ */
+class TriangulatedRing {
+ public:
+  TriangulatedRing() = default;
+  explicit TriangulatedRing(const BasicPolygon2d& ring) { assign(ring); }
+
+  void assign(const BasicPolygon2d& ring) {
+    triangles_.clear();
+    levels_.clear();
+    edges_.clear();
+    for (size_t i = 0; i < ring.size() && ring.size() > 1; ++i) {
+      edges_.push_back({ring[i], ring[(i + 1) % ring.size()]});
+    }
+    if (ring.size() < 3) {
+      return;
+    }
+    // the ring may come in either orientation (holes are usually counterclockwise), triangulate a clockwise one
+    const BasicPolygon2d clockwise = signedArea(ring) > 0. ? BasicPolygon2d(ring.rbegin(), ring.rend()) : ring;
+    for (const auto& tri : triangulate(clockwise)) {
+      triangles_.push_back({clockwise[tri[0]], clockwise[tri[1]], clockwise[tri[2]]});
+    }
+    if (triangles_.empty()) {
+      return;
+    }
+    sortTriangles(0, triangles_.size());
+    std::vector<Box> leaves(triangles_.size());
+    std::transform(triangles_.begin(), triangles_.end(), leaves.begin(), [](const Triangle& t) { return t.box(); });
+    levels_.push_back(std::move(leaves));
+    while (levels_.back().size() > 1) {
+      const auto& below = levels_.back();
+      std::vector<Box> level((below.size() + 1) / 2);
+      for (size_t i = 0; i < level.size(); ++i) {
+        level[i] = below[2 * i];
+        if (2 * i + 1 < below.size()) {
+          level[i].extend(below[2 * i + 1]);
+        }
+      }
+      levels_.push_back(std::move(level));
+    }
+  }
+
+  size_t numTriangles() const noexcept { return triangles_.size(); }
+  bool empty() const noexcept { return triangles_.empty(); }
+
+  //! whether the point is inside one of the triangles or on its border
+  bool covers(const BasicPoint2d& point) const {
+    if (levels_.empty()) {
+      return false;
+    }
+    const double px = point.x();
+    const double py = point.y();
+    std::pair<size_t, size_t> stack[64];  // (level, index), the depth is bounded by the number of levels
+    size_t top = 0;
+    stack[top++] = {levels_.size() - 1, 0};
+    while (top > 0) {
+      const auto node = stack[--top];
+      if (!levels_[node.first][node.second].contains(px, py)) {
+        continue;
+      }
+      if (node.first == 0) {
+        if (triangles_[node.second].covers(px, py)) {
+          return true;
+        }
+        continue;
+      }
+      const auto& children = levels_[node.first - 1];
+      for (auto child = std::min(2 * node.second + 2, children.size()); child-- > 2 * node.second;) {
+        stack[top++] = {node.first - 1, child};
+      }
+    }
+    return false;
+  }
+
+  //! whether the point is on one of the edges of the ring
+  bool onBorder(const BasicPoint2d& point) const {
+    return std::any_of(edges_.begin(), edges_.end(),
+                       [&point](const auto& edge) { return onSegment(edge.first, edge.second, point); });
+  }
+
+ private:
+  struct Box {
+    double minX, minY, maxX, maxY;
+    void extend(const Box& other) {
+      minX = std::min(minX, other.minX);
+      minY = std::min(minY, other.minY);
+      maxX = std::max(maxX, other.maxX);
+      maxY = std::max(maxY, other.maxY);
+    }
+    bool contains(double x, double y) const { return x >= minX && x <= maxX && y >= minY && y <= maxY; }
+  };
+
+  struct Triangle {
+    BasicPoint2d a, b, c;
+    Box box() const {
+      return {std::min({a.x(), b.x(), c.x()}), std::min({a.y(), b.y(), c.y()}), std::max({a.x(), b.x(), c.x()}),
+              std::max({a.y(), b.y(), c.y()})};
+    }
+    bool covers(double x, double y) const {
+      const double d1 = cross(a, b, x, y);
+      const double d2 = cross(b, c, x, y);
+      const double d3 = cross(c, a, x, y);
+      const bool neg = d1 < 0. || d2 < 0. || d3 < 0.;
+      const bool pos = d1 > 0. || d2 > 0. || d3 > 0.;
+      return !(neg && pos);
+    }
+  };
+
+  static double cross(const BasicPoint2d& a, const BasicPoint2d& b, double x, double y) {
+    return (b.x() - a.x()) * (y - a.y()) - (b.y() - a.y()) * (x - a.x());
+  }
+
+  //! positive for counterclockwise rings
+  static double signedArea(const BasicPolygon2d& ring) {
+    double area = 0.;
+    for (size_t i = 0; i < ring.size(); ++i) {
+      const auto& a = ring[i];
+      const auto& b = ring[(i + 1) % ring.size()];
+      area += a.x() * b.y() - b.x() * a.y();
+    }
+    return area / 2.;
+  }
+
+  static bool onSegment(const BasicPoint2d& a, const BasicPoint2d& b, const BasicPoint2d& p) {
+    return cross(a, b, p.x(), p.y()) == 0. && p.x() >= std::min(a.x(), b.x()) && p.x() <= std::max(a.x(), b.x()) &&
+           p.y() >= std::min(a.y(), b.y()) && p.y() <= std::max(a.y(), b.y());
+  }
+
+  //! orders [first, last) so that consecutive triangles are close to each other
+  void sortTriangles(size_t first, size_t last) {
+    if (last - first <= 2) {
+      return;
+    }
+    Box extent = triangles_[first].box();
+    for (size_t i = first + 1; i < last; ++i) {
+      extent.extend(triangles_[i].box());
+    }
+    const bool splitX = extent.maxX - extent.minX >= extent.maxY - extent.minY;
+    const size_t mid = first + (last - first) / 2;
+    std::nth_element(triangles_.begin() + first, triangles_.begin() + mid, triangles_.begin() + last,
+                     [splitX](const Triangle& lhs, const Triangle& rhs) {
+                       const BasicPoint2d cl = lhs.a + lhs.b + lhs.c;
+                       const BasicPoint2d cr = rhs.a + rhs.b + rhs.c;
+                       return splitX ? cl.x() < cr.x() : cl.y() < cr.y();
+                     });
+    sortTriangles(first, mid);
+    sortTriangles(mid, last);
+  }
+
+  std::vector<Triangle> triangles_;
+  std::vector<std::vector<Box>> levels_;  //!< levels_[0] are the triangles, the last level is the root
+  std::vector<std::pair<BasicPoint2d, BasicPoint2d>> edges_;
+};
+
+/**
+ * @brief Triangulated outer bound and holes of a polygon, answering inside() like boost::geometry::covered_by.
+ *
+ * A point is inside if a triangle of the outer ring covers it and it is not in the interior of a hole (points on the
+ * border of a hole are inside, as for covered_by). Holes are usually small and few, they are tested through their own
+ * triangulation as well.
+ */
+class TriangulatedPolygon {
+ public:
+  TriangulatedPolygon() = default;
+  explicit TriangulatedPolygon(const BasicPolygonWithHoles2d& polygon) { assign(polygon); }
+  explicit TriangulatedPolygon(const BasicPolygon2d& polygon) { assign(BasicPolygonWithHoles2d{polygon, {}}); }
+
+  void assign(const BasicPolygonWithHoles2d& polygon) {
+    outer_.assign(polygon.outer);
+    inner_.resize(polygon.inner.size());
+    for (size_t i = 0; i < polygon.inner.size(); ++i) {
+      inner_[i].assign(polygon.inner[i]);
+    }
+  }
+
+  bool inside(const BasicPoint2d& point) const {
+    if (!outer_.covers(point)) {
+      return false;
+    }
+    return std::none_of(inner_.begin(), inner_.end(),
+                        [&point](const TriangulatedRing& hole) { return hole.covers(point) && !hole.onBorder(point); });
+  }
+
+  const TriangulatedRing& outer() const noexcept { return outer_; }
+  const std::vector<TriangulatedRing>& inner() const noexcept { return inner_; }
+
+ private:
+  TriangulatedRing outer_;
+  std::vector<TriangulatedRing> inner_;
+};
+
+/**
+ * @brief Keeps a TriangulatedPolygon of every area it is asked for.
+ *
+ * The triangulation is computed on the first query of an area and reused afterwards. An entry is rebuilt if the
+ * number of points of the area changed; after moving points of an area in place (or AreaData::resetCache), call
+ * invalidate() or clear().
+ */
+class TriangulationCache {
+ public:
+  const TriangulatedPolygon& get(const ConstArea& area) { return entry(area).triangulation; }
+
+  //! same result as geometry::inside(area, point)
+  bool inside(const ConstArea& area, const BasicPoint2d& point) {
+    const auto& e = entry(area);
+    return e.boundingBox.contains(point) && e.triangulation.inside(point);
+  }
+
+  void invalidate(const ConstArea& area) { cache_.erase(area.constData().get()); }
+  void clear() { cache_.clear(); }
+  size_t size() const noexcept { return cache_.size(); }
+
+ private:
+  struct Entry {
+    Optional<ConstArea> area;  //!< keeps the area data alive so that its address is not reused
+    size_t numPoints{0};
+    BoundingBox2d boundingBox;
+    TriangulatedPolygon triangulation;
+  };
+
+  static size_t numPoints(const AreaData& data) {
+    const auto& inner = data.innerBoundPolygons();
+    return std::accumulate(inner.begin(), inner.end(), data.outerBoundPolygon().size(),
+                           [](size_t n, const CompoundPolygon3d& hole) { return n + hole.size(); });
+  }
+
+  Entry& entry(const ConstArea& area) {
+    const auto numPoints = TriangulationCache::numPoints(*area.constData());
+    auto& entry = cache_[area.constData().get()];
+    if (!entry.area || entry.numPoints != numPoints) {
+      const auto polygon = area.basicPolygonWithHoles2d();
+      entry.area = area;
+      entry.numPoints = numPoints;
+      entry.boundingBox = BoundingBox2d();
+      for (const auto& p : polygon.outer) {
+        entry.boundingBox.extend(p);
+      }
+      entry.triangulation.assign(polygon);
+    }
+    return entry;
+  }
+
+  std::unordered_map<const AreaData*, Entry> cache_;
+};
+
+}  // namespace geometry
+}  // namespace lanelet
@@ -0,0 +1,195 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+#include "lanelet2_core/primitives/LineString.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LANELET2_SEGMENT_PROJECTION_NEON
+#endif
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define LANELET2_SEGMENT_PROJECTION_AVX2
+#endif
+
+namespace lanelet {
+namespace geometry {
+namespace internal {
+/**
+ * @brief Closest segment of a polyline to a point.
+ *
+ * The kernels project the point onto several segments at once (2 with NEON, 4 with AVX2). The selection of the
+ * minimum is done in segment order in all kernels, so they return the same segment as the scalar version (the first
+ * one on ties).
+ */
+struct SegmentProjection {
+  size_t segment{0};          //!< index of the first point of the segment
+  double t{0.};               //!< position of the projected point on the segment in [0, 1]
+  double squaredDistance{std::numeric_limits<double>::max()};
+};
+
+//! keeps the first minimum, as the scalar loop does
+inline void updateProjection(SegmentProjection& best, size_t segment, double t, double squaredDistance) {
+  if (squaredDistance < best.squaredDistance) {
+    best = {segment, t, squaredDistance};
+  }
+}
+
+//! Reference kernel. Point i is (x[i * stride], y[i * stride]).
+inline SegmentProjection closestSegmentScalar(const double* x, const double* y, size_t stride, size_t n, double px,
+                                              double py) {
+  SegmentProjection best;
+  for (size_t i = 0; i + 1 < n; ++i) {
+    const double x0 = x[i * stride];
+    const double y0 = y[i * stride];
+    const double dx = x[(i + 1) * stride] - x0;
+    const double dy = y[(i + 1) * stride] - y0;
+    const double len2 = dx * dx + dy * dy;
+    double t = 0.;
+    if (len2 > 0.) {
+      t = std::min(std::max(((px - x0) * dx + (py - y0) * dy) / len2, 0.), 1.);
+    }
+    const double ex = x0 + t * dx - px;
+    const double ey = y0 + t * dy - py;
+    updateProjection(best, i, t, ex * ex + ey * ey);
+  }
+  return best;
+}
+
+#ifdef LANELET2_SEGMENT_PROJECTION_NEON
+//! NEON kernel, two segments per iteration. Interleaved input (BasicLineString2d) is split with vld2q.
+template <bool Interleaved>
+inline SegmentProjection closestSegmentNeon(const double* x, const double* y, size_t n, double px, double py) {
+  SegmentProjection best;
+  if (n < 2) {
+    return best;
+  }
+  const size_t numSegments = n - 1;
+  const float64x2_t vpx = vdupq_n_f64(px);
+  const float64x2_t vpy = vdupq_n_f64(py);
+  const float64x2_t zero = vdupq_n_f64(0.);
+  const float64x2_t one = vdupq_n_f64(1.);
+  size_t i = 0;
+  for (; i + 2 <= numSegments; i += 2) {
+    float64x2_t x0, y0, x1, y1;
+    if (Interleaved) {
+      const float64x2x2_t p0 = vld2q_f64(x + 2 * i);
+      const float64x2x2_t p1 = vld2q_f64(x + 2 * (i + 1));
+      x0 = p0.val[0];
+      y0 = p0.val[1];
+      x1 = p1.val[0];
+      y1 = p1.val[1];
+    } else {
+      x0 = vld1q_f64(x + i);
+      y0 = vld1q_f64(y + i);
+      x1 = vld1q_f64(x + i + 1);
+      y1 = vld1q_f64(y + i + 1);
+    }
+    const float64x2_t dx = vsubq_f64(x1, x0);
+    const float64x2_t dy = vsubq_f64(y1, y0);
+    const float64x2_t len2 = vaddq_f64(vmulq_f64(dx, dx), vmulq_f64(dy, dy));
+    const float64x2_t num = vaddq_f64(vmulq_f64(vsubq_f64(vpx, x0), dx), vmulq_f64(vsubq_f64(vpy, y0), dy));
+    const uint64x2_t valid = vcgtq_f64(len2, zero);
+    float64x2_t t = vdivq_f64(num, vbslq_f64(valid, len2, one));
+    t = vbslq_f64(valid, vminq_f64(vmaxq_f64(t, zero), one), zero);
+    const float64x2_t ex = vsubq_f64(vaddq_f64(x0, vmulq_f64(t, dx)), vpx);
+    const float64x2_t ey = vsubq_f64(vaddq_f64(y0, vmulq_f64(t, dy)), vpy);
+    const float64x2_t d = vaddq_f64(vmulq_f64(ex, ex), vmulq_f64(ey, ey));
+    updateProjection(best, i, vgetq_lane_f64(t, 0), vgetq_lane_f64(d, 0));
+    updateProjection(best, i + 1, vgetq_lane_f64(t, 1), vgetq_lane_f64(d, 1));
+  }
+  if (i < numSegments) {
+    const size_t stride = Interleaved ? 2 : 1;
+    auto tail = closestSegmentScalar(x + i * stride, y + i * stride, stride, n - i, px, py);
+    updateProjection(best, tail.segment + i, tail.t, tail.squaredDistance);
+  }
+  return best;
+}
+#endif
+
+#ifdef LANELET2_SEGMENT_PROJECTION_AVX2
+//! AVX2 kernel for separate coordinate arrays, four segments per iteration. Only called if the cpu supports it.
+__attribute__((target("avx2"))) inline SegmentProjection closestSegmentAvx2(const double* x, const double* y,
+                                                                             size_t n, double px, double py) {
+  SegmentProjection best;
+  if (n < 2) {
+    return best;
+  }
+  const size_t numSegments = n - 1;
+  const __m256d vpx = _mm256_set1_pd(px);
+  const __m256d vpy = _mm256_set1_pd(py);
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d one = _mm256_set1_pd(1.);
+  alignas(32) double tLanes[4];
+  alignas(32) double dLanes[4];
+  size_t i = 0;
+  for (; i + 4 <= numSegments; i += 4) {
+    const __m256d x0 = _mm256_loadu_pd(x + i);
+    const __m256d y0 = _mm256_loadu_pd(y + i);
+    const __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + i + 1), x0);
+    const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + i + 1), y0);
+    const __m256d len2 = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+    const __m256d num =
+        _mm256_add_pd(_mm256_mul_pd(_mm256_sub_pd(vpx, x0), dx), _mm256_mul_pd(_mm256_sub_pd(vpy, y0), dy));
+    const __m256d valid = _mm256_cmp_pd(len2, zero, _CMP_GT_OQ);
+    __m256d t = _mm256_div_pd(num, _mm256_blendv_pd(one, len2, valid));
+    t = _mm256_blendv_pd(zero, _mm256_min_pd(_mm256_max_pd(t, zero), one), valid);
+    const __m256d ex = _mm256_sub_pd(_mm256_add_pd(x0, _mm256_mul_pd(t, dx)), vpx);
+    const __m256d ey = _mm256_sub_pd(_mm256_add_pd(y0, _mm256_mul_pd(t, dy)), vpy);
+    _mm256_store_pd(tLanes, t);
+    _mm256_store_pd(dLanes, _mm256_add_pd(_mm256_mul_pd(ex, ex), _mm256_mul_pd(ey, ey)));
+    for (size_t lane = 0; lane < 4; ++lane) {
+      updateProjection(best, i + lane, tLanes[lane], dLanes[lane]);
+    }
+  }
+  if (i < numSegments) {
+    auto tail = closestSegmentScalar(x + i, y + i, 1, n - i, px, py);
+    updateProjection(best, tail.segment + i, tail.t, tail.squaredDistance);
+  }
+  return best;
+}
+#endif
+
+using ClosestSegmentKernel = SegmentProjection (*)(const double*, const double*, size_t, double, double);
+
+inline SegmentProjection closestSegmentScalarSoA(const double* x, const double* y, size_t n, double px, double py) {
+  return closestSegmentScalar(x, y, 1, n, px, py);
+}
+
+//! picks the fastest kernel the cpu supports. NEON is part of every aarch64 cpu, AVX2 is checked at runtime.
+inline ClosestSegmentKernel selectClosestSegmentKernel() {
+#ifdef LANELET2_SEGMENT_PROJECTION_AVX2
+  if (__builtin_cpu_supports("avx2")) {
+    return &closestSegmentAvx2;
+  }
+#endif
+#ifdef LANELET2_SEGMENT_PROJECTION_NEON
+  return &closestSegmentNeon<false>;
+#else
+  return &closestSegmentScalarSoA;
+#endif
+}
+
+//! Closest segment for separate x and y arrays of n points
+inline SegmentProjection closestSegment(const double* x, const double* y, size_t n, double px, double py) {
+  static const ClosestSegmentKernel kernel = selectClosestSegmentKernel();
+  return kernel(x, y, n, px, py);
+}
+
+//! Closest segment of a BasicLineString2d (interleaved coordinates)
+inline SegmentProjection closestSegment(const BasicLineString2d& lineString, const BasicPoint2d& point) {
+  if (lineString.empty()) {
+    return {};
+  }
+  const double* xy = lineString.front().data();
+#ifdef LANELET2_SEGMENT_PROJECTION_NEON
+  return closestSegmentNeon<true>(xy, xy + 1, lineString.size(), point.x(), point.y());
+#else
+  return closestSegmentScalar(xy, xy + 1, 2, lineString.size(), point.x(), point.y());
+#endif
+}
+}  // namespace internal
+}  // namespace geometry
+}  // namespace lanelet
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <functional>
+
+#include "lanelet2_core/FrozenGeometry.h"
+#include "lanelet2_core/primitives/Lanelet.h"
+
+namespace lanelet {
+
+/**
+ * @brief Non owning view on a lanelet: a raw pointer to its data and the orientation.
+ *
+ * Copying, inverting and comparing a ConstLanelet copies a shared_ptr, so a routing search or path construction that
+ * passes lanelets around by value causes two atomic reference count operations per copy, and centerline2d() of an
+ * inverted lanelet creates handles of the inverted centerline. A LaneletRef is a few words without reference counting:
+ * it is created from a ConstLanelet for free and inverts in place. One created by FrozenLaneletMap::laneletRef also
+ * points to the FrozenLaneletGeometry of the lanelet and reads the 2d centerline of either orientation, its length and
+ * the bounding box from there as plain points.
+ *
+ * Neither the referenced LaneletData nor the geometry are kept alive: a LaneletRef must not outlive the map or graph
+ * that owns the lanelet. Use it for the hot loops and keep ConstLanelet for what is stored or returned. The geometry is
+ * immutable, so the refs can be used by concurrent readers.
+ */
+class LaneletRef {
+ public:
+  LaneletRef() = default;
+  LaneletRef(const ConstLanelet& lanelet) noexcept  // NOLINT
+      : data_{lanelet.constData().get()}, inverted_{lanelet.inverted()} {}
+  LaneletRef(const ConstLanelet& lanelet, const FrozenLaneletGeometry& geometry) noexcept
+      : data_{lanelet.constData().get()}, geometry_{&geometry}, inverted_{lanelet.inverted()} {}
+  explicit LaneletRef(const LaneletData* data, bool inverted = false,
+                      const FrozenLaneletGeometry* geometry = nullptr) noexcept
+      : data_{data}, geometry_{geometry}, inverted_{inverted} {}
+
+  bool valid() const noexcept { return data_ != nullptr; }
+  const LaneletData* data() const noexcept { return data_; }
+  Id id() const noexcept { return data_->id; }
+  bool inverted() const noexcept { return inverted_; }
+  LaneletRef invert() const noexcept { return LaneletRef{data_, !inverted_, geometry_}; }
+
+  const AttributeMap& attributes() const { return data_->attributes; }
+
+  //! whether the geometry is available, i.e. the ref was created by FrozenLaneletMap::laneletRef
+  bool hasGeometry() const noexcept { return geometry_ != nullptr; }
+  //! the cached geometry of the lanelet, requires hasGeometry()
+  const FrozenLaneletGeometry& geometry() const noexcept { return *geometry_; }
+  //! the 2d centerline in the orientation of this view, requires hasGeometry()
+  const BasicLineString2d& centerline2d() const noexcept { return geometry_->centerline[inverted_ ? 1 : 0]; }
+  //! 2d length of the centerline, requires hasGeometry()
+  double length2d() const noexcept { return geometry_->length; }
+  //! same as geometry::boundingBox2d of the lanelet, one box for both orientations. Requires hasGeometry().
+  const BoundingBox2d& boundingBox2d() const noexcept { return geometry_->boundingBox; }
+
+  //! whether this views the lanelet in the same orientation
+  bool is(const ConstLanelet& lanelet) const noexcept {
+    return data_ == lanelet.constData().get() && inverted_ == lanelet.inverted();
+  }
+
+  bool operator==(const LaneletRef& rhs) const noexcept { return data_ == rhs.data_ && inverted_ == rhs.inverted_; }
+  bool operator!=(const LaneletRef& rhs) const noexcept { return !(*this == rhs); }
+
+ private:
+  const LaneletData* data_{nullptr};
+  const FrozenLaneletGeometry* geometry_{nullptr};
+  bool inverted_{false};
+};
+
+using LaneletRefs = std::vector<LaneletRef>;
+
+}  // namespace lanelet
+
+namespace std {
+template <>
+struct hash<lanelet::LaneletRef> {
+  size_t operator()(const lanelet::LaneletRef& ref) const noexcept {
+    return std::hash<const void*>()(ref.data()) ^ static_cast<size_t>(ref.inverted());
+  }
+};
+}  // namespace std
@@ -1,7 +1,13 @@
 #pragma once
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
 #include <map>
 #include <ostream>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -35,6 +41,10 @@ class ArrayView {
   }
 };
 
+}  // namespace detail
+
+#ifndef LANELET2_HYBRID_MAP_FLAT
+namespace detail {
 template <typename Iterator, typename Map>
 std::vector<Iterator> copyIterators(const std::vector<Iterator>& oldV, const Map& oldM, Map& newM) {
   std::vector<Iterator> newV(oldV.size(), newM.end());
@@ -62,6 +72,9 @@ void replaceIterator(Vector& v, const Iterator& replace, const Iterator& by) {
  * than using strings for the lookup.
  * @tparam Enum an enum with *continuous* values. The last element must be named
  * "End".
+ *
+ * This is the default std::map backend, which the prebuilt lanelet2 libraries use. The flat backend below has a
+ * different layout and contract and is only selected with LANELET2_HYBRID_MAP_FLAT.
  */
 template <typename ValueT, typename PairArrayT, PairArrayT PairArray>
 class HybridMap {
@@ -230,6 +243,228 @@ class HybridMap {
   Map m_;
   Vec v_;
 };
+#else
+/**
+ * @brief A hybrid map is just like a normal map with keys as string, but
+ * elements can also be accessed using an enum for the keys. This is much faster
+ * than using strings for the lookup.
+ * @tparam Enum an enum with *continuous* values. The last element must be named
+ * "End".
+ *
+ * The elements are stored in one vector sorted by key, like a flat map: primitives have a handful of tags, so one
+ * allocation for all of them and a binary search over contiguous memory beat a tree node per tag. A fixed array maps
+ * the enum keys to positions in that vector. As for a vector, insert and erase invalidate iterators and references,
+ * and the keys of the elements must not be modified through iterators (value_type has a non-const key). Iteration
+ * order is the key order, as for the std::map backend.
+ *
+ * Opt-in with LANELET2_HYBRID_MAP_FLAT: it changes the layout of AttributeMap and of every primitive data class, so
+ * all lanelet2 libraries and everything linking them must be built with the same setting.
+ */
+template <typename ValueT, typename PairArrayT, PairArrayT PairArray>
+class HybridMap {
+  using Array = detail::ArrayView<PairArrayT, PairArray>;
+  static constexpr uint32_t NoPosition = std::numeric_limits<uint32_t>::max();
+  static constexpr size_t InitialCapacity = 4;  //!< most primitives have a few tags, skip the first regrowths
+
+  static constexpr size_t numEnums() {
+    size_t n = 0;
+    for (auto it = Array::begin(); it != Array::end(); ++it) {
+      n = std::max(n, static_cast<size_t>(it->second) + 1);
+    }
+    return n;
+  }
+  using Vec = std::array<uint32_t, numEnums()>;
+  static constexpr Vec noPositions() {
+    Vec v{};
+    for (auto& p : v) {
+      p = NoPosition;
+    }
+    return v;
+  }
+
+ public:
+  using Map = std::vector<std::pair<std::string, ValueT>>;
+  using Enum = std::decay_t<decltype(PairArray[0].second)>;
+
+  using key_type = std::string;                           // NOLINT
+  using mapped_type = ValueT;                             // NOLINT
+  using iterator = typename Map::iterator;                // NOLINT
+  using const_iterator = typename Map::const_iterator;    // NOLINT
+  using value_type = typename Map::value_type;            // NOLINT
+  using difference_type = typename Map::difference_type;  // NOLINT
+  using size_type = typename Map::size_type;              // NOLINT
+  HybridMap() noexcept = default;
+  HybridMap(HybridMap&& rhs) noexcept = default;
+  HybridMap& operator=(HybridMap&& rhs) noexcept = default;
+  HybridMap(const HybridMap& rhs) = default;
+  HybridMap& operator=(const HybridMap& rhs) = default;
+  HybridMap(const std::initializer_list<std::pair<const std::string, ValueT>>& list) {
+    m_.reserve(list.size());
+    for (const auto& item : list) {
+      insert(value_type(item.first, item.second));
+    }
+  }
+  template <typename InputIterator>
+  HybridMap(InputIterator begin, InputIterator end) {
+    for (; begin != end; ++begin) {
+      insert(value_type(begin->first, begin->second));
+    }
+  }
+
+  ~HybridMap() noexcept = default;
+
+  iterator find(const key_type& k) {
+    auto it = lowerBound(k);
+    return it != m_.end() && it->first == k ? it : m_.end();
+  }
+  iterator find(Enum k) {
+    const auto pos = static_cast<size_t>(k);
+    return pos >= v_.size() || v_[pos] == NoPosition ? m_.end() : m_.begin() + v_[pos];
+  }
+  const_iterator find(const key_type& k) const {
+    auto it = lowerBound(k);
+    return it != m_.end() && it->first == k ? it : m_.end();
+  }
+  const_iterator find(Enum k) const {
+    const auto pos = static_cast<size_t>(k);
+    return pos >= v_.size() || v_[pos] == NoPosition ? m_.end() : m_.begin() + v_[pos];
+  }
+
+  iterator begin() { return m_.begin(); }
+  iterator end() { return m_.end(); }
+  const_iterator begin() const { return m_.begin(); }
+  const_iterator end() const { return m_.end(); }
+
+  std::pair<iterator, bool> insert(const value_type& v) { return insert(value_type(v)); }
+  std::pair<iterator, bool> insert(value_type&& v) {
+    auto it = lowerBound(v.first);
+    if (it != m_.end() && it->first == v.first) {
+      return {it, false};
+    }
+    return {insertAt(static_cast<size_t>(it - m_.begin()), std::move(v)), true};
+  }
+
+  //! the hint is used if it is the end and the key is larger than all others, which is the case when loading
+  iterator insert(const_iterator hint, const value_type& v) {
+    if (hint == m_.end() && (m_.empty() || m_.back().first < v.first)) {
+      return insertAt(m_.size(), value_type(v));
+    }
+    return insert(v).first;
+  }
+
+  iterator erase(const_iterator pos) {
+    const auto idx = static_cast<uint32_t>(pos - m_.cbegin());
+    for (auto& p : v_) {
+      if (p == idx) {
+        p = NoPosition;
+      } else if (p != NoPosition && p > idx) {
+        --p;
+      }
+    }
+    return m_.erase(pos);
+  }
+
+  size_type erase(const std::string& k) {
+    auto it = find(k);
+    if (it == end()) {
+      return 0;
+    }
+    erase(it);
+    return 1;
+  }
+
+  ValueT& operator[](const key_type& k) {
+    auto it = find(k);
+    if (it == m_.end()) {
+      it = insert({k, mapped_type()}).first;
+    }
+    return it->second;
+  }
+  ValueT& operator[](const Enum& k) {
+    auto it = find(k);
+    auto end = m_.end();
+    if (it == end) {
+      auto attr = Array::findValue(k);
+      it = insert({attr->first, mapped_type()}).first;
+    }
+    return it->second;
+  }
+
+  const ValueT& at(const key_type& k) const {
+    auto it = find(k);
+    if (it == m_.end()) {
+      throw std::out_of_range(std::string("Could not find ") + k);
+    }
+    return it->second;
+  }
+  const ValueT& at(const Enum& k) const {
+    auto it = find(k);
+    if (it == m_.end()) {
+      throw std::out_of_range(std::string("Could not find ") + std::to_string(static_cast<int>(k)));
+    }
+    return it->second;
+  }
+
+  ValueT& at(const key_type& k) {
+    auto it = find(k);
+    if (it == m_.end()) {
+      throw std::out_of_range(std::string("Could not find ") + k);
+    }
+    return it->second;
+  }
+  ValueT& at(const Enum& k) {
+    auto it = find(k);
+    if (it == m_.end()) {
+      throw std::out_of_range(std::string("Could not find ") + std::to_string(static_cast<int>(k)));
+    }
+    return it->second;
+  }
+
+  void clear() { m_.clear(), v_ = noPositions(); }
+  void reserve(size_type n) { m_.reserve(n); }
+
+  bool empty() const { return m_.empty(); }
+  size_t size() const { return m_.size(); }
+
+  auto key_comp() const { return std::less<std::string>(); }    // NOLINT
+  auto value_comp() const { return std::less<std::string>(); }  // NOLINT
+
+  bool operator==(const HybridMap& other) const { return this->m_ == other.m_; }
+  bool operator!=(const HybridMap& other) const { return !(*this == other); }
+
+ private:
+  iterator lowerBound(const std::string& k) {
+    return std::lower_bound(m_.begin(), m_.end(), k, [](const value_type& e, const std::string& key) {
+      return e.first < key;
+    });
+  }
+  const_iterator lowerBound(const std::string& k) const {
+    return std::lower_bound(m_.begin(), m_.end(), k, [](const value_type& e, const std::string& key) {
+      return e.first < key;
+    });
+  }
+
+  iterator insertAt(size_t idx, value_type&& v) {
+    if (m_.capacity() == 0) {
+      m_.reserve(InitialCapacity);
+    }
+    for (auto& p : v_) {
+      if (p != NoPosition && p >= idx) {
+        ++p;
+      }
+    }
+    auto it = m_.insert(m_.begin() + static_cast<difference_type>(idx), std::move(v));
+    auto attr = Array::findKey(it->first.c_str());
+    if (attr != std::end(PairArray)) {  // NOLINT
+      v_[static_cast<size_t>(attr->second)] = static_cast<uint32_t>(idx);
+    }
+    return it;
+  }
+
+  Map m_;  //!< sorted by key
+  Vec v_{noPositions()};  //!< position in m_ for each enum key
+};
+#endif
 
 template <typename Value, typename Enum, const std::pair<const char*, const Enum> Lookup[]>
 std::ostream& operator<<(std::ostream& stream, HybridMap<Value, Enum, Lookup> map) {
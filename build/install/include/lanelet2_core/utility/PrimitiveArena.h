@@ -0,0 +1,118 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace lanelet {
+
+/**
+ * @brief Monotonic memory resource for the primitive data of a map.
+ *
+ * Memory is handed out from a few large blocks and is only released when the arena is destroyed, deallocation is a
+ * no-op. Allocation is not synchronized, so an arena must only be filled from one thread at a time (usually while a map
+ * is loaded). Destruction is safe from any thread.
+ */
+class PrimitiveArena {
+ public:
+  static constexpr size_t DefaultBlockSize = size_t(1) << 20;
+
+  explicit PrimitiveArena(size_t blockSize = DefaultBlockSize) : blockSize_{std::max(blockSize, size_t(1024))} {}
+  PrimitiveArena(const PrimitiveArena&) = delete;
+  PrimitiveArena& operator=(const PrimitiveArena&) = delete;
+  PrimitiveArena(PrimitiveArena&&) = delete;
+  PrimitiveArena& operator=(PrimitiveArena&&) = delete;
+  ~PrimitiveArena() = default;
+
+  //! Reserves space for roughly this many bytes so that the next allocations do not need a new block
+  void reserve(size_t bytes) {
+    if (bytes > static_cast<size_t>(end_ - head_)) {
+      addBlock(bytes);
+    }
+  }
+
+  void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+    auto* p = align(head_, alignment);
+    if (head_ == nullptr || p + bytes > end_) {
+      addBlock(std::max(blockSize_, bytes + alignment));
+      p = align(head_, alignment);
+    }
+    head_ = p + bytes;
+    allocated_ += bytes;
+    return p;
+  }
+
+  //! number of bytes handed out so far
+  size_t allocated() const noexcept { return allocated_; }
+  //! number of bytes held in blocks
+  size_t capacity() const noexcept { return capacity_; }
+
+ private:
+  static char* align(char* p, size_t alignment) {
+    const auto addr = reinterpret_cast<std::uintptr_t>(p);
+    return p + ((alignment - addr % alignment) % alignment);
+  }
+
+  void addBlock(size_t bytes) {
+    blocks_.emplace_back(new char[bytes]);
+    head_ = blocks_.back().get();
+    end_ = head_ + bytes;
+    capacity_ += bytes;
+  }
+
+  size_t blockSize_;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  char* head_{nullptr};
+  char* end_{nullptr};
+  size_t allocated_{0};
+  size_t capacity_{0};
+};
+using PrimitiveArenaPtr = std::shared_ptr<PrimitiveArena>;
+
+/**
+ * @brief Standard allocator on top of a PrimitiveArena.
+ *
+ * Every copy of the allocator shares ownership of the arena. std::allocate_shared keeps a copy in the control block of
+ * each object, so the arena lives until the last primitive allocated from it is gone, no matter if the map or a copy of
+ * a primitive is destroyed last.
+ */
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;  // NOLINT
+
+  explicit ArenaAllocator(PrimitiveArenaPtr arena) noexcept : arena_{std::move(arena)} {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_{other.arena()} {}  // NOLINT
+
+  T* allocate(size_t n) { return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T))); }
+  void deallocate(T* /*p*/, size_t /*n*/) noexcept {}
+
+  const PrimitiveArenaPtr& arena() const noexcept { return arena_; }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& rhs) const noexcept {
+    return arena_ == rhs.arena();
+  }
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U>& rhs) const noexcept {
+    return !(*this == rhs);
+  }
+
+ private:
+  PrimitiveArenaPtr arena_;
+};
+
+//! Creates the data object of a primitive in the arena or, if arena is null, with std::make_shared
+template <typename DataT, typename... Args>
+std::shared_ptr<DataT> makeSharedData(const PrimitiveArenaPtr& arena, Args&&... args) {
+  if (!arena) {
+    return std::make_shared<DataT>(std::forward<Args>(args)...);
+  }
+  return std::allocate_shared<DataT>(ArenaAllocator<DataT>(arena), std::forward<Args>(args)...);
+}
+
+}  // namespace lanelet
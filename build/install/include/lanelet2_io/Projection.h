@@ -2,6 +2,8 @@
 #include <lanelet2_core/primitives/GPSPoint.h>
 #include <lanelet2_core/primitives/Point.h>
 
+#include <algorithm>
+#include <future>
 #include <memory>
 #include <vector>
 
@@ -37,10 +39,49 @@ class Projector {  // NOLINT
   //! @throws ReverseProjectionError if projection is impossible
   virtual GPSPoint reverse(const BasicPoint3d& p) const = 0;
 
+  /**
+   * @brief Project n points from lat/lon coordinates to the local coordinate system, out[i] = forward(gps[i])
+   *
+   * With more than one thread, contiguous chunks are projected concurrently (forward has to be thread safe, which it is
+   * for the projectors of lanelet2). Meant for bulk conversions like map loading, small batches run sequentially.
+   * @throws ForwardProjectionError if the projection of one of the points is impossible
+   */
+  void forward(const GPSPoint* gps, BasicPoint3d* out, size_t n, size_t numThreads = 1) const {
+    const auto chunks = std::max<size_t>(1, std::min(numThreads, n / MinPointsPerThread));
+    if (chunks == 1) {
+      for (size_t i = 0; i < n; ++i) {
+        out[i] = forward(gps[i]);
+      }
+      return;
+    }
+    std::vector<std::future<void>> futures;
+    futures.reserve(chunks);
+    for (size_t c = 0; c < chunks; ++c) {
+      const size_t begin = n * c / chunks;
+      const size_t end = n * (c + 1) / chunks;
+      futures.push_back(std::async(std::launch::async, [this, gps, out, begin, end] {
+        for (size_t i = begin; i < end; ++i) {
+          out[i] = forward(gps[i]);
+        }
+      }));
+    }
+    for (auto& future : futures) {
+      future.get();
+    }
+  }
+
+  //! @brief Batch version of forward, see above
+  std::vector<BasicPoint3d> forward(const std::vector<GPSPoint>& gps, size_t numThreads = 1) const {
+    std::vector<BasicPoint3d> result(gps.size());
+    forward(gps.data(), result.data(), gps.size(), numThreads);
+    return result;
+  }
+
   //! Obtain the internal origin
   const Origin& origin() const { return origin_; }
 
  private:
+  static constexpr size_t MinPointsPerThread = 4096;
   Origin origin_;
 };
 
@@ -54,6 +95,7 @@ namespace projection {
 class SphericalMercatorProjector : public Projector {
  public:
   using Projector::Projector;
+  using Projector::forward;
   BasicPoint3d forward(const GPSPoint& p) const override {
     const auto scale = std::cos(origin().position.lat * M_PI / 180.0);
     const double x{scale * p.lon * M_PI * EarthRadius / 180.0};
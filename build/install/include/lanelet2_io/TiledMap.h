@@ -0,0 +1,378 @@
+#pragma once
+#include <lanelet2_core/LaneletMap.h>
+#include <lanelet2_core/geometry/Area.h>
+#include <lanelet2_core/geometry/Lanelet.h>
+#include <lanelet2_core/geometry/LineString.h>
+#include <lanelet2_core/geometry/Polygon.h>
+
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "lanelet2_io/Exceptions.h"
+#include "lanelet2_io/io_handlers/FlatHandler.h"
+
+namespace lanelet {
+
+//! Position of a tile in the grid of a TileManifest, tile (x, y) covers [x, x + 1) * tileSize x [y, y + 1) * tileSize
+struct TileKey {
+  int32_t x{0};
+  int32_t y{0};
+  friend bool operator==(const TileKey& lhs, const TileKey& rhs) { return lhs.x == rhs.x && lhs.y == rhs.y; }
+  friend bool operator!=(const TileKey& lhs, const TileKey& rhs) { return !(lhs == rhs); }
+  friend bool operator<(const TileKey& lhs, const TileKey& rhs) {
+    return lhs.x < rhs.x || (lhs.x == rhs.x && lhs.y < rhs.y);
+  }
+};
+
+/**
+ * @brief Index of a map cut into tiles by cutIntoTiles: the tiles, what they cover and the tile of every lanelet.
+ *
+ * Stored as text file "tiles.manifest" next to the tiles, small enough to be read completely at startup.
+ */
+class TileManifest {
+ public:
+  static constexpr const char* FileName = "tiles.manifest";
+
+  struct LaneletEntry {
+    TileKey tile;
+    BoundingBox2d box;
+  };
+
+  TileManifest() = default;
+  explicit TileManifest(double tileSize) : tileSize_{tileSize} {}
+
+  double tileSize() const noexcept { return tileSize_; }
+  const std::map<TileKey, BoundingBox2d>& tiles() const noexcept { return tiles_; }
+  const std::unordered_map<Id, LaneletEntry>& lanelets() const noexcept { return lanelets_; }
+
+  TileKey tileOf(const BasicPoint2d& p) const {
+    return {static_cast<int32_t>(std::floor(p.x() / tileSize_)), static_cast<int32_t>(std::floor(p.y() / tileSize_))};
+  }
+
+  //! file name of a tile, relative to the directory of the manifest
+  static std::string tileFile(const TileKey& key) {
+    return "tile_" + std::to_string(key.x) + "_" + std::to_string(key.y) + ".flat";
+  }
+
+  //! existing tiles whose content overlaps the box. The content of a tile can reach out of its grid cell.
+  std::vector<TileKey> tilesIn(const BoundingBox2d& box) const {
+    std::vector<TileKey> result;
+    for (const auto& tile : tiles_) {
+      if (tile.second.intersects(box)) {
+        result.push_back(tile.first);
+      }
+    }
+    return result;
+  }
+
+  void addTile(const TileKey& key, const BoundingBox2d& content) { tiles_[key] = content; }
+  void addLanelet(Id id, const TileKey& key, const BoundingBox2d& box) { lanelets_[id] = {key, box}; }
+
+  //! @throws WriteError if the file can not be written
+  void save(const std::string& filename) const {
+    std::ofstream out(filename);
+    if (!out.good()) {
+      throw WriteError("Failed to open tile manifest " + filename);
+    }
+    out.precision(17);
+    out << "lanelet2_tiles " << Version << '\n' << "tile_size " << tileSize_ << '\n';
+    for (const auto& tile : tiles_) {
+      out << "tile " << tile.first.x << ' ' << tile.first.y << ' ' << tile.second.min().x() << ' '
+          << tile.second.min().y() << ' ' << tile.second.max().x() << ' ' << tile.second.max().y() << '\n';
+    }
+    for (const auto& llt : lanelets_) {
+      out << "lanelet " << llt.first << ' ' << llt.second.tile.x << ' ' << llt.second.tile.y << ' '
+          << llt.second.box.min().x() << ' ' << llt.second.box.min().y() << ' ' << llt.second.box.max().x() << ' '
+          << llt.second.box.max().y() << '\n';
+    }
+    if (!out.good()) {
+      throw WriteError("Failed to write tile manifest " + filename);
+    }
+  }
+
+  //! @throws FileNotFoundError if the file is missing, ParseError if it is not a tile manifest
+  static TileManifest load(const std::string& filename) {
+    std::ifstream in(filename);
+    if (!in.good()) {
+      throw FileNotFoundError("Could not open tile manifest " + filename);
+    }
+    std::string tag;
+    int version{};
+    TileManifest manifest;
+    if (!(in >> tag >> version) || tag != "lanelet2_tiles" || version != Version || !(in >> tag) ||
+        tag != "tile_size" || !(in >> manifest.tileSize_) || !(manifest.tileSize_ > 0.)) {
+      throw ParseError(filename + " is not a lanelet2 tile manifest of version " + std::to_string(Version));
+    }
+    while (in >> tag) {
+      TileKey key;
+      double minX{};
+      double minY{};
+      double maxX{};
+      double maxY{};
+      if (tag == "tile" && in >> key.x >> key.y >> minX >> minY >> maxX >> maxY) {
+        manifest.addTile(key, BoundingBox2d(BasicPoint2d(minX, minY), BasicPoint2d(maxX, maxY)));
+        continue;
+      }
+      Id id{};
+      if (tag == "lanelet" && in >> id >> key.x >> key.y >> minX >> minY >> maxX >> maxY) {
+        manifest.addLanelet(id, key, BoundingBox2d(BasicPoint2d(minX, minY), BasicPoint2d(maxX, maxY)));
+        continue;
+      }
+      throw ParseError("Invalid entry '" + tag + "' in tile manifest " + filename);
+    }
+    return manifest;
+  }
+
+ private:
+  static constexpr int Version = 1;
+  double tileSize_{500.};
+  std::map<TileKey, BoundingBox2d> tiles_;
+  std::unordered_map<Id, LaneletEntry> lanelets_;
+};
+
+/**
+ * @brief Cuts a map into square tiles of flat maps (see FlatHandler.h) and writes them together with a TileManifest.
+ *
+ * Lanelets, areas, line strings and polygons go to the tile containing the center of their bounding box, together
+ * with everything they reference (bounds, points, regulatory elements and their parameters). Points that are not part
+ * of any line string or polygon go to the tile containing them. Therefore primitives on tile borders are stored in
+ * every tile that needs them; TiledLaneletMap merges them into one object again when composing tiles.
+ *
+ * @param directory has to exist. Existing tiles in it are overwritten.
+ * @return the manifest that was written
+ */
+inline TileManifest cutIntoTiles(LaneletMap& map, const std::string& directory, double tileSize = 500.) {
+  TileManifest manifest(tileSize);
+  struct TileContent {
+    Lanelets lanelets;
+    Areas areas;
+    LineStrings3d lineStrings;
+    Polygons3d polygons;
+    Points3d points;
+  };
+  std::map<TileKey, TileContent> tiles;
+  auto keyOf = [&manifest](const BoundingBox2d& box) { return manifest.tileOf(box.center()); };
+  for (auto& llt : map.laneletLayer) {
+    const auto box = geometry::boundingBox2d(llt);
+    const auto key = keyOf(box);
+    tiles[key].lanelets.push_back(llt);
+    manifest.addLanelet(llt.id(), key, box);
+  }
+  for (auto& area : map.areaLayer) {
+    tiles[keyOf(geometry::boundingBox2d(area))].areas.push_back(area);
+  }
+  std::unordered_set<Id> usedPoints;
+  for (auto& ls : map.lineStringLayer) {
+    tiles[keyOf(geometry::boundingBox2d(utils::to2D(ls)))].lineStrings.push_back(ls);
+    for (const auto& p : ls) {
+      usedPoints.insert(p.id());
+    }
+  }
+  for (auto& poly : map.polygonLayer) {
+    tiles[keyOf(geometry::boundingBox2d(utils::to2D(poly)))].polygons.push_back(poly);
+    for (const auto& p : poly) {
+      usedPoints.insert(p.id());
+    }
+  }
+  for (auto& p : map.pointLayer) {
+    if (usedPoints.count(p.id()) == 0) {
+      tiles[manifest.tileOf(p.basicPoint2d())].points.push_back(p);
+    }
+  }
+  for (auto& tile : tiles) {
+    auto& content = tile.second;
+    auto tileMap = utils::createMap(content.lanelets, content.areas);
+    for (auto& ls : content.lineStrings) {
+      tileMap->add(ls);
+    }
+    for (auto& poly : content.polygons) {
+      tileMap->add(poly);
+    }
+    for (auto& p : content.points) {
+      tileMap->add(p);
+    }
+    BoundingBox2d extent;
+    for (const auto& p : tileMap->pointLayer) {
+      extent.extend(p.basicPoint2d());
+    }
+    io_handlers::flat::writeFlatMap(directory + "/" + TileManifest::tileFile(tile.first), *tileMap);
+    manifest.addTile(tile.first, extent);
+  }
+  manifest.save(directory + "/" + TileManifest::FileName);
+  return manifest;
+}
+
+/**
+ * @brief Map made of the tiles around the ego position and along the route, loaded and evicted in the background.
+ *
+ * update() only records which tiles are needed. A background thread memory maps the missing tiles, unmaps the ones
+ * that are no longer needed and then publishes a new LaneletMap composed of the current tiles (FlatMapComposer, so a
+ * primitive stored in several tiles is one object again). map() returns the latest snapshot; a snapshot handed out
+ * stays valid and unchanged while the next one is built. Memory and loading time depend on the size of the corridor,
+ * not of the map.
+ *
+ * The routing graph of a tiled map should not be built from a snapshot (routes would end at its border), use a
+ * routing::RoutingSkeleton of the whole map for the route and pass the lanelet ids of the result to update().
+ */
+class TiledLaneletMap {
+ public:
+  //! @throws FileNotFoundError, ParseError if the directory contains no valid manifest
+  explicit TiledLaneletMap(std::string directory)
+      : directory_{std::move(directory)},
+        manifest_{TileManifest::load(directory_ + "/" + TileManifest::FileName)},
+        map_{std::make_shared<LaneletMap>()},
+        worker_{[this] { run(); }} {}
+
+  TiledLaneletMap(const TiledLaneletMap&) = delete;
+  TiledLaneletMap& operator=(const TiledLaneletMap&) = delete;
+  TiledLaneletMap(TiledLaneletMap&&) = delete;
+  TiledLaneletMap& operator=(TiledLaneletMap&&) = delete;
+
+  ~TiledLaneletMap() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wakeup_.notify_all();
+    worker_.join();
+  }
+
+  /**
+   * @brief Requests the tiles within radius of the ego position and within corridor of the route lanelets.
+   *
+   * Returns immediately. Lanelets of the route that are not in the manifest are ignored. Only the part of the route
+   * ahead should be passed, otherwise the whole route stays loaded.
+   */
+  void update(const BasicPoint2d& ego, const Ids& route = {}, double radius = 300., double corridor = 50.) {
+    std::set<TileKey> wanted;
+    const BasicPoint2d reach(radius, radius);
+    for (const auto& key : manifest_.tilesIn(BoundingBox2d(ego - reach, ego + reach))) {
+      wanted.insert(key);
+    }
+    const BasicPoint2d margin(corridor, corridor);
+    for (const auto id : route) {
+      auto it = manifest_.lanelets().find(id);
+      if (it == manifest_.lanelets().end()) {
+        continue;
+      }
+      wanted.insert(it->second.tile);
+      const auto& box = it->second.box;
+      for (const auto& key : manifest_.tilesIn(BoundingBox2d(box.min() - margin, box.max() + margin))) {
+        wanted.insert(key);
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (wanted == wanted_) {
+        return;
+      }
+      wanted_ = std::move(wanted);
+      ++requested_;
+    }
+    wakeup_.notify_all();
+  }
+
+  //! the latest composed map. Never null, empty before the first update has been processed.
+  std::shared_ptr<const LaneletMap> map() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return map_;
+  }
+
+  //! tiles of the latest snapshot
+  std::vector<TileKey> loadedTiles() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return loadedTiles_;
+  }
+
+  /**
+   * @brief Blocks until the snapshot reflects the last update()
+   * @throws the error of the background thread if loading a tile failed since the last call
+   */
+  void waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return processed_ == requested_; });
+    if (error_) {
+      auto error = error_;
+      error_ = nullptr;
+      std::rethrow_exception(error);
+    }
+  }
+
+  const TileManifest& manifest() const noexcept { return manifest_; }
+
+ private:
+  void run() {
+    std::map<TileKey, io_handlers::flat::FlatMapView> views;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      wakeup_.wait(lock, [this] { return stop_ || processed_ != requested_; });
+      if (stop_) {
+        return;
+      }
+      const auto wanted = wanted_;
+      const auto request = requested_;
+      lock.unlock();
+      std::exception_ptr error;
+      std::shared_ptr<LaneletMap> composed;
+      std::vector<TileKey> loaded;
+      try {
+        for (auto it = views.begin(); it != views.end();) {
+          it = wanted.count(it->first) == 0 ? views.erase(it) : std::next(it);
+        }
+        for (const auto& key : wanted) {
+          if (views.count(key) == 0) {
+            views.emplace(key, io_handlers::flat::FlatMapView(directory_ + "/" + TileManifest::tileFile(key)));
+          }
+        }
+        io_handlers::flat::FlatMapComposer composer;
+        for (const auto& view : views) {
+          composer.add(view.second);
+          loaded.push_back(view.first);
+        }
+        composed = composer.finish();
+      } catch (...) {
+        error = std::current_exception();
+      }
+      lock.lock();
+      if (composed) {
+        map_ = std::move(composed);
+        loadedTiles_ = std::move(loaded);
+      }
+      if (error) {
+        error_ = error;
+      }
+      processed_ = request;
+      idle_.notify_all();
+    }
+  }
+
+  const std::string directory_;
+  const TileManifest manifest_;
+  mutable std::mutex mutex_;
+  std::condition_variable wakeup_;
+  std::condition_variable idle_;
+  std::set<TileKey> wanted_;
+  uint64_t requested_{0};
+  uint64_t processed_{0};
+  bool stop_{false};
+  std::exception_ptr error_;
+  std::shared_ptr<const LaneletMap> map_;
+  std::vector<TileKey> loadedTiles_;
+  std::thread worker_;  //!< last member, started after everything it uses is initialized
+};
+
+}  // namespace lanelet
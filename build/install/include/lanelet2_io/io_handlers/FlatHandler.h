@@ -0,0 +1,986 @@
+#pragma once
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <lanelet2_core/LaneletMap.h>
+#include <lanelet2_core/primitives/RegulatoryElement.h>
+#include <lanelet2_core/utility/PrimitiveArena.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "lanelet2_io/io_handlers/Parser.h"
+#include "lanelet2_io/io_handlers/Writer.h"
+
+namespace lanelet {
+namespace io_handlers {
+/**
+ * @brief Flat, versioned binary map format that can be memory mapped without parsing.
+ *
+ * All primitives are stored in contiguous arrays and reference each other by array index instead of by id. Point
+ * coordinates are kept as separate x/y/z arrays, attributes point into a shared string pool. The file also contains
+ * the bounding box of every lanelet and a uniform grid over these boxes, so spatial queries can be answered directly
+ * on the mapped file.
+ *
+ * The file is mapped read-only (MAP_SHARED), therefore several processes loading the same map share its pages through
+ * the page cache. The layout uses the native byte order and is only meant to be read on the architecture it was
+ * written on.
+ */
+namespace flat {
+constexpr char Magic[8] = {'L', 'L', '2', 'F', 'L', 'A', 'T', '\0'};
+constexpr uint32_t Version = 1;
+constexpr uint32_t NoIndex = 0xffffffffU;
+
+//! Half open range [begin, end) into another section
+struct Range {
+  uint32_t begin;
+  uint32_t end;
+  uint32_t size() const { return end - begin; }
+};
+
+//! Key and value are offsets into the string pool (null terminated)
+struct Attribute {
+  uint32_t key;
+  uint32_t value;
+};
+
+struct BoundRef {
+  uint32_t lineString;  //!< index into the linestring section
+  uint32_t inverted;
+};
+
+struct LineString {
+  int64_t id;
+  Range points;  //!< into PointRefs
+  Range attributes;
+};
+
+struct Lanelet {
+  int64_t id;
+  BoundRef left;
+  BoundRef right;
+  uint32_t inverted;
+  uint32_t reserved;
+  Range attributes;
+  Range regulatoryElements;  //!< into RegulatoryElementRefs
+};
+
+struct Area {
+  int64_t id;
+  Range outerBound;   //!< into BoundRefs
+  Range innerBounds;  //!< into InnerBounds, each entry is a range into BoundRefs
+  Range attributes;
+  Range regulatoryElements;  //!< into RegulatoryElementRefs
+};
+
+//! Same order as the alternatives of lanelet::RuleParameter
+enum class ParameterType : uint32_t { Point = 0, LineString = 1, Polygon = 2, Lanelet = 3, Area = 4 };
+
+struct Parameter {
+  uint32_t role;  //!< offset into the string pool
+  ParameterType type;
+  uint32_t index;  //!< index into the section of the given type
+  uint32_t inverted;
+};
+
+struct RegulatoryElement {
+  int64_t id;
+  Range parameters;
+  Range attributes;
+};
+
+struct Box {
+  double minX;
+  double minY;
+  double maxX;
+  double maxY;
+};
+
+struct Grid {
+  double originX;
+  double originY;
+  double cellSize;
+  uint32_t cellsX;
+  uint32_t cellsY;
+};
+
+enum Section : uint32_t {
+  PointIds = 0,            //!< int64_t
+  PointX,                  //!< double
+  PointY,                  //!< double
+  PointZ,                  //!< double
+  PointAttributes,         //!< Range, one per point
+  PointRefs,               //!< uint32_t
+  BoundRefs,               //!< BoundRef
+  InnerBounds,             //!< Range
+  LineStrings,             //!< LineString
+  Polygons,                //!< LineString
+  Lanelets,                //!< Lanelet
+  Areas,                   //!< Area
+  RegulatoryElementRefs,   //!< uint32_t
+  RegulatoryElements,      //!< RegulatoryElement
+  Parameters,              //!< Parameter
+  Attributes,              //!< Attribute
+  Strings,                 //!< char
+  LaneletBoxes,            //!< Box, one per lanelet
+  GridCells,               //!< Range into GridItems, one per cell (row major)
+  GridItems,               //!< uint32_t lanelet index
+  NumSections
+};
+
+struct SectionInfo {
+  uint64_t offset;  //!< from the start of the file, 8 byte aligned
+  uint64_t count;   //!< number of elements
+};
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t headerSize;
+  uint64_t fileSize;
+  Grid grid;
+  SectionInfo sections[NumSections];
+};
+
+namespace detail {
+inline size_t elementSize(Section section) {
+  switch (section) {
+    case PointIds:
+      return sizeof(int64_t);
+    case PointX:
+    case PointY:
+    case PointZ:
+      return sizeof(double);
+    case PointAttributes:
+    case InnerBounds:
+    case GridCells:
+      return sizeof(Range);
+    case PointRefs:
+    case RegulatoryElementRefs:
+    case GridItems:
+      return sizeof(uint32_t);
+    case BoundRefs:
+      return sizeof(BoundRef);
+    case LineStrings:
+    case Polygons:
+      return sizeof(LineString);
+    case Lanelets:
+      return sizeof(Lanelet);
+    case Areas:
+      return sizeof(Area);
+    case RegulatoryElements:
+      return sizeof(RegulatoryElement);
+    case Parameters:
+      return sizeof(Parameter);
+    case Attributes:
+      return sizeof(flat::Attribute);
+    case Strings:
+      return sizeof(char);
+    case LaneletBoxes:
+      return sizeof(Box);
+    default:
+      return 0;
+  }
+}
+
+//! Collects the sections in memory before they are written to disk
+class Builder {
+ public:
+  uint32_t addString(const std::string& str) {
+    auto it = stringOffsets_.find(str);
+    if (it != stringOffsets_.end()) {
+      return it->second;
+    }
+    auto offset = static_cast<uint32_t>(strings_.size());
+    strings_.insert(strings_.end(), str.begin(), str.end());
+    strings_.push_back('\0');
+    stringOffsets_.emplace(str, offset);
+    return offset;
+  }
+
+  Range addAttributes(const AttributeMap& attributes) {
+    Range range{static_cast<uint32_t>(attributes_.size()), 0};
+    for (const auto& attr : attributes) {
+      attributes_.push_back({addString(attr.first), addString(attr.second.value())});
+    }
+    range.end = static_cast<uint32_t>(attributes_.size());
+    return range;
+  }
+
+  template <typename T>
+  static void append(std::vector<char>& buffer, SectionInfo& info, const std::vector<T>& data) {
+    buffer.resize((buffer.size() + 7) & ~size_t(7), '\0');
+    info.offset = buffer.size();
+    info.count = data.size();
+    if (!data.empty()) {
+      const auto* begin = reinterpret_cast<const char*>(data.data());
+      buffer.insert(buffer.end(), begin, begin + data.size() * sizeof(T));
+    }
+  }
+
+  std::vector<int64_t> pointIds;
+  std::vector<double> pointX;
+  std::vector<double> pointY;
+  std::vector<double> pointZ;
+  std::vector<Range> pointAttributes;
+  std::vector<uint32_t> pointRefs;
+  std::vector<BoundRef> boundRefs;
+  std::vector<Range> innerBounds;
+  std::vector<LineString> lineStrings;
+  std::vector<LineString> polygons;
+  std::vector<Lanelet> lanelets;
+  std::vector<Area> areas;
+  std::vector<uint32_t> regulatoryElementRefs;
+  std::vector<RegulatoryElement> regulatoryElements;
+  std::vector<Parameter> parameters;
+  std::vector<flat::Attribute> attributes_;
+  std::vector<char> strings_;
+  std::vector<Box> laneletBoxes;
+  std::vector<Range> gridCells;
+  std::vector<uint32_t> gridItems;
+  Grid grid{0., 0., 1., 0, 0};
+
+ private:
+  std::unordered_map<std::string, uint32_t> stringOffsets_;
+};
+
+template <typename T>
+uint32_t indexOf(const std::unordered_map<Id, uint32_t>& indices, const T& primitive) {
+  auto it = indices.find(primitive.id());
+  if (it == indices.end()) {
+    throw WriteError("Primitive " + std::to_string(primitive.id()) + " is referenced but not part of the map");
+  }
+  return it->second;
+}
+}  // namespace detail
+
+/**
+ * @brief Serializes a map into the flat format.
+ * @param map map to serialize. It has to be self contained (as every LaneletMap is).
+ * @param gridCellSize edge length of the cells of the prebuilt lanelet grid index in map units
+ * @throws WriteError if the map references primitives that are not part of it
+ */
+inline std::vector<char> serializeFlatMap(const LaneletMap& map, double gridCellSize = 50.) {
+  detail::Builder b;
+  std::unordered_map<Id, uint32_t> pointIdx;
+  std::unordered_map<Id, uint32_t> lineStringIdx;
+  std::unordered_map<Id, uint32_t> polygonIdx;
+  std::unordered_map<Id, uint32_t> laneletIdx;
+  std::unordered_map<Id, uint32_t> areaIdx;
+  std::unordered_map<Id, uint32_t> regElemIdx;
+
+  for (const auto& point : map.pointLayer) {
+    pointIdx.emplace(point.id(), static_cast<uint32_t>(b.pointIds.size()));
+    b.pointIds.push_back(point.id());
+    b.pointX.push_back(point.x());
+    b.pointY.push_back(point.y());
+    b.pointZ.push_back(point.z());
+    b.pointAttributes.push_back(b.addAttributes(point.attributes()));
+  }
+
+  auto addLineString = [&](const auto& ls, std::vector<LineString>& target) {
+    Range points{static_cast<uint32_t>(b.pointRefs.size()), 0};
+    for (const auto& point : ls) {
+      b.pointRefs.push_back(detail::indexOf(pointIdx, point));
+    }
+    points.end = static_cast<uint32_t>(b.pointRefs.size());
+    target.push_back({ls.id(), points, b.addAttributes(ls.attributes())});
+  };
+  for (const auto& ls : map.lineStringLayer) {
+    lineStringIdx.emplace(ls.id(), static_cast<uint32_t>(b.lineStrings.size()));
+    // store the points in their stored order, inversion is a property of the reference
+    addLineString(ls.inverted() ? ls.invert() : ls, b.lineStrings);
+  }
+  for (const auto& poly : map.polygonLayer) {
+    polygonIdx.emplace(poly.id(), static_cast<uint32_t>(b.polygons.size()));
+    addLineString(poly, b.polygons);
+  }
+
+  // ids first, the regulatory element references are filled in once all regulatory elements are indexed
+  for (const auto& llt : map.laneletLayer) {
+    laneletIdx.emplace(llt.id(), static_cast<uint32_t>(laneletIdx.size()));
+  }
+  for (const auto& ar : map.areaLayer) {
+    areaIdx.emplace(ar.id(), static_cast<uint32_t>(areaIdx.size()));
+  }
+  for (const auto& regElem : map.regulatoryElementLayer) {
+    regElemIdx.emplace(regElem->id(), static_cast<uint32_t>(regElemIdx.size()));
+  }
+
+  auto boundRef = [&](const auto& ls) {
+    return BoundRef{detail::indexOf(lineStringIdx, ls), ls.inverted() ? 1U : 0U};
+  };
+  auto addRegElemRefs = [&](const auto& regElems) {
+    Range range{static_cast<uint32_t>(b.regulatoryElementRefs.size()), 0};
+    for (const auto& regElem : regElems) {
+      b.regulatoryElementRefs.push_back(detail::indexOf(regElemIdx, *regElem));
+    }
+    range.end = static_cast<uint32_t>(b.regulatoryElementRefs.size());
+    return range;
+  };
+
+  for (const auto& llt : map.laneletLayer) {
+    Lanelet flatLlt{};
+    flatLlt.id = llt.id();
+    // bounds are stored as seen from the non inverted lanelet
+    const auto base = llt.inverted() ? llt.invert() : llt;
+    flatLlt.left = boundRef(base.leftBound());
+    flatLlt.right = boundRef(base.rightBound());
+    flatLlt.inverted = llt.inverted() ? 1U : 0U;
+    flatLlt.attributes = b.addAttributes(llt.attributes());
+    flatLlt.regulatoryElements = addRegElemRefs(llt.regulatoryElements());
+    b.lanelets.push_back(flatLlt);
+
+    Box box{std::numeric_limits<double>::max(), std::numeric_limits<double>::max(),
+            std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest()};
+    auto extend = [&box](const auto& bound) {
+      for (const auto& p : bound) {
+        box.minX = std::min(box.minX, p.x());
+        box.minY = std::min(box.minY, p.y());
+        box.maxX = std::max(box.maxX, p.x());
+        box.maxY = std::max(box.maxY, p.y());
+      }
+    };
+    extend(base.leftBound());
+    extend(base.rightBound());
+    b.laneletBoxes.push_back(box);
+  }
+
+  for (const auto& ar : map.areaLayer) {
+    Area flatArea{};
+    flatArea.id = ar.id();
+    flatArea.outerBound.begin = static_cast<uint32_t>(b.boundRefs.size());
+    for (const auto& ls : ar.outerBound()) {
+      b.boundRefs.push_back(boundRef(ls));
+    }
+    flatArea.outerBound.end = static_cast<uint32_t>(b.boundRefs.size());
+    flatArea.innerBounds.begin = static_cast<uint32_t>(b.innerBounds.size());
+    for (const auto& inner : ar.innerBounds()) {
+      Range innerRange{static_cast<uint32_t>(b.boundRefs.size()), 0};
+      for (const auto& ls : inner) {
+        b.boundRefs.push_back(boundRef(ls));
+      }
+      innerRange.end = static_cast<uint32_t>(b.boundRefs.size());
+      b.innerBounds.push_back(innerRange);
+    }
+    flatArea.innerBounds.end = static_cast<uint32_t>(b.innerBounds.size());
+    flatArea.attributes = b.addAttributes(ar.attributes());
+    flatArea.regulatoryElements = addRegElemRefs(ar.regulatoryElements());
+    b.areas.push_back(flatArea);
+  }
+
+  for (const auto& regElem : map.regulatoryElementLayer) {
+    RegulatoryElement flatRegElem{};
+    flatRegElem.id = regElem->id();
+    flatRegElem.parameters.begin = static_cast<uint32_t>(b.parameters.size());
+    for (const auto& role : regElem->getParameters()) {
+      const auto roleOffset = b.addString(role.first);
+      for (const auto& param : role.second) {
+        Parameter flatParam{roleOffset, static_cast<ParameterType>(param.which()), NoIndex, 0};
+        switch (flatParam.type) {
+          case ParameterType::Point:
+            flatParam.index = detail::indexOf(pointIdx, boost::get<ConstPoint3d>(param));
+            break;
+          case ParameterType::LineString: {
+            const auto& ls = boost::get<ConstLineString3d>(param);
+            flatParam.index = detail::indexOf(lineStringIdx, ls);
+            flatParam.inverted = ls.inverted() ? 1U : 0U;
+            break;
+          }
+          case ParameterType::Polygon:
+            flatParam.index = detail::indexOf(polygonIdx, boost::get<ConstPolygon3d>(param));
+            break;
+          case ParameterType::Lanelet: {
+            const auto& weakLlt = boost::get<ConstWeakLanelet>(param);
+            if (weakLlt.expired()) {
+              continue;
+            }
+            const auto llt = weakLlt.lock();
+            flatParam.index = detail::indexOf(laneletIdx, llt);
+            flatParam.inverted = llt.inverted() ? 1U : 0U;
+            break;
+          }
+          case ParameterType::Area: {
+            const auto& weakArea = boost::get<ConstWeakArea>(param);
+            if (weakArea.expired()) {
+              continue;
+            }
+            flatParam.index = detail::indexOf(areaIdx, weakArea.lock());
+            break;
+          }
+        }
+        b.parameters.push_back(flatParam);
+      }
+    }
+    flatRegElem.parameters.end = static_cast<uint32_t>(b.parameters.size());
+    flatRegElem.attributes = b.addAttributes(regElem->attributes());
+    b.regulatoryElements.push_back(flatRegElem);
+  }
+
+  // uniform grid over the lanelet boxes. Every lanelet is listed in each cell its box overlaps.
+  if (!b.laneletBoxes.empty()) {
+    Box bounds = b.laneletBoxes.front();
+    for (const auto& box : b.laneletBoxes) {
+      bounds.minX = std::min(bounds.minX, box.minX);
+      bounds.minY = std::min(bounds.minY, box.minY);
+      bounds.maxX = std::max(bounds.maxX, box.maxX);
+      bounds.maxY = std::max(bounds.maxY, box.maxY);
+    }
+    b.grid.cellSize = gridCellSize > 0. ? gridCellSize : 50.;
+    b.grid.originX = bounds.minX;
+    b.grid.originY = bounds.minY;
+    b.grid.cellsX = static_cast<uint32_t>((bounds.maxX - bounds.minX) / b.grid.cellSize) + 1;
+    b.grid.cellsY = static_cast<uint32_t>((bounds.maxY - bounds.minY) / b.grid.cellSize) + 1;
+    std::vector<std::vector<uint32_t>> cells(size_t(b.grid.cellsX) * b.grid.cellsY);
+    for (uint32_t i = 0; i < b.laneletBoxes.size(); ++i) {
+      const auto& box = b.laneletBoxes[i];
+      const auto x0 = static_cast<uint32_t>((box.minX - b.grid.originX) / b.grid.cellSize);
+      const auto x1 = static_cast<uint32_t>((box.maxX - b.grid.originX) / b.grid.cellSize);
+      const auto y0 = static_cast<uint32_t>((box.minY - b.grid.originY) / b.grid.cellSize);
+      const auto y1 = static_cast<uint32_t>((box.maxY - b.grid.originY) / b.grid.cellSize);
+      for (auto y = y0; y <= y1; ++y) {
+        for (auto x = x0; x <= x1; ++x) {
+          cells[size_t(y) * b.grid.cellsX + x].push_back(i);
+        }
+      }
+    }
+    b.gridCells.reserve(cells.size());
+    for (const auto& cell : cells) {
+      Range range{static_cast<uint32_t>(b.gridItems.size()), 0};
+      b.gridItems.insert(b.gridItems.end(), cell.begin(), cell.end());
+      range.end = static_cast<uint32_t>(b.gridItems.size());
+      b.gridCells.push_back(range);
+    }
+  }
+
+  Header header{};
+  std::memcpy(header.magic, Magic, sizeof(Magic));
+  header.version = Version;
+  header.headerSize = sizeof(Header);
+  header.grid = b.grid;
+
+  std::vector<char> buffer(sizeof(Header), '\0');
+  using detail::Builder;
+  Builder::append(buffer, header.sections[PointIds], b.pointIds);
+  Builder::append(buffer, header.sections[PointX], b.pointX);
+  Builder::append(buffer, header.sections[PointY], b.pointY);
+  Builder::append(buffer, header.sections[PointZ], b.pointZ);
+  Builder::append(buffer, header.sections[PointAttributes], b.pointAttributes);
+  Builder::append(buffer, header.sections[PointRefs], b.pointRefs);
+  Builder::append(buffer, header.sections[BoundRefs], b.boundRefs);
+  Builder::append(buffer, header.sections[InnerBounds], b.innerBounds);
+  Builder::append(buffer, header.sections[LineStrings], b.lineStrings);
+  Builder::append(buffer, header.sections[Polygons], b.polygons);
+  Builder::append(buffer, header.sections[Lanelets], b.lanelets);
+  Builder::append(buffer, header.sections[Areas], b.areas);
+  Builder::append(buffer, header.sections[RegulatoryElementRefs], b.regulatoryElementRefs);
+  Builder::append(buffer, header.sections[RegulatoryElements], b.regulatoryElements);
+  Builder::append(buffer, header.sections[Parameters], b.parameters);
+  Builder::append(buffer, header.sections[Attributes], b.attributes_);
+  Builder::append(buffer, header.sections[Strings], b.strings_);
+  Builder::append(buffer, header.sections[LaneletBoxes], b.laneletBoxes);
+  Builder::append(buffer, header.sections[GridCells], b.gridCells);
+  Builder::append(buffer, header.sections[GridItems], b.gridItems);
+  buffer.resize((buffer.size() + 7) & ~size_t(7), '\0');
+  header.fileSize = buffer.size();
+  std::memcpy(buffer.data(), &header, sizeof(Header));
+  return buffer;
+}
+
+/**
+ * @brief Writes a map in the flat format.
+ * @throws WriteError if the file can not be written
+ */
+inline void writeFlatMap(const std::string& filename, const LaneletMap& map, double gridCellSize = 50.) {
+  const auto buffer = serializeFlatMap(map, gridCellSize);
+  std::ofstream fs(filename, std::ios::binary | std::ios::trunc);
+  if (!fs.good()) {
+    throw WriteError("Failed open archive " + filename);
+  }
+  fs.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+  if (!fs.good()) {
+    throw WriteError("Failed to write " + filename);
+  }
+}
+
+/**
+ * @brief Publishes a map in the flat format as POSIX shared memory object.
+ *
+ * Other processes attach to it read-only with FlatMapView::attach and share the same physical pages. The coordinates
+ * are already projected, so attaching processes neither parse nor project the map. The header is written last, so a
+ * process attaching during publishing gets a ParseError instead of a partial map.
+ * @param shmName name of the shared memory object, e.g. "/lanelet2_map"
+ * @throws WriteError if the object can not be created
+ */
+inline void publishFlatMap(const std::string& shmName, const LaneletMap& map, double gridCellSize = 50.) {
+  const auto buffer = serializeFlatMap(map, gridCellSize);
+  // a fresh object is created, processes attached to a previously published map keep the old one
+  ::shm_unlink(shmName.c_str());
+  const int fd = ::shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0) {
+    throw WriteError("Failed to create shared memory object " + shmName);
+  }
+  if (::ftruncate(fd, static_cast<off_t>(buffer.size())) != 0) {
+    ::close(fd);
+    throw WriteError("Failed to resize shared memory object " + shmName);
+  }
+  void* data = ::mmap(nullptr, buffer.size(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    throw WriteError("Failed to map shared memory object " + shmName);
+  }
+  auto* dst = static_cast<char*>(data);
+  std::memcpy(dst + sizeof(Header), buffer.data() + sizeof(Header), buffer.size() - sizeof(Header));
+  std::memcpy(dst, buffer.data(), sizeof(Header));
+  ::munmap(data, buffer.size());
+}
+
+//! Removes a map published with publishFlatMap. Processes that are attached keep their mapping.
+inline void unpublishFlatMap(const std::string& shmName) { ::shm_unlink(shmName.c_str()); }
+
+/**
+ * @brief Read-only view on a memory mapped flat map file.
+ *
+ * Opening (a file) or attaching (to a published shared memory object) only maps and validates the data, nothing is
+ * parsed. The arrays can be accessed directly, e.g. to look up
+ * lanelet candidates with searchLanelets() before (or instead of) building a LaneletMap with toLaneletMap().
+ */
+class FlatMapView {
+ public:
+  FlatMapView() = default;
+  explicit FlatMapView(const std::string& filename) { open(filename); }
+  FlatMapView(const FlatMapView&) = delete;
+  FlatMapView& operator=(const FlatMapView&) = delete;
+  FlatMapView(FlatMapView&& rhs) noexcept : data_{rhs.data_}, size_{rhs.size_} {
+    rhs.data_ = nullptr;
+    rhs.size_ = 0;
+  }
+  FlatMapView& operator=(FlatMapView&& rhs) noexcept {
+    if (this != &rhs) {
+      close();
+      std::swap(data_, rhs.data_);
+      std::swap(size_, rhs.size_);
+    }
+    return *this;
+  }
+  ~FlatMapView() { close(); }
+
+  //! @throws FileNotFoundError, ParseError if the file is not a valid flat map
+  void open(const std::string& filename) {
+    close();
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw FileNotFoundError("Could not open " + filename);
+    }
+    map(fd, filename);
+  }
+
+  //! Attaches read-only to a map published with publishFlatMap
+  //! @throws FileNotFoundError if nothing is published under this name, ParseError if it is not a valid flat map
+  void attach(const std::string& shmName) {
+    close();
+    const int fd = ::shm_open(shmName.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+      throw FileNotFoundError("No flat map published as " + shmName);
+    }
+    map(fd, shmName);
+  }
+
+  void close() noexcept {
+    if (data_ != nullptr) {
+      ::munmap(const_cast<char*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  bool isOpen() const noexcept { return data_ != nullptr; }
+
+  const Header& header() const { return *reinterpret_cast<const Header*>(data_); }
+
+  template <typename T>
+  const T* section(Section s) const {
+    return reinterpret_cast<const T*>(data_ + header().sections[s].offset);
+  }
+  size_t count(Section s) const { return header().sections[s].count; }
+
+  size_t numPoints() const { return count(PointIds); }
+  size_t numLanelets() const { return count(Lanelets); }
+  const double* pointX() const { return section<double>(PointX); }
+  const double* pointY() const { return section<double>(PointY); }
+  const double* pointZ() const { return section<double>(PointZ); }
+  const Lanelet& lanelet(size_t idx) const { return section<Lanelet>(Lanelets)[idx]; }
+  const Box& laneletBox(size_t idx) const { return section<Box>(LaneletBoxes)[idx]; }
+  const char* string(uint32_t offset) const { return section<char>(Strings) + offset; }
+
+  //! Indices of all lanelets whose bounding box intersects the given box, using the prebuilt grid
+  std::vector<uint32_t> searchLanelets(const Box& query) const {
+    std::vector<uint32_t> result;
+    const auto& grid = header().grid;
+    if (grid.cellsX == 0 || grid.cellsY == 0) {
+      return result;
+    }
+    auto cellIndex = [&grid](double v, double origin, uint32_t cells) {
+      const auto c = std::floor((v - origin) / grid.cellSize);
+      return static_cast<uint32_t>(std::min(std::max(c, 0.), double(cells - 1)));
+    };
+    const auto x0 = cellIndex(query.minX, grid.originX, grid.cellsX);
+    const auto x1 = cellIndex(query.maxX, grid.originX, grid.cellsX);
+    const auto y0 = cellIndex(query.minY, grid.originY, grid.cellsY);
+    const auto y1 = cellIndex(query.maxY, grid.originY, grid.cellsY);
+    const auto* cells = section<Range>(GridCells);
+    const auto* items = section<uint32_t>(GridItems);
+    for (auto y = y0; y <= y1; ++y) {
+      for (auto x = x0; x <= x1; ++x) {
+        const auto& cell = cells[size_t(y) * grid.cellsX + x];
+        for (auto i = cell.begin; i < cell.end; ++i) {
+          const auto& box = laneletBox(items[i]);
+          if (box.maxX >= query.minX && box.minX <= query.maxX && box.maxY >= query.minY && box.minY <= query.maxY) {
+            result.push_back(items[i]);
+          }
+        }
+      }
+    }
+    // a lanelet spanning several cells is found more than once
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+  }
+
+  /**
+   * @brief Builds a LaneletMap from the mapped data using the bulk constructor of the layers
+   * @param arena if set, the data of points, line strings, polygons, lanelets and areas is allocated from it, in this
+   * order. The arena is kept alive by the primitives, so the map may outlive the pointer passed here.
+   */
+  std::unique_ptr<LaneletMap> toLaneletMap(const PrimitiveArenaPtr& arena = nullptr) const;
+
+ private:
+  //! Maps everything behind fd read-only. Closes fd, the mapping stays valid.
+  void map(int fd, const std::string& filename) {
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+      ::close(fd);
+      throw ParseError(filename + " is not a flat lanelet2 map");
+    }
+    void* data = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+      throw ParseError("Could not map " + filename);
+    }
+    data_ = static_cast<const char*>(data);
+    size_ = static_cast<size_t>(st.st_size);
+    try {
+      validate(filename);
+    } catch (...) {
+      close();
+      throw;
+    }
+  }
+
+  void validate(const std::string& filename) const {
+    const auto& h = header();
+    if (std::memcmp(h.magic, Magic, sizeof(Magic)) != 0) {
+      throw ParseError(filename + " is not a flat lanelet2 map");
+    }
+    if (h.version != Version || h.headerSize != sizeof(Header)) {
+      throw ParseError(filename + " has an unsupported flat map version " + std::to_string(h.version));
+    }
+    if (h.fileSize != size_) {
+      throw ParseError(filename + " is truncated");
+    }
+    for (uint32_t s = 0; s < NumSections; ++s) {
+      const auto& info = h.sections[s];
+      const auto elemSize = detail::elementSize(static_cast<Section>(s));
+      if (info.offset % 8 != 0 || info.offset > size_ || info.count > (size_ - info.offset) / elemSize) {
+        throw ParseError(filename + " has a corrupt section " + std::to_string(s));
+      }
+    }
+    if (count(PointX) != numPoints() || count(PointY) != numPoints() || count(PointZ) != numPoints() ||
+        count(PointAttributes) != numPoints() || count(LaneletBoxes) != numLanelets() ||
+        count(GridCells) != size_t(h.grid.cellsX) * h.grid.cellsY) {
+      throw ParseError(filename + " has inconsistent section sizes");
+    }
+  }
+
+  const char* data_{nullptr};
+  size_t size_{0};
+};
+/**
+ * @brief Builds one LaneletMap out of several flat maps that may contain the same primitives, e.g. adjacent map tiles.
+ *
+ * Primitives are identified by id. The first flat map that contains a primitive creates it, later ones reuse the
+ * existing object, so a bound shared by lanelets of two tiles is one line string in the result (as it was in the map
+ * the tiles were cut from) and relations that compare primitives by identity (routing, geometry::follows) work across
+ * tile borders. Regulatory elements are attached to a lanelet or area only by the flat map that created it.
+ */
+class FlatMapComposer {
+ public:
+  //! @param arena if set, the data of the created primitives is allocated from it
+  explicit FlatMapComposer(PrimitiveArenaPtr arena = nullptr) : arena_{std::move(arena)} {}
+
+  void add(const FlatMapView& view) {
+    auto attributes = [&view](const Range& range) {
+      AttributeMap map;
+      const auto* attrs = view.section<flat::Attribute>(Attributes);
+      for (auto i = range.begin; i < range.end; ++i) {
+        map[view.string(attrs[i].key)] = view.string(attrs[i].value);
+      }
+      return map;
+    };
+
+    const auto nPoints = view.numPoints();
+    const auto* ids = view.section<int64_t>(PointIds);
+    const auto* pointAttrs = view.section<Range>(PointAttributes);
+    std::vector<Point3d> points;
+    points.reserve(nPoints);
+    pointMap_.reserve(pointMap_.size() + nPoints);
+    for (size_t i = 0; i < nPoints; ++i) {
+      auto it = pointMap_.find(ids[i]);
+      if (it == pointMap_.end()) {
+        it = pointMap_
+                 .emplace(ids[i], Point3d(makeSharedData<PointData>(
+                                      arena_, ids[i],
+                                      BasicPoint3d(view.pointX()[i], view.pointY()[i], view.pointZ()[i]),
+                                      attributes(pointAttrs[i]))))
+                 .first;
+      }
+      points.push_back(it->second);
+    }
+
+    const auto* pointRefs = view.section<uint32_t>(PointRefs);
+    auto makePoints = [&](const LineString& ls) {
+      Points3d lsPoints;
+      lsPoints.reserve(ls.points.size());
+      for (auto i = ls.points.begin; i < ls.points.end; ++i) {
+        lsPoints.push_back(points[pointRefs[i]]);
+      }
+      return lsPoints;
+    };
+    std::vector<LineString3d> lineStrings;
+    lineStrings.reserve(view.count(LineStrings));
+    for (size_t i = 0; i < view.count(LineStrings); ++i) {
+      const auto& ls = view.section<LineString>(LineStrings)[i];
+      auto it = lineStringMap_.find(ls.id);
+      if (it == lineStringMap_.end()) {
+        it = lineStringMap_
+                 .emplace(ls.id, LineString3d(makeSharedData<LineStringData>(arena_, ls.id, makePoints(ls),
+                                                                             attributes(ls.attributes)),
+                                              false))
+                 .first;
+      }
+      lineStrings.push_back(it->second);
+    }
+    std::vector<Polygon3d> polygons;
+    polygons.reserve(view.count(Polygons));
+    for (size_t i = 0; i < view.count(Polygons); ++i) {
+      const auto& poly = view.section<LineString>(Polygons)[i];
+      auto it = polygonMap_.find(poly.id);
+      if (it == polygonMap_.end()) {
+        it = polygonMap_
+                 .emplace(poly.id, Polygon3d(makeSharedData<LineStringData>(arena_, poly.id, makePoints(poly),
+                                                                            attributes(poly.attributes)),
+                                             false))
+                 .first;
+      }
+      polygons.push_back(it->second);
+    }
+
+    auto bound = [&lineStrings](const BoundRef& ref) {
+      return ref.inverted != 0U ? lineStrings[ref.lineString].invert() : lineStrings[ref.lineString];
+    };
+    // lanelets in the orientation of their data, created[i] if this view created lanelet i
+    std::vector<lanelet::Lanelet> lanelets;
+    std::vector<bool> createdLanelets(view.numLanelets(), false);
+    lanelets.reserve(view.numLanelets());
+    for (size_t i = 0; i < view.numLanelets(); ++i) {
+      const auto& llt = view.lanelet(i);
+      auto it = laneletMap_.find(llt.id);
+      if (it != laneletMap_.end()) {
+        lanelets.push_back(it->second.inverted() ? it->second.invert() : it->second);
+        continue;
+      }
+      lanelets.emplace_back(
+          makeSharedData<LaneletData>(arena_, llt.id, bound(llt.left), bound(llt.right), attributes(llt.attributes)),
+          false);
+      createdLanelets[i] = true;
+    }
+
+    const auto* boundRefs = view.section<BoundRef>(BoundRefs);
+    const auto* innerBounds = view.section<Range>(InnerBounds);
+    auto bounds = [&](const Range& range) {
+      LineStrings3d result;
+      result.reserve(range.size());
+      for (auto i = range.begin; i < range.end; ++i) {
+        result.push_back(bound(boundRefs[i]));
+      }
+      return result;
+    };
+    std::vector<lanelet::Area> areas;
+    std::vector<bool> createdAreas(view.count(Areas), false);
+    areas.reserve(view.count(Areas));
+    for (size_t i = 0; i < view.count(Areas); ++i) {
+      const auto& ar = view.section<Area>(Areas)[i];
+      auto it = areaMap_.find(ar.id);
+      if (it != areaMap_.end()) {
+        areas.push_back(it->second);
+        continue;
+      }
+      lanelet::InnerBounds inner;
+      for (auto j = ar.innerBounds.begin; j < ar.innerBounds.end; ++j) {
+        inner.push_back(bounds(innerBounds[j]));
+      }
+      areas.emplace_back(
+          makeSharedData<AreaData>(arena_, ar.id, bounds(ar.outerBound), std::move(inner), attributes(ar.attributes)));
+      createdAreas[i] = true;
+    }
+
+    // lanelets and areas exist now, so the weak references of the parameters can be created
+    const auto* params = view.section<Parameter>(Parameters);
+    std::vector<RegulatoryElementPtr> regElems;
+    regElems.reserve(view.count(RegulatoryElements));
+    for (size_t i = 0; i < view.count(RegulatoryElements); ++i) {
+      const auto& regElem = view.section<RegulatoryElement>(RegulatoryElements)[i];
+      auto existing = regElemMap_.find(regElem.id);
+      if (existing != regElemMap_.end()) {
+        regElems.push_back(existing->second);
+        continue;
+      }
+      RuleParameterMap ruleParams;
+      for (auto j = regElem.parameters.begin; j < regElem.parameters.end; ++j) {
+        const auto& p = params[j];
+        auto& role = ruleParams[view.string(p.role)];
+        switch (p.type) {
+          case ParameterType::Point:
+            role.emplace_back(points[p.index]);
+            break;
+          case ParameterType::LineString:
+            role.emplace_back(p.inverted != 0U ? lineStrings[p.index].invert() : lineStrings[p.index]);
+            break;
+          case ParameterType::Polygon:
+            role.emplace_back(polygons[p.index]);
+            break;
+          case ParameterType::Lanelet:
+            role.emplace_back(WeakLanelet(p.inverted != 0U ? lanelets[p.index].invert() : lanelets[p.index]));
+            break;
+          case ParameterType::Area:
+            role.emplace_back(WeakArea(areas[p.index]));
+            break;
+        }
+      }
+      auto attrs = attributes(regElem.attributes);
+      auto subtype = attrs.find(AttributeName::Subtype);
+      auto regElemPtr = subtype != attrs.end()
+                            ? RegulatoryElementFactory::create(subtype->second.value(), regElem.id, ruleParams, attrs)
+                            : std::make_shared<GenericRegulatoryElement>(regElem.id, ruleParams, attrs);
+      regElems.push_back(regElemPtr);
+      regElemMap_.emplace(regElem.id, regElemPtr);
+    }
+
+    const auto* regElemRefs = view.section<uint32_t>(RegulatoryElementRefs);
+    laneletMap_.reserve(laneletMap_.size() + lanelets.size());
+    for (size_t i = 0; i < lanelets.size(); ++i) {
+      if (!createdLanelets[i]) {
+        continue;
+      }
+      const auto& llt = view.lanelet(i);
+      for (auto j = llt.regulatoryElements.begin; j < llt.regulatoryElements.end; ++j) {
+        lanelets[i].addRegulatoryElement(regElems[regElemRefs[j]]);
+      }
+      laneletMap_.emplace(llt.id, llt.inverted != 0U ? lanelets[i].invert() : lanelets[i]);
+    }
+    for (size_t i = 0; i < areas.size(); ++i) {
+      if (!createdAreas[i]) {
+        continue;
+      }
+      const auto& ar = view.section<Area>(Areas)[i];
+      for (auto j = ar.regulatoryElements.begin; j < ar.regulatoryElements.end; ++j) {
+        areas[i].addRegulatoryElement(regElems[regElemRefs[j]]);
+      }
+      areaMap_.emplace(ar.id, areas[i]);
+    }
+  }
+
+  //! the map of everything added so far. The composer is empty afterwards.
+  std::unique_ptr<LaneletMap> finish() {
+    auto map = std::make_unique<LaneletMap>(laneletMap_, areaMap_, regElemMap_, polygonMap_, lineStringMap_, pointMap_);
+    laneletMap_.clear();
+    areaMap_.clear();
+    regElemMap_.clear();
+    polygonMap_.clear();
+    lineStringMap_.clear();
+    pointMap_.clear();
+    return map;
+  }
+
+ private:
+  PrimitiveArenaPtr arena_;
+  PointLayer::Map pointMap_;
+  LineStringLayer::Map lineStringMap_;
+  PolygonLayer::Map polygonMap_;
+  LaneletLayer::Map laneletMap_;
+  AreaLayer::Map areaMap_;
+  RegulatoryElementLayer::Map regElemMap_;
+};
+
+inline std::unique_ptr<LaneletMap> FlatMapView::toLaneletMap(const PrimitiveArenaPtr& arena) const {
+  if (arena) {
+    // the control block of allocate_shared holds the allocator next to the data
+    constexpr size_t Overhead = 2 * sizeof(void*) + sizeof(ArenaAllocator<char>) + alignof(std::max_align_t);
+    arena->reserve(numPoints() * (sizeof(PointData) + Overhead) +
+                   (count(LineStrings) + count(Polygons)) * (sizeof(LineStringData) + Overhead) +
+                   numLanelets() * (sizeof(LaneletData) + Overhead) + count(Areas) * (sizeof(AreaData) + Overhead));
+  }
+  FlatMapComposer composer(arena);
+  composer.add(*this);
+  return composer.finish();
+}
+}  // namespace flat
+
+/**
+ * @brief Writer class for flat, memory mappable binary files
+ */
+class FlatWriter : public Writer {
+ public:
+  using Writer::Writer;
+
+  void write(const std::string& filename, const LaneletMap& laneletMap, ErrorMessages& /*errors*/) const override {
+    flat::writeFlatMap(filename, laneletMap);
+  }
+
+  static constexpr const char* extension() { return ".flat"; }
+
+  static constexpr const char* name() { return "flat_handler"; }
+};
+
+/**
+ * @brief Parser for flat binary files. The file is mapped only while the map is built.
+ *
+ * The primitive data is allocated from one PrimitiveArena per map, which is released when the last primitive of the map
+ * is gone.
+ *
+ * Register it in exactly one translation unit with RegisterParser<FlatParser> (and RegisterWriter<FlatWriter>) to make
+ * lanelet::load/write pick it up by extension.
+ */
+class FlatParser : public Parser {
+ public:
+  using Parser::Parser;
+
+  std::unique_ptr<LaneletMap> parse(const std::string& filename, ErrorMessages& /*errors*/) const override {
+    return flat::FlatMapView(filename).toLaneletMap(std::make_shared<PrimitiveArena>());
+  }
+
+  static constexpr const char* extension() { return ".flat"; }
+
+  static constexpr const char* name() { return "flat_handler"; }
+};
+}  // namespace io_handlers
+}  // namespace lanelet
@@ -0,0 +1,269 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lanelet2_io/io_handlers/OsmFile.h"
+#include "lanelet2_io/io_handlers/OsmHandler.h"
+
+namespace lanelet {
+namespace osm {
+//! Wall time spent in the individual phases of loading an osm file, in milliseconds
+struct LoadTimings {
+  double xml{0.};      //!< pugixml document parse
+  double count{0.};    //!< collecting and counting the node, way and relation elements
+  double build{0.};    //!< creating nodes, ways and relations (parallel)
+  double resolve{0.};  //!< resolving way nodes and relation members (parallel)
+  double convert{0.};  //!< osm::File to LaneletMap
+  size_t nodes{0};
+  size_t ways{0};
+  size_t relations{0};
+  double total() const { return xml + count + build + resolve + convert; }
+};
+
+inline std::ostream& operator<<(std::ostream& stream, const LoadTimings& t) {
+  return stream << "osm load: " << t.total() << " ms (xml " << t.xml << ", count " << t.count << ", build " << t.build
+                << ", resolve " << t.resolve << ", convert " << t.convert << ") for " << t.nodes << " nodes, " << t.ways
+                << " ways, " << t.relations << " relations";
+}
+
+namespace parallel {
+namespace detail {
+using Clock = std::chrono::steady_clock;
+
+inline double msSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+inline bool isDeleted(const pugi::xml_node& node) {
+  auto action = node.attribute("action");
+  return action && std::strcmp(action.value(), "delete") == 0;
+}
+
+//! Same as the sequential reader: the elevation tag is stored in the GPSPoint, not in the attributes
+inline Attributes tags(const pugi::xml_node& node) {
+  Attributes attributes;
+  for (auto tag = node.child("tag"); tag; tag = tag.next_sibling("tag")) {
+    const char* key = tag.attribute("k").value();
+    if (std::strcmp(key, "ele") == 0) {
+      continue;
+    }
+    attributes.emplace_hint(attributes.end(), key, tag.attribute("v").value());
+  }
+  return attributes;
+}
+
+inline std::vector<pugi::xml_node> collect(const pugi::xml_node& osmNode, const char* name) {
+  size_t n = 0;
+  for (auto node = osmNode.child(name); node; node = node.next_sibling(name)) {
+    ++n;
+  }
+  std::vector<pugi::xml_node> result;
+  result.reserve(n);
+  for (auto node = osmNode.child(name); node; node = node.next_sibling(name)) {
+    if (!isDeleted(node)) {
+      result.push_back(node);
+    }
+  }
+  return result;
+}
+
+//! Runs f(begin, end) on contiguous chunks of [0, n) and returns the per chunk results in order
+template <typename Func>
+auto forChunks(size_t n, size_t numThreads, Func&& f) {
+  using Result = decltype(f(size_t(), size_t()));
+  const auto chunks = std::max<size_t>(1, std::min(numThreads, n / 1000 + 1));
+  std::vector<std::future<Result>> futures;
+  futures.reserve(chunks);
+  for (size_t c = 0; c < chunks; ++c) {
+    futures.push_back(std::async(std::launch::async, f, n * c / chunks, n * (c + 1) / chunks));
+  }
+  std::vector<Result> results;
+  results.reserve(chunks);
+  for (auto& future : futures) {
+    results.push_back(future.get());
+  }
+  return results;
+}
+
+//! Ids of the members, resolved to pointers once all primitives exist
+struct MemberRef {
+  std::string role;
+  std::string type;
+  Id ref;
+};
+}  // namespace detail
+
+/**
+ * @brief Parallel variant of osm::read.
+ *
+ * The element handles of each section are collected and counted first. Then nodes, ways and relations are created
+ * concurrently (the node section additionally in chunks), and in a second phase way nodes and relation members are
+ * resolved concurrently while the maps are no longer modified. The resulting File is identical to osm::read.
+ */
+inline File read(pugi::xml_document& doc, Errors* errors = nullptr, LoadTimings* timings = nullptr,
+                 size_t numThreads = std::max(1U, std::thread::hardware_concurrency())) {
+  using detail::Clock;
+  auto start = Clock::now();
+  File file;
+  auto osmNode = doc.child("osm");
+  const auto nodeElems = detail::collect(osmNode, "node");
+  const auto wayElems = detail::collect(osmNode, "way");
+  const auto relationElems = detail::collect(osmNode, "relation");
+  if (timings != nullptr) {
+    timings->count = detail::msSince(start);
+    timings->nodes = nodeElems.size();
+    timings->ways = wayElems.size();
+    timings->relations = relationElems.size();
+  }
+
+  // phase 1: create all primitives, references are only stored as ids
+  start = Clock::now();
+  std::vector<std::vector<Id>> wayNodeIds(wayElems.size());
+  std::vector<std::vector<detail::MemberRef>> relationMembers(relationElems.size());
+  auto waysFuture = std::async(std::launch::async, [&] {
+    for (size_t i = 0; i < wayElems.size(); ++i) {
+      const auto& elem = wayElems[i];
+      const auto id = elem.attribute("id").as_llong(InvalId);
+      auto& ids = wayNodeIds[i];
+      for (auto nd = elem.child("nd"); nd; nd = nd.next_sibling("nd")) {
+        ids.push_back(nd.attribute("ref").as_llong());
+      }
+      file.ways.emplace_hint(file.ways.end(), id, Way{id, detail::tags(elem), {}});
+    }
+  });
+  auto relationsFuture = std::async(std::launch::async, [&] {
+    for (size_t i = 0; i < relationElems.size(); ++i) {
+      const auto& elem = relationElems[i];
+      const auto id = elem.attribute("id").as_llong(InvalId);
+      auto& members = relationMembers[i];
+      for (auto member = elem.child("member"); member; member = member.next_sibling("member")) {
+        members.push_back(
+            {member.attribute("role").value(), member.attribute("type").value(), member.attribute("ref").as_llong()});
+      }
+      file.relations.emplace_hint(file.relations.end(), id, Relation{id, detail::tags(elem)});
+    }
+  });
+  auto nodeChunks = detail::forChunks(nodeElems.size(), numThreads, [&nodeElems](size_t begin, size_t end) {
+    std::vector<Node> nodes;
+    nodes.reserve(end - begin);
+    for (auto i = begin; i < end; ++i) {
+      const auto& elem = nodeElems[i];
+      const auto ele = elem.find_child_by_attribute("tag", "k", "ele").attribute("v").as_double(0.);
+      nodes.emplace_back(elem.attribute("id").as_llong(InvalId), detail::tags(elem),
+                         GPSPoint{elem.attribute("lat").as_double(0.), elem.attribute("lon").as_double(0.), ele});
+    }
+    return nodes;
+  });
+  for (auto& chunk : nodeChunks) {
+    for (auto& node : chunk) {
+      const auto id = node.id;
+      file.nodes.emplace_hint(file.nodes.end(), id, std::move(node));
+    }
+  }
+  waysFuture.get();
+  relationsFuture.get();
+  if (timings != nullptr) {
+    timings->build = detail::msSince(start);
+  }
+
+  // phase 2: resolve references. The maps are complete, so lookups can run concurrently.
+  start = Clock::now();
+  Errors wayErrors;
+  Errors relationErrors;
+  auto resolveWays = std::async(std::launch::async, [&] {
+    size_t i = 0;
+    for (const auto& elem : wayElems) {
+      auto& way = file.ways.at(elem.attribute("id").as_llong(InvalId));
+      way.nodes.reserve(wayNodeIds[i].size());
+      for (const auto ref : wayNodeIds[i]) {
+        auto node = file.nodes.find(ref);
+        if (node == file.nodes.end()) {
+          wayErrors.push_back("Way " + std::to_string(way.id) + " references non-existing point " +
+                              std::to_string(ref));
+          continue;
+        }
+        way.nodes.push_back(&node->second);
+      }
+      ++i;
+    }
+  });
+  size_t i = 0;
+  for (const auto& elem : relationElems) {
+    auto& relation = file.relations.at(elem.attribute("id").as_llong(InvalId));
+    for (const auto& member : relationMembers[i]) {
+      Primitive* primitive = nullptr;
+      if (member.type == "node") {
+        auto it = file.nodes.find(member.ref);
+        primitive = it != file.nodes.end() ? &it->second : nullptr;
+      } else if (member.type == "way") {
+        auto it = file.ways.find(member.ref);
+        primitive = it != file.ways.end() ? &it->second : nullptr;
+      } else if (member.type == "relation") {
+        auto it = file.relations.find(member.ref);
+        primitive = it != file.relations.end() ? &it->second : nullptr;
+      }
+      if (primitive == nullptr) {
+        relationErrors.push_back("Relation " + std::to_string(relation.id) + " references non-existing " +
+                                 member.type + " " + std::to_string(member.ref));
+        continue;
+      }
+      relation.members.emplace_back(member.role, primitive);
+    }
+    ++i;
+  }
+  resolveWays.get();
+  if (timings != nullptr) {
+    timings->resolve = detail::msSince(start);
+  }
+  if (errors != nullptr) {
+    errors->insert(errors->end(), wayErrors.begin(), wayErrors.end());
+    errors->insert(errors->end(), relationErrors.begin(), relationErrors.end());
+  }
+  return file;
+}
+}  // namespace parallel
+}  // namespace osm
+
+namespace io_handlers {
+/**
+ * @brief Osm parser that reads the osm file with osm::parallel::read and prints a load time breakdown.
+ *
+ * The conversion to a LaneletMap is the one of OsmParser. Not registered by default because it shares the extension
+ * with OsmParser; load it by name after registering it with RegisterParser<OsmParallelParser>.
+ */
+class OsmParallelParser : public OsmParser {
+ public:
+  using OsmParser::OsmParser;
+
+  std::unique_ptr<LaneletMap> parse(const std::string& filename, ErrorMessages& errors) const override {
+    using Clock = std::chrono::steady_clock;
+    osm::LoadTimings timings;
+    auto start = Clock::now();
+    pugi::xml_document doc;
+    auto result = doc.load_file(filename.c_str());
+    if (!result) {
+      throw lanelet::ParseError(std::string("Errors occured while parsing osm file: ") + result.description());
+    }
+    timings.xml = osm::parallel::detail::msSince(start);
+
+    osm::Errors osmReadErrors;
+    auto file = osm::parallel::read(doc, &osmReadErrors, &timings);
+
+    start = Clock::now();
+    auto map = fromOsmFile(file, errors);
+    timings.convert = osm::parallel::detail::msSince(start);
+    errors.insert(errors.begin(), osmReadErrors.begin(), osmReadErrors.end());
+    std::cout << timings << std::endl;
+    return map;
+  }
+
+  static constexpr const char* name() { return "osm_parallel_handler"; }
+};
+}  // namespace io_handlers
+}  // namespace lanelet
@@ -8,6 +8,7 @@ class CpmProjector : public Projector {
  public:
   explicit CpmProjector(Origin origin);
 
+  using Projector::forward;
   BasicPoint3d forward(const GPSPoint& gps) const override;
 
   GPSPoint reverse(const BasicPoint3d& utm) const override;
@@ -11,6 +11,7 @@ class Mercator : public Projector {
   explicit Mercator(const Origin& origin = Origin::defaultOrigin())
       : Projector(origin), offset_{rawForward(origin.position)} {}
 
+  using Projector::forward;
   BasicPoint3d forward(const GPSPoint& pGps) const override { return rawForward(pGps) - offset_; }
   GPSPoint reverse(const BasicPoint3d& p) const override { return rawReverse(p + offset_); }
 
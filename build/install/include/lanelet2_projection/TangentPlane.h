@@ -0,0 +1,108 @@
+#pragma once
+#include <lanelet2_io/Projection.h>
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+
+namespace lanelet {
+namespace projection {
+
+/**
+ * @brief Second order Taylor approximation of another projector around a center, for frequent conversions near it.
+ *
+ * forward is a handful of multiplications instead of a call into GeographicLib. The coefficients are taken from the
+ * exact projector by finite differences on construction, so the result lives in the same local frame (UTM tile
+ * and offset, CPM, ...) as the map, only the error grows with the distance d to the center (third order, about
+ * d^3 / R^2 with R the earth radius: well below a millimeter within 2 km). maxError() is the largest deviation from the
+ * exact projector measured on construction at points up to radius() around the center. Points farther away are
+ * projected as well, but without that bound. reverse solves the quadratic model with a few Newton steps. The elevation
+ * is passed through, as by the lanelet2 projectors.
+ */
+class TangentPlaneProjector : public Projector {
+ public:
+  /**
+   * @param exact the projector to approximate. Only used during construction.
+   * @param center point to expand around, the origin of exact if default
+   * @param radius radius in meters of the area in which maxError() is measured
+   */
+  explicit TangentPlaneProjector(const Projector& exact, Origin center = Origin::defaultOrigin(),
+                                 double radius = 2000.)
+      : Projector(exact.origin()), radius_{radius} {
+    center_ = center.isDefault ? exact.origin().position : center.position;
+    center_.ele = 0.;
+    const auto f = [&](double dLat, double dLon) -> Eigen::Vector2d {
+      const auto p = exact.forward(GPSPoint{center_.lat + dLat, center_.lon + dLon, 0.});
+      return {p.x(), p.y()};
+    };
+    const double h = StepDeg;
+    value_ = f(0., 0.);
+    const Eigen::Vector2d pLat = f(h, 0.);
+    const Eigen::Vector2d mLat = f(-h, 0.);
+    const Eigen::Vector2d pLon = f(0., h);
+    const Eigen::Vector2d mLon = f(0., -h);
+    jacobian_.col(0) = (pLat - mLat) / (2 * h);
+    jacobian_.col(1) = (pLon - mLon) / (2 * h);
+    const Eigen::Vector2d dLatLat = (pLat - 2 * value_ + mLat) / (h * h);
+    const Eigen::Vector2d dLonLon = (pLon - 2 * value_ + mLon) / (h * h);
+    const Eigen::Vector2d dLatLon = (f(h, h) - f(h, -h) - f(-h, h) + f(-h, -h)) / (4 * h * h);
+    for (int i = 0; i < 2; ++i) {
+      hessian_[i] << dLatLat[i], dLatLon[i], dLatLon[i], dLonLon[i];
+    }
+    jacobianInverse_ = jacobian_.inverse();
+
+    // measure the error on rings around the center
+    const double metersPerDeg = std::max(jacobian_.col(0).norm(), jacobian_.col(1).norm());
+    for (const double fraction : {0.25, 0.5, 1.}) {
+      for (int k = 0; k < 16; ++k) {
+        const double angle = k * M_PI / 8;
+        const double dLat = fraction * radius_ / metersPerDeg * std::cos(angle);
+        const double dLon = fraction * radius_ / metersPerDeg * std::sin(angle);
+        const Eigen::Vector2d diff = model(Eigen::Vector2d(dLat, dLon)) - f(dLat, dLon);
+        maxError_ = std::max(maxError_, diff.norm());
+      }
+    }
+  }
+
+  using Projector::forward;
+  BasicPoint3d forward(const GPSPoint& gps) const override {
+    const Eigen::Vector2d p = model(Eigen::Vector2d(gps.lat - center_.lat, gps.lon - center_.lon));
+    return {p.x(), p.y(), gps.ele};
+  }
+
+  GPSPoint reverse(const BasicPoint3d& local) const override {
+    const Eigen::Vector2d target(local.x(), local.y());
+    Eigen::Vector2d d = jacobianInverse_ * (target - value_);
+    for (int i = 0; i < NewtonSteps; ++i) {
+      Eigen::Matrix2d jacobian;
+      jacobian.row(0) = jacobian_.row(0) + (hessian_[0] * d).transpose();
+      jacobian.row(1) = jacobian_.row(1) + (hessian_[1] * d).transpose();
+      d -= jacobian.inverse() * (model(d) - target);
+    }
+    return {center_.lat + d.x(), center_.lon + d.y(), local.z()};
+  }
+
+  //! largest deviation from the exact projector within radius() of the center, in meters
+  double maxError() const noexcept { return maxError_; }
+  double radius() const noexcept { return radius_; }
+  const GPSPoint& center() const noexcept { return center_; }
+
+ private:
+  static constexpr double StepDeg = 1e-3;  //!< finite difference step, about 100 m
+  static constexpr int NewtonSteps = 3;
+
+  Eigen::Vector2d model(const Eigen::Vector2d& d) const {
+    return value_ + jacobian_ * d + 0.5 * Eigen::Vector2d(d.dot(hessian_[0] * d), d.dot(hessian_[1] * d));
+  }
+
+  GPSPoint center_;
+  double radius_;
+  double maxError_{0.};
+  Eigen::Vector2d value_;
+  Eigen::Matrix2d jacobian_;  //!< columns: d/dlat, d/dlon in meters per degree
+  Eigen::Matrix2d jacobianInverse_;
+  Eigen::Matrix2d hessian_[2];  //!< of x and y
+};
+
+}  // namespace projection
+}  // namespace lanelet
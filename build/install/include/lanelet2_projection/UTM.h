@@ -8,6 +8,7 @@ class UtmProjector : public Projector {
  public:
   explicit UtmProjector(Origin origin, bool useOffset = true, bool throwInPaddingArea = false);
 
+  using Projector::forward;
   BasicPoint3d forward(const GPSPoint& gps) const override;
 
   GPSPoint reverse(const BasicPoint3d& utm) const override;
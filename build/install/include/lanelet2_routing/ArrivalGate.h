@@ -0,0 +1,101 @@
+#pragma once
+#include <lanelet2_core/geometry/Lanelet.h>
+#include <lanelet2_core/geometry/LineString.h>
+
+#include <cmath>
+#include <limits>
+
+namespace lanelet {
+namespace routing {
+
+//! Tolerances of ArrivalGate
+struct ArrivalParameters {
+  double distance{1.};     //!< maximum 2d distance to the goal position [m]
+  double angle{0.785398};  //!< maximum heading difference to the goal [rad]
+  double speed{0.01};      //!< maximum absolute speed [m/s]
+};
+
+/**
+ * @brief Goal arrival check that is prepared once per goal, so that the per cycle check is almost free.
+ *
+ * When the goal is set, the goal lanelet, the arc length of the goal on its centerline and an axis aligned gate around
+ * the goal (the box of the arrival distance) are stored. arrived() first compares the ego position with the gate, four
+ * float compares that reject the vehicle on all cycles but the last few of a route. Only inside the gate the distance,
+ * heading and speed conditions are evaluated.
+ */
+class ArrivalGate {
+ public:
+  using Parameters = ArrivalParameters;
+
+  ArrivalGate() = default;
+  ArrivalGate(const ConstLanelet& goalLanelet, const BasicPoint2d& goal, double goalYaw,
+              const Parameters& params = {}) {
+    setGoal(goalLanelet, goal, goalYaw, params);
+  }
+
+  void setGoal(const ConstLanelet& goalLanelet, const BasicPoint2d& goal, double goalYaw,
+               const Parameters& params = {}) {
+    goalLanelet_ = goalLanelet;
+    centerline_ = goalLanelet.centerline2d();
+    goal_ = goal;
+    goalYaw_ = goalYaw;
+    params_ = params;
+    goalArcLength_ = geometry::toArcCoordinates(centerline_, goal).length;
+    minX_ = goal.x() - params.distance;
+    maxX_ = goal.x() + params.distance;
+    minY_ = goal.y() - params.distance;
+    maxY_ = goal.y() + params.distance;
+  }
+
+  //! removes the goal, arrived() is false afterwards
+  void reset() {
+    goalLanelet_.reset();
+    minX_ = maxX_ = minY_ = maxY_ = std::numeric_limits<double>::quiet_NaN();
+  }
+
+  bool hasGoal() const noexcept { return !!goalLanelet_; }
+  const Optional<ConstLanelet>& goalLanelet() const noexcept { return goalLanelet_; }
+  //! arc length of the goal position along the centerline of the goal lanelet
+  double goalArcLength() const noexcept { return goalArcLength_; }
+  const Parameters& parameters() const noexcept { return params_; }
+
+  //! whether the position is inside the gate around the goal, false without a goal
+  bool inGate(const BasicPoint2d& ego) const noexcept {
+    return ego.x() >= minX_ && ego.x() <= maxX_ && ego.y() >= minY_ && ego.y() <= maxY_;
+  }
+
+  //! true if the vehicle is close to the goal, heading like the goal pose and (almost) stopped
+  bool arrived(const BasicPoint2d& ego, double egoYaw, double speed) const {
+    if (!inGate(ego)) {
+      return false;
+    }
+    if ((ego - goal_).squaredNorm() > params_.distance * params_.distance) {
+      return false;
+    }
+    if (std::abs(std::remainder(egoYaw - goalYaw_, 2. * M_PI)) > params_.angle) {
+      return false;
+    }
+    return std::abs(speed) <= params_.speed;
+  }
+
+  //! arc length from the position to the goal along the centerline of the goal lanelet (negative once passed)
+  double remainingArcLength(const BasicPoint2d& ego) const {
+    return goalArcLength_ - geometry::toArcCoordinates(centerline_, ego).length;
+  }
+
+ private:
+  Optional<ConstLanelet> goalLanelet_;
+  ConstLineString2d centerline_;
+  BasicPoint2d goal_{BasicPoint2d::Zero()};
+  double goalYaw_{0.};
+  double goalArcLength_{0.};
+  Parameters params_;
+  // NaN without a goal, every comparison with it fails
+  double minX_{std::numeric_limits<double>::quiet_NaN()};
+  double maxX_{std::numeric_limits<double>::quiet_NaN()};
+  double minY_{std::numeric_limits<double>::quiet_NaN()};
+  double maxY_{std::numeric_limits<double>::quiet_NaN()};
+};
+
+}  // namespace routing
+}  // namespace lanelet
@@ -0,0 +1,895 @@
+#pragma once
+#include <lanelet2_core/geometry/BoundingBox.h>
+#include <lanelet2_core/geometry/Lanelet.h>
+#include <lanelet2_core/primitives/LaneletRef.h>
+#include <lanelet2_traffic_rules/TrafficRules.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <limits>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "lanelet2_routing/Exceptions.h"
+#include "lanelet2_routing/LaneletPath.h"
+#include "lanelet2_routing/RoutingCost.h"
+#include "lanelet2_routing/RoutingGraph.h"
+
+namespace lanelet {
+namespace routing {
+
+/**
+ * @brief Dense search state for the queries of FrozenRoutingGraph.
+ *
+ * The vectors (and the storage of the priority queue) are sized once for the graph and reused. Instead of clearing
+ * them for every query, each entry is stamped with the query number, so starting a new search is O(1). Keep one state
+ * per thread.
+ */
+class RoutingSearchState {
+ public:
+  using QueueEntry = std::pair<double, uint32_t>;  //!< priority, vertex
+
+  void reset(size_t numVertices) {
+    if (stamp_.size() != numVertices) {
+      stamp_.assign(numVertices, 0);
+      cost_.resize(numVertices);
+      predecessor_.resize(numVertices);
+      closed_.resize(numVertices);
+      query_ = 0;
+    }
+    if (++query_ == 0) {  // wrapped around, the old stamps are ambiguous now
+      std::fill(stamp_.begin(), stamp_.end(), 0);
+      query_ = 1;
+    }
+  }
+
+  bool visited(uint32_t v) const { return stamp_[v] == query_; }
+  double cost(uint32_t v) const { return visited(v) ? cost_[v] : std::numeric_limits<double>::infinity(); }
+  uint32_t predecessor(uint32_t v) const { return predecessor_[v]; }
+  bool closed(uint32_t v) const { return visited(v) && closed_[v]; }
+
+  void open(uint32_t v, double cost, uint32_t predecessor) {
+    stamp_[v] = query_;
+    cost_[v] = cost;
+    predecessor_[v] = predecessor;
+    closed_[v] = false;
+  }
+  void close(uint32_t v) { closed_[v] = true; }
+
+  //! min priority queue on a reused vector
+  void push(double priority, uint32_t v) {
+    queue_.emplace_back(priority, v);
+    std::push_heap(queue_.begin(), queue_.end(), std::greater<>());
+  }
+  const QueueEntry& top() const { return queue_.front(); }
+  void pop() {
+    std::pop_heap(queue_.begin(), queue_.end(), std::greater<>());
+    queue_.pop_back();
+  }
+  bool queueEmpty() const noexcept { return queue_.empty(); }
+  void clearQueue() noexcept { queue_.clear(); }
+
+ private:
+  std::vector<QueueEntry> queue_;
+  std::vector<uint32_t> stamp_;
+  std::vector<double> cost_;
+  std::vector<uint32_t> predecessor_;
+  std::vector<char> closed_;
+  uint32_t query_{0};
+};
+
+//! Paths stored as vertex ids in one array; path i is [offsets[i], offsets[i + 1]) of vertices
+struct PathArena {
+  std::vector<uint32_t> vertices;
+  std::vector<uint32_t> offsets{0};
+
+  size_t size() const noexcept { return offsets.size() - 1; }
+  bool empty() const noexcept { return size() == 0; }
+  const uint32_t* begin(size_t i) const { return vertices.data() + offsets[i]; }
+  const uint32_t* end(size_t i) const { return vertices.data() + offsets[i + 1]; }
+  void clear() {
+    vertices.clear();
+    offsets.resize(1);
+  }
+};
+
+/**
+ * @brief Caller owned workspace for FrozenRoutingGraph::reachableSet and possiblePaths.
+ *
+ * Holds the search state, the result buffers and the parameters of the last query, which reachableSet uses to resume
+ * the last search instead of starting over. Reuse one workspace per thread (or per query type) across cycles.
+ */
+class RoutingWorkspace {
+ public:
+  ConstLanelets reachable;  //!< result of reachableSet
+  PathArena paths;          //!< result of possiblePaths
+
+  //! forces the next query to start from scratch
+  void invalidate() noexcept { last_ = {}; }
+
+ private:
+  friend class FrozenRoutingGraph;
+  struct Query {
+    uint32_t start{std::numeric_limits<uint32_t>::max()};
+    RoutingCostId costId{};
+    bool laneChanges{false};
+    double budget{-1.};
+  };
+  RoutingSearchState state_;  //!< not shared with other queries, reachableSet may resume it
+  Query last_;
+  std::vector<uint32_t> order_;  //!< expanded vertices of possiblePaths
+  std::vector<char> isParent_;
+};
+
+/**
+ * @brief Immutable compressed sparse row copy of the routable edges of a RoutingGraph.
+ *
+ * For every routing cost id, the outgoing successor and lane change edges of a vertex are stored contiguously (targets,
+ * costs and relation in separate arrays). shortestPath runs A* on it with a dense, reusable search state instead of
+ * the filtered boost graph views and map based vertex state of RoutingGraph::shortestPath.
+ *
+ * The heuristic is the euclidean distance between the centers of the lanelet bounding boxes, scaled per routing cost
+ * id by the smallest ratio of edge cost to center distance in the graph. This makes it consistent for any routing cost
+ * module, so the returned paths are optimal: a distance based cost gets a scale close to 1, a time based one a scale
+ * close to the inverse of the maximum speed.
+ *
+ * Optionally, landmarks can be computed (ALT): the exact route costs from and to a few vertices at the border of the
+ * map. By the triangle inequality they give much tighter lower bounds than the euclidean distance, so only vertices
+ * close to the optimal path are expanded. They can be saved next to the map and loaded on startup, shortestPath uses
+ * them automatically.
+ *
+ * The relations are collected in parallel on construction. The graph can be saved and loaded for a map that did not
+ * change, so the build is skipped at startup.
+ *
+ * Areas are not part of the copy, use RoutingGraph::shortestPathIncludingAreas for them.
+ */
+class FrozenRoutingGraph {
+ public:
+  static constexpr uint32_t InvalVertex = std::numeric_limits<uint32_t>::max();
+
+  /**
+   * @brief copies the graph
+   * @param graph graph to copy. Only used during construction.
+   * @param trafficRules and routingCosts the graph was built with. They are used to recompute the edge costs, since
+   * RoutingGraph does not expose them.
+   * @param numThreads threads used to query the relations of the lanelets
+   */
+  FrozenRoutingGraph(const RoutingGraph& graph, const traffic_rules::TrafficRules& trafficRules,
+                     const RoutingCostPtrs& routingCosts = defaultRoutingCosts(),
+                     size_t numThreads = std::max(1U, std::thread::hardware_concurrency())) {
+    for (const auto& llt : graph.passableSubmap()->laneletLayer) {
+      for (const auto& dir : {ConstLanelet(llt), ConstLanelet(llt).invert()}) {
+        if (trafficRules.canPass(dir)) {
+          vertexLookup_.emplace(dir, static_cast<uint32_t>(vertices_.size()));
+          vertices_.push_back(dir);
+          centers_.push_back(geometry::boundingBox2d(dir).center());
+        }
+      }
+    }
+    layouts_.resize(routingCosts.size());
+    for (RoutingCostId costId = 0; costId < routingCosts.size(); ++costId) {
+      buildLayout(layouts_[costId], graph, trafficRules, *routingCosts[costId], costId, numThreads);
+    }
+  }
+
+  size_t numVertices() const noexcept { return vertices_.size(); }
+  size_t numRoutingCosts() const noexcept { return layouts_.size(); }
+  size_t numEdges(RoutingCostId costId = {}) const { return layouts_.at(costId).targets.size(); }
+  const ConstLanelet& lanelet(uint32_t v) const { return vertices_[v]; }
+  //! non owning view on the lanelet of a vertex without geometry, valid as long as the graph. See
+  //! FrozenLaneletMap::laneletRef for one with the centerline.
+  LaneletRef laneletRef(uint32_t v) const noexcept { return vertices_[v]; }
+
+  //! vertex of the lanelet or InvalVertex if it is not passable
+  uint32_t vertex(const ConstLanelet& llt) const {
+    auto it = vertexLookup_.find(llt);
+    return it == vertexLookup_.end() ? InvalVertex : it->second;
+  }
+
+  //! Same as RoutingGraph::shortestPath
+  Optional<LaneletPath> shortestPath(const ConstLanelet& from, const ConstLanelet& to, RoutingCostId routingCostId = {},
+                                     bool withLaneChanges = true) const {
+    RoutingSearchState state;
+    return shortestPath(from, to, state, routingCostId, withLaneChanges);
+  }
+
+  //! Same as RoutingGraph::shortestPath, reusing the given search state
+  Optional<LaneletPath> shortestPath(const ConstLanelet& from, const ConstLanelet& to, RoutingSearchState& state,
+                                     RoutingCostId routingCostId = {}, bool withLaneChanges = true) const {
+    const auto& layout = layouts_.at(routingCostId);
+    const auto start = vertex(from);
+    const auto goal = vertex(to);
+    if (start == InvalVertex || goal == InvalVertex) {
+      return {};
+    }
+    auto heuristic = [&](uint32_t v) { return lowerBound(layout, v, goal); };
+    if (!std::isfinite(heuristic(start))) {
+      return {};
+    }
+
+    state.reset(numVertices());
+    state.clearQueue();
+    state.open(start, 0., InvalVertex);
+    state.push(heuristic(start), start);  // priority is the estimated total cost
+    while (!state.queueEmpty()) {
+      const auto v = state.top().second;
+      state.pop();
+      if (state.closed(v)) {
+        continue;
+      }
+      if (v == goal) {
+        return LaneletPath(tracePath(state, goal));
+      }
+      state.close(v);
+      const auto cost = state.cost(v);
+      for (auto e = layout.offsets[v]; e < layout.offsets[v + 1]; ++e) {
+        if (!withLaneChanges && layout.relations[e] != RelationType::Successor) {
+          continue;
+        }
+        const auto w = layout.targets[e];
+        const auto newCost = cost + layout.costs[e];
+        if (!state.closed(w) && newCost < state.cost(w)) {
+          const auto estimate = heuristic(w);
+          if (!std::isfinite(estimate)) {
+            continue;  // the landmarks prove that the goal can not be reached from w
+          }
+          state.open(w, newCost, v);
+          state.push(newCost + estimate, w);
+        }
+      }
+    }
+    return {};
+  }
+
+  /**
+   * @brief Same as RoutingGraph::shortestPathVia, with the legs between consecutive via lanelets searched in parallel.
+   *
+   * The legs are independent searches on the const graph. Each thread has its own search state and handles a
+   * contiguous range of legs, so the query takes about as long as the longest leg (or range of legs, if there are more
+   * legs than threads) instead of the sum of all legs.
+   */
+  Optional<LaneletPath> shortestPathVia(const ConstLanelet& start, const ConstLanelets& via, const ConstLanelet& end,
+                                        RoutingCostId routingCostId = {}, bool withLaneChanges = true,
+                                        size_t numThreads = std::max(1U, std::thread::hardware_concurrency())) const {
+    ConstLanelets stops{start};
+    stops.insert(stops.end(), via.begin(), via.end());
+    stops.push_back(end);
+    const auto numLegs = stops.size() - 1;
+    auto legs = forChunks(
+        numLegs, numThreads,
+        [&](size_t begin, size_t last) {
+          RoutingSearchState state;
+          std::vector<Optional<LaneletPath>> result;
+          result.reserve(last - begin);
+          for (auto leg = begin; leg < last; ++leg) {
+            result.push_back(shortestPath(stops[leg], stops[leg + 1], state, routingCostId, withLaneChanges));
+            if (!result.back()) {
+              break;  // the whole path fails anyway
+            }
+          }
+          return result;
+        },
+        1);
+    ConstLanelets path;
+    for (const auto& chunk : legs) {
+      for (const auto& leg : chunk) {
+        if (!leg) {
+          return {};
+        }
+        path.insert(path.end(), path.empty() ? leg->begin() : std::next(leg->begin()), leg->end());
+      }
+    }
+    return LaneletPath(std::move(path));
+  }
+
+  /**
+   * @brief Lanelets reachable from the start lanelet within maxRoutingCost, as RoutingGraph::reachableSet
+   *
+   * @param startOffset routing cost already covered on the start lanelet, e.g. the distance the ego has driven on it.
+   * The horizon is measured from there, so it grows by startOffset.
+   * @return the lanelets in order of increasing cost, stored in the workspace. The start lanelet is always included.
+   *
+   * If the previous query of the workspace had the same start lanelet and parameters and a smaller horizon (the ego
+   * advanced within the lanelet), the search continues from where it stopped and only the new lanelets are added.
+   */
+  const ConstLanelets& reachableSet(const ConstLanelet& lanelet, double maxRoutingCost, RoutingWorkspace& workspace,
+                                    RoutingCostId routingCostId = {}, bool allowLaneChanges = true,
+                                    double startOffset = 0.) const {
+    const auto& layout = layouts_.at(routingCostId);
+    const auto start = vertex(lanelet);
+    auto& state = workspace.state_;
+    if (start == InvalVertex) {
+      workspace.reachable.clear();
+      workspace.invalidate();
+      return workspace.reachable;
+    }
+    const auto budget = std::max(maxRoutingCost + startOffset, 0.);
+    const auto& last = workspace.last_;
+    const bool resume = last.start == start && last.costId == routingCostId && last.laneChanges == allowLaneChanges &&
+                        budget >= last.budget;
+    if (!resume) {
+      state.reset(numVertices());
+      state.clearQueue();
+      workspace.reachable.clear();
+      state.open(start, 0., InvalVertex);
+      state.push(0., start);
+    }
+    while (!state.queueEmpty() && state.top().first <= budget) {
+      const auto v = state.top().second;
+      state.pop();
+      if (state.closed(v)) {
+        continue;
+      }
+      state.close(v);
+      workspace.reachable.push_back(vertices_[v]);
+      for (auto e = layout.offsets[v]; e < layout.offsets[v + 1]; ++e) {
+        if (!allowLaneChanges && layout.relations[e] != RelationType::Successor) {
+          continue;
+        }
+        const auto w = layout.targets[e];
+        const auto newCost = state.cost(v) + layout.costs[e];
+        if (!state.closed(w) && newCost < state.cost(w)) {
+          state.open(w, newCost, v);
+          state.push(newCost, w);
+        }
+      }
+    }
+    workspace.last_ = {start, routingCostId, allowLaneChanges, budget};
+    return workspace.reachable;
+  }
+
+  /**
+   * @brief Paths from the start lanelet that are at least minRoutingCost long (or end in a dead end), as
+   * RoutingGraph::possiblePaths
+   *
+   * The paths are the branches of the cheapest-path tree from the start, so every lanelet is reached on its cheapest
+   * path. The result is stored as vertex ids in workspace.paths, use toLaneletPath to convert a path.
+   */
+  const PathArena& possiblePaths(const ConstLanelet& startPoint, double minRoutingCost, RoutingWorkspace& workspace,
+                                 RoutingCostId routingCostId = {}, bool allowLaneChanges = false) const {
+    const auto& layout = layouts_.at(routingCostId);
+    const auto start = vertex(startPoint);
+    auto& state = workspace.state_;
+    auto& order = workspace.order_;
+    workspace.paths.clear();
+    workspace.invalidate();
+    if (start == InvalVertex) {
+      return workspace.paths;
+    }
+    state.reset(numVertices());
+    state.clearQueue();
+    order.clear();
+    state.open(start, 0., InvalVertex);
+    state.push(0., start);
+    while (!state.queueEmpty()) {
+      const auto v = state.top().second;
+      state.pop();
+      if (state.closed(v)) {
+        continue;
+      }
+      state.close(v);
+      order.push_back(v);
+      const auto cost = state.cost(v);
+      if (cost >= minRoutingCost) {
+        continue;  // long enough, the path ends here
+      }
+      for (auto e = layout.offsets[v]; e < layout.offsets[v + 1]; ++e) {
+        if (!allowLaneChanges && layout.relations[e] != RelationType::Successor) {
+          continue;
+        }
+        const auto w = layout.targets[e];
+        if (!state.closed(w) && cost + layout.costs[e] < state.cost(w)) {
+          state.open(w, cost + layout.costs[e], v);
+          state.push(cost + layout.costs[e], w);
+        }
+      }
+    }
+    auto& isParent = workspace.isParent_;
+    isParent.resize(numVertices(), 0);
+    for (auto v : order) {
+      if (state.predecessor(v) != InvalVertex) {
+        isParent[state.predecessor(v)] = 1;
+      }
+    }
+    auto& paths = workspace.paths;
+    for (auto v : order) {
+      if (isParent[v] == 0) {
+        const auto first = paths.vertices.size();
+        for (auto p = v; p != InvalVertex; p = state.predecessor(p)) {
+          paths.vertices.push_back(p);
+        }
+        std::reverse(paths.vertices.begin() + first, paths.vertices.end());
+        paths.offsets.push_back(static_cast<uint32_t>(paths.vertices.size()));
+      }
+    }
+    for (auto v : order) {
+      isParent[v] = 0;
+    }
+    return paths;
+  }
+
+  //! path i of the arena as lanelets
+  LaneletPath toLaneletPath(const PathArena& paths, size_t i) const {
+    ConstLanelets lanelets;
+    lanelets.reserve(paths.end(i) - paths.begin(i));
+    std::transform(paths.begin(i), paths.end(i), std::back_inserter(lanelets),
+                   [this](uint32_t v) { return vertices_[v]; });
+    return LaneletPath(std::move(lanelets));
+  }
+
+  LaneletPaths toLaneletPaths(const PathArena& paths) const {
+    LaneletPaths result;
+    result.reserve(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+      result.push_back(toLaneletPath(paths, i));
+    }
+    return result;
+  }
+
+  /**
+   * @brief selects numLandmarks landmarks per routing cost id and computes the costs from and to them
+   *
+   * Landmarks are chosen greedily as the vertex farthest from all landmarks chosen so far. This needs two Dijkstra
+   * searches over the whole graph per landmark and routing cost, memory is 2 * numLandmarks doubles per vertex.
+   */
+  void computeLandmarks(size_t numLandmarks) {
+    const auto n = numVertices();
+    for (auto& layout : layouts_) {
+      layout.landmarks.clear();
+      layout.fromLandmark.clear();
+      layout.toLandmark.clear();
+      if (n == 0) {
+        continue;
+      }
+      Layout reverse = reversed(layout);
+      auto farthest = [](const std::vector<double>& costs) {
+        uint32_t best = 0;
+        for (uint32_t v = 0; v < costs.size(); ++v) {
+          if (costs[v] > costs[best]) {
+            best = v;
+          }
+        }
+        return best;
+      };
+      auto fromFirst = costsFrom(layout, 0);
+      std::replace(fromFirst.begin(), fromFirst.end(), std::numeric_limits<double>::infinity(), -1.);
+      auto next = farthest(fromFirst);
+      std::vector<double> closest(n, std::numeric_limits<double>::infinity());
+      while (layout.landmarks.size() < numLandmarks && layout.landmarks.size() < n) {
+        const auto from = costsFrom(layout, next);
+        const auto to = costsFrom(reverse, next);
+        layout.landmarks.push_back(next);
+        layout.fromLandmark.insert(layout.fromLandmark.end(), from.begin(), from.end());
+        layout.toLandmark.insert(layout.toLandmark.end(), to.begin(), to.end());
+        for (size_t v = 0; v < n; ++v) {
+          closest[v] = std::min(closest[v], std::min(from[v], to[v]));
+        }
+        next = farthest(closest);  // unreachable vertices (other components) come first
+        if (closest[next] <= 0.) {
+          break;
+        }
+      }
+    }
+  }
+
+  size_t numLandmarks(RoutingCostId costId = {}) const { return layouts_.at(costId).landmarks.size(); }
+
+  //! Writes the landmarks to a file, e.g. next to the map. Throws an ExportError if the file can not be written.
+  void saveLandmarks(const std::string& filename) const {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) {
+      throw ExportError("Could not open " + filename + " for writing landmarks");
+    }
+    const uint64_t fp = fingerprint();
+    const auto n = static_cast<uint32_t>(numVertices());
+    const auto numLayouts = static_cast<uint32_t>(layouts_.size());
+    out.write(LandmarkMagic, sizeof(LandmarkMagic));
+    writeRaw(out, &LandmarkVersion, 1);
+    writeRaw(out, &fp, 1);
+    writeRaw(out, &n, 1);
+    writeRaw(out, &numLayouts, 1);
+    for (const auto& layout : layouts_) {
+      const auto k = static_cast<uint32_t>(layout.landmarks.size());
+      writeRaw(out, &k, 1);
+      writeRaw(out, layout.landmarks.data(), k);
+      writeRaw(out, layout.fromLandmark.data(), layout.fromLandmark.size());
+      writeRaw(out, layout.toLandmark.data(), layout.toLandmark.size());
+    }
+    if (!out) {
+      throw ExportError("Failed to write landmarks to " + filename);
+    }
+  }
+
+  /**
+   * @brief Loads landmarks saved with saveLandmarks
+   * @return false if the file does not exist, is corrupt or belongs to a different graph (other map, traffic rules or
+   * routing costs). Then the landmarks are left unchanged and should be recomputed.
+   */
+  bool loadLandmarks(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    char magic[sizeof(LandmarkMagic)];
+    uint32_t version{};
+    uint64_t fp{};
+    uint32_t n{};
+    uint32_t numLayouts{};
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, LandmarkMagic, sizeof(magic)) != 0 ||
+        !readRaw(in, &version, 1) || version != LandmarkVersion || !readRaw(in, &fp, 1) || fp != fingerprint() ||
+        !readRaw(in, &n, 1) || n != numVertices() || !readRaw(in, &numLayouts, 1) || numLayouts != layouts_.size()) {
+      return false;
+    }
+    std::vector<Layout> loaded(numLayouts);
+    for (auto& layout : loaded) {
+      uint32_t k{};
+      if (!readRaw(in, &k, 1) || k > n) {
+        return false;
+      }
+      layout.landmarks.resize(k);
+      layout.fromLandmark.resize(size_t(k) * n);
+      layout.toLandmark.resize(size_t(k) * n);
+      if (!readRaw(in, layout.landmarks.data(), k) ||
+          !readRaw(in, layout.fromLandmark.data(), layout.fromLandmark.size()) ||
+          !readRaw(in, layout.toLandmark.data(), layout.toLandmark.size())) {
+        return false;
+      }
+    }
+    for (size_t i = 0; i < numLayouts; ++i) {
+      layouts_[i].landmarks = std::move(loaded[i].landmarks);
+      layouts_[i].fromLandmark = std::move(loaded[i].fromLandmark);
+      layouts_[i].toLandmark = std::move(loaded[i].toLandmark);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Writes the graph, so that the next start can load() it instead of building the RoutingGraph
+   * @param mapHash identifies the map version (e.g. a hash of the map file), checked by load(). Landmarks are not part
+   * of the file, see saveLandmarks.
+   * @throws ExportError if the file can not be written
+   */
+  void save(const std::string& filename, uint64_t mapHash) const {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) {
+      throw ExportError("Could not open " + filename + " for writing the routing graph");
+    }
+    const auto n = static_cast<uint32_t>(numVertices());
+    const auto numLayouts = static_cast<uint32_t>(layouts_.size());
+    out.write(GraphMagic, sizeof(GraphMagic));
+    writeRaw(out, &GraphVersion, 1);
+    writeRaw(out, &mapHash, 1);
+    writeRaw(out, &n, 1);
+    writeRaw(out, &numLayouts, 1);
+    for (const auto& llt : vertices_) {
+      const Id id = llt.id();
+      const char inverted = llt.inverted() ? 1 : 0;
+      writeRaw(out, &id, 1);
+      writeRaw(out, &inverted, 1);
+    }
+    for (const auto& layout : layouts_) {
+      const auto numEdges = static_cast<uint32_t>(layout.targets.size());
+      writeRaw(out, &layout.heuristicScale, 1);
+      writeRaw(out, &numEdges, 1);
+      writeRaw(out, layout.offsets.data(), layout.offsets.size());
+      writeRaw(out, layout.targets.data(), numEdges);
+      writeRaw(out, layout.costs.data(), numEdges);
+      writeRaw(out, layout.relations.data(), numEdges);
+    }
+    if (!out) {
+      throw ExportError("Failed to write the routing graph to " + filename);
+    }
+  }
+
+  /**
+   * @brief Restores a graph written by save()
+   * @param map the map the graph was built from. Its lanelets are referenced by id.
+   * @return nullptr if the file does not exist, is corrupt, was written for another mapHash or references lanelets
+   * that are not in the map. Then the graph has to be built again.
+   */
+  static std::unique_ptr<FrozenRoutingGraph> load(const std::string& filename, const LaneletMap& map,
+                                                  uint64_t mapHash) {
+    std::ifstream in(filename, std::ios::binary);
+    char magic[sizeof(GraphMagic)];
+    uint32_t version{};
+    uint64_t hash{};
+    uint32_t n{};
+    uint32_t numLayouts{};
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, GraphMagic, sizeof(magic)) != 0 ||
+        !readRaw(in, &version, 1) || version != GraphVersion || !readRaw(in, &hash, 1) || hash != mapHash ||
+        !readRaw(in, &n, 1) || !readRaw(in, &numLayouts, 1)) {
+      return nullptr;
+    }
+    std::unique_ptr<FrozenRoutingGraph> graph(new FrozenRoutingGraph());
+    graph->vertices_.reserve(n);
+    graph->centers_.reserve(n);
+    for (uint32_t v = 0; v < n; ++v) {
+      Id id{};
+      char inverted{};
+      if (!readRaw(in, &id, 1) || !readRaw(in, &inverted, 1) || !map.laneletLayer.exists(id)) {
+        return nullptr;
+      }
+      ConstLanelet llt = map.laneletLayer.get(id);
+      if (inverted != 0) {
+        llt = llt.invert();
+      }
+      graph->vertexLookup_.emplace(llt, v);
+      graph->vertices_.push_back(llt);
+      graph->centers_.push_back(geometry::boundingBox2d(llt).center());
+    }
+    graph->layouts_.resize(numLayouts);
+    for (auto& layout : graph->layouts_) {
+      uint32_t numEdges{};
+      if (!readRaw(in, &layout.heuristicScale, 1) || !readRaw(in, &numEdges, 1)) {
+        return nullptr;
+      }
+      layout.offsets.resize(size_t(n) + 1);
+      layout.targets.resize(numEdges);
+      layout.costs.resize(numEdges);
+      layout.relations.resize(numEdges);
+      if (!readRaw(in, layout.offsets.data(), layout.offsets.size()) || !readRaw(in, layout.targets.data(), numEdges) ||
+          !readRaw(in, layout.costs.data(), numEdges) || !readRaw(in, layout.relations.data(), numEdges) ||
+          layout.offsets.front() != 0 || layout.offsets.back() != numEdges ||
+          std::any_of(layout.targets.begin(), layout.targets.end(), [n](uint32_t t) { return t >= n; }) ||
+          !std::is_sorted(layout.offsets.begin(), layout.offsets.end())) {
+        return nullptr;
+      }
+    }
+    return graph;
+  }
+
+ private:
+  friend class RoutingSkeleton;
+  FrozenRoutingGraph() = default;
+
+  static constexpr char GraphMagic[8] = {'L', 'L', '2', 'F', 'R', 'G', '\0', '\0'};
+  static constexpr uint32_t GraphVersion = 1;
+  static constexpr char LandmarkMagic[8] = {'L', 'L', '2', 'A', 'L', 'T', '\0', '\0'};
+  static constexpr uint32_t LandmarkVersion = 1;
+
+  struct Layout {
+    std::vector<uint32_t> offsets;  //!< edges of vertex v are [offsets[v], offsets[v + 1])
+    std::vector<uint32_t> targets;
+    std::vector<double> costs;
+    std::vector<RelationType> relations;
+    double heuristicScale{0.};
+    std::vector<uint32_t> landmarks;
+    std::vector<double> fromLandmark;  //!< cost from landmark l to vertex v at l * numVertices() + v
+    std::vector<double> toLandmark;    //!< cost from vertex v to landmark l at l * numVertices() + v
+  };
+
+  //! Lower bound of the cost from v to goal: the scaled euclidean distance or the best landmark bound
+  double lowerBound(const Layout& layout, uint32_t v, uint32_t goal) const {
+    double bound = layout.heuristicScale * (centers_[v] - centers_[goal]).norm();
+    const auto n = numVertices();
+    for (size_t l = 0; l < layout.landmarks.size(); ++l) {
+      const double* from = layout.fromLandmark.data() + l * n;
+      const double* to = layout.toLandmark.data() + l * n;
+      if (std::isfinite(from[goal]) && std::isfinite(from[v])) {
+        bound = std::max(bound, from[goal] - from[v]);
+      }
+      if (std::isfinite(to[goal])) {
+        if (!std::isfinite(to[v])) {
+          return std::numeric_limits<double>::infinity();  // v can not reach the landmark, so not the goal either
+        }
+        bound = std::max(bound, to[v] - to[goal]);
+      }
+    }
+    return bound;
+  }
+
+  //! Dijkstra over all edges of the layout
+  std::vector<double> costsFrom(const Layout& layout, uint32_t source) const {
+    std::vector<double> cost(numVertices(), std::numeric_limits<double>::infinity());
+    using Entry = std::pair<double, uint32_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+    cost[source] = 0.;
+    queue.push({0., source});
+    while (!queue.empty()) {
+      const auto c = queue.top().first;
+      const auto v = queue.top().second;
+      queue.pop();
+      if (c > cost[v]) {
+        continue;
+      }
+      for (auto e = layout.offsets[v]; e < layout.offsets[v + 1]; ++e) {
+        const auto w = layout.targets[e];
+        if (c + layout.costs[e] < cost[w]) {
+          cost[w] = c + layout.costs[e];
+          queue.push({cost[w], w});
+        }
+      }
+    }
+    return cost;
+  }
+
+  //! layout with all edges inverted
+  Layout reversed(const Layout& layout) const {
+    const auto n = numVertices();
+    Layout reverse;
+    reverse.offsets.assign(n + 1, 0);
+    for (auto target : layout.targets) {
+      ++reverse.offsets[target + 1];
+    }
+    for (size_t v = 0; v < n; ++v) {
+      reverse.offsets[v + 1] += reverse.offsets[v];
+    }
+    reverse.targets.resize(layout.targets.size());
+    reverse.costs.resize(layout.costs.size());
+    auto fill = reverse.offsets;
+    for (uint32_t v = 0; v < n; ++v) {
+      for (auto e = layout.offsets[v]; e < layout.offsets[v + 1]; ++e) {
+        const auto pos = fill[layout.targets[e]]++;
+        reverse.targets[pos] = v;
+        reverse.costs[pos] = layout.costs[e];
+      }
+    }
+    return reverse;
+  }
+
+  //! identifies vertices and edges, so that landmarks of another graph are not loaded
+  uint64_t fingerprint() const {
+    uint64_t hash = 14695981039346656037ULL;  // FNV-1a
+    auto add = [&hash](const void* data, size_t size) {
+      const auto* bytes = static_cast<const unsigned char*>(data);
+      for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+      }
+    };
+    for (const auto& llt : vertices_) {
+      const Id id = llt.id();
+      const char inverted = llt.inverted() ? 1 : 0;
+      add(&id, sizeof(id));
+      add(&inverted, 1);
+    }
+    for (const auto& layout : layouts_) {
+      add(layout.offsets.data(), layout.offsets.size() * sizeof(uint32_t));
+      add(layout.targets.data(), layout.targets.size() * sizeof(uint32_t));
+      add(layout.costs.data(), layout.costs.size() * sizeof(double));
+    }
+    return hash;
+  }
+
+  template <typename T>
+  static void writeRaw(std::ostream& out, const T* data, size_t count) {
+    out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+  }
+  template <typename T>
+  static bool readRaw(std::istream& in, T* data, size_t count) {
+    return bool(in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(count * sizeof(T))));
+  }
+
+  //! A relation found in the routing graph, before its cost is known
+  struct Candidate {
+    uint32_t from;
+    uint32_t to;
+    RelationType relation;
+    ConstLanelets froms;  //!< lane change run (lane changes only)
+    ConstLanelets tos;
+  };
+
+  //! Runs f(begin, end) on contiguous chunks of [0, n), at least minChunkSize long, and returns the results in order
+  template <typename Func, typename Result = decltype(std::declval<Func>()(size_t(), size_t()))>
+  static std::vector<Result> forChunks(size_t n, size_t numThreads, Func&& f, size_t minChunkSize = 256) {
+    const auto chunks = std::max<size_t>(1, std::min(numThreads, n / minChunkSize + 1));
+    std::vector<std::future<Result>> futures;
+    futures.reserve(chunks);
+    for (size_t c = 0; c < chunks; ++c) {
+      futures.push_back(std::async(std::launch::async, f, n * c / chunks, n * (c + 1) / chunks));
+    }
+    std::vector<Result> results;
+    results.reserve(chunks);
+    for (auto& future : futures) {
+      results.push_back(future.get());
+    }
+    return results;
+  }
+
+  /**
+   * The relations of the vertices are queried in parallel, each thread fills its own buffer. The costs are computed
+   * serially afterwards: routing cost modules read attributes (e.g. the speed limit) whose caches are not thread safe.
+   */
+  void buildLayout(Layout& layout, const RoutingGraph& graph, const traffic_rules::TrafficRules& trafficRules,
+                   const RoutingCost& routingCost, RoutingCostId costId, size_t numThreads) const {
+    auto buffers = forChunks(numVertices(), numThreads, [&](size_t begin, size_t end) {
+      std::vector<Candidate> candidates;
+      for (auto v = static_cast<uint32_t>(begin); v < end; ++v) {
+        const auto& llt = vertices_[v];
+        auto add = [&](const ConstLanelet& to, RelationType relation, ConstLanelets froms = {}, ConstLanelets tos = {}) {
+          const auto target = vertex(to);
+          if (target != InvalVertex) {
+            candidates.push_back({v, target, relation, std::move(froms), std::move(tos)});
+          }
+        };
+        for (const auto& next : graph.following(llt, false)) {
+          add(next, RelationType::Successor);
+        }
+        if (auto left = graph.left(llt, costId)) {
+          auto run = laneChangeRun(graph, costId, llt, *left, true);
+          add(*left, RelationType::Left, std::move(run.first), std::move(run.second));
+        }
+        if (auto right = graph.right(llt, costId)) {
+          auto run = laneChangeRun(graph, costId, llt, *right, false);
+          add(*right, RelationType::Right, std::move(run.first), std::move(run.second));
+        }
+      }
+      return candidates;
+    });
+
+    layout.offsets.assign(numVertices() + 1, 0);
+    layout.heuristicScale = std::numeric_limits<double>::infinity();
+    for (const auto& buffer : buffers) {  // chunks are ordered by vertex, so the edges are already grouped
+      for (const auto& c : buffer) {
+        const auto cost = c.relation == RelationType::Successor
+                              ? routingCost.getCostSucceeding(trafficRules, vertices_[c.from], vertices_[c.to])
+                              : routingCost.getCostLaneChange(trafficRules, c.froms, c.tos);
+        if (!std::isfinite(cost)) {
+          continue;
+        }
+        layout.targets.push_back(c.to);
+        layout.costs.push_back(cost);
+        layout.relations.push_back(c.relation);
+        ++layout.offsets[c.from + 1];
+        const auto dist = (centers_[c.from] - centers_[c.to]).norm();
+        if (dist > 0.) {
+          layout.heuristicScale = std::min(layout.heuristicScale, cost / dist);
+        }
+      }
+    }
+    for (size_t v = 0; v < numVertices(); ++v) {
+      layout.offsets[v + 1] += layout.offsets[v];
+    }
+    if (!std::isfinite(layout.heuristicScale)) {
+      layout.heuristicScale = 0.;
+    }
+  }
+
+  //! Like the graph builder, a lane change covers the remaining run of parallel lanelets it is part of
+  std::pair<ConstLanelets, ConstLanelets> laneChangeRun(const RoutingGraph& graph, RoutingCostId costId,
+                                                        const ConstLanelet& from, const ConstLanelet& to,
+                                                        bool left) const {
+    ConstLanelets froms{from};
+    ConstLanelets tos{to};
+    while (froms.size() <= numVertices()) {
+      const auto followingTos = graph.following(tos.back(), false);
+      bool extended = false;
+      for (const auto& next : graph.following(froms.back(), false)) {
+        const auto side = left ? graph.left(next, costId) : graph.right(next, costId);
+        if (side && std::find(followingTos.begin(), followingTos.end(), *side) != followingTos.end()) {
+          froms.push_back(next);
+          tos.push_back(*side);
+          extended = true;
+          break;
+        }
+      }
+      if (!extended || froms.back() == from) {
+        break;
+      }
+    }
+    return {std::move(froms), std::move(tos)};
+  }
+
+  ConstLanelets tracePath(const RoutingSearchState& state, uint32_t goal) const {
+    ConstLanelets path;
+    for (auto v = goal; v != InvalVertex; v = state.predecessor(v)) {
+      path.push_back(vertices_[v]);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+  }
+
+  ConstLanelets vertices_;
+  std::vector<BasicPoint2d> centers_;
+  std::unordered_map<ConstLanelet, uint32_t> vertexLookup_;
+  std::vector<Layout> layouts_;
+};
+
+}  // namespace routing
+}  // namespace lanelet
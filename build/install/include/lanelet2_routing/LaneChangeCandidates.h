@@ -0,0 +1,280 @@
+#pragma once
+#include <lanelet2_routing/FrozenRoutingGraph.h>
+#include <lanelet2_routing/RoutingGraph.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lanelet {
+namespace routing {
+
+//! Which lane change candidates LaneChangeEvaluator generates
+struct LaneChangeParameters {
+  double minPathLength{100.};  //!< routing cost of the possible paths after the lane change (usually [m])
+  size_t maxLaneChanges{1};    //!< targets up to this many lanes to the left and right
+  bool preferLeft{true};       //!< order of the sides for the same number of lane changes
+  RoutingCostId routingCostId{};
+};
+
+//! A lane change from the current lanelet to a target lanelet, followed by a possible path on the target lane
+struct LaneChangeCandidate {
+  ConstLanelet target;
+  LaneletPath path;         //!< current lanelet, target and the possible path from the target
+  size_t laneChanges{1};    //!< number of lanes between current and target
+  bool left{true};          //!< side of the target
+};
+
+//! Outcome and timing of one candidate
+struct LaneChangeCandidateResult {
+  Optional<double> cost;                      //!< set if the safety check passed
+  bool checked{false};                        //!< false if skipped because a preferred candidate is feasible
+  std::chrono::nanoseconds checkTime{0};      //!< duration of the safety check
+};
+
+//! Timing of the candidate generation for one target lanelet
+struct LaneChangeTargetTiming {
+  ConstLanelet target;
+  size_t numCandidates{0};
+  bool skipped{false};                        //!< not generated because a preferred target is feasible
+  std::chrono::nanoseconds generateTime{0};   //!< possiblePaths and conversion of the paths
+};
+
+//! Result of LaneChangeEvaluator::evaluate; candidates and results are in priority order
+struct LaneChangeEvaluation {
+  std::vector<LaneChangeCandidate> candidates;
+  std::vector<LaneChangeCandidateResult> results;
+  std::vector<LaneChangeTargetTiming> targets;
+  Optional<size_t> best;                      //!< index of the first feasible candidate
+  std::chrono::nanoseconds totalTime{0};
+
+  const LaneChangeCandidate* bestCandidate() const { return best ? &candidates[*best] : nullptr; }
+};
+
+/**
+ * @brief Generates and safety checks lane change candidates on a pool of worker threads.
+ *
+ * The targets are the lanelets reached by 1..maxLaneChanges lane changes to the left and right of the current lanelet
+ * (RoutingGraph::left/right), ordered by the number of lane changes and then by side. Every target is one task: its
+ * possible paths are generated on the FrozenRoutingGraph (with the RoutingWorkspace of the worker, which keeps its
+ * buffers across cycles) and checked one after the other, cheapest path first. The first feasible candidate in this
+ * order is the best one: as soon as a target has a feasible candidate, the workers skip the targets after it and stop
+ * checking their paths, while the preferred targets before it are still completed. The result is the same as that of
+ * a serial evaluation in priority order.
+ *
+ * The graphs are shared immutable snapshots. The safety check is called concurrently from all workers; it must only
+ * read shared data, e.g. an obstacle snapshot held by a std::shared_ptr<const ...> that is captured by the check.
+ *
+ * The calling thread works as one of the workers; evaluate must not be called concurrently on the same evaluator.
+ * If a check throws, the remaining targets are skipped and the exception is rethrown by evaluate.
+ */
+class LaneChangeEvaluator {
+ public:
+  //! returns the cost of a safe candidate, nothing if it collides
+  using SafetyCheck = std::function<Optional<double>(const LaneChangeCandidate&)>;
+
+  LaneChangeEvaluator(std::shared_ptr<const RoutingGraph> graph, std::shared_ptr<const FrozenRoutingGraph> frozenGraph,
+                      size_t numThreads = std::min(4U, std::max(1U, std::thread::hardware_concurrency())))
+      : graph_{std::move(graph)}, frozenGraph_{std::move(frozenGraph)}, workspaces_(std::max<size_t>(numThreads, 1)) {
+    for (size_t i = 1; i < workspaces_.size(); ++i) {
+      workers_.emplace_back([this, i] { workerLoop(workspaces_[i]); });
+    }
+  }
+
+  LaneChangeEvaluator(const LaneChangeEvaluator&) = delete;
+  LaneChangeEvaluator& operator=(const LaneChangeEvaluator&) = delete;
+
+  ~LaneChangeEvaluator() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    startCv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  size_t numThreads() const noexcept { return workspaces_.size(); }
+
+  LaneChangeEvaluation evaluate(const ConstLanelet& current, const SafetyCheck& check,
+                                const LaneChangeParameters& params = {}) {
+    const auto start = std::chrono::steady_clock::now();
+    Job job{current, check, params};
+    job.targets = collectTargets(current, params);
+    job.outputs.resize(job.targets.size());
+    job.best = job.targets.size();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      job_ = &job;
+      busy_ = workers_.size();
+      ++generation_;
+    }
+    startCv_.notify_all();
+    work(job, workspaces_[0]);
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      doneCv_.wait(lock, [this] { return busy_ == 0; });
+      job_ = nullptr;
+    }
+    if (job.error) {
+      std::rethrow_exception(job.error);
+    }
+
+    LaneChangeEvaluation evaluation;
+    for (size_t k = 0; k < job.targets.size(); ++k) {
+      auto& output = job.outputs[k];
+      for (size_t c = 0; c < output.candidates.size(); ++c) {
+        if (!evaluation.best && output.results[c].cost) {
+          evaluation.best = evaluation.candidates.size();
+        }
+        evaluation.candidates.push_back(std::move(output.candidates[c]));
+        evaluation.results.push_back(output.results[c]);
+      }
+      evaluation.targets.push_back(output.timing);
+    }
+    evaluation.totalTime = std::chrono::steady_clock::now() - start;
+    return evaluation;
+  }
+
+ private:
+  struct Target {
+    ConstLanelet lanelet;
+    size_t laneChanges;
+    bool left;
+  };
+  struct TargetOutput {
+    std::vector<LaneChangeCandidate> candidates;
+    std::vector<LaneChangeCandidateResult> results;
+    LaneChangeTargetTiming timing;
+  };
+  struct Job {
+    Job(const ConstLanelet& current, const SafetyCheck& check, const LaneChangeParameters& params)
+        : current{current}, check{check}, params{params} {}
+    ConstLanelet current;
+    const SafetyCheck& check;
+    const LaneChangeParameters& params;
+    std::vector<Target> targets;
+    std::vector<TargetOutput> outputs;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> best{0};  //!< index of the first target with a feasible candidate so far
+    std::mutex errorMutex;
+    std::exception_ptr error;
+  };
+
+  std::vector<Target> collectTargets(const ConstLanelet& current, const LaneChangeParameters& params) const {
+    std::vector<Target> targets;
+    Optional<ConstLanelet> left = current;
+    Optional<ConstLanelet> right = current;
+    for (size_t n = 1; n <= params.maxLaneChanges; ++n) {
+      left = left ? graph_->left(*left, params.routingCostId) : Optional<ConstLanelet>{};
+      right = right ? graph_->right(*right, params.routingCostId) : Optional<ConstLanelet>{};
+      const auto& first = params.preferLeft ? left : right;
+      const auto& second = params.preferLeft ? right : left;
+      if (first) {
+        targets.push_back({*first, n, params.preferLeft});
+      }
+      if (second) {
+        targets.push_back({*second, n, !params.preferLeft});
+      }
+    }
+    return targets;
+  }
+
+  void workerLoop(RoutingWorkspace& workspace) {
+    size_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      startCv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+      if (stop_) {
+        return;
+      }
+      seen = generation_;
+      Job& job = *job_;
+      lock.unlock();
+      work(job, workspace);
+      lock.lock();
+      if (--busy_ == 0) {
+        doneCv_.notify_one();
+      }
+    }
+  }
+
+  void work(Job& job, RoutingWorkspace& workspace) const {
+    for (auto k = job.next.fetch_add(1); k < job.targets.size(); k = job.next.fetch_add(1)) {
+      auto& output = job.outputs[k];
+      output.timing.target = job.targets[k].lanelet;
+      if (job.best.load() < k) {
+        output.timing.skipped = true;
+        continue;
+      }
+      try {
+        evaluateTarget(job, k, workspace, output);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(job.errorMutex);
+        if (!job.error) {
+          job.error = std::current_exception();
+        }
+        job.best.store(0);  // skips every target that is not started yet
+      }
+    }
+  }
+
+  void evaluateTarget(Job& job, size_t k, RoutingWorkspace& workspace, TargetOutput& output) const {
+    const auto& target = job.targets[k];
+    const auto generateStart = std::chrono::steady_clock::now();
+    const auto& paths =
+        frozenGraph_->possiblePaths(target.lanelet, job.params.minPathLength, workspace, job.params.routingCostId);
+    output.candidates.reserve(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+      ConstLanelets lanelets{job.current};
+      for (auto v = paths.begin(i); v != paths.end(i); ++v) {
+        lanelets.push_back(frozenGraph_->lanelet(*v));
+      }
+      output.candidates.push_back({target.lanelet, LaneletPath(std::move(lanelets)), target.laneChanges, target.left});
+    }
+    output.timing.numCandidates = output.candidates.size();
+    output.timing.generateTime = std::chrono::steady_clock::now() - generateStart;
+
+    output.results.resize(output.candidates.size());
+    for (size_t c = 0; c < output.candidates.size(); ++c) {
+      if (job.best.load() < k) {
+        break;  // a preferred target has a feasible candidate
+      }
+      auto& result = output.results[c];
+      const auto checkStart = std::chrono::steady_clock::now();
+      result.cost = job.check(output.candidates[c]);
+      result.checkTime = std::chrono::steady_clock::now() - checkStart;
+      result.checked = true;
+      if (result.cost) {
+        auto best = job.best.load();
+        while (k < best && !job.best.compare_exchange_weak(best, k)) {
+        }
+        break;
+      }
+    }
+  }
+
+  std::shared_ptr<const RoutingGraph> graph_;
+  std::shared_ptr<const FrozenRoutingGraph> frozenGraph_;
+  std::vector<RoutingWorkspace> workspaces_;  //!< one per thread, [0] is used by the calling thread
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable startCv_;
+  std::condition_variable doneCv_;
+  Job* job_{nullptr};
+  size_t generation_{0};
+  size_t busy_{0};
+  bool stop_{false};
+};
+
+}  // namespace routing
+}  // namespace lanelet
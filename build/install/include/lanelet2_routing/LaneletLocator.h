@@ -0,0 +1,112 @@
+#pragma once
+#include <lanelet2_core/LaneletMap.h>
+#include <lanelet2_core/PackedRTree.h>
+#include <lanelet2_core/geometry/Lanelet.h>
+#include <lanelet2_core/geometry/LaneletMap.h>
+
+#include <algorithm>
+
+#include "lanelet2_routing/RoutingGraph.h"
+
+namespace lanelet {
+namespace routing {
+
+/**
+ * @brief Stateful lookup of the lanelet a (moving) point is on.
+ *
+ * The locator remembers the lanelet of the last query and its neighbours in the routing graph (following, previous
+ * and besides). A query first checks whether the point is still inside the last lanelet, then whether it moved into
+ * one of the neighbours. Only if both fail, the spatial index of the layer is queried. For a vehicle driving along
+ * the map this replaces the R-Tree and geometry search of each cycle by one or a few point in polygon tests.
+ *
+ * @tparam LayerT anything geometry::findNearest accepts for lanelets, i.e. the LaneletLayer of a map or a packed tree
+ * of a frozen map.
+ */
+template <typename LayerT = LaneletLayer>
+class LaneletLocatorT {
+ public:
+  struct Statistics {
+    size_t lastHits{0};       //!< point still inside the last lanelet
+    size_t neighbourHits{0};  //!< point moved to a neighbour of the last lanelet
+    size_t searches{0};       //!< full search in the spatial index
+  };
+
+  /**
+   * @param layer layer to fall back to. Has to outlive the locator.
+   * @param graph routing graph used to find the neighbours. Can be null, then only the last lanelet is cached.
+   */
+  explicit LaneletLocatorT(const LayerT& layer, RoutingGraphConstPtr graph = nullptr)
+      : layer_{&layer}, graph_{std::move(graph)} {}
+
+  /**
+   * @brief returns the lanelet containing the point or, if the point is outside of all lanelets, the closest one
+   *
+   * Where lanelets overlap (e.g. at intersections), the last lanelet and its neighbours are preferred over other
+   * overlapping lanelets, so the result does not jump between them.
+   */
+  Optional<ConstLanelet> locate(const BasicPoint2d& point) {
+    if (last_) {
+      if (geometry::inside(*last_, point)) {
+        ++stats_.lastHits;
+        return last_;
+      }
+      for (const auto& neighbour : neighbours_) {
+        if (geometry::inside(neighbour, point)) {
+          ++stats_.neighbourHits;
+          update(neighbour);
+          return last_;
+        }
+      }
+    }
+    ++stats_.searches;
+    const auto nearest = geometry::findNearest(*layer_, point, 1);
+    if (nearest.empty()) {
+      reset();
+      return {};
+    }
+    update(nearest.front().second);
+    return last_;
+  }
+
+  //! Forgets the last lanelet, e.g. after a relocalization
+  void reset() {
+    last_ = {};
+    neighbours_.clear();
+  }
+
+  const Optional<ConstLanelet>& last() const noexcept { return last_; }
+  const Statistics& statistics() const noexcept { return stats_; }
+
+ private:
+  void update(const ConstLanelet& llt) {
+    if (last_ && *last_ == llt) {
+      return;
+    }
+    last_ = llt;
+    neighbours_.clear();
+    if (!graph_) {
+      return;
+    }
+    auto append = [this, &llt](const ConstLanelets& lanelets) {
+      for (const auto& other : lanelets) {
+        if (other != llt && std::find(neighbours_.begin(), neighbours_.end(), other) == neighbours_.end()) {
+          neighbours_.push_back(other);
+        }
+      }
+    };
+    append(graph_->following(llt));
+    append(graph_->besides(llt));
+    append(graph_->previous(llt));
+  }
+
+  const LayerT* layer_;
+  RoutingGraphConstPtr graph_;
+  Optional<ConstLanelet> last_;
+  ConstLanelets neighbours_;  //!< ordered by the likelihood of being entered next
+  Statistics stats_;
+};
+
+using LaneletLocator = LaneletLocatorT<LaneletLayer>;
+
+}  // namespace routing
+}  // namespace lanelet
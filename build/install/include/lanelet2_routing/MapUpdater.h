@@ -0,0 +1,106 @@
+#pragma once
+#include <lanelet2_core/MapPatch.h>
+#include <lanelet2_traffic_rules/TrafficRules.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "lanelet2_routing/Route.h"
+#include "lanelet2_routing/RoutingCost.h"
+#include "lanelet2_routing/RoutingGraph.h"
+
+namespace lanelet {
+namespace routing {
+
+/**
+ * @brief Owns a map and its routing graph and applies patches to them while the process keeps running.
+ *
+ * The map is patched in place (see applyPatch), then the routing graph is rebuilt from the patched map and published
+ * to all subscribers together with what the patch changed. Users like a route handler subscribe to replan only if
+ * their route is affected.
+ *
+ * A patch file is an ordinary map file, so it is loaded through lanelet::load and MapPatch::fromMap.
+ *
+ * The routing graph is exchanged atomically, so graphs obtained from routingGraph() stay valid, but the map itself is
+ * modified in place: apply() must not run while other threads read the map (e.g. call it between two planning
+ * cycles).
+ */
+class MapUpdater {
+ public:
+  using Callback = std::function<void(const MapPatchResult&, const RoutingGraphConstPtr&)>;
+  using SubscriptionId = size_t;
+
+  MapUpdater(LaneletMapPtr map, traffic_rules::TrafficRulesPtr trafficRules,
+             RoutingCostPtrs routingCosts = defaultRoutingCosts(),
+             RoutingGraph::Configuration config = RoutingGraph::Configuration())
+      : map_{std::move(map)},
+        trafficRules_{std::move(trafficRules)},
+        routingCosts_{std::move(routingCosts)},
+        config_{std::move(config)},
+        graph_{RoutingGraph::build(*map_, *trafficRules_, routingCosts_, config_)} {}
+
+  const LaneletMapPtr& laneletMap() const noexcept { return map_; }
+
+  RoutingGraphConstPtr routingGraph() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return graph_;
+  }
+
+  //! Registers a callback that is called after every applied patch, from the thread calling apply()
+  SubscriptionId subscribe(Callback callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscribers_.emplace(nextId_, std::move(callback));
+    return nextId_++;
+  }
+  void unsubscribe(SubscriptionId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscribers_.erase(id);
+  }
+
+  /**
+   * @brief Applies the patch, rebuilds the routing graph and notifies the subscribers
+   * @throws InvalidInputError if the patch is invalid. Nothing is changed then.
+   *
+   * The graph of the prebuilt routing library can not be edited, so it is rebuilt from the patched map. This takes a
+   * fraction of the time of a full reload and the lanelets, which are updated in place, keep their identity.
+   */
+  MapPatchResult apply(const MapPatch& patch) {
+    auto result = applyPatch(*map_, patch);
+    if (result.empty()) {
+      return result;
+    }
+    RoutingGraphConstPtr graph = RoutingGraph::build(*map_, *trafficRules_, routingCosts_, config_);
+    std::map<SubscriptionId, Callback> subscribers;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      graph_ = graph;
+      subscribers = subscribers_;
+    }
+    for (auto& subscriber : subscribers) {
+      subscriber.second(result, graph);
+    }
+    return result;
+  }
+
+  //! true if the route has to be replanned after the patch
+  static bool affects(const MapPatchResult& result, const Route& route) {
+    const auto& lanelets = route.laneletSubmap()->laneletLayer;
+    return result.affects(ConstLanelets(lanelets.begin(), lanelets.end()));
+  }
+
+ private:
+  LaneletMapPtr map_;
+  traffic_rules::TrafficRulesPtr trafficRules_;
+  RoutingCostPtrs routingCosts_;
+  RoutingGraph::Configuration config_;
+  mutable std::mutex mutex_;
+  RoutingGraphConstPtr graph_;
+  std::map<SubscriptionId, Callback> subscribers_;
+  SubscriptionId nextId_{0};
+};
+
+}  // namespace routing
+}  // namespace lanelet
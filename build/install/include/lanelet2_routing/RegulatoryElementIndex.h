@@ -0,0 +1,197 @@
+#pragma once
+#include <lanelet2_core/geometry/LineString.h>
+#include <lanelet2_core/primitives/BasicRegulatoryElements.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "lanelet2_routing/RouteIndex.h"
+
+namespace lanelet {
+namespace routing {
+
+/**
+ * @brief Regulatory elements along a route, sorted by route arc length, with precomputed stop positions.
+ *
+ * Built together with the RouteIndex whenever the route changes. Every (regulatory element, route lanelet) pair is one
+ * element, so a traffic light controlling three lanes of a segment shows up three times with the stop position of each
+ * lane. The per cycle lookup "what is in [s_ego, s_ego + horizon]" is then a binary search instead of walking the path
+ * lanelets and their regulatoryElements().
+ *
+ * The stop position is where the stop line (traffic lights, right of way, all way stops) or the reference line (traffic
+ * signs and any other element with a ref_line, e.g. crosswalks) crosses the centerline of the lanelet. Elements without
+ * such a line stop at the end of their lanelet.
+ */
+class RegulatoryElementIndex {
+ public:
+  enum class Kind : uint8_t { TrafficLight, RightOfWay, AllWayStop, TrafficSign, Crosswalk, Other };
+
+  struct Element {
+    RegulatoryElementConstPtr regulatoryElement;
+    Kind kind;
+    uint32_t entry;      //!< route index entry of the lanelet referencing the element
+    bool preferred;      //!< whether that lanelet is the preferred lanelet of its segment
+    bool hasStopLine;    //!< false if s is the end of the lanelet
+    double s;            //!< route arc length of the stop position
+    BasicPoint2d point;  //!< stop position
+  };
+
+  //! contiguous, s sorted range of elements
+  struct Range {
+    const Element* first{nullptr};
+    const Element* last{nullptr};
+    const Element* begin() const noexcept { return first; }
+    const Element* end() const noexcept { return last; }
+    bool empty() const noexcept { return first == last; }
+    size_t size() const noexcept { return static_cast<size_t>(last - first); }
+  };
+
+  RegulatoryElementIndex() = default;
+
+  explicit RegulatoryElementIndex(const RouteIndex& route) {
+    for (uint32_t idx = 0; idx < route.size(); ++idx) {
+      const auto& entry = route[idx];
+      for (const auto& regElem : entry.lanelet.regulatoryElements()) {
+        elements_.push_back(makeElement(route, idx, regElem));
+      }
+    }
+    std::stable_sort(elements_.begin(), elements_.end(),
+                     [](const Element& lhs, const Element& rhs) { return lhs.s < rhs.s; });
+    s_.reserve(elements_.size());
+    for (const auto& element : elements_) {
+      s_.push_back(element.s);
+    }
+  }
+
+  size_t size() const noexcept { return elements_.size(); }
+  bool empty() const noexcept { return elements_.empty(); }
+  const Element& operator[](size_t idx) const { return elements_[idx]; }
+  Range all() const noexcept { return {elements_.data(), elements_.data() + elements_.size()}; }
+
+  //! all elements with a stop position in [from, to]
+  Range between(double from, double to) const {
+    if (to < from) {
+      return {};
+    }
+    const auto first = std::lower_bound(s_.begin(), s_.end(), from) - s_.begin();
+    const auto last = std::upper_bound(s_.begin() + first, s_.end(), to) - s_.begin();
+    return {elements_.data() + first, elements_.data() + last};
+  }
+
+  //! first element of the kind with a stop position at or after s, or nullptr
+  const Element* next(Kind kind, double s, bool preferredOnly = true) const {
+    const auto first = std::lower_bound(s_.begin(), s_.end(), s) - s_.begin();
+    for (auto i = static_cast<size_t>(first); i < elements_.size(); ++i) {
+      if (elements_[i].kind == kind && (elements_[i].preferred || !preferredOnly)) {
+        return &elements_[i];
+      }
+    }
+    return nullptr;
+  }
+
+  static Kind kindOf(const RegulatoryElementConstPtr& regElem) {
+    if (std::dynamic_pointer_cast<const TrafficLight>(regElem)) {
+      return Kind::TrafficLight;
+    }
+    if (std::dynamic_pointer_cast<const RightOfWay>(regElem)) {
+      return Kind::RightOfWay;
+    }
+    if (std::dynamic_pointer_cast<const AllWayStop>(regElem)) {
+      return Kind::AllWayStop;
+    }
+    if (std::dynamic_pointer_cast<const TrafficSign>(regElem)) {
+      return Kind::TrafficSign;
+    }
+    if (regElem->attributeOr(AttributeName::Subtype, "") == std::string(AttributeValueString::Crosswalk)) {
+      return Kind::Crosswalk;
+    }
+    return Kind::Other;
+  }
+
+ private:
+  static Element makeElement(const RouteIndex& route, uint32_t idx, const RegulatoryElementConstPtr& regElem) {
+    const auto& entry = route[idx];
+    const auto kind = kindOf(regElem);
+    ConstLineStrings3d lines;
+    switch (kind) {
+      case Kind::TrafficLight:
+        if (auto line = std::static_pointer_cast<const TrafficLight>(regElem)->stopLine()) {
+          lines.push_back(*line);
+        }
+        break;
+      case Kind::RightOfWay:
+        if (auto line = std::static_pointer_cast<const RightOfWay>(regElem)->stopLine()) {
+          lines.push_back(*line);
+        }
+        break;
+      case Kind::AllWayStop:
+        if (auto line = std::static_pointer_cast<const AllWayStop>(regElem)->getStopLine(entry.lanelet)) {
+          lines.push_back(*line);
+        }
+        break;
+      case Kind::TrafficSign:
+        lines = std::static_pointer_cast<const TrafficSign>(regElem)->refLines();
+        break;
+      default:
+        lines = regElem->getParameters<ConstLineString3d>(RoleName::RefLine);
+        break;
+    }
+
+    const auto centerline = entry.lanelet.centerline2d();
+    Element element{regElem, kind, idx, entry.preferred, false, route.segmentStart(entry.segment + 1), {}};
+    if (!centerline.empty()) {
+      element.point = centerline.back().basicPoint();
+    }
+    double bestDist = std::numeric_limits<double>::infinity();
+    for (const auto& line : lines) {
+      double dist = 0.;
+      const auto point = crossing(centerline, utils::to2D(line), dist);
+      if (dist < bestDist) {
+        bestDist = dist;
+        element.point = point;
+        element.hasStopLine = true;
+      }
+    }
+    if (element.hasStopLine) {
+      element.s = route.arcLength(idx, element.point);
+    }
+    return element;
+  }
+
+  /**
+   * @brief where the line crosses the centerline, or its vertex closest to it if it does not
+   * @param dist distance of the returned point to the centerline, 0 for a crossing
+   */
+  static BasicPoint2d crossing(const ConstLineString2d& centerline, const ConstLineString2d& line, double& dist) {
+    dist = std::numeric_limits<double>::infinity();
+    BasicPoint2d best = line.empty() ? BasicPoint2d(BasicPoint2d::Zero()) : line.front().basicPoint();
+    if (line.empty() || centerline.size() < 2) {
+      return best;
+    }
+    double prev = geometry::signedDistance(centerline, line.front().basicPoint());
+    for (size_t i = 0; i < line.size(); ++i) {
+      const BasicPoint2d p = line[i].basicPoint();
+      const double d = i == 0 ? prev : geometry::signedDistance(centerline, p);
+      if (std::abs(d) < dist) {
+        dist = std::abs(d);
+        best = p;
+      }
+      if (i > 0 && ((prev < 0.) != (d < 0.))) {
+        const BasicPoint2d a = line[i - 1].basicPoint();
+        dist = 0.;
+        return a + (p - a) * (prev / (prev - d));
+      }
+      prev = d;
+    }
+    return best;
+  }
+
+  std::vector<Element> elements_;
+  std::vector<double> s_;  //!< stop position of each element, for the binary searches
+};
+
+}  // namespace routing
+}  // namespace lanelet
@@ -0,0 +1,117 @@
+#pragma once
+#include <lanelet2_core/geometry/Lanelet.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "lanelet2_routing/FrozenRoutingGraph.h"
+#include "lanelet2_routing/LaneletPath.h"
+
+namespace lanelet {
+namespace routing {
+
+/**
+ * @brief Difference between an old and a new route path: the new path is old[0, keptPrefix) followed by appended.
+ *
+ * A consumer with per route caches (lanelet sequences, route index, stop positions) keeps everything it has for the
+ * prefix and only drops the entries of the removed lanelets and adds the appended ones.
+ */
+struct RouteDelta {
+  size_t keptPrefix{0};    //!< number of lanelets at the start of the old path that are unchanged
+  ConstLanelets removed;   //!< the old lanelets after the prefix
+  ConstLanelets appended;  //!< the new lanelets after the prefix
+
+  bool empty() const noexcept { return removed.empty() && appended.empty(); }
+
+  //! the new path, from the old one
+  LaneletPath apply(const LaneletPath& old) const {
+    ConstLanelets lanelets(old.begin(), old.begin() + static_cast<std::ptrdiff_t>(std::min(keptPrefix, old.size())));
+    lanelets.insert(lanelets.end(), appended.begin(), appended.end());
+    return LaneletPath(std::move(lanelets));
+  }
+};
+
+/**
+ * @brief Replans a route after a new checkpoint or goal without touching the part the vehicle is about to drive.
+ *
+ * The old path is kept from the ego lanelet up to a splice lanelet at least keepDistance ahead of it, the search only
+ * runs from the splice lanelet through the checkpoints to the goal. This makes the result stable near the vehicle (a
+ * full replan from the current pose may pick another, equally good lane right in front of it) and the search
+ * shorter. If the goal can not be reached from the splice lanelet, earlier splice lanelets are tried down to the ego
+ * lanelet.
+ *
+ * The returned delta is relative to the old path, with the longest prefix the old and the new path have in common, so
+ * a goal moved within the last lanelets of a long route only changes the last lanelets.
+ */
+class PrefixRerouter {
+ public:
+  explicit PrefixRerouter(const FrozenRoutingGraph& graph, RoutingCostId routingCostId = {},
+                          bool withLaneChanges = true)
+      : graph_{&graph}, routingCostId_{routingCostId}, withLaneChanges_{withLaneChanges} {}
+
+  /**
+   * @param path the current route path
+   * @param egoIndex index of the lanelet of the vehicle in path. The lanelets before it are kept as they are.
+   * @param targets the lanelets of the remaining checkpoints followed by the goal lanelet, in order
+   * @param keepDistance minimum length (2d centerline) of the kept path ahead of the start of the ego lanelet
+   * @return the delta to the new path, which keeps the already driven lanelets before egoIndex. Empty optional if a
+   * target can not be reached.
+   */
+  Optional<RouteDelta> reroute(const LaneletPath& path, size_t egoIndex, const ConstLanelets& targets,
+                               double keepDistance = 100.) {
+    if (egoIndex >= path.size() || targets.empty()) {
+      return {};
+    }
+    size_t splice = egoIndex;
+    for (double length = 0.; splice + 1 < path.size() && length < keepDistance; ++splice) {
+      length += geometry::length2d(path[splice]);
+    }
+    for (auto candidate = splice + 1; candidate-- > egoIndex;) {
+      auto tail = routeThrough(path[candidate], targets);
+      if (tail.empty()) {
+        continue;
+      }
+      ConstLanelets lanelets(path.begin() + static_cast<std::ptrdiff_t>(egoIndex),
+                             path.begin() + static_cast<std::ptrdiff_t>(candidate));
+      lanelets.insert(lanelets.end(), tail.begin(), tail.end());
+      return delta(path, egoIndex, lanelets);
+    }
+    return {};
+  }
+
+ private:
+  //! path from start through all targets, empty if one of them can not be reached
+  ConstLanelets routeThrough(const ConstLanelet& start, const ConstLanelets& targets) {
+    ConstLanelets result{start};
+    for (const auto& target : targets) {
+      if (target == result.back()) {
+        continue;
+      }
+      auto leg = graph_->shortestPath(result.back(), target, state_, routingCostId_, withLaneChanges_);
+      if (!leg) {
+        return {};
+      }
+      result.insert(result.end(), std::next(leg->begin()), leg->end());
+    }
+    return result;
+  }
+
+  //! lanelets replaces old from egoIndex on
+  static RouteDelta delta(const LaneletPath& old, size_t egoIndex, const ConstLanelets& lanelets) {
+    RouteDelta result;
+    auto common = std::mismatch(old.begin() + static_cast<std::ptrdiff_t>(egoIndex), old.end(), lanelets.begin(),
+                                lanelets.end());
+    result.keptPrefix = static_cast<size_t>(common.first - old.begin());
+    result.removed.assign(common.first, old.end());
+    result.appended.assign(common.second, lanelets.end());
+    return result;
+  }
+
+  const FrozenRoutingGraph* graph_;
+  RoutingCostId routingCostId_;
+  bool withLaneChanges_;
+  RoutingSearchState state_;
+};
+
+}  // namespace routing
+}  // namespace lanelet
@@ -0,0 +1,207 @@
+#pragma once
+#include <lanelet2_core/geometry/BoundingBox.h>
+#include <lanelet2_core/geometry/Lanelet.h>
+#include <lanelet2_core/geometry/LineString.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "lanelet2_routing/Route.h"
+
+namespace lanelet {
+namespace routing {
+
+//! One section of a route: the lanelets side by side and the one the vehicle should prefer
+struct RouteSegment {
+  ConstLanelet preferred;
+  ConstLanelets lanelets;  //!< all lanelets of the section, including the preferred one
+};
+using RouteSegments = std::vector<RouteSegment>;
+
+/**
+ * @brief Flat, precomputed view on a route for per cycle queries.
+ *
+ * The lanelets of all segments are stored in one array, ordered by segment. Each entry knows its segment, whether it
+ * is the preferred lanelet and its left and right neighbour within the segment. The arc length s runs along the
+ * preferred lanelets, so "the lanelets between s = a and s = b" and "the segment at s" are binary searches instead of
+ * graph walks.
+ */
+class RouteIndex {
+ public:
+  static constexpr uint32_t None = std::numeric_limits<uint32_t>::max();
+
+  struct Entry {
+    ConstLanelet lanelet;
+    uint32_t segment;
+    bool preferred;
+    uint32_t left{None};   //!< entry of the lanelet left of this one in the same segment
+    uint32_t right{None};  //!< entry of the lanelet right of this one in the same segment
+    double length;         //!< 2d length of the centerline
+  };
+
+  explicit RouteIndex(const RouteSegments& segments) {
+    segmentBegin_.reserve(segments.size() + 1);
+    segmentS_.reserve(segments.size() + 1);
+    double s = 0.;
+    for (uint32_t seg = 0; seg < segments.size(); ++seg) {
+      const auto& segment = segments[seg];
+      segmentBegin_.push_back(static_cast<uint32_t>(entries_.size()));
+      segmentS_.push_back(s);
+      preferred_.push_back(None);
+      for (const auto& llt : segment.lanelets) {
+        const auto idx = static_cast<uint32_t>(entries_.size());
+        const bool preferred = llt == segment.preferred;
+        const auto centerline = llt.centerline2d();
+        centerlines_.emplace_back(centerline.basicBegin(), centerline.basicEnd());
+        const auto length = static_cast<double>(geometry::length(centerlines_.back()));
+        entries_.push_back({llt, seg, preferred, None, None, length});
+        boxes_.push_back(geometry::boundingBox2d(llt));
+        lookup_.emplace(llt, idx);
+        if (preferred) {
+          preferred_.back() = idx;
+        }
+      }
+      linkNeighbours(segmentBegin_.back(), static_cast<uint32_t>(entries_.size()));
+      s += preferred_.back() != None ? entries_[preferred_.back()].length : geometry::length2d(segment.preferred);
+    }
+    segmentBegin_.push_back(static_cast<uint32_t>(entries_.size()));
+    segmentS_.push_back(s);
+  }
+
+  /**
+   * @brief Segments from a lanelet2 route: one per lanelet of the shortest path, with the lanelets left and right of it
+   * in the route
+   */
+  static RouteSegments segments(const Route& route) {
+    RouteSegments result;
+    for (const auto& llt : route.shortestPath()) {
+      RouteSegment segment{llt, {}};
+      auto lefts = route.leftRelations(llt);
+      for (auto it = lefts.rbegin(); it != lefts.rend(); ++it) {
+        segment.lanelets.push_back(it->lanelet);
+      }
+      segment.lanelets.push_back(llt);
+      for (const auto& right : route.rightRelations(llt)) {
+        segment.lanelets.push_back(right.lanelet);
+      }
+      result.push_back(std::move(segment));
+    }
+    return result;
+  }
+
+  size_t size() const noexcept { return entries_.size(); }
+  const Entry& operator[](uint32_t idx) const { return entries_[idx]; }
+  //! 2d centerline of an entry in the direction of its lanelet, as plain points computed once
+  const BasicLineString2d& centerline2d(uint32_t idx) const { return centerlines_[idx]; }
+  size_t numSegments() const noexcept { return preferred_.size(); }
+  //! arc length of the whole route along the preferred lanelets
+  double length() const noexcept { return segmentS_.back(); }
+
+  //! entry of the lanelet or None if it is not on the route
+  uint32_t find(const ConstLanelet& llt) const {
+    auto it = lookup_.find(llt);
+    return it == lookup_.end() ? None : it->second;
+  }
+  bool contains(const ConstLanelet& llt) const { return find(llt) != None; }
+  bool isPreferred(const ConstLanelet& llt) const {
+    const auto idx = find(llt);
+    return idx != None && entries_[idx].preferred;
+  }
+
+  //! entries [begin, end) of a segment
+  std::pair<uint32_t, uint32_t> segmentEntries(uint32_t segment) const {
+    return {segmentBegin_[segment], segmentBegin_[segment + 1]};
+  }
+  //! entry of the preferred lanelet of a segment or None if the preferred lanelet is not part of the segment
+  uint32_t preferredEntry(uint32_t segment) const { return preferred_[segment]; }
+  //! arc length at the start of the segment
+  double segmentStart(uint32_t segment) const { return segmentS_[segment]; }
+
+  //! the segment containing the arc length s, clamped to the first and last segment
+  uint32_t segmentAt(double s) const {
+    if (numSegments() == 0) {
+      return None;
+    }
+    const auto it = std::upper_bound(segmentS_.begin(), segmentS_.end() - 1, s);
+    return static_cast<uint32_t>(std::max<std::ptrdiff_t>(std::distance(segmentS_.begin(), it) - 1, 0));
+  }
+
+  //! the preferred lanelets of the segments overlapping [from, to], in route order
+  ConstLanelets preferredSequence(double from, double to) const {
+    ConstLanelets result;
+    if (numSegments() == 0 || to < from) {
+      return result;
+    }
+    const auto last = segmentAt(to);
+    for (auto seg = segmentAt(from); seg <= last; ++seg) {
+      if (preferred_[seg] != None) {
+        result.push_back(entries_[preferred_[seg]].lanelet);
+      }
+    }
+    return result;
+  }
+
+  //! arc length of a point on a route lanelet. Positions on non preferred lanelets are scaled to the preferred one.
+  double arcLength(uint32_t entry, const BasicPoint2d& point) const {
+    const auto& e = entries_[entry];
+    const auto seg = e.segment;
+    const auto along = geometry::toArcCoordinates(centerlines_[entry], point).length;
+    const auto segmentLength = segmentS_[seg + 1] - segmentS_[seg];
+    const auto scale = e.length > 0. ? segmentLength / e.length : 0.;
+    return segmentS_[seg] + std::min(std::max(along * scale, 0.), segmentLength);
+  }
+
+  /**
+   * @brief the route lanelet closest to the point (distance 0 if inside), preferring lanelets of the preferred lane
+   * @return entry index or None if the route is empty
+   */
+  uint32_t closest(const BasicPoint2d& point) const {
+    uint32_t best = None;
+    double bestDist = std::numeric_limits<double>::infinity();
+    for (uint32_t i = 0; i < entries_.size(); ++i) {
+      if (boxDistance(boxes_[i], point) > bestDist) {
+        continue;
+      }
+      const auto dist = geometry::distance2d(entries_[i].lanelet, point);
+      if (dist < bestDist || (dist == bestDist && best != None && entries_[i].preferred && !entries_[best].preferred)) {
+        bestDist = dist;
+        best = i;
+      }
+    }
+    return best;
+  }
+
+ private:
+  static double boxDistance(const BoundingBox2d& box, const BasicPoint2d& p) {
+    const double dx = std::max(std::max(box.min().x() - p.x(), p.x() - box.max().x()), 0.);
+    const double dy = std::max(std::max(box.min().y() - p.y(), p.y() - box.max().y()), 0.);
+    return std::hypot(dx, dy);
+  }
+
+  //! neighbours share a bound: the left bound of a lanelet is the right bound of its left neighbour
+  void linkNeighbours(uint32_t begin, uint32_t end) {
+    for (auto i = begin; i < end; ++i) {
+      for (auto j = begin; j < end; ++j) {
+        if (i != j && entries_[i].lanelet.leftBound() == entries_[j].lanelet.rightBound()) {
+          entries_[i].left = j;
+          entries_[j].right = i;
+        }
+      }
+    }
+  }
+
+  std::vector<Entry> entries_;
+  std::vector<BoundingBox2d> boxes_;
+  std::vector<BasicLineString2d> centerlines_;  //!< 2d centerline of each entry as plain points
+  std::vector<uint32_t> segmentBegin_;  //!< first entry of each segment, plus the end
+  std::vector<double> segmentS_;        //!< arc length at the start of each segment, plus the total length
+  std::vector<uint32_t> preferred_;     //!< preferred entry of each segment
+  std::unordered_map<ConstLanelet, uint32_t> lookup_;
+};
+
+}  // namespace routing
+}  // namespace lanelet
@@ -0,0 +1,90 @@
+#pragma once
+#include <lanelet2_core/LaneletMap.h>
+#include <lanelet2_core/PackedRTree.h>
+#include <lanelet2_traffic_rules/TrafficRules.h>
+
+#include <memory>
+#include <unordered_set>
+
+#include "lanelet2_routing/RoutingCost.h"
+#include "lanelet2_routing/RoutingGraph.h"
+
+namespace lanelet {
+namespace routing {
+
+/**
+ * @brief A small map around a route with its own spatial index and routing graph.
+ *
+ * Contains the route lanelets, all lanelets beside them (with and without allowed lane change), their direct
+ * predecessors and successors and all lanelets sharing a bound with them, which includes shoulders and other lanelets
+ * that are not passable for the traffic rules of the graph. Built once when a route arrives, the per cycle lookups
+ * (neighbours, preferred lanes, shoulders, the lanelet of a pose) then run on a few hundred lanelets instead of the
+ * whole map.
+ */
+class RouteScope {
+ public:
+  /**
+   * @param routeLanelets lanelets of the route
+   * @param map the full map. The submap references its primitives, so it has to outlive the scope.
+   * @param graph routing graph of the full map, used to find the lanelets beside the route
+   * @param trafficRules and routingCosts for the routing graph of the scope
+   */
+  RouteScope(const ConstLanelets& routeLanelets, LaneletMap& map, const RoutingGraph& graph,
+             const traffic_rules::TrafficRules& trafficRules, const RoutingCostPtrs& routingCosts = defaultRoutingCosts())
+      : submap_{utils::createSubmap(collect(routeLanelets, map, graph))},
+        graph_{RoutingGraph::build(*submap_, trafficRules, routingCosts)},
+        index_{submap_->laneletLayer} {
+    for (const auto& llt : routeLanelets) {
+      route_.insert(llt.id());
+    }
+  }
+
+  //! The lanelets of the scope (only the lanelets, not their bounds or points)
+  const LaneletSubmap& submap() const noexcept { return *submap_; }
+  //! Routing graph restricted to the scope
+  const RoutingGraph& routingGraph() const noexcept { return *graph_; }
+  //! Spatial index over the lanelets of the scope, e.g. for geometry::findNearest
+  const PackedRTree<Lanelet>& laneletIndex() const noexcept { return index_; }
+
+  bool contains(const ConstLanelet& llt) const { return submap_->laneletLayer.exists(llt.id()); }
+  bool isRouteLanelet(const ConstLanelet& llt) const { return route_.count(llt.id()) > 0; }
+
+ private:
+  static Lanelets collect(const ConstLanelets& routeLanelets, LaneletMap& map, const RoutingGraph& graph) {
+    std::unordered_set<Id> ids;
+    Lanelets result;
+    auto add = [&](const ConstLanelet& llt) {
+      if (ids.insert(llt.id()).second && map.laneletLayer.exists(llt.id())) {
+        result.push_back(map.laneletLayer.get(llt.id()));
+      }
+    };
+    auto addAll = [&](const auto& lanelets) {
+      for (const auto& llt : lanelets) {
+        add(llt);
+      }
+    };
+    for (const auto& llt : routeLanelets) {
+      add(llt);
+      if (graph.passableSubmap()->laneletLayer.exists(llt.id())) {
+        for (const auto& beside : graph.besides(llt)) {
+          add(beside);
+          addAll(graph.following(beside));
+          addAll(graph.previous(beside));
+        }
+      }
+      addAll(map.laneletLayer.findUsages(llt.leftBound()));
+      addAll(map.laneletLayer.findUsages(llt.rightBound()));
+      addAll(map.laneletLayer.findUsages(llt.leftBound().invert()));
+      addAll(map.laneletLayer.findUsages(llt.rightBound().invert()));
+    }
+    return result;
+  }
+
+  LaneletSubmapUPtr submap_;
+  RoutingGraphUPtr graph_;
+  PackedRTree<Lanelet> index_;
+  std::unordered_set<Id> route_;
+};
+
+}  // namespace routing
+}  // namespace lanelet
@@ -5,6 +5,9 @@
 #include <lanelet2_core/primitives/Lanelet.h>
 
 #include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "lanelet2_routing/Route.h"
@@ -42,18 +45,31 @@ class RoutingGraphContainer {
     if (routingGraphId >= graphs_.size()) {
       throw InvalidInputError("Routing Graph ID is higher than the number of graphs.");
     }
-    auto overlaps = [lanelet, participantHeight](const ConstLanelet& ll) {
-      return participantHeight != .0 ? !geometry::overlaps3d(lanelet, ll, participantHeight)
-                                     : !geometry::overlaps2d(lanelet, ll);
-    };
-    const auto map{graphs_[routingGraphId]->passableSubmap()};
-    ConstLanelets conflicting{map->laneletLayer.search(geometry::boundingBox2d(lanelet))};
-    auto begin = conflicting.begin();
-    auto end = conflicting.end();
-    end = std::remove(begin, end, lanelet);
-    end = std::remove_if(begin, end, overlaps);
-    conflicting.erase(end, conflicting.end());
-    return conflicting;
+    if (const auto* table = conflictTable(routingGraphId, participantHeight)) {
+      auto it = table->index.find(lanelet);
+      if (it != table->index.end()) {
+        return table->get(it->second);
+      }
+    }
+    return computeConflictingInGraph(lanelet, routingGraphId, participantHeight);
+  }
+
+  /** @brief Precomputes conflictingInGraph for all lanelets of all graphs
+   *
+   *  Afterwards, conflictingInGraph and the functions based on it are a table lookup for these lanelets (in the
+   * direction they have in the map) and the given participant height. Other queries are still computed on the fly.
+   *  @param participantHeight Height the table is built for
+   *  @param lazy If true, the table of a graph is built on the first query for it instead of now. This is thread safe,
+   * concurrent queries wait for the table. Calling this function itself must not overlap with queries. */
+  void precomputeConflicts(double participantHeight = .0, bool lazy = false) {
+    conflictHeight_ = participantHeight;
+    conflictTables_.clear();
+    for (size_t i = 0; i < graphs_.size(); ++i) {
+      conflictTables_.push_back(std::make_shared<ConflictTable>());
+      if (!lazy) {
+        conflictTable(i, participantHeight);
+      }
+    }
   }
 
   /** @brief Find the conflicting lanelets of a given lanelet within all graphs
@@ -100,7 +116,73 @@ class RoutingGraphContainer {
   const std::vector<RoutingGraphConstPtr>& routingGraphs() const { return graphs_; }
 
  private:
+  //! Conflicts of every lanelet with one graph, as indices into the lanelets of that graph
+  struct ConflictTable {
+    std::once_flag built;
+    std::unordered_map<ConstLanelet, uint32_t> index;  //!< query lanelet -> row
+    std::vector<uint32_t> offsets;                     //!< row i is [offsets[i], offsets[i + 1]) of conflicts
+    std::vector<uint32_t> conflicts;
+    ConstLanelets lanelets;  //!< lanelets of the graph
+
+    ConstLanelets get(uint32_t row) const {
+      ConstLanelets result;
+      result.reserve(offsets[row + 1] - offsets[row]);
+      for (auto i = offsets[row]; i < offsets[row + 1]; ++i) {
+        result.push_back(lanelets[conflicts[i]]);
+      }
+      return result;
+    }
+  };
+
+  //! returns the table of the graph (building it if necessary) or nullptr if there is none for this height
+  const ConflictTable* conflictTable(size_t routingGraphId, double participantHeight) const {
+    if (routingGraphId >= conflictTables_.size() || participantHeight != conflictHeight_) {
+      return nullptr;
+    }
+    auto& table = *conflictTables_[routingGraphId];
+    std::call_once(table.built, [&] { buildConflictTable(table, routingGraphId); });
+    return &table;
+  }
+
+  void buildConflictTable(ConflictTable& table, size_t routingGraphId) const {
+    std::unordered_map<ConstLanelet, uint32_t> graphIndex;
+    for (const auto& llt : graphs_[routingGraphId]->passableSubmap()->laneletLayer) {
+      graphIndex.emplace(llt, static_cast<uint32_t>(table.lanelets.size()));
+      table.lanelets.emplace_back(llt);
+    }
+    table.offsets.push_back(0);
+    for (const auto& graph : graphs_) {
+      for (const auto& llt : graph->passableSubmap()->laneletLayer) {
+        if (!table.index.emplace(llt, static_cast<uint32_t>(table.offsets.size() - 1)).second) {
+          continue;  // already part of another graph
+        }
+        for (const auto& conflicting : computeConflictingInGraph(llt, routingGraphId, conflictHeight_)) {
+          table.conflicts.push_back(graphIndex.at(conflicting));
+        }
+        table.offsets.push_back(static_cast<uint32_t>(table.conflicts.size()));
+      }
+    }
+  }
+
+  ConstLanelets computeConflictingInGraph(const ConstLanelet& lanelet, size_t routingGraphId,
+                                          double participantHeight) const {
+    auto overlaps = [lanelet, participantHeight](const ConstLanelet& ll) {
+      return participantHeight != .0 ? !geometry::overlaps3d(lanelet, ll, participantHeight)
+                                     : !geometry::overlaps2d(lanelet, ll);
+    };
+    const auto map{graphs_[routingGraphId]->passableSubmap()};
+    ConstLanelets conflicting{map->laneletLayer.search(geometry::boundingBox2d(lanelet))};
+    auto begin = conflicting.begin();
+    auto end = conflicting.end();
+    end = std::remove(begin, end, lanelet);
+    end = std::remove_if(begin, end, overlaps);
+    conflicting.erase(end, conflicting.end());
+    return conflicting;
+  }
+
   std::vector<RoutingGraphConstPtr> graphs_;  ///< Routing graphs of the container.
+  std::vector<std::shared_ptr<ConflictTable>> conflictTables_;  ///< Precomputed conflicts per graph, if requested
+  double conflictHeight_{.0};                                 ///< Participant height of the conflict tables
 };
 
 }  // namespace routing
@@ -0,0 +1,226 @@
+#pragma once
+#include <lanelet2_core/Forward.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "lanelet2_routing/Exceptions.h"
+#include "lanelet2_routing/FrozenRoutingGraph.h"
+
+namespace lanelet {
+namespace routing {
+
+/**
+ * @brief Routing graph of a whole map without the map: lanelet ids, their centers and the edges of one routing cost.
+ *
+ * Extracted once from a FrozenRoutingGraph of the full map and saved next to the map tiles. A process that only
+ * holds the tiles around its route (lanelet2_io TiledLaneletMap) can still plan a route over the whole map with it
+ * and then load the tiles along the result. It costs a few dozen bytes per lanelet instead of the map.
+ */
+class RoutingSkeleton {
+ public:
+  static constexpr uint32_t InvalVertex = FrozenRoutingGraph::InvalVertex;
+
+  //! a lanelet on a skeleton path, in driving direction
+  struct Step {
+    Id id;
+    bool inverted;
+  };
+
+  RoutingSkeleton() = default;
+
+  explicit RoutingSkeleton(const FrozenRoutingGraph& graph, RoutingCostId costId = {}) {
+    const auto& layout = graph.layouts_.at(costId);
+    const auto n = graph.numVertices();
+    ids_.reserve(n);
+    inverted_.reserve(n);
+    for (const auto& llt : graph.vertices_) {
+      ids_.push_back(llt.id());
+      inverted_.push_back(llt.inverted() ? 1 : 0);
+    }
+    centers_ = graph.centers_;
+    offsets_ = layout.offsets;
+    targets_ = layout.targets;
+    costs_ = layout.costs;
+    successor_.reserve(layout.relations.size());
+    for (const auto relation : layout.relations) {
+      successor_.push_back(relation == RelationType::Successor ? 1 : 0);
+    }
+    heuristicScale_ = layout.heuristicScale;
+    buildLookup();
+  }
+
+  size_t numVertices() const noexcept { return ids_.size(); }
+  size_t numEdges() const noexcept { return targets_.size(); }
+  Id id(uint32_t v) const { return ids_[v]; }
+  bool inverted(uint32_t v) const { return inverted_[v] != 0; }
+  const BasicPoint2d& center(uint32_t v) const { return centers_[v]; }
+
+  //! vertex of the lanelet in the given orientation or InvalVertex if it is not passable
+  uint32_t vertex(Id id, bool inverted = false) const {
+    auto it = lookup_.find(id);
+    if (it == lookup_.end()) {
+      return InvalVertex;
+    }
+    for (const auto v : {it->second.first, it->second.second}) {
+      if (v != InvalVertex && this->inverted(v) == inverted) {
+        return v;
+      }
+    }
+    return InvalVertex;
+  }
+
+  //! Same path as FrozenRoutingGraph::shortestPath for the cost of this skeleton, empty if there is none
+  std::vector<Step> shortestPath(Id from, Id to, bool withLaneChanges = true) const {
+    RoutingSearchState state;
+    return shortestPath(Step{from, false}, Step{to, false}, state, withLaneChanges);
+  }
+
+  std::vector<Step> shortestPath(const Step& from, const Step& to, RoutingSearchState& state,
+                                 bool withLaneChanges = true) const {
+    const auto start = vertex(from.id, from.inverted);
+    const auto goal = vertex(to.id, to.inverted);
+    if (start == InvalVertex || goal == InvalVertex) {
+      return {};
+    }
+    auto heuristic = [&](uint32_t v) { return heuristicScale_ * (centers_[v] - centers_[goal]).norm(); };
+    state.reset(numVertices());
+    state.clearQueue();
+    state.open(start, 0., InvalVertex);
+    state.push(heuristic(start), start);
+    while (!state.queueEmpty()) {
+      const auto v = state.top().second;
+      state.pop();
+      if (state.closed(v)) {
+        continue;
+      }
+      if (v == goal) {
+        std::vector<Step> path;
+        for (auto w = goal; w != InvalVertex; w = state.predecessor(w)) {
+          path.push_back({ids_[w], inverted(w)});
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+      }
+      state.close(v);
+      const auto cost = state.cost(v);
+      for (auto e = offsets_[v]; e < offsets_[v + 1]; ++e) {
+        if (!withLaneChanges && successor_[e] == 0) {
+          continue;
+        }
+        const auto w = targets_[e];
+        const auto newCost = cost + costs_[e];
+        if (!state.closed(w) && newCost < state.cost(w)) {
+          state.open(w, newCost, v);
+          state.push(newCost + heuristic(w), w);
+        }
+      }
+    }
+    return {};
+  }
+
+  /**
+   * @param mapHash identifies the map version, checked by load()
+   * @throws ExportError if the file can not be written
+   */
+  void save(const std::string& filename, uint64_t mapHash) const {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) {
+      throw ExportError("Could not open " + filename + " for writing the routing skeleton");
+    }
+    const auto n = static_cast<uint32_t>(numVertices());
+    const auto m = static_cast<uint32_t>(numEdges());
+    out.write(Magic, sizeof(Magic));
+    writeRaw(out, &Version, 1);
+    writeRaw(out, &mapHash, 1);
+    writeRaw(out, &n, 1);
+    writeRaw(out, &m, 1);
+    writeRaw(out, &heuristicScale_, 1);
+    writeRaw(out, ids_.data(), n);
+    writeRaw(out, inverted_.data(), n);
+    writeRaw(out, centers_.data(), n);
+    writeRaw(out, offsets_.data(), offsets_.size());
+    writeRaw(out, targets_.data(), m);
+    writeRaw(out, costs_.data(), m);
+    writeRaw(out, successor_.data(), m);
+    if (!out) {
+      throw ExportError("Failed to write the routing skeleton to " + filename);
+    }
+  }
+
+  //! Restores a skeleton written by save(). Returns false if the file is missing, corrupt or for another mapHash.
+  bool load(const std::string& filename, uint64_t mapHash) {
+    std::ifstream in(filename, std::ios::binary);
+    char magic[sizeof(Magic)];
+    uint32_t version{};
+    uint64_t hash{};
+    uint32_t n{};
+    uint32_t m{};
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, Magic, sizeof(magic)) != 0 ||
+        !readRaw(in, &version, 1) || version != Version || !readRaw(in, &hash, 1) || hash != mapHash ||
+        !readRaw(in, &n, 1) || !readRaw(in, &m, 1)) {
+      return false;
+    }
+    RoutingSkeleton skeleton;
+    skeleton.ids_.resize(n);
+    skeleton.inverted_.resize(n);
+    skeleton.centers_.resize(n);
+    skeleton.offsets_.resize(size_t(n) + 1);
+    skeleton.targets_.resize(m);
+    skeleton.costs_.resize(m);
+    skeleton.successor_.resize(m);
+    if (!readRaw(in, &skeleton.heuristicScale_, 1) || !readRaw(in, skeleton.ids_.data(), n) ||
+        !readRaw(in, skeleton.inverted_.data(), n) || !readRaw(in, skeleton.centers_.data(), n) ||
+        !readRaw(in, skeleton.offsets_.data(), skeleton.offsets_.size()) ||
+        !readRaw(in, skeleton.targets_.data(), m) || !readRaw(in, skeleton.costs_.data(), m) ||
+        !readRaw(in, skeleton.successor_.data(), m) || skeleton.offsets_.front() != 0 ||
+        skeleton.offsets_.back() != m || !std::is_sorted(skeleton.offsets_.begin(), skeleton.offsets_.end()) ||
+        std::any_of(skeleton.targets_.begin(), skeleton.targets_.end(), [n](uint32_t t) { return t >= n; })) {
+      return false;
+    }
+    skeleton.buildLookup();
+    *this = std::move(skeleton);
+    return true;
+  }
+
+ private:
+  static constexpr char Magic[8] = {'L', 'L', '2', 'R', 'S', 'K', 'L', '\0'};
+  static constexpr uint32_t Version = 1;
+
+  template <typename T>
+  static void writeRaw(std::ostream& out, const T* data, size_t count) {
+    out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+  }
+  template <typename T>
+  static bool readRaw(std::istream& in, T* data, size_t count) {
+    return bool(in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(count * sizeof(T))));
+  }
+
+  void buildLookup() {
+    lookup_.clear();
+    lookup_.reserve(ids_.size());
+    for (uint32_t v = 0; v < ids_.size(); ++v) {
+      auto& entry = lookup_.emplace(ids_[v], std::make_pair(InvalVertex, InvalVertex)).first->second;
+      (entry.first == InvalVertex ? entry.first : entry.second) = v;
+    }
+  }
+
+  std::vector<Id> ids_;
+  std::vector<uint8_t> inverted_;
+  std::vector<BasicPoint2d> centers_;
+  std::vector<uint32_t> offsets_;  //!< edges of vertex v are [offsets_[v], offsets_[v + 1])
+  std::vector<uint32_t> targets_;
+  std::vector<double> costs_;
+  std::vector<uint8_t> successor_;  //!< 0 for lane changes
+  double heuristicScale_{0.};
+  std::unordered_map<Id, std::pair<uint32_t, uint32_t>> lookup_;  //!< id -> vertices of both orientations
+};
+
+}  // namespace routing
+}  // namespace lanelet
@@ -0,0 +1,287 @@
+#pragma once
+#include <lanelet2_core/geometry/LineString.h>
+#include <lanelet2_traffic_rules/TrafficRules.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "lanelet2_routing/RouteIndex.h"
+
+namespace lanelet {
+namespace routing {
+
+//! How SpeedLimitProfile derives the limits from the route
+struct SpeedLimitProfileParameters {
+  double maxLateralAcceleration{1.5};  //!< [m/s^2] curvature limit v = sqrt(a / |curvature|), <= 0 disables it
+  double minCurvatureSpeed{2.};        //!< [m/s] lower bound of the curvature limit
+  double curvatureBaseLength{3.};      //!< [m] min distance of the neighbours of the three point curvature
+  double speedResolution{0.1};         //!< [m/s] limits are rounded down to multiples of it, 0 keeps them exact
+};
+
+/**
+ * @brief Piecewise constant speed limit over the arc length of a route, for per cycle lookups in the velocity planners.
+ *
+ * Built once when the route arrives, from a RouteIndex and the traffic rules: the speed limit of the preferred lanelet
+ * of every segment (TrafficRules::speedLimit, so CachedTrafficRules makes the build cheap as well) and, where it is
+ * lower, the curvature limit sqrt(maxLateralAcceleration / |curvature|) of the centerlines of the preferred lanelets.
+ * The curvature is that of the circle through each centerline vertex and the vertices at least curvatureBaseLength
+ * before and after it, so densely sampled centerlines do not make it noisy. Adjacent pieces with the same (rounded)
+ * limit are merged, so the profile of a long route is a few hundred pieces.
+ *
+ * The profile is two flat arrays (breakpoints and limits) that can be published from the mission planner as they are
+ * and rebuilt downstream with the array constructor; the planners then never query lanelets or traffic rules for the
+ * speed limit. Each tick either looks up single arc lengths (at, O(log n)), merges a sorted series of arc lengths of
+ * the trajectory in one linear pass (sample), or walks forward with a Cursor.
+ *
+ * Arc lengths before the route and after its end take the limit of the first and last piece.
+ */
+class SpeedLimitProfile {
+ public:
+  enum class Source : uint8_t { TrafficRules, Curvature };
+
+  SpeedLimitProfile() = default;
+
+  SpeedLimitProfile(const RouteIndex& route, const traffic_rules::TrafficRules& rules,
+                    const SpeedLimitProfileParameters& params = {})
+      : params_{params} {
+    for (uint32_t seg = 0; seg < route.numSegments(); ++seg) {
+      const auto entry = route.preferredEntry(seg);
+      if (entry == RouteIndex::None) {
+        continue;
+      }
+      const auto limit = rules.speedLimit(route[entry].lanelet).speedLimit.value();
+      append(route.segmentStart(seg), limit, Source::TrafficRules);
+    }
+    if (params_.maxLateralAcceleration > 0.) {
+      applyCurvatureLimits(route);
+    }
+    merge();
+  }
+
+  //! rebuilds a profile from its arrays, e.g. after receiving them in a message
+  SpeedLimitProfile(std::vector<double> breakpoints, std::vector<double> limits, std::vector<Source> sources = {})
+      : s_{std::move(breakpoints)}, limit_{std::move(limits)}, source_{std::move(sources)} {
+    source_.resize(limit_.size(), Source::TrafficRules);
+  }
+
+  size_t size() const noexcept { return limit_.size(); }
+  bool empty() const noexcept { return limit_.empty(); }
+
+  //! start of each piece, ascending; piece i covers [breakpoints()[i], breakpoints()[i + 1])
+  const std::vector<double>& breakpoints() const noexcept { return s_; }
+  //! [m/s] limit of each piece
+  const std::vector<double>& limits() const noexcept { return limit_; }
+  //! which limit is the lower one in each piece
+  const std::vector<Source>& sources() const noexcept { return source_; }
+
+  //! piece containing the arc length s, clamped to the first and last piece
+  size_t pieceAt(double s) const {
+    const auto it = std::upper_bound(s_.begin(), s_.end(), s);
+    return static_cast<size_t>(std::max<std::ptrdiff_t>(std::distance(s_.begin(), it) - 1, 0));
+  }
+
+  //! [m/s] limit at the arc length s, infinity for an empty profile
+  double at(double s) const { return empty() ? std::numeric_limits<double>::infinity() : limit_[pieceAt(s)]; }
+
+  //! [m/s] lowest limit of the pieces overlapping [from, to]
+  double minBetween(double from, double to) const {
+    double result = std::numeric_limits<double>::infinity();
+    if (empty() || to < from) {
+      return result;
+    }
+    const auto last = pieceAt(to);
+    for (auto i = pieceAt(from); i <= last; ++i) {
+      result = std::min(result, limit_[i]);
+    }
+    return result;
+  }
+
+  /**
+   * @brief limits at the sorted arc lengths of e.g. trajectory points, in one pass over both
+   * @param limits resized to the size of sortedS
+   */
+  void sample(const std::vector<double>& sortedS, std::vector<double>& limits) const {
+    limits.resize(sortedS.size());
+    if (empty()) {
+      std::fill(limits.begin(), limits.end(), std::numeric_limits<double>::infinity());
+      return;
+    }
+    size_t piece = sortedS.empty() ? 0 : pieceAt(sortedS.front());
+    for (size_t i = 0; i < sortedS.size(); ++i) {
+      while (piece + 1 < s_.size() && s_[piece + 1] <= sortedS[i]) {
+        ++piece;
+      }
+      limits[i] = limit_[piece];
+    }
+  }
+
+  //! forward lookups for arc lengths that mostly increase; a step backwards falls back to the binary search
+  class Cursor {
+   public:
+    explicit Cursor(const SpeedLimitProfile& profile) : profile_{&profile} {}
+
+    double at(double s) {
+      const auto& bps = profile_->s_;
+      if (profile_->empty()) {
+        return std::numeric_limits<double>::infinity();
+      }
+      if (piece_ >= bps.size() || s < bps[piece_]) {
+        piece_ = profile_->pieceAt(s);
+      }
+      while (piece_ + 1 < bps.size() && bps[piece_ + 1] <= s) {
+        ++piece_;
+      }
+      return profile_->limit_[piece_];
+    }
+    size_t piece() const noexcept { return piece_; }
+
+   private:
+    const SpeedLimitProfile* profile_;
+    size_t piece_{0};
+  };
+
+ private:
+  struct Vertex {
+    BasicPoint2d point;
+    double s;
+  };
+
+  void append(double s, double limit, Source source) {
+    s_.push_back(s);
+    limit_.push_back(limit);
+    source_.push_back(source);
+  }
+
+  //! the centerline vertices of the preferred lanelets with their route arc length
+  static std::vector<Vertex> routeVertices(const RouteIndex& route) {
+    std::vector<Vertex> vertices;
+    for (uint32_t seg = 0; seg < route.numSegments(); ++seg) {
+      const auto entry = route.preferredEntry(seg);
+      if (entry == RouteIndex::None) {
+        continue;
+      }
+      const auto& centerline = route.centerline2d(entry);
+      const auto segmentLength = route.segmentStart(seg + 1) - route.segmentStart(seg);
+      const auto scale = route[entry].length > 0. ? segmentLength / route[entry].length : 0.;
+      double along = 0.;
+      for (size_t i = 0; i < centerline.size(); ++i) {
+        const BasicPoint2d& p = centerline[i];
+        if (i > 0) {
+          along += (p - centerline[i - 1]).norm();
+        }
+        if (!vertices.empty() && (vertices.back().point - p).norm() < 1e-6) {
+          continue;  // shared vertex of succeeding lanelets
+        }
+        vertices.push_back({p, route.segmentStart(seg) + along * scale});
+      }
+    }
+    return vertices;
+  }
+
+  //! inserts a piece for every vertex whose curvature limit is below the traffic rule limit
+  void applyCurvatureLimits(const RouteIndex& route) {
+    const auto vertices = routeVertices(route);
+    if (vertices.size() < 3 || empty()) {
+      return;
+    }
+    std::vector<double> s;
+    std::vector<double> limit;
+    std::vector<Source> source;
+    size_t prev = 0;
+    size_t next = 0;
+    size_t piece = 0;
+    for (size_t i = 1; i + 1 < vertices.size(); ++i) {
+      while (prev + 1 < i && vertices[i].s - vertices[prev + 1].s >= params_.curvatureBaseLength) {
+        ++prev;
+      }
+      next = std::max(next, i + 1);
+      while (next + 1 < vertices.size() && vertices[next].s - vertices[i].s < params_.curvatureBaseLength) {
+        ++next;
+      }
+      const double from = 0.5 * (vertices[i - 1].s + vertices[i].s);
+      const double to = 0.5 * (vertices[i].s + vertices[i + 1].s);
+      // traffic rule pieces starting before this vertex
+      while (piece < s_.size() && s_[piece] <= from) {
+        s.push_back(s_[piece]);
+        limit.push_back(limit_[piece]);
+        source.push_back(source_[piece]);
+        ++piece;
+      }
+      // rule limits in [from, to): before the vertex and of the pieces starting around it (segment boundaries)
+      double lowest = limit_[piece == 0 ? 0 : piece - 1];
+      double highest = lowest;
+      double after = lowest;
+      size_t inner = piece;
+      for (; inner < s_.size() && s_[inner] < to; ++inner) {
+        after = limit_[inner];
+        lowest = std::min(lowest, after);
+        highest = std::max(highest, after);
+      }
+      const double curvature =
+          std::abs(threePointCurvature(vertices[prev].point, vertices[i].point, vertices[next].point));
+      const double curvatureSpeed =
+          std::max(std::sqrt(params_.maxLateralAcceleration / std::max(curvature, 1e-9)), params_.minCurvatureSpeed);
+      if (curvatureSpeed < highest) {
+        // the curvature piece replaces the rule pieces starting inside it and takes the lowest of all limits
+        s.push_back(from);
+        limit.push_back(std::min(curvatureSpeed, lowest));
+        source.push_back(curvatureSpeed < lowest ? Source::Curvature : Source::TrafficRules);
+        s.push_back(to);
+        limit.push_back(after);
+        source.push_back(Source::TrafficRules);
+        piece = inner;
+      }
+    }
+    for (; piece < s_.size(); ++piece) {
+      s.push_back(s_[piece]);
+      limit.push_back(limit_[piece]);
+      source.push_back(source_[piece]);
+    }
+    s_ = std::move(s);
+    limit_ = std::move(limit);
+    source_ = std::move(source);
+  }
+
+  //! rounds the limits down to speedResolution and merges adjacent pieces with the same limit
+  void merge() {
+    size_t out = 0;
+    for (size_t i = 0; i < limit_.size(); ++i) {
+      double limit = limit_[i];
+      if (params_.speedResolution > 0. && std::isfinite(limit)) {
+        limit = std::floor(limit / params_.speedResolution + 1e-9) * params_.speedResolution;
+      }
+      if (out > 0 && s_[i] <= s_[out - 1]) {
+        --out;  // the previous piece is empty
+      }
+      if (out > 0 && limit == limit_[out - 1]) {
+        continue;
+      }
+      s_[out] = s_[i];
+      limit_[out] = limit;
+      source_[out] = source_[i];
+      ++out;
+    }
+    s_.resize(out);
+    limit_.resize(out);
+    source_.resize(out);
+  }
+
+  static double threePointCurvature(const BasicPoint2d& a, const BasicPoint2d& b, const BasicPoint2d& c) {
+    const BasicPoint2d ab = b - a;
+    const BasicPoint2d bc = c - b;
+    const BasicPoint2d ac = c - a;
+    const double denominator = std::sqrt(ab.squaredNorm() * bc.squaredNorm() * ac.squaredNorm());
+    return denominator > 1e-12 ? 2. * (ab.x() * bc.y() - ab.y() * bc.x()) / denominator : 0.;
+  }
+
+  SpeedLimitProfileParameters params_;
+  std::vector<double> s_;
+  std::vector<double> limit_;
+  std::vector<Source> source_;
+};
+
+}  // namespace routing
+}  // namespace lanelet
@@ -0,0 +1,153 @@
+#pragma once
+#include <lanelet2_core/LaneletMap.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "lanelet2_traffic_rules/TrafficRules.h"
+
+namespace lanelet {
+namespace traffic_rules {
+
+/**
+ * @brief Traffic rules with the per lanelet answers of another TrafficRules object precomputed for one map.
+ *
+ * GenericTrafficRules parses attribute strings and walks the regulatory elements on every call, and the routing graph
+ * builder and the planners ask the same questions for the same lanelets over and over. This wrapper asks the wrapped
+ * rules once per lanelet of the map (both orientations) and keeps speed limit, passability, one way and dynamic rule
+ * flags and the lane change permissions towards the lanelets sharing the left and right bound in a table. Queries are
+ * a hash lookup of the lanelet id plus an array access.
+ *
+ * canPass(from, to) rejects from the table if one of the lanelets is not passable and asks the wrapped rules for the
+ * adjacency check otherwise. Lanelets of other maps, areas and everything else are forwarded unchanged. The table is a
+ * snapshot: rebuild it when the map or the wrapped rules change. The map and the wrapped rules must outlive this
+ * object.
+ */
+class CachedTrafficRules : public TrafficRules {  // NOLINT
+ public:
+  CachedTrafficRules(TrafficRulesPtr rules, const LaneletMap& map)
+      : TrafficRules(rules->configuration()), rules_{std::move(rules)} {
+    entries_.reserve(map.laneletLayer.size());
+    lookup_.reserve(map.laneletLayer.size());
+    for (const auto& llt : map.laneletLayer) {
+      const ConstLanelet lanelet = llt;
+      Entry entry;
+      entry.lanelet = lanelet;
+      entry.speedLimit = rules_->speedLimit(lanelet);
+      entry.flags = static_cast<uint8_t>((rules_->canPass(lanelet) ? CanPass : 0) |
+                                         (rules_->canPass(lanelet.invert()) ? CanPassInverted : 0) |
+                                         (rules_->isOneWay(lanelet) ? OneWay : 0) |
+                                         (rules_->hasDynamicRules(lanelet) ? DynamicRules : 0));
+      for (const bool inverted : {false, true}) {
+        const auto from = inverted ? lanelet.invert() : lanelet;
+        entry.left[inverted] = neighbour(map, from, from.leftBound(), true);
+        entry.right[inverted] = neighbour(map, from, from.rightBound(), false);
+      }
+      lookup_.emplace(lanelet.id(), static_cast<uint32_t>(entries_.size()));
+      entries_.push_back(std::move(entry));
+    }
+  }
+
+  bool canPass(const ConstLanelet& lanelet) const override {
+    const auto* entry = find(lanelet);
+    return entry != nullptr ? (entry->flags & (lanelet.inverted() ? CanPassInverted : CanPass)) != 0
+                            : rules_->canPass(lanelet);
+  }
+  bool canPass(const ConstArea& area) const override { return rules_->canPass(area); }
+
+  bool canPass(const ConstLanelet& from, const ConstLanelet& to) const override {
+    const auto* fromEntry = find(from);
+    const auto* toEntry = find(to);
+    if ((fromEntry != nullptr && !canPass(from)) || (toEntry != nullptr && !canPass(to))) {
+      return false;
+    }
+    return rules_->canPass(from, to);
+  }
+  bool canPass(const ConstLanelet& from, const ConstArea& to) const override { return rules_->canPass(from, to); }
+  bool canPass(const ConstArea& from, const ConstLanelet& to) const override { return rules_->canPass(from, to); }
+  bool canPass(const ConstArea& from, const ConstArea& to) const override { return rules_->canPass(from, to); }
+
+  bool canChangeLane(const ConstLanelet& from, const ConstLanelet& to) const override {
+    if (const auto* entry = find(from)) {
+      for (const auto* side : {&entry->left[from.inverted()], &entry->right[from.inverted()]}) {
+        if (side->lanelet && *side->lanelet == to) {
+          return side->canChange;
+        }
+      }
+    }
+    return rules_->canChangeLane(from, to);
+  }
+
+  SpeedLimitInformation speedLimit(const ConstLanelet& lanelet) const override {
+    const auto* entry = find(lanelet);
+    return entry != nullptr ? entry->speedLimit : rules_->speedLimit(lanelet);
+  }
+  SpeedLimitInformation speedLimit(const ConstArea& area) const override { return rules_->speedLimit(area); }
+
+  bool isOneWay(const ConstLanelet& lanelet) const override {
+    const auto* entry = find(lanelet);
+    return entry != nullptr ? (entry->flags & OneWay) != 0 : rules_->isOneWay(lanelet);
+  }
+
+  bool hasDynamicRules(const ConstLanelet& lanelet) const override {
+    const auto* entry = find(lanelet);
+    return entry != nullptr ? (entry->flags & DynamicRules) != 0 : rules_->hasDynamicRules(lanelet);
+  }
+
+  //! the wrapped rules
+  const TrafficRules& rules() const noexcept { return *rules_; }
+  //! number of cached lanelets
+  size_t size() const noexcept { return entries_.size(); }
+
+ private:
+  enum Flags : uint8_t { CanPass = 1, CanPassInverted = 2, OneWay = 4, DynamicRules = 8 };
+
+  //! lanelet beside a bound and whether changing to it is allowed
+  struct Neighbour {
+    Optional<ConstLanelet> lanelet;
+    bool canChange{false};
+  };
+
+  struct Entry {
+    ConstLanelet lanelet;
+    SpeedLimitInformation speedLimit;
+    uint8_t flags{0};
+    Neighbour left[2];  //!< indexed by the orientation of the lanelet
+    Neighbour right[2];
+  };
+
+  //! the table entry or nullptr if the lanelet is not part of the cached map
+  const Entry* find(const ConstLanelet& lanelet) const {
+    auto it = lookup_.find(lanelet.id());
+    if (it == lookup_.end() || entries_[it->second].lanelet.constData() != lanelet.constData()) {
+      return nullptr;
+    }
+    return &entries_[it->second];
+  }
+
+  //! the lanelet that has the bound on its other side, in the orientation that continues along from
+  Neighbour neighbour(const LaneletMap& map, const ConstLanelet& from, const ConstLineString3d& bound,
+                      bool left) const {
+    Neighbour result;
+    for (const auto& usage : map.laneletLayer.findUsages(bound)) {
+      for (const auto& candidate : {usage, usage.invert()}) {
+        if (candidate.constData() != from.constData() &&
+            (left ? candidate.rightBound() : candidate.leftBound()) == bound) {
+          result.lanelet = candidate;
+          result.canChange = rules_->canChangeLane(from, candidate);
+          return result;
+        }
+      }
+    }
+    return result;
+  }
+
+  TrafficRulesPtr rules_;
+  std::vector<Entry> entries_;
+  std::unordered_map<Id, uint32_t> lookup_;
+};
+
+}  // namespace traffic_rules
+}  // namespace lanelet
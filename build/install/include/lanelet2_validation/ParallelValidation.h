@@ -0,0 +1,347 @@
+#pragma once
+#include <lanelet2_core/LaneletMap.h>
+#include <lanelet2_core/geometry/Area.h>
+#include <lanelet2_core/geometry/Lanelet.h>
+#include <lanelet2_core/geometry/Polygon.h>
+#include <lanelet2_core/geometry/RegulatoryElement.h>
+#include <lanelet2_io/Io.h>
+#include <lanelet2_projection/UTM.h>
+#include <lanelet2_routing/RoutingGraph.h>
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <iterator>
+#include <regex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "lanelet2_validation/Validation.h"
+#include "lanelet2_validation/ValidatorFactory.h"
+
+namespace lanelet {
+namespace validation {
+namespace internal {
+
+//! the comma separated checks filter of ValidationConfig as regexes, as the sequential validateMap does
+inline Regexes parseFilter(const std::string& filter) {
+  Regexes regexes;
+  std::string::size_type begin = 0;
+  while (begin < filter.size()) {
+    auto end = filter.find(',', begin);
+    end = end == std::string::npos ? filter.size() : end;
+    if (end > begin) {
+      regexes.emplace_back(filter.substr(begin, end - begin));
+    }
+    begin = end + 1;
+  }
+  return regexes;
+}
+
+inline void appendIssues(std::vector<DetectedIssues>& result, std::string name, Issues issues) {
+  if (!issues.empty()) {
+    result.emplace_back(std::move(name), std::move(issues));
+  }
+}
+
+inline std::unique_ptr<LaneletMap> loadForValidation(const std::string& mapFilename, const ValidationConfig& config,
+                                                     std::vector<DetectedIssues>* issues) {
+  ErrorMessages errors;
+  std::unique_ptr<LaneletMap> map;
+  try {
+    projection::UtmProjector projector(Origin(config.origin));
+    map = load(mapFilename, projector, &errors);
+  } catch (LaneletError& err) {
+    errors.emplace_back(err.what());
+  }
+  if (issues != nullptr) {
+    appendIssues(*issues, "general",
+                 utils::transform(errors, [](const auto& error) { return Issue(Severity::Error, error); }));
+  }
+  return map;
+}
+}  // namespace internal
+
+/**
+ * @brief Parallel variant of validateMap(mapFilename, config) with the same checks and the same issues.
+ *
+ * Every map validator, every traffic rule validator and the routing graph validators of each participant (building
+ * the routing graph included) are one task, the tasks are distributed over numThreads workers. The validators and the
+ * map interfaces they use have lazily filled caches (attributes, centerlines) that are not safe for concurrent use, so
+ * every worker loads its own copy of the map (in parallel, the wall time of loading stays the same, the memory grows
+ * with the number of workers). The issues are returned in task order, independent of the scheduling.
+ */
+inline std::vector<DetectedIssues> validateMapParallel(const std::string& mapFilename, const ValidationConfig& config,
+                                                       size_t numThreads = std::thread::hardware_concurrency()) {
+  std::vector<DetectedIssues> result;
+  auto map = internal::loadForValidation(mapFilename, config, &result);
+  if (!map) {
+    return result;
+  }
+
+  const auto regexes = internal::parseFilter(config.checksFilter);
+  auto& factory = ValidatorFactory::instance();
+  auto mapValidators = factory.createMapValidators(regexes);
+  auto ruleValidators = factory.createTrafficRuleValidators(regexes);
+  std::vector<ValidatorsWithName<RoutingGraphValidator>> graphValidators;
+  for (size_t i = 0; i < config.participants.size(); ++i) {
+    graphValidators.push_back(factory.createRoutingGraphValidators(regexes));
+    if (graphValidators.back().empty()) {
+      graphValidators.clear();
+      break;
+    }
+  }
+
+  const size_t numTasks = mapValidators.size() + ruleValidators.size() + graphValidators.size();
+  std::vector<std::vector<DetectedIssues>> taskIssues(numTasks);
+  const auto runTask = [&](size_t task, const LaneletMap& laneletMap) {
+    auto& issues = taskIssues[task];
+    if (task < mapValidators.size()) {
+      auto& validator = mapValidators[task];
+      internal::appendIssues(issues, validator.first, (*validator.second)(laneletMap));
+      return;
+    }
+    task -= mapValidators.size();
+    if (task < ruleValidators.size()) {
+      std::vector<traffic_rules::TrafficRulesUPtr> rules;
+      for (const auto& participant : config.participants) {
+        rules.push_back(traffic_rules::TrafficRulesFactory::create(config.location, participant));
+      }
+      auto& validator = ruleValidators[task];
+      internal::appendIssues(issues, validator.first, (*validator.second)(laneletMap, rules));
+      return;
+    }
+    task -= ruleValidators.size();
+    auto rules = traffic_rules::TrafficRulesFactory::create(config.location, config.participants[task]);
+    auto graph = routing::RoutingGraph::build(laneletMap, *rules);
+    for (auto& validator : graphValidators[task]) {
+      internal::appendIssues(issues, validator.first, (*validator.second)(*graph, *rules));
+    }
+  };
+
+  std::atomic<size_t> nextTask{0};
+  const auto worker = [&](const LaneletMap* laneletMap) {
+    std::unique_ptr<LaneletMap> ownMap;
+    for (size_t task = nextTask++; task < numTasks; task = nextTask++) {
+      if (laneletMap == nullptr) {  // load lazily, a worker that gets no task does not need a map
+        ownMap = internal::loadForValidation(mapFilename, config, nullptr);
+        if (!ownMap) {
+          throw LaneletError("Failed to load another copy of " + mapFilename + " for parallel validation");
+        }
+        laneletMap = ownMap.get();
+      }
+      runTask(task, *laneletMap);
+    }
+  };
+  const auto numWorkers = std::max<size_t>(1, std::min(numThreads, numTasks));
+  std::vector<std::future<void>> futures;
+  for (size_t i = 1; i < numWorkers; ++i) {
+    futures.push_back(std::async(std::launch::async, worker, nullptr));
+  }
+  worker(map.get());
+  for (auto& future : futures) {
+    future.get();
+  }
+  for (auto& issues : taskIssues) {
+    std::move(issues.begin(), issues.end(), std::back_inserter(result));
+  }
+  return result;
+}
+
+namespace internal {
+inline bool sameAttributes(const AttributeMap& lhs, const AttributeMap& rhs) {
+  return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](const auto& l, const auto& r) {
+           return l.first == r.first && l.second.value() == r.second.value();
+         });
+}
+
+template <typename LineStringT>
+bool samePointIds(const LineStringT& lhs, const LineStringT& rhs) {
+  return lhs.size() == rhs.size() &&
+         std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](const auto& l, const auto& r) { return l.id() == r.id(); });
+}
+
+inline bool sameBound(const ConstLineString3d& lhs, const ConstLineString3d& rhs) {
+  return lhs.id() == rhs.id() && lhs.inverted() == rhs.inverted();
+}
+
+inline bool sameBounds(const ConstLineStrings3d& lhs, const ConstLineStrings3d& rhs) {
+  return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), sameBound);
+}
+
+inline bool sameRegulatoryElements(const RegulatoryElementConstPtrs& lhs, const RegulatoryElementConstPtrs& rhs) {
+  return lhs.size() == rhs.size() &&
+         std::equal(lhs.begin(), lhs.end(), rhs.begin(),
+                    [](const auto& l, const auto& r) { return l->id() == r->id(); });
+}
+
+//! role and id of each parameter, in order
+inline std::vector<std::pair<std::string, Id>> parameterIds(const RegulatoryElement& regElem) {
+  struct IdVisitor : boost::static_visitor<Id> {
+    Id operator()(const ConstPoint3d& p) const { return p.id(); }
+    Id operator()(const ConstLineString3d& ls) const { return ls.id(); }
+    Id operator()(const ConstPolygon3d& poly) const { return poly.id(); }
+    Id operator()(const ConstWeakLanelet& llt) const { return llt.expired() ? InvalId : llt.lock().id(); }
+    Id operator()(const ConstWeakArea& area) const { return area.expired() ? InvalId : area.lock().id(); }
+  };
+  std::vector<std::pair<std::string, Id>> ids;
+  for (const auto& role : regElem.getParameters()) {
+    for (const auto& param : role.second) {
+      ids.emplace_back(role.first, boost::apply_visitor(IdVisitor(), param));
+    }
+  }
+  return ids;
+}
+
+inline bool sameContent(const ConstPoint3d& lhs, const ConstPoint3d& rhs) {
+  return lhs.basicPoint() == rhs.basicPoint() && sameAttributes(lhs.attributes(), rhs.attributes());
+}
+inline bool sameContent(const ConstLineString3d& lhs, const ConstLineString3d& rhs) {
+  return samePointIds(lhs, rhs) && sameAttributes(lhs.attributes(), rhs.attributes());
+}
+inline bool sameContent(const ConstPolygon3d& lhs, const ConstPolygon3d& rhs) {
+  return samePointIds(lhs, rhs) && sameAttributes(lhs.attributes(), rhs.attributes());
+}
+inline bool sameContent(const ConstLanelet& lhs, const ConstLanelet& rhs) {
+  return lhs.inverted() == rhs.inverted() && sameBound(lhs.leftBound(), rhs.leftBound()) &&
+         sameBound(lhs.rightBound(), rhs.rightBound()) && sameAttributes(lhs.attributes(), rhs.attributes()) &&
+         sameRegulatoryElements(lhs.regulatoryElements(), rhs.regulatoryElements());
+}
+inline bool sameContent(const ConstArea& lhs, const ConstArea& rhs) {
+  const auto lhsInner = lhs.innerBounds();
+  const auto rhsInner = rhs.innerBounds();
+  return sameBounds(lhs.outerBound(), rhs.outerBound()) && lhsInner.size() == rhsInner.size() &&
+         std::equal(lhsInner.begin(), lhsInner.end(), rhsInner.begin(), sameBounds) &&
+         sameAttributes(lhs.attributes(), rhs.attributes()) &&
+         sameRegulatoryElements(lhs.regulatoryElements(), rhs.regulatoryElements());
+}
+inline bool sameContent(const RegulatoryElementConstPtr& lhs, const RegulatoryElementConstPtr& rhs) {
+  return sameAttributes(lhs->attributes(), rhs->attributes()) && parameterIds(*lhs) == parameterIds(*rhs);
+}
+
+inline Id idOf(const RegulatoryElementConstPtr& regElem) { return regElem->id(); }
+template <typename PrimT>
+Id idOf(const PrimT& prim) {
+  return prim.id();
+}
+
+inline BoundingBox2d region(const ConstPoint3d& p) { return BoundingBox2d(p.basicPoint2d()); }
+inline BoundingBox2d region(const ConstLineString3d& ls) { return geometry::boundingBox2d(utils::to2D(ls)); }
+inline BoundingBox2d region(const ConstPolygon3d& poly) { return geometry::boundingBox2d(utils::to2D(poly)); }
+inline BoundingBox2d region(const ConstLanelet& llt) { return geometry::boundingBox2d(llt); }
+inline BoundingBox2d region(const ConstArea& area) { return geometry::boundingBox2d(area); }
+inline BoundingBox2d region(const RegulatoryElementConstPtr& regElem) { return geometry::boundingBox2d(regElem); }
+
+//! regions of the primitives that were added, removed or changed between the layers
+template <typename LayerT>
+void diffLayer(const LayerT& previous, const LayerT& current, std::vector<BoundingBox2d>& regions) {
+  const auto addRegion = [&regions](const BoundingBox2d& box) {
+    if (!box.isEmpty()) {
+      regions.push_back(box);
+    }
+  };
+  for (const auto& prim : current) {
+    const auto old = previous.find(idOf(prim));
+    if (old == previous.end()) {
+      addRegion(region(prim));
+    } else if (!sameContent(*old, prim)) {
+      addRegion(region(prim));
+      addRegion(region(*old));  // the primitive may have moved
+    }
+  }
+  for (const auto& prim : previous) {
+    if (!current.exists(idOf(prim))) {
+      addRegion(region(prim));
+    }
+  }
+}
+}  // namespace internal
+
+/**
+ * @brief 2d regions in which current differs from previous
+ *
+ * Primitives are matched by id. A primitive counts as changed if its own data differs: coordinates and attributes of
+ * points, point ids of line strings and polygons, bound ids, attributes and regulatory element ids of lanelets and
+ * areas, attributes and parameter ids of regulatory elements. Each added, removed or changed primitive contributes its
+ * bounding box (changed ones in both versions). Moving a point changes only the point, its users are covered by the
+ * margin of validateMapIncremental.
+ */
+inline std::vector<BoundingBox2d> changedRegions(const LaneletMap& previous, const LaneletMap& current) {
+  std::vector<BoundingBox2d> regions;
+  internal::diffLayer(previous.pointLayer, current.pointLayer, regions);
+  internal::diffLayer(previous.lineStringLayer, current.lineStringLayer, regions);
+  internal::diffLayer(previous.polygonLayer, current.polygonLayer, regions);
+  internal::diffLayer(previous.laneletLayer, current.laneletLayer, regions);
+  internal::diffLayer(previous.areaLayer, current.areaLayer, regions);
+  internal::diffLayer(previous.regulatoryElementLayer, current.regulatoryElementLayer, regions);
+  return regions;
+}
+
+/**
+ * @brief Map with all primitives of map whose bounding box intersects one of the regions, grown by margin.
+ *
+ * Lanelets and areas come with their bounds and regulatory elements (see utils::createMap), line strings, polygons and
+ * points that are not part of one are added as well. The primitives are shared with map, not copied.
+ */
+inline LaneletMapUPtr extractRegions(LaneletMap& map, const std::vector<BoundingBox2d>& regions, double margin) {
+  Lanelets lanelets;
+  Areas areas;
+  LineStrings3d lineStrings;
+  Polygons3d polygons;
+  Points3d points;
+  const auto append = [](auto& to, auto&& from) {
+    for (auto& prim : from) {
+      if (std::find(to.begin(), to.end(), prim) == to.end()) {
+        to.push_back(prim);
+      }
+    }
+  };
+  for (const auto& region : regions) {
+    const BoundingBox2d box(region.min() - BasicPoint2d(margin, margin), region.max() + BasicPoint2d(margin, margin));
+    append(lanelets, map.laneletLayer.search(box));
+    append(areas, map.areaLayer.search(box));
+    append(lineStrings, map.lineStringLayer.search(box));
+    append(polygons, map.polygonLayer.search(box));
+    append(points, map.pointLayer.search(box));
+  }
+  auto submap = utils::createMap(lanelets, areas);
+  for (auto& ls : lineStrings) {
+    if (!submap->lineStringLayer.exists(ls.id())) {
+      submap->add(ls);
+    }
+  }
+  for (auto& poly : polygons) {
+    if (!submap->polygonLayer.exists(poly.id())) {
+      submap->add(poly);
+    }
+  }
+  for (auto& p : points) {
+    if (!submap->pointLayer.exists(p.id())) {
+      submap->add(p);
+    }
+  }
+  return submap;
+}
+
+/**
+ * @brief Validates only the part of map that changed with respect to previous.
+ *
+ * The changed regions (changedRegions) are grown by margin, all primitives in them are extracted (extractRegions) and
+ * validated with validateMap. The margin has to cover the context the checks need, e.g. the neighbours and successors
+ * of a changed lanelet for the routing graph checks. Issues of unchanged primitives inside the margin are reported
+ * again, and issues at the border of the extracted part (e.g. lanelets whose successor is outside) can show up that
+ * the full map does not have. Returns no issues if the maps do not differ.
+ */
+inline std::vector<DetectedIssues> validateMapIncremental(LaneletMap& map, const LaneletMap& previous,
+                                                          const ValidationConfig& config, double margin = 50.) {
+  const auto regions = changedRegions(previous, map);
+  if (regions.empty()) {
+    return {};
+  }
+  auto submap = extractRegions(map, regions, margin);
+  return validateMap(*submap, config);
+}
+
+}  // namespace validation
+}  // namespace lanelet
@@ -0,0 +1,198 @@
+// Per-stage latency tracing for the planning pipeline
+#ifndef PATH_OPTIMIZER__LATENCY_TRACER_HPP_
+#define PATH_OPTIMIZER__LATENCY_TRACER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * LatencyTracer: records stage enter/exit stamps per input sample and writes them to a trace file
+ *
+ * Every sample is identified by its origin stamp (the header stamp set by the first stage, e.g.
+ * ServiceCreator), which all later stages copy into their outputs. A stage records one event per
+ * processed sample: origin, enter and exit time in nanoseconds of the system clock. Joining the
+ * events of all stages by origin gives per-stage processing time and the queueing time between
+ * stages (enter of a stage minus exit of the previous one); tool/analyze_stage_latency.py does
+ * that and reports p50/p99.
+ *
+ * record() is lock free and never blocks: events go into a bounded multi-producer ring buffer
+ * that a background thread drains into a JSON lines file. Events are dropped (and counted) if
+ * the buffer is full.
+ */
+class LatencyTracer
+{
+public:
+  struct Event
+  {
+    const char * stage{nullptr};  // must point to a string with static storage duration
+    int64_t origin_ns{0};
+    int64_t enter_ns{0};
+    int64_t exit_ns{0};
+  };
+
+  /**
+   * @param path trace file, opened for appending
+   * @param capacity ring buffer size, rounded up to a power of two
+   */
+  explicit LatencyTracer(const std::string & path, const size_t capacity = 1U << 14U)
+  : file_(path, std::ios::app)
+  {
+    size_t size = 2;
+    while (size < capacity) {
+      size <<= 1U;
+    }
+    mask_ = size - 1;
+    slots_ = std::make_unique<Slot[]>(size);
+    for (size_t i = 0; i < size; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    writer_ = std::thread([this] { writerLoop(); });
+  }
+
+  LatencyTracer(const LatencyTracer &) = delete;
+  LatencyTracer & operator=(const LatencyTracer &) = delete;
+
+  ~LatencyTracer()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_one();
+    writer_.join();
+  }
+
+  static int64_t now()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+  }
+
+  static int64_t toNanoseconds(const int32_t sec, const uint32_t nanosec)
+  {
+    return static_cast<int64_t>(sec) * 1000000000LL + nanosec;
+  }
+
+  // Returns false if the event was dropped because the buffer is full
+  bool record(const Event & event)
+  {
+    size_t pos = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot & slot = slots_[pos & mask_];
+      const size_t seq = slot.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          slot.event = event;
+          slot.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Number of events dropped so far
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+  // Records enter at construction and exit at destruction
+  class Scope
+  {
+  public:
+    Scope(LatencyTracer * tracer, const char * stage, const int64_t origin_ns)
+    : tracer_(tracer), event_{stage, origin_ns, now(), 0}
+    {
+    }
+    Scope(const Scope &) = delete;
+    Scope & operator=(const Scope &) = delete;
+    ~Scope()
+    {
+      if (tracer_) {
+        event_.exit_ns = now();
+        tracer_->record(event_);
+      }
+    }
+
+  private:
+    LatencyTracer * tracer_;
+    Event event_;
+  };
+
+private:
+  struct Slot
+  {
+    std::atomic<size_t> sequence{0};
+    Event event;
+  };
+
+  bool pop(Event & event)
+  {
+    Slot & slot = slots_[tail_ & mask_];
+    if (slot.sequence.load(std::memory_order_acquire) != tail_ + 1) {
+      return false;
+    }
+    event = slot.event;
+    slot.sequence.store(tail_ + mask_ + 1, std::memory_order_release);
+    ++tail_;
+    return true;
+  }
+
+  void drain()
+  {
+    Event event;
+    bool wrote = false;
+    while (pop(event)) {
+      file_ << "{\"stage\":\"" << event.stage << "\",\"origin\":" << event.origin_ns
+            << ",\"enter\":" << event.enter_ns << ",\"exit\":" << event.exit_ns << "}\n";
+      wrote = true;
+    }
+    if (wrote) {
+      file_.flush();
+    }
+  }
+
+  void writerLoop()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+      cv_.wait_for(lock, std::chrono::milliseconds(100));
+      lock.unlock();
+      drain();
+      lock.lock();
+    }
+    lock.unlock();
+    drain();
+  }
+
+  std::ofstream file_;
+  std::unique_ptr<Slot[]> slots_;
+  size_t mask_{0};
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) size_t tail_{0};  // only used by the writer thread
+  std::atomic<uint64_t> dropped_{0};
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_{false};
+  std::thread writer_;
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__LATENCY_TRACER_HPP_
@@ -0,0 +1,359 @@
+// Heap accounting per subsystem and periodic memory reports of a SWC
+#ifndef PATH_OPTIMIZER__MEMORY_ACCOUNTING_HPP_
+#define PATH_OPTIMIZER__MEMORY_ACCOUNTING_HPP_
+
+#include <malloc.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+// Subsystems that heap allocations are attributed to; registerTag adds more after Count
+enum class MemoryTag : uint8_t {
+  Untagged,
+  Map,           // lanelet2 primitives, layers and their search trees
+  RoutingGraph,  // RoutingGraph / FrozenRoutingGraph
+  RouteCache,    // routes, route deltas, skeleton and tile caches
+  Messages,      // port samples and message buffers
+  Planner,       // planner state: trajectories, QP workspaces
+  Count
+};
+
+/**
+ * MemoryAccounting: live heap bytes, peak and allocation count per MemoryTag
+ *
+ * A MemoryTagScope sets the tag of the calling thread; every operator new in that scope is
+ * attributed to it, so loading the map inside MemoryTagScope(MemoryTag::Map) charges the map,
+ * whichever library allocates. The tag is stored in a small header of each block, and the bytes
+ * are returned to the same tag when the block is freed, even from another thread or scope.
+ *
+ * The counting operator new/delete replacements are only compiled where
+ * PATH_OPTIMIZER_MEMORY_ACCOUNTING_IMPLEMENTATION is defined before including this header,
+ * in exactly one translation unit of the executable. They replace the global operators, so they
+ * cannot be combined with the AllocationGuard implementation in the same executable. Each
+ * allocation costs a thread local load and two relaxed atomic adds; blocks get a 16 byte header.
+ * Memory that bypasses operator new (Eigen, which uses malloc, and aligned new) stays untagged
+ * and only shows up in the process totals of MemoryReport.
+ */
+class MemoryAccounting
+{
+public:
+  static constexpr size_t max_tags = 32;
+
+  struct TagUsage
+  {
+    std::string name;
+    int64_t bytes{0};
+    int64_t peak_bytes{0};
+    uint64_t allocations{0};
+  };
+
+  static MemoryAccounting & instance()
+  {
+    static MemoryAccounting accounting;
+    return accounting;
+  }
+
+  // Whether the operator new replacements are linked into this executable
+  static bool active() { return activeFlag().load(std::memory_order_relaxed); }
+
+  // Adds a tag (e.g. one per planner module); name must have static storage duration
+  uint8_t registerTag(const char * name)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto id = num_tags_.load(std::memory_order_relaxed);
+    if (id >= max_tags) {
+      return static_cast<uint8_t>(MemoryTag::Untagged);
+    }
+    names_[id] = name;
+    num_tags_.store(id + 1, std::memory_order_release);
+    return static_cast<uint8_t>(id);
+  }
+
+  std::vector<TagUsage> usage() const
+  {
+    std::vector<TagUsage> result;
+    const size_t n = num_tags_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < n; ++i) {
+      const auto & c = counters_[i];
+      result.push_back(TagUsage{
+        names_[i], c.bytes.load(std::memory_order_relaxed),
+        c.peak_bytes.load(std::memory_order_relaxed),
+        c.allocations.load(std::memory_order_relaxed)});
+    }
+    return result;
+  }
+
+  // Called by the operator new/delete replacements
+  void onAllocate(const uint8_t tag, const size_t size)
+  {
+    auto & c = counters_[tag];
+    const int64_t bytes =
+      c.bytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) +
+      static_cast<int64_t>(size);
+    c.allocations.fetch_add(1, std::memory_order_relaxed);
+    int64_t peak = c.peak_bytes.load(std::memory_order_relaxed);
+    while (bytes > peak && !c.peak_bytes.compare_exchange_weak(peak, bytes)) {
+    }
+  }
+  void onFree(const uint8_t tag, const size_t size)
+  {
+    counters_[tag].bytes.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+  }
+
+  static uint8_t & currentTag()
+  {
+    thread_local uint8_t tag = static_cast<uint8_t>(MemoryTag::Untagged);
+    return tag;
+  }
+
+  static std::atomic<bool> & activeFlag()
+  {
+    static std::atomic<bool> active{false};
+    return active;
+  }
+
+private:
+  struct alignas(64) Counter
+  {
+    std::atomic<int64_t> bytes{0};
+    std::atomic<int64_t> peak_bytes{0};
+    std::atomic<uint64_t> allocations{0};
+  };
+
+  MemoryAccounting()
+  {
+    constexpr const char * builtin[] = {
+      "untagged", "map", "routing_graph", "route_cache", "messages", "planner"};
+    for (size_t i = 0; i < static_cast<size_t>(MemoryTag::Count); ++i) {
+      names_[i] = builtin[i];
+    }
+  }
+
+  std::array<Counter, max_tags> counters_{};
+  std::array<const char *, max_tags> names_{};
+  std::atomic<size_t> num_tags_{static_cast<size_t>(MemoryTag::Count)};
+  std::mutex mutex_;
+};
+
+// Attributes the allocations of the calling thread to tag while in scope (nestable)
+class MemoryTagScope
+{
+public:
+  explicit MemoryTagScope(const MemoryTag tag) : MemoryTagScope(static_cast<uint8_t>(tag)) {}
+  explicit MemoryTagScope(const uint8_t tag) : previous_(MemoryAccounting::currentTag())
+  {
+    MemoryAccounting::currentTag() = tag;
+  }
+  MemoryTagScope(const MemoryTagScope &) = delete;
+  MemoryTagScope & operator=(const MemoryTagScope &) = delete;
+  ~MemoryTagScope() { MemoryAccounting::currentTag() = previous_; }
+
+private:
+  uint8_t previous_;
+};
+
+/**
+ * MemoryReport: writes the memory usage of the process every period, one JSON line per sample
+ *
+ *   {"stamp": <ns>, "process": "Exe_missionplanner", "rss": <bytes>, "heap": <bytes>,
+ *    "tags": {"map": [<bytes>, <peak bytes>, <allocations>], ...}}
+ *
+ * rss is the resident set size from /proc/self/statm, heap the bytes in use by malloc
+ * (mallinfo2, including the untracked allocations). The peak RSS over a drive is the value to
+ * put as mem-usage into the execution manifest, plus a margin; the tags tell where it goes.
+ * tool/analyze_memory_usage.py summarizes the reports.
+ */
+class MemoryReport
+{
+public:
+  MemoryReport(
+    const std::string & path, std::string process,
+    const std::chrono::milliseconds period = std::chrono::milliseconds(5000))
+  : file_(path, std::ios::app), process_(std::move(process)), period_(period)
+  {
+    thread_ = std::thread([this] { reportLoop(); });
+  }
+
+  MemoryReport(const MemoryReport &) = delete;
+  MemoryReport & operator=(const MemoryReport &) = delete;
+
+  ~MemoryReport()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+  }
+
+  static int64_t residentBytes()
+  {
+    std::ifstream statm("/proc/self/statm");
+    int64_t size = 0;
+    int64_t resident = 0;
+    statm >> size >> resident;
+    return resident * static_cast<int64_t>(::sysconf(_SC_PAGESIZE));
+  }
+
+  static int64_t heapBytes()
+  {
+    const auto info = ::mallinfo2();
+    return static_cast<int64_t>(info.uordblks + info.hblkhd);
+  }
+
+  // Writes one line now, also called by the report thread
+  void write()
+  {
+    const auto stamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    file_ << "{\"stamp\":" << stamp << ",\"process\":\"" << process_
+          << "\",\"rss\":" << residentBytes() << ",\"heap\":" << heapBytes();
+    if (MemoryAccounting::active()) {
+      file_ << ",\"tags\":{";
+      bool first = true;
+      for (const auto & tag : MemoryAccounting::instance().usage()) {
+        file_ << (first ? "" : ",") << "\"" << tag.name << "\":[" << tag.bytes << ","
+              << tag.peak_bytes << "," << tag.allocations << "]";
+        first = false;
+      }
+      file_ << "}";
+    }
+    file_ << "}\n";
+    file_.flush();
+  }
+
+private:
+  void reportLoop()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!cv_.wait_for(lock, period_, [this] { return stop_; })) {
+      write();
+    }
+    write();
+  }
+
+  std::ofstream file_;
+  const std::string process_;
+  const std::chrono::milliseconds period_;
+  std::mutex write_mutex_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_{false};
+  std::thread thread_;
+};
+
+}  // namespace autoware::path_optimizer
+
+#ifdef PATH_OPTIMIZER_MEMORY_ACCOUNTING_IMPLEMENTATION
+
+#ifdef PATH_OPTIMIZER_ALLOCATION_GUARD_IMPLEMENTATION
+#error "memory accounting and the allocation guard both replace operator new"
+#endif
+
+#include <cstdlib>
+#include <new>
+
+namespace autoware::path_optimizer::memory_accounting_detail
+{
+// Header in front of every block: keeps the 16 byte alignment of operator new
+struct alignas(16) BlockHeader
+{
+  size_t size;
+  uint8_t tag;
+};
+static_assert(sizeof(BlockHeader) == 16, "header must keep the alignment of the block");
+
+const bool registered = [] {
+  MemoryAccounting::activeFlag().store(true, std::memory_order_relaxed);
+  return true;
+}();
+
+inline void * allocate(const std::size_t size)
+{
+  auto * header = static_cast<BlockHeader *>(std::malloc(sizeof(BlockHeader) + size));
+  if (header == nullptr) {
+    return nullptr;
+  }
+  header->size = size;
+  header->tag = MemoryAccounting::currentTag();
+  MemoryAccounting::instance().onAllocate(header->tag, size);
+  return header + 1;
+}
+
+inline void deallocate(void * p) noexcept
+{
+  if (p == nullptr) {
+    return;
+  }
+  auto * header = static_cast<BlockHeader *>(p) - 1;
+  MemoryAccounting::instance().onFree(header->tag, header->size);
+  std::free(header);
+}
+}  // namespace autoware::path_optimizer::memory_accounting_detail
+
+// noinline: as for the AllocationGuard replacements
+[[gnu::noinline]] void * operator new(const std::size_t size)
+{
+  if (void * p = autoware::path_optimizer::memory_accounting_detail::allocate(size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void * operator new[](const std::size_t size)
+{
+  if (void * p = autoware::path_optimizer::memory_accounting_detail::allocate(size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void * operator new(const std::size_t size, const std::nothrow_t &) noexcept
+{
+  return autoware::path_optimizer::memory_accounting_detail::allocate(size);
+}
+
+[[gnu::noinline]] void * operator new[](const std::size_t size, const std::nothrow_t &) noexcept
+{
+  return autoware::path_optimizer::memory_accounting_detail::allocate(size);
+}
+
+[[gnu::noinline]] void operator delete(void * p) noexcept
+{
+  autoware::path_optimizer::memory_accounting_detail::deallocate(p);
+}
+
+[[gnu::noinline]] void operator delete[](void * p) noexcept
+{
+  autoware::path_optimizer::memory_accounting_detail::deallocate(p);
+}
+
+[[gnu::noinline]] void operator delete(void * p, std::size_t) noexcept
+{
+  autoware::path_optimizer::memory_accounting_detail::deallocate(p);
+}
+
+[[gnu::noinline]] void operator delete[](void * p, std::size_t) noexcept
+{
+  autoware::path_optimizer::memory_accounting_detail::deallocate(p);
+}
+
+#endif  // PATH_OPTIMIZER_MEMORY_ACCOUNTING_IMPLEMENTATION
+
+#endif  // PATH_OPTIMIZER__MEMORY_ACCOUNTING_HPP_
@@ -16,6 +16,7 @@
 #define PATH_OPTIMIZER__MPT_OPTIMIZER_HPP_
 
 #include "path_optimizer_types.hpp"
+#include "reference_point_fields.hpp"
 #include "state_equation_generator.hpp"
 
 #include <Eigen/Core>
@@ -50,6 +51,12 @@ public:
     return ref_points_;
   }
 
+  // Copy of the reference points with the derived fields that the solver does not need (default:
+  // alpha and the poses of the vehicle circles at circle_offsets), computed on each call
+  std::vector<ReferencePoint> getDebugReferencePoints(
+    const std::vector<double> & circle_offsets,
+    const ReferencePointFields fields = ReferencePointFields::debug()) const;
+
 private:
   MPTParam param_;
   VehicleInfo vehicle_info_;
@@ -83,6 +90,15 @@ private:
     const std::vector<ReferencePoint> & ref_points) const;
 };
 
+inline std::vector<ReferencePoint> MPTOptimizer::getDebugReferencePoints(
+  const std::vector<double> & circle_offsets, const ReferencePointFields fields) const
+{
+  auto ref_points = ref_points_;
+  ReferencePointFieldCalculator().calc(
+    ref_points, fields, vehicle_info_.wheel_base_m, circle_offsets);
+  return ref_points;
+}
+
 }  // namespace autoware::path_optimizer
 
 #endif  // PATH_OPTIMIZER__MPT_OPTIMIZER_HPP_
@@ -0,0 +1,366 @@
+// Condensed and sparse QP formulations of the MPT problem
+#ifndef PATH_OPTIMIZER__MPT_QP_FORMULATION_HPP_
+#define PATH_OPTIMIZER__MPT_QP_FORMULATION_HPP_
+
+#include "path_optimizer_types.hpp"
+#include "osqp_interface.hpp"
+#include "state_equation_generator.hpp"
+
+#include <Eigen/Core>
+
+#include <cstddef>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+enum class MPTQPFormulation {
+  CONDENSED,  // U only, states eliminated through X = B * U + W (dense Hessian B^T Q B + R)
+  SPARSE,     // [X; U] with the dynamics as banded equality constraints (diagonal Hessian)
+};
+
+/**
+ * MPTQPBuilder: builds the MPT tracking QP in either formulation
+ *
+ *   minimize    0.5 * sum_i x_i^T Q x_i + 0.5 * sum_k u_k^T R u_k   (Q, R = setWeights())
+ *   subject to  x_0 = ego state, x_{i+1} = Ad_i x_i + Bd_i u_i + Wd_i,
+ *               bounds on the lateral error of each vehicle circle at x_i (i >= 1),
+ *               |u_k| <= input_limit
+ *
+ * CONDENSED has N_u = (N_ref - 1) * D_u variables, but its Hessian and the lateral constraint
+ * rows are dense, so the KKT factorization grows with N_u^3 and the matrix build with N_ref^2.
+ * SPARSE has N_x + N_u variables and every column holds a constant number of entries, so OSQP's
+ * sparse LDL^T factorization and the build grow linearly with the horizon. The formulation is a
+ * runtime switch; both give the same optimum, extractSolution() returns U and X for either.
+ *
+ * Vehicle circles: the lateral error of a circle at longitudinal offset l from the reference point
+ * is linearized as x[0] + l * x[1] (lateral and yaw error). The row coefficients are precomputed
+ * by setVehicleCircles() and every circle adds N_ref - 1 rows, in the sparse formulation with two
+ * entries each, written straight into the CSC columns. Its bounds are
+ * ref_points[i].bounds_on_constraints[j] (BoundsCalculator::calcBoundsOnCircles) shrunk by the
+ * radius. Without circles there is one row per point on x[0] with ref_points[i].bounds.
+ *
+ * The sparsity pattern depends only on N_ref and the formulation: all structural entries are
+ * stored even if their value is zero, so OSQPBackend reuses its workspace across cycles. All
+ * buffers keep their capacity across calls.
+ */
+template <typename Model>
+class MPTQPBuilderT
+{
+public:
+  using Generator = StateEquationGeneratorT<Model>;
+  static constexpr int DimX = Generator::DimX;
+  static constexpr int DimU = Generator::DimU;
+  using StateVector = typename Generator::StateVector;
+  using InputVector = Eigen::Matrix<double, DimU, 1>;
+  static_assert(DimX >= 2, "the circle rows need [lateral_error, yaw_error, ...] states");
+
+  struct Weights
+  {
+    StateVector state{StateVector::Ones()};
+    InputVector input{InputVector::Ones()};
+  };
+
+  // Problem in the QPSolverBackend convention (P upper triangular CSC)
+  struct Problem
+  {
+    CSC_Matrix P;
+    CSC_Matrix A;
+    std::vector<double> q;
+    std::vector<double> l;
+    std::vector<double> u;
+    size_t num_state_variables{0};  // Leading X block, 0 for CONDENSED
+    size_t num_input_variables{0};
+  };
+
+  explicit MPTQPBuilderT(const MPTQPFormulation formulation = MPTQPFormulation::CONDENSED)
+  : formulation_(formulation)
+  {
+  }
+
+  void setFormulation(const MPTQPFormulation formulation) { formulation_ = formulation; }
+  MPTQPFormulation getFormulation() const { return formulation_; }
+
+  void setWeights(const Weights & weights) { weights_ = weights; }
+  void setInputLimit(const double input_limit) { input_limit_ = input_limit; }
+
+  /**
+   * @param offsets longitudinal circle offsets from the reference point (e.g. calcVehicleCircles)
+   * @param radius circle radius, subtracted from both bounds
+   */
+  void setVehicleCircles(const std::vector<double> & offsets, const double radius)
+  {
+    circle_rows_.clear();
+    for (const double offset : offsets) {
+      StateVector row = StateVector::Zero();
+      row(0) = 1.0;
+      row(1) = offset;
+      circle_rows_.push_back(row);
+    }
+    circle_radius_ = radius;
+    use_circles_ = !offsets.empty();
+    if (!use_circles_) {
+      circle_rows_.push_back(StateVector::Unit(0));
+      circle_radius_ = 0.0;
+    }
+  }
+
+  /**
+   * @param x0 ego state, fixes X[0]
+   * @param problem overwritten
+   */
+  void build(
+    const Generator & generator, const std::vector<ReferencePoint> & ref_points,
+    const StateVector & x0, Problem & problem)
+  {
+    if (formulation_ == MPTQPFormulation::SPARSE) {
+      buildSparse(generator, ref_points, x0, problem);
+    } else {
+      buildCondensed(generator, ref_points, x0, problem);
+    }
+  }
+
+  // Inputs and predicted states of a solution of the last built problem
+  void extractSolution(
+    const std::vector<double> & primal, Eigen::VectorXd & U, Eigen::VectorXd & X) const
+  {
+    const auto size = static_cast<Eigen::Index>(primal.size());
+    const Eigen::Map<const Eigen::VectorXd> z(primal.data(), size);
+    if (formulation_ == MPTQPFormulation::SPARSE) {
+      X = z.head(num_x_);
+      U = z.tail(size - num_x_);
+      return;
+    }
+    U = z;
+    X = mat_.B * U + offset_;
+  }
+
+private:
+  static void clear(CSC_Matrix & csc)
+  {
+    csc.m_vals.clear();
+    csc.m_row_idxs.clear();
+    csc.m_col_idxs.clear();
+    csc.m_col_idxs.push_back(0);
+  }
+
+  static void push(CSC_Matrix & csc, const size_t row, const double value)
+  {
+    csc.m_row_idxs.push_back(static_cast<long long>(row));
+    csc.m_vals.push_back(value);
+  }
+
+  static void endColumn(CSC_Matrix & csc)
+  {
+    csc.m_col_idxs.push_back(static_cast<long long>(csc.m_vals.size()));
+  }
+
+  // Lateral bounds of circle c at reference point p
+  void getCircleBounds(
+    const ReferencePoint & p, const size_t c, double & lower, double & upper) const
+  {
+    const Bounds & bounds = use_circles_ ? p.bounds_on_constraints[c] : p.bounds;
+    lower = bounds.lower_bound + circle_radius_;
+    upper = bounds.upper_bound - circle_radius_;
+  }
+
+  void buildCondensed(
+    const Generator & generator, const std::vector<ReferencePoint> & ref_points,
+    const StateVector & x0, Problem & problem)
+  {
+    constexpr size_t D_x = DimX;
+    constexpr size_t D_u = DimU;
+    const size_t N_ref = ref_points.size();
+    const size_t N_x = N_ref * D_x;
+    const size_t N_u = (N_ref - 1) * D_u;
+    num_x_ = static_cast<Eigen::Index>(N_x);
+
+    generator.calcMatrix(ref_points, mat_);
+
+    // X = B * U + offset, offset = W + propagation of x0 through A[i, i-1] = Ad
+    offset_ = mat_.W;
+    StateVector phi = x0;
+    offset_.template segment<DimX>(0) += phi;
+    for (size_t i = 1; i < N_ref; ++i) {
+      phi = mat_.A.template block<DimX, DimX>(i * D_x, (i - 1) * D_x) * phi;
+      offset_.template segment<DimX>(i * D_x) += phi;
+    }
+
+    q_diag_.resize(static_cast<Eigen::Index>(N_x));
+    for (size_t i = 0; i < N_ref; ++i) {
+      q_diag_.template segment<DimX>(i * D_x) = weights_.state;
+    }
+    QB_.noalias() = q_diag_.asDiagonal() * mat_.B;
+    H_.noalias() = mat_.B.transpose() * QB_;
+    for (size_t k = 0; k < N_ref - 1; ++k) {
+      H_.diagonal().template segment<DimU>(k * D_u) += weights_.input;
+    }
+    g_.noalias() = QB_.transpose() * offset_;
+
+    // Dense Hessian: all upper triangular entries are structural
+    clear(problem.P);
+    for (size_t col = 0; col < N_u; ++col) {
+      for (size_t row = 0; row <= col; ++row) {
+        push(problem.P, row, H_(static_cast<Eigen::Index>(row), static_cast<Eigen::Index>(col)));
+      }
+      endColumn(problem.P);
+    }
+    problem.q.assign(g_.data(), g_.data() + g_.size());
+
+    // Rows: circle lateral errors of X[1..N_ref-1] circle by circle, then the inputs.
+    // U[k] affects X[k+1..].
+    const size_t num_circles = circle_rows_.size();
+    const size_t num_lat = num_circles * (N_ref - 1);
+    clear(problem.A);
+    for (size_t k = 0; k < N_ref - 1; ++k) {
+      for (size_t j = 0; j < D_u; ++j) {
+        const size_t col = k * D_u + j;
+        for (size_t c = 0; c < num_circles; ++c) {
+          for (size_t i = k + 1; i < N_ref; ++i) {
+            const double value = circle_rows_[c].dot(
+              mat_.B.template block<DimX, 1>(i * D_x, static_cast<Eigen::Index>(col)));
+            push(problem.A, c * (N_ref - 1) + i - 1, value);
+          }
+        }
+        push(problem.A, num_lat + col, 1.0);
+        endColumn(problem.A);
+      }
+    }
+
+    problem.l.resize(num_lat + N_u);
+    problem.u.resize(num_lat + N_u);
+    for (size_t c = 0; c < num_circles; ++c) {
+      for (size_t i = 1; i < N_ref; ++i) {
+        const double lat_offset = circle_rows_[c].dot(offset_.template segment<DimX>(i * D_x));
+        const size_t row = c * (N_ref - 1) + i - 1;
+        getCircleBounds(ref_points[i], c, problem.l[row], problem.u[row]);
+        problem.l[row] -= lat_offset;
+        problem.u[row] -= lat_offset;
+      }
+    }
+    for (size_t col = 0; col < N_u; ++col) {
+      problem.l[num_lat + col] = -input_limit_;
+      problem.u[num_lat + col] = input_limit_;
+    }
+    problem.num_state_variables = 0;
+    problem.num_input_variables = N_u;
+  }
+
+  void buildSparse(
+    const Generator & generator, const std::vector<ReferencePoint> & ref_points,
+    const StateVector & x0, Problem & problem)
+  {
+    constexpr size_t D_x = DimX;
+    constexpr size_t D_u = DimU;
+    const size_t N_ref = ref_points.size();
+    const size_t N_x = N_ref * D_x;
+    const size_t N_u = (N_ref - 1) * D_u;
+    num_x_ = static_cast<Eigen::Index>(N_x);
+
+    generator.calcStepMatrices(ref_points, steps_);
+
+    // Diagonal Hessian over [X; U]
+    clear(problem.P);
+    for (size_t i = 0; i < N_ref; ++i) {
+      for (size_t d = 0; d < D_x; ++d) {
+        push(problem.P, i * D_x + d, weights_.state(static_cast<Eigen::Index>(d)));
+        endColumn(problem.P);
+      }
+    }
+    for (size_t k = 0; k < N_ref - 1; ++k) {
+      for (size_t j = 0; j < D_u; ++j) {
+        push(problem.P, N_x + k * D_u + j, weights_.input(static_cast<Eigen::Index>(j)));
+        endColumn(problem.P);
+      }
+    }
+    problem.q.assign(N_x + N_u, 0.0);
+
+    // Rows: dynamics X[0] = x0 and X[i] - Ad X[i-1] - Bd U[i-1] = Wd (N_x), circle lateral
+    // errors of X[1..N_ref-1] circle by circle, inputs
+    const size_t num_circles = circle_rows_.size();
+    const size_t lat_row = N_x;
+    const size_t input_row = N_x + num_circles * (N_ref - 1);
+    clear(problem.A);
+    for (size_t k = 0; k < N_ref; ++k) {
+      for (size_t d = 0; d < D_x; ++d) {
+        push(problem.A, k * D_x + d, 1.0);
+        if (k + 1 < N_ref) {
+          for (size_t r = 0; r < D_x; ++r) {
+            const auto & Ad = steps_.Ad[k + 1];
+            push(
+              problem.A, (k + 1) * D_x + r,
+              -Ad(static_cast<Eigen::Index>(r), static_cast<Eigen::Index>(d)));
+          }
+        }
+        for (size_t c = 0; c < num_circles && k >= 1; ++c) {
+          const double value = circle_rows_[c](static_cast<Eigen::Index>(d));
+          if (value != 0.0) {  // depends on the circle offsets only, not on the cycle
+            push(problem.A, lat_row + c * (N_ref - 1) + k - 1, value);
+          }
+        }
+        endColumn(problem.A);
+      }
+    }
+    for (size_t k = 0; k < N_ref - 1; ++k) {
+      for (size_t j = 0; j < D_u; ++j) {
+        const auto & Bd = steps_.Bd[k + 1];
+        for (size_t r = 0; r < D_x; ++r) {
+          push(
+            problem.A, (k + 1) * D_x + r,
+            -Bd(static_cast<Eigen::Index>(r), static_cast<Eigen::Index>(j)));
+        }
+        push(problem.A, input_row + k * D_u + j, 1.0);
+        endColumn(problem.A);
+      }
+    }
+
+    const size_t num_rows = input_row + N_u;
+    problem.l.resize(num_rows);
+    problem.u.resize(num_rows);
+    for (size_t d = 0; d < D_x; ++d) {
+      problem.l[d] = problem.u[d] = x0(static_cast<Eigen::Index>(d));
+    }
+    for (size_t i = 1; i < N_ref; ++i) {
+      for (size_t d = 0; d < D_x; ++d) {
+        problem.l[i * D_x + d] = problem.u[i * D_x + d] =
+          steps_.Wd[i](static_cast<Eigen::Index>(d));
+      }
+      for (size_t c = 0; c < num_circles; ++c) {
+        const size_t row = lat_row + c * (N_ref - 1) + i - 1;
+        getCircleBounds(ref_points[i], c, problem.l[row], problem.u[row]);
+      }
+    }
+    for (size_t col = 0; col < N_u; ++col) {
+      problem.l[input_row + col] = -input_limit_;
+      problem.u[input_row + col] = input_limit_;
+    }
+    problem.num_state_variables = N_x;
+    problem.num_input_variables = N_u;
+  }
+
+  MPTQPFormulation formulation_;
+  Weights weights_;
+  double input_limit_{0.7};
+
+  // Lateral error row of each circle on X[i]; one circle at the reference point by default
+  std::vector<StateVector, Eigen::aligned_allocator<StateVector>> circle_rows_{
+    StateVector::Unit(0)};
+  double circle_radius_{0.0};
+  bool use_circles_{false};
+
+  // Scratch of the last build
+  Eigen::Index num_x_{0};
+  typename Generator::Matrix mat_;
+  typename Generator::StepMatrices steps_;
+  Eigen::VectorXd offset_;
+  Eigen::VectorXd q_diag_;
+  Eigen::MatrixXd QB_;
+  Eigen::MatrixXd H_;
+  Eigen::VectorXd g_;
+};
+
+using MPTQPBuilder = MPTQPBuilderT<VehicleModel>;
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__MPT_QP_FORMULATION_HPP_
@@ -0,0 +1,527 @@
+// Non-verbose logging for hot paths: message ids and binary arguments, formatted offline
+#ifndef PATH_OPTIMIZER__NONVERBOSE_LOG_HPP_
+#define PATH_OPTIMIZER__NONVERBOSE_LOG_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+// DLT log levels
+enum class LogLevel : uint8_t { Fatal = 1, Error = 2, Warn = 3, Info = 4, Debug = 5, Verbose = 6 };
+
+// Argument types of the payload, in the type signature of a message
+namespace nonverbose_log
+{
+constexpr char type_int = 'i';     // int64
+constexpr char type_uint = 'u';    // uint64
+constexpr char type_double = 'd';  // float64
+constexpr char type_bool = 'b';    // uint8
+
+template <typename T>
+constexpr char typeOf()
+{
+  using U = std::decay_t<T>;
+  static_assert(std::is_arithmetic_v<U> || std::is_enum_v<U>, "arguments must be numbers");
+  if constexpr (std::is_same_v<U, bool>) {
+    return type_bool;
+  } else if constexpr (std::is_floating_point_v<U>) {
+    return type_double;
+  } else if constexpr (std::is_enum_v<U> || std::is_signed_v<U>) {
+    return type_int;
+  } else {
+    return type_uint;
+  }
+}
+
+constexpr size_t sizeOf(const char type) { return type == type_bool ? 1 : 8; }
+}  // namespace nonverbose_log
+
+// One log site: id, level, format string ("{}" per argument) and argument type signature
+struct LogMessageInfo
+{
+  uint32_t id;
+  LogLevel level;
+  std::string format;
+  std::string types;
+};
+
+/**
+ * LogCatalog: all messages of the process, registered at static initialization
+ *
+ * The format strings never leave the process at run time: save() writes them once, as one line
+ * "id<TAB>level<TAB>types<TAB>format" per message, and the offline decoder (formatRecord) joins
+ * that catalog with the logged ids and arguments. Ids must be unique; registering an id twice
+ * throws at startup.
+ */
+class LogCatalog
+{
+public:
+  static LogCatalog & instance()
+  {
+    static LogCatalog catalog;
+    return catalog;
+  }
+
+  void add(const LogMessageInfo & info)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto & m : messages_) {
+      if (m.id == info.id) {
+        throw std::logic_error("log catalog: duplicate message id " + std::to_string(info.id));
+      }
+    }
+    messages_.push_back(info);
+  }
+
+  std::vector<LogMessageInfo> messages() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return messages_;
+  }
+
+  void save(const std::string & path) const
+  {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+      throw std::runtime_error("log catalog: cannot open " + path);
+    }
+    for (const auto & m : messages()) {
+      file << m.id << '\t' << static_cast<int>(m.level) << '\t' << m.types << '\t' << m.format
+           << '\n';
+    }
+  }
+
+  static std::vector<LogMessageInfo> load(const std::string & path)
+  {
+    std::ifstream file(path);
+    if (!file) {
+      throw std::runtime_error("log catalog: cannot open " + path);
+    }
+    std::vector<LogMessageInfo> messages;
+    std::string line;
+    while (std::getline(file, line)) {
+      std::istringstream fields(line);
+      std::string id, level, types, format;
+      if (
+        !std::getline(fields, id, '\t') || !std::getline(fields, level, '\t') ||
+        !std::getline(fields, types, '\t')) {
+        throw std::runtime_error("log catalog: malformed line in " + path);
+      }
+      std::getline(fields, format);
+      messages.push_back(LogMessageInfo{
+        static_cast<uint32_t>(std::stoul(id)), static_cast<LogLevel>(std::stoi(level)), format,
+        types});
+    }
+    return messages;
+  }
+
+private:
+  LogCatalog() = default;
+
+  mutable std::mutex mutex_;
+  std::vector<LogMessageInfo> messages_;
+};
+
+/**
+ * NonVerboseLog: per-thread binary log buffers, drained in the background
+ *
+ * A message costs one relaxed load when its level is filtered out, and otherwise a copy of
+ * the message id, a time stamp and the raw arguments into a single-producer byte ring buffer
+ * owned by the calling thread: no formatting, no lock, no allocation after the first message of
+ * the thread. A background thread drains the buffers every period and appends the records to
+ * the output file and/or passes them to a sink, which the SWC binds to the DLT non-verbose API
+ * (message id + raw payload). Records that do not fit into a full buffer are dropped and counted.
+ *
+ * File layout (little endian): magic "NVLOG001", then per record
+ *   id (uint32), size (uint16), thread (uint16), stamp_ns (int64), payload (size bytes)
+ */
+class NonVerboseLog
+{
+public:
+  struct Record
+  {
+    uint32_t id{0};
+    uint16_t thread{0};
+    int64_t stamp_ns{0};
+    std::vector<uint8_t> payload;
+  };
+  using Sink = std::function<void(const Record &)>;
+
+  static constexpr char magic[8] = {'N', 'V', 'L', 'O', 'G', '0', '0', '1'};
+  static constexpr size_t record_header_size = 16;
+
+  static NonVerboseLog & instance()
+  {
+    static NonVerboseLog log;
+    return log;
+  }
+
+  NonVerboseLog(const NonVerboseLog &) = delete;
+  NonVerboseLog & operator=(const NonVerboseLog &) = delete;
+
+  ~NonVerboseLog() { stop(); }
+
+  /**
+   * @brief Enables logging up to level and starts the drain thread
+   * @param path output file (truncated); empty to only pass the records to the sink
+   */
+  void start(
+    const std::string & path, const LogLevel level, Sink sink = {},
+    const std::chrono::milliseconds period = std::chrono::milliseconds(100))
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (drain_thread_.joinable()) {
+      return;
+    }
+    if (!path.empty()) {
+      file_.open(path, std::ios::binary | std::ios::trunc);
+      file_.write(magic, sizeof(magic));
+    }
+    sink_ = std::move(sink);
+    period_ = period;
+    stop_ = false;
+    level_.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+    drain_thread_ = std::thread([this] { drainLoop(); });
+  }
+
+  // Disables logging, drains the remaining records and closes the file
+  void stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!drain_thread_.joinable()) {
+        return;
+      }
+      level_.store(0, std::memory_order_relaxed);
+      stop_ = true;
+    }
+    cv_.notify_one();
+    drain_thread_.join();
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.close();
+  }
+
+  // The level can be changed at run time, e.g. raised on a diagnostic request
+  void setLevel(const LogLevel level)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (drain_thread_.joinable()) {
+      level_.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+    }
+  }
+
+  bool enabled(const LogLevel level) const
+  {
+    return static_cast<uint8_t>(level) <= level_.load(std::memory_order_relaxed);
+  }
+
+  template <typename... Args>
+  void log(const uint32_t id, const Args &... args)
+  {
+    constexpr size_t payload_size = (size_t{0} + ... + nonverbose_log::sizeOf(
+                                                          nonverbose_log::typeOf<Args>()));
+    static_assert(payload_size <= 512, "too many arguments for one record");
+    std::array<uint8_t, record_header_size + payload_size> bytes;
+    const int64_t stamp_ns = now();
+    const auto size = static_cast<uint16_t>(payload_size);
+    ThreadBuffer & buffer = threadBuffer();
+    std::memcpy(bytes.data(), &id, 4);
+    std::memcpy(bytes.data() + 4, &size, 2);
+    std::memcpy(bytes.data() + 6, &buffer.thread, 2);
+    std::memcpy(bytes.data() + 8, &stamp_ns, 8);
+    uint8_t * cursor = bytes.data() + record_header_size;
+    (put(cursor, args), ...);
+    buffer.push(bytes.data(), bytes.size(), dropped_);
+  }
+
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+  static int64_t now()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+  }
+
+private:
+  // Single producer (the owning thread), single consumer (the drain thread, under mutex_)
+  struct ThreadBuffer
+  {
+    static constexpr size_t capacity = 1U << 16U;
+    std::array<uint8_t, capacity> bytes;
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+    std::atomic<bool> alive{true};
+    uint16_t thread{0};
+
+    void push(const uint8_t * data, const size_t size, std::atomic<uint64_t> & dropped)
+    {
+      const size_t h = head.load(std::memory_order_relaxed);
+      if (capacity - (h - tail.load(std::memory_order_acquire)) < size) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      copy(h, data, size);
+      head.store(h + size, std::memory_order_release);
+    }
+
+    void copy(const size_t position, const uint8_t * data, const size_t size)
+    {
+      const size_t offset = position & (capacity - 1);
+      const size_t first = std::min(size, capacity - offset);
+      std::memcpy(bytes.data() + offset, data, first);
+      std::memcpy(bytes.data(), data + first, size - first);
+    }
+
+    void read(const size_t position, uint8_t * data, const size_t size) const
+    {
+      const size_t offset = position & (capacity - 1);
+      const size_t first = std::min(size, capacity - offset);
+      std::memcpy(data, bytes.data() + offset, first);
+      std::memcpy(data + first, bytes.data(), size - first);
+    }
+  };
+
+  struct ThreadHandle
+  {
+    std::shared_ptr<ThreadBuffer> buffer;
+    ~ThreadHandle()
+    {
+      if (buffer) {
+        buffer->alive.store(false, std::memory_order_release);
+      }
+    }
+  };
+
+  NonVerboseLog() = default;
+
+  template <typename T>
+  static void put(uint8_t *& cursor, const T & value)
+  {
+    constexpr char type = nonverbose_log::typeOf<T>();
+    if constexpr (type == nonverbose_log::type_bool) {
+      *cursor++ = value ? 1 : 0;
+    } else {
+      using Stored = std::conditional_t<
+        type == nonverbose_log::type_double, double,
+        std::conditional_t<type == nonverbose_log::type_int, int64_t, uint64_t>>;
+      const auto stored = static_cast<Stored>(value);
+      std::memcpy(cursor, &stored, sizeof(stored));
+      cursor += sizeof(stored);
+    }
+  }
+
+  ThreadBuffer & threadBuffer()
+  {
+    thread_local ThreadHandle handle;
+    if (!handle.buffer) {
+      handle.buffer = std::make_shared<ThreadBuffer>();
+      std::lock_guard<std::mutex> lock(mutex_);
+      handle.buffer->thread = next_thread_++;
+      buffers_.push_back(handle.buffer);
+    }
+    return *handle.buffer;
+  }
+
+  // Requires mutex_
+  void drainBuffers()
+  {
+    uint8_t header[record_header_size];
+    for (auto it = buffers_.begin(); it != buffers_.end();) {
+      ThreadBuffer & buffer = **it;
+      const bool alive = buffer.alive.load(std::memory_order_acquire);
+      const size_t head = buffer.head.load(std::memory_order_acquire);
+      size_t tail = buffer.tail.load(std::memory_order_relaxed);
+      while (tail != head) {
+        buffer.read(tail, header, record_header_size);
+        uint16_t size = 0;
+        std::memcpy(&record_.id, header, 4);
+        std::memcpy(&size, header + 4, 2);
+        std::memcpy(&record_.thread, header + 6, 2);
+        std::memcpy(&record_.stamp_ns, header + 8, 8);
+        record_.payload.resize(size);
+        buffer.read(tail + record_header_size, record_.payload.data(), size);
+        tail += record_header_size + size;
+        if (file_.is_open()) {
+          file_.write(reinterpret_cast<const char *>(header), record_header_size);
+          file_.write(reinterpret_cast<const char *>(record_.payload.data()), size);
+        }
+        if (sink_) {
+          sink_(record_);
+        }
+      }
+      buffer.tail.store(tail, std::memory_order_release);
+      it = alive ? std::next(it) : buffers_.erase(it);
+    }
+    if (file_.is_open()) {
+      file_.flush();
+    }
+  }
+
+  void drainLoop()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+      cv_.wait_for(lock, period_, [this] { return stop_; });
+      drainBuffers();
+    }
+  }
+
+  std::atomic<uint8_t> level_{0};
+  std::atomic<uint64_t> dropped_{0};
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_{false};
+  std::chrono::milliseconds period_{100};
+  std::thread drain_thread_;
+  std::ofstream file_;
+  Sink sink_;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+  uint16_t next_thread_{0};
+  Record record_;  // reused by the drain thread
+};
+
+/**
+ * LogMessage: a log site with a fixed id, level, format and argument types
+ *
+ * Defined at namespace scope (usually through PO_NV_LOG_MESSAGE), so it is in the catalog from
+ * startup whether it is ever logged or not. operator() only accepts the declared argument types.
+ *
+ *   PO_NV_LOG_MESSAGE(mpt_qp_failed, 0x1001, Warn, "QP failed: status {}, {} iterations",
+ *                     int, int);
+ *   mpt_qp_failed(status, iterations);
+ */
+template <typename... Args>
+class LogMessage
+{
+public:
+  LogMessage(const uint32_t id, const LogLevel level, const char * format)
+  : id_(id), level_(level)
+  {
+    LogCatalog::instance().add(
+      LogMessageInfo{id, level, format, std::string{nonverbose_log::typeOf<Args>()...}});
+  }
+
+  void operator()(const Args &... args) const
+  {
+    auto & log = NonVerboseLog::instance();
+    if (log.enabled(level_)) {
+      log.log(id_, args...);
+    }
+  }
+
+  uint32_t id() const { return id_; }
+
+private:
+  uint32_t id_;
+  LogLevel level_;
+};
+
+#define PO_NV_LOG_MESSAGE(name, id, level, format, ...)                   \
+  inline const ::autoware::path_optimizer::LogMessage<__VA_ARGS__> name { \
+    id, ::autoware::path_optimizer::LogLevel::level, format               \
+  }
+
+// Reads a non-verbose log file
+class NonVerboseLogReader
+{
+public:
+  explicit NonVerboseLogReader(const std::string & path) : file_(path, std::ios::binary)
+  {
+    char header[sizeof(NonVerboseLog::magic)];
+    if (
+      !file_.read(header, sizeof(header)) ||
+      std::memcmp(header, NonVerboseLog::magic, sizeof(header)) != 0) {
+      throw std::runtime_error("non-verbose log: " + path + " is not a non-verbose log");
+    }
+  }
+
+  // Reads the next record (its payload capacity is reused), false at the end
+  bool next(NonVerboseLog::Record & record)
+  {
+    char header[NonVerboseLog::record_header_size];
+    if (!file_.read(header, sizeof(header))) {
+      return false;
+    }
+    uint16_t size = 0;
+    std::memcpy(&record.id, header, 4);
+    std::memcpy(&size, header + 4, 2);
+    std::memcpy(&record.thread, header + 6, 2);
+    std::memcpy(&record.stamp_ns, header + 8, 8);
+    record.payload.resize(size);
+    if (size > 0 && !file_.read(reinterpret_cast<char *>(record.payload.data()), size)) {
+      throw std::runtime_error("non-verbose log: truncated record payload");
+    }
+    return true;
+  }
+
+private:
+  std::ifstream file_;
+};
+
+// Formats a record with its catalog entry; "<unknown id>" if the catalog does not have it
+inline std::string formatRecord(
+  const std::vector<LogMessageInfo> & catalog, const NonVerboseLog::Record & record)
+{
+  const auto it = std::find_if(
+    catalog.begin(), catalog.end(), [&](const auto & m) { return m.id == record.id; });
+  if (it == catalog.end()) {
+    return "<unknown id " + std::to_string(record.id) + ">";
+  }
+  std::ostringstream out;
+  size_t offset = 0;
+  size_t arg = 0;
+  for (const char * f = it->format.c_str(); *f != '\0'; ++f) {
+    if (f[0] != '{' || f[1] != '}' || arg >= it->types.size()) {
+      out << *f;
+      continue;
+    }
+    const char type = it->types[arg++];
+    if (offset + nonverbose_log::sizeOf(type) > record.payload.size()) {
+      return out.str() + "<truncated>";
+    }
+    const uint8_t * p = record.payload.data() + offset;
+    if (type == nonverbose_log::type_bool) {
+      out << (*p != 0 ? "true" : "false");
+    } else if (type == nonverbose_log::type_double) {
+      double v;
+      std::memcpy(&v, p, 8);
+      out << v;
+    } else if (type == nonverbose_log::type_int) {
+      int64_t v;
+      std::memcpy(&v, p, 8);
+      out << v;
+    } else {
+      uint64_t v;
+      std::memcpy(&v, p, 8);
+      out << v;
+    }
+    offset += nonverbose_log::sizeOf(type);
+    ++f;
+  }
+  return out.str();
+}
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__NONVERBOSE_LOG_HPP_
@@ -7,6 +7,7 @@
 #endif
 
 #include <Eigen/Core>
+#include <Eigen/Sparse>
 #include <memory>
 #include <functional>
 #include <vector>
@@ -28,6 +29,57 @@ struct CSC_Matrix
 CSC_Matrix calCSCMatrix(const Eigen::MatrixXd & mat);
 CSC_Matrix calCSCMatrixTrapezoidal(const Eigen::MatrixXd & mat);
 
+// Sparse overloads: copy the compressed storage directly (O(nnz) instead of O(rows * cols)).
+// Stored entries are kept even if their value is zero, so the CSC sparsity pattern only
+// depends on the pattern of the input matrix.
+inline CSC_Matrix calCSCMatrix(const Eigen::SparseMatrix<double, Eigen::ColMajor> & mat)
+{
+  if (!mat.isCompressed()) {
+    Eigen::SparseMatrix<double, Eigen::ColMajor> compressed = mat;
+    compressed.makeCompressed();
+    return calCSCMatrix(compressed);
+  }
+
+  const auto nnz = mat.nonZeros();
+  const auto cols = mat.outerSize();
+
+  CSC_Matrix csc;
+  csc.m_vals.assign(mat.valuePtr(), mat.valuePtr() + nnz);
+  csc.m_row_idxs.assign(mat.innerIndexPtr(), mat.innerIndexPtr() + nnz);
+  csc.m_col_idxs.assign(mat.outerIndexPtr(), mat.outerIndexPtr() + cols + 1);
+  return csc;
+}
+
+// Upper triangular part (row <= col) only, as required by OSQP for P
+inline CSC_Matrix calCSCMatrixTrapezoidal(const Eigen::SparseMatrix<double, Eigen::ColMajor> & mat)
+{
+  CSC_Matrix csc;
+  csc.m_vals.reserve(mat.nonZeros());
+  csc.m_row_idxs.reserve(mat.nonZeros());
+  csc.m_col_idxs.reserve(mat.outerSize() + 1);
+
+  csc.m_col_idxs.push_back(0);
+  for (Eigen::Index col = 0; col < mat.outerSize(); ++col) {
+    for (Eigen::SparseMatrix<double, Eigen::ColMajor>::InnerIterator it(mat, col); it; ++it) {
+      if (it.row() > col) {
+        break;  // inner indices are sorted within a column
+      }
+      csc.m_vals.push_back(it.value());
+      csc.m_row_idxs.push_back(it.row());
+    }
+    csc.m_col_idxs.push_back(static_cast<long long>(csc.m_vals.size()));
+  }
+  return csc;
+}
+
+// True if both matrices have identical dimensions and nonzero layout, i.e. the values of one
+// can be written into an OSQP workspace that was set up with the other.
+inline bool hasSameSparsity(const CSC_Matrix & lhs, const CSC_Matrix & rhs)
+{
+  return lhs.m_vals.size() == rhs.m_vals.size() && lhs.m_col_idxs == rhs.m_col_idxs &&
+         lhs.m_row_idxs == rhs.m_row_idxs;
+}
+
 #ifdef USE_OSQP
 
 /**
@@ -53,6 +105,8 @@ public:
   std::tuple<std::vector<double>, std::vector<double>, int, int, int> solve();
   
   // Update methods (for warm start)
+  // updateCscP/updateCscA only replace values: the new matrix must satisfy hasSameSparsity()
+  // with the one the workspace was set up with, otherwise a new OSQPInterface is required.
   void updateCscP(const CSC_Matrix & P_csc);
   void updateQ(const std::vector<double> & q);
   void updateCscA(const CSC_Matrix & A_csc);
@@ -66,6 +120,23 @@ public:
     const std::vector<double> & dual_vars = {});
   
   void logUnsolvedStatus(const std::string & prefix) const;
+
+  // Stops the next solves after time_limit_sec (0: no limit) or max_iter iterations (0: keep the
+  // setting) with OSQP_TIME_LIMIT_REACHED / OSQP_MAX_ITER_REACHED; the iterate at that point is
+  // returned
+  void setSolveLimits(const double time_limit_sec, const int max_iter)
+  {
+    settings_.time_limit = time_limit_sec;
+    if (max_iter > 0) {
+      settings_.max_iter = max_iter;
+    }
+    if (work_initialized_ && work_) {
+      osqp_update_time_limit(work_, time_limit_sec);
+      if (max_iter > 0) {
+        osqp_update_max_iter(work_, max_iter);
+      }
+    }
+  }
   
 private:
   int64_t param_n_;              // Number of variables
@@ -1,3 +1,6 @@
+// NOTE: Superseded by osqp_interface.hpp, which is wrapped by OSQPBackend (qp_solver_backend.hpp).
+// MPTOptimizer only talks to QPSolverBackend. Do not include this header together with
+// osqp_interface.hpp, as both define CSC_Matrix.
 #ifndef PATH_OPTIMIZER_OSQP_INTERFACE_HPP_
 #define PATH_OPTIMIZER_OSQP_INTERFACE_HPP_
 
@@ -0,0 +1,234 @@
+// Batched heading, curvature and arc length of paths for Path Optimizer
+#ifndef PATH_OPTIMIZER__PATH_GEOMETRY_HPP_
+#define PATH_OPTIMIZER__PATH_GEOMETRY_HPP_
+
+#include "cubic_spline.hpp"
+#include "path_optimizer_types.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+// Kernels on coordinate arrays. The loops over the points have no branches and no loop carried
+// dependency (except the cumulative sum of the arc length), so the compiler vectorizes them when
+// sqrt needs no errno check: -O3 (or -ftree-vectorize) with -fno-math-errno.
+namespace path_geometry
+{
+
+// Cumulative 2d arc length from the first point; the segment lengths are computed in their own
+// loop before the prefix sum
+inline void calcArcLength(const double * x, const double * y, const size_t n, double * s)
+{
+  if (n == 0) {
+    return;
+  }
+  s[0] = 0.0;
+  for (size_t i = 1; i < n; ++i) {
+    const double dx = x[i] - x[i - 1];
+    const double dy = y[i] - y[i - 1];
+    s[i] = std::sqrt(dx * dx + dy * dy);
+  }
+  for (size_t i = 1; i < n; ++i) {
+    s[i] += s[i - 1];
+  }
+}
+
+// Curvature of the circle through points i - 1, i and i + 1 (as motion_utils calcCurvature),
+// positive to the left; the end points take the value of their neighbour, degenerate triples
+// (repeated points) have zero curvature
+inline void calcCurvature(const double * x, const double * y, const size_t n, double * curvature)
+{
+  if (n < 3) {
+    for (size_t i = 0; i < n; ++i) {
+      curvature[i] = 0.0;
+    }
+    return;
+  }
+  for (size_t i = 1; i + 1 < n; ++i) {
+    const double ax = x[i] - x[i - 1];
+    const double ay = y[i] - y[i - 1];
+    const double bx = x[i + 1] - x[i];
+    const double by = y[i + 1] - y[i];
+    const double cx = x[i + 1] - x[i - 1];
+    const double cy = y[i + 1] - y[i - 1];
+    const double denominator =
+      std::sqrt((ax * ax + ay * ay) * (bx * bx + by * by) * (cx * cx + cy * cy));
+    const double cross = ax * by - ay * bx;
+    curvature[i] = 2.0 * cross / std::max(denominator, 1e-12);
+  }
+  curvature[0] = curvature[1];
+  curvature[n - 1] = curvature[n - 2];
+}
+
+/**
+ * @brief Arc length, heading and curvature of a polyline from each point and its two neighbours
+ *
+ * One pass computes the three differences of every interior point once and takes from them the
+ * incoming segment length and the curvature of the circle through the three points (as
+ * calcCurvature). The heading is the tangent of that circle, which is parallel to the chord from
+ * the previous to the next point; it is taken with atan2 in a second loop, which is only
+ * vectorized where the math library has a vector atan2, so that it does not keep the first one
+ * from being vectorized. The end points take the heading of their segment and the curvature of
+ * their neighbour.
+ *
+ * @param s, yaw, curvature outputs of n values each
+ */
+inline void calcThreePoint(
+  const double * x, const double * y, const size_t n, double * s, double * yaw,
+  double * curvature)
+{
+  if (n < 3) {
+    calcArcLength(x, y, n, s);
+    calcCurvature(x, y, n, curvature);
+    for (size_t i = 0; i < n; ++i) {
+      yaw[i] = n == 2 ? std::atan2(y[1] - y[0], x[1] - x[0]) : 0.0;
+    }
+    return;
+  }
+
+  s[0] = 0.0;
+  for (size_t i = 1; i + 1 < n; ++i) {
+    const double ax = x[i] - x[i - 1];
+    const double ay = y[i] - y[i - 1];
+    const double bx = x[i + 1] - x[i];
+    const double by = y[i + 1] - y[i];
+    const double cx = x[i + 1] - x[i - 1];
+    const double cy = y[i + 1] - y[i - 1];
+    const double la2 = ax * ax + ay * ay;
+    const double denominator = std::sqrt(la2 * (bx * bx + by * by) * (cx * cx + cy * cy));
+    const double cross = ax * by - ay * bx;
+    s[i] = std::sqrt(la2);
+    curvature[i] = 2.0 * cross / std::max(denominator, 1e-12);
+  }
+  s[n - 1] = std::hypot(x[n - 1] - x[n - 2], y[n - 1] - y[n - 2]);
+  for (size_t i = 1; i < n; ++i) {
+    s[i] += s[i - 1];
+  }
+  curvature[0] = curvature[1];
+  curvature[n - 1] = curvature[n - 2];
+
+  for (size_t i = 1; i + 1 < n; ++i) {
+    yaw[i] = std::atan2(y[i + 1] - y[i - 1], x[i + 1] - x[i - 1]);
+  }
+  yaw[0] = std::atan2(y[1] - y[0], x[1] - x[0]);
+  yaw[n - 1] = std::atan2(y[n - 1] - y[n - 2], x[n - 1] - x[n - 2]);
+}
+
+// Heading and curvature of a parametric curve from its first and second derivatives,
+// curvature = (x' y'' - y' x'') / (x'^2 + y'^2)^1.5
+inline void calcFromDerivatives(
+  const double * dx, const double * dy, const double * ddx, const double * ddy, const size_t n,
+  double * yaw, double * curvature)
+{
+  for (size_t i = 0; i < n; ++i) {
+    const double speed2 = dx[i] * dx[i] + dy[i] * dy[i];
+    const double denominator = speed2 * std::sqrt(speed2);
+    const double cross = dx[i] * ddy[i] - dy[i] * ddx[i];
+    curvature[i] = cross / std::max(denominator, 1e-12);
+  }
+  for (size_t i = 0; i < n; ++i) {
+    yaw[i] = std::atan2(dy[i], dx[i]);
+  }
+}
+
+}  // namespace path_geometry
+
+/**
+ * PathGeometry: arc length, heading and curvature along a path in one batched call
+ *
+ * One shared implementation for the places that need the shape of a path every cycle: the
+ * reference points of the MPT, the curvature limits of the velocity planners and the path
+ * utilities of the behavior planner.
+ *
+ * - calc(points) / calc(x, y, n): three point variant on the path points, for paths whose point
+ *   spacing is fine compared to their curvature (resampled paths).
+ * - calc(spline, sorted_s): spline variant, evaluates the positions and both derivatives of a
+ *   CubicSpline2D at the sorted arc lengths in one forward pass and takes the heading and
+ *   curvature from the derivatives. Exact on the spline and smooth between input points, as
+ *   generateReferencePoints needs it; s is used as the arc length.
+ *
+ * The results are kept in buffers that keep their capacity, so calling it every cycle on paths of
+ * similar size does not allocate.
+ */
+class PathGeometry
+{
+public:
+  void calc(const double * x, const double * y, const size_t n)
+  {
+    resize(n);
+    if (x != x_.data()) {
+      x_.assign(x, x + n);
+      y_.assign(y, y + n);
+    }
+    path_geometry::calcThreePoint(x, y, n, s_.data(), yaw_.data(), curvature_.data());
+  }
+
+  template <typename PointT>
+  void calc(const std::vector<PointT> & points)
+  {
+    const size_t n = points.size();
+    x_.resize(n);
+    y_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      x_[i] = getPosition(points[i]).x;
+      y_[i] = getPosition(points[i]).y;
+    }
+    resize(n);
+    path_geometry::calcThreePoint(
+      x_.data(), y_.data(), n, s_.data(), yaw_.data(), curvature_.data());
+  }
+
+  void calc(const CubicSpline2D & spline, const std::vector<double> & sorted_s)
+  {
+    const size_t n = sorted_s.size();
+    resize(n);
+    x_.resize(n);
+    y_.resize(n);
+    dx_.resize(n);
+    dy_.resize(n);
+    ddx_.resize(n);
+    ddy_.resize(n);
+    spline.evaluate(
+      sorted_s.data(), n, x_.data(), y_.data(), dx_.data(), dy_.data(), ddx_.data(), ddy_.data());
+    s_.assign(sorted_s.begin(), sorted_s.end());
+    path_geometry::calcFromDerivatives(
+      dx_.data(), dy_.data(), ddx_.data(), ddy_.data(), n, yaw_.data(), curvature_.data());
+  }
+
+  size_t size() const { return s_.size(); }
+
+  // Positions of the last calc (the spline values for the spline variant)
+  const std::vector<double> & getX() const { return x_; }
+  const std::vector<double> & getY() const { return y_; }
+  const std::vector<double> & getArcLength() const { return s_; }
+  const std::vector<double> & getYaw() const { return yaw_; }
+  const std::vector<double> & getCurvature() const { return curvature_; }
+
+private:
+  static const Point & getPosition(const Point & p) { return p; }
+  static const Point & getPosition(const Pose & p) { return p.position; }
+  template <typename PointT>
+  static const Point & getPosition(const PointT & p)
+  {
+    return p.pose.position;
+  }
+
+  void resize(const size_t n)
+  {
+    s_.resize(n);
+    yaw_.resize(n);
+    curvature_.resize(n);
+  }
+
+  std::vector<double> x_, y_;
+  std::vector<double> s_, yaw_, curvature_;
+  std::vector<double> dx_, dy_, ddx_, ddy_;  // spline derivatives
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__PATH_GEOMETRY_HPP_
@@ -0,0 +1,177 @@
+// Re-anchoring of a low rate path to the current ego pose for dual rate planning
+#ifndef PATH_OPTIMIZER__PATH_REANCHOR_HPP_
+#define PATH_OPTIMIZER__PATH_REANCHOR_HPP_
+
+#include "path_optimizer_types.hpp"
+#include "trajectory_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+struct PathReanchorParam
+{
+  double backward_length{5.0};         // kept behind the ego [m]
+  double forward_length{100.0};        // extended to if the path ends closer ahead [m]
+  double extension_interval{1.0};      // spacing of the extended points [m]
+  double max_age_sec{1.0};             // older paths are stale
+  double max_lateral_deviation{1.5};   // ego farther from the path: it does not fit anymore [m]
+  double max_yaw_deviation{0.8};       // [rad]
+};
+
+/**
+ * PathReanchor: keeps the last path of a low rate planner usable at the control rate
+ *
+ * With BPP/BVP running at a fraction of the rate of EBS/PO/MVP, the downstream stages get a new
+ * path only every few cycles. In between, reanchor() aligns the last one with the current ego
+ * pose: points more than backward_length behind the ego are trimmed and, if the path ends less
+ * than forward_length ahead, it is extended along its last segment. The kept points are copied
+ * unchanged (no resampling), so the fixed points and warm starts of the downstream stages stay
+ * valid. A path whose last point has zero velocity ends in a stop or the goal and is not
+ * extended.
+ *
+ * reanchor() reports when the path can not be used anymore (too old, or the ego left it); the
+ * caller then requests a replan from the low rate planner, see PlanningRateDivider.
+ */
+class PathReanchor
+{
+public:
+  enum class Status : uint8_t { Ok, NoPath, Stale, Deviated };
+
+  explicit PathReanchor(const PathReanchorParam & param = {}) : param_(param) {}
+
+  void setParam(const PathReanchorParam & param) { param_ = param; }
+
+  // new path of the low rate planner, planned at stamp_sec
+  void setPath(const std::vector<TrajectoryPoint> & path, const double stamp_sec)
+  {
+    path_.assign(path.begin(), path.end());
+    index_.assign(path_);
+    stamp_sec_ = stamp_sec;
+    hint_.reset();
+  }
+
+  void reset()
+  {
+    path_.clear();
+    index_.assign(path_);
+    hint_.reset();
+  }
+
+  /**
+   * @brief the path around the ego pose
+   * @param output overwritten if the status is Ok, capacity is kept
+   */
+  Status reanchor(
+    const Pose & ego_pose, const double now_sec, std::vector<TrajectoryPoint> & output)
+  {
+    if (path_.size() < 2) {
+      return Status::NoPath;
+    }
+    if (now_sec - stamp_sec_ > param_.max_age_sec) {
+      return Status::Stale;
+    }
+    const auto & p = ego_pose.position;
+    const size_t seg = index_.findNearestSegmentIndex(p, hint_);
+    hint_ = seg;
+    const auto & a = path_[seg].pose.position;
+    const auto & b = path_[seg + 1].pose.position;
+    const double seg_len = std::hypot(b.x - a.x, b.y - a.y);
+    const double lateral =
+      seg_len > 1e-9 ? ((b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x)) / seg_len : 0.0;
+    const double yaw_diff =
+      std::remainder(calcYaw(ego_pose.orientation) - std::atan2(b.y - a.y, b.x - a.x), 2.0 * M_PI);
+    if (
+      std::abs(lateral) > param_.max_lateral_deviation ||
+      std::abs(yaw_diff) > param_.max_yaw_deviation) {
+      return Status::Deviated;
+    }
+
+    // first point at or before ego_s - backward_length
+    const double ego_s = index_.getArcLength(seg) + index_.calcLongitudinalOffset(seg, p.x, p.y);
+    const double start_s = ego_s - param_.backward_length;
+    size_t first = seg;
+    while (first > 0 && index_.getArcLength(first) > start_s) {
+      --first;
+    }
+    output.assign(path_.begin() + static_cast<std::ptrdiff_t>(first), path_.end());
+
+    const auto & last = path_.back();
+    const double remaining = index_.getLength() - ego_s;
+    if (remaining >= param_.forward_length || last.longitudinal_velocity_mps == 0.0) {
+      return Status::Ok;
+    }
+    const auto & prev = path_[path_.size() - 2].pose.position;
+    const double dx = last.pose.position.x - prev.x;
+    const double dy = last.pose.position.y - prev.y;
+    const double len = std::hypot(dx, dy);
+    if (len < 1e-9 || !(param_.extension_interval > 0.0)) {
+      return Status::Ok;
+    }
+    const auto num = static_cast<size_t>(
+      std::ceil((param_.forward_length - remaining) / param_.extension_interval));
+    for (size_t k = 1; k <= num; ++k) {
+      TrajectoryPoint extended = last;
+      extended.pose.position.x += dx / len * param_.extension_interval * static_cast<double>(k);
+      extended.pose.position.y += dy / len * param_.extension_interval * static_cast<double>(k);
+      output.push_back(extended);
+    }
+    return Status::Ok;
+  }
+
+  bool hasPath() const { return path_.size() >= 2; }
+  double getPathStamp() const { return stamp_sec_; }
+
+private:
+  static double calcYaw(const Quaternion & q)
+  {
+    return std::atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+  }
+
+  PathReanchorParam param_;
+  std::vector<TrajectoryPoint> path_;
+  TrajectoryIndex index_;
+  double stamp_sec_{0.0};
+  std::optional<size_t> hint_;
+};
+
+/**
+ * PlanningRateDivider: decides in which control cycles the low rate planner runs
+ *
+ * tick() is true every divisor-th cycle and in the cycle after requestReplan() (e.g. when
+ * PathReanchor reported Stale or Deviated), so a path that does not fit anymore is replaced
+ * immediately instead of at the next regular slot. divisor 1 keeps the single rate behavior.
+ */
+class PlanningRateDivider
+{
+public:
+  explicit PlanningRateDivider(const size_t divisor = 1) : divisor_(std::max<size_t>(divisor, 1))
+  {
+  }
+
+  bool tick()
+  {
+    const bool run = replan_requested_ || counter_ == 0;
+    counter_ = run ? 1 % divisor_ : (counter_ + 1) % divisor_;
+    replan_requested_ = false;
+    return run;
+  }
+
+  void requestReplan() { replan_requested_ = true; }
+  size_t getDivisor() const { return divisor_; }
+
+private:
+  size_t divisor_;
+  size_t counter_{0};
+  bool replan_requested_{false};
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__PATH_REANCHOR_HPP_
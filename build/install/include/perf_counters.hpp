@@ -0,0 +1,172 @@
+// Hardware performance counters (perf_event) for benchmarks and the planning cycle
+#ifndef PATH_OPTIMIZER__PERF_COUNTERS_HPP_
+#define PATH_OPTIMIZER__PERF_COUNTERS_HPP_
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace autoware::path_optimizer
+{
+
+struct PerfCounterValues
+{
+  bool valid{false};
+  double cycles{0.0};
+  double instructions{0.0};
+  double cache_misses{0.0};  // last level cache misses
+  double branch_misses{0.0};
+
+  double ipc() const { return cycles > 0.0 ? instructions / cycles : 0.0; }
+
+  PerfCounterValues & operator+=(const PerfCounterValues & other)
+  {
+    valid = valid || other.valid;
+    cycles += other.cycles;
+    instructions += other.instructions;
+    cache_misses += other.cache_misses;
+    branch_misses += other.branch_misses;
+    return *this;
+  }
+
+  PerfCounterValues scaled(const double factor) const
+  {
+    PerfCounterValues v = *this;
+    v.cycles *= factor;
+    v.instructions *= factor;
+    v.cache_misses *= factor;
+    v.branch_misses *= factor;
+    return v;
+  }
+};
+
+/**
+ * PerfCounterGroup: cycles, instructions, cache misses and branch misses of the calling thread
+ *
+ * The four counters are opened as one perf_event group, so they are scheduled onto the PMU
+ * together and their ratios (IPC, misses per instruction) refer to the same instructions. Only
+ * user space is counted, so the group can be opened with perf_event_paranoid <= 2 and without
+ * CAP_PERFMON. If the PMU is shared with other groups the kernel multiplexes; the values are
+ * scaled by time enabled / time running.
+ *
+ * Where perf_event is not available (containers, VMs without a virtual PMU, paranoid 3) the
+ * group is invalid: error() says why and start()/stop() return invalid values, so callers can
+ * keep running with wall clock time only.
+ *
+ * Low IPC with many cache misses per instruction marks a memory bound kernel, high IPC a compute
+ * bound one; a layout regression usually shows as more cache misses for the same instructions.
+ */
+class PerfCounterGroup
+{
+public:
+  PerfCounterGroup()
+  {
+    constexpr std::array<uint64_t, num_counters> configs = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+      PERF_COUNT_HW_BRANCH_MISSES};
+    for (size_t i = 0; i < num_counters; ++i) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.size = sizeof(attr);
+      attr.config = configs[i];
+      attr.disabled = i == 0 ? 1 : 0;  // the leader starts and stops the group
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format =
+        PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      const int group = i == 0 ? -1 : fds_[0];
+      fds_[i] = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+      if (fds_[i] < 0) {
+        error_ = std::string("perf_event_open: ") + std::strerror(errno);
+        close();
+        return;
+      }
+    }
+  }
+
+  PerfCounterGroup(const PerfCounterGroup &) = delete;
+  PerfCounterGroup & operator=(const PerfCounterGroup &) = delete;
+
+  ~PerfCounterGroup() { close(); }
+
+  bool valid() const { return fds_[0] >= 0; }
+  const std::string & error() const { return error_; }
+
+  void start()
+  {
+    if (valid()) {
+      ::ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ::ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+  }
+
+  // Counts since start()
+  PerfCounterValues stop()
+  {
+    PerfCounterValues values;
+    if (!valid()) {
+      return values;
+    }
+    ::ioctl(fds_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    // nr, time_enabled, time_running, one value per counter
+    std::array<uint64_t, 3 + num_counters> data{};
+    if (::read(fds_[0], data.data(), sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+      return values;
+    }
+    if (data[2] == 0) {
+      return values;  // never scheduled onto the PMU
+    }
+    const double scale = static_cast<double>(data[1]) / static_cast<double>(data[2]);
+    values.valid = true;
+    values.cycles = static_cast<double>(data[3]) * scale;
+    values.instructions = static_cast<double>(data[4]) * scale;
+    values.cache_misses = static_cast<double>(data[5]) * scale;
+    values.branch_misses = static_cast<double>(data[6]) * scale;
+    return values;
+  }
+
+  // Adds the counts of its scope to total, e.g. around the SWC cycle
+  class Scope
+  {
+  public:
+    Scope(PerfCounterGroup & group, PerfCounterValues & total) : group_(group), total_(total)
+    {
+      group_.start();
+    }
+    Scope(const Scope &) = delete;
+    Scope & operator=(const Scope &) = delete;
+    ~Scope() { total_ += group_.stop(); }
+
+  private:
+    PerfCounterGroup & group_;
+    PerfCounterValues & total_;
+  };
+
+private:
+  static constexpr size_t num_counters = 4;
+
+  void close()
+  {
+    for (auto & fd : fds_) {
+      if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+      }
+    }
+  }
+
+  std::array<int, num_counters> fds_{-1, -1, -1, -1};
+  std::string error_;
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__PERF_COUNTERS_HPP_
@@ -0,0 +1,51 @@
+// Non-verbose log messages of the planning hot paths
+#ifndef PATH_OPTIMIZER__PLANNING_LOG_MESSAGES_HPP_
+#define PATH_OPTIMIZER__PLANNING_LOG_MESSAGES_HPP_
+
+#include "nonverbose_log.hpp"
+
+#include <cstdint>
+
+namespace autoware::path_optimizer::log_messages
+{
+
+// Id ranges: 0x1000 MPTOptimizer, 0x2000 planner_manager, 0x3000 port callbacks.
+// Ids are part of the offline catalog: never reuse or renumber an id, retire it instead.
+
+// MPTOptimizer
+PO_NV_LOG_MESSAGE(
+  mpt_cycle, 0x1001, Debug, "MPT: {} reference points, {} fixed, horizon {} m", uint32_t,
+  uint32_t, double);
+PO_NV_LOG_MESSAGE(
+  mpt_qp_solved, 0x1002, Verbose, "MPT: QP solved in {} us, {} iterations", int64_t, int32_t);
+PO_NV_LOG_MESSAGE(
+  mpt_qp_failed, 0x1003, Warn, "MPT: QP failed with status {} after {} iterations", int32_t,
+  int32_t);
+PO_NV_LOG_MESSAGE(
+  mpt_fallback, 0x1004, Warn, "MPT: using the previous trajectory, {} cycles in a row",
+  uint32_t);
+PO_NV_LOG_MESSAGE(
+  mpt_bounds_violated, 0x1005, Debug, "MPT: point {} out of the drivable area by {} m", uint32_t,
+  double);
+
+// planner_manager of the behavior path planner
+PO_NV_LOG_MESSAGE(
+  planner_manager_run, 0x2001, Debug, "planner_manager: {} approved, {} candidate modules, {} us",
+  uint32_t, uint32_t, int64_t);
+PO_NV_LOG_MESSAGE(
+  planner_manager_module, 0x2002, Verbose, "planner_manager: module {} ran in {} us", uint32_t,
+  int64_t);
+PO_NV_LOG_MESSAGE(
+  planner_manager_reset, 0x2003, Info, "planner_manager: reset, {} modules cleared", uint32_t);
+
+// Port callbacks
+PO_NV_LOG_MESSAGE(
+  port_received, 0x3001, Verbose, "port {}: sample received, {} points, latency {} us", uint32_t,
+  uint32_t, int64_t);
+PO_NV_LOG_MESSAGE(
+  port_dropped, 0x3002, Warn, "port {}: {} samples dropped (queue full)", uint32_t, uint32_t);
+PO_NV_LOG_MESSAGE(port_stale, 0x3003, Warn, "port {}: input older than {} ms", uint32_t, double);
+
+}  // namespace autoware::path_optimizer::log_messages
+
+#endif  // PATH_OPTIMIZER__PLANNING_LOG_MESSAGES_HPP_
@@ -0,0 +1,274 @@
+// Predicted paths of obstacles resampled once per cycle onto a shared time grid
+#ifndef PATH_OPTIMIZER__PREDICTED_PATH_CACHE_HPP_
+#define PATH_OPTIMIZER__PREDICTED_PATH_CACHE_HPP_
+
+#include "path_optimizer_types.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+struct PredictedPathCacheParam
+{
+  double time_step{0.1};     // [s] of the shared grid
+  double max_horizon{10.0};  // [s] of the predictions that is kept, from the prediction stamp
+};
+
+/**
+ * PredictedPathCache: predicted paths of all obstacles on one time grid, structure of arrays
+ *
+ * The cruise planner and the collision checks need the obstacle poses at the times of the ego
+ * trajectory, and interpolating the predicted paths there for every check repeats the same pose
+ * search and interpolation many times per cycle. Here every predicted path is resampled once onto
+ * the grid t_k = k * time_step of absolute time (the grid does not move with the cycle), and the
+ * positions and headings of all paths are kept in flat arrays. A check then indexes a path by the
+ * step of the cycle grid, which starts at the first grid time at or after now:
+ *
+ *   cache.beginCycle(now);
+ *   for (const auto & object : objects) {
+ *     for (size_t p = 0; p < paths.size(); ++p) {
+ *       cache.addPath(key_of(object), p, message_stamp, paths[p].path, time_step, confidence);
+ *     }
+ *   }
+ *   cache.endCycle();
+ *   for (size_t i = 0; i < cache.size(); ++i) {
+ *     const auto path = cache.path(i);
+ *     for (size_t k = path.first_step; k < path.end_step; ++k) {   // k = step of the cycle grid
+ *       ... path.x(k), path.y(k), path.ux(k), path.uy(k) at cache.cycleTime(k) ...
+ *     }
+ *   }
+ *
+ * Since the grid is absolute, a prediction that did not change since the last cycle (same object
+ * key, path index, stamp and poses, compared by a hash) has the same samples: they are copied
+ * from the previous cycle instead of being interpolated again, and only the first step of the
+ * cycle grid moves. Paths not added in a cycle are dropped at endCycle. The buffers keep their
+ * capacity, so a steady-state cycle does not allocate.
+ */
+class PredictedPathCache
+{
+public:
+  // Samples of one path on the cycle grid, steps [first_step, end_step)
+  struct PathView
+  {
+    uint64_t object_key;
+    size_t path_index;
+    double confidence;
+    size_t first_step;
+    size_t end_step;
+
+    bool contains(const size_t k) const { return first_step <= k && k < end_step; }
+    double x(const size_t k) const { return x_[k - offset_]; }
+    double y(const size_t k) const { return y_[k - offset_]; }
+    double ux(const size_t k) const { return ux_[k - offset_]; }  // heading cosine
+    double uy(const size_t k) const { return uy_[k - offset_]; }  // heading sine
+
+    const double * x_;
+    const double * y_;
+    const double * ux_;
+    const double * uy_;
+    int64_t offset_;  // cycle step of x_[0]
+  };
+
+  explicit PredictedPathCache(const PredictedPathCacheParam & param = {}) : param_(param) {}
+
+  // Starts a cycle at the time now [s] (same clock as the prediction stamps)
+  void beginCycle(const double now)
+  {
+    std::swap(entries_, prev_entries_);
+    std::swap(x_, prev_x_);
+    std::swap(y_, prev_y_);
+    std::swap(ux_, prev_ux_);
+    std::swap(uy_, prev_uy_);
+    std::swap(lookup_, prev_lookup_);
+    entries_.clear();
+    x_.clear();
+    y_.clear();
+    ux_.clear();
+    uy_.clear();
+    lookup_.clear();
+    cycle_step_ = static_cast<int64_t>(std::ceil(now / param_.time_step - 1e-9));
+    num_reused_ = 0;
+    num_resampled_ = 0;
+  }
+
+  /**
+   * @brief Add one predicted path of an object
+   * @param object_key identifies the object across cycles, e.g. a hash of its uuid
+   * @param stamp [s] time of the first pose
+   * @param time_step [s] between the poses
+   */
+  void addPath(
+    const uint64_t object_key, const size_t path_index, const double stamp,
+    const std::vector<Pose> & path, const double time_step, const double confidence)
+  {
+    if (path.empty() || !(time_step > 0.0)) {
+      return;
+    }
+    const uint64_t key = combine(object_key, path_index);
+    const uint64_t hash = hashPath(stamp, path, time_step);
+    Entry entry{object_key, path_index, hash, confidence, 0, x_.size(), 0};
+
+    const auto prev = prev_lookup_.find(key);
+    if (prev != prev_lookup_.end() && prev_entries_[prev->second].hash == hash) {
+      const auto & p = prev_entries_[prev->second];
+      entry.first_step = p.first_step;
+      entry.num_steps = p.num_steps;
+      append(prev_x_, x_, p.begin, p.num_steps);
+      append(prev_y_, y_, p.begin, p.num_steps);
+      append(prev_ux_, ux_, p.begin, p.num_steps);
+      append(prev_uy_, uy_, p.begin, p.num_steps);
+      ++num_reused_;
+    } else {
+      resample(stamp, path, time_step, entry);
+      ++num_resampled_;
+    }
+    lookup_[key] = entries_.size();
+    entries_.push_back(entry);
+  }
+
+  // Ends the cycle; views are valid until the next beginCycle
+  void endCycle() { prev_lookup_.clear(); }
+
+  size_t size() const { return entries_.size(); }
+  size_t numReused() const { return num_reused_; }
+  size_t numResampled() const { return num_resampled_; }
+  double timeStep() const { return param_.time_step; }
+
+  // [s] absolute time of step k of the cycle grid
+  double cycleTime(const size_t k) const
+  {
+    return static_cast<double>(cycle_step_ + static_cast<int64_t>(k)) * param_.time_step;
+  }
+  // Step of the cycle grid nearest to the absolute time t, 0 for times before the cycle
+  size_t cycleStep(const double t) const
+  {
+    const int64_t step = static_cast<int64_t>(std::llround(t / param_.time_step)) - cycle_step_;
+    return step > 0 ? static_cast<size_t>(step) : 0;
+  }
+
+  PathView path(const size_t i) const
+  {
+    const auto & e = entries_[i];
+    const int64_t offset = e.first_step - cycle_step_;  // cycle step of the first sample
+    const int64_t end = offset + static_cast<int64_t>(e.num_steps);
+    PathView view{
+      e.object_key,
+      e.path_index,
+      e.confidence,
+      static_cast<size_t>(std::max<int64_t>(offset, 0)),
+      static_cast<size_t>(std::max<int64_t>(end, 0)),
+      x_.data() + e.begin,
+      y_.data() + e.begin,
+      ux_.data() + e.begin,
+      uy_.data() + e.begin,
+      offset};
+    view.first_step = std::min(view.first_step, view.end_step);
+    return view;
+  }
+
+private:
+  struct Entry
+  {
+    uint64_t object_key;
+    size_t path_index;
+    uint64_t hash;
+    double confidence;
+    int64_t first_step;  // absolute grid step of the first sample
+    size_t begin;        // of the samples in the arrays
+    size_t num_steps;
+  };
+
+  static uint64_t combine(const uint64_t object_key, const size_t path_index)
+  {
+    return object_key ^ (static_cast<uint64_t>(path_index) * 0x9e3779b97f4a7c15ULL +
+                         (object_key << 6U) + (object_key >> 2U));
+  }
+
+  // FNV-1a over the bits of the stamp, the time step and the planar poses
+  static uint64_t hashPath(
+    const double stamp, const std::vector<Pose> & path, const double time_step)
+  {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    auto add = [&hash](const double value) {
+      uint64_t bits = 0;
+      std::memcpy(&bits, &value, sizeof(bits));
+      hash = (hash ^ bits) * 0x100000001b3ULL;
+    };
+    add(stamp);
+    add(time_step);
+    for (const auto & pose : path) {
+      add(pose.position.x);
+      add(pose.position.y);
+      add(pose.orientation.z);
+      add(pose.orientation.w);
+    }
+    return hash;
+  }
+
+  static void append(
+    const std::vector<double> & from, std::vector<double> & to, const size_t begin, const size_t n)
+  {
+    to.insert(to.end(), from.begin() + begin, from.begin() + begin + n);
+  }
+
+  // Linear interpolation of the position and of the yaw (shortest way) at the grid times
+  void resample(
+    const double stamp, const std::vector<Pose> & path, const double time_step, Entry & entry)
+  {
+    const double duration =
+      std::min(static_cast<double>(path.size() - 1) * time_step, param_.max_horizon);
+    const auto first = static_cast<int64_t>(std::ceil(stamp / param_.time_step - 1e-9));
+    const auto last =
+      static_cast<int64_t>(std::floor((stamp + duration) / param_.time_step + 1e-9));
+    entry.first_step = first;
+    entry.num_steps = last >= first ? static_cast<size_t>(last - first + 1) : 0;
+
+    yaw_.resize(path.size());
+    for (size_t i = 0; i < path.size(); ++i) {
+      const auto & q = path[i].orientation;
+      yaw_[i] = std::atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+    }
+
+    size_t seg = 0;
+    for (size_t k = 0; k < entry.num_steps; ++k) {
+      const double t = static_cast<double>(first + static_cast<int64_t>(k)) * param_.time_step;
+      const double u = std::max((t - stamp) / time_step, 0.0);
+      while (seg + 2 < path.size() && static_cast<double>(seg + 1) <= u) {
+        ++seg;
+      }
+      const size_t next = std::min(seg + 1, path.size() - 1);
+      const double ratio = next == seg ? 0.0 : std::min(u - static_cast<double>(seg), 1.0);
+      const auto & p0 = path[seg].position;
+      const auto & p1 = path[next].position;
+      const double yaw =
+        yaw_[seg] + ratio * std::remainder(yaw_[next] - yaw_[seg], 2.0 * M_PI);
+      x_.push_back(p0.x + ratio * (p1.x - p0.x));
+      y_.push_back(p0.y + ratio * (p1.y - p0.y));
+      ux_.push_back(std::cos(yaw));
+      uy_.push_back(std::sin(yaw));
+    }
+  }
+
+  PredictedPathCacheParam param_;
+  int64_t cycle_step_{0};
+  size_t num_reused_{0};
+  size_t num_resampled_{0};
+
+  std::vector<Entry> entries_, prev_entries_;
+  std::vector<double> x_, y_, ux_, uy_;
+  std::vector<double> prev_x_, prev_y_, prev_ux_, prev_uy_;
+  std::unordered_map<uint64_t, size_t> lookup_, prev_lookup_;
+  std::vector<double> yaw_;  // scratch
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__PREDICTED_PATH_CACHE_HPP_
@@ -0,0 +1,275 @@
+// QP Solver Backend abstraction for Path Optimizer
+#ifndef PATH_OPTIMIZER__QP_SOLVER_BACKEND_HPP_
+#define PATH_OPTIMIZER__QP_SOLVER_BACKEND_HPP_
+
+#include "osqp_interface.hpp"
+#include "riccati_admm_solver.hpp"
+#include "vehicle_model.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+struct QPResult
+{
+  std::vector<double> primal;  // Optimal decision variables
+  std::vector<double> dual;    // Lagrange multipliers of the constraints
+  int status{0};               // Backend specific status value
+  int iterations{0};
+  bool is_solved{false};
+};
+
+/**
+ * QPSolverBackend: common interface of the QP solvers used by MPTOptimizer
+ *
+ *   minimize    0.5 * x^T P x + q^T x
+ *   subject to  l <= A x <= u
+ *
+ * P is passed as upper triangular CSC (calCSCMatrixTrapezoidal), A as full CSC (calCSCMatrix).
+ * Backends are free to keep internal state (workspace, factorization) between setProblem calls.
+ */
+class QPSolverBackend
+{
+public:
+  virtual ~QPSolverBackend() = default;
+
+  virtual std::string getName() const = 0;
+
+  virtual void setProblem(
+    const CSC_Matrix & P, const CSC_Matrix & A, const std::vector<double> & q,
+    const std::vector<double> & l, const std::vector<double> & u) = 0;
+
+  // Initial guess for the next solve; an empty dual keeps the backend default
+  virtual void setWarmStart(
+    const std::vector<double> & primal_vars, const std::vector<double> & dual_vars = {}) = 0;
+
+  virtual QPResult solve() = 0;
+
+  // Limits for the next solves (time_limit_sec 0: none, max_iter 0: keep the backend default); a
+  // limited solve returns the last iterate with is_solved false. Backends without such limits
+  // ignore them.
+  virtual void setSolveLimits(const double /*time_limit_sec*/, const int /*max_iter*/) {}
+
+  size_t getNumSetups() const { return num_setups_; }
+  size_t getNumUpdates() const { return num_updates_; }
+
+protected:
+  size_t num_setups_{0};   // Full setups (new workspace)
+  size_t num_updates_{0};  // Value-only updates of an existing workspace
+};
+
+#ifdef USE_OSQP
+
+/**
+ * OSQPBackend: OSQPInterface behind QPSolverBackend
+ *
+ * The workspace is kept across setProblem calls and only rebuilt when the P/A sparsity pattern
+ * changes, so the KKT symbolic factorization is skipped in steady state.
+ */
+class OSQPBackend : public QPSolverBackend
+{
+public:
+  explicit OSQPBackend(const double eps_abs) : eps_abs_(eps_abs) {}
+
+  std::string getName() const override { return "osqp"; }
+
+  void setProblem(
+    const CSC_Matrix & P, const CSC_Matrix & A, const std::vector<double> & q,
+    const std::vector<double> & l, const std::vector<double> & u) override
+  {
+    const bool is_same_pattern =
+      osqp_solver_ptr_ && hasSameSparsity(P, prev_P_) && hasSameSparsity(A, prev_A_);
+    if (is_same_pattern) {
+      osqp_solver_ptr_->updateCscP(P);
+      osqp_solver_ptr_->updateQ(q);
+      osqp_solver_ptr_->updateCscA(A);
+      osqp_solver_ptr_->updateBounds(l, u);
+      ++num_updates_;
+    } else {
+      osqp_solver_ptr_ = std::make_unique<OSQPInterface>(P, A, q, l, u, eps_abs_);
+      if (max_iter_ > 0 || time_limit_sec_ > 0.0) {
+        osqp_solver_ptr_->setSolveLimits(time_limit_sec_, max_iter_);
+      }
+      ++num_setups_;
+    }
+    prev_P_ = P;
+    prev_A_ = A;
+  }
+
+  void setWarmStart(
+    const std::vector<double> & primal_vars, const std::vector<double> & dual_vars = {}) override
+  {
+    if (osqp_solver_ptr_) {
+      osqp_solver_ptr_->setWarmStart(primal_vars, dual_vars);
+    }
+  }
+
+  void setSolveLimits(const double time_limit_sec, const int max_iter) override
+  {
+    time_limit_sec_ = time_limit_sec;
+    max_iter_ = max_iter;
+    if (osqp_solver_ptr_) {
+      osqp_solver_ptr_->setSolveLimits(time_limit_sec, max_iter);
+    }
+  }
+
+  QPResult solve() override
+  {
+    QPResult result;
+    if (!osqp_solver_ptr_) {
+      return result;
+    }
+
+    // [primal, dual, polish status, solution status, iterations]
+    const auto osqp_result = osqp_solver_ptr_->optimize();
+    result.primal = std::get<0>(osqp_result);
+    result.dual = std::get<1>(osqp_result);
+    result.status = std::get<3>(osqp_result);
+    result.iterations = std::get<4>(osqp_result);
+    result.is_solved = result.status == 1;  // OSQP_SOLVED
+    if (!result.is_solved) {
+      osqp_solver_ptr_->logUnsolvedStatus("[MPT]");
+    }
+    return result;
+  }
+
+private:
+  double eps_abs_;
+  double time_limit_sec_{0.0};  // 0: none
+  int max_iter_{0};             // 0: OSQP settings of OSQPInterface
+  std::unique_ptr<OSQPInterface> osqp_solver_ptr_;
+  CSC_Matrix prev_P_;
+  CSC_Matrix prev_A_;
+};
+
+#endif  // USE_OSQP
+
+/**
+ * RiccatiADMMBackend: RiccatiADMMSolverT for the sparse MPT formulation, OSQP otherwise
+ *
+ * Problems that do not have the stage-wise layout of MPTQPBuilder (SPARSE), e.g. the condensed
+ * formulation, are passed to an OSQPBackend, so the backend can be used for every MPT problem.
+ * Without USE_OSQP such problems are reported as not solved. getNumSetups()/getNumUpdates() count
+ * the setProblem calls of both paths: a stage-wise problem is an update, a fallback problem counts
+ * as the OSQPBackend counted it.
+ */
+class RiccatiADMMBackend : public QPSolverBackend
+{
+public:
+  using Solver = RiccatiADMMSolverT<VehicleModel::DimX, VehicleModel::DimU>;
+
+  explicit RiccatiADMMBackend(const double eps_abs) : eps_abs_(eps_abs)
+  {
+    Solver::Settings settings;
+    settings.eps_abs = eps_abs;
+    settings.eps_rel = eps_abs;
+    solver_.setSettings(settings);
+  }
+
+  std::string getName() const override
+  {
+    return use_fallback_ ? "riccati_admm(osqp)" : "riccati_admm";
+  }
+
+  void setProblem(
+    const CSC_Matrix & P, const CSC_Matrix & A, const std::vector<double> & q,
+    const std::vector<double> & l, const std::vector<double> & u) override
+  {
+    use_fallback_ = !solver_.setProblem(P, A, q, l, u);
+    if (!use_fallback_) {
+      ++num_updates_;  // no workspace to set up, the factorization is O(N)
+      return;
+    }
+#ifdef USE_OSQP
+    if (!fallback_) {
+      fallback_ = std::make_unique<OSQPBackend>(eps_abs_);
+      if (max_iter_ > 0 || time_limit_sec_ > 0.0) {
+        fallback_->setSolveLimits(time_limit_sec_, max_iter_);
+      }
+    }
+    const size_t prev_fallback_setups = fallback_->getNumSetups();
+    const size_t prev_fallback_updates = fallback_->getNumUpdates();
+    fallback_->setProblem(P, A, q, l, u);
+    num_setups_ += fallback_->getNumSetups() - prev_fallback_setups;
+    num_updates_ += fallback_->getNumUpdates() - prev_fallback_updates;
+#endif
+  }
+
+  void setWarmStart(
+    const std::vector<double> & primal_vars, const std::vector<double> & dual_vars = {}) override
+  {
+    if (!use_fallback_) {
+      solver_.setWarmStart(primal_vars, dual_vars);
+    } else if (fallback_) {
+      fallback_->setWarmStart(primal_vars, dual_vars);
+    }
+  }
+
+  void setSolveLimits(const double time_limit_sec, const int max_iter) override
+  {
+    auto settings = solver_.getSettings();
+    settings.time_limit_sec = time_limit_sec;
+    if (max_iter > 0) {
+      settings.max_iter = max_iter;
+    }
+    solver_.setSettings(settings);
+    time_limit_sec_ = time_limit_sec;
+    max_iter_ = max_iter;
+    if (fallback_) {
+      fallback_->setSolveLimits(time_limit_sec, max_iter);
+    }
+  }
+
+  QPResult solve() override
+  {
+    if (use_fallback_) {
+      return fallback_ ? fallback_->solve() : QPResult{};
+    }
+    QPResult result;
+    result.is_solved = solver_.solve(result.primal, result.dual, result.iterations);
+    result.status = result.is_solved ? 1 : 0;  // OSQP_SOLVED convention
+    return result;
+  }
+
+  // True if the last problem did not have the stage-wise layout
+  bool isUsingFallback() const { return use_fallback_; }
+
+private:
+  double eps_abs_;
+  double time_limit_sec_{0.0};  // 0: none, kept for the fallback
+  int max_iter_{0};             // 0: OSQP settings of OSQPInterface
+  Solver solver_;
+  bool use_fallback_{false};
+  std::unique_ptr<QPSolverBackend> fallback_;
+};
+
+enum class QPSolverType {
+  OSQP,
+  RICCATI_ADMM,  // Stage-wise ADMM for the sparse formulation, OSQP for others
+};
+
+// Returns nullptr if the requested backend is not compiled in
+inline std::unique_ptr<QPSolverBackend> createQPSolverBackend(
+  const QPSolverType type, const double eps_abs)
+{
+  switch (type) {
+    case QPSolverType::OSQP:
+#ifdef USE_OSQP
+      return std::make_unique<OSQPBackend>(eps_abs);
+#else
+      (void)eps_abs;
+      return nullptr;
+#endif
+    case QPSolverType::RICCATI_ADMM:
+      return std::make_unique<RiccatiADMMBackend>(eps_abs);
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__QP_SOLVER_BACKEND_HPP_
@@ -0,0 +1,96 @@
+// Process setup for running a planning executable with the real-time profile
+#ifndef PATH_OPTIMIZER__REALTIME_SETUP_HPP_
+#define PATH_OPTIMIZER__REALTIME_SETUP_HPP_
+
+#include <alloca.h>
+#include <malloc.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * Memory locking for the real-time profile (tool/rt_profile.py)
+ *
+ * Scheduling policy, priority and core affinity are applied by EM from the execution manifest.
+ * Page faults are not: without locking, the first touch of heap pages and pages reclaimed under
+ * memory pressure cost page faults inside the planning cycle. lockMemory() locks all current and
+ * future pages, stops glibc from returning freed heap memory to the kernel and from serving large
+ * allocations with fresh mmaps, and touches the given amount of heap and stack once, so later
+ * allocations up to that size are served from resident memory.
+ */
+struct RealtimeMemoryConfig
+{
+  size_t prefault_heap_bytes{64U * 1024U * 1024U};
+  size_t prefault_stack_bytes{512U * 1024U};
+};
+
+/**
+ * @brief Locks and prefaults memory, call once at startup before the worker threads are created
+ * @param error set to the failing step if false is returned (e.g. missing CAP_IPC_LOCK)
+ */
+inline bool lockMemory(const RealtimeMemoryConfig & config, std::string * error = nullptr)
+{
+  // Freed memory stays in the heap and large blocks come from the (prefaulted) heap too
+  mallopt(M_TRIM_THRESHOLD, -1);
+  mallopt(M_MMAP_MAX, 0);
+
+  if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+    if (error) {
+      *error = std::string("mlockall: ") + std::strerror(errno);
+    }
+    return false;
+  }
+
+  const auto page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  if (config.prefault_heap_bytes > 0) {
+    auto * heap = static_cast<volatile char *>(std::malloc(config.prefault_heap_bytes));
+    if (!heap) {
+      if (error) {
+        *error = "prefault: heap allocation failed";
+      }
+      return false;
+    }
+    for (size_t i = 0; i < config.prefault_heap_bytes; i += page) {
+      heap[i] = 0;
+    }
+    std::free(const_cast<char *>(heap));  // stays in the heap because trimming is disabled
+  }
+
+  if (config.prefault_stack_bytes > 0) {
+    auto * stack = static_cast<volatile char *>(alloca(config.prefault_stack_bytes));
+    for (size_t i = 0; i < config.prefault_stack_bytes; i += page) {
+      stack[i] = 0;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief lockMemory() configured by the environment of the execution manifest
+ *
+ * PLANNING_RT_MLOCK=1 enables it, PLANNING_RT_PREFAULT_HEAP_MB overrides the heap size. Returns
+ * true if locking is disabled.
+ */
+inline bool lockMemoryFromEnvironment(std::string * error = nullptr)
+{
+  const char * enabled = std::getenv("PLANNING_RT_MLOCK");
+  if (!enabled || std::strcmp(enabled, "1") != 0) {
+    return true;
+  }
+  RealtimeMemoryConfig config;
+  if (const char * heap_mb = std::getenv("PLANNING_RT_PREFAULT_HEAP_MB")) {
+    config.prefault_heap_bytes = std::strtoul(heap_mb, nullptr, 10) * 1024U * 1024U;
+  }
+  return lockMemory(config, error);
+}
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__REALTIME_SETUP_HPP_
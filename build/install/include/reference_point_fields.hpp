@@ -0,0 +1,159 @@
+// Derived ReferencePoint fields computed in dedicated passes, only where they are needed
+#ifndef PATH_OPTIMIZER__REFERENCE_POINT_FIELDS_HPP_
+#define PATH_OPTIMIZER__REFERENCE_POINT_FIELDS_HPP_
+
+#include "path_optimizer_types.hpp"
+#include "path_geometry.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+// Derived fields of ReferencePoint that are not needed by every cycle
+enum class ReferencePointField : uint32_t {
+  Curvature = 1U << 0U,          // state equation, only with enableRefCurvature
+  Alpha = 1U << 1U,              // yaw of the front wheel position relative to the point (debug)
+  PoseOnConstraints = 1U << 2U,  // poses of the vehicle circles (debug markers)
+};
+
+/**
+ * ReferencePointFields: set of ReferencePointField
+ *
+ * generateReferencePoints fills pose, delta_arc_length, bounds and bounds_on_constraints, which
+ * every solve needs, and Curvature only if the state equation uses it. The debug set is filled by
+ * MPTOptimizer::getDebugReferencePoints(), on a copy, so a cycle without a debug subscriber does
+ * not compute it at all.
+ */
+class ReferencePointFields
+{
+public:
+  constexpr ReferencePointFields() = default;
+  constexpr ReferencePointFields(const ReferencePointField field)  // NOLINT
+  : mask_(static_cast<uint32_t>(field))
+  {
+  }
+
+  static constexpr ReferencePointFields debug()
+  {
+    return ReferencePointFields(ReferencePointField::Alpha) |
+           ReferencePointField::PoseOnConstraints;
+  }
+
+  constexpr bool has(const ReferencePointField field) const
+  {
+    return (mask_ & static_cast<uint32_t>(field)) != 0U;
+  }
+  constexpr bool empty() const { return mask_ == 0U; }
+
+  constexpr ReferencePointFields operator|(const ReferencePointFields other) const
+  {
+    ReferencePointFields fields;
+    fields.mask_ = mask_ | other.mask_;
+    return fields;
+  }
+
+private:
+  uint32_t mask_{0U};
+};
+
+// Three point curvature of the reference point positions (path_geometry::calcCurvature)
+inline void calcReferencePointCurvature(
+  std::vector<ReferencePoint> & ref_points, std::vector<double> & x, std::vector<double> & y,
+  std::vector<double> & curvature)
+{
+  const size_t n = ref_points.size();
+  x.resize(n);
+  y.resize(n);
+  curvature.resize(n);
+  for (size_t i = 0; i < n; ++i) {
+    x[i] = ref_points[i].pose.position.x;
+    y[i] = ref_points[i].pose.position.y;
+  }
+  path_geometry::calcCurvature(x.data(), y.data(), n, curvature.data());
+  for (size_t i = 0; i < n; ++i) {
+    ref_points[i].curvature = curvature[i];
+  }
+}
+
+// Angle from the yaw of each point to the direction of the position wheelbase ahead of it along
+// the points (as the alpha of the autoware MPT); one forward cursor, the last points use their
+// own yaw
+inline void calcReferencePointAlpha(
+  std::vector<ReferencePoint> & ref_points, const double wheelbase)
+{
+  const size_t n = ref_points.size();
+  auto yawOf = [](const Quaternion & q) {
+    return std::atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+  };
+  size_t j = 0;
+  double s_j = 0.0;  // arc length from point i to point j
+  for (size_t i = 0; i < n; ++i) {
+    if (i > 0) {
+      s_j -= ref_points[i - 1].delta_arc_length;
+    }
+    if (j < i) {
+      j = i;
+      s_j = 0.0;
+    }
+    while (j + 1 < n && s_j < wheelbase) {
+      s_j += ref_points[j].delta_arc_length;
+      ++j;
+    }
+    auto & p = ref_points[i];
+    const double yaw = yawOf(p.pose.orientation);
+    const double dx = ref_points[j].pose.position.x - p.pose.position.x;
+    const double dy = ref_points[j].pose.position.y - p.pose.position.y;
+    const double front_wheel_yaw = dx * dx + dy * dy > 1e-6 ? std::atan2(dy, dx) : yaw;
+    p.alpha = std::remainder(front_wheel_yaw - yaw, 2.0 * M_PI);
+  }
+}
+
+// Centers of the vehicle circles as poses (orientation of the reference point)
+inline void calcPosesOnConstraints(
+  std::vector<ReferencePoint> & ref_points, const std::vector<double> & circle_offsets)
+{
+  for (auto & p : ref_points) {
+    const auto & q = p.pose.orientation;
+    const double yaw =
+      std::atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+    const double tx = std::cos(yaw);
+    const double ty = std::sin(yaw);
+    p.pose_on_constraints.resize(circle_offsets.size());
+    for (size_t j = 0; j < circle_offsets.size(); ++j) {
+      p.pose_on_constraints[j] = p.pose;
+      p.pose_on_constraints[j].position.x += circle_offsets[j] * tx;
+      p.pose_on_constraints[j].position.y += circle_offsets[j] * ty;
+    }
+  }
+}
+
+// Fills the requested fields; keeps its scratch buffers across cycles
+class ReferencePointFieldCalculator
+{
+public:
+  void calc(
+    std::vector<ReferencePoint> & ref_points, const ReferencePointFields fields,
+    const double wheelbase, const std::vector<double> & circle_offsets)
+  {
+    if (fields.has(ReferencePointField::Curvature)) {
+      calcReferencePointCurvature(ref_points, x_, y_, curvature_);
+    }
+    if (fields.has(ReferencePointField::Alpha)) {
+      calcReferencePointAlpha(ref_points, wheelbase);
+    }
+    if (fields.has(ReferencePointField::PoseOnConstraints)) {
+      calcPosesOnConstraints(ref_points, circle_offsets);
+    }
+  }
+
+private:
+  std::vector<double> x_, y_, curvature_;
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__REFERENCE_POINT_FIELDS_HPP_
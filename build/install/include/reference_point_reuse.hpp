@@ -0,0 +1,227 @@
+// Reuse of the previous MPT reference points where the new horizon overlaps them
+#ifndef PATH_OPTIMIZER__REFERENCE_POINT_REUSE_HPP_
+#define PATH_OPTIMIZER__REFERENCE_POINT_REUSE_HPP_
+
+#include "path_optimizer_types.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+struct ReferencePointReuseParam
+{
+  double max_path_deviation{0.01};  // [m] of a reused point from the current trajectory
+  double max_bound_deviation{0.01};  // [m] of the bound vertices from the previous bounds
+  double max_spacing_error{1e-3};   // [m] of the previous delta_arc_length
+};
+
+/**
+ * ReferencePointReuse: takes the overlap of the new horizon from the previous reference points
+ *
+ * From cycle to cycle the horizon moves by the distance the ego drove, while the path and the
+ * drivable area usually stay the same. The previous points are aligned with the new start by arc
+ * length (projection onto the previous reference polyline), and the new horizon starts at the last
+ * previous point at or before it, so the new arc length grid is the previous one: the overlapping
+ * points are the same points and are copied with their geometry (pose, curvature), bounds,
+ * bounds_on_constraints and avoidance terms. Only the points after the end of the previous ones are
+ * generated from the trajectory again. The start of the horizon is at most one delta_arc_length
+ * behind the requested start.
+ *
+ * Nothing is reused if
+ *   - the left or right bound changed: a vertex of the new bound is farther than
+ *     max_bound_deviation from the previous one or the other way round; vertices beyond the ends
+ *     of the other polyline are not compared, so the bounds may be cropped behind the ego and
+ *     extended at the end from cycle to cycle,
+ *   - a previous point is farther than max_path_deviation from the current trajectory (the path
+ *     changed; the check is one forward sweep over both),
+ *   - the previous points are not spaced by delta_arc_length (the spacing was changed, e.g. by
+ *     AdaptiveHorizon).
+ * The per-cycle results (fixed and optimized kinematic state, input) are cleared in the copies,
+ * longitudinal_velocity_mps is taken from the current trajectory.
+ */
+class ReferencePointReuse
+{
+public:
+  explicit ReferencePointReuse(const ReferencePointReuseParam & param = {}) : param_(param) {}
+
+  /**
+   * @brief Copy the overlap of the previous reference points to the front of ref_points
+   * @param start requested start of the horizon (e.g. the ego position projected onto the path)
+   * @param ref_points resized to the reused points; the caller appends the others from the
+   * trajectory, recomputes the curvature of the last reused point (its neighbour is new) and
+   * computes the bounds from the first new point on (BoundsCalculator, begin)
+   * @return number of reused points, 0 if the previous points cannot be used
+   */
+  size_t reuse(
+    const std::vector<ReferencePoint> & prev_ref_points,
+    const std::vector<TrajectoryPoint> & traj_points, const std::vector<Point> & left_bound,
+    const std::vector<Point> & right_bound, const Point & start, const double delta_arc_length,
+    const size_t num_points, std::vector<ReferencePoint> & ref_points)
+  {
+    ref_points.clear();
+    const bool bounds_changed = !has_prev_bounds_ || !matchBound(prev_left_bound_, left_bound) ||
+                                !matchBound(prev_right_bound_, right_bound);
+    prev_left_bound_.assign(left_bound.begin(), left_bound.end());
+    prev_right_bound_.assign(right_bound.begin(), right_bound.end());
+    has_prev_bounds_ = true;
+    if (bounds_changed || prev_ref_points.size() < 2 || traj_points.size() < 2) {
+      return 0;
+    }
+
+    const size_t first = findStartIndex(prev_ref_points, start);
+    const size_t count = std::min(num_points, prev_ref_points.size() - first);
+    for (size_t i = first; i + 1 < first + count; ++i) {
+      const double spacing_error = prev_ref_points[i].delta_arc_length - delta_arc_length;
+      if (std::abs(spacing_error) > param_.max_spacing_error) {
+        return 0;
+      }
+    }
+
+    ref_points.assign(prev_ref_points.begin() + first, prev_ref_points.begin() + first + count);
+    if (!matchTrajectory(traj_points, ref_points)) {
+      ref_points.clear();
+      return 0;
+    }
+    for (auto & p : ref_points) {
+      p.fixed_kinematic_state.reset();
+      p.optimized_kinematic_state = KinematicState{};
+      p.optimized_input = 0.0;
+    }
+    return count;
+  }
+
+  // Forget the previous bounds, e.g. after a reset of the optimizer
+  void reset() { has_prev_bounds_ = false; }
+
+private:
+  // Last previous point whose arc length is at or before the projection of start
+  static size_t findStartIndex(const std::vector<ReferencePoint> & points, const Point & start)
+  {
+    double min_dist_sq = std::numeric_limits<double>::max();
+    size_t index = 0;
+    for (size_t i = 0; i + 1 < points.size(); ++i) {
+      const auto & p0 = points[i].pose.position;
+      const auto & p1 = points[i + 1].pose.position;
+      const double seg_x = p1.x - p0.x;
+      const double seg_y = p1.y - p0.y;
+      const double seg_len_sq = seg_x * seg_x + seg_y * seg_y;
+      const double ratio =
+        seg_len_sq > 1e-12
+          ? std::clamp(((start.x - p0.x) * seg_x + (start.y - p0.y) * seg_y) / seg_len_sq, 0.0, 1.0)
+          : 0.0;
+      const double dx = p0.x + ratio * seg_x - start.x;
+      const double dy = p0.y + ratio * seg_y - start.y;
+      const double dist_sq = dx * dx + dy * dy;
+      if (dist_sq < min_dist_sq) {
+        min_dist_sq = dist_sq;
+        index = ratio >= 1.0 ? i + 1 : i;
+      }
+    }
+    return index;
+  }
+
+  // Whether every point lies on the trajectory; takes the velocity of the preceding trajectory
+  // point (zero order hold, as the resampler)
+  bool matchTrajectory(
+    const std::vector<TrajectoryPoint> & traj_points,
+    std::vector<ReferencePoint> & ref_points) const
+  {
+    const double max_dist_sq = param_.max_path_deviation * param_.max_path_deviation;
+    const size_t num_segs = traj_points.size() - 1;
+    size_t seg = 0;
+    for (auto & p : ref_points) {
+      double ratio = 0.0;
+      double dist_sq = distanceToSegment(traj_points, seg, p.pose.position, ratio);
+      while (seg + 1 < num_segs) {
+        double next_ratio = 0.0;
+        const double next_dist_sq =
+          distanceToSegment(traj_points, seg + 1, p.pose.position, next_ratio);
+        if (next_dist_sq > dist_sq) {
+          break;
+        }
+        ++seg;
+        dist_sq = next_dist_sq;
+        ratio = next_ratio;
+      }
+      if (dist_sq > max_dist_sq) {
+        return false;
+      }
+      p.longitudinal_velocity_mps =
+        traj_points[ratio >= 1.0 ? seg + 1 : seg].longitudinal_velocity_mps;
+    }
+    return true;
+  }
+
+  static double distanceToSegment(
+    const std::vector<TrajectoryPoint> & traj_points, const size_t seg, const Point & p,
+    double & ratio)
+  {
+    return distanceToSegment(
+      traj_points[seg].pose.position, traj_points[seg + 1].pose.position, p, ratio);
+  }
+
+  // Squared distance of p to [p0, p1]; ratio is the clamped position of the projection on it
+  static double distanceToSegment(
+    const Point & p0, const Point & p1, const Point & p, double & ratio)
+  {
+    const double seg_x = p1.x - p0.x;
+    const double seg_y = p1.y - p0.y;
+    const double seg_len_sq = seg_x * seg_x + seg_y * seg_y;
+    ratio = seg_len_sq > 1e-12
+              ? std::clamp(((p.x - p0.x) * seg_x + (p.y - p0.y) * seg_y) / seg_len_sq, 0.0, 1.0)
+              : 0.0;
+    const double dx = p0.x + ratio * seg_x - p.x;
+    const double dy = p0.y + ratio * seg_y - p.y;
+    return dx * dx + dy * dy;
+  }
+
+  bool matchBound(const std::vector<Point> & prev, const std::vector<Point> & bound) const
+  {
+    return isOnPolyline(bound, prev) && isOnPolyline(prev, bound);
+  }
+
+  // Whether every vertex of points that projects inside polyline is within max_bound_deviation
+  bool isOnPolyline(const std::vector<Point> & points, const std::vector<Point> & polyline) const
+  {
+    if (polyline.size() < 2) {
+      return points.size() == polyline.size();
+    }
+    const double max_dist_sq = param_.max_bound_deviation * param_.max_bound_deviation;
+    const size_t num_segs = polyline.size() - 1;
+    size_t seg = 0;
+    for (const auto & p : points) {
+      double ratio = 0.0;
+      double dist_sq = distanceToSegment(polyline[seg], polyline[seg + 1], p, ratio);
+      while (seg + 1 < num_segs) {
+        double next_ratio = 0.0;
+        const double next_dist_sq =
+          distanceToSegment(polyline[seg + 1], polyline[seg + 2], p, next_ratio);
+        if (next_dist_sq > dist_sq) {
+          break;
+        }
+        ++seg;
+        dist_sq = next_dist_sq;
+        ratio = next_ratio;
+      }
+      const bool outside = (seg == 0 && ratio <= 0.0) || (seg + 1 == num_segs && ratio >= 1.0);
+      if (!outside && dist_sq > max_dist_sq) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  ReferencePointReuseParam param_;
+  std::vector<Point> prev_left_bound_;
+  std::vector<Point> prev_right_bound_;
+  bool has_prev_bounds_{false};
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__REFERENCE_POINT_REUSE_HPP_
@@ -0,0 +1,494 @@
+// Structure-exploiting ADMM solver for the sparse MPT QP
+#ifndef PATH_OPTIMIZER__RICCATI_ADMM_SOLVER_HPP_
+#define PATH_OPTIMIZER__RICCATI_ADMM_SOLVER_HPP_
+
+#include "osqp_interface.hpp"
+
+#include <Eigen/Core>
+#include <Eigen/StdVector>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * RiccatiADMMSolverT: ADMM for the stage-wise LQ problem of MPTQPBuilder (SPARSE formulation)
+ *
+ *   minimize    sum_i 0.5 x_i^T Q_i x_i + q_i^T x_i + sum_k 0.5 u_k^T R_k u_k + r_k^T u_k
+ *   subject to  x_0 = x0, x_{k+1} = A_k x_k + B_k u_k + w_k,
+ *               l <= x_i[0] <= u (i >= 1), l <= u_k <= u
+ *
+ * ADMM in the OSQP form splits off the box constraints. Every iteration solves an equality
+ * constrained LQ problem with the stage costs Q_i + rho e_0 e_0^T and R_k + rho I, which only
+ * change in their linear terms between iterations. The Riccati recursion of these costs is
+ * factorized once per setProblem; an iteration is one backward pass for the linear terms and one
+ * forward rollout, O(N) with fixed-size DimX x DimX algebra. Nothing is allocated after the
+ * buffers have grown to the horizon. As the refactorization is cheap, rho is rebalanced between
+ * the primal and dual residual at every check; the last rho is kept for the next problem.
+ *
+ * setProblem() reads the stage matrices back from the CSC layout written by MPTQPBuilder and
+ * returns false for any other layout (dense condensed Hessian, other constraints), so the caller
+ * can fall back to a general solver. The dual of the box rows is rho * w as in OSQP; the duals of
+ * the dynamics rows are returned as zero.
+ */
+template <int DimX, int DimU>
+class RiccatiADMMSolverT
+{
+public:
+  using StateMatrix = Eigen::Matrix<double, DimX, DimX>;
+  using InputMatrix = Eigen::Matrix<double, DimX, DimU>;
+  using GainMatrix = Eigen::Matrix<double, DimU, DimX>;
+  using InputSquare = Eigen::Matrix<double, DimU, DimU>;
+  using StateVector = Eigen::Matrix<double, DimX, 1>;
+  using InputVector = Eigen::Matrix<double, DimU, 1>;
+
+  struct Settings
+  {
+    double rho{0.1};
+    double alpha{1.6};  // Over-relaxation
+    double eps_abs{1e-4};
+    double eps_rel{1e-4};
+    int max_iter{4000};
+    int check_interval{10};  // Iterations between two convergence checks
+    bool adaptive_rho{true};  // Rebalance rho at the checks, as OSQP does (O(N) refactorization)
+    double time_limit_sec{0.0};  // Checked at the convergence checks, 0: no limit
+  };
+
+  explicit RiccatiADMMSolverT(const Settings & settings = Settings{})
+  : settings_(settings), rho_(settings.rho)
+  {
+  }
+
+  // Keeps the current (adapted) rho if settings.rho is unchanged
+  void setSettings(const Settings & settings)
+  {
+    if (settings.rho != settings_.rho) {
+      rho_ = settings.rho;
+    }
+    settings_ = settings;
+  }
+  const Settings & getSettings() const { return settings_; }
+
+  /**
+   * @brief Reads and factorizes the problem
+   * @return false if P, A, l, u do not have the stage-wise layout
+   */
+  bool setProblem(
+    const CSC_Matrix & P, const CSC_Matrix & A, const std::vector<double> & q,
+    const std::vector<double> & l, const std::vector<double> & u)
+  {
+    if (!parse(P, A, q, l, u)) {
+      num_points_ = 0;
+      return false;
+    }
+    factorize();
+    resetIterates();
+    return true;
+  }
+
+  // Primal in [X; U] order, dual by constraint row; an empty dual keeps the scaled dual at zero
+  void setWarmStart(const std::vector<double> & primal, const std::vector<double> & dual)
+  {
+    const size_t N = num_points_;
+    if (N == 0) {
+      return;
+    }
+    if (primal.size() == N * DimX + (N - 1) * DimU) {
+      for (size_t i = 1; i < N; ++i) {
+        v_lat_[i] = std::clamp(primal[i * DimX], lat_l_[i], lat_u_[i]);
+      }
+      for (size_t k = 0; k + 1 < N; ++k) {
+        for (int j = 0; j < DimU; ++j) {
+          const double value = primal[N * DimX + k * DimU + j];
+          v_u_[k](j) = std::clamp(value, u_l_[k](j), u_u_[k](j));
+        }
+      }
+    }
+    if (dual.size() == num_rows_) {
+      const size_t lat_row = N * DimX;
+      const size_t input_row = lat_row + N - 1;
+      for (size_t i = 1; i < N; ++i) {
+        w_lat_[i] = dual[lat_row + i - 1] / rho_;
+      }
+      for (size_t k = 0; k + 1 < N; ++k) {
+        for (int j = 0; j < DimU; ++j) {
+          w_u_[k](j) = dual[input_row + k * DimU + j] / rho_;
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Runs ADMM from the current iterates
+   * @return true if the residuals reached the tolerances within max_iter and time_limit_sec
+   */
+  bool solve(std::vector<double> & primal, std::vector<double> & dual, int & iterations)
+  {
+    const size_t N = num_points_;
+    iterations = 0;
+    if (N == 0) {
+      return false;
+    }
+    const double alpha = settings_.alpha;
+    const auto start = std::chrono::steady_clock::now();
+    const auto time_limit = std::chrono::duration<double>(settings_.time_limit_sec);
+    bool converged = false;
+    bool timed_out = false;
+    while (iterations < settings_.max_iter && !converged && !timed_out) {
+      ++iterations;
+      solveLQ();
+
+      const bool check = iterations % settings_.check_interval == 0;
+      double primal_res = 0.0;
+      double dual_res = 0.0;
+      double scale_z = 0.0;
+      double scale_w = 0.0;
+      for (size_t i = 1; i < N; ++i) {
+        const double cz = X_[i](0);
+        const double z_hat = alpha * cz + (1.0 - alpha) * v_lat_[i];
+        const double v = std::clamp(z_hat + w_lat_[i], lat_l_[i], lat_u_[i]);
+        if (check) {
+          primal_res = std::max(primal_res, std::abs(cz - v));
+          dual_res = std::max(dual_res, std::abs(v - v_lat_[i]));
+          scale_z = std::max({scale_z, std::abs(cz), std::abs(v)});
+        }
+        w_lat_[i] += z_hat - v;
+        v_lat_[i] = v;
+        scale_w = std::max(scale_w, std::abs(w_lat_[i]));
+      }
+      for (size_t k = 0; k + 1 < N; ++k) {
+        for (int j = 0; j < DimU; ++j) {
+          const double cz = U_[k](j);
+          const double z_hat = alpha * cz + (1.0 - alpha) * v_u_[k](j);
+          const double v = std::clamp(z_hat + w_u_[k](j), u_l_[k](j), u_u_[k](j));
+          if (check) {
+            primal_res = std::max(primal_res, std::abs(cz - v));
+            dual_res = std::max(dual_res, std::abs(v - v_u_[k](j)));
+            scale_z = std::max({scale_z, std::abs(cz), std::abs(v)});
+          }
+          w_u_[k](j) += z_hat - v;
+          v_u_[k](j) = v;
+          scale_w = std::max(scale_w, std::abs(w_u_[k](j)));
+        }
+      }
+      if (check) {
+        converged = primal_res <= settings_.eps_abs + settings_.eps_rel * scale_z &&
+                    rho_ * dual_res <= settings_.eps_abs + settings_.eps_rel * rho_ * scale_w;
+        if (!converged && settings_.adaptive_rho) {
+          updateRho(primal_res / std::max(scale_z, 1e-10), dual_res / std::max(scale_w, 1e-10));
+        }
+        timed_out = settings_.time_limit_sec > 0.0 &&
+                    std::chrono::steady_clock::now() - start > time_limit;
+      }
+    }
+
+    primal.resize(N * DimX + (N - 1) * DimU);
+    for (size_t i = 0; i < N; ++i) {
+      for (int d = 0; d < DimX; ++d) {
+        primal[i * DimX + d] = X_[i](d);
+      }
+    }
+    for (size_t k = 0; k + 1 < N; ++k) {
+      for (int j = 0; j < DimU; ++j) {
+        primal[N * DimX + k * DimU + j] = U_[k](j);
+      }
+    }
+    const double rho = rho_;
+    dual.assign(num_rows_, 0.0);
+    const size_t lat_row = N * DimX;
+    const size_t input_row = lat_row + N - 1;
+    for (size_t i = 1; i < N; ++i) {
+      dual[lat_row + i - 1] = rho * w_lat_[i];
+    }
+    for (size_t k = 0; k + 1 < N; ++k) {
+      for (int j = 0; j < DimU; ++j) {
+        dual[input_row + k * DimU + j] = rho * w_u_[k](j);
+      }
+    }
+    return converged;
+  }
+
+private:
+  template <typename T>
+  using AlignedVector = std::vector<T, Eigen::aligned_allocator<T>>;
+
+  // Sets begin to the first entry of the column; false if it does not hold num_entries entries
+  static bool columnHas(
+    const CSC_Matrix & csc, const size_t col, const size_t num_entries, long long & begin)
+  {
+    begin = csc.m_col_idxs[col];
+    return static_cast<size_t>(csc.m_col_idxs[col + 1] - begin) == num_entries;
+  }
+
+  bool parse(
+    const CSC_Matrix & P, const CSC_Matrix & A, const std::vector<double> & q,
+    const std::vector<double> & l, const std::vector<double> & u)
+  {
+    // n = N * DimX + (N - 1) * DimU variables, N * DimX + (N - 1) * (1 + DimU) rows
+    const size_t n = q.size();
+    if ((n + DimU) % (DimX + DimU) != 0) {
+      return false;
+    }
+    const size_t N = (n + DimU) / (DimX + DimU);
+    const size_t N_x = N * DimX;
+    const size_t lat_row = N_x;
+    const size_t input_row = N_x + N - 1;
+    const size_t m = input_row + (N - 1) * DimU;
+    if (
+      N < 2 || l.size() != m || u.size() != m || P.m_col_idxs.size() != n + 1 ||
+      A.m_col_idxs.size() != n + 1) {
+      return false;
+    }
+    resize(N);
+    num_rows_ = m;
+
+    // Diagonal Hessian
+    long long idx = 0;
+    for (size_t col = 0; col < n; ++col) {
+      if (!columnHas(P, col, 1, idx) || P.m_row_idxs[idx] != static_cast<long long>(col)) {
+        return false;
+      }
+    }
+    for (size_t i = 0; i < N; ++i) {
+      for (int d = 0; d < DimX; ++d) {
+        Q_[i](d) = P.m_vals[i * DimX + d];
+        q_[i](d) = q[i * DimX + d];
+      }
+    }
+    for (size_t k = 0; k + 1 < N; ++k) {
+      for (int j = 0; j < DimU; ++j) {
+        R_[k](j) = P.m_vals[N_x + k * DimU + j];
+        r_[k](j) = q[N_x + k * DimU + j];
+      }
+    }
+
+    // State columns: 1 on the own dynamics row, -A_k below, 1 on the lateral row
+    for (size_t k = 0; k < N; ++k) {
+      for (int d = 0; d < DimX; ++d) {
+        const size_t col = k * DimX + d;
+        const bool has_next = k + 1 < N;
+        const bool has_lat = d == 0 && k >= 1;
+        const size_t num_entries = 1 + (has_next ? DimX : 0) + (has_lat ? 1 : 0);
+        if (
+          !columnHas(A, col, num_entries, idx) ||
+          A.m_row_idxs[idx] != static_cast<long long>(col)) {
+          return false;
+        }
+        ++idx;
+        if (has_next) {
+          for (int r = 0; r < DimX; ++r, ++idx) {
+            if (A.m_row_idxs[idx] != static_cast<long long>((k + 1) * DimX + r)) {
+              return false;
+            }
+            A_[k](r, d) = -A.m_vals[idx];
+          }
+        }
+        if (has_lat && A.m_row_idxs[idx] != static_cast<long long>(lat_row + k - 1)) {
+          return false;
+        }
+      }
+    }
+
+    // Input columns: -B_k on the next dynamics rows, 1 on the input row
+    for (size_t k = 0; k + 1 < N; ++k) {
+      for (int j = 0; j < DimU; ++j) {
+        const size_t col = N_x + k * DimU + j;
+        if (!columnHas(A, col, DimX + 1, idx)) {
+          return false;
+        }
+        for (int r = 0; r < DimX; ++r, ++idx) {
+          if (A.m_row_idxs[idx] != static_cast<long long>((k + 1) * DimX + r)) {
+            return false;
+          }
+          B_[k](r, j) = -A.m_vals[idx];
+        }
+        if (A.m_row_idxs[idx] != static_cast<long long>(input_row + k * DimU + j)) {
+          return false;
+        }
+      }
+    }
+
+    // Dynamics rows are equalities
+    for (size_t row = 0; row < N_x; ++row) {
+      if (l[row] != u[row]) {
+        return false;
+      }
+    }
+    for (int d = 0; d < DimX; ++d) {
+      x0_(d) = l[d];
+    }
+    for (size_t k = 0; k + 1 < N; ++k) {
+      for (int d = 0; d < DimX; ++d) {
+        w_[k](d) = l[(k + 1) * DimX + d];
+      }
+    }
+    for (size_t i = 1; i < N; ++i) {
+      lat_l_[i] = l[lat_row + i - 1];
+      lat_u_[i] = u[lat_row + i - 1];
+    }
+    for (size_t k = 0; k + 1 < N; ++k) {
+      for (int j = 0; j < DimU; ++j) {
+        u_l_[k](j) = l[input_row + k * DimU + j];
+        u_u_[k](j) = u[input_row + k * DimU + j];
+      }
+    }
+    return true;
+  }
+
+  void resize(const size_t N)
+  {
+    num_points_ = N;
+    Q_.resize(N);
+    q_.resize(N);
+    R_.resize(N - 1);
+    r_.resize(N - 1);
+    A_.resize(N - 1);
+    B_.resize(N - 1);
+    w_.resize(N - 1);
+    P_.resize(N);
+    p_.resize(N);
+    K_.resize(N - 1);
+    G_.resize(N - 1);
+    H_inv_.resize(N - 1);
+    X_.resize(N);
+    U_.resize(N - 1);
+    lat_l_.resize(N);
+    lat_u_.resize(N);
+    v_lat_.resize(N);
+    w_lat_.resize(N);
+    u_l_.resize(N - 1);
+    u_u_.resize(N - 1);
+    v_u_.resize(N - 1);
+    w_u_.resize(N - 1);
+  }
+
+  // Scales rho by the square root of the normalized residual ratio if it is off by more than 5x;
+  // the scaled dual w = y / rho is rescaled so that y is unchanged
+  void updateRho(const double primal_ratio, const double dual_ratio)
+  {
+    const double ratio = std::sqrt(primal_ratio / std::max(dual_ratio, 1e-10));
+    if (ratio < 5.0 && ratio > 0.2) {
+      return;
+    }
+    const double rho = std::clamp(rho_ * ratio, 1e-6, 1e6);
+    const double scale = rho_ / rho;
+    for (size_t i = 0; i < num_points_; ++i) {
+      w_lat_[i] *= scale;
+    }
+    for (size_t k = 0; k + 1 < num_points_; ++k) {
+      w_u_[k] *= scale;
+    }
+    rho_ = rho;
+    factorize();
+  }
+
+  // Riccati recursion of the quadratic terms (including rho), independent of the iterates
+  void factorize()
+  {
+    const size_t N = num_points_;
+    const double rho = rho_;
+    P_[N - 1] = stateCost(N - 1, rho).asDiagonal();
+    for (size_t k = N - 1; k-- > 0;) {
+      const StateMatrix & P_next = P_[k + 1];
+      const InputMatrix PB = P_next * B_[k];
+      InputSquare H = B_[k].transpose() * PB;
+      H.diagonal() += R_[k] + InputVector::Constant(rho);
+      H_inv_[k] = H.inverse();
+      G_[k] = PB.transpose() * A_[k];
+      K_[k] = -H_inv_[k] * G_[k];
+      StateMatrix P = A_[k].transpose() * P_next * A_[k] + G_[k].transpose() * K_[k];
+      P.diagonal() += stateCost(k, rho);
+      P_[k] = 0.5 * (P + P.transpose());
+    }
+  }
+
+  StateVector stateCost(const size_t i, const double rho) const
+  {
+    StateVector cost = Q_[i];
+    if (i > 0) {
+      cost(0) += rho;
+    }
+    return cost;
+  }
+
+  void resetIterates()
+  {
+    for (size_t i = 0; i < num_points_; ++i) {
+      v_lat_[i] = std::clamp(0.0, lat_l_[i], lat_u_[i]);
+      w_lat_[i] = 0.0;
+    }
+    for (size_t k = 0; k + 1 < num_points_; ++k) {
+      v_u_[k] = InputVector::Zero().cwiseMax(u_l_[k]).cwiseMin(u_u_[k]);
+      w_u_[k].setZero();
+    }
+  }
+
+  // Equality constrained LQ step with the linear terms of the current v and w
+  void solveLQ()
+  {
+    const size_t N = num_points_;
+    const double rho = rho_;
+
+    p_[N - 1] = q_[N - 1];
+    p_[N - 1](0) -= rho * (v_lat_[N - 1] - w_lat_[N - 1]);
+    for (size_t k = N - 1; k-- > 0;) {
+      const StateVector e = P_[k + 1] * w_[k] + p_[k + 1];
+      const InputVector h = r_[k] - rho * (v_u_[k] - w_u_[k]) + B_[k].transpose() * e;
+      U_[k] = -H_inv_[k] * h;  // feed-forward term, the feedback is added in the rollout
+      StateVector p = q_[k] + A_[k].transpose() * e + G_[k].transpose() * U_[k];
+      if (k > 0) {
+        p(0) -= rho * (v_lat_[k] - w_lat_[k]);
+      }
+      p_[k] = p;
+    }
+
+    X_[0] = x0_;
+    for (size_t k = 0; k + 1 < N; ++k) {
+      U_[k] += K_[k] * X_[k];
+      X_[k + 1] = A_[k] * X_[k] + B_[k] * U_[k] + w_[k];
+    }
+  }
+
+  Settings settings_;
+  double rho_;
+  size_t num_points_{0};
+  size_t num_rows_{0};
+
+  // Problem
+  StateVector x0_;
+  AlignedVector<StateVector> Q_;  // Diagonal state weights
+  AlignedVector<StateVector> q_;
+  AlignedVector<InputVector> R_;  // Diagonal input weights
+  AlignedVector<InputVector> r_;
+  AlignedVector<StateMatrix> A_;
+  AlignedVector<InputMatrix> B_;
+  AlignedVector<StateVector> w_;
+  std::vector<double> lat_l_;
+  std::vector<double> lat_u_;
+  AlignedVector<InputVector> u_l_;
+  AlignedVector<InputVector> u_u_;
+
+  // Factorization
+  AlignedVector<StateMatrix> P_;
+  AlignedVector<StateVector> p_;
+  AlignedVector<GainMatrix> K_;
+  AlignedVector<GainMatrix> G_;
+  AlignedVector<InputSquare> H_inv_;
+
+  // Iterates
+  AlignedVector<StateVector> X_;
+  AlignedVector<InputVector> U_;
+  std::vector<double> v_lat_;  // Projected lateral error
+  std::vector<double> w_lat_;  // Scaled dual of the lateral rows
+  AlignedVector<InputVector> v_u_;
+  AlignedVector<InputVector> w_u_;
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__RICCATI_ADMM_SOLVER_HPP_
@@ -0,0 +1,161 @@
+// Binary log of port samples for offline replay
+#ifndef PATH_OPTIMIZER__SAMPLE_LOG_HPP_
+#define PATH_OPTIMIZER__SAMPLE_LOG_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * Sample log: recorded port samples in a compact binary file, for replaying a SWC without the
+ * communication stack
+ *
+ * File layout (little endian, as written by the target):
+ *   header  : magic "SMPLLOG1" (8 bytes)
+ *   record  : channel (uint16), size (uint32), stamp_ns (int64), payload (size bytes)
+ *
+ * The channel identifies the port (e.g. one id per rport_*), the stamp is the receive time. The
+ * payload encoding is up to the port; writeValue/readValue cover trivially copyable samples and
+ * writeArray/readArray contiguous arrays of them (e.g. trajectory points).
+ */
+struct SampleRecord
+{
+  uint16_t channel{0};
+  int64_t stamp_ns{0};
+  std::vector<uint8_t> payload;
+
+  template <typename T>
+  T readValue() const
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "sample type must be trivially copyable");
+    if (payload.size() != sizeof(T)) {
+      throw std::runtime_error("sample log: payload size does not match the sample type");
+    }
+    T value;
+    std::memcpy(&value, payload.data(), sizeof(T));
+    return value;
+  }
+
+  template <typename T>
+  void readArray(std::vector<T> & values) const
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "sample type must be trivially copyable");
+    if (payload.size() % sizeof(T) != 0) {
+      throw std::runtime_error("sample log: payload size does not match the sample type");
+    }
+    values.resize(payload.size() / sizeof(T));
+    std::memcpy(values.data(), payload.data(), payload.size());
+  }
+};
+
+class SampleLogWriter
+{
+public:
+  explicit SampleLogWriter(const std::string & path)
+  : file_(path, std::ios::binary | std::ios::trunc)
+  {
+    if (!file_) {
+      throw std::runtime_error("sample log: cannot open " + path);
+    }
+    file_.write(magic, sizeof(magic));
+  }
+
+  void write(const uint16_t channel, const int64_t stamp_ns, const void * data, const uint32_t size)
+  {
+    file_.write(reinterpret_cast<const char *>(&channel), sizeof(channel));
+    file_.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    file_.write(reinterpret_cast<const char *>(&stamp_ns), sizeof(stamp_ns));
+    file_.write(static_cast<const char *>(data), size);
+  }
+
+  template <typename T>
+  void writeValue(const uint16_t channel, const int64_t stamp_ns, const T & value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "sample type must be trivially copyable");
+    write(channel, stamp_ns, &value, sizeof(T));
+  }
+
+  template <typename T>
+  void writeArray(const uint16_t channel, const int64_t stamp_ns, const std::vector<T> & values)
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "sample type must be trivially copyable");
+    write(channel, stamp_ns, values.data(), static_cast<uint32_t>(values.size() * sizeof(T)));
+  }
+
+  void flush() { file_.flush(); }
+
+  static constexpr char magic[8] = {'S', 'M', 'P', 'L', 'L', 'O', 'G', '1'};
+
+private:
+  std::ofstream file_;
+};
+
+class SampleLogReader
+{
+public:
+  explicit SampleLogReader(const std::string & path) : file_(path, std::ios::binary)
+  {
+    char header[sizeof(SampleLogWriter::magic)];
+    if (
+      !file_.read(header, sizeof(header)) ||
+      std::memcmp(header, SampleLogWriter::magic, sizeof(header)) != 0) {
+      throw std::runtime_error("sample log: " + path + " is not a sample log");
+    }
+  }
+
+  // Reads the next record into record (its payload capacity is reused), false at the end
+  bool next(SampleRecord & record)
+  {
+    uint32_t size = 0;
+    if (!file_.read(reinterpret_cast<char *>(&record.channel), sizeof(record.channel))) {
+      return false;
+    }
+    if (
+      !file_.read(reinterpret_cast<char *>(&size), sizeof(size)) ||
+      !file_.read(reinterpret_cast<char *>(&record.stamp_ns), sizeof(record.stamp_ns))) {
+      throw std::runtime_error("sample log: truncated record header");
+    }
+    record.payload.resize(size);
+    if (size > 0 && !file_.read(reinterpret_cast<char *>(record.payload.data()), size)) {
+      throw std::runtime_error("sample log: truncated record payload");
+    }
+    return true;
+  }
+
+private:
+  std::ifstream file_;
+};
+
+/**
+ * ReplayClock: time source that follows the stamps of the replayed records
+ *
+ * A SWC that reads its time from a ReplayClock instead of the system clock, and that is triggered
+ * per record instead of by a timer, processes a log as fast as possible and produces the same
+ * outputs in every run.
+ */
+class ReplayClock
+{
+public:
+  void advanceTo(const int64_t stamp_ns)
+  {
+    if (stamp_ns > now_ns_) {
+      now_ns_ = stamp_ns;
+    }
+  }
+  int64_t now() const { return now_ns_; }
+  double seconds() const { return static_cast<double>(now_ns_) * 1e-9; }
+
+private:
+  int64_t now_ns_{0};
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__SAMPLE_LOG_HPP_
@@ -0,0 +1,171 @@
+// In-process batch evaluation of recorded scenarios, many independent instances in parallel
+#ifndef PATH_OPTIMIZER__SCENARIO_BATCH_RUNNER_HPP_
+#define PATH_OPTIMIZER__SCENARIO_BATCH_RUNNER_HPP_
+
+#include "sample_log.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+// One scenario: a sample log of the port inputs recorded for it (e.g. Scenario_1_1)
+struct ScenarioSpec
+{
+  std::string name;
+  std::string sample_log;
+};
+
+struct ScenarioResult
+{
+  std::string name;
+  bool ok{false};
+  std::string error;
+  size_t num_samples{0};
+  double wall_time_ms{0.0};
+  std::map<std::string, double> metrics;  // filled by the instance, e.g. "max_lateral_error"
+};
+
+/**
+ * ScenarioInstance: the planning logic of one scenario run, driven without the middleware
+ *
+ * Instead of receiving samples through its ports, the instance gets the records of the sample
+ * log in order, with a ReplayClock advanced to each record's stamp. It owns all of its mutable
+ * state (stages, solvers, route search states), so instances never share anything writable.
+ */
+class ScenarioInstance
+{
+public:
+  virtual ~ScenarioInstance() = default;
+
+  virtual void onSample(const SampleRecord & record, const ReplayClock & clock) = 0;
+
+  // Called after the last record; adds the scenario metrics to result
+  virtual void finish(ScenarioResult & result) = 0;
+};
+
+/**
+ * ScenarioBatchRunner: runs many scenarios in parallel threads of one process
+ *
+ * The shared world (map, routing graph, traffic rules, parameters) is built once and passed to
+ * the factory of every instance as const: it must only be read, e.g. a LaneletMap and a
+ * FrozenRoutingGraph queried with a RoutingSearchState per instance. Scenarios are handed to
+ * num_threads workers from a shared counter, so long and short scenarios balance out. Each
+ * instance replays its sample log with its own ReplayClock, so the results do not depend on the
+ * number of threads or on the load of the machine.
+ *
+ * A scenario that throws is reported as failed with the exception message; the others continue.
+ *
+ *   auto world = std::make_shared<const World>(loadWorld(map_path));
+ *   ScenarioBatchRunner<World> runner(world, [](const World & w, const ScenarioSpec & spec) {
+ *     return std::make_unique<PlanningInstance>(w, spec);
+ *   });
+ *   const auto results = runner.run(specs, std::thread::hardware_concurrency());
+ *   writeScenarioResults("output/scenarios.jsonl", results);
+ */
+template <typename World>
+class ScenarioBatchRunner
+{
+public:
+  using Factory =
+    std::function<std::unique_ptr<ScenarioInstance>(const World &, const ScenarioSpec &)>;
+
+  ScenarioBatchRunner(std::shared_ptr<const World> world, Factory factory)
+  : world_(std::move(world)), factory_(std::move(factory))
+  {
+    if (!world_ || !factory_) {
+      throw std::invalid_argument("scenario batch runner: world and factory are required");
+    }
+  }
+
+  // Results in the order of specs
+  std::vector<ScenarioResult> run(const std::vector<ScenarioSpec> & specs, size_t num_threads)
+  {
+    std::vector<ScenarioResult> results(specs.size());
+    num_threads = std::clamp<size_t>(num_threads, 1, std::max<size_t>(specs.size(), 1));
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+      SampleRecord record;  // payload capacity reused across the scenarios of this thread
+      for (size_t i = next.fetch_add(1); i < specs.size(); i = next.fetch_add(1)) {
+        results[i] = runOne(specs[i], record);
+      }
+    };
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < num_threads; ++t) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (auto & thread : threads) {
+      thread.join();
+    }
+    return results;
+  }
+
+private:
+  ScenarioResult runOne(const ScenarioSpec & spec, SampleRecord & record) const
+  {
+    ScenarioResult result;
+    result.name = spec.name;
+    const auto start = std::chrono::steady_clock::now();
+    try {
+      const auto instance = factory_(*world_, spec);
+      SampleLogReader reader(spec.sample_log);
+      ReplayClock clock;
+      while (reader.next(record)) {
+        clock.advanceTo(record.stamp_ns);
+        instance->onSample(record, clock);
+        ++result.num_samples;
+      }
+      instance->finish(result);
+      result.ok = true;
+    } catch (const std::exception & e) {
+      result.ok = false;
+      result.error = e.what();
+    }
+    result.wall_time_ms =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return result;
+  }
+
+  std::shared_ptr<const World> world_;
+  Factory factory_;
+};
+
+// One JSON line per scenario (names and errors are written as they are, without escaping)
+inline void writeScenarioResults(
+  const std::string & path, const std::vector<ScenarioResult> & results)
+{
+  std::ofstream file(path, std::ios::trunc);
+  if (!file) {
+    throw std::runtime_error("scenario batch runner: cannot open " + path);
+  }
+  for (const auto & r : results) {
+    file << "{\"name\":\"" << r.name << "\",\"ok\":" << (r.ok ? "true" : "false")
+         << ",\"samples\":" << r.num_samples << ",\"wall_time_ms\":" << r.wall_time_ms;
+    if (!r.ok) {
+      file << ",\"error\":\"" << r.error << "\"";
+    }
+    for (const auto & [name, value] : r.metrics) {
+      file << ",\"" << name << "\":" << value;
+    }
+    file << "}\n";
+  }
+}
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__SCENARIO_BATCH_RUNNER_HPP_
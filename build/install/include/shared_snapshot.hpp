@@ -0,0 +1,147 @@
+// Copy-on-write snapshots of data shared between receive callbacks and the planning cycle
+#ifndef PATH_OPTIMIZER__SHARED_SNAPSHOT_HPP_
+#define PATH_OPTIMIZER__SHARED_SNAPSHOT_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * SharedSnapshot: the current immutable version of a T, published by writers, read without locks
+ *
+ * RCU-style exchange through an atomic shared_ptr: a writer builds a new version outside of any
+ * lock and publishes it with one atomic store; a reader takes the current version with one atomic
+ * load and keeps it as long as it needs it. Old versions are freed when the last reader drops
+ * them (the reference count is the grace period), so a planning cycle sees the same data from
+ * start to end however often the callbacks publish meanwhile, and neither side waits for the
+ * work of the other. Without C++20 atomic<shared_ptr> the exchange uses the std::atomic_load /
+ * atomic_store overloads, which guard only the pointer copy.
+ *
+ * Several inputs that must be read consistently belong into one T whose members are themselves
+ * shared_ptr<const ...>, so an update copies a few pointers, not the data:
+ *
+ *   struct PlannerData {
+ *     std::shared_ptr<const LaneletRoute> route;
+ *     std::shared_ptr<const Odometry> odometry;
+ *     std::shared_ptr<const PredictedObjects> objects;
+ *   };
+ *   SharedSnapshot<PlannerData> planner_data;
+ *
+ *   // receive callback (rport_*)
+ *   planner_data.update([&](PlannerData & d) { d.odometry = std::make_shared<Odometry>(msg); });
+ *
+ *   // planning cycle, and every module running in parallel with it
+ *   const auto data = planner_data.load();
+ *   plan(*data->route, *data->odometry, *data->objects);
+ *
+ * update() copies the current version, applies the function to the copy and publishes it with a
+ * compare and exchange; if another writer published in between, it retries on the newer version,
+ * so concurrent callbacks never lose each other's updates. The function may therefore run more
+ * than once and should only assign to the copy.
+ */
+template <typename T>
+class SharedSnapshot
+{
+public:
+  // One published version; the version number increases by one per publish
+  class Snapshot
+  {
+  public:
+    Snapshot() = default;
+
+    const T * operator->() const { return &node_->value; }
+    const T & operator*() const { return node_->value; }
+    const T & get() const { return node_->value; }
+    explicit operator bool() const { return static_cast<bool>(node_); }
+    uint64_t version() const { return node_ ? node_->version : 0; }
+
+  private:
+    friend class SharedSnapshot;
+    struct Node
+    {
+      T value;
+      uint64_t version;
+    };
+    explicit Snapshot(std::shared_ptr<const Node> node) : node_(std::move(node)) {}
+
+    std::shared_ptr<const Node> node_;
+  };
+
+  explicit SharedSnapshot(T initial = T{})
+  {
+    store(std::make_shared<const Node>(Node{std::move(initial), 0}));
+  }
+
+  SharedSnapshot(const SharedSnapshot &) = delete;
+  SharedSnapshot & operator=(const SharedSnapshot &) = delete;
+
+  // The current version; never blocks on writers
+  Snapshot load() const { return Snapshot(loadNode()); }
+
+  uint64_t version() const { return loadNode()->version; }
+
+  // Replaces the current version by value
+  void publish(T value)
+  {
+    auto current = loadNode();
+    auto next = std::make_shared<Node>(Node{std::move(value), 0});
+    while (true) {
+      next->version = current->version + 1;
+      if (compareExchange(current, next)) {
+        return;
+      }
+    }
+  }
+
+  // Publishes f applied to a copy of the current version; returns the published version number
+  template <typename F>
+  uint64_t update(F && f)
+  {
+    auto current = loadNode();
+    while (true) {
+      auto next = std::make_shared<Node>(Node{current->value, current->version + 1});
+      f(next->value);
+      std::shared_ptr<const Node> published = std::move(next);
+      const uint64_t version = published->version;
+      if (compareExchange(current, published)) {
+        return version;
+      }
+    }
+  }
+
+private:
+  using Node = typename Snapshot::Node;
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+  std::shared_ptr<const Node> loadNode() const { return node_.load(std::memory_order_acquire); }
+  void store(std::shared_ptr<const Node> node) { node_.store(std::move(node)); }
+  // On failure current is the version published meanwhile
+  bool compareExchange(std::shared_ptr<const Node> & current, std::shared_ptr<const Node> next)
+  {
+    return node_.compare_exchange_strong(current, std::move(next), std::memory_order_acq_rel);
+  }
+
+  std::atomic<std::shared_ptr<const Node>> node_;
+#else
+  std::shared_ptr<const Node> loadNode() const
+  {
+    return std::atomic_load_explicit(&node_, std::memory_order_acquire);
+  }
+  void store(std::shared_ptr<const Node> node) { std::atomic_store(&node_, std::move(node)); }
+  bool compareExchange(std::shared_ptr<const Node> & current, std::shared_ptr<const Node> next)
+  {
+    return std::atomic_compare_exchange_strong_explicit(
+      &node_, &current, std::move(next), std::memory_order_acq_rel, std::memory_order_acquire);
+  }
+
+  std::shared_ptr<const Node> node_;
+#endif
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__SHARED_SNAPSHOT_HPP_
@@ -0,0 +1,180 @@
+// Pipelined execution of planning stages on frame-tagged channels
+#ifndef PATH_OPTIMIZER__STAGE_PIPELINE_HPP_
+#define PATH_OPTIMIZER__STAGE_PIPELINE_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * Frame: a stage input or output tagged with the frame it belongs to
+ *
+ * frame_id is assigned by the first stage and increases by one per input frame; origin_ns is the
+ * header stamp of that input (see LatencyTracer). Both are copied unchanged from input to output,
+ * so a downstream stage can match its inputs and detect skipped frames (a gap in frame_id).
+ */
+template <typename T>
+struct Frame
+{
+  uint64_t frame_id{0};
+  int64_t origin_ns{0};
+  T value{};
+};
+
+/**
+ * FrameChannel: bounded hand-off between two stage threads
+ *
+ * With capacity 1 (the default) the channel holds only the newest frame: if the consumer is still
+ * busy when the next frame arrives, the queued one is replaced (counted in skipped()). A frame
+ * then waits for at most one processing time of the next stage, so the end-to-end latency stays
+ * bounded by the sum of the stage times instead of growing with a backlog.
+ */
+template <typename T>
+class FrameChannel
+{
+public:
+  explicit FrameChannel(const size_t capacity = 1) : slots_(capacity > 0 ? capacity : 1) {}
+
+  FrameChannel(const FrameChannel &) = delete;
+  FrameChannel & operator=(const FrameChannel &) = delete;
+
+  // Queues a frame, replacing the oldest one if the channel is full; false after close()
+  bool push(Frame<T> && frame)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (closed_) {
+        return false;
+      }
+      if (size_ == slots_.size()) {
+        head_ = (head_ + 1) % slots_.size();
+        --size_;
+        ++skipped_;
+      }
+      slots_[(head_ + size_) % slots_.size()] = std::move(frame);
+      ++size_;
+    }
+    cv_.notify_one();
+    return true;
+  }
+
+  // Waits for the next frame; false once the channel is closed and empty
+  bool pop(Frame<T> & frame)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return size_ > 0 || closed_; });
+    if (size_ == 0) {
+      return false;
+    }
+    frame = std::move(slots_[head_]);
+    head_ = (head_ + 1) % slots_.size();
+    --size_;
+    return true;
+  }
+
+  void close()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+    }
+    cv_.notify_all();
+  }
+
+  uint64_t skipped() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return skipped_;
+  }
+
+private:
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<Frame<T>> slots_;
+  size_t head_{0};
+  size_t size_{0};
+  uint64_t skipped_{0};
+  bool closed_{false};
+};
+
+/**
+ * PipelineStage: runs one planning stage on its own thread between two channels
+ *
+ * Chaining stages with channels gives the pipelined mode: while stage k processes frame t, stage
+ * k - 1 already works on frame t + 1, so the throughput is set by the slowest stage instead of the
+ * sum of all stages.
+ *
+ *   FrameChannel<Trajectory> ebs_to_po, po_to_mvp;
+ *   PipelineStage<Trajectory, Trajectory> po("path_optimizer", ebs_to_po, po_to_mvp, optimize);
+ *
+ * process returns false to drop the frame (e.g. optimization failed). The stage stops when its
+ * input is closed and closes its output, so closing the first channel shuts down the pipeline in
+ * order; the destructor does the same for this stage.
+ */
+template <typename In, typename Out>
+class PipelineStage
+{
+public:
+  using Process = std::function<bool(const In &, Out &)>;
+
+  PipelineStage(
+    std::string name, FrameChannel<In> & input, FrameChannel<Out> & output, Process process)
+  : name_(std::move(name)), input_(input), output_(output), process_(std::move(process))
+  {
+    thread_ = std::thread([this] { run(); });
+  }
+
+  PipelineStage(const PipelineStage &) = delete;
+  PipelineStage & operator=(const PipelineStage &) = delete;
+
+  ~PipelineStage()
+  {
+    input_.close();
+    thread_.join();
+  }
+
+  const std::string & name() const { return name_; }
+
+  uint64_t processed() const { return processed_.load(std::memory_order_relaxed); }
+  uint64_t failed() const { return failed_.load(std::memory_order_relaxed); }
+
+private:
+  void run()
+  {
+    Frame<In> in;
+    Frame<Out> out;
+    while (input_.pop(in)) {
+      out.frame_id = in.frame_id;
+      out.origin_ns = in.origin_ns;
+      if (!process_(in.value, out.value)) {
+        failed_.fetch_add(1, std::memory_order_relaxed);
+        continue;
+      }
+      processed_.fetch_add(1, std::memory_order_relaxed);
+      output_.push(std::move(out));
+    }
+    output_.close();
+  }
+
+  std::string name_;
+  FrameChannel<In> & input_;
+  FrameChannel<Out> & output_;
+  Process process_;
+  std::atomic<uint64_t> processed_{0};
+  std::atomic<uint64_t> failed_{0};
+  std::thread thread_;
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__STAGE_PIPELINE_HPP_
@@ -0,0 +1,204 @@
+// Startup milestones of the planning SWCs and parallel, dependency ordered initialization
+#ifndef PATH_OPTIMIZER__STARTUP_TIMELINE_HPP_
+#define PATH_OPTIMIZER__STARTUP_TIMELINE_HPP_
+
+#include <time.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * StartupTimeline: readiness milestones of one process, for the startup timeline trace
+ *
+ * mark() appends one JSON line per milestone:
+ *   {"process": "Exe_elasticbandsmoother", "milestone": "map_loaded", "boot_ns": <ns>}
+ * boot_ns is CLOCK_BOOTTIME, which starts at kernel boot and is shared by all processes of the
+ * machine, so the traces of all SWCs line up on one time axis starting close to ignition.
+ * tool/analyze_startup_timeline.py merges them and reports the time to the first trajectory and
+ * the milestone that gated every SWC.
+ *
+ * The trace is written to $PLANNING_STARTUP_TRACE_DIR/<process>.startup.jsonl (set it in the
+ * environment of the execution manifest); without it mark() only keeps the milestone in memory.
+ * Each milestone is recorded once, later marks of the same name are ignored, so "first_input"
+ * and "first_output" can be marked from the cycle without a flag.
+ *
+ * Milestones used by the planning SWCs: process_start, map_loaded, graph_built, ports_offered,
+ * first_input, first_output.
+ */
+class StartupTimeline
+{
+public:
+  struct Milestone
+  {
+    std::string name;
+    int64_t boot_ns;
+  };
+
+  static StartupTimeline & instance()
+  {
+    static StartupTimeline timeline;
+    return timeline;
+  }
+
+  StartupTimeline(const StartupTimeline &) = delete;
+  StartupTimeline & operator=(const StartupTimeline &) = delete;
+
+  // Opens the trace and marks process_start; call first thing in main()
+  void begin(const std::string & process)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    process_ = process;
+    if (const char * dir = std::getenv("PLANNING_STARTUP_TRACE_DIR"); dir != nullptr && *dir) {
+      file_.open(std::string(dir) + "/" + process + ".startup.jsonl", std::ios::trunc);
+    }
+    markLocked("process_start", now());
+  }
+
+  void mark(const std::string & milestone)
+  {
+    const int64_t stamp = now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    markLocked(milestone, stamp);
+  }
+
+  std::vector<Milestone> milestones() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return milestones_;
+  }
+
+  static int64_t now()
+  {
+    timespec ts{};
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+  }
+
+private:
+  StartupTimeline() = default;
+
+  // Requires mutex_
+  void markLocked(const std::string & milestone, const int64_t stamp)
+  {
+    for (const auto & m : milestones_) {
+      if (m.name == milestone) {
+        return;
+      }
+    }
+    milestones_.push_back(Milestone{milestone, stamp});
+    if (file_.is_open()) {
+      file_ << "{\"process\":\"" << process_ << "\",\"milestone\":\"" << milestone
+            << "\",\"boot_ns\":" << stamp << "}\n";
+      file_.flush();
+    }
+  }
+
+  mutable std::mutex mutex_;
+  std::string process_;
+  std::ofstream file_;
+  std::vector<Milestone> milestones_;
+};
+
+/**
+ * StartupTasks: initialization steps of a SWC, run in parallel as far as their dependencies allow
+ *
+ * The steps of a SWC (load the map, build the routing graph, create and offer the ports, read
+ * the parameters, warm up the solver, ...) used to run one after the other. Here every step
+ * names the steps it needs; run() starts every step whose dependencies are done on its own
+ * thread and marks a milestone of the step's name when it finishes, so independent steps (port
+ * setup and map loading) overlap and the timeline shows which step gated the SWC.
+ *
+ *   StartupTasks tasks;
+ *   tasks.add("map_loaded", {}, [&] { map = load(map_path); });
+ *   tasks.add("graph_built", {"map_loaded"}, [&] { graph = buildGraph(*map); });
+ *   tasks.add("ports_offered", {}, [&] { offerPorts(); });
+ *   tasks.run();
+ *
+ * If a step throws, the steps that depend on it are skipped, the independent ones still finish,
+ * and run() rethrows the first error.
+ */
+class StartupTasks
+{
+public:
+  void add(std::string name, std::vector<std::string> dependencies, std::function<void()> task)
+  {
+    for (const auto & dependency : dependencies) {
+      if (findTask(dependency) == tasks_.size()) {
+        throw std::invalid_argument(
+          "startup task " + name + ": unknown dependency " + dependency + " (add it first)");
+      }
+    }
+    tasks_.push_back(Task{std::move(name), std::move(dependencies), std::move(task)});
+  }
+
+  void run()
+  {
+    // Dependencies are added before their dependents, so the list is in topological order and
+    // waiting on the futures of the earlier tasks cannot deadlock.
+    std::vector<std::shared_future<void>> done(tasks_.size());
+    for (size_t i = 0; i < tasks_.size(); ++i) {
+      std::vector<std::shared_future<void>> dependencies;
+      for (const auto & dependency : tasks_[i].dependencies) {
+        dependencies.push_back(done[findTask(dependency)]);
+      }
+      done[i] = std::async(std::launch::async, [this, i, dependencies = std::move(dependencies)] {
+                  for (const auto & dependency : dependencies) {
+                    dependency.get();  // rethrows: the task is skipped
+                  }
+                  tasks_[i].task();
+                  StartupTimeline::instance().mark(tasks_[i].name);
+                }).share();
+    }
+    std::exception_ptr error;
+    for (auto & d : done) {
+      try {
+        d.get();
+      } catch (...) {
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    }
+    tasks_.clear();
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+private:
+  struct Task
+  {
+    std::string name;
+    std::vector<std::string> dependencies;
+    std::function<void()> task;
+  };
+
+  size_t findTask(const std::string & name) const
+  {
+    for (size_t i = 0; i < tasks_.size(); ++i) {
+      if (tasks_[i].name == name) {
+        return i;
+      }
+    }
+    return tasks_.size();
+  }
+
+  std::vector<Task> tasks_;
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__STARTUP_TIMELINE_HPP_
@@ -6,15 +6,29 @@
 #include "path_optimizer_types.hpp"
 
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
 #include <memory>
 #include <vector>
 
 namespace autoware::path_optimizer
 {
 
-class StateEquationGenerator
+/**
+ * State equation generator templated on the vehicle model.
+ * The one-step matrices have compile-time dimensions (VehicleModelTraits), so the inner loops
+ * use fixed-size Eigen blocks without heap allocation or runtime size checks.
+ */
+template <typename Model>
+class StateEquationGeneratorT
 {
 public:
+  static constexpr int DimX = VehicleModelTraits<Model>::DimX;
+  static constexpr int DimU = VehicleModelTraits<Model>::DimU;
+
+  using StateMatrix = typename VehicleModelTraits<Model>::StateMatrix;
+  using InputMatrix = typename VehicleModelTraits<Model>::InputMatrix;
+  using StateVector = typename VehicleModelTraits<Model>::StateVector;
+
   struct Matrix
   {
     Eigen::MatrixXd A;  // State transition matrix
@@ -22,69 +36,203 @@ public:
     Eigen::VectorXd W;  // Offset vector
   };
 
-  StateEquationGenerator() = default;
-  
-  StateEquationGenerator(const double wheelbase, const double max_steer_rad)
-  : vehicle_model_(std::make_unique<VehicleModel>(wheelbase, max_steer_rad))
+  // Column-major sparse counterpart of Matrix, convertible to CSC without a dense intermediate
+  struct SparseMatrix
+  {
+    Eigen::SparseMatrix<double, Eigen::ColMajor> A;  // State transition matrix
+    Eigen::SparseMatrix<double, Eigen::ColMajor> B;  // Input matrix (block lower-triangular)
+    Eigen::VectorXd W;                               // Offset vector
+  };
+
+  // One-step matrices of X[i] = Ad[i] * X[i-1] + Bd[i] * U[i-1] + Wd[i], valid for i >= 1
+  struct StepMatrices
+  {
+    std::vector<StateMatrix, Eigen::aligned_allocator<StateMatrix>> Ad;
+    std::vector<InputMatrix, Eigen::aligned_allocator<InputMatrix>> Bd;
+    std::vector<StateVector, Eigen::aligned_allocator<StateVector>> Wd;
+  };
+
+  StateEquationGeneratorT() = default;
+
+  StateEquationGeneratorT(const double wheelbase, const double max_steer_rad)
+  : vehicle_model_(std::make_unique<Model>(wheelbase, max_steer_rad))
   {
   }
 
-  int getDimX() const { return vehicle_model_->getDimX(); }
-  int getDimU() const { return vehicle_model_->getDimU(); }
+  // Use ReferencePoint::curvature in the state equation instead of 0.0.
+  // The curvature dependent terms are read from a precomputed table, so this adds no trig cost.
+  void enableRefCurvature(const double max_curvature, const size_t num_table_samples)
+  {
+    vehicle_model_->buildCurvatureTable(max_curvature, num_table_samples);
+    use_ref_curvature_ = true;
+  }
+
+  int getDimX() const { return DimX; }
+  int getDimU() const { return DimU; }
 
   // Calculate time-series state equation: X = B * U + W
   // where X is state vector for all time steps, U is input vector for all time steps
   Matrix calcMatrix(const std::vector<ReferencePoint> & ref_points) const
   {
-    const size_t D_x = vehicle_model_->getDimX();
-    const size_t D_u = vehicle_model_->getDimU();
+    Matrix mat;
+    calcMatrix(ref_points, mat);
+    return mat;
+  }
+
+  // Same as above, but writes into mat. Its storage is reused if the number of reference points
+  // is unchanged, so with a fixed horizon the steady state does not allocate.
+  void calcMatrix(const std::vector<ReferencePoint> & ref_points, Matrix & mat) const
+  {
+    constexpr size_t D_x = DimX;
+    constexpr size_t D_u = DimU;
 
     const size_t N_ref = ref_points.size();
     const size_t N_x = N_ref * D_x;
     const size_t N_u = (N_ref - 1) * D_u;
 
     // Matrices for whole state equation
-    Eigen::MatrixXd A = Eigen::MatrixXd::Zero(N_x, N_x);
-    Eigen::MatrixXd B = Eigen::MatrixXd::Zero(N_x, N_u);
-    Eigen::VectorXd W = Eigen::VectorXd::Zero(N_x);
+    Eigen::MatrixXd & A = mat.A;
+    Eigen::MatrixXd & B = mat.B;
+    Eigen::VectorXd & W = mat.W;
+    A.setZero(N_x, N_x);
+    B.setZero(N_x, N_u);
+    W.setZero(N_x);
 
     // Matrices for one-step state equation
-    Eigen::MatrixXd Ad, Bd, Wd;
+    StateMatrix Ad;
+    InputMatrix Bd;
+    StateVector Wd;
 
     // Initial state at X[0] will be set from ego vehicle state
     // Leave W[0] as zero for now, will be overridden in solveQP
-    W.segment(0, D_x) = Eigen::VectorXd::Zero(D_x);
+    W.template segment<DimX>(0).setZero();
 
     // Calculate state equations for each time step using recurrence:
     // X[k+1] = Ad * X[k] + Bd * U[k] + Wd
-    // 
+    //
     // In matrix form: X = A_cum * X[0] + B_cum * U + W_cum
     // where A_cum, B_cum, W_cum propagate through state transitions
-    
+
     for (size_t i = 1; i < N_ref; ++i) {
       const auto & p = ref_points[i - 1];
-      
+
       // Get discrete kinematics matrix Ad, Bd, Wd
-      // NOTE: Using curvature = 0.0 for stability (same as ROS2 version)
-      vehicle_model_->calculateStateEquationMatrix(Ad, Bd, Wd, 0.0, p.delta_arc_length);
+      // NOTE: Using curvature = 0.0 for stability (same as ROS2 version) unless enabled
+      const double curvature = use_ref_curvature_ ? p.curvature : 0.0;
+      vehicle_model_->calculateStateEquationMatrix(Ad, Bd, Wd, curvature, p.delta_arc_length);
 
       // Update W: W[i] = Ad * W[i-1] + Wd (cumulative propagation)
-      W.segment(i * D_x, D_x) = Ad * W.segment((i - 1) * D_x, D_x) + Wd;
-      
+      W.template segment<DimX>(i * D_x) = Ad * W.template segment<DimX>((i - 1) * D_x) + Wd;
+
       // Update B: B[i,:] propagates previous B through Ad, plus current Bd
       // B[i, k] = Ad * B[i-1, k]  for k < i-1
       // B[i, i-1] = Bd
       for (size_t k = 0; k < i - 1; ++k) {
-        B.block(i * D_x, k * D_u, D_x, D_u) = Ad * B.block((i - 1) * D_x, k * D_u, D_x, D_u);
+        B.template block<DimX, DimU>(i * D_x, k * D_u) =
+          Ad * B.template block<DimX, DimU>((i - 1) * D_x, k * D_u);
       }
-      B.block(i * D_x, (i - 1) * D_u, D_x, D_u) = Bd;
-      
+      B.template block<DimX, DimU>(i * D_x, (i - 1) * D_u) = Bd;
+
       // A is not used in X = B*U + W formulation (initial state absorbed into W)
       // But we keep it for reference: A[i, i-1] = Ad
-      A.block(i * D_x, (i - 1) * D_x, D_x, D_x) = Ad;
+      A.template block<DimX, DimX>(i * D_x, (i - 1) * D_x) = Ad;
     }
+  }
 
-    return Matrix{A, B, W};
+  // Sparse variant of calcMatrix. The result is numerically identical to calcMatrix, but B is
+  // built column by column (U[k] only affects X[k+1], X[k+2], ...) so neither the zero upper
+  // triangle nor the O(N^2) dense block products are ever materialized.
+  // The sparsity pattern depends only on the number of reference points, not on matrix values.
+  SparseMatrix calcSparseMatrix(const std::vector<ReferencePoint> & ref_points) const
+  {
+    SparseMatrix mat;
+    StepMatrices steps;
+    calcSparseMatrix(ref_points, mat, steps);
+    return mat;
+  }
+
+  // Same as above, but writes into mat and reuses its storage. steps is the caller's scratch for
+  // the one-step matrices (see calcStepMatrices), so concurrent calls need one each.
+  void calcSparseMatrix(
+    const std::vector<ReferencePoint> & ref_points, SparseMatrix & mat, StepMatrices & steps) const
+  {
+    constexpr size_t D_x = DimX;
+    constexpr size_t D_u = DimU;
+
+    const size_t N_ref = ref_points.size();
+    const size_t N_x = N_ref * D_x;
+    const size_t N_u = (N_ref - 1) * D_u;
+
+    // One-step matrices are computed once and reused by every column of B
+    calcStepMatrices(ref_points, steps);
+    const auto & Ad_vec = steps.Ad;
+    const auto & Bd_vec = steps.Bd;
+
+    Eigen::VectorXd & W = mat.W;
+    W.setZero(N_x);
+    for (size_t i = 1; i < N_ref; ++i) {
+      W.template segment<DimX>(i * D_x) =
+        Ad_vec[i] * W.template segment<DimX>((i - 1) * D_x) + steps.Wd[i];
+    }
+
+    // B[i, k] = Ad[i] * ... * Ad[k+2] * Bd[k+1]  for i > k, zero otherwise
+    Eigen::SparseMatrix<double, Eigen::ColMajor> & B = mat.B;
+    B.resize(static_cast<Eigen::Index>(N_x), static_cast<Eigen::Index>(N_u));
+    B.reserve(static_cast<Eigen::Index>(D_x * D_u * (N_ref - 1) * N_ref / 2));
+    StateVector B_col;
+    for (size_t k = 0; k < N_ref - 1; ++k) {
+      for (size_t j = 0; j < D_u; ++j) {
+        const size_t col = k * D_u + j;
+        B.startVec(static_cast<Eigen::Index>(col));
+
+        B_col = Bd_vec[k + 1].col(j);
+        for (size_t i = k + 1; i < N_ref; ++i) {
+          if (i > k + 1) {
+            B_col = Ad_vec[i] * B_col;
+          }
+          for (size_t d = 0; d < D_x; ++d) {
+            B.insertBack(static_cast<Eigen::Index>(i * D_x + d), static_cast<Eigen::Index>(col)) =
+              B_col(d);
+          }
+        }
+      }
+    }
+    B.finalize();
+
+    // A[i, i-1] = Ad (kept for parity with the dense path)
+    Eigen::SparseMatrix<double, Eigen::ColMajor> & A = mat.A;
+    A.resize(static_cast<Eigen::Index>(N_x), static_cast<Eigen::Index>(N_x));
+    A.reserve(static_cast<Eigen::Index>(D_x * D_x * (N_ref - 1)));
+    for (size_t c = 0; c < N_x; ++c) {
+      A.startVec(static_cast<Eigen::Index>(c));
+      const size_t k = c / D_x;
+      if (k + 1 >= N_ref) {
+        continue;
+      }
+      for (size_t d = 0; d < D_x; ++d) {
+        A.insertBack(static_cast<Eigen::Index>((k + 1) * D_x + d), static_cast<Eigen::Index>(c)) =
+          Ad_vec[k + 1](d, c % D_x);
+      }
+    }
+    A.finalize();
+  }
+
+  // Only the one-step matrices, O(N) instead of the O(N^2) propagated B, for formulations that
+  // keep the states as decision variables
+  void calcStepMatrices(const std::vector<ReferencePoint> & ref_points, StepMatrices & steps) const
+  {
+    const size_t N_ref = ref_points.size();
+    steps.Ad.resize(N_ref);
+    steps.Bd.resize(N_ref);
+    steps.Wd.resize(N_ref);
+    for (size_t i = 1; i < N_ref; ++i) {
+      const auto & p = ref_points[i - 1];
+
+      // NOTE: Same curvature handling as dense calcMatrix
+      const double curvature = use_ref_curvature_ ? p.curvature : 0.0;
+      vehicle_model_->calculateStateEquationMatrix(
+        steps.Ad[i], steps.Bd[i], steps.Wd[i], curvature, p.delta_arc_length);
+    }
   }
 
   Eigen::VectorXd predict(const Matrix & mat, const Eigen::VectorXd & U) const
@@ -92,10 +240,19 @@ public:
     return mat.B * U + mat.W;
   }
 
+  Eigen::VectorXd predict(const SparseMatrix & mat, const Eigen::VectorXd & U) const
+  {
+    return mat.B * U + mat.W;
+  }
+
 private:
-  std::unique_ptr<VehicleModel> vehicle_model_;
+  std::unique_ptr<Model> vehicle_model_;
+  bool use_ref_curvature_{false};
 };
 
+// Default generator for the [lateral_error, yaw_error] / [steering_angle] kinematic model
+using StateEquationGenerator = StateEquationGeneratorT<VehicleModel>;
+
 }  // namespace autoware::path_optimizer
 
 #endif  // PATH_OPTIMIZER__STATE_EQUATION_GENERATOR_HPP_
@@ -0,0 +1,382 @@
+// Single-threaded coroutine executor and awaitable port inputs for a SWC (C++20)
+#ifndef PATH_OPTIMIZER__SWC_EXECUTOR_HPP_
+#define PATH_OPTIMIZER__SWC_EXECUTOR_HPP_
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+class SwcExecutor;
+
+/**
+ * SwcTask: top level coroutine run by a SwcExecutor
+ *
+ * A task starts when it is spawned and may co_await AsyncInput::next, SwcExecutor::sleepUntil and
+ * sleepFor. An exception leaving the task stops the executor and is rethrown by run().
+ */
+class SwcTask
+{
+public:
+  struct promise_type
+  {
+    std::exception_ptr error;
+
+    SwcTask get_return_object()
+    {
+      return SwcTask(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { error = std::current_exception(); }
+  };
+
+  SwcTask(SwcTask && other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+  SwcTask(const SwcTask &) = delete;
+  SwcTask & operator=(const SwcTask &) = delete;
+  ~SwcTask()
+  {
+    if (handle_) {
+      handle_.destroy();
+    }
+  }
+
+private:
+  friend class SwcExecutor;
+  explicit SwcTask(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * SwcExecutor: runs the coroutines of one SWC on the thread calling run()
+ *
+ * Replaces the per port receive threads and polling loops: the receive handlers of the rport_*
+ * classes (ara::com SetReceiveHandler, any thread) push the samples into AsyncInputs, and the
+ * waiting coroutine is resumed on the executor thread. With nothing ready the thread sleeps on a
+ * condition variable until the next push or the earliest deadline, so an idle SWC does not use CPU
+ * and a sample wakes its consumer right away instead of at the next poll.
+ *
+ *   SwcExecutor executor;
+ *   AsyncInput<Route> mp(executor);
+ *   AsyncInput<Odometry> ss(executor);
+ *   rport_mp2bpp.SetReceiveHandler([&] { mp.push(take_sample()); });
+ *
+ *   SwcTask planLoop(AsyncInput<Odometry> & ss, AsyncInput<Route> & mp) {
+ *     while (true) {
+ *       const auto deadline = SwcExecutor::Clock::now() + std::chrono::milliseconds(100);
+ *       auto odometry = co_await ss.next(deadline);   // mandatory input
+ *       auto route = co_await mp.next(deadline);      // same deadline: waits for both
+ *       if (!odometry) { report_timeout(); continue; }
+ *       plan(*odometry, route);                       // route is optional here
+ *     }
+ *   }
+ *   executor.spawn(planLoop(ss, mp));
+ *   executor.run();
+ *
+ * All coroutines run on one thread and need no locks among themselves. run() returns when all
+ * tasks are done or after stop(). Tasks take their inputs as parameters: the captures of a
+ * coroutine lambda do not live in the coroutine frame.
+ */
+class SwcExecutor
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  // A suspended coroutine, resumed by its input or its deadline
+  struct Waiter
+  {
+    std::coroutine_handle<> handle;
+    bool has_timer{false};
+    bool timed_out{false};
+    std::multimap<Clock::time_point, Waiter *>::iterator timer;
+    void (*on_timeout)(void *){nullptr};  // called with the lock held, with context
+    void * context{nullptr};
+  };
+
+  SwcExecutor() = default;
+  SwcExecutor(const SwcExecutor &) = delete;
+  SwcExecutor & operator=(const SwcExecutor &) = delete;
+
+  ~SwcExecutor()
+  {
+    for (auto handle : tasks_) {
+      handle.destroy();
+    }
+  }
+
+  void spawn(SwcTask task)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto handle = std::exchange(task.handle_, {});
+    tasks_.push_back(handle);
+    ready_.push_back(handle);
+  }
+
+  // Runs the tasks until all are done or stop() is called; rethrows an exception of a task
+  void run()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stop_ = false;
+    while (!stop_ && !tasks_.empty()) {
+      fireTimers(Clock::now());
+      if (ready_.empty()) {
+        if (timers_.empty()) {
+          cv_.wait(lock, [this] { return stop_ || !ready_.empty(); });
+        } else {
+          const auto deadline = timers_.begin()->first;
+          cv_.wait_until(lock, deadline, [this] { return stop_ || !ready_.empty(); });
+        }
+        continue;
+      }
+      const auto handle = ready_.front();
+      ready_.pop_front();
+      ++num_resumes_;
+      lock.unlock();
+      handle.resume();
+      lock.lock();
+      if (handle.done()) {
+        if (const auto error = finish(handle)) {
+          std::rethrow_exception(error);
+        }
+      }
+    }
+  }
+
+  // Thread safe
+  void stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+  }
+
+  // Resumptions of coroutines so far, e.g. to compare the wake ups with the received samples
+  uint64_t numResumes() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_resumes_;
+  }
+
+  class SleepAwaitable
+  {
+  public:
+    SleepAwaitable(SwcExecutor & executor, const Clock::time_point deadline)
+    : executor_(executor), deadline_(deadline)
+    {
+    }
+    bool await_ready() const { return Clock::now() >= deadline_; }
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+      std::lock_guard<std::mutex> lock(executor_.mutex_);
+      waiter_.handle = handle;
+      executor_.addTimer(deadline_, waiter_);
+    }
+    void await_resume() const {}
+
+  private:
+    SwcExecutor & executor_;
+    Clock::time_point deadline_;
+    Waiter waiter_;
+  };
+
+  SleepAwaitable sleepUntil(const Clock::time_point deadline) { return {*this, deadline}; }
+  SleepAwaitable sleepFor(const Clock::duration duration)
+  {
+    return {*this, Clock::now() + duration};
+  }
+
+private:
+  template <typename T>
+  friend class AsyncInput;
+
+  // With the lock held
+  void addTimer(const Clock::time_point deadline, Waiter & waiter)
+  {
+    waiter.timer = timers_.emplace(deadline, &waiter);
+    waiter.has_timer = true;
+  }
+  // With the lock held; resumes the waiter from any thread
+  void wake(Waiter & waiter)
+  {
+    if (waiter.has_timer) {
+      timers_.erase(waiter.timer);
+      waiter.has_timer = false;
+    }
+    ready_.push_back(waiter.handle);
+    cv_.notify_one();
+  }
+
+  void fireTimers(const Clock::time_point now)
+  {
+    while (!timers_.empty() && timers_.begin()->first <= now) {
+      Waiter * waiter = timers_.begin()->second;
+      timers_.erase(timers_.begin());
+      waiter->has_timer = false;
+      waiter->timed_out = true;
+      if (waiter->on_timeout != nullptr) {
+        waiter->on_timeout(waiter->context);
+      }
+      ready_.push_back(waiter->handle);
+    }
+  }
+
+  // Destroys a finished task; returns its exception
+  std::exception_ptr finish(const std::coroutine_handle<> handle)
+  {
+    for (size_t i = 0; i < tasks_.size(); ++i) {
+      if (tasks_[i] == handle) {
+        const auto error = tasks_[i].promise().error;
+        tasks_[i].destroy();
+        tasks_.erase(tasks_.begin() + static_cast<std::ptrdiff_t>(i));
+        return error;
+      }
+    }
+    return {};
+  }
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::coroutine_handle<>> ready_;
+  std::multimap<Clock::time_point, Waiter *> timers_;
+  std::vector<std::coroutine_handle<SwcTask::promise_type>> tasks_;
+  uint64_t num_resumes_{0};
+  bool stop_{false};
+};
+
+/**
+ * AsyncInput: samples of one port for the coroutines of a SwcExecutor
+ *
+ * push() may be called from any thread, typically the receive handler of the port; it keeps the
+ * newest capacity samples (older ones are counted in dropped(), as FrameChannel). co_await
+ * next(deadline) returns the oldest queued sample at once, or suspends until one is pushed, or
+ * returns nothing at the deadline. Only one coroutine may wait on an input at a time.
+ */
+template <typename T>
+class AsyncInput
+{
+public:
+  using Clock = SwcExecutor::Clock;
+
+  explicit AsyncInput(SwcExecutor & executor, const size_t capacity = 1)
+  : executor_(executor), capacity_(capacity > 0 ? capacity : 1)
+  {
+  }
+
+  AsyncInput(const AsyncInput &) = delete;
+  AsyncInput & operator=(const AsyncInput &) = delete;
+
+  void push(T value)
+  {
+    std::lock_guard<std::mutex> lock(executor_.mutex_);
+    if (queue_.size() == capacity_) {
+      queue_.pop_front();
+      ++dropped_;
+    }
+    queue_.push_back(std::move(value));
+    if (waiter_ != nullptr) {
+      NextAwaitable * waiter = std::exchange(waiter_, nullptr);
+      waiter->result_ = take();
+      executor_.wake(waiter->waiter_);
+    }
+  }
+
+  class NextAwaitable
+  {
+  public:
+    NextAwaitable(AsyncInput & input, const Clock::time_point deadline)
+    : input_(input), deadline_(deadline)
+    {
+    }
+
+    bool await_ready()
+    {
+      std::lock_guard<std::mutex> lock(input_.executor_.mutex_);
+      if (!input_.queue_.empty()) {
+        result_ = input_.take();
+        return true;
+      }
+      return false;
+    }
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+      std::lock_guard<std::mutex> lock(input_.executor_.mutex_);
+      if (!input_.queue_.empty()) {
+        result_ = input_.take();  // pushed after await_ready
+        return false;
+      }
+      if (Clock::now() >= deadline_) {
+        return false;
+      }
+      waiter_.handle = handle;
+      waiter_.on_timeout = [](void * input) {
+        static_cast<AsyncInput *>(input)->waiter_ = nullptr;
+      };
+      waiter_.context = &input_;
+      input_.waiter_ = this;
+      if (deadline_ != Clock::time_point::max()) {
+        input_.executor_.addTimer(deadline_, waiter_);
+      }
+      return true;
+    }
+    // The sample, nothing at the deadline
+    std::optional<T> await_resume() { return std::move(result_); }
+
+  private:
+    friend class AsyncInput;
+
+    AsyncInput & input_;
+    Clock::time_point deadline_;
+    std::optional<T> result_;
+    SwcExecutor::Waiter waiter_;
+  };
+
+  NextAwaitable next(const Clock::time_point deadline = Clock::time_point::max())
+  {
+    return {*this, deadline};
+  }
+  NextAwaitable next(const Clock::duration timeout) { return {*this, Clock::now() + timeout}; }
+
+  uint64_t dropped() const
+  {
+    std::lock_guard<std::mutex> lock(executor_.mutex_);
+    return dropped_;
+  }
+
+private:
+  // With the lock held
+  T take()
+  {
+    T value = std::move(queue_.front());
+    queue_.pop_front();
+    return value;
+  }
+
+  SwcExecutor & executor_;
+  size_t capacity_;
+  std::deque<T> queue_;
+  NextAwaitable * waiter_{nullptr};
+  uint64_t dropped_{0};
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // __cpp_impl_coroutine
+
+#endif  // PATH_OPTIMIZER__SWC_EXECUTOR_HPP_
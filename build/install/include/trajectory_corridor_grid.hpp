@@ -0,0 +1,324 @@
+// Uniform grid over the footprint corridor of a trajectory for obstacle filtering
+#ifndef PATH_OPTIMIZER__TRAJECTORY_CORRIDOR_GRID_HPP_
+#define PATH_OPTIMIZER__TRAJECTORY_CORRIDOR_GRID_HPP_
+
+#include "path_optimizer_types.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * TrajectoryCorridorGrid: which trajectory segments are near a point, in O(1)
+ *
+ * The corridor is the set of points within half_width of the trajectory polyline (the ego
+ * footprint swept along it). build() registers every segment in the grid cells overlapped by its
+ * bounding box grown by half_width; the cells are stored as one flat CSR array (offsets + segment
+ * indices), so a rebuild per cycle keeps all capacity. A query only looks at the cells of its
+ * bounding box: obstacle points or polygons in empty cells are rejected without touching a
+ * segment, and the exact distance test only runs against the few segments registered there.
+ *
+ *   grid.build(ego_traj_points, 0.5 * vehicle_width + margin);
+ *   for (const auto & obstacle : obstacles) {
+ *     for (const auto & pose : predicted_path) {
+ *       if (grid.intersects(footprint_polygon(pose))) { ... }   // or intersects(p, radius)
+ *     }
+ *   }
+ *
+ * The cell size defaults to the corridor width and grows if the trajectory bounding box would
+ * need more than max_cells cells. Queries dedupe segments with a per-grid stamp and are therefore
+ * not thread safe on the same instance.
+ */
+class TrajectoryCorridorGrid
+{
+public:
+  explicit TrajectoryCorridorGrid(const double cell_size = 0.0, const size_t max_cells = 1U << 16)
+  : param_cell_size_(cell_size), max_cells_(std::max<size_t>(max_cells, 1))
+  {
+  }
+
+  // Capacity preserving, so steady-state updates do not allocate
+  template <typename PointT>
+  void build(const std::vector<PointT> & points, const double half_width)
+  {
+    const size_t n = points.size();
+    x_.resize(n);
+    y_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      x_[i] = points[i].pose.position.x;
+      y_[i] = points[i].pose.position.y;
+    }
+    half_width_ = std::max(half_width, 0.0);
+    num_segments_ = n >= 2 ? n - 1 : n;  // a single point is one degenerate segment
+    stamps_.assign(num_segments_, 0);
+    stamp_ = 0;
+    if (n == 0) {
+      cols_ = rows_ = 0;
+      cell_offsets_.assign(1, 0);
+      cell_segments_.clear();
+      return;
+    }
+
+    min_x_ = *std::min_element(x_.begin(), x_.end()) - half_width_;
+    min_y_ = *std::min_element(y_.begin(), y_.end()) - half_width_;
+    const double extent_x = *std::max_element(x_.begin(), x_.end()) + half_width_ - min_x_;
+    const double extent_y = *std::max_element(y_.begin(), y_.end()) + half_width_ - min_y_;
+    cell_size_ = param_cell_size_ > 0.0 ? param_cell_size_ : std::max(2.0 * half_width_, 1.0);
+    const double area_cells = (extent_x / cell_size_ + 1.0) * (extent_y / cell_size_ + 1.0);
+    if (area_cells > static_cast<double>(max_cells_)) {
+      cell_size_ *= std::sqrt(area_cells / static_cast<double>(max_cells_)) * 1.01;
+    }
+    cols_ = static_cast<size_t>(extent_x / cell_size_) + 1;
+    rows_ = static_cast<size_t>(extent_y / cell_size_) + 1;
+
+    // Two passes: count the segments per cell, then fill
+    cell_offsets_.assign(cols_ * rows_ + 1, 0);
+    forEachSegmentCell([this](const size_t cell, const size_t) { ++cell_offsets_[cell + 1]; });
+    for (size_t c = 0; c < cols_ * rows_; ++c) {
+      cell_offsets_[c + 1] += cell_offsets_[c];
+    }
+    cell_segments_.resize(cell_offsets_.back());
+    fill_.assign(cell_offsets_.begin(), cell_offsets_.end() - 1);
+    forEachSegmentCell([this](const size_t cell, const size_t seg) {
+      cell_segments_[fill_[cell]++] = static_cast<uint32_t>(seg);
+    });
+  }
+
+  double getHalfWidth() const { return half_width_; }
+  double getCellSize() const { return cell_size_; }
+
+  // O(1) test: false if no segment is registered in the cells within radius of (px, py)
+  bool isNearCorridor(const double px, const double py, const double radius = 0.0) const
+  {
+    bool found = false;
+    forEachCell(px - radius, py - radius, px + radius, py + radius, [&](const size_t cell) {
+      found = found || cell_offsets_[cell + 1] > cell_offsets_[cell];
+    });
+    return found;
+  }
+
+  /**
+   * @brief Distance from (px, py) to the trajectory polyline over the segments near it
+   * @param seg nearest segment, if one is within search_radius
+   * @return infinity if no segment is within search_radius (cells only, not exact)
+   */
+  double calcDistance(
+    const double px, const double py, const double search_radius, size_t & seg) const
+  {
+    double min_dist_sq = std::numeric_limits<double>::infinity();
+    forEachCandidateSegment(
+      px - search_radius, py - search_radius, px + search_radius, py + search_radius,
+      [&](const size_t k) {
+        const double dist_sq = calcSquaredDistanceToSegment(k, px, py);
+        if (dist_sq < min_dist_sq) {
+          min_dist_sq = dist_sq;
+          seg = k;
+        }
+      });
+    return std::sqrt(min_dist_sq);
+  }
+
+  // Exact: a circle of radius at (px, py) overlaps the corridor
+  bool intersects(const double px, const double py, const double radius = 0.0) const
+  {
+    size_t seg = 0;
+    return calcDistance(px, py, half_width_ + radius, seg) <= half_width_ + radius;
+  }
+
+  // Exact: the polygon (closed implicitly, any orientation) overlaps the corridor
+  bool intersects(const std::vector<Point> & polygon) const
+  {
+    if (polygon.empty()) {
+      return false;
+    }
+    double min_x = polygon.front().x;
+    double max_x = min_x;
+    double min_y = polygon.front().y;
+    double max_y = min_y;
+    for (const auto & p : polygon) {
+      min_x = std::min(min_x, p.x);
+      max_x = std::max(max_x, p.x);
+      min_y = std::min(min_y, p.y);
+      max_y = std::max(max_y, p.y);
+    }
+    const double w = half_width_;
+    const double w_sq = w * w;
+    bool hit = false;
+    forEachCandidateSegment(min_x - w, min_y - w, max_x + w, max_y + w, [&](const size_t k) {
+      if (hit) {
+        return;
+      }
+      // Trajectory point inside the polygon, or a polygon edge within half_width of the segment
+      if (isInside(polygon, x_[k], y_[k])) {
+        hit = true;
+        return;
+      }
+      for (size_t e = 0; e < polygon.size() && !hit; ++e) {
+        const auto & a = polygon[e];
+        const auto & b = polygon[(e + 1) % polygon.size()];
+        hit = calcSquaredSegmentDistance(k, a.x, a.y, b.x, b.y) <= w_sq;
+      }
+    });
+    return hit;
+  }
+
+  /**
+   * @brief Calls f(segment index) once for every segment registered in the cells overlapping the
+   * box [min_x, max_x] x [min_y, max_y]
+   */
+  template <typename F>
+  void forEachCandidateSegment(
+    const double min_x, const double min_y, const double max_x, const double max_y, F && f) const
+  {
+    if (++stamp_ == 0) {  // wrapped around: stale stamps could match
+      std::fill(stamps_.begin(), stamps_.end(), 0);
+      stamp_ = 1;
+    }
+    forEachCell(min_x, min_y, max_x, max_y, [&](const size_t cell) {
+      for (auto k = cell_offsets_[cell]; k < cell_offsets_[cell + 1]; ++k) {
+        const uint32_t seg = cell_segments_[k];
+        if (stamps_[seg] != stamp_) {
+          stamps_[seg] = stamp_;
+          f(static_cast<size_t>(seg));
+        }
+      }
+    });
+  }
+
+private:
+  // Calls f(cell) for the cells overlapping the box, clipped to the grid
+  template <typename F>
+  void forEachCell(
+    const double min_x, const double min_y, const double max_x, const double max_y, F && f) const
+  {
+    if (cols_ == 0) {
+      return;
+    }
+    const double gx0 = (min_x - min_x_) / cell_size_;
+    const double gy0 = (min_y - min_y_) / cell_size_;
+    const double gx1 = (max_x - min_x_) / cell_size_;
+    const double gy1 = (max_y - min_y_) / cell_size_;
+    const auto cols = static_cast<double>(cols_);
+    const auto rows = static_cast<double>(rows_);
+    if (!(gx1 >= 0.0 && gy1 >= 0.0 && gx0 < cols && gy0 < rows)) {
+      return;  // outside of the grid (also NaN)
+    }
+    const auto c0 = static_cast<size_t>(std::max(gx0, 0.0));
+    const auto r0 = static_cast<size_t>(std::max(gy0, 0.0));
+    const auto c1 = static_cast<size_t>(std::min(gx1, cols - 1.0));
+    const auto r1 = static_cast<size_t>(std::min(gy1, rows - 1.0));
+    for (size_t r = r0; r <= r1; ++r) {
+      for (size_t c = c0; c <= c1; ++c) {
+        f(r * cols_ + c);
+      }
+    }
+  }
+
+  // Calls f(cell, segment) for the cells of every segment box grown by half_width
+  template <typename F>
+  void forEachSegmentCell(F && f) const
+  {
+    for (size_t k = 0; k < num_segments_; ++k) {
+      const size_t next = std::min(k + 1, x_.size() - 1);
+      const double min_x = std::min(x_[k], x_[next]) - half_width_;
+      const double min_y = std::min(y_[k], y_[next]) - half_width_;
+      const double max_x = std::max(x_[k], x_[next]) + half_width_;
+      const double max_y = std::max(y_[k], y_[next]) + half_width_;
+      forEachCell(min_x, min_y, max_x, max_y, [&](const size_t cell) { f(cell, k); });
+    }
+  }
+
+  double calcSquaredDistanceToSegment(const size_t k, const double px, const double py) const
+  {
+    const size_t next = std::min(k + 1, x_.size() - 1);
+    const double seg_x = x_[next] - x_[k];
+    const double seg_y = y_[next] - y_[k];
+    const double seg_len_sq = seg_x * seg_x + seg_y * seg_y;
+    const double ratio =
+      seg_len_sq > 1e-12
+        ? std::clamp(((px - x_[k]) * seg_x + (py - y_[k]) * seg_y) / seg_len_sq, 0.0, 1.0)
+        : 0.0;
+    const double dx = x_[k] + ratio * seg_x - px;
+    const double dy = y_[k] + ratio * seg_y - py;
+    return dx * dx + dy * dy;
+  }
+
+  // Squared distance between segment k and the segment (ax, ay)-(bx, by)
+  double calcSquaredSegmentDistance(
+    const size_t k, const double ax, const double ay, const double bx, const double by) const
+  {
+    const size_t next = std::min(k + 1, x_.size() - 1);
+    const auto cross = [](double ox, double oy, double px, double py, double qx, double qy) {
+      return (px - ox) * (qy - oy) - (py - oy) * (qx - ox);
+    };
+    const double d1 = cross(ax, ay, bx, by, x_[k], y_[k]);
+    const double d2 = cross(ax, ay, bx, by, x_[next], y_[next]);
+    const double d3 = cross(x_[k], y_[k], x_[next], y_[next], ax, ay);
+    const double d4 = cross(x_[k], y_[k], x_[next], y_[next], bx, by);
+    if (((d1 > 0.0 && d2 < 0.0) || (d1 < 0.0 && d2 > 0.0)) &&
+        ((d3 > 0.0 && d4 < 0.0) || (d3 < 0.0 && d4 > 0.0))) {
+      return 0.0;  // proper crossing
+    }
+
+    // Otherwise the minimum is at one of the four end points
+    const auto point_to_ab = [&](const double px, const double py) {
+      const double seg_x = bx - ax;
+      const double seg_y = by - ay;
+      const double seg_len_sq = seg_x * seg_x + seg_y * seg_y;
+      const double ratio =
+        seg_len_sq > 1e-12
+          ? std::clamp(((px - ax) * seg_x + (py - ay) * seg_y) / seg_len_sq, 0.0, 1.0)
+          : 0.0;
+      const double dx = ax + ratio * seg_x - px;
+      const double dy = ay + ratio * seg_y - py;
+      return dx * dx + dy * dy;
+    };
+    return std::min(
+      {calcSquaredDistanceToSegment(k, ax, ay), calcSquaredDistanceToSegment(k, bx, by),
+       point_to_ab(x_[k], y_[k]), point_to_ab(x_[next], y_[next])});
+  }
+
+  // Even-odd rule
+  static bool isInside(const std::vector<Point> & polygon, const double px, const double py)
+  {
+    bool inside = false;
+    for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+      const auto & a = polygon[i];
+      const auto & b = polygon[j];
+      if ((a.y > py) != (b.y > py) && px < (b.x - a.x) * (py - a.y) / (b.y - a.y) + a.x) {
+        inside = !inside;
+      }
+    }
+    return inside;
+  }
+
+  double param_cell_size_;  // 0: corridor width
+  size_t max_cells_;
+
+  std::vector<double> x_;
+  std::vector<double> y_;
+  size_t num_segments_{0};
+  double half_width_{0.0};
+
+  double min_x_{0.0};
+  double min_y_{0.0};
+  double cell_size_{1.0};
+  size_t cols_{0};
+  size_t rows_{0};
+  std::vector<size_t> cell_offsets_;      // Segments of cell c: [offsets[c], offsets[c + 1])
+  std::vector<uint32_t> cell_segments_;
+  std::vector<size_t> fill_;              // Build scratch
+
+  mutable std::vector<uint32_t> stamps_;  // Query dedupe
+  mutable uint32_t stamp_{0};
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__TRAJECTORY_CORRIDOR_GRID_HPP_
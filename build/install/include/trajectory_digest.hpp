@@ -0,0 +1,123 @@
+// Compact arc-length indexed trajectory copy and early exit path shape check
+#ifndef PATH_OPTIMIZER__TRAJECTORY_DIGEST_HPP_
+#define PATH_OPTIMIZER__TRAJECTORY_DIGEST_HPP_
+
+#include "path_optimizer_types.hpp"
+#include "trajectory_soa.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * TrajectoryDigest: positions and arc length of a trajectory, structure of arrays
+ *
+ * A replan check that keeps this instead of the previous std::vector<TrajectoryPoint> copies three
+ * doubles per point, and calcPathShapeChange() reads only these arrays.
+ */
+struct TrajectoryDigest
+{
+  std::vector<double> s;
+  std::vector<double> x;
+  std::vector<double> y;
+
+  // Capacity preserving, so steady-state updates do not allocate
+  void assign(const std::vector<TrajectoryPoint> & traj_points)
+  {
+    const size_t n = traj_points.size();
+    s.resize(n);
+    x.resize(n);
+    y.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      x[i] = traj_points[i].pose.position.x;
+      y[i] = traj_points[i].pose.position.y;
+      s[i] = i == 0 ? 0.0 : s[i - 1] + std::hypot(x[i] - x[i - 1], y[i] - y[i - 1]);
+    }
+  }
+
+  // From the structure of arrays layout: two array copies and the arc length kernel
+  void assign(const TrajectorySoA & traj)
+  {
+    x.assign(traj.x.begin(), traj.x.end());
+    y.assign(traj.y.begin(), traj.y.end());
+    traj.calcArcLength(s);
+  }
+
+  size_t size() const { return s.size(); }
+};
+
+namespace trajectory_digest
+{
+
+// ratio is the unclamped position of the projection on the segment
+inline double calcSquaredDistanceToSegment(
+  const TrajectoryDigest & digest, const size_t seg, const double px, const double py,
+  double & ratio)
+{
+  const double seg_x = digest.x[seg + 1] - digest.x[seg];
+  const double seg_y = digest.y[seg + 1] - digest.y[seg];
+  const double seg_len_sq = seg_x * seg_x + seg_y * seg_y;
+  ratio = seg_len_sq > 1e-12
+            ? ((px - digest.x[seg]) * seg_x + (py - digest.y[seg]) * seg_y) / seg_len_sq
+            : 0.0;
+  const double clamped_ratio = std::clamp(ratio, 0.0, 1.0);
+  const double dx = digest.x[seg] + clamped_ratio * seg_x - px;
+  const double dy = digest.y[seg] + clamped_ratio * seg_y - py;
+  return dx * dx + dy * dy;
+}
+
+}  // namespace trajectory_digest
+
+// Max distance of traj_points from the previous trajectory over their overlapping range, the
+// shape check of ReplanChecker. Returns as soon as the distance exceeds max_allowed_dist (the
+// value is then only a lower bound).
+inline double calcPathShapeChange(
+  const TrajectoryDigest & prev_digest, const std::vector<TrajectoryPoint> & traj_points,
+  const double max_allowed_dist)
+{
+  if (prev_digest.size() < 2) {
+    return 0.0;
+  }
+
+  double max_dist = 0.0;
+  size_t seg = 0;  // Both trajectories run forward, so the matched segment only moves forward
+  const size_t num_segs = prev_digest.size() - 1;
+  for (const auto & traj_point : traj_points) {
+    const double px = traj_point.pose.position.x;
+    const double py = traj_point.pose.position.y;
+
+    double ratio = 0.0;
+    double dist_sq =
+      trajectory_digest::calcSquaredDistanceToSegment(prev_digest, seg, px, py, ratio);
+    while (seg + 1 < num_segs) {
+      double next_ratio = 0.0;
+      const double next_dist_sq =
+        trajectory_digest::calcSquaredDistanceToSegment(prev_digest, seg + 1, px, py, next_ratio);
+      if (next_dist_sq > dist_sq) {
+        break;
+      }
+      ++seg;
+      dist_sq = next_dist_sq;
+      ratio = next_ratio;
+    }
+
+    // Skip points outside of the previous trajectory
+    if ((seg == 0 && ratio < 0.0) || (seg + 1 == num_segs && ratio > 1.0)) {
+      continue;
+    }
+
+    max_dist = std::max(max_dist, std::sqrt(dist_sq));
+    if (max_dist > max_allowed_dist) {
+      break;
+    }
+  }
+  return max_dist;
+}
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__TRAJECTORY_DIGEST_HPP_
@@ -0,0 +1,243 @@
+// Asynchronous trajectory export to the evaluation server (tool/server.py)
+#ifndef PATH_OPTIMIZER__TRAJECTORY_EXPORTER_HPP_
+#define PATH_OPTIMIZER__TRAJECTORY_EXPORTER_HPP_
+
+#include "path_optimizer_types.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * TrajectoryExporter: sends trajectories as JSON lines from a background thread
+ *
+ * push() copies the trajectory into a preallocated slot of a single-producer single-consumer
+ * queue and returns; it never blocks and does not allocate once the slots have grown to the
+ * trajectory size. The export thread serializes the queued trajectories into one buffer and sends
+ * it with a single write per batch, so a 10 Hz planner costs a few syscalls per second instead of
+ * one formatted write per message inside the planning cycle.
+ *
+ * If the collector is slow the queue fills up. Above half of the capacity only every second
+ * trajectory is accepted (decimation), and trajectories are dropped if the queue is full; both are
+ * counted. The line format is the one read by tool/analyze_trajectory_frequency.py:
+ *   {"timestamp":<ns>,"message":{"header":{"stamp":{...}},"points":[...]}}
+ */
+class TrajectoryExporter
+{
+public:
+  /**
+   * @param fd connected stream socket, closed by the exporter
+   * @param capacity number of queued trajectories, rounded up to a power of two
+   * @param batch_bytes a batch is sent once it is this large or the queue is empty
+   */
+  explicit TrajectoryExporter(
+    const int fd, const size_t capacity = 16, const size_t batch_bytes = 64U * 1024U)
+  : fd_(fd), batch_bytes_(batch_bytes)
+  {
+    size_t size = 2;
+    while (size < capacity) {
+      size <<= 1U;
+    }
+    mask_ = size - 1;
+    slots_ = std::make_unique<Slot[]>(size);
+    batch_.reserve(batch_bytes_ * 2);
+    thread_ = std::thread([this] { exportLoop(); });
+  }
+
+  TrajectoryExporter(const TrajectoryExporter &) = delete;
+  TrajectoryExporter & operator=(const TrajectoryExporter &) = delete;
+
+  ~TrajectoryExporter()
+  {
+    stop_.store(true, std::memory_order_release);
+    thread_.join();
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+
+  // Connects a TCP socket to host:port (IPv4 address), -1 on failure
+  static int connectTo(const std::string & host, const uint16_t port)
+  {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+      return -1;
+    }
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (
+      ::inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1 ||
+      ::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+      ::close(fd);
+      return -1;
+    }
+    return fd;
+  }
+
+  /**
+   * @brief Queues a trajectory for export, called from the planning thread
+   * @return false if it was decimated or dropped
+   */
+  bool push(const int64_t stamp_ns, const std::vector<TrajectoryPoint> & points)
+  {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    const size_t queued = head - tail_.load(std::memory_order_acquire);
+    if (queued > mask_) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    if (2 * queued > mask_ && (sequence_++ & 1U) != 0) {
+      decimated_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    Slot & slot = slots_[head & mask_];
+    slot.stamp_ns = stamp_ns;
+    slot.points.assign(points.begin(), points.end());
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+  uint64_t decimated() const { return decimated_.load(std::memory_order_relaxed); }
+  uint64_t exported() const { return exported_.load(std::memory_order_relaxed); }
+
+private:
+  struct Slot
+  {
+    int64_t stamp_ns{0};
+    std::vector<TrajectoryPoint> points;
+  };
+
+  void appendNumber(const double value)
+  {
+    char buf[32];
+    const int n = std::snprintf(buf, sizeof(buf), "%.9g", value);
+    batch_.append(buf, static_cast<size_t>(n));
+  }
+
+  void appendInteger(const int64_t value)
+  {
+    char buf[24];
+    const int n = std::snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(value));
+    batch_.append(buf, static_cast<size_t>(n));
+  }
+
+  void appendStamp(const int64_t sec, const int64_t nanosec)
+  {
+    batch_ += "{\"sec\":";
+    appendInteger(sec);
+    batch_ += ",\"nanosec\":";
+    appendInteger(nanosec);
+    batch_ += '}';
+  }
+
+  void serialize(const Slot & slot)
+  {
+    batch_ += "{\"timestamp\":";
+    appendInteger(slot.stamp_ns);
+    batch_ += ",\"message\":{\"header\":{\"stamp\":";
+    appendStamp(slot.stamp_ns / 1000000000LL, slot.stamp_ns % 1000000000LL);
+    batch_ += "},\"points\":[";
+    for (size_t i = 0; i < slot.points.size(); ++i) {
+      const auto & p = slot.points[i];
+      if (i > 0) {
+        batch_ += ',';
+      }
+      batch_ += "{\"time_from_start\":";
+      appendStamp(p.time_from_start.sec, p.time_from_start.nanosec);
+      batch_ += ",\"pose\":{\"position\":{\"x\":";
+      appendNumber(p.pose.position.x);
+      batch_ += ",\"y\":";
+      appendNumber(p.pose.position.y);
+      batch_ += ",\"z\":";
+      appendNumber(p.pose.position.z);
+      batch_ += "},\"orientation\":{\"x\":";
+      appendNumber(p.pose.orientation.x);
+      batch_ += ",\"y\":";
+      appendNumber(p.pose.orientation.y);
+      batch_ += ",\"z\":";
+      appendNumber(p.pose.orientation.z);
+      batch_ += ",\"w\":";
+      appendNumber(p.pose.orientation.w);
+      batch_ += "}},\"longitudinal_velocity_mps\":";
+      appendNumber(p.longitudinal_velocity_mps);
+      batch_ += ",\"acceleration_mps2\":";
+      appendNumber(p.acceleration_mps2);
+      batch_ += '}';
+    }
+    batch_ += "]}}\n";
+  }
+
+  // Sends the whole batch; on a broken connection the rest of the export is discarded
+  void sendBatch()
+  {
+    size_t offset = 0;
+    while (offset < batch_.size() && fd_ >= 0) {
+      const ssize_t n = ::send(fd_, batch_.data() + offset, batch_.size() - offset, MSG_NOSIGNAL);
+      if (n <= 0) {
+        ::close(fd_);
+        fd_ = -1;
+        break;
+      }
+      offset += static_cast<size_t>(n);
+    }
+    batch_.clear();
+  }
+
+  void exportLoop()
+  {
+    for (;;) {
+      const bool stop = stop_.load(std::memory_order_acquire);
+      size_t tail = tail_.load(std::memory_order_relaxed);
+      const size_t head = head_.load(std::memory_order_acquire);
+      for (; tail != head; ++tail) {
+        serialize(slots_[tail & mask_]);
+        tail_.store(tail + 1, std::memory_order_release);  // the slot may be reused from here
+        exported_.fetch_add(1, std::memory_order_relaxed);
+        if (batch_.size() >= batch_bytes_) {
+          sendBatch();
+        }
+      }
+      if (!batch_.empty()) {
+        sendBatch();
+      }
+      if (stop) {
+        return;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+  }
+
+  int fd_;
+  size_t batch_bytes_;
+  size_t mask_{0};
+  std::unique_ptr<Slot[]> slots_;
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+  size_t sequence_{0};  // only used by the producer
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> decimated_{0};
+  std::atomic<uint64_t> exported_{0};
+
+  std::string batch_;  // only used by the export thread
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__TRAJECTORY_EXPORTER_HPP_
@@ -0,0 +1,181 @@
+// Arc length index and hinted nearest search for trajectories in Path Optimizer
+#ifndef PATH_OPTIMIZER__TRAJECTORY_INDEX_HPP_
+#define PATH_OPTIMIZER__TRAJECTORY_INDEX_HPP_
+
+#include "path_optimizer_types.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * TrajectoryIndex: cumulative arc length and positions of a trajectory for repeated queries
+ *
+ * calcSignedArcLength between two indices is a subtraction. The nearest searches take the index
+ * of the previous result as a hint and only scan a window around it; the window grows until the
+ * distance starts increasing on both sides, and the whole trajectory is scanned if there is no
+ * hint. This matches the linear scan as long as the trajectory does not come back close to
+ * itself outside of the window.
+ */
+class TrajectoryIndex
+{
+public:
+  TrajectoryIndex() = default;
+
+  template <typename PointT>
+  explicit TrajectoryIndex(const std::vector<PointT> & points)
+  {
+    assign(points);
+  }
+
+  // Capacity preserving, so steady-state updates do not allocate
+  template <typename PointT>
+  void assign(const std::vector<PointT> & points)
+  {
+    const size_t n = points.size();
+    x_.resize(n);
+    y_.resize(n);
+    s_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      x_[i] = points[i].pose.position.x;
+      y_[i] = points[i].pose.position.y;
+      s_[i] = i == 0 ? 0.0 : s_[i - 1] + std::hypot(x_[i] - x_[i - 1], y_[i] - y_[i - 1]);
+    }
+  }
+
+  size_t size() const { return s_.size(); }
+  bool empty() const { return s_.empty(); }
+
+  // Arc length from the first point to point i
+  double getArcLength(const size_t i) const { return s_[i]; }
+  double getLength() const { return s_.empty() ? 0.0 : s_.back(); }
+
+  // Arc length from point i to point j, negative if j is before i
+  double calcSignedArcLength(const size_t i, const size_t j) const { return s_[j] - s_[i]; }
+
+  // Arc length from the projection of p onto the trajectory to point j
+  double calcSignedArcLength(
+    const Point & p, const size_t j, const std::optional<size_t> hint = std::nullopt) const
+  {
+    if (s_.size() < 2) {
+      return 0.0;
+    }
+    const size_t seg = findNearestSegmentIndex(p, hint);
+    return s_[j] - (s_[seg] + calcLongitudinalOffset(seg, p.x, p.y));
+  }
+
+  // Arc length between the projections of p1 and p2
+  double calcSignedArcLength(
+    const Point & p1, const Point & p2, const std::optional<size_t> hint = std::nullopt) const
+  {
+    if (s_.size() < 2) {
+      return 0.0;
+    }
+    const size_t seg1 = findNearestSegmentIndex(p1, hint);
+    const size_t seg2 = findNearestSegmentIndex(p2, seg1);
+    return (s_[seg2] + calcLongitudinalOffset(seg2, p2.x, p2.y)) -
+           (s_[seg1] + calcLongitudinalOffset(seg1, p1.x, p1.y));
+  }
+
+  // Index of the point closest to p
+  size_t findNearestIndex(const Point & p, const std::optional<size_t> hint = std::nullopt) const
+  {
+    if (s_.empty()) {
+      return 0;
+    }
+    auto dist = [&](const size_t i) {
+      return (x_[i] - p.x) * (x_[i] - p.x) + (y_[i] - p.y) * (y_[i] - p.y);
+    };
+    return searchAround(s_.size(), hint, dist);
+  }
+
+  // Index i of the segment [i, i + 1] closest to p
+  size_t findNearestSegmentIndex(
+    const Point & p, const std::optional<size_t> hint = std::nullopt) const
+  {
+    if (s_.size() < 2) {
+      return 0;
+    }
+    auto dist = [&](const size_t i) { return calcSquaredDistanceToSegment(i, p.x, p.y); };
+    return searchAround(s_.size() - 1, hint, dist);
+  }
+
+  // Signed offset of the projection of (px, py) from the start of segment seg along the segment
+  double calcLongitudinalOffset(const size_t seg, const double px, const double py) const
+  {
+    const double seg_x = x_[seg + 1] - x_[seg];
+    const double seg_y = y_[seg + 1] - y_[seg];
+    const double seg_len = std::hypot(seg_x, seg_y);
+    return seg_len > 1e-9 ? ((px - x_[seg]) * seg_x + (py - y_[seg]) * seg_y) / seg_len : 0.0;
+  }
+
+private:
+  // Minimum of dist over [0, num); starting at the hint, extends the window while it improves
+  template <typename Dist>
+  static size_t searchAround(const size_t num, const std::optional<size_t> hint, Dist dist)
+  {
+    if (!hint) {
+      size_t best = 0;
+      double best_dist = std::numeric_limits<double>::max();
+      for (size_t i = 0; i < num; ++i) {
+        const double d = dist(i);
+        if (d < best_dist) {
+          best_dist = d;
+          best = i;
+        }
+      }
+      return best;
+    }
+
+    size_t best = std::min(*hint, num - 1);
+    double best_dist = dist(best);
+    // Walk forward and backward until the distance increases for a few steps
+    constexpr size_t patience = 3;
+    for (const int dir : {1, -1}) {
+      size_t misses = 0;
+      size_t i = best;
+      while (misses < patience) {
+        if (dir > 0 ? i + 1 >= num : i == 0) {
+          break;
+        }
+        i = dir > 0 ? i + 1 : i - 1;
+        const double d = dist(i);
+        if (d < best_dist) {
+          best_dist = d;
+          best = i;
+          misses = 0;
+        } else {
+          ++misses;
+        }
+      }
+    }
+    return best;
+  }
+
+  double calcSquaredDistanceToSegment(const size_t seg, const double px, const double py) const
+  {
+    const double seg_x = x_[seg + 1] - x_[seg];
+    const double seg_y = y_[seg + 1] - y_[seg];
+    const double seg_len_sq = seg_x * seg_x + seg_y * seg_y;
+    const double ratio =
+      seg_len_sq > 1e-12
+        ? std::clamp(((px - x_[seg]) * seg_x + (py - y_[seg]) * seg_y) / seg_len_sq, 0.0, 1.0)
+        : 0.0;
+    const double dx = x_[seg] + ratio * seg_x - px;
+    const double dy = y_[seg] + ratio * seg_y - py;
+    return dx * dx + dy * dy;
+  }
+
+  std::vector<double> x_;
+  std::vector<double> y_;
+  std::vector<double> s_;
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__TRAJECTORY_INDEX_HPP_
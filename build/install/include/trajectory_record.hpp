@@ -0,0 +1,257 @@
+// Binary trajectory recording for offline analysis
+#ifndef PATH_OPTIMIZER__TRAJECTORY_RECORD_HPP_
+#define PATH_OPTIMIZER__TRAJECTORY_RECORD_HPP_
+
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * Trajectory record file (.trjb): one record per published trajectory, columns per record
+ *
+ * Layout (little endian):
+ *   header : magic "TRAJREC1" (8 bytes)
+ *   record : size (uint32, bytes after this field), stamp_ns (int64), num_points (uint32),
+ *            x, y, z (float64 * num_points each),
+ *            yaw, longitudinal_velocity_mps, acceleration_mps2, time_from_start
+ *            (float32 * num_points each)
+ *
+ * The columns load directly into arrays (numpy.frombuffer in tool/trajectory_record.py) and a
+ * point takes 40 bytes instead of several hundred bytes of JSON.
+ */
+constexpr char trajectory_record_magic[8] = {'T', 'R', 'A', 'J', 'R', 'E', 'C', '1'};
+constexpr uint32_t trajectory_record_point_size = 3 * sizeof(double) + 4 * sizeof(float);
+constexpr uint32_t trajectory_record_header_size = sizeof(int64_t) + sizeof(uint32_t);
+
+/**
+ * TrajectoryRecordWriter: appends trajectory records to a file without blocking the caller on I/O
+ *
+ * write() serializes into an in-memory chunk. Full chunks are handed to a background thread that
+ * writes them to the file, and the written buffers are reused, so steady-state recording neither
+ * allocates nor waits for the disk. write() must be called from one thread at a time.
+ */
+class TrajectoryRecordWriter
+{
+public:
+  explicit TrajectoryRecordWriter(const std::string & path, const size_t chunk_size = 1U << 20U)
+  : file_(path, std::ios::binary | std::ios::trunc), chunk_size_(chunk_size)
+  {
+    if (!file_) {
+      throw std::runtime_error("trajectory record: cannot open " + path);
+    }
+    file_.write(trajectory_record_magic, sizeof(trajectory_record_magic));
+    active_.reserve(chunk_size_);
+    writer_ = std::thread([this] { writerLoop(); });
+  }
+
+  TrajectoryRecordWriter(const TrajectoryRecordWriter &) = delete;
+  TrajectoryRecordWriter & operator=(const TrajectoryRecordWriter &) = delete;
+
+  ~TrajectoryRecordWriter()
+  {
+    flush();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_one();
+    writer_.join();
+  }
+
+  // PointT has the fields of TrajectoryPoint that are recorded (pose, longitudinal_velocity_mps,
+  // acceleration_mps2, time_from_start), so this header does not depend on the planner types
+  template <typename PointT>
+  void write(const int64_t stamp_ns, const std::vector<PointT> & points)
+  {
+    const auto n = static_cast<uint32_t>(points.size());
+    const uint32_t size = trajectory_record_header_size + n * trajectory_record_point_size;
+    append(size);
+    append(stamp_ns);
+    append(n);
+    for (const auto & p : points) {
+      append(p.pose.position.x);
+    }
+    for (const auto & p : points) {
+      append(p.pose.position.y);
+    }
+    for (const auto & p : points) {
+      append(p.pose.position.z);
+    }
+    for (const auto & p : points) {
+      const auto & q = p.pose.orientation;
+      append(static_cast<float>(
+        std::atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z))));
+    }
+    for (const auto & p : points) {
+      append(static_cast<float>(p.longitudinal_velocity_mps));
+    }
+    for (const auto & p : points) {
+      append(static_cast<float>(p.acceleration_mps2));
+    }
+    for (const auto & p : points) {
+      append(static_cast<float>(p.time_from_start.sec + p.time_from_start.nanosec * 1e-9));
+    }
+    if (active_.size() >= chunk_size_) {
+      handOver();
+    }
+  }
+
+  // Hands the current chunk to the writer thread and waits until everything is on disk
+  void flush()
+  {
+    handOver();
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return pending_.empty() && !writing_; });
+    file_.flush();
+  }
+
+private:
+  template <typename T>
+  void append(const T value)
+  {
+    const size_t offset = active_.size();
+    active_.resize(offset + sizeof(T));
+    std::memcpy(active_.data() + offset, &value, sizeof(T));
+  }
+
+  void handOver()
+  {
+    if (active_.empty()) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_.push_back(std::move(active_));
+      if (free_.empty()) {
+        active_ = std::vector<char>();
+      } else {
+        active_ = std::move(free_.back());
+        free_.pop_back();
+      }
+    }
+    active_.clear();
+    active_.reserve(chunk_size_);
+    cv_.notify_one();
+  }
+
+  void writerLoop()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      cv_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+      if (pending_.empty()) {
+        return;  // stop_ and everything written
+      }
+      std::vector<char> chunk = std::move(pending_.front());
+      pending_.pop_front();
+      writing_ = true;
+      lock.unlock();
+      file_.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+      lock.lock();
+      writing_ = false;
+      free_.push_back(std::move(chunk));
+      done_cv_.notify_all();
+    }
+  }
+
+  std::ofstream file_;
+  size_t chunk_size_;
+  std::vector<char> active_;  // only used by the caller of write()
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::condition_variable done_cv_;
+  std::deque<std::vector<char>> pending_;
+  std::vector<std::vector<char>> free_;
+  bool writing_{false};
+  bool stop_{false};
+  std::thread writer_;
+};
+
+/**
+ * TrajectoryRecordReader: reads the records of a .trjb file one by one
+ */
+class TrajectoryRecordReader
+{
+public:
+  struct Record
+  {
+    int64_t stamp_ns{0};
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+    std::vector<float> yaw;
+    std::vector<float> longitudinal_velocity_mps;
+    std::vector<float> acceleration_mps2;
+    std::vector<float> time_from_start;
+  };
+
+  explicit TrajectoryRecordReader(const std::string & path) : file_(path, std::ios::binary)
+  {
+    char magic[sizeof(trajectory_record_magic)];
+    if (
+      !file_.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, trajectory_record_magic, sizeof(magic)) != 0) {
+      throw std::runtime_error("trajectory record: " + path + " is not a trajectory record file");
+    }
+  }
+
+  // Reads the next record (array capacities are reused), false at the end of the file
+  bool next(Record & record)
+  {
+    uint32_t size = 0;
+    if (!file_.read(reinterpret_cast<char *>(&size), sizeof(size))) {
+      return false;
+    }
+    uint32_t n = 0;
+    read(&record.stamp_ns, 1);
+    read(&n, 1);
+    if (size != trajectory_record_header_size + n * trajectory_record_point_size) {
+      throw std::runtime_error("trajectory record: corrupt record size");
+    }
+    readColumn(record.x, n);
+    readColumn(record.y, n);
+    readColumn(record.z, n);
+    readColumn(record.yaw, n);
+    readColumn(record.longitudinal_velocity_mps, n);
+    readColumn(record.acceleration_mps2, n);
+    readColumn(record.time_from_start, n);
+    return true;
+  }
+
+private:
+  template <typename T>
+  void read(T * data, const size_t count)
+  {
+    const auto bytes = static_cast<std::streamsize>(count * sizeof(T));
+    if (!file_.read(reinterpret_cast<char *>(data), bytes)) {
+      throw std::runtime_error("trajectory record: truncated record");
+    }
+  }
+
+  template <typename T>
+  void readColumn(std::vector<T> & column, const uint32_t n)
+  {
+    column.resize(n);
+    if (n > 0) {
+      read(column.data(), n);
+    }
+  }
+
+  std::ifstream file_;
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__TRAJECTORY_RECORD_HPP_
@@ -0,0 +1,379 @@
+// Batched trajectory resampler for Path Optimizer
+#ifndef PATH_OPTIMIZER__TRAJECTORY_RESAMPLER_HPP_
+#define PATH_OPTIMIZER__TRAJECTORY_RESAMPLER_HPP_
+
+#include "path_optimizer_types.hpp"
+#include "trajectory_soa.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * TrajectoryResampler: resamples trajectory points by arc length in a few flat passes
+ *
+ * The cumulative arc length of the input is computed once. The sorted output arc lengths are then
+ * matched to input segments with one forward cursor, and every interpolated field is computed in
+ * its own loop over contiguous arrays, so the loops are free of searches and branches on the
+ * point level and can be vectorized by the compiler. All buffers, including the output, keep their
+ * capacity across calls, so resampling paths of similar size does not allocate.
+ *
+ * If all orientations are rotations around z only (planar path), the yaw angle is interpolated
+ * instead of doing a quaternion slerp per point.
+ */
+class TrajectoryResampler
+{
+public:
+  // Velocities are held from the preceding input point, as motion_utils resampleTrajectory does
+  // by default. Set to false to interpolate them linearly instead.
+  bool use_zero_order_hold_for_velocity{true};
+
+  /**
+   * @brief Resample with a fixed interval, the last input point is always kept
+   * @param output overwritten with the resampled points
+   */
+  void resample(
+    const std::vector<TrajectoryPoint> & input, const double interval,
+    std::vector<TrajectoryPoint> & output)
+  {
+    output.clear();
+    if (input.size() < 2 || !(interval > 0.0)) {
+      output.assign(input.begin(), input.end());
+      return;
+    }
+    calcArcLength(input);
+    const double length = s_in_.back();
+    query_s_.clear();
+    for (double s = 0.0; s < length - 1e-3 * interval; s += interval) {
+      query_s_.push_back(s);
+    }
+    query_s_.push_back(length);
+    interpolate(input, output);
+  }
+
+  /**
+   * @brief Resample at the given arc lengths
+   * @param sorted_s increasing arc lengths from the first input point, clamped to the input range
+   */
+  void resample(
+    const std::vector<TrajectoryPoint> & input, const std::vector<double> & sorted_s,
+    std::vector<TrajectoryPoint> & output)
+  {
+    output.clear();
+    if (input.size() < 2) {
+      output.assign(input.begin(), input.end());
+      return;
+    }
+    calcArcLength(input);
+    query_s_.assign(sorted_s.begin(), sorted_s.end());
+    interpolate(input, output);
+  }
+
+  // Same as above on the structure of arrays layout, every field is one pass over its arrays
+  void resample(const TrajectorySoA & input, const double interval, TrajectorySoA & output)
+  {
+    if (input.size() < 2 || !(interval > 0.0)) {
+      output = input;
+      return;
+    }
+    input.calcArcLength(s_in_);
+    const double length = s_in_.back();
+    query_s_.clear();
+    for (double s = 0.0; s < length - 1e-3 * interval; s += interval) {
+      query_s_.push_back(s);
+    }
+    query_s_.push_back(length);
+    interpolate(input, output);
+  }
+
+  void resample(
+    const TrajectorySoA & input, const std::vector<double> & sorted_s, TrajectorySoA & output)
+  {
+    if (input.size() < 2) {
+      output = input;
+      return;
+    }
+    input.calcArcLength(s_in_);
+    query_s_.assign(sorted_s.begin(), sorted_s.end());
+    interpolate(input, output);
+  }
+
+  // Cumulative arc length of the last input
+  const std::vector<double> & getInputArcLength() const { return s_in_; }
+
+private:
+  void calcArcLength(const std::vector<TrajectoryPoint> & input)
+  {
+    const size_t n = input.size();
+    s_in_.resize(n);
+    s_in_[0] = 0.0;
+    for (size_t i = 1; i < n; ++i) {
+      const auto & p0 = input[i - 1].pose.position;
+      const auto & p1 = input[i].pose.position;
+      s_in_[i] = s_in_[i - 1] + std::hypot(p1.x - p0.x, p1.y - p0.y);
+    }
+  }
+
+  // One forward pass: input segment and ratio of every query
+  void locateQueries()
+  {
+    const size_t m = query_s_.size();
+    const size_t num_segs = s_in_.size() - 1;
+    seg_.resize(m);
+    ratio_.resize(m);
+    size_t seg = 0;
+    for (size_t j = 0; j < m; ++j) {
+      const double s = std::clamp(query_s_[j], s_in_.front(), s_in_.back());
+      while (seg + 1 < num_segs && s_in_[seg + 1] < s) {
+        ++seg;
+      }
+      const double ds = s_in_[seg + 1] - s_in_[seg];
+      seg_[j] = seg;
+      ratio_[j] = ds > 1e-9 ? std::clamp((s - s_in_[seg]) / ds, 0.0, 1.0) : 0.0;
+    }
+  }
+
+  template <typename Getter>
+  void gather(const std::vector<TrajectoryPoint> & input, Getter get)
+  {
+    const size_t m = seg_.size();
+    v0_.resize(m);
+    v1_.resize(m);
+    for (size_t j = 0; j < m; ++j) {
+      v0_[j] = get(input[seg_[j]]);
+      v1_[j] = get(input[seg_[j] + 1]);
+    }
+  }
+
+  // out = v0 + ratio * (v1 - v0), or v0 for zero order hold (exact at the end of a segment)
+  void lerp(std::vector<double> & out, const bool zero_order_hold = false) const
+  {
+    const size_t m = seg_.size();
+    out.resize(m);
+    const double * v0 = v0_.data();
+    const double * v1 = v1_.data();
+    const double * r = ratio_.data();
+    double * o = out.data();
+    if (zero_order_hold) {
+      for (size_t j = 0; j < m; ++j) {
+        o[j] = r[j] >= 1.0 ? v1[j] : v0[j];
+      }
+      return;
+    }
+    for (size_t j = 0; j < m; ++j) {
+      o[j] = v0[j] + r[j] * (v1[j] - v0[j]);
+    }
+  }
+
+  template <typename Getter>
+  void interpolateField(
+    const std::vector<TrajectoryPoint> & input, Getter get, std::vector<double> & out,
+    const bool zero_order_hold = false)
+  {
+    gather(input, get);
+    lerp(out, zero_order_hold);
+  }
+
+  static bool isPlanar(const std::vector<TrajectoryPoint> & input)
+  {
+    return std::all_of(input.begin(), input.end(), [](const TrajectoryPoint & p) {
+      const auto & q = p.pose.orientation;
+      return std::abs(q.x) < 1e-6 && std::abs(q.y) < 1e-6;
+    });
+  }
+
+  static double normalizeAngle(const double angle)
+  {
+    return std::atan2(std::sin(angle), std::cos(angle));
+  }
+
+  void interpolateYaw(const std::vector<TrajectoryPoint> & input, std::vector<TrajectoryPoint> & output)
+  {
+    const size_t m = seg_.size();
+    gather(input, [](const TrajectoryPoint & p) {
+      return 2.0 * std::atan2(p.pose.orientation.z, p.pose.orientation.w);
+    });
+    for (size_t j = 0; j < m; ++j) {
+      v1_[j] = v0_[j] + normalizeAngle(v1_[j] - v0_[j]);
+    }
+    lerp(tmp_);
+    for (size_t j = 0; j < m; ++j) {
+      auto & q = output[j].pose.orientation;
+      q.x = 0.0;
+      q.y = 0.0;
+      q.z = std::sin(0.5 * tmp_[j]);
+      q.w = std::cos(0.5 * tmp_[j]);
+    }
+  }
+
+  void slerp(const std::vector<TrajectoryPoint> & input, std::vector<TrajectoryPoint> & output) const
+  {
+    for (size_t j = 0; j < seg_.size(); ++j) {
+      output[j].pose.orientation =
+        slerp(input[seg_[j]].pose.orientation, input[seg_[j] + 1].pose.orientation, ratio_[j]);
+    }
+  }
+
+  static Quaternion slerp(const Quaternion & q0, Quaternion q1, const double t)
+  {
+    double dot = q0.x * q1.x + q0.y * q1.y + q0.z * q1.z + q0.w * q1.w;
+    if (dot < 0.0) {
+      q1.x = -q1.x;
+      q1.y = -q1.y;
+      q1.z = -q1.z;
+      q1.w = -q1.w;
+      dot = -dot;
+    }
+    double w0 = 1.0 - t;
+    double w1 = t;
+    if (dot < 0.9995) {
+      const double theta = std::acos(std::min(dot, 1.0));
+      const double sin_theta = std::sin(theta);
+      w0 = std::sin((1.0 - t) * theta) / sin_theta;
+      w1 = std::sin(t * theta) / sin_theta;
+    }
+    Quaternion q;
+    q.x = w0 * q0.x + w1 * q1.x;
+    q.y = w0 * q0.y + w1 * q1.y;
+    q.z = w0 * q0.z + w1 * q1.z;
+    q.w = w0 * q0.w + w1 * q1.w;
+    const double norm = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    q.x /= norm;
+    q.y /= norm;
+    q.z /= norm;
+    q.w /= norm;
+    return q;
+  }
+
+  void interpolate(const std::vector<TrajectoryPoint> & input, std::vector<TrajectoryPoint> & output)
+  {
+    locateQueries();
+    const size_t m = seg_.size();
+
+    // Fields that are not interpolated are taken from the preceding input point
+    output.resize(m);
+    for (size_t j = 0; j < m; ++j) {
+      output[j] = input[ratio_[j] >= 1.0 ? seg_[j] + 1 : seg_[j]];
+    }
+
+    interpolateField(input, [](const TrajectoryPoint & p) { return p.pose.position.x; }, tmp_);
+    for (size_t j = 0; j < m; ++j) {
+      output[j].pose.position.x = tmp_[j];
+    }
+    interpolateField(input, [](const TrajectoryPoint & p) { return p.pose.position.y; }, tmp_);
+    for (size_t j = 0; j < m; ++j) {
+      output[j].pose.position.y = tmp_[j];
+    }
+    interpolateField(input, [](const TrajectoryPoint & p) { return p.pose.position.z; }, tmp_);
+    for (size_t j = 0; j < m; ++j) {
+      output[j].pose.position.z = tmp_[j];
+    }
+
+    if (isPlanar(input)) {
+      interpolateYaw(input, output);
+    } else {
+      slerp(input, output);
+    }
+
+    const bool hold = use_zero_order_hold_for_velocity;
+    interpolateField(
+      input, [](const TrajectoryPoint & p) { return p.longitudinal_velocity_mps; }, tmp_, hold);
+    for (size_t j = 0; j < m; ++j) {
+      output[j].longitudinal_velocity_mps = tmp_[j];
+    }
+    interpolateField(
+      input, [](const TrajectoryPoint & p) { return p.lateral_velocity_mps; }, tmp_, hold);
+    for (size_t j = 0; j < m; ++j) {
+      output[j].lateral_velocity_mps = tmp_[j];
+    }
+    interpolateField(
+      input, [](const TrajectoryPoint & p) { return p.heading_rate_rps; }, tmp_, hold);
+    for (size_t j = 0; j < m; ++j) {
+      output[j].heading_rate_rps = tmp_[j];
+    }
+    interpolateField(input, [](const TrajectoryPoint & p) { return p.acceleration_mps2; }, tmp_);
+    for (size_t j = 0; j < m; ++j) {
+      output[j].acceleration_mps2 = tmp_[j];
+    }
+  }
+
+  // out[j] = in[seg_j] + ratio_j * (in[seg_j + 1] - in[seg_j]), or the preceding value for hold
+  template <typename In, typename Out>
+  void lerpField(const In & in, Out & out, const bool zero_order_hold = false) const
+  {
+    const size_t m = seg_.size();
+    out.resize(m);
+    const auto * v = in.data();
+    const size_t * seg = seg_.data();
+    const double * r = ratio_.data();
+    auto * o = out.data();
+    if (zero_order_hold) {
+      for (size_t j = 0; j < m; ++j) {
+        o[j] = v[r[j] >= 1.0 ? seg[j] + 1 : seg[j]];
+      }
+      return;
+    }
+    for (size_t j = 0; j < m; ++j) {
+      o[j] = v[seg[j]] + r[j] * (v[seg[j] + 1] - v[seg[j]]);
+    }
+  }
+
+  void interpolate(const TrajectorySoA & input, TrajectorySoA & output)
+  {
+    locateQueries();
+    const size_t m = seg_.size();
+    output.resize(m);
+    lerpField(input.x, output.x);
+    lerpField(input.y, output.y);
+    lerpField(input.z, output.z);
+    const bool hold = use_zero_order_hold_for_velocity;
+    lerpField(input.longitudinal_velocity_mps, output.longitudinal_velocity_mps, hold);
+    lerpField(input.lateral_velocity_mps, output.lateral_velocity_mps, hold);
+    lerpField(input.heading_rate_rps, output.heading_rate_rps, hold);
+    lerpField(input.acceleration_mps2, output.acceleration_mps2);
+    // Not interpolated, taken from the preceding input point as in the AoS version
+    lerpField(input.front_wheel_angle_rad, output.front_wheel_angle_rad, true);
+    lerpField(input.rear_wheel_angle_rad, output.rear_wheel_angle_rad, true);
+    lerpField(input.time_from_start_ns, output.time_from_start_ns, true);
+
+    if (input.isPlanar()) {
+      v0_.resize(m);
+      v1_.resize(m);
+      for (size_t j = 0; j < m; ++j) {
+        v0_[j] = input.getYaw(seg_[j]);
+        v1_[j] = v0_[j] + normalizeAngle(input.getYaw(seg_[j] + 1) - v0_[j]);
+      }
+      lerp(tmp_);
+      for (size_t j = 0; j < m; ++j) {
+        output.qx[j] = 0.0;
+        output.qy[j] = 0.0;
+        output.qz[j] = std::sin(0.5 * tmp_[j]);
+        output.qw[j] = std::cos(0.5 * tmp_[j]);
+      }
+      return;
+    }
+    for (size_t j = 0; j < m; ++j) {
+      const auto q =
+        slerp(input.getOrientation(seg_[j]), input.getOrientation(seg_[j] + 1), ratio_[j]);
+      output.qx[j] = q.x;
+      output.qy[j] = q.y;
+      output.qz[j] = q.z;
+      output.qw[j] = q.w;
+    }
+  }
+
+  std::vector<double> s_in_;     // Cumulative arc length of the input
+  std::vector<double> query_s_;  // Output arc lengths
+  std::vector<size_t> seg_;      // Input segment of each output point
+  std::vector<double> ratio_;    // Position of each output point on its segment
+  std::vector<double> v0_;       // Field values at the segment start
+  std::vector<double> v1_;       // Field values at the segment end
+  std::vector<double> tmp_;      // Interpolated values
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__TRAJECTORY_RESAMPLER_HPP_
@@ -0,0 +1,215 @@
+// Structure of arrays trajectory and its kernels for Path Optimizer
+#ifndef PATH_OPTIMIZER__TRAJECTORY_SOA_HPP_
+#define PATH_OPTIMIZER__TRAJECTORY_SOA_HPP_
+
+#include "path_geometry.hpp"
+#include "path_optimizer_types.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+// Allocator for cache line aligned arrays, so that vectorized loops start on a full vector
+template <typename T, size_t Alignment = 64>
+struct AlignedAllocator
+{
+  using value_type = T;
+  template <typename U>
+  struct rebind
+  {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() noexcept = default;
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment> &) noexcept  // NOLINT
+  {
+  }
+
+  T * allocate(const size_t n)
+  {
+    // std::aligned_alloc needs a (non zero) multiple of the alignment
+    const size_t blocks = std::max<size_t>((n * sizeof(T) + Alignment - 1) / Alignment, 1);
+    const size_t bytes = blocks * Alignment;
+    void * p = std::aligned_alloc(Alignment, bytes);
+    if (p == nullptr) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T *>(p);
+  }
+  void deallocate(T * p, const size_t /*n*/) noexcept { std::free(p); }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, Alignment> &) const noexcept
+  {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const AlignedAllocator<U, Alignment> &) const noexcept
+  {
+    return false;
+  }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+/**
+ * TrajectorySoA: trajectory points stored as one aligned array per field
+ *
+ * Most kernels only read x/y (arc length, curvature, nearest search) or one velocity field. With
+ * std::vector<TrajectoryPoint> every such loop pulls whole points (over 100 bytes) through the
+ * cache for 16 bytes of data and cannot be vectorized; here it reads two contiguous arrays.
+ *
+ * assign() and toPoints() convert from and to the message layout without loss (the time is kept
+ * as integer nanoseconds); both keep the capacity of their destination, so a trajectory that is
+ * converted every cycle does not allocate. point()/setPoint() access single points for code that
+ * still works on TrajectoryPoint.
+ */
+class TrajectorySoA
+{
+public:
+  AlignedVector<double> x, y, z;
+  AlignedVector<double> qx, qy, qz, qw;  // orientation quaternion
+  AlignedVector<double> longitudinal_velocity_mps;
+  AlignedVector<double> lateral_velocity_mps;
+  AlignedVector<double> acceleration_mps2;
+  AlignedVector<double> heading_rate_rps;
+  AlignedVector<double> front_wheel_angle_rad;
+  AlignedVector<double> rear_wheel_angle_rad;
+  AlignedVector<int64_t> time_from_start_ns;
+
+  TrajectorySoA() = default;
+  explicit TrajectorySoA(const std::vector<TrajectoryPoint> & points) { assign(points); }
+
+  size_t size() const { return x.size(); }
+  bool empty() const { return x.empty(); }
+
+  void resize(const size_t n)
+  {
+    forEachField([n](auto & field) { field.resize(n); });
+  }
+  void clear() { resize(0); }
+
+  void assign(const std::vector<TrajectoryPoint> & points)
+  {
+    resize(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+      setPoint(i, points[i]);
+    }
+  }
+
+  void toPoints(std::vector<TrajectoryPoint> & points) const
+  {
+    points.resize(size());
+    for (size_t i = 0; i < size(); ++i) {
+      points[i] = point(i);
+    }
+  }
+  std::vector<TrajectoryPoint> toPoints() const
+  {
+    std::vector<TrajectoryPoint> points;
+    toPoints(points);
+    return points;
+  }
+
+  TrajectoryPoint point(const size_t i) const
+  {
+    TrajectoryPoint p;
+    p.pose.position.x = x[i];
+    p.pose.position.y = y[i];
+    p.pose.position.z = z[i];
+    p.pose.orientation = getOrientation(i);
+    p.longitudinal_velocity_mps = longitudinal_velocity_mps[i];
+    p.lateral_velocity_mps = lateral_velocity_mps[i];
+    p.acceleration_mps2 = acceleration_mps2[i];
+    p.heading_rate_rps = heading_rate_rps[i];
+    p.front_wheel_angle_rad = front_wheel_angle_rad[i];
+    p.rear_wheel_angle_rad = rear_wheel_angle_rad[i];
+    const int64_t ns = time_from_start_ns[i];
+    const int64_t sec = ns >= 0 ? ns / 1000000000 : (ns - 999999999) / 1000000000;
+    p.time_from_start.sec = static_cast<decltype(p.time_from_start.sec)>(sec);
+    p.time_from_start.nanosec =
+      static_cast<decltype(p.time_from_start.nanosec)>(ns - sec * 1000000000);
+    return p;
+  }
+
+  void setPoint(const size_t i, const TrajectoryPoint & p)
+  {
+    x[i] = p.pose.position.x;
+    y[i] = p.pose.position.y;
+    z[i] = p.pose.position.z;
+    qx[i] = p.pose.orientation.x;
+    qy[i] = p.pose.orientation.y;
+    qz[i] = p.pose.orientation.z;
+    qw[i] = p.pose.orientation.w;
+    longitudinal_velocity_mps[i] = p.longitudinal_velocity_mps;
+    lateral_velocity_mps[i] = p.lateral_velocity_mps;
+    acceleration_mps2[i] = p.acceleration_mps2;
+    heading_rate_rps[i] = p.heading_rate_rps;
+    front_wheel_angle_rad[i] = p.front_wheel_angle_rad;
+    rear_wheel_angle_rad[i] = p.rear_wheel_angle_rad;
+    time_from_start_ns[i] =
+      static_cast<int64_t>(p.time_from_start.sec) * 1000000000 + p.time_from_start.nanosec;
+  }
+
+  Quaternion getOrientation(const size_t i) const
+  {
+    Quaternion q;
+    q.x = qx[i];
+    q.y = qy[i];
+    q.z = qz[i];
+    q.w = qw[i];
+    return q;
+  }
+
+  // Yaw angle of point i, assuming a rotation around z
+  double getYaw(const size_t i) const { return 2.0 * std::atan2(qz[i], qw[i]); }
+
+  // Whether all orientations are rotations around z only
+  bool isPlanar() const
+  {
+    for (size_t i = 0; i < size(); ++i) {
+      if (std::abs(qx[i]) >= 1e-6 || std::abs(qy[i]) >= 1e-6) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Cumulative 2d arc length from the first point (path_geometry::calcArcLength)
+  template <typename Vector>
+  void calcArcLength(Vector & s) const
+  {
+    s.resize(size());
+    path_geometry::calcArcLength(x.data(), y.data(), size(), s.data());
+  }
+
+  // Three point curvature as motion_utils calcCurvature (path_geometry::calcCurvature)
+  template <typename Vector>
+  void calcCurvature(Vector & curvature) const
+  {
+    curvature.resize(size());
+    path_geometry::calcCurvature(x.data(), y.data(), size(), curvature.data());
+  }
+
+  template <typename Func>
+  void forEachField(Func && f)
+  {
+    f(x), f(y), f(z), f(qx), f(qy), f(qz), f(qw);
+    f(longitudinal_velocity_mps), f(lateral_velocity_mps), f(acceleration_mps2);
+    f(heading_rate_rps), f(front_wheel_angle_rad), f(rear_wheel_angle_rad);
+    f(time_from_start_ns);
+  }
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__TRAJECTORY_SOA_HPP_
@@ -0,0 +1,50 @@
+// Vehicle footprint approximation by circles for the MPT constraints
+#ifndef PATH_OPTIMIZER__VEHICLE_CIRCLES_HPP_
+#define PATH_OPTIMIZER__VEHICLE_CIRCLES_HPP_
+
+#include "path_optimizer_types.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+struct VehicleCircles
+{
+  std::vector<double> longitudinal_offsets;  // From the rear axle center (reference point)
+  double radius{0.0};
+};
+
+/**
+ * @brief Covers the footprint with num_circles circles of equal radius, evenly spaced from the
+ * rear to the front end
+ *
+ * The vehicle length is split into num_circles equal parts; each circle is centered on one part
+ * and encloses it (radius = half diagonal of the part). radius_ratio < 1 trades coverage of the
+ * corners for less conservative bounds. Computed once from VehicleInfo, the offsets go to
+ * BoundsCalculator::calcBoundsOnCircles and MPTQPBuilder::setVehicleCircles.
+ */
+inline VehicleCircles calcVehicleCircles(
+  const VehicleInfo & vehicle_info, const size_t num_circles, const double radius_ratio = 1.0)
+{
+  VehicleCircles circles;
+  if (num_circles == 0) {
+    return circles;
+  }
+  const double length =
+    vehicle_info.rear_overhang_m + vehicle_info.wheel_base_m + vehicle_info.front_overhang_m;
+  const double part = length / static_cast<double>(num_circles);
+  circles.longitudinal_offsets.reserve(num_circles);
+  for (size_t i = 0; i < num_circles; ++i) {
+    circles.longitudinal_offsets.push_back(
+      -vehicle_info.rear_overhang_m + part * (static_cast<double>(i) + 0.5));
+  }
+  circles.radius = radius_ratio * std::hypot(0.5 * part, 0.5 * vehicle_info.vehicle_width_m);
+  return circles;
+}
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__VEHICLE_CIRCLES_HPP_
@@ -5,20 +5,40 @@
 #include <Eigen/Dense>
 #include <algorithm>
 #include <cmath>
+#include <vector>
 
 namespace autoware::path_optimizer
 {
 
+/**
+ * Compile-time description of a vehicle model used by StateEquationGeneratorT.
+ * A model provides DimX/DimU and a fixed-size calculateStateEquationMatrix overload taking
+ * the types below; specialize this trait if a model cannot expose DimX/DimU itself.
+ */
+template <typename Model>
+struct VehicleModelTraits
+{
+  static constexpr int DimX = Model::DimX;
+  static constexpr int DimU = Model::DimU;
+
+  using StateMatrix = Eigen::Matrix<double, DimX, DimX>;  // Ad
+  using InputMatrix = Eigen::Matrix<double, DimX, DimU>;  // Bd
+  using StateVector = Eigen::Matrix<double, DimX, 1>;     // Wd
+};
+
 class VehicleModel
 {
 public:
+  static constexpr int DimX = 2;  // [lateral_error, yaw_error]
+  static constexpr int DimU = 1;  // [steering_angle]
+
   VehicleModel(const double wheelbase, const double steer_limit)
   : wheelbase_(wheelbase), steer_limit_(steer_limit)
   {
   }
 
-  int getDimX() const { return 2; }  // [lateral_error, yaw_error]
-  int getDimU() const { return 1; }  // [steering_angle]
+  int getDimX() const { return DimX; }
+  int getDimU() const { return DimU; }
 
   // Calculate discrete state equation: x_{t+1} = Ad * x_t + Bd * u_t + Wd
   void calculateStateEquationMatrix(
@@ -28,8 +48,11 @@ public:
     const double curvature,
     const double ds) const
   {
-    const double delta_r = std::atan(wheelbase_ * curvature);
-    const double cropped_delta_r = std::clamp(delta_r, -steer_limit_, steer_limit_);
+    double bd_factor;
+    double wd_factor;
+    if (!lookupCurvatureFactors(curvature, bd_factor, wd_factor)) {
+      calcCurvatureFactors(curvature, bd_factor, wd_factor);
+    }
 
     // State: [lateral_error, yaw_error]
     // Input: [steering_angle]
@@ -41,25 +64,100 @@ public:
 
     // Bd matrix (2x1)
     Bd.resize(2, 1);
-    const double cos_delta = std::cos(delta_r);
     Bd << 0.0,
-          ds / wheelbase_ / (cos_delta * cos_delta);
+          ds * bd_factor;
 
     // Wd vector (2x1)
     Wd.resize(2, 1);
-    const double tan_cropped = std::tan(cropped_delta_r);
-    const double cos_cropped = std::cos(cropped_delta_r);
     Wd << 0.0,
-          -ds * curvature + ds / wheelbase_ * 
-          (tan_cropped - cropped_delta_r / (cos_cropped * cos_cropped));
+          ds * wd_factor;
   }
 
+  // Fixed-size variant: no heap allocation, and no trigonometry if the curvature table is built
+  void calculateStateEquationMatrix(
+    Eigen::Matrix<double, DimX, DimX> & Ad,
+    Eigen::Matrix<double, DimX, DimU> & Bd,
+    Eigen::Matrix<double, DimX, 1> & Wd,
+    const double curvature,
+    const double ds) const
+  {
+    // Bd and Wd are linear in ds, so only the curvature dependent factors need the trig functions
+    double bd_factor;
+    double wd_factor;
+    if (!lookupCurvatureFactors(curvature, bd_factor, wd_factor)) {
+      calcCurvatureFactors(curvature, bd_factor, wd_factor);
+    }
+
+    Ad << 1.0, ds,
+          0.0, 1.0;
+    Bd << 0.0, ds * bd_factor;
+    Wd << 0.0, ds * wd_factor;
+  }
+
+  // Precompute the curvature factors on a uniform grid over [-max_curvature, max_curvature].
+  // Curvatures outside the grid fall back to the exact computation.
+  void buildCurvatureTable(const double max_curvature, const size_t num_samples)
+  {
+    curvature_table_bd_.clear();
+    curvature_table_wd_.clear();
+    if (max_curvature <= 0.0 || num_samples < 2) {
+      return;
+    }
+
+    table_max_curvature_ = max_curvature;
+    table_resolution_ = 2.0 * max_curvature / static_cast<double>(num_samples - 1);
+    curvature_table_bd_.resize(num_samples);
+    curvature_table_wd_.resize(num_samples);
+    for (size_t i = 0; i < num_samples; ++i) {
+      const double curvature = -max_curvature + static_cast<double>(i) * table_resolution_;
+      calcCurvatureFactors(curvature, curvature_table_bd_[i], curvature_table_wd_[i]);
+    }
+  }
+
+  bool hasCurvatureTable() const { return !curvature_table_bd_.empty(); }
+
   double getWheelbase() const { return wheelbase_; }
   double getSteerLimit() const { return steer_limit_; }
 
 private:
+  // Bd = [0, ds * bd_factor]^T, Wd = [0, ds * wd_factor]^T
+  void calcCurvatureFactors(const double curvature, double & bd_factor, double & wd_factor) const
+  {
+    const double delta_r = std::atan(wheelbase_ * curvature);
+    const double cropped_delta_r = std::clamp(delta_r, -steer_limit_, steer_limit_);
+
+    const double cos_delta = std::cos(delta_r);
+    bd_factor = 1.0 / wheelbase_ / (cos_delta * cos_delta);
+
+    const double tan_cropped = std::tan(cropped_delta_r);
+    const double cos_cropped = std::cos(cropped_delta_r);
+    wd_factor = -curvature + 1.0 / wheelbase_ *
+                (tan_cropped - cropped_delta_r / (cos_cropped * cos_cropped));
+  }
+
+  // Linear interpolation in the curvature table
+  bool lookupCurvatureFactors(const double curvature, double & bd_factor, double & wd_factor) const
+  {
+    if (curvature_table_bd_.empty() || std::abs(curvature) > table_max_curvature_) {
+      return false;
+    }
+
+    const double pos = (curvature + table_max_curvature_) / table_resolution_;
+    const size_t idx = std::min(static_cast<size_t>(pos), curvature_table_bd_.size() - 2);
+    const double ratio = pos - static_cast<double>(idx);
+    bd_factor = curvature_table_bd_[idx] + ratio * (curvature_table_bd_[idx + 1] - curvature_table_bd_[idx]);
+    wd_factor = curvature_table_wd_[idx] + ratio * (curvature_table_wd_[idx + 1] - curvature_table_wd_[idx]);
+    return true;
+  }
+
   double wheelbase_;
   double steer_limit_;
+
+  // Curvature lookup table (empty if not built)
+  double table_max_curvature_{0.0};
+  double table_resolution_{0.0};
+  std::vector<double> curvature_table_bd_;
+  std::vector<double> curvature_table_wd_;
 };
 
 }  // namespace autoware::path_optimizer
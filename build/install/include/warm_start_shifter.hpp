@@ -0,0 +1,143 @@
+// Warm Start Shifter for Path Optimizer
+#ifndef PATH_OPTIMIZER__WARM_START_SHIFTER_HPP_
+#define PATH_OPTIMIZER__WARM_START_SHIFTER_HPP_
+
+#include "path_optimizer_types.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * WarmStartShifter: maps the previous QP solution onto the current reference points
+ *
+ * The previous and current reference points are aligned by arc length: the first current point
+ * is projected onto the previous reference polyline, and both point sets are parameterized by
+ * their cumulative delta_arc_length from there. Any vector made of one fixed-size block per
+ * reference point (inputs, per-point constraint duals, ...) can then be resampled onto the
+ * current points by linear interpolation, holding the end values outside the previous range.
+ */
+class WarmStartShifter
+{
+public:
+  // Returns false if the previous points cannot be used for alignment
+  bool align(
+    const std::vector<ReferencePoint> & prev_ref_points,
+    const std::vector<ReferencePoint> & ref_points)
+  {
+    prev_s_.clear();
+    s_.clear();
+    if (prev_ref_points.size() < 2 || ref_points.empty()) {
+      return false;
+    }
+
+    prev_s_.reserve(prev_ref_points.size());
+    prev_s_.push_back(0.0);
+    for (size_t i = 1; i < prev_ref_points.size(); ++i) {
+      prev_s_.push_back(prev_s_.back() + prev_ref_points[i - 1].delta_arc_length);
+    }
+
+    // Arc length of the current start point in the previous frame
+    const auto & start = ref_points.front().pose.position;
+    double min_dist_sq = std::numeric_limits<double>::max();
+    double start_s = 0.0;
+    for (size_t i = 0; i + 1 < prev_ref_points.size(); ++i) {
+      const auto & p0 = prev_ref_points[i].pose.position;
+      const auto & p1 = prev_ref_points[i + 1].pose.position;
+      const double seg_x = p1.x - p0.x;
+      const double seg_y = p1.y - p0.y;
+      const double seg_len_sq = seg_x * seg_x + seg_y * seg_y;
+      double ratio = 0.0;
+      if (seg_len_sq > 1e-12) {
+        ratio = ((start.x - p0.x) * seg_x + (start.y - p0.y) * seg_y) / seg_len_sq;
+        // Allow extrapolation before the first and after the last segment only
+        if (i != 0) {
+          ratio = std::max(ratio, 0.0);
+        }
+        if (i + 2 != prev_ref_points.size()) {
+          ratio = std::min(ratio, 1.0);
+        }
+      }
+      const double dx = p0.x + ratio * seg_x - start.x;
+      const double dy = p0.y + ratio * seg_y - start.y;
+      const double dist_sq = dx * dx + dy * dy;
+      if (dist_sq < min_dist_sq) {
+        min_dist_sq = dist_sq;
+        start_s = prev_s_[i] + ratio * (prev_s_[i + 1] - prev_s_[i]);
+      }
+    }
+
+    s_.reserve(ref_points.size());
+    s_.push_back(start_s);
+    for (size_t i = 1; i < ref_points.size(); ++i) {
+      s_.push_back(s_.back() + ref_points[i - 1].delta_arc_length);
+    }
+    return true;
+  }
+
+  bool isAligned() const { return !s_.empty(); }
+
+  // Arc length shift of the current start point along the previous reference points
+  double getShift() const { return s_.empty() ? 0.0 : s_.front(); }
+
+  /**
+   * @brief Resample a block vector from the previous onto the current reference points
+   * @param prev_values num_prev_blocks * block_size values, block k belongs to previous point k
+   * @param block_size number of values per point
+   * @param num_blocks number of blocks (current points) to generate
+   * @return num_blocks * block_size values, or empty if not aligned or sizes mismatch
+   */
+  std::vector<double> shift(
+    const std::vector<double> & prev_values, const size_t block_size,
+    const size_t num_blocks) const
+  {
+    std::vector<double> values;
+    if (!isAligned() || block_size == 0 || prev_values.size() % block_size != 0) {
+      return values;
+    }
+    const size_t num_prev_blocks = prev_values.size() / block_size;
+    if (num_prev_blocks == 0 || num_prev_blocks > prev_s_.size() || num_blocks > s_.size()) {
+      return values;
+    }
+
+    values.resize(num_blocks * block_size);
+    size_t seg = 0;  // s_ is increasing, so the segment cursor only moves forward
+    for (size_t j = 0; j < num_blocks; ++j) {
+      const double s = s_[j];
+      size_t k0 = 0;
+      size_t k1 = 0;
+      double ratio = 0.0;
+      if (num_prev_blocks == 1 || s <= prev_s_.front()) {
+        k0 = k1 = 0;
+      } else if (s >= prev_s_[num_prev_blocks - 1]) {
+        k0 = k1 = num_prev_blocks - 1;
+      } else {
+        while (seg + 2 < num_prev_blocks && prev_s_[seg + 1] < s) {
+          ++seg;
+        }
+        k0 = seg;
+        k1 = seg + 1;
+        const double ds = prev_s_[k1] - prev_s_[k0];
+        ratio = ds > 1e-9 ? (s - prev_s_[k0]) / ds : 0.0;
+      }
+      for (size_t d = 0; d < block_size; ++d) {
+        const double v0 = prev_values[k0 * block_size + d];
+        const double v1 = prev_values[k1 * block_size + d];
+        values[j * block_size + d] = v0 + ratio * (v1 - v0);
+      }
+    }
+    return values;
+  }
+
+private:
+  std::vector<double> prev_s_;  // Arc length of previous reference points
+  std::vector<double> s_;       // Arc length of current reference points in the previous frame
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__WARM_START_SHIFTER_HPP_
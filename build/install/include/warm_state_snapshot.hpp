@@ -0,0 +1,403 @@
+// Binary snapshots of the warm state of a SWC, checkpointed periodically for fast restart
+#ifndef PATH_OPTIMIZER__WARM_STATE_SNAPSHOT_HPP_
+#define PATH_OPTIMIZER__WARM_STATE_SNAPSHOT_HPP_
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+/**
+ * WarmStateSnapshot: tagged sections of trivially copyable arrays
+ *
+ * File layout (little endian):
+ *   header  : magic "WARMSNP1" (8 bytes), state_hash (uint64), stamp_ns (int64),
+ *             num_sections (uint32)
+ *   section : tag (uint32), size (uint32), payload (size bytes)
+ *   trailer : FNV-1a 64 of all preceding bytes
+ *
+ * A section holds one piece of warm state, e.g. the MPT primal/dual solution and its reference
+ * points, or the lanelet ids of the current route. state_hash identifies everything the state
+ * depends on (map version, parameters); a snapshot written for another hash is not restored.
+ * stamp_ns is system time, so the age of a snapshot can still be checked after a restart.
+ *
+ * Large, slowly changing state (the map, the routing graph) is not copied into the snapshot: it
+ * already has its own binary caches (FlatHandler, RoutingSkeleton), which a restart loads
+ * instead of parsing the OSM file.
+ */
+class WarmStateSnapshot
+{
+public:
+  static constexpr char magic[8] = {'W', 'A', 'R', 'M', 'S', 'N', 'P', '1'};
+
+  // Section tag from four characters, e.g. tag("MPTU")
+  static constexpr uint32_t tag(const char (&name)[5])
+  {
+    return static_cast<uint32_t>(static_cast<uint8_t>(name[0])) |
+           static_cast<uint32_t>(static_cast<uint8_t>(name[1])) << 8U |
+           static_cast<uint32_t>(static_cast<uint8_t>(name[2])) << 16U |
+           static_cast<uint32_t>(static_cast<uint8_t>(name[3])) << 24U;
+  }
+
+  // Keeps the capacity of the sections, so a snapshot that is refilled every period is cheap
+  void clear()
+  {
+    for (auto & section : sections_) {
+      section.bytes.clear();
+      section.used = false;
+    }
+  }
+
+  bool empty() const
+  {
+    for (const auto & section : sections_) {
+      if (section.used) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool has(const uint32_t section_tag) const { return find(section_tag) != nullptr; }
+
+  template <typename T>
+  void putArray(const uint32_t section_tag, const T * data, const size_t size)
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "state must be trivially copyable");
+    auto & bytes = section(section_tag);
+    const auto * begin = reinterpret_cast<const uint8_t *>(data);
+    bytes.assign(begin, begin + size * sizeof(T));
+  }
+  template <typename T>
+  void putArray(const uint32_t section_tag, const std::vector<T> & values)
+  {
+    putArray(section_tag, values.data(), values.size());
+  }
+  template <typename T>
+  void putValue(const uint32_t section_tag, const T & value)
+  {
+    putArray(section_tag, &value, 1);
+  }
+
+  // false (and values unchanged) if the section is missing or does not hold T
+  template <typename T>
+  bool getArray(const uint32_t section_tag, std::vector<T> & values) const
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "state must be trivially copyable");
+    const auto * bytes = find(section_tag);
+    if (bytes == nullptr || bytes->size() % sizeof(T) != 0) {
+      return false;
+    }
+    values.resize(bytes->size() / sizeof(T));
+    std::memcpy(values.data(), bytes->data(), bytes->size());
+    return true;
+  }
+  template <typename T>
+  bool getValue(const uint32_t section_tag, T & value) const
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "state must be trivially copyable");
+    const auto * bytes = find(section_tag);
+    if (bytes == nullptr || bytes->size() != sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&value, bytes->data(), sizeof(T));
+    return true;
+  }
+
+  void serialize(
+    const uint64_t state_hash, const int64_t stamp_ns, std::vector<uint8_t> & out) const
+  {
+    out.clear();
+    auto put = [&out](const void * data, const size_t size) {
+      const auto * p = static_cast<const uint8_t *>(data);
+      out.insert(out.end(), p, p + size);
+    };
+    uint32_t num_sections = 0;
+    for (const auto & s : sections_) {
+      num_sections += s.used ? 1 : 0;
+    }
+    put(magic, sizeof(magic));
+    put(&state_hash, sizeof(state_hash));
+    put(&stamp_ns, sizeof(stamp_ns));
+    put(&num_sections, sizeof(num_sections));
+    for (const auto & s : sections_) {
+      if (s.used) {
+        const auto size = static_cast<uint32_t>(s.bytes.size());
+        put(&s.tag, sizeof(s.tag));
+        put(&size, sizeof(size));
+        put(s.bytes.data(), s.bytes.size());
+      }
+    }
+    const uint64_t checksum = fnv1a(out.data(), out.size());
+    put(&checksum, sizeof(checksum));
+  }
+
+  // false for a truncated or corrupt buffer and for another state_hash
+  bool parse(const uint8_t * data, const size_t size, const uint64_t state_hash)
+  {
+    clear();
+    constexpr size_t header_size = sizeof(magic) + 8 + 8 + 4;
+    if (
+      size < header_size + 8 || std::memcmp(data, magic, sizeof(magic)) != 0 ||
+      read<uint64_t>(data + size - 8) != fnv1a(data, size - 8) ||
+      read<uint64_t>(data + sizeof(magic)) != state_hash) {
+      return false;
+    }
+    stamp_ns_ = read<int64_t>(data + sizeof(magic) + 8);
+    const auto num_sections = read<uint32_t>(data + sizeof(magic) + 16);
+    size_t offset = header_size;
+    for (uint32_t i = 0; i < num_sections; ++i) {
+      if (offset + 8 > size - 8) {
+        return false;
+      }
+      const auto section_tag = read<uint32_t>(data + offset);
+      const auto section_size = read<uint32_t>(data + offset + 4);
+      offset += 8;
+      if (section_size > size - 8 - offset) {
+        return false;
+      }
+      section(section_tag).assign(data + offset, data + offset + section_size);
+      offset += section_size;
+    }
+    return offset == size - 8;
+  }
+
+  // Stamp of the parsed snapshot
+  int64_t getStamp() const { return stamp_ns_; }
+
+  /**
+   * @brief Writes the snapshot to path atomically: a temporary file is written and synced, then
+   * renamed over path, so a crash while writing keeps the previous snapshot
+   */
+  bool save(const std::string & path, const uint64_t state_hash, const int64_t stamp_ns) const
+  {
+    std::vector<uint8_t> buffer;
+    serialize(state_hash, stamp_ns, buffer);
+    return writeFile(path, buffer);
+  }
+
+  bool load(const std::string & path, const uint64_t state_hash)
+  {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+      return false;
+    }
+    const std::vector<uint8_t> buffer(
+      (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return parse(buffer.data(), buffer.size(), state_hash);
+  }
+
+  static bool writeFile(const std::string & path, const std::vector<uint8_t> & buffer)
+  {
+    const std::string tmp = path + ".tmp";
+    const int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+      return false;
+    }
+    size_t written = 0;
+    while (written < buffer.size()) {
+      const ssize_t n = ::write(fd, buffer.data() + written, buffer.size() - written);
+      if (n <= 0) {
+        ::close(fd);
+        return false;
+      }
+      written += static_cast<size_t>(n);
+    }
+    const bool synced = ::fsync(fd) == 0;
+    return ::close(fd) == 0 && synced && std::rename(tmp.c_str(), path.c_str()) == 0;
+  }
+
+  static uint64_t fnv1a(const uint8_t * data, const size_t size)
+  {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; ++i) {
+      hash = (hash ^ data[i]) * 1099511628211ULL;
+    }
+    return hash;
+  }
+
+  static int64_t now()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+  }
+
+private:
+  struct Section
+  {
+    uint32_t tag;
+    bool used;
+    std::vector<uint8_t> bytes;
+  };
+
+  template <typename T>
+  static T read(const uint8_t * p)
+  {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+  }
+
+  std::vector<uint8_t> & section(const uint32_t section_tag)
+  {
+    for (auto & s : sections_) {
+      if (s.tag == section_tag) {
+        s.used = true;
+        return s.bytes;
+      }
+    }
+    sections_.push_back(Section{section_tag, true, {}});
+    return sections_.back().bytes;
+  }
+
+  const std::vector<uint8_t> * find(const uint32_t section_tag) const
+  {
+    for (const auto & s : sections_) {
+      if (s.tag == section_tag && s.used) {
+        return &s.bytes;
+      }
+    }
+    return nullptr;
+  }
+
+  std::vector<Section> sections_;
+  int64_t stamp_ns_{0};
+};
+
+/**
+ * WarmStateCheckpointer: writes a snapshot every period without blocking the cycle
+ *
+ * The cycle fills a snapshot when due() says so and hands it over with submit(), which only
+ * swaps buffers; a background thread serializes the snapshot and writes it to disk. restore()
+ * is called once at startup.
+ *
+ *   if (checkpointer.due(now_ns)) {
+ *     snapshot.clear();
+ *     snapshot.putArray(WarmStateSnapshot::tag("MPTU"), prev_optimized_solution);
+ *     snapshot.putArray(WarmStateSnapshot::tag("ROUT"), route_ids);
+ *     checkpointer.submit(snapshot, now_ns);
+ *   }
+ */
+class WarmStateCheckpointer
+{
+public:
+  WarmStateCheckpointer(
+    std::string path, const uint64_t state_hash,
+    const std::chrono::milliseconds period = std::chrono::milliseconds(1000))
+  : path_(std::move(path)), state_hash_(state_hash), period_ns_(period.count() * 1000000)
+  {
+    writer_ = std::thread([this] { writerLoop(); });
+  }
+
+  WarmStateCheckpointer(const WarmStateCheckpointer &) = delete;
+  WarmStateCheckpointer & operator=(const WarmStateCheckpointer &) = delete;
+
+  // Writes the last submitted snapshot before returning
+  ~WarmStateCheckpointer()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_one();
+    writer_.join();
+  }
+
+  bool due(const int64_t now_ns) const { return now_ns - last_submit_ns_ >= period_ns_; }
+
+  // Swaps snapshot with the pending one (the caller gets the older buffer back for reuse)
+  void submit(WarmStateSnapshot & snapshot, const int64_t stamp_ns)
+  {
+    last_submit_ns_ = stamp_ns;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::swap(pending_, snapshot);
+      pending_stamp_ns_ = stamp_ns;
+      has_pending_ = true;
+    }
+    cv_.notify_one();
+  }
+
+  // Number of snapshots that could not be written
+  uint64_t failures() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return failures_;
+  }
+
+  /**
+   * @brief Snapshot of the previous run, if there is one for state_hash that is at most max_age
+   * old; older warm state (e.g. the vehicle moved since) would only mislead the warm start
+   */
+  static std::optional<WarmStateSnapshot> restore(
+    const std::string & path, const uint64_t state_hash, const std::chrono::milliseconds max_age,
+    const int64_t now_ns = WarmStateSnapshot::now())
+  {
+    WarmStateSnapshot snapshot;
+    if (
+      !snapshot.load(path, state_hash) ||
+      now_ns - snapshot.getStamp() > max_age.count() * 1000000) {
+      return std::nullopt;
+    }
+    return snapshot;
+  }
+
+private:
+  void writerLoop()
+  {
+    WarmStateSnapshot snapshot;
+    std::vector<uint8_t> buffer;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cv_.wait(lock, [this] { return stop_ || has_pending_; });
+      if (!has_pending_) {
+        return;
+      }
+      std::swap(snapshot, pending_);
+      const int64_t stamp_ns = pending_stamp_ns_;
+      has_pending_ = false;
+      lock.unlock();
+      snapshot.serialize(state_hash_, stamp_ns, buffer);
+      const bool ok = WarmStateSnapshot::writeFile(path_, buffer);
+      lock.lock();
+      failures_ += ok ? 0 : 1;
+    }
+  }
+
+  const std::string path_;
+  const uint64_t state_hash_;
+  const int64_t period_ns_;
+  int64_t last_submit_ns_{std::numeric_limits<int64_t>::min() / 2};  // owned by the cycle
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_{false};
+  bool has_pending_{false};
+  WarmStateSnapshot pending_;
+  int64_t pending_stamp_ns_{0};
+  uint64_t failures_{0};
+  std::thread writer_;
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__WARM_STATE_SNAPSHOT_HPP_
@@ -0,0 +1,9 @@
+INSTALL=../build/install
+CXXFLAGS="-std=c++17 -O2 -DNDEBUG -I$INSTALL/include -Iinclude -I/usr/include/eigen3"
+
+# Header only benchmarks; add -DUSE_OSQP / -DUSE_LANELET2 with the libraries of the target to run the others:
+#   -DUSE_LANELET2 -L$INSTALL/lib -llanelet2_core -llanelet2_io -llanelet2_projection -llanelet2_routing -llanelet2_traffic_rules
+g++ $CXXFLAGS benchmark/planning_benchmark.cpp -o benchmark/planning_benchmark $BENCHMARK_FLAGS
+
+mkdir -p output
+LD_LIBRARY_PATH=$INSTALL/lib ./benchmark/planning_benchmark --map lanelet2_map.osm --json output/benchmark.jsonl
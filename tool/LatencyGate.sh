@@ -0,0 +1,19 @@
+INSTALL=../build/install
+CXXFLAGS="-std=c++17 -O2 -DNDEBUG -I$INSTALL/include"
+
+# Latency regression gate of a scenario run: the per-stage latency traces of all SWCs
+# (LatencyTracer, one JSONL file per SWC) against the stored baseline of a reference run.
+# Without a baseline the run is stored as the baseline; fails (exit code 1) on a significant
+# slowdown of any stage or more deadline misses.
+#   TRACES="output/latency/*.jsonl" DEADLINES="--deadline pipeline=100" ./LatencyGate.sh
+TRACES=${TRACES:-output/latency/*.jsonl}
+BASELINE=${BASELINE:-output/latency_baseline.txt}
+DEADLINES=${DEADLINES:---deadline pipeline=100}
+g++ $CXXFLAGS benchmark/latency_gate.cpp -o benchmark/latency_gate
+
+mkdir -p output
+if [ -f $BASELINE ]; then
+  ./benchmark/latency_gate --baseline $BASELINE $DEADLINES --output output/latency_gate.csv $TRACES
+else
+  ./benchmark/latency_gate --save-baseline $BASELINE $DEADLINES --output output/latency_gate.csv $TRACES
+fi
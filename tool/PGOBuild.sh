@@ -0,0 +1,37 @@
+INSTALL=../build/install
+CXXFLAGS="-std=c++17 -O2 -DNDEBUG -I$INSTALL/include -Iinclude -I/usr/include/eigen3"
+PROFILE_DIR=${PROFILE_DIR:-$PWD/output/pgo-profiles}
+OBJ=output/pgo/planning_benchmark.o
+
+# Profile-guided build of the micro benchmarks, trained on the benchmarks themselves and, if
+# TRAIN_CMD is set, on a replay (e.g. the scenario batch runner over the recorded Scenario logs).
+# The Exe_* targets and the lanelet2 libraries use the same flags through tool/pgo.cmake.
+#   TRAIN_CMD="./scenario_batch --logs output/scenario_logs" ./PGOBuild.sh
+# GCC names the profile after the object file, so the instrumented and the optimized build compile
+# to the same object path.
+set -e
+mkdir -p output/pgo
+rm -rf $PROFILE_DIR
+
+# 1. Baseline and instrumented builds
+g++ $CXXFLAGS benchmark/planning_benchmark.cpp -o benchmark/planning_benchmark $BENCHMARK_FLAGS
+g++ $CXXFLAGS -fprofile-generate=$PROFILE_DIR -fprofile-update=atomic -c benchmark/planning_benchmark.cpp -o $OBJ
+g++ -fprofile-generate=$PROFILE_DIR $OBJ -o benchmark/planning_benchmark_instrumented $BENCHMARK_FLAGS
+
+# 2. Training runs
+LD_LIBRARY_PATH=$INSTALL/lib ./benchmark/planning_benchmark_instrumented --map lanelet2_map.osm \
+  --min-time-ms 2 --repetitions 5 > /dev/null
+if [ -n "$TRAIN_CMD" ]; then
+  LD_LIBRARY_PATH=$INSTALL/lib sh -c "$TRAIN_CMD"
+fi
+
+# 3. Optimized build
+g++ $CXXFLAGS -fprofile-use=$PROFILE_DIR -fprofile-partial-training -Wno-missing-profile \
+  -c benchmark/planning_benchmark.cpp -o $OBJ
+g++ $OBJ -o benchmark/planning_benchmark_pgo $BENCHMARK_FLAGS
+
+# 4. Report: baseline against PGO
+LD_LIBRARY_PATH=$INSTALL/lib ./benchmark/planning_benchmark --map lanelet2_map.osm --json output/benchmark_baseline.jsonl
+LD_LIBRARY_PATH=$INSTALL/lib ./benchmark/planning_benchmark_pgo --map lanelet2_map.osm --json output/benchmark_pgo.jsonl
+python3 compare_benchmarks.py --baseline output/benchmark_baseline.jsonl --candidate output/benchmark_pgo.jsonl \
+  --output output/benchmark_pgo_report.csv
@@ -0,0 +1,23 @@
+INSTALL=../build/install
+CXXFLAGS="-std=c++17 -O2 -DNDEBUG -I$INSTALL/include -I/usr/include/eigen3"
+
+# Native counterpart of TrajVisualizer.sh: the same GIFs from .trjb recordings, one process per
+# scenario so that the map layer is rasterized once and shared by the five runs (and cached in
+# output/cache for the next call)
+# Links the prebuilt lanelet2 libraries, so the headers are used in their default configuration
+# (no LANELET2_HYBRID_MAP_FLAT, which changes the layout of the map classes)
+g++ $CXXFLAGS render/trajectory_renderer.cpp -o render/trajectory_renderer -pthread \
+  -L$INSTALL/lib -llanelet2_core -llanelet2_io -llanelet2_projection
+
+mkdir -p output
+for SCENARIO in 1 2 3; do
+  FILES=""
+  for RUN in 1 2 3 4 5; do
+    NAME=Scenario_${SCENARIO}_${RUN}
+    if [ ! -f $NAME.trjb ] && [ -f $NAME.jsonl ]; then
+      python3 trajectory_record.py --input $NAME.jsonl --output $NAME.trjb
+    fi
+    FILES="$FILES $NAME.trjb"
+  done
+  LD_LIBRARY_PATH=$INSTALL/lib ./render/trajectory_renderer --map lanelet2_map.osm --scenario $SCENARIO $FILES
+done
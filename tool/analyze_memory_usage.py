@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+"""
+Summarize the memory reports (JSONL) written by MemoryReport (memory_accounting.hpp).
+
+Each line is one sample of one process:
+  {"stamp": <ns>, "process": "Exe_missionplanner", "rss": <bytes>, "heap": <bytes>,
+   "tags": {"map": [<bytes>, <peak bytes>, <allocations>], ...}}
+"tags" is only present if the executable was built with the memory accounting implementation.
+
+Outputs:
+  - Per process: peak and last RSS and heap, and the suggested "mem-usage" of the execution
+    manifest (peak RSS times --margin, rounded up to MiB).
+  - Per process and tag: live bytes of the last sample, peak bytes and allocation count, sorted
+    by peak, so the subsystems worth trimming come first.
+Both tables are printed and saved as CSV.
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import math
+from pathlib import Path
+from typing import Dict, List
+
+import pandas as pd
+
+MIB = 1024.0 * 1024.0
+
+
+def parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description="Memory report analyzer")
+    parser.add_argument("--input", required=True, nargs="+", type=Path, help="Memory report JSONL file(s)")
+    parser.add_argument("--margin", type=float, default=1.25, help="Factor on the peak RSS for mem-usage")
+    parser.add_argument(
+        "--output",
+        type=Path,
+        default=Path("output") / "memory_usage",
+        help="Prefix of the CSV files (default: output/memory_usage)",
+    )
+    return parser.parse_args()
+
+
+def load_samples(paths: List[Path]) -> List[Dict]:
+    samples: List[Dict] = []
+    for path in paths:
+        with path.open() as f:
+            for line_num, line in enumerate(f, start=1):
+                stripped = line.strip()
+                if not stripped:
+                    continue
+                try:
+                    samples.append(json.loads(stripped))
+                except json.JSONDecodeError as exc:
+                    raise ValueError(f"Invalid JSON on line {line_num} of {path}") from exc
+    if not samples:
+        raise ValueError("No samples found in the provided files.")
+    return sorted(samples, key=lambda s: s["stamp"])
+
+
+def process_table(samples: List[Dict], margin: float) -> pd.DataFrame:
+    df = pd.DataFrame.from_records(samples, columns=["stamp", "process", "rss", "heap"])
+    rows = []
+    for process, group in df.groupby("process"):
+        peak_rss = float(group["rss"].max())
+        rows.append(
+            {
+                "Process": process,
+                "Samples": len(group),
+                "Peak RSS [MiB]": peak_rss / MIB,
+                "Last RSS [MiB]": float(group["rss"].iloc[-1]) / MIB,
+                "Peak heap [MiB]": float(group["heap"].max()) / MIB,
+                "mem-usage [MiB]": math.ceil(peak_rss * margin / MIB),
+            }
+        )
+    return pd.DataFrame(rows)
+
+
+def tag_table(samples: List[Dict]) -> pd.DataFrame:
+    last: Dict[str, Dict] = {}
+    for sample in samples:
+        if "tags" in sample:
+            last[sample["process"]] = sample["tags"]
+    rows = []
+    for process, tags in last.items():
+        for tag, (live, peak, allocations) in tags.items():
+            rows.append(
+                {
+                    "Process": process,
+                    "Tag": tag,
+                    "Live [MiB]": live / MIB,
+                    "Peak [MiB]": peak / MIB,
+                    "Allocations": allocations,
+                }
+            )
+    if not rows:
+        return pd.DataFrame(columns=["Process", "Tag", "Live [MiB]", "Peak [MiB]", "Allocations"])
+    return pd.DataFrame(rows).sort_values(["Process", "Peak [MiB]"], ascending=[True, False])
+
+
+def main() -> None:
+    args = parse_args()
+
+    samples = load_samples(args.input)
+    processes = process_table(samples, args.margin)
+    tags = tag_table(samples)
+
+    with pd.option_context("display.max_rows", None, "display.width", 120):
+        print(processes.to_string(index=False, float_format=lambda v: f"{v:.1f}"))
+        if not tags.empty:
+            print()
+            print(tags.to_string(index=False, float_format=lambda v: f"{v:.2f}"))
+
+    args.output.parent.mkdir(parents=True, exist_ok=True)
+    processes.to_csv(f"{args.output}_processes.csv", index=False, float_format="%.3f")
+    tags.to_csv(f"{args.output}_tags.csv", index=False, float_format="%.3f")
+
+
+if __name__ == "__main__":
+    main()
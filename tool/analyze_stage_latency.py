@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+"""
+Analyze per-stage latency traces (JSONL) written by LatencyTracer (latency_tracer.hpp).
+
+Each line is one processed sample of one stage:
+  {"stage": "bpp", "origin": <ns>, "enter": <ns>, "exit": <ns>}
+where origin is the stamp of the input sample that started the pipeline.
+
+Outputs:
+  - Table of processing time (exit - enter) and queueing time (enter - exit of the previous
+    stage for the same origin) per stage with p50/p99/max, printed and saved as CSV.
+  - End-to-end latency (exit of the last stage - origin).
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+from pathlib import Path
+from typing import Dict, List, Optional
+
+import numpy as np
+import pandas as pd
+
+NS_TO_MS = 1e-6
+
+
+def parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description="Pipeline stage latency analyzer")
+    parser.add_argument(
+        "--input",
+        required=True,
+        nargs="+",
+        type=Path,
+        help="Trace JSONL file(s), e.g. one per SWC",
+    )
+    parser.add_argument(
+        "--stages",
+        nargs="+",
+        default=None,
+        help="Stage order (default: ordered by median enter time relative to origin)",
+    )
+    parser.add_argument(
+        "--output",
+        type=Path,
+        default=None,
+        help="CSV file for the statistics (default: output/<first input stem>_latency.csv)",
+    )
+    return parser.parse_args()
+
+
+def load_events(paths: List[Path]) -> pd.DataFrame:
+    """Load all events of all trace files."""
+    records: List[Dict] = []
+    for path in paths:
+        with path.open() as f:
+            for line_num, line in enumerate(f, start=1):
+                stripped = line.strip()
+                if not stripped:
+                    continue
+                try:
+                    records.append(json.loads(stripped))
+                except json.JSONDecodeError as exc:
+                    raise ValueError(f"Invalid JSON on line {line_num} of {path}") from exc
+    if not records:
+        raise ValueError("No events found in the provided files.")
+    df = pd.DataFrame.from_records(records, columns=["stage", "origin", "enter", "exit"])
+    # A stage may process the same origin more than once (e.g. after a replan); keep the first
+    return df.sort_values("enter").drop_duplicates(["stage", "origin"], keep="first")
+
+
+def order_stages(df: pd.DataFrame, stages: Optional[List[str]]) -> List[str]:
+    if stages:
+        return stages
+    offset = df["enter"] - df["origin"]
+    return list(offset.groupby(df["stage"]).median().sort_values().index)
+
+
+def percentile_stats(values_ns: pd.Series) -> Dict[str, float]:
+    valid = values_ns.dropna().to_numpy(dtype=np.float64) * NS_TO_MS
+    if valid.size == 0:
+        return {k: float("nan") for k in ["Count", "p50 [ms]", "p99 [ms]", "Max [ms]", "Mean [ms]"]}
+    return {
+        "Count": float(valid.size),
+        "p50 [ms]": float(np.percentile(valid, 50)),
+        "p99 [ms]": float(np.percentile(valid, 99)),
+        "Max [ms]": float(valid.max()),
+        "Mean [ms]": float(valid.mean()),
+    }
+
+
+def compute_statistics(df: pd.DataFrame, stages: List[str]) -> pd.DataFrame:
+    """Processing and queueing time per stage plus the end-to-end latency."""
+    enter = df.pivot(index="origin", columns="stage", values="enter")
+    exit_ = df.pivot(index="origin", columns="stage", values="exit")
+    rows = []
+    prev: Optional[str] = None
+    for stage in stages:
+        if stage not in enter.columns:
+            continue
+        processing = exit_[stage] - enter[stage]
+        rows.append({"Stage": stage, "Metric": "processing", **percentile_stats(processing)})
+        # The first stage is queued relative to the origin stamp of the sample
+        queued = enter[stage] - (exit_[prev] if prev is not None else enter.index.to_series())
+        rows.append({"Stage": stage, "Metric": "queueing", **percentile_stats(queued)})
+        prev = stage
+    if prev is not None:
+        end_to_end = exit_[prev] - exit_.index.to_series()
+        rows.append({"Stage": "pipeline", "Metric": "end-to-end", **percentile_stats(end_to_end)})
+    return pd.DataFrame(rows)
+
+
+def main() -> None:
+    args = parse_args()
+
+    df = load_events(args.input)
+    stages = order_stages(df, args.stages)
+    stats = compute_statistics(df, stages)
+
+    with pd.option_context("display.max_rows", None, "display.width", 120):
+        print(stats.to_string(index=False, float_format=lambda v: f"{v:.3f}"))
+
+    output = args.output or Path("output") / f"{args.input[0].stem}_latency.csv"
+    output.parent.mkdir(parents=True, exist_ok=True)
+    stats.to_csv(output, index=False, float_format="%.4f")
+
+
+if __name__ == "__main__":
+    main()
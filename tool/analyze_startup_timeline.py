@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""
+Analyze the startup timeline traces (JSONL) written by StartupTimeline (startup_timeline.hpp).
+
+Each SWC writes <process>.startup.jsonl to $PLANNING_STARTUP_TRACE_DIR, one line per milestone:
+  {"process": "Exe_elasticbandsmoother", "milestone": "map_loaded", "boot_ns": <ns>}
+boot_ns is CLOCK_BOOTTIME, shared by all processes, so 0 is kernel boot (the closest stamp to
+ignition that every process can read).
+
+Outputs:
+  - Milestones of every process relative to boot and to its own process_start, printed and saved
+    as CSV.
+  - Per process the slowest step (the largest gap between consecutive milestones), which is where
+    startup of that SWC should be shortened first.
+  - Time from boot to the first trajectory: first_output of --final-process.
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+from pathlib import Path
+from typing import Dict, List
+
+import pandas as pd
+
+NS_TO_S = 1e-9
+
+
+def parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description="Startup timeline analyzer")
+    parser.add_argument(
+        "--input",
+        required=True,
+        nargs="+",
+        type=Path,
+        help="Startup trace JSONL file(s) or directories containing *.startup.jsonl",
+    )
+    parser.add_argument(
+        "--final-process",
+        default="Exe_motionvelocityplanner",
+        help="Process whose first_output is the first trajectory (default: Exe_motionvelocityplanner)",
+    )
+    parser.add_argument(
+        "--output",
+        type=Path,
+        default=Path("output") / "startup_timeline.csv",
+        help="CSV file for the timeline (default: output/startup_timeline.csv)",
+    )
+    return parser.parse_args()
+
+
+def trace_files(paths: List[Path]) -> List[Path]:
+    files: List[Path] = []
+    for path in paths:
+        files.extend(sorted(path.glob("*.startup.jsonl")) if path.is_dir() else [path])
+    return files
+
+
+def load_milestones(paths: List[Path]) -> pd.DataFrame:
+    """Load all milestones of all trace files."""
+    records: List[Dict] = []
+    for path in trace_files(paths):
+        with path.open() as f:
+            for line_num, line in enumerate(f, start=1):
+                stripped = line.strip()
+                if not stripped:
+                    continue
+                try:
+                    records.append(json.loads(stripped))
+                except json.JSONDecodeError as exc:
+                    raise ValueError(f"Invalid JSON on line {line_num} of {path}") from exc
+    if not records:
+        raise ValueError("No milestones found in the provided files.")
+    df = pd.DataFrame.from_records(records, columns=["process", "milestone", "boot_ns"])
+    return df.sort_values(["process", "boot_ns"]).reset_index(drop=True)
+
+
+def compute_timeline(df: pd.DataFrame) -> pd.DataFrame:
+    """Milestones relative to boot, to process_start and to the previous milestone."""
+    rows = []
+    for process, group in df.groupby("process", sort=False):
+        start = group.loc[group["milestone"] == "process_start", "boot_ns"]
+        start_ns = int(start.iloc[0]) if not start.empty else int(group["boot_ns"].min())
+        prev_ns = start_ns
+        for _, row in group.iterrows():
+            rows.append(
+                {
+                    "Process": process,
+                    "Milestone": row["milestone"],
+                    "Since boot [s]": row["boot_ns"] * NS_TO_S,
+                    "Since start [s]": (row["boot_ns"] - start_ns) * NS_TO_S,
+                    "Step [s]": (row["boot_ns"] - prev_ns) * NS_TO_S,
+                }
+            )
+            prev_ns = row["boot_ns"]
+    return pd.DataFrame(rows).sort_values("Since boot [s]").reset_index(drop=True)
+
+
+def main() -> None:
+    args = parse_args()
+
+    timeline = compute_timeline(load_milestones(args.input))
+
+    with pd.option_context("display.max_rows", None, "display.width", 120):
+        print(timeline.to_string(index=False, float_format=lambda v: f"{v:.3f}"))
+
+    print("\nSlowest step per process:")
+    slowest = timeline.loc[timeline.groupby("Process")["Step [s]"].idxmax()]
+    for _, row in slowest.iterrows():
+        print(f"  {row['Process']}: {row['Milestone']} took {row['Step [s]']:.3f} s")
+
+    first = timeline[(timeline["Process"] == args.final_process) & (timeline["Milestone"] == "first_output")]
+    if first.empty:
+        print(f"\n{args.final_process} has no first_output milestone")
+    else:
+        print(f"\nBoot to first trajectory: {first['Since boot [s]'].iloc[0]:.3f} s")
+
+    args.output.parent.mkdir(parents=True, exist_ok=True)
+    timeline.to_csv(args.output, index=False, float_format="%.4f")
+
+
+if __name__ == "__main__":
+    main()
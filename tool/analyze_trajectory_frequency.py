@@ -27,6 +27,8 @@ from openpyxl.chart.shapes import GraphicalProperties
 from openpyxl.drawing.line import LineProperties
 from openpyxl.styles import Alignment, Border, Font, PatternFill, Side
 
+from trajectory_record import load_stamps_ns
+
 NS_TO_SEC = 1e-9
 
 
@@ -36,7 +38,7 @@ def parse_args() -> argparse.Namespace:
         "--input",
         required=True,
         type=Path,
-        help="Path to trajectory JSONL file (each line contains a timestamp field)",
+        help="Path to trajectory JSONL file (each line contains a timestamp field) or .trjb record file",
     )
     parser.add_argument(
         "--scenario",
@@ -89,7 +91,13 @@ def extract_timestamp_ns(record: Dict) -> int:
 
 
 def load_timestamps(path: Path) -> List[int]:
-    """Load all timestamps (nanoseconds) from a JSONL file."""
+    """Load all timestamps (nanoseconds) from a JSONL or .trjb file."""
+    if path.suffix.lower() == ".trjb":
+        timestamps = load_stamps_ns(path)
+        if not timestamps:
+            raise ValueError("No timestamps found in the provided file.")
+        return timestamps
+
     timestamps: List[int] = []
     with path.open() as f:
         for line_num, line in enumerate(f, start=1):
@@ -0,0 +1,646 @@
+// Statistical regression gate on the per-stage latency of the planning pipeline
+//
+// Reads the latency traces of a scenario run (LatencyTracer, latency_tracer.hpp: one JSON line
+// {"stage", "origin", "enter", "exit"} per processed sample, one file per SWC), joins the events
+// by origin like tool/analyze_stage_latency.py and computes per stage the processing time
+// (exit - enter) and the queueing time (enter - exit of the previous stage), plus the end-to-end
+// latency of the pipeline: count, p50/p95/p99/max/mean and the misses of the given deadlines.
+//
+// With --baseline, every metric is compared against the stored samples of a reference run. For
+// p50, p95 and p99 the difference candidate - baseline gets a one-sided bootstrap lower bound;
+// a metric regresses if that bound exceeds the tolerance (--tolerance relative to the baseline,
+// at least --min-delta-ms). Deadline miss rates regress if they are significantly higher (one
+// sided two-proportion test). The confidence level holds for the whole run: it is divided among
+// all tests (Bonferroni), so more stages do not mean more false alarms. The exit code is 1 if
+// anything regressed, so a scenario run can be failed on it (tool/LatencyGate.sh):
+//
+//   ./latency_gate --save-baseline output/latency_baseline.txt $TRACES
+//   ./latency_gate --baseline output/latency_baseline.txt --deadline pipeline=100 $TRACES
+//
+// The bootstrap does not resample: the k-th smallest value of a resample of n sorted values is
+// x[ceil(n * U) - 1] with U ~ Beta(k, n + 1 - k) (order statistic of uniforms), so one replicate
+// of a quantile costs two gamma draws however long the trace is.
+//
+// Build: g++ -std=c++17 -O2 latency_gate.cpp -o latency_gate
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+constexpr double ns_to_ms = 1e-6;
+constexpr const char * pipeline_stage = "pipeline";
+constexpr std::pair<const char *, double> gated_quantiles[] = {
+  {"p50", 0.50}, {"p95", 0.95}, {"p99", 0.99}};
+
+struct Options
+{
+  std::vector<std::string> trace_files;
+  std::vector<std::string> baseline_files;
+  std::string save_baseline;
+  std::string output{"output/latency_gate.csv"};
+  std::vector<std::string> stages;
+  std::map<std::string, double> deadlines_ms;  // stage (processing) or "pipeline" (end-to-end)
+  double confidence{0.99};
+  double tolerance{0.05};
+  double min_delta_ms{0.05};
+  size_t min_samples{30};
+  size_t bootstrap{10000};
+  uint64_t seed{1};
+};
+
+// One metric of one stage: the samples in nanoseconds, sorted
+struct Metric
+{
+  std::string stage;
+  std::string name;  // processing, queueing, end-to-end
+  std::vector<int64_t> values;
+
+  std::string key() const { return stage + "/" + name; }
+};
+
+// ---------------------------------------------------------------------------------------------
+// Traces
+// ---------------------------------------------------------------------------------------------
+
+// Value of a field of the flat JSON objects written by LatencyTracer
+bool findField(const std::string & line, const char * name, std::string & value)
+{
+  const std::string pattern = std::string("\"") + name + "\":";
+  const auto pos = line.find(pattern);
+  if (pos == std::string::npos) {
+    return false;
+  }
+  size_t begin = pos + pattern.size();
+  while (begin < line.size() && line[begin] == ' ') {
+    ++begin;
+  }
+  if (begin < line.size() && line[begin] == '"') {
+    const auto end = line.find('"', begin + 1);
+    if (end == std::string::npos) {
+      return false;
+    }
+    value = line.substr(begin + 1, end - begin - 1);
+    return true;
+  }
+  const auto end = line.find_first_of(",}", begin);
+  value = line.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+  return !value.empty();
+}
+
+struct Span
+{
+  int64_t enter;
+  int64_t exit;
+};
+using StageEvents = std::unordered_map<int64_t, Span>;  // by origin
+
+// Events of all files by stage; a stage that processed an origin more than once keeps the first
+bool loadTraces(const std::vector<std::string> & paths, std::map<std::string, StageEvents> & stages)
+{
+  for (const auto & path : paths) {
+    std::ifstream file(path);
+    if (!file) {
+      std::fprintf(stderr, "Cannot open %s\n", path.c_str());
+      return false;
+    }
+    std::string line;
+    std::string stage;
+    std::string origin;
+    std::string enter;
+    std::string exit;
+    size_t line_num = 0;
+    while (std::getline(file, line)) {
+      ++line_num;
+      if (line.find_first_not_of(" \t\r") == std::string::npos) {
+        continue;
+      }
+      if (
+        !findField(line, "stage", stage) || !findField(line, "origin", origin) ||
+        !findField(line, "enter", enter) || !findField(line, "exit", exit)) {
+        std::fprintf(stderr, "Invalid event on line %zu of %s\n", line_num, path.c_str());
+        return false;
+      }
+      const Span span{std::atoll(enter.c_str()), std::atoll(exit.c_str())};
+      auto & events = stages[stage];
+      const auto inserted = events.emplace(std::atoll(origin.c_str()), span);
+      if (!inserted.second && span.enter < inserted.first->second.enter) {
+        inserted.first->second = span;
+      }
+    }
+  }
+  if (stages.empty()) {
+    std::fprintf(stderr, "No events found in the provided files.\n");
+    return false;
+  }
+  return true;
+}
+
+// Stage order: as given, else by the median enter time relative to the origin
+std::vector<std::string> orderStages(
+  const std::map<std::string, StageEvents> & stages, const std::vector<std::string> & given)
+{
+  if (!given.empty()) {
+    return given;
+  }
+  std::vector<std::pair<int64_t, std::string>> order;
+  for (const auto & [name, events] : stages) {
+    std::vector<int64_t> offsets;
+    offsets.reserve(events.size());
+    for (const auto & [origin, span] : events) {
+      offsets.push_back(span.enter - origin);
+    }
+    std::nth_element(offsets.begin(), offsets.begin() + offsets.size() / 2, offsets.end());
+    order.emplace_back(offsets[offsets.size() / 2], name);
+  }
+  std::sort(order.begin(), order.end());
+  std::vector<std::string> names;
+  for (const auto & entry : order) {
+    names.push_back(entry.second);
+  }
+  return names;
+}
+
+std::vector<Metric> computeMetrics(
+  const std::map<std::string, StageEvents> & stages, const std::vector<std::string> & order)
+{
+  std::vector<Metric> metrics;
+  const StageEvents * prev = nullptr;
+  for (const auto & name : order) {
+    const auto it = stages.find(name);
+    if (it == stages.end()) {
+      continue;
+    }
+    Metric processing{name, "processing", {}};
+    Metric queueing{name, "queueing", {}};
+    for (const auto & [origin, span] : it->second) {
+      processing.values.push_back(span.exit - span.enter);
+      // the first stage is queued relative to the origin stamp of the sample
+      if (prev == nullptr) {
+        queueing.values.push_back(span.enter - origin);
+      } else if (const auto p = prev->find(origin); p != prev->end()) {
+        queueing.values.push_back(span.enter - p->second.exit);
+      }
+    }
+    metrics.push_back(std::move(processing));
+    metrics.push_back(std::move(queueing));
+    prev = &it->second;
+  }
+  if (prev != nullptr) {
+    Metric end_to_end{pipeline_stage, "end-to-end", {}};
+    for (const auto & [origin, span] : *prev) {
+      end_to_end.values.push_back(span.exit - origin);
+    }
+    metrics.push_back(std::move(end_to_end));
+  }
+  for (auto & metric : metrics) {
+    std::sort(metric.values.begin(), metric.values.end());
+  }
+  return metrics;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Baseline file: one line per metric, "<stage> <metric> <count> <sorted values [ns]...>"
+// ---------------------------------------------------------------------------------------------
+constexpr const char * baseline_header = "latency_baseline 1";
+
+bool saveBaseline(const std::string & path, const std::vector<Metric> & metrics)
+{
+  std::ofstream file(path);
+  file << baseline_header << "\n";
+  for (const auto & metric : metrics) {
+    file << metric.stage << " " << metric.name << " " << metric.values.size();
+    for (const auto v : metric.values) {
+      file << " " << v;
+    }
+    file << "\n";
+  }
+  return static_cast<bool>(file);
+}
+
+bool loadBaseline(const std::string & path, std::vector<Metric> & metrics)
+{
+  std::ifstream file(path);
+  std::string line;
+  if (!std::getline(file, line) || line != baseline_header) {
+    std::fprintf(stderr, "%s is not a latency baseline\n", path.c_str());
+    return false;
+  }
+  while (std::getline(file, line)) {
+    std::istringstream in(line);
+    Metric metric;
+    size_t count = 0;
+    if (!(in >> metric.stage >> metric.name >> count)) {
+      continue;
+    }
+    metric.values.resize(count);
+    for (auto & v : metric.values) {
+      in >> v;
+    }
+    if (!in) {
+      std::fprintf(stderr, "Truncated metric %s in %s\n", metric.key().c_str(), path.c_str());
+      return false;
+    }
+    metrics.push_back(std::move(metric));
+  }
+  return true;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Statistics
+// ---------------------------------------------------------------------------------------------
+
+// Quantile with linear interpolation between the order statistics (numpy default), in ms
+double quantileMs(const std::vector<int64_t> & sorted, const double q)
+{
+  if (sorted.empty()) {
+    return NAN;
+  }
+  const double h = q * static_cast<double>(sorted.size() - 1);
+  const auto lo = static_cast<size_t>(std::floor(h));
+  const size_t hi = std::min(lo + 1, sorted.size() - 1);
+  const double v = static_cast<double>(sorted[lo]) +
+                   (h - static_cast<double>(lo)) * static_cast<double>(sorted[hi] - sorted[lo]);
+  return v * ns_to_ms;
+}
+
+double meanMs(const std::vector<int64_t> & values)
+{
+  if (values.empty()) {
+    return NAN;
+  }
+  double sum = 0.0;
+  for (const auto v : values) {
+    sum += static_cast<double>(v);
+  }
+  return sum / static_cast<double>(values.size()) * ns_to_ms;
+}
+
+size_t misses(const std::vector<int64_t> & sorted, const double deadline_ms)
+{
+  const auto deadline_ns = static_cast<int64_t>(deadline_ms / ns_to_ms);
+  return static_cast<size_t>(
+    sorted.end() - std::upper_bound(sorted.begin(), sorted.end(), deadline_ns));
+}
+
+// Upper alpha quantile of the standard normal distribution
+double normalUpperQuantile(const double alpha)
+{
+  double lo = 0.0;
+  double hi = 40.0;
+  for (int i = 0; i < 200; ++i) {
+    const double mid = 0.5 * (lo + hi);
+    (0.5 * std::erfc(mid / std::sqrt(2.0)) > alpha ? lo : hi) = mid;
+  }
+  return 0.5 * (lo + hi);
+}
+
+// Bootstrap replicates of the q quantile of a sorted sample (nearest order statistic)
+class QuantileBootstrap
+{
+public:
+  QuantileBootstrap(const std::vector<int64_t> & sorted, const double q)
+  : sorted_(sorted),
+    k_(std::clamp<double>(std::round(q * static_cast<double>(sorted.size() - 1)) + 1.0, 1.0,
+                          static_cast<double>(sorted.size()))),
+    a_(k_, 1.0),
+    b_(static_cast<double>(sorted.size()) + 1.0 - k_, 1.0)
+  {
+  }
+
+  double draw(std::mt19937_64 & rng)
+  {
+    const double x = a_(rng);
+    const double u = x / (x + b_(rng));
+    const auto n = static_cast<double>(sorted_.size());
+    const auto rank = static_cast<size_t>(std::clamp(std::ceil(n * u), 1.0, n));
+    return static_cast<double>(sorted_[rank - 1]) * ns_to_ms;
+  }
+
+private:
+  const std::vector<int64_t> & sorted_;
+  double k_;
+  std::gamma_distribution<double> a_;
+  std::gamma_distribution<double> b_;
+};
+
+// Lower bound (one-sided, level 1 - alpha) of the q quantile difference candidate - baseline
+double differenceLowerBound(
+  const std::vector<int64_t> & baseline, const std::vector<int64_t> & candidate, const double q,
+  const double alpha, const Options & options, std::mt19937_64 & rng)
+{
+  QuantileBootstrap base(baseline, q);
+  QuantileBootstrap cand(candidate, q);
+  std::vector<double> deltas(options.bootstrap);
+  for (auto & d : deltas) {
+    d = cand.draw(rng) - base.draw(rng);
+  }
+  const auto index = static_cast<size_t>(std::floor(alpha * static_cast<double>(deltas.size())));
+  std::nth_element(deltas.begin(), deltas.begin() + index, deltas.end());
+  return deltas[index];
+}
+
+// ---------------------------------------------------------------------------------------------
+// Gate
+// ---------------------------------------------------------------------------------------------
+struct Row
+{
+  const Metric * metric{nullptr};
+  const Metric * baseline{nullptr};
+  double deadline_ms{NAN};
+  size_t misses{0};
+  size_t baseline_misses{0};
+  double delta_ms[3]{NAN, NAN, NAN};
+  double lower_ms[3]{NAN, NAN, NAN};
+  bool regressed[3]{false, false, false};
+  bool misses_regressed{false};
+  std::string note;
+};
+
+double deadlineOf(const Metric & metric, const Options & options)
+{
+  const bool gated = metric.stage == pipeline_stage ? metric.name == "end-to-end"
+                                                    : metric.name == "processing";
+  const auto it = options.deadlines_ms.find(metric.stage);
+  return gated && it != options.deadlines_ms.end() ? it->second : NAN;
+}
+
+// Fills the comparison of all rows; returns the number of regressions
+size_t gate(std::vector<Row> & rows, const Options & options)
+{
+  size_t num_tests = 0;
+  for (const auto & row : rows) {
+    if (row.baseline == nullptr) {
+      continue;
+    }
+    if (
+      row.metric->values.size() >= options.min_samples &&
+      row.baseline->values.size() >= options.min_samples) {
+      num_tests += std::size(gated_quantiles);
+    }
+    num_tests += std::isnan(row.deadline_ms) ? 0 : 1;
+  }
+  const double alpha =
+    (1.0 - options.confidence) / static_cast<double>(std::max<size_t>(num_tests, 1));
+  const double z = normalUpperQuantile(alpha);
+
+  std::mt19937_64 rng(options.seed);
+  size_t regressions = 0;
+  for (auto & row : rows) {
+    if (row.baseline == nullptr) {
+      row.note = "no baseline";
+      continue;
+    }
+    const auto & cand = row.metric->values;
+    const auto & base = row.baseline->values;
+    if (cand.size() < options.min_samples || base.size() < options.min_samples) {
+      row.note = "too few samples";
+    } else {
+      for (size_t i = 0; i < std::size(gated_quantiles); ++i) {
+        const double q = gated_quantiles[i].second;
+        const double base_q = quantileMs(base, q);
+        row.delta_ms[i] = quantileMs(cand, q) - base_q;
+        row.lower_ms[i] = differenceLowerBound(base, cand, q, alpha, options, rng);
+        const double tolerance = std::max(options.min_delta_ms, options.tolerance * base_q);
+        row.regressed[i] = row.lower_ms[i] > tolerance;
+        regressions += row.regressed[i] ? 1 : 0;
+      }
+    }
+    if (!std::isnan(row.deadline_ms) && !cand.empty() && !base.empty()) {
+      row.baseline_misses = misses(base, row.deadline_ms);
+      const double nc = static_cast<double>(cand.size());
+      const double nb = static_cast<double>(base.size());
+      const double pc = static_cast<double>(row.misses) / nc;
+      const double pb = static_cast<double>(row.baseline_misses) / nb;
+      const double pooled = static_cast<double>(row.misses + row.baseline_misses) / (nc + nb);
+      const double se = std::sqrt(pooled * (1.0 - pooled) * (1.0 / nc + 1.0 / nb));
+      row.misses_regressed = se > 0.0 && (pc - pb) / se > z;
+      regressions += row.misses_regressed ? 1 : 0;
+    }
+  }
+  return regressions;
+}
+
+void printAndSave(const std::vector<Row> & rows, const Options & options, const bool compared)
+{
+  std::printf(
+    "%-24s %-11s %7s %9s %9s %9s %9s %9s %7s", "Stage", "Metric", "Count", "p50 [ms]", "p95 [ms]",
+    "p99 [ms]", "Max [ms]", "Mean [ms]", "Misses");
+  if (compared) {
+    for (const auto & [name, q] : gated_quantiles) {
+      std::printf("  %-22s", (std::string(name) + " delta (lower)").c_str());
+    }
+  }
+  std::printf("\n");
+
+  std::ofstream csv(options.output);
+  csv << "Stage,Metric,Count,p50 [ms],p95 [ms],p99 [ms],Max [ms],Mean [ms],Deadline [ms],Misses";
+  if (compared) {
+    for (const auto & [name, q] : gated_quantiles) {
+      csv << "," << name << " delta [ms]," << name << " lower [ms]," << name << " regression";
+    }
+    csv << ",Baseline misses,Misses regression,Note";
+  }
+  csv << "\n";
+
+  for (const auto & row : rows) {
+    const auto & v = row.metric->values;
+    const double max_ms = v.empty() ? NAN : static_cast<double>(v.back()) * ns_to_ms;
+    std::printf(
+      "%-24s %-11s %7zu %9.3f %9.3f %9.3f %9.3f %9.3f", row.metric->stage.c_str(),
+      row.metric->name.c_str(), v.size(), quantileMs(v, 0.5), quantileMs(v, 0.95),
+      quantileMs(v, 0.99), max_ms, meanMs(v));
+    if (std::isnan(row.deadline_ms)) {
+      std::printf(" %7s", "-");
+    } else {
+      std::printf(" %6zu%s", row.misses, row.misses_regressed ? "!" : " ");
+    }
+    char line[256];
+    std::snprintf(
+      line, sizeof(line),
+      "%s,%s,%zu,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%zu", row.metric->stage.c_str(),
+      row.metric->name.c_str(), v.size(), quantileMs(v, 0.5), quantileMs(v, 0.95),
+      quantileMs(v, 0.99), max_ms, meanMs(v), row.deadline_ms, row.misses);
+    csv << line;
+    if (compared) {
+      for (size_t i = 0; i < std::size(gated_quantiles); ++i) {
+        char cell[64];
+        if (std::isnan(row.delta_ms[i])) {
+          std::snprintf(cell, sizeof(cell), "-");
+        } else {
+          std::snprintf(
+            cell, sizeof(cell), "%+.3f (%+.3f)%s", row.delta_ms[i], row.lower_ms[i],
+            row.regressed[i] ? " SLOWER" : "");
+        }
+        std::printf("  %-22s", cell);
+        std::snprintf(
+          line, sizeof(line), ",%.4f,%.4f,%d", row.delta_ms[i], row.lower_ms[i],
+          row.regressed[i] ? 1 : 0);
+        csv << line;
+      }
+      csv << "," << row.baseline_misses << "," << (row.misses_regressed ? 1 : 0) << "," << row.note;
+      if (!row.note.empty()) {
+        std::printf("  %s", row.note.c_str());
+      }
+    }
+    csv << "\n";
+    std::printf("\n");
+  }
+}
+
+void usage(const char * name)
+{
+  std::fprintf(
+    stderr,
+    "Usage: %s [options] <trace.jsonl>...\n"
+    "  --baseline <file>          stored baseline (--save-baseline) or trace .jsonl, repeatable\n"
+    "  --save-baseline <file>     store the samples of this run as the baseline\n"
+    "  --deadline <stage>=<ms>    deadline of the processing time of a stage, pipeline=<ms> for\n"
+    "                             the end-to-end latency; repeatable\n"
+    "  --stages <a,b,...>         stage order (default: by median enter time)\n"
+    "  --confidence <c>           family-wise confidence of the gate (default 0.99)\n"
+    "  --tolerance <r>            accepted relative slowdown of a quantile (default 0.05)\n"
+    "  --min-delta-ms <ms>        accepted absolute slowdown of a quantile (default 0.05)\n"
+    "  --min-samples <n>          fewer samples are reported, not gated (default 30)\n"
+    "  --bootstrap <n>            bootstrap replicates (default 10000)\n"
+    "  --seed <n>                 random seed of the bootstrap (default 1)\n"
+    "  --output <file>            CSV of the statistics (default output/latency_gate.csv)\n"
+    "Exit code: 0 pass, 1 significant regression, 2 invalid input\n",
+    name);
+}
+
+bool endsWith(const std::string & s, const std::string & suffix)
+{
+  return s.size() >= suffix.size() &&
+         s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--baseline" && has_value) {
+      options.baseline_files.push_back(argv[++i]);
+    } else if (arg == "--save-baseline" && has_value) {
+      options.save_baseline = argv[++i];
+    } else if (arg == "--deadline" && has_value) {
+      const std::string value = argv[++i];
+      const auto eq = value.find('=');
+      if (eq == std::string::npos) {
+        usage(argv[0]);
+        return 2;
+      }
+      options.deadlines_ms[value.substr(0, eq)] = std::atof(value.c_str() + eq + 1);
+    } else if (arg == "--stages" && has_value) {
+      std::istringstream in(argv[++i]);
+      std::string stage;
+      while (std::getline(in, stage, ',')) {
+        options.stages.push_back(stage);
+      }
+    } else if (arg == "--confidence" && has_value) {
+      options.confidence = std::clamp(std::atof(argv[++i]), 0.5, 1.0 - 1e-9);
+    } else if (arg == "--tolerance" && has_value) {
+      options.tolerance = std::atof(argv[++i]);
+    } else if (arg == "--min-delta-ms" && has_value) {
+      options.min_delta_ms = std::atof(argv[++i]);
+    } else if (arg == "--min-samples" && has_value) {
+      options.min_samples = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+    } else if (arg == "--bootstrap" && has_value) {
+      options.bootstrap = static_cast<size_t>(std::max(100, std::atoi(argv[++i])));
+    } else if (arg == "--seed" && has_value) {
+      options.seed = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--output" && has_value) {
+      options.output = argv[++i];
+    } else if (!arg.empty() && arg[0] != '-') {
+      options.trace_files.push_back(arg);
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (options.trace_files.empty()) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  std::map<std::string, StageEvents> stages;
+  if (!loadTraces(options.trace_files, stages)) {
+    return 2;
+  }
+  const auto order = orderStages(stages, options.stages);
+  const auto metrics = computeMetrics(stages, order);
+
+  // baseline: stored files and trace files, the traces ordered like the candidate
+  std::vector<Metric> baseline;
+  std::vector<std::string> baseline_traces;
+  for (const auto & path : options.baseline_files) {
+    if (endsWith(path, ".jsonl")) {
+      baseline_traces.push_back(path);
+    } else if (!loadBaseline(path, baseline)) {
+      return 2;
+    }
+  }
+  if (!baseline_traces.empty()) {
+    std::map<std::string, StageEvents> baseline_stages;
+    if (!loadTraces(baseline_traces, baseline_stages)) {
+      return 2;
+    }
+    for (auto & metric : computeMetrics(baseline_stages, orderStages(baseline_stages, order))) {
+      baseline.push_back(std::move(metric));
+    }
+  }
+
+  std::unordered_map<std::string, const Metric *> baseline_by_key;
+  for (const auto & metric : baseline) {
+    baseline_by_key.emplace(metric.key(), &metric);
+  }
+  std::vector<Row> rows;
+  for (const auto & metric : metrics) {
+    Row row;
+    row.metric = &metric;
+    const auto it = baseline_by_key.find(metric.key());
+    row.baseline = it != baseline_by_key.end() ? it->second : nullptr;
+    row.deadline_ms = deadlineOf(metric, options);
+    row.misses = std::isnan(row.deadline_ms) ? 0 : misses(metric.values, row.deadline_ms);
+    rows.push_back(row);
+  }
+  for (const auto & [key, metric] : baseline_by_key) {
+    const bool present = std::any_of(
+      metrics.begin(), metrics.end(), [&key = key](const Metric & m) { return m.key() == key; });
+    if (!present) {
+      std::fprintf(stderr, "Warning: %s of the baseline is missing in the traces\n", key.c_str());
+    }
+  }
+
+  const bool compared = !baseline.empty();
+  const size_t regressions = compared ? gate(rows, options) : 0;
+  printAndSave(rows, options, compared);
+
+  if (!options.save_baseline.empty()) {
+    if (!saveBaseline(options.save_baseline, metrics)) {
+      std::fprintf(stderr, "Cannot write %s\n", options.save_baseline.c_str());
+      return 2;
+    }
+    std::printf("Saved baseline to %s\n", options.save_baseline.c_str());
+  }
+  if (compared) {
+    std::printf(
+      "\n%s: %zu significant regression(s) (confidence %.3f over all tests)\n",
+      regressions == 0 ? "PASS" : "FAIL", regressions, options.confidence);
+  }
+  return regressions == 0 ? 0 : 1;
+}
@@ -0,0 +1,763 @@
+// Micro benchmarks for the planning hot paths
+//
+// Build with tool/Benchmark.sh. Each benchmark is calibrated until one batch takes at least
+// --min-time-ms, then --repetitions batches are timed; the table reports the time per iteration
+// (mean, p50 and p99 over batches) so changes in tail latency are visible, not only the average.
+// With --perf the timed batches also count cycles, instructions, cache and branch misses
+// (perf_counters.hpp), reported per iteration with the IPC; compare two runs with
+// tool/compare_benchmarks.py.
+//
+// Optional sections:
+//   USE_OSQP      OSQPInterface::optimize, also for both MPT QP formulations (links the path
+//                 optimizer and osqp)
+//   USE_LANELET2  AttributeMap build and lookup; OSM load, attribute queries on the loaded map,
+//                 PrimitiveLayer::nearest and RoutingGraph::shortestPath (--map)
+
+#include "bounds_calculator.hpp"
+#include "cubic_spline.hpp"
+#include "elastic_band_qp.hpp"
+#include "footprint_collision.hpp"
+#include "mpt_qp_formulation.hpp"
+#include "path_geometry.hpp"
+#include "path_optimizer_types.hpp"
+#include "perf_counters.hpp"
+#include "qp_solver_backend.hpp"
+#include "state_equation_generator.hpp"
+#include "trajectory_corridor_grid.hpp"
+#include "trajectory_index.hpp"
+#include "trajectory_resampler.hpp"
+
+#ifdef USE_OSQP
+#include "osqp_interface.hpp"
+#endif
+
+#include <Eigen/SparseCholesky>
+
+#ifdef USE_LANELET2
+#include <lanelet2_core/LaneletMap.h>
+#include <lanelet2_io/Io.h>
+#include <lanelet2_projection/UTM.h>
+#include <lanelet2_routing/RoutingGraph.h>
+#include <lanelet2_traffic_rules/TrafficRulesFactory.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+using autoware::path_optimizer::BoundsCalculator;
+using autoware::path_optimizer::CollisionPolygon;
+using autoware::path_optimizer::CubicSpline2D;
+using autoware::path_optimizer::ElasticBandQP;
+using autoware::path_optimizer::FootprintBatch;
+using autoware::path_optimizer::MPTQPBuilder;
+using autoware::path_optimizer::MPTQPFormulation;
+using autoware::path_optimizer::PathGeometry;
+using autoware::path_optimizer::PerfCounterGroup;
+using autoware::path_optimizer::PerfCounterValues;
+using autoware::path_optimizer::ReferencePoint;
+using autoware::path_optimizer::StateEquationGenerator;
+using autoware::path_optimizer::TrajectoryCorridorGrid;
+using autoware::path_optimizer::TrajectoryIndex;
+using autoware::path_optimizer::TrajectoryPoint;
+using autoware::path_optimizer::TrajectoryResampler;
+
+struct Options
+{
+  double min_time_ms{10.0};
+  size_t repetitions{30};
+  std::string filter;
+  std::string json_output;
+  std::string map_path;
+  bool perf{false};
+};
+
+// Runs the benchmarked operation the given number of times
+using BenchmarkFunction = std::function<void(size_t)>;
+
+struct Benchmark
+{
+  std::string name;
+  BenchmarkFunction run;
+};
+
+struct Result
+{
+  std::string name;
+  size_t iterations{0};
+  double mean_ns{0.0};
+  double p50_ns{0.0};
+  double p99_ns{0.0};
+  PerfCounterValues counters;  // per iteration, valid with --perf
+};
+
+// Keeps the compiler from removing the computation of value
+template <typename T>
+inline void doNotOptimize(const T & value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+double elapsedNs(const BenchmarkFunction & run, const size_t iterations)
+{
+  const auto start = std::chrono::steady_clock::now();
+  run(iterations);
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+double percentile(std::vector<double> values, const double q)
+{
+  std::sort(values.begin(), values.end());
+  const auto idx = static_cast<size_t>(q * static_cast<double>(values.size() - 1) + 0.5);
+  return values[idx];
+}
+
+Result runBenchmark(
+  const Benchmark & benchmark, const Options & options, PerfCounterGroup * perf_counters)
+{
+  size_t iterations = 1;
+  const double min_time_ns = options.min_time_ms * 1e6;
+  while (elapsedNs(benchmark.run, iterations) < min_time_ns && iterations < (1U << 30U)) {
+    iterations *= 2;
+  }
+
+  std::vector<double> per_iteration;
+  per_iteration.reserve(options.repetitions);
+  PerfCounterValues counters;
+  for (size_t i = 0; i < options.repetitions; ++i) {
+    double elapsed = 0.0;
+    if (perf_counters != nullptr) {
+      PerfCounterGroup::Scope scope(*perf_counters, counters);
+      elapsed = elapsedNs(benchmark.run, iterations);
+    } else {
+      elapsed = elapsedNs(benchmark.run, iterations);
+    }
+    per_iteration.push_back(elapsed / static_cast<double>(iterations));
+  }
+
+  Result result;
+  result.name = benchmark.name;
+  result.iterations = iterations;
+  for (const double v : per_iteration) {
+    result.mean_ns += v / static_cast<double>(per_iteration.size());
+  }
+  result.p50_ns = percentile(per_iteration, 0.5);
+  result.p99_ns = percentile(per_iteration, 0.99);
+  result.counters =
+    counters.scaled(1.0 / static_cast<double>(iterations * per_iteration.size()));
+  return result;
+}
+
+// Sine shaped path with the given number of points and spacing
+std::vector<TrajectoryPoint> makeTrajectory(const size_t num_points, const double interval)
+{
+  std::vector<TrajectoryPoint> points(num_points);
+  for (size_t i = 0; i < num_points; ++i) {
+    const double x = static_cast<double>(i) * interval;
+    const double y = 2.0 * std::sin(x / 20.0);
+    const double yaw = std::atan(0.1 * std::cos(x / 20.0));
+    points[i].pose.position.x = x;
+    points[i].pose.position.y = y;
+    points[i].pose.orientation.z = std::sin(0.5 * yaw);
+    points[i].pose.orientation.w = std::cos(0.5 * yaw);
+    points[i].longitudinal_velocity_mps = 10.0;
+  }
+  return points;
+}
+
+std::vector<ReferencePoint> makeRefPoints(const size_t num_points)
+{
+  std::vector<ReferencePoint> ref_points(num_points);
+  for (size_t i = 0; i < ref_points.size(); ++i) {
+    ref_points[i].curvature = 0.01 * std::sin(0.1 * static_cast<double>(i));
+    ref_points[i].delta_arc_length = 1.0;
+    ref_points[i].bounds.lower_bound = -1.5;
+    ref_points[i].bounds.upper_bound = 1.5;
+  }
+  return ref_points;
+}
+
+void benchCalcMatrix(const size_t iterations)
+{
+  StateEquationGenerator generator(2.79, 0.7);
+  const auto ref_points = makeRefPoints(100);
+  for (size_t i = 0; i < iterations; ++i) {
+    const auto mat = generator.calcMatrix(ref_points);
+    doNotOptimize(mat.B.data());
+  }
+}
+
+void benchCubicSpline(const size_t iterations)
+{
+  std::vector<double> s(100);
+  std::vector<double> x(100);
+  std::vector<double> y(100);
+  for (size_t i = 0; i < s.size(); ++i) {
+    s[i] = static_cast<double>(i);
+    x[i] = static_cast<double>(i);
+    y[i] = 2.0 * std::sin(s[i] / 20.0);
+  }
+  std::vector<double> query(500);
+  for (size_t i = 0; i < query.size(); ++i) {
+    query[i] = 99.0 * static_cast<double>(i) / 499.0;
+  }
+  std::vector<double> out_x(query.size());
+  std::vector<double> out_y(query.size());
+  CubicSpline2D spline;
+  for (size_t i = 0; i < iterations; ++i) {
+    spline.calcSplineCoefficients(s, x, y);
+    spline.evaluate(
+      query.data(), query.size(), out_x.data(), out_y.data(), nullptr, nullptr, nullptr, nullptr);
+    doNotOptimize(out_y.data());
+  }
+}
+
+void benchResample(const size_t iterations)
+{
+  const auto input = makeTrajectory(200, 1.0);
+  std::vector<TrajectoryPoint> output;
+  TrajectoryResampler resampler;
+  for (size_t i = 0; i < iterations; ++i) {
+    resampler.resample(input, 0.2, output);
+    doNotOptimize(output.data());
+  }
+}
+
+// Arc length, heading and curvature of a resampled path, from the points or from its spline
+void benchPathGeometry(const size_t iterations, const bool spline_variant)
+{
+  const auto points = makeTrajectory(1000, 0.2);
+  std::vector<double> s(points.size());
+  std::vector<double> x(points.size());
+  std::vector<double> y(points.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    x[i] = points[i].pose.position.x;
+    y[i] = points[i].pose.position.y;
+    s[i] = i == 0 ? 0.0 : s[i - 1] + std::hypot(x[i] - x[i - 1], y[i] - y[i - 1]);
+  }
+  CubicSpline2D spline;
+  spline.calcSplineCoefficients(s, x, y);
+  PathGeometry geometry;
+  for (size_t i = 0; i < iterations; ++i) {
+    if (spline_variant) {
+      geometry.calc(spline, s);
+    } else {
+      geometry.calc(points);
+    }
+    doNotOptimize(geometry.getCurvature().data());
+  }
+}
+
+// Ego moving slowly along the trajectory, the previous result is the hint
+void benchNearestSegment(const size_t iterations)
+{
+  const auto points = makeTrajectory(1000, 0.5);
+  const TrajectoryIndex index(points);
+  size_t hint = 0;
+  for (size_t i = 0; i < iterations; ++i) {
+    auto p = points[(i / 4) % points.size()].pose.position;
+    p.y += 0.3;
+    hint = index.findNearestSegmentIndex(p, hint);
+    doNotOptimize(hint);
+  }
+}
+
+#ifdef USE_OSQP
+// Banded box constrained QP of the size of an MPT problem
+void benchOsqp(const size_t iterations)
+{
+  using autoware::path_optimizer::calCSCMatrix;
+  using autoware::path_optimizer::calCSCMatrixTrapezoidal;
+  using autoware::path_optimizer::OSQPInterface;
+
+  constexpr int n = 200;
+  Eigen::SparseMatrix<double, Eigen::ColMajor> P(n, n);
+  Eigen::SparseMatrix<double, Eigen::ColMajor> A(n, n);
+  for (int i = 0; i < n; ++i) {
+    P.insert(i, i) = 2.0;
+    if (i + 1 < n) {
+      P.insert(i, i + 1) = -0.5;
+      P.insert(i + 1, i) = -0.5;
+    }
+    A.insert(i, i) = 1.0;
+  }
+  P.makeCompressed();
+  A.makeCompressed();
+  const auto P_csc = calCSCMatrixTrapezoidal(P);
+  const auto A_csc = calCSCMatrix(A);
+  std::vector<double> q(n);
+  for (int i = 0; i < n; ++i) {
+    q[i] = std::sin(0.1 * i);
+  }
+  const std::vector<double> l(n, -0.2);
+  const std::vector<double> u(n, 0.2);
+  for (size_t i = 0; i < iterations; ++i) {
+    OSQPInterface solver(P_csc, A_csc, q, l, u, 1e-4);
+    const auto result = solver.optimize();
+    doNotOptimize(std::get<0>(result).data());
+  }
+}
+#endif
+
+// Upper triangle of the OSQP KKT matrix [P + sigma I, A^T; A, -1/rho I] with the default sigma
+// and rho; its LDL^T factorization is the dominant setup cost of OSQP
+Eigen::SparseMatrix<double, Eigen::ColMajor> makeKKTMatrix(const MPTQPBuilder::Problem & problem)
+{
+  constexpr double sigma = 1e-6;
+  constexpr double rho = 0.1;
+  const auto n = static_cast<Eigen::Index>(problem.q.size());
+  const auto m = static_cast<Eigen::Index>(problem.l.size());
+  std::vector<Eigen::Triplet<double>> triplets;
+  triplets.reserve(problem.P.m_vals.size() + problem.A.m_vals.size() + n + m);
+  for (Eigen::Index col = 0; col < n; ++col) {
+    triplets.emplace_back(col, col, sigma);
+    for (auto k = problem.P.m_col_idxs[col]; k < problem.P.m_col_idxs[col + 1]; ++k) {
+      triplets.emplace_back(problem.P.m_row_idxs[k], col, problem.P.m_vals[k]);
+    }
+    for (auto k = problem.A.m_col_idxs[col]; k < problem.A.m_col_idxs[col + 1]; ++k) {
+      triplets.emplace_back(col, n + problem.A.m_row_idxs[k], problem.A.m_vals[k]);
+    }
+  }
+  for (Eigen::Index row = 0; row < m; ++row) {
+    triplets.emplace_back(n + row, n + row, -1.0 / rho);
+  }
+  Eigen::SparseMatrix<double, Eigen::ColMajor> kkt(n + m, n + m);
+  kkt.setFromTriplets(triplets.begin(), triplets.end());
+  return kkt;
+}
+
+// Reference points on makeTrajectory, drivable area 2 m to the left and 1.5 m to the right
+void benchBounds(const size_t iterations)
+{
+  std::vector<ReferencePoint> ref_points(100);
+  const auto path = makeTrajectory(100, 1.0);
+  for (size_t i = 0; i < ref_points.size(); ++i) {
+    ref_points[i].pose = path[i].pose;
+  }
+  std::vector<autoware::path_optimizer::Point> left_bound;
+  std::vector<autoware::path_optimizer::Point> right_bound;
+  for (const auto & p : makeTrajectory(400, 0.3)) {
+    const double yaw = 2.0 * std::atan2(p.pose.orientation.z, p.pose.orientation.w);
+    auto left = p.pose.position;
+    auto right = p.pose.position;
+    left.x -= 2.0 * std::sin(yaw);
+    left.y += 2.0 * std::cos(yaw);
+    right.x += 1.5 * std::sin(yaw);
+    right.y -= 1.5 * std::cos(yaw);
+    left_bound.push_back(left);
+    right_bound.push_back(right);
+  }
+  const std::vector<double> circle_offsets{-1.0, 1.0, 3.0};
+  BoundsCalculator calculator;
+  for (size_t i = 0; i < iterations; ++i) {
+    calculator.calcBoundsOnCircles(ref_points, left_bound, right_bound, circle_offsets);
+    doNotOptimize(ref_points.back().bounds_on_constraints.data());
+  }
+}
+
+// Corridor of a 200 point trajectory against 200 vehicle footprints (4.8 x 2 m) scattered over
+// +-20 m around it, about 1 in 10 overlapping
+void benchCorridorGrid(const size_t iterations)
+{
+  const auto traj_points = makeTrajectory(200, 0.5);
+  std::vector<std::vector<autoware::path_optimizer::Point>> footprints(200);
+  for (size_t m = 0; m < footprints.size(); ++m) {
+    const double cx = 0.5 * static_cast<double>(m);
+    const double cy = 2.0 * std::sin(cx / 20.0) + 20.0 * std::sin(1.7 * static_cast<double>(m));
+    const double yaw = 0.3 * static_cast<double>(m);
+    for (const auto & [lx, ly] : {std::pair{2.4, 1.0}, {-2.4, 1.0}, {-2.4, -1.0}, {2.4, -1.0}}) {
+      footprints[m].push_back(
+        {cx + std::cos(yaw) * lx - std::sin(yaw) * ly, cy + std::sin(yaw) * lx + std::cos(yaw) * ly,
+         0.0});
+    }
+  }
+  TrajectoryCorridorGrid grid;
+  for (size_t i = 0; i < iterations; ++i) {
+    grid.build(traj_points, 1.5);
+    size_t num_hits = 0;
+    for (const auto & footprint : footprints) {
+      num_hits += grid.intersects(footprint) ? 1 : 0;
+    }
+    doNotOptimize(num_hits);
+  }
+}
+
+// Ego footprints at all trajectory poses against a set of box obstacles, batched SAT kernel
+void benchFootprintCollision(const size_t iterations)
+{
+  const auto traj_points = makeTrajectory(200, 0.5);
+  autoware::path_optimizer::VehicleInfo vehicle_info{};
+  vehicle_info.wheel_base_m = 2.79;
+  vehicle_info.vehicle_width_m = 1.92;
+  vehicle_info.front_overhang_m = 0.96;
+  vehicle_info.rear_overhang_m = 1.02;
+  std::vector<CollisionPolygon> obstacles(50);
+  for (size_t m = 0; m < obstacles.size(); ++m) {
+    const double cx = 2.0 * static_cast<double>(m);
+    const double cy = 2.0 * std::sin(cx / 20.0) + 4.0 * std::sin(1.7 * static_cast<double>(m));
+    const double yaw = 0.3 * static_cast<double>(m);
+    std::vector<autoware::path_optimizer::Point> polygon;
+    for (const auto & [lx, ly] : {std::pair{2.4, 1.0}, {-2.4, 1.0}, {-2.4, -1.0}, {2.4, -1.0}}) {
+      polygon.push_back(
+        {cx + std::cos(yaw) * lx - std::sin(yaw) * ly, cy + std::sin(yaw) * lx + std::cos(yaw) * ly,
+         0.0});
+    }
+    obstacles[m].assign(polygon);
+  }
+  FootprintBatch footprints;
+  std::vector<uint8_t> collides;
+  for (size_t i = 0; i < iterations; ++i) {
+    footprints.assign(traj_points, vehicle_info, 0.1);
+    size_t num_hits = 0;
+    for (const auto & obstacle : obstacles) {
+      num_hits += autoware::path_optimizer::checkFootprintCollision(footprints, obstacle, collides);
+    }
+    doNotOptimize(num_hits);
+  }
+}
+
+// Problem build and KKT factorization of one MPT QP formulation, header only
+BenchmarkFunction benchQPFormulation(const MPTQPFormulation formulation, const size_t num_points)
+{
+  return [formulation, num_points](const size_t iterations) {
+    StateEquationGenerator generator(2.79, 0.7);
+    const auto ref_points = makeRefPoints(num_points);
+    MPTQPBuilder builder(formulation);
+    MPTQPBuilder::Problem problem;
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double, Eigen::ColMajor>, Eigen::Upper> ldlt;
+    for (size_t i = 0; i < iterations; ++i) {
+      builder.build(generator, ref_points, Eigen::Vector2d(0.5, 0.1), problem);
+      ldlt.compute(makeKKTMatrix(problem));
+      doNotOptimize(ldlt.info());
+    }
+  };
+}
+
+// Sparse MPT QP solved by the stage-wise Riccati ADMM solver, cold start
+void benchRiccatiADMM(const size_t iterations, const size_t num_points)
+{
+  StateEquationGenerator generator(2.79, 0.7);
+  const auto ref_points = makeRefPoints(num_points);
+  MPTQPBuilder builder(MPTQPFormulation::SPARSE);
+  builder.setInputLimit(0.1);
+  MPTQPBuilder::Problem problem;
+  autoware::path_optimizer::RiccatiADMMBackend backend(1e-4);
+  for (size_t i = 0; i < iterations; ++i) {
+    builder.build(generator, ref_points, Eigen::Vector2d(0.5, 0.1), problem);
+    backend.setProblem(problem.P, problem.A, problem.q, problem.l, problem.u);
+    const auto result = backend.solve();
+    doNotOptimize(result.primal.data());
+  }
+}
+
+// Elastic band over a window of makeTrajectory with a +-0.4 m wiggle (the band hits its 0.5 m
+// clearance), moving by one point per cycle; the 3 fixed points are taken from the last band
+enum class BandStart { COLD, WARM, REUSE };
+
+void benchElasticBand(const size_t iterations, const BandStart band_start)
+{
+  constexpr size_t num_points = 100;
+  auto path = makeTrajectory(400, 1.0);
+  for (auto & p : path) {
+    p.pose.position.y += 0.4 * std::sin(0.7 * p.pose.position.x);
+  }
+  std::vector<double> clearance(num_points, 0.5);
+  std::fill(clearance.begin(), clearance.begin() + 3, 0.0);
+  std::vector<TrajectoryPoint> window(num_points);
+  std::vector<autoware::path_optimizer::Point> band;
+  ElasticBandQP band_qp;
+  int qp_iterations = 0;
+  for (size_t i = 0; i < iterations; ++i) {
+    const size_t start = i % (path.size() - num_points);
+    std::copy_n(path.begin() + start, num_points, window.begin());
+    for (size_t j = 0; start > 0 && j < 3; ++j) {
+      window[j].pose.position.x = band[j + 1].x;
+      window[j].pose.position.y = band[j + 1].y;
+    }
+    band_qp.setProblem(window, clearance);
+    if (start > 0) {
+      const auto & p0 = path[start - 1].pose.position;
+      const auto & p1 = path[start].pose.position;
+      const double travel = std::hypot(p1.x - p0.x, p1.y - p0.y);
+      if (band_start == BandStart::WARM) {
+        band_qp.shiftWarmStart(travel);
+      } else if (band_start == BandStart::REUSE) {
+        band_qp.fixUnchangedPrefix(travel);
+      }
+    }
+    band_qp.solve(band, qp_iterations);
+    doNotOptimize(band.data());
+  }
+}
+
+#ifdef USE_OSQP
+// Complete OSQP setup and solve of one MPT QP formulation
+BenchmarkFunction benchQPFormulationSolve(
+  const MPTQPFormulation formulation, const size_t num_points)
+{
+  return [formulation, num_points](const size_t iterations) {
+    StateEquationGenerator generator(2.79, 0.7);
+    const auto ref_points = makeRefPoints(num_points);
+    MPTQPBuilder builder(formulation);
+    MPTQPBuilder::Problem problem;
+    for (size_t i = 0; i < iterations; ++i) {
+      builder.build(generator, ref_points, Eigen::Vector2d(0.5, 0.1), problem);
+      autoware::path_optimizer::OSQPInterface solver(
+        problem.P, problem.A, problem.q, problem.l, problem.u, 1e-4);
+      const auto result = solver.optimize();
+      doNotOptimize(std::get<0>(result).data());
+    }
+  };
+}
+#endif
+
+std::vector<Benchmark> pathOptimizerBenchmarks()
+{
+  std::vector<Benchmark> benchmarks{
+    {"StateEquationGenerator::calcMatrix/100", benchCalcMatrix},
+    {"CubicSpline2D::fit+evaluate/100->500", benchCubicSpline},
+    {"TrajectoryResampler::resample/200->1000", benchResample},
+    {"TrajectoryIndex::findNearestSegmentIndex/hint", benchNearestSegment},
+    {"PathGeometry::calc/three_point/1000",
+     [](const size_t iterations) { benchPathGeometry(iterations, false); }},
+    {"PathGeometry::calc/spline/1000",
+     [](const size_t iterations) { benchPathGeometry(iterations, true); }},
+    {"BoundsCalculator::calcBoundsOnCircles/100x3", benchBounds},
+    {"TrajectoryCorridorGrid::build+intersects/200x200", benchCorridorGrid},
+    {"checkFootprintCollision/200x50", benchFootprintCollision},
+    {"ElasticBandQP::solve/cold/100",
+     [](const size_t iterations) { benchElasticBand(iterations, BandStart::COLD); }},
+    {"ElasticBandQP::solve/warm/100",
+     [](const size_t iterations) { benchElasticBand(iterations, BandStart::WARM); }},
+    {"ElasticBandQP::solve/reuse_prefix/100",
+     [](const size_t iterations) { benchElasticBand(iterations, BandStart::REUSE); }},
+  };
+#ifdef USE_OSQP
+  benchmarks.push_back({"OSQPInterface::optimize/200", benchOsqp});
+#endif
+
+  // Condensed vs sparse MPT QP over the horizon size (number of reference points)
+  const std::pair<const char *, MPTQPFormulation> formulations[] = {
+    {"condensed", MPTQPFormulation::CONDENSED}, {"sparse", MPTQPFormulation::SPARSE}};
+  for (const size_t num_points : {25U, 50U, 100U, 200U}) {
+    for (const auto & [name, formulation] : formulations) {
+      const std::string suffix = std::string(name) + "/" + std::to_string(num_points);
+      benchmarks.push_back(
+        {"MPTQPBuilder::build+LDLT/" + suffix, benchQPFormulation(formulation, num_points)});
+#ifdef USE_OSQP
+      benchmarks.push_back(
+        {"MPTQPBuilder::build+OSQP/" + suffix, benchQPFormulationSolve(formulation, num_points)});
+#endif
+    }
+    benchmarks.push_back(
+      {"RiccatiADMMBackend::solve/sparse/" + std::to_string(num_points),
+       [num_points](const size_t iterations) { benchRiccatiADMM(iterations, num_points); }});
+  }
+  return benchmarks;
+}
+
+#ifdef USE_LANELET2
+std::vector<Benchmark> lanelet2Benchmarks(const std::string & map_path)
+{
+  std::vector<Benchmark> benchmarks;
+
+  // Tags of a typical line string: built by the OSM parser, then looked up by enum and by string
+  benchmarks.push_back({"AttributeMap::build+find/6", [](const size_t iterations) {
+    const std::string ele = "ele";
+    const std::string width = "width";
+    const std::string one_way = "one_way";
+    for (size_t i = 0; i < iterations; ++i) {
+      lanelet::AttributeMap attributes;
+      attributes[lanelet::AttributeName::Type] = "line_thin";
+      attributes[lanelet::AttributeName::Subtype] = "solid";
+      attributes[ele] = "12.5";
+      attributes[width] = "0.15";
+      attributes[lanelet::AttributeName::Location] = "urban";
+      attributes["name"] = "boundary";
+      size_t hits = 0;
+      hits += attributes.find(lanelet::AttributeName::Subtype) != attributes.end() ? 1 : 0;
+      hits += attributes.find(width) != attributes.end() ? 1 : 0;
+      hits += attributes.find(one_way) != attributes.end() ? 1 : 0;
+      doNotOptimize(hits);
+    }
+  }});
+
+  if (map_path.empty()) {
+    std::fprintf(stderr, "lanelet2 map benchmarks skipped: no --map given\n");
+    return benchmarks;
+  }
+  const lanelet::projection::UtmProjector projector(lanelet::Origin({0.0, 0.0}));
+
+  benchmarks.push_back({"lanelet::load/osm", [map_path, projector](const size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+      const auto map = lanelet::load(map_path, projector);
+      doNotOptimize(map.get());
+    }
+  }});
+
+  std::shared_ptr<lanelet::LaneletMap> map{lanelet::load(map_path, projector)};
+  if (map->laneletLayer.empty()) {
+    return benchmarks;
+  }
+
+  // The attribute lookups of the traffic rules and planners, for every line string of the map
+  const std::string name_attr_query =
+    "AttributeMap::find/" + std::to_string(map->lineStringLayer.size()) + "x3";
+  benchmarks.push_back({name_attr_query, [map](const size_t iterations) {
+    const std::string lane_change = "lane_change";
+    for (size_t i = 0; i < iterations; ++i) {
+      size_t hits = 0;
+      for (const auto & ls : map->lineStringLayer) {
+        const auto & attributes = ls.attributes();
+        hits += attributes.find(lanelet::AttributeName::Type) != attributes.end() ? 1 : 0;
+        hits += attributes.find(lanelet::AttributeName::Subtype) != attributes.end() ? 1 : 0;
+        hits += attributes.find(lane_change) != attributes.end() ? 1 : 0;
+      }
+      doNotOptimize(hits);
+    }
+  }});
+
+  benchmarks.push_back({"PrimitiveLayer::nearest/5", [map](const size_t iterations) {
+    const lanelet::BasicPoint2d origin = map->pointLayer.begin()->basicPoint2d();
+    for (size_t i = 0; i < iterations; ++i) {
+      const lanelet::BasicPoint2d query =
+        origin + lanelet::BasicPoint2d(static_cast<double>(i % 100), 0.0);
+      const auto nearest = map->pointLayer.nearest(query, 5);
+      doNotOptimize(nearest.data());
+    }
+  }});
+
+  const auto traffic_rules = lanelet::traffic_rules::TrafficRulesFactory::create(
+    lanelet::Locations::Germany, lanelet::Participants::Vehicle);
+  std::shared_ptr<lanelet::routing::RoutingGraph> graph{
+    lanelet::routing::RoutingGraph::build(*map, *traffic_rules)};
+
+  // Route to the lanelet with the longest shortest path from the first lanelet
+  const lanelet::ConstLanelet from = *map->laneletLayer.begin();
+  lanelet::ConstLanelet to = from;
+  size_t longest = 0;
+  for (const auto & llt : graph->reachableSet(from, 0)) {
+    if (const auto path = graph->shortestPath(from, llt); path && path->size() > longest) {
+      longest = path->size();
+      to = llt;
+    }
+  }
+
+  const std::string name = "RoutingGraph::shortestPath/" + std::to_string(longest);
+  benchmarks.push_back({name, [graph, from, to](const size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+      const auto path = graph->shortestPath(from, to);
+      doNotOptimize(path);
+    }
+  }});
+
+  return benchmarks;
+}
+#endif
+
+Options parseArgs(const int argc, char ** argv)
+{
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--min-time-ms" && has_value) {
+      options.min_time_ms = std::atof(argv[++i]);
+    } else if (arg == "--repetitions" && has_value) {
+      options.repetitions = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--filter" && has_value) {
+      options.filter = argv[++i];
+    } else if (arg == "--json" && has_value) {
+      options.json_output = argv[++i];
+    } else if (arg == "--map" && has_value) {
+      options.map_path = argv[++i];
+    } else if (arg == "--perf") {
+      options.perf = true;
+    } else {
+      std::fprintf(
+        stderr,
+        "Usage: %s [--filter <substring>] [--min-time-ms <ms>] [--repetitions <n>] "
+        "[--json <file>] [--map <osm file>] [--perf]\n",
+        argv[0]);
+      std::exit(arg == "--help" ? 0 : 1);
+    }
+  }
+  return options;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  const auto options = parseArgs(argc, argv);
+
+  auto benchmarks = pathOptimizerBenchmarks();
+#ifdef USE_LANELET2
+  auto lanelet2 = lanelet2Benchmarks(options.map_path);
+  benchmarks.insert(benchmarks.end(), lanelet2.begin(), lanelet2.end());
+#endif
+
+  // Counters of the main thread, which runs all benchmarks; without a PMU only the times remain
+  std::unique_ptr<PerfCounterGroup> perf_counters;
+  if (options.perf) {
+    perf_counters = std::make_unique<PerfCounterGroup>();
+    if (!perf_counters->valid()) {
+      std::fprintf(stderr, "--perf ignored: %s\n", perf_counters->error().c_str());
+      perf_counters.reset();
+    }
+  }
+
+  std::vector<Result> results;
+  std::printf(
+    "%-50s %12s %14s %14s %14s", "Benchmark", "Iterations", "Mean [ns]", "p50 [ns]", "p99 [ns]");
+  if (perf_counters) {
+    std::printf(
+      " %14s %14s %6s %12s %12s", "Cycles", "Instructions", "IPC", "LLC misses", "Br. misses");
+  }
+  std::printf("\n");
+  for (const auto & benchmark : benchmarks) {
+    if (!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos) {
+      continue;
+    }
+    const auto result = runBenchmark(benchmark, options, perf_counters.get());
+    std::printf(
+      "%-50s %12zu %14.1f %14.1f %14.1f", result.name.c_str(), result.iterations, result.mean_ns,
+      result.p50_ns, result.p99_ns);
+    if (const auto & c = result.counters; c.valid) {
+      std::printf(
+        " %14.1f %14.1f %6.2f %12.2f %12.2f", c.cycles, c.instructions, c.ipc(), c.cache_misses,
+        c.branch_misses);
+    }
+    std::printf("\n");
+    results.push_back(result);
+  }
+
+  // One JSON object per line, the same layout as the other trace files of tool/
+  if (!options.json_output.empty()) {
+    std::ofstream file(options.json_output);
+    for (const auto & r : results) {
+      file << "{\"name\":\"" << r.name << "\",\"iterations\":" << r.iterations
+           << ",\"mean_ns\":" << r.mean_ns << ",\"p50_ns\":" << r.p50_ns
+           << ",\"p99_ns\":" << r.p99_ns;
+      if (const auto & c = r.counters; c.valid) {
+        file << ",\"cycles\":" << c.cycles << ",\"instructions\":" << c.instructions
+             << ",\"ipc\":" << c.ipc() << ",\"cache_misses\":" << c.cache_misses
+             << ",\"branch_misses\":" << c.branch_misses;
+      }
+      file << "}\n";
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""
+Compare two benchmark runs, e.g. a baseline and a PGO build (tool/PGOBuild.sh).
+
+Inputs are either
+  - benchmark JSONL files written by planning_benchmark --json, one line per benchmark:
+      {"name": ..., "iterations": ..., "mean_ns": ..., "p50_ns": ..., "p99_ns": ...}
+    with --perf also "cycles", "instructions", "ipc", "cache_misses" and "branch_misses" per iteration
+  - or per-stage latency CSV files written by analyze_stage_latency.py (Stage, Metric, p50 [ms],
+    p99 [ms], Max [ms], Mean [ms]), to compare the replayed pipeline before and after.
+
+Output: mean/p50/p99 of both runs and the speedup (baseline / candidate, > 1 is faster), printed
+and saved as CSV. If both runs have hardware counters, their values and the ratio (candidate /
+baseline, < 1 is fewer) follow, so a speedup can be told apart as fewer instructions or fewer misses.
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+from pathlib import Path
+from typing import Dict, List
+
+import pandas as pd
+
+METRICS = ["mean", "p50", "p99"]
+COUNTERS = ["instructions", "ipc", "cache_misses", "branch_misses"]
+
+
+def parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description="Benchmark comparison")
+    parser.add_argument("--baseline", required=True, type=Path, help="Baseline run (.jsonl or .csv)")
+    parser.add_argument("--candidate", required=True, type=Path, help="Candidate run (.jsonl or .csv)")
+    parser.add_argument(
+        "--output",
+        type=Path,
+        default=None,
+        help="CSV file for the comparison (default: output/<candidate stem>_comparison.csv)",
+    )
+    return parser.parse_args()
+
+
+def load_run(path: Path) -> pd.DataFrame:
+    """One row per benchmark (or stage and metric) with the columns name, mean, p50, p99."""
+    if path.suffix == ".csv":
+        df = pd.read_csv(path)
+        return pd.DataFrame(
+            {
+                "name": df["Stage"] + "/" + df["Metric"],
+                "mean": df["Mean [ms]"],
+                "p50": df["p50 [ms]"],
+                "p99": df["p99 [ms]"],
+            }
+        )
+    records: List[Dict] = []
+    with path.open() as f:
+        for line_num, line in enumerate(f, start=1):
+            stripped = line.strip()
+            if not stripped:
+                continue
+            try:
+                records.append(json.loads(stripped))
+            except json.JSONDecodeError as exc:
+                raise ValueError(f"Invalid JSON on line {line_num} of {path}") from exc
+    if not records:
+        raise ValueError(f"No results found in {path}")
+    df = pd.DataFrame.from_records(records)
+    run = pd.DataFrame({"name": df["name"], "mean": df["mean_ns"], "p50": df["p50_ns"], "p99": df["p99_ns"]})
+    for counter in COUNTERS:
+        if counter in df:
+            run[counter] = df[counter]
+    return run
+
+
+def compare(baseline: pd.DataFrame, candidate: pd.DataFrame) -> pd.DataFrame:
+    merged = baseline.merge(candidate, on="name", suffixes=(" base", " new"))
+    for metric in METRICS:
+        merged[f"{metric} speedup"] = merged[f"{metric} base"] / merged[f"{metric} new"]
+    columns = ["name"] + [f"{m} {s}" for m in METRICS for s in ["base", "new", "speedup"]]
+    for counter in COUNTERS:
+        if counter in baseline and counter in candidate:
+            merged[f"{counter} ratio"] = merged[f"{counter} new"] / merged[f"{counter} base"]
+            columns += [f"{counter} {s}" for s in ["base", "new", "ratio"]]
+    return merged[columns]
+
+
+def main() -> None:
+    args = parse_args()
+
+    comparison = compare(load_run(args.baseline), load_run(args.candidate))
+
+    with pd.option_context("display.max_rows", None, "display.width", 200):
+        print(comparison.to_string(index=False, float_format=lambda v: f"{v:.3f}"))
+    speedups = comparison["p50 speedup"].dropna()
+    if not speedups.empty:
+        geomean = float(speedups.prod() ** (1.0 / len(speedups)))
+        print(f"\nGeometric mean p50 speedup: {geomean:.3f}")
+
+    output = args.output or Path("output") / f"{args.candidate.stem}_comparison.csv"
+    output.parent.mkdir(parents=True, exist_ok=True)
+    comparison.to_csv(output, index=False, float_format="%.4f")
+
+
+if __name__ == "__main__":
+    main()
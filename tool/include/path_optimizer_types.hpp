@@ -0,0 +1,129 @@
+// Planner types for building the tools without the path_optimizer sources
+#ifndef PATH_OPTIMIZER__PATH_OPTIMIZER_TYPES_HPP_
+#define PATH_OPTIMIZER__PATH_OPTIMIZER_TYPES_HPP_
+
+// The installed path_optimizer_types.hpp is part of the path_optimizer package. The scripts in tool/
+// put this directory after $INSTALL/include, and the include guard is the same, so the installed
+// header wins whenever it is there. This copy has the fields the headers in build/install/include
+// use, laid out as the autoware messages they come from. It is only for the header-only tools:
+// do not link objects built against it with libpath_optimizer_lib.
+
+#include <Eigen/Core>
+
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace autoware::path_optimizer
+{
+
+struct Point
+{
+  double x{0.0};
+  double y{0.0};
+  double z{0.0};
+};
+
+struct Quaternion
+{
+  double x{0.0};
+  double y{0.0};
+  double z{0.0};
+  double w{1.0};
+};
+
+struct Pose
+{
+  Point position;
+  Quaternion orientation;
+};
+
+struct Duration
+{
+  int32_t sec{0};
+  uint32_t nanosec{0};
+};
+
+struct TrajectoryPoint
+{
+  Duration time_from_start;
+  Pose pose;
+  double longitudinal_velocity_mps{0.0};
+  double lateral_velocity_mps{0.0};
+  double acceleration_mps2{0.0};
+  double heading_rate_rps{0.0};
+  double front_wheel_angle_rad{0.0};
+  double rear_wheel_angle_rad{0.0};
+};
+
+struct Bounds
+{
+  double lower_bound{0.0};
+  double upper_bound{0.0};
+};
+
+struct KinematicState
+{
+  double lat{0.0};
+  double yaw{0.0};
+
+  Eigen::Vector2d toEigenVector() const { return Eigen::Vector2d{lat, yaw}; }
+};
+
+struct ReferencePoint
+{
+  Pose pose;
+  double longitudinal_velocity_mps{0.0};
+
+  // additional information
+  double curvature{0.0};
+  double delta_arc_length{0.0};
+  double alpha{0.0};                          // for minimizing lateral error
+  Bounds bounds{};                            // bounds on pose
+  std::vector<std::optional<double>> beta{};  // for collision-free constraint
+  double normalized_avoidance_cost{0.0};
+
+  // bounds and its local pose on each avoidance circle
+  std::vector<Bounds> bounds_on_constraints{};
+  std::vector<Pose> pose_on_constraints{};
+
+  // optimization result
+  std::optional<KinematicState> fixed_kinematic_state{};
+  KinematicState optimized_kinematic_state{};
+  double optimized_input{0.0};
+
+  double getYaw() const
+  {
+    const auto & q = pose.orientation;
+    return std::atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+  }
+};
+
+struct MPTParam
+{
+  int num_points{100};
+  double delta_arc_length{1.0};
+  double max_steer_rad{0.7};
+};
+
+struct VehicleInfo
+{
+  double wheel_base_m{2.79};
+  double max_steer_angle_rad{0.7};
+  double vehicle_width_m{1.92};
+  double vehicle_length_m{4.89};
+  double front_overhang_m{1.0};
+  double rear_overhang_m{1.1};
+};
+
+struct ReplanCheckerParam
+{
+  double max_path_shape_change_dist{0.3};
+  double max_ego_moving_dist{5.0};
+  double max_delta_time_sec{1.0};
+};
+
+}  // namespace autoware::path_optimizer
+
+#endif  // PATH_OPTIMIZER__PATH_OPTIMIZER_TYPES_HPP_
@@ -0,0 +1,41 @@
+# Profile-guided optimization for the planning executables and the lanelet2 libraries
+#
+# Injected into the source tree's configure without editing its CMakeLists.txt:
+#   cmake -S <src> -B build-pgo -DCMAKE_BUILD_TYPE=Release \
+#         -DCMAKE_PROJECT_INCLUDE=<repo>/tool/pgo.cmake -DPLANNING_PGO=generate \
+#         -DPLANNING_PGO_DIR=/tmp/planning-pgo
+#   ... build, install, run the training replays (see tool/PGOBuild.sh) ...
+#   cmake -S <src> -B build-pgo -DPLANNING_PGO=use && cmake --build build-pgo
+#
+# generate: instrumented binaries write .gcda profiles to PLANNING_PGO_DIR at exit (one file per
+#           object, named after the mangled object path, so all processes of a replay can share
+#           the directory).
+# use     : optimizes with the profiles; objects without a profile (code not reached by the
+#           replays) are built as without PGO instead of as cold code.
+#
+# The profiles are found by object path, so both steps have to use the same build directory.
+
+set(PLANNING_PGO "off" CACHE STRING "Profile-guided optimization: off, generate or use")
+set_property(CACHE PLANNING_PGO PROPERTY STRINGS off generate use)
+set(PLANNING_PGO_DIR "${CMAKE_BINARY_DIR}/pgo-profiles" CACHE PATH "Directory of the PGO profiles")
+
+if(PLANNING_PGO STREQUAL "generate")
+  file(MAKE_DIRECTORY "${PLANNING_PGO_DIR}")
+  file(WRITE "${PLANNING_PGO_DIR}/build_dir.txt" "${CMAKE_BINARY_DIR}")
+  add_compile_options(-fprofile-generate=${PLANNING_PGO_DIR} -fprofile-update=atomic)
+  add_link_options(-fprofile-generate=${PLANNING_PGO_DIR})
+elseif(PLANNING_PGO STREQUAL "use")
+  if(NOT EXISTS "${PLANNING_PGO_DIR}/build_dir.txt")
+    message(FATAL_ERROR "PLANNING_PGO=use: no profiles in ${PLANNING_PGO_DIR}")
+  endif()
+  file(READ "${PLANNING_PGO_DIR}/build_dir.txt" PLANNING_PGO_BUILD_DIR)
+  if(NOT PLANNING_PGO_BUILD_DIR STREQUAL CMAKE_BINARY_DIR)
+    message(FATAL_ERROR
+      "PLANNING_PGO=use: the profiles were generated in ${PLANNING_PGO_BUILD_DIR}, use that build directory")
+  endif()
+  add_compile_options(
+    -fprofile-use=${PLANNING_PGO_DIR} -fprofile-partial-training -Wno-missing-profile)
+  add_link_options(-fprofile-use=${PLANNING_PGO_DIR})
+elseif(NOT PLANNING_PGO STREQUAL "off")
+  message(FATAL_ERROR "PLANNING_PGO must be off, generate or use, not ${PLANNING_PGO}")
+endif()
@@ -0,0 +1,1149 @@
+// Headless trajectory-on-map renderer, the native replacement of
+// tool/visualize_lanelet2_trajectory_points.py for scenario sweeps
+//
+// Renders the same animation (lanelet map, trajectory points of one message per frame colored by
+// velocity, vehicle outline, start/goal markers, trajectory frequency) from .trjb records
+// (trajectory_record.hpp; convert JSONL recordings with tool/trajectory_record.py) into
+// output/<name>_visual.gif:
+//
+//   ./trajectory_renderer --map lanelet2_map.osm --scenario 1 Scenario_1_1.trjb Scenario_1_2.trjb
+//
+// Where the time goes in the Python tool and what is done instead:
+//   - The map is loaded with lanelet2_io and rasterized once per viewport into a base layer that
+//     is cached on disk (output/cache, keyed by map file, size, mtime, viewport and image size).
+//     With a cached base layer the map is not loaded at all, and all files of a run share it.
+//   - Frames are drawn into 8-bit palette images (white, map, grid, markers and a 248 entry
+//     velocity color map), so GIF encoding needs no color quantization.
+//   - Frames are rendered and LZW encoded in parallel (--threads). Each frame after the first only
+//     encodes the rectangle that changed against the previous frame (the points and vehicle of both
+//     frames), the rest is kept by the GIF "do not dispose" mode.
+//
+// Plot constants (anchoring, manual map offset, start/goal, fixed bounds) are the ones of the
+// Python tool and have to be kept in sync with it. Only the frequency and the color bar range are
+// written as text; axes ticks and the title are left out.
+//
+// Build with tool/TrajRender.sh.
+
+#include "trajectory_record.hpp"
+
+#include <lanelet2_core/LaneletMap.h>
+#include <lanelet2_io/Io.h>
+#include <lanelet2_io/Projection.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using autoware::path_optimizer::TrajectoryRecordReader;
+
+// ---------------------------------------------------------------------------------------------
+// Plot constants of visualize_lanelet2_trajectory_points.py
+// ---------------------------------------------------------------------------------------------
+constexpr double manual_dx = -50.4;
+constexpr double manual_dy = 7.2;
+constexpr double ref_start_x = 3708.456298828125;
+constexpr double ref_start_y = 73666.421875;
+constexpr std::array<double, 2> start_point = {3733.0, 73679.0};
+const std::map<int, std::array<double, 2>> goals = {
+  {1, {3831.229, 73730.367}}, {2, {3770.879, 73729.656}}, {3, {3831.229, 73730.367}}};
+const std::map<int, std::array<double, 4>> fixed_bounds = {  // xmin, xmax, ymin, ymax
+  {1, {3703.456298828125, 3812.3225495931997, 73661.421875, 73722.95039384908}},
+  {2, {3703.456298828125, 3762.1529604873735, 73661.421875, 73722.23938998018}},
+  {3, {3703.456298828125, 3812.3225495931997, 73661.421875, 73722.95039382219}}};
+
+constexpr uint32_t base_layer_version = 1;
+
+struct Options
+{
+  std::string map_path;
+  std::vector<std::string> trajectory_files;
+  int scenario{0};
+  int width{2000};
+  int height{1600};
+  size_t max_frames{400};
+  size_t frame_step{1};
+  double t_max{-1.0};
+  double dx{0.0};
+  double dy{0.0};
+  int fps{20};
+  unsigned threads{std::max(1U, std::thread::hardware_concurrency())};
+  std::string output_dir{"output"};
+  std::optional<double> origin_lat;
+  std::optional<double> origin_lon;
+};
+
+// ---------------------------------------------------------------------------------------------
+// Palette images
+// ---------------------------------------------------------------------------------------------
+enum Color : uint8_t {
+  White = 0,
+  MapGray = 1,   // "0.7", alpha 0.8
+  GridGray = 2,  // dashed grid, alpha 0.5
+  Marker = 3,    // magenta, alpha 0.5
+  Vehicle = 4,   // black, alpha 0.4
+  Black = 5,
+  Frame = 6,
+  ColorMapBegin = 8,
+};
+constexpr int color_map_size = 256 - ColorMapBegin;
+
+std::array<uint8_t, 768> makePalette()
+{
+  std::array<uint8_t, 768> palette{};
+  auto set = [&palette](const int i, const int r, const int g, const int b) {
+    palette[3 * i] = static_cast<uint8_t>(r);
+    palette[3 * i + 1] = static_cast<uint8_t>(g);
+    palette[3 * i + 2] = static_cast<uint8_t>(b);
+  };
+  set(White, 255, 255, 255);
+  set(MapGray, 194, 194, 194);
+  set(GridGray, 223, 223, 223);
+  set(Marker, 255, 128, 255);
+  set(Vehicle, 153, 153, 153);
+  set(Black, 0, 0, 0);
+  set(Frame, 38, 38, 38);
+  set(7, 255, 255, 255);
+  // matplotlib RdYlGn anchors, linearly interpolated
+  static constexpr int anchors[11][3] = {{165, 0, 38},    {215, 48, 39},   {244, 109, 67},
+                                         {253, 174, 97},  {254, 224, 139}, {255, 255, 191},
+                                         {217, 239, 139}, {166, 217, 106}, {102, 189, 99},
+                                         {26, 152, 80},   {0, 104, 55}};
+  for (int i = 0; i < color_map_size; ++i) {
+    const double u = 10.0 * i / (color_map_size - 1);
+    const int a = std::min(static_cast<int>(u), 9);
+    const double f = u - a;
+    int rgb[3];
+    for (int c = 0; c < 3; ++c) {
+      const double value = anchors[a][c] + f * (anchors[a + 1][c] - anchors[a][c]);
+      rgb[c] = static_cast<int>(std::lround(value));
+    }
+    set(ColorMapBegin + i, rgb[0], rgb[1], rgb[2]);
+  }
+  return palette;
+}
+
+struct Rect
+{
+  int x0{0}, y0{0}, x1{0}, y1{0};  // [x0, x1) x [y0, y1)
+
+  bool empty() const { return x1 <= x0 || y1 <= y0; }
+  void extend(const Rect & other)
+  {
+    if (other.empty()) {
+      return;
+    }
+    if (empty()) {
+      *this = other;
+      return;
+    }
+    x0 = std::min(x0, other.x0);
+    y0 = std::min(y0, other.y0);
+    x1 = std::max(x1, other.x1);
+    y1 = std::max(y1, other.y1);
+  }
+  Rect clipped(const int w, const int h) const
+  {
+    return {std::max(x0, 0), std::max(y0, 0), std::min(x1, w), std::min(y1, h)};
+  }
+};
+
+struct Image
+{
+  int width{0};
+  int height{0};
+  std::vector<uint8_t> pixels;
+
+  void set(const int x, const int y, const uint8_t c)
+  {
+    if (x >= 0 && y >= 0 && x < width && y < height) {
+      pixels[static_cast<size_t>(y) * width + x] = c;
+    }
+  }
+
+  void line(double x0, double y0, const double x1, const double y1, const uint8_t c,
+            const int dash = 0)
+  {
+    const double length = std::hypot(x1 - x0, y1 - y0);
+    const int steps = std::max(1, static_cast<int>(std::ceil(length)));
+    for (int i = 0; i <= steps; ++i) {
+      if (dash > 0 && (i / dash) % 2 == 1) {
+        continue;
+      }
+      const double t = static_cast<double>(i) / steps;
+      set(static_cast<int>(std::lround(x0 + t * (x1 - x0))),
+          static_cast<int>(std::lround(y0 + t * (y1 - y0))), c);
+    }
+  }
+
+  void fillRect(const Rect & r, const uint8_t c)
+  {
+    const Rect clip = r.clipped(width, height);
+    for (int y = clip.y0; y < clip.y1; ++y) {
+      std::fill_n(pixels.begin() + static_cast<size_t>(y) * width + clip.x0, clip.x1 - clip.x0, c);
+    }
+  }
+
+  Rect fillCircle(const double cx, const double cy, const double r, const uint8_t c)
+  {
+    const int y0 = static_cast<int>(std::floor(cy - r));
+    const int y1 = static_cast<int>(std::ceil(cy + r));
+    for (int y = y0; y <= y1; ++y) {
+      const double dy = y - cy;
+      const double half = r * r - dy * dy;
+      if (half < 0.0) {
+        continue;
+      }
+      const double w = std::sqrt(half);
+      const int x1 = static_cast<int>(std::floor(cx + w));
+      for (int x = static_cast<int>(std::ceil(cx - w)); x <= x1; ++x) {
+        set(x, y, c);
+      }
+    }
+    return {static_cast<int>(std::floor(cx - r)), y0, static_cast<int>(std::ceil(cx + r)) + 1,
+            y1 + 1};
+  }
+
+  // Even-odd scanline fill
+  Rect fillPolygon(const std::vector<std::array<double, 2>> & polygon, const uint8_t c)
+  {
+    Rect box;
+    if (polygon.size() < 3) {
+      return box;
+    }
+    double ymin = polygon[0][1];
+    double ymax = ymin;
+    double xmin = polygon[0][0];
+    double xmax = xmin;
+    for (const auto & p : polygon) {
+      ymin = std::min(ymin, p[1]);
+      ymax = std::max(ymax, p[1]);
+      xmin = std::min(xmin, p[0]);
+      xmax = std::max(xmax, p[0]);
+    }
+    std::vector<double> crossings;
+    for (int y = static_cast<int>(std::ceil(ymin)); y <= static_cast<int>(std::floor(ymax)); ++y) {
+      crossings.clear();
+      for (size_t i = 0; i < polygon.size(); ++i) {
+        const auto & a = polygon[i];
+        const auto & b = polygon[(i + 1) % polygon.size()];
+        if ((a[1] <= y) != (b[1] <= y)) {
+          crossings.push_back(a[0] + (y - a[1]) * (b[0] - a[0]) / (b[1] - a[1]));
+        }
+      }
+      std::sort(crossings.begin(), crossings.end());
+      for (size_t i = 0; i + 1 < crossings.size(); i += 2) {
+        for (int x = static_cast<int>(std::ceil(crossings[i]));
+             x <= static_cast<int>(std::floor(crossings[i + 1])); ++x) {
+          set(x, y, c);
+        }
+      }
+    }
+    return {static_cast<int>(std::floor(xmin)), static_cast<int>(std::floor(ymin)),
+            static_cast<int>(std::ceil(xmax)) + 1, static_cast<int>(std::ceil(ymax)) + 1};
+  }
+
+  // 5x7 glyphs of the characters the plot needs, scaled by scale; returns the covered rectangle
+  Rect text(const int x, const int y, const std::string & s, const int scale, const uint8_t c)
+  {
+    static const std::map<char, std::array<uint8_t, 7>> glyphs = {
+      {'0', {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}},
+      {'1', {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}},
+      {'2', {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}},
+      {'3', {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}},
+      {'4', {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}},
+      {'5', {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}},
+      {'6', {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}},
+      {'7', {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}},
+      {'8', {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}},
+      {'9', {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}},
+      {'.', {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}},
+      {'-', {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}},
+      {'[', {0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E}},
+      {']', {0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E}},
+      {'/', {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00}},
+      {'A', {0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}},
+      {'H', {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}},
+      {'N', {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}},
+      {'h', {0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x11}},
+      {'k', {0x10, 0x10, 0x12, 0x14, 0x18, 0x14, 0x12}},
+      {'m', {0x00, 0x00, 0x1A, 0x15, 0x15, 0x11, 0x11}},
+      {'z', {0x00, 0x00, 0x1F, 0x02, 0x04, 0x08, 0x1F}}};
+    for (size_t i = 0; i < s.size(); ++i) {
+      const auto glyph = glyphs.find(s[i]);
+      if (glyph == glyphs.end()) {
+        continue;
+      }
+      const int gx = x + static_cast<int>(i) * 6 * scale;
+      for (int row = 0; row < 7; ++row) {
+        for (int col = 0; col < 5; ++col) {
+          if ((glyph->second[row] >> (4 - col)) & 1U) {
+            const int px = gx + col * scale;
+            const int py = y + row * scale;
+            fillRect({px, py, px + scale, py + scale}, c);
+          }
+        }
+      }
+    }
+    return {x, y, x + static_cast<int>(s.size()) * 6 * scale, y + 7 * scale};
+  }
+};
+
+// ---------------------------------------------------------------------------------------------
+// Viewport: world coordinates to pixels with equal aspect, axes box and color bar on the right
+// ---------------------------------------------------------------------------------------------
+struct Viewport
+{
+  std::array<double, 4> bounds{};  // xmin, xmax, ymin, ymax
+  int width{0};
+  int height{0};
+  double scale{1.0};  // pixels per meter
+  double left{0.0};
+  double top{0.0};
+  Rect axes;
+  Rect color_bar;
+
+  Viewport(const std::array<double, 4> & b, const int w, const int h)
+  : bounds(b), width(w), height(h)
+  {
+    const double margin = 0.06 * std::min(w, h);
+    const double bar = 0.05 * w;
+    const double avail_w = w - 2.0 * margin - bar;
+    const double avail_h = h - 2.0 * margin;
+    scale = std::min(avail_w / (b[1] - b[0]), avail_h / (b[3] - b[2]));
+    left = margin + 0.5 * (avail_w - scale * (b[1] - b[0]));
+    top = margin + 0.5 * (avail_h - scale * (b[3] - b[2]));
+    axes = {static_cast<int>(left), static_cast<int>(top),
+            static_cast<int>(std::ceil(left + scale * (b[1] - b[0]))),
+            static_cast<int>(std::ceil(top + scale * (b[3] - b[2])))};
+    const int bar_x = axes.x1 + static_cast<int>(0.01 * w);
+    color_bar = {bar_x, axes.y0, bar_x + static_cast<int>(0.02 * w), axes.y1};
+  }
+
+  double px(const double x) const { return left + (x - bounds[0]) * scale; }
+  double py(const double y) const { return top + (bounds[3] - y) * scale; }
+};
+
+// ---------------------------------------------------------------------------------------------
+// Map loading and the cached base layer
+// ---------------------------------------------------------------------------------------------
+
+// Local east/north meters around an origin, as the azimuthal equidistant projection of the
+// Python tool (equal within millimeters over the extent of a map)
+class EnuProjector : public lanelet::Projector
+{
+public:
+  explicit EnuProjector(const lanelet::GPSPoint & origin)
+  : lanelet::Projector(lanelet::Origin(origin)), origin_(origin)
+  {
+    constexpr double a = 6378137.0;
+    constexpr double e2 = 6.69437999014e-3;
+    const double lat = origin.lat * M_PI / 180.0;
+    const double w = std::sqrt(1.0 - e2 * std::sin(lat) * std::sin(lat));
+    meters_per_deg_lat_ = a * (1.0 - e2) / (w * w * w) * M_PI / 180.0;
+    meters_per_deg_lon_ = a / w * std::cos(lat) * M_PI / 180.0;
+  }
+
+  lanelet::BasicPoint3d forward(const lanelet::GPSPoint & p) const override
+  {
+    return {(p.lon - origin_.lon) * meters_per_deg_lon_,
+            (p.lat - origin_.lat) * meters_per_deg_lat_, p.ele};
+  }
+  lanelet::GPSPoint reverse(const lanelet::BasicPoint3d & p) const override
+  {
+    return {origin_.lat + p.y() / meters_per_deg_lat_, origin_.lon + p.x() / meters_per_deg_lon_,
+            p.z()};
+  }
+
+private:
+  lanelet::GPSPoint origin_;
+  double meters_per_deg_lat_{1.0};
+  double meters_per_deg_lon_{1.0};
+};
+
+// lat/lon of the first node of an OSM file, the default origin of the Python tool
+std::optional<lanelet::GPSPoint> firstNode(const std::string & osm_path)
+{
+  std::ifstream file(osm_path);
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.find("<node") == std::string::npos) {
+      continue;
+    }
+    auto attribute = [&line](const std::string & name) -> std::optional<double> {
+      const auto pos = line.find(" " + name + "=");
+      if (pos == std::string::npos) {
+        return std::nullopt;
+      }
+      return std::atof(line.c_str() + pos + name.size() + 3);
+    };
+    const auto lat = attribute("lat");
+    const auto lon = attribute("lon");
+    if (lat && lon) {
+      return lanelet::GPSPoint{*lat, *lon, 0.0};
+    }
+  }
+  return std::nullopt;
+}
+
+using Polylines = std::vector<std::vector<std::array<double, 2>>>;
+
+// All line strings and polygons of the map in the plot frame (anchored as the Python tool)
+Polylines loadMapPolylines(const Options & options)
+{
+  auto origin = firstNode(options.map_path).value_or(lanelet::GPSPoint{0.0, 0.0, 0.0});
+  if (options.origin_lat) {
+    origin.lat = *options.origin_lat;
+  }
+  if (options.origin_lon) {
+    origin.lon = *options.origin_lon;
+  }
+  lanelet::ErrorMessages errors;
+  const auto map = lanelet::load(options.map_path, EnuProjector(origin), &errors);
+  if (!errors.empty()) {
+    std::fprintf(
+      stderr, "%zu warnings while loading %s\n", errors.size(), options.map_path.c_str());
+  }
+
+  Polylines polylines;
+  auto add = [&polylines](const auto & points) {
+    if (points.size() < 2) {
+      return;
+    }
+    polylines.emplace_back();
+    for (const auto & p : points) {
+      polylines.back().push_back({p.x(), p.y()});
+    }
+  };
+  for (const auto & ls : map->lineStringLayer) {
+    add(ls);
+  }
+  for (const auto & polygon : map->polygonLayer) {
+    add(polygon);
+    polylines.back().push_back(polylines.back().front());
+  }
+
+  // anchor the mean of all points to the reference start, then the manual offset
+  double sum_x = 0.0;
+  double sum_y = 0.0;
+  size_t n = 0;
+  for (const auto & pl : polylines) {
+    for (const auto & p : pl) {
+      sum_x += p[0];
+      sum_y += p[1];
+      ++n;
+    }
+  }
+  const double shift_x = n > 0 ? ref_start_x - sum_x / n + manual_dx : 0.0;
+  const double shift_y = n > 0 ? ref_start_y - sum_y / n + manual_dy : 0.0;
+  for (auto & pl : polylines) {
+    for (auto & p : pl) {
+      p[0] += shift_x;
+      p[1] += shift_y;
+    }
+  }
+  return polylines;
+}
+
+// Grid line spacing with about 5 to 10 lines across the extent (1, 2, 5 * 10^k)
+double niceStep(const double extent)
+{
+  const double raw = extent / 6.0;
+  const double magnitude = std::pow(10.0, std::floor(std::log10(raw)));
+  for (const double f : {1.0, 2.0, 5.0}) {
+    if (f * magnitude >= raw) {
+      return f * magnitude;
+    }
+  }
+  return 10.0 * magnitude;
+}
+
+Image rasterizeBase(const Polylines & polylines, const Viewport & view)
+{
+  Image image{view.width, view.height,
+              std::vector<uint8_t>(static_cast<size_t>(view.width) * view.height, White)};
+  const auto & b = view.bounds;
+  const double dash = std::max(2, view.width / 400);
+  for (const int axis : {0, 1}) {
+    const double lo = b[2 * axis];
+    const double hi = b[2 * axis + 1];
+    const double step = niceStep(hi - lo);
+    for (double v = std::ceil(lo / step) * step; v <= hi; v += step) {
+      if (axis == 0) {
+        image.line(view.px(v), view.axes.y0, view.px(v), view.axes.y1, GridGray, dash);
+      } else {
+        image.line(view.axes.x0, view.py(v), view.axes.x1, view.py(v), GridGray, dash);
+      }
+    }
+  }
+  for (const auto & pl : polylines) {
+    for (size_t i = 0; i + 1 < pl.size(); ++i) {
+      image.line(view.px(pl[i][0]), view.py(pl[i][1]), view.px(pl[i + 1][0]), view.py(pl[i + 1][1]),
+                 MapGray);
+    }
+  }
+  // everything outside the axes is background, as the map is clipped by the axes in matplotlib
+  image.fillRect({0, 0, view.width, view.axes.y0}, White);
+  image.fillRect({0, view.axes.y1, view.width, view.height}, White);
+  image.fillRect({0, 0, view.axes.x0, view.height}, White);
+  image.fillRect({view.axes.x1, 0, view.width, view.height}, White);
+  const auto & a = view.axes;
+  image.line(a.x0, a.y0, a.x1, a.y0, Frame);
+  image.line(a.x0, a.y1, a.x1, a.y1, Frame);
+  image.line(a.x0, a.y0, a.x0, a.y1, Frame);
+  image.line(a.x1, a.y0, a.x1, a.y1, Frame);
+
+  const auto & bar = view.color_bar;
+  for (int y = bar.y0; y < bar.y1; ++y) {
+    const double u = static_cast<double>(bar.y1 - 1 - y) / std::max(1, bar.y1 - bar.y0 - 1);
+    const auto c = static_cast<uint8_t>(ColorMapBegin + std::lround(u * (color_map_size - 1)));
+    image.fillRect({bar.x0, y, bar.x1, y + 1}, c);
+  }
+  return image;
+}
+
+uint64_t fnv1a(uint64_t hash, const void * data, const size_t size)
+{
+  const auto * bytes = static_cast<const uint8_t *>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+std::string baseLayerPath(const Options & options, const Viewport & view)
+{
+  struct stat st{};
+  ::stat(options.map_path.c_str(), &st);
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  hash = fnv1a(hash, options.map_path.data(), options.map_path.size());
+  const int64_t file[2] = {static_cast<int64_t>(st.st_size), static_cast<int64_t>(st.st_mtime)};
+  hash = fnv1a(hash, file, sizeof(file));
+  hash = fnv1a(hash, view.bounds.data(), sizeof(view.bounds));
+  const int32_t size[2] = {view.width, view.height};
+  hash = fnv1a(hash, size, sizeof(size));
+  const double origin[2] = {options.origin_lat.value_or(NAN), options.origin_lon.value_or(NAN)};
+  hash = fnv1a(hash, origin, sizeof(origin));
+  hash = fnv1a(hash, &base_layer_version, sizeof(base_layer_version));
+  char name[64];
+  std::snprintf(name, sizeof(name), "/base_%016llx.bin", static_cast<unsigned long long>(hash));
+  return options.output_dir + "/cache" + name;
+}
+
+bool readBaseLayer(const std::string & path, Image & image)
+{
+  std::ifstream file(path, std::ios::binary);
+  int32_t size[2] = {0, 0};
+  if (!file.read(reinterpret_cast<char *>(size), sizeof(size)) || size[0] != image.width ||
+      size[1] != image.height) {
+    return false;
+  }
+  image.pixels.resize(static_cast<size_t>(size[0]) * size[1]);
+  const auto bytes = static_cast<std::streamsize>(image.pixels.size());
+  return static_cast<bool>(file.read(reinterpret_cast<char *>(image.pixels.data()), bytes));
+}
+
+void writeBaseLayer(const std::string & path, const Image & image)
+{
+  const std::string tmp = path + ".tmp";
+  std::ofstream file(tmp, std::ios::binary);
+  const int32_t size[2] = {image.width, image.height};
+  file.write(reinterpret_cast<const char *>(size), sizeof(size));
+  file.write(reinterpret_cast<const char *>(image.pixels.data()),
+             static_cast<std::streamsize>(image.pixels.size()));
+  file.close();
+  if (file) {
+    std::rename(tmp.c_str(), path.c_str());  // atomic for parallel runs of the sweep
+  }
+}
+
+// ---------------------------------------------------------------------------------------------
+// GIF encoding (LZW, 8 bit codes, global palette)
+// ---------------------------------------------------------------------------------------------
+class LzwEncoder
+{
+public:
+  // Appends the image data sub-blocks of pixels (LZW minimum code size 8)
+  void encode(const uint8_t * pixels, const size_t n, std::vector<uint8_t> & out)
+  {
+    bytes_.clear();
+    bit_buffer_ = 0;
+    bit_count_ = 0;
+    reset();
+    emit(clear_code);
+    if (n > 0) {
+      uint32_t prefix = pixels[0];
+      for (size_t i = 1; i < n; ++i) {
+        const uint32_t c = pixels[i];
+        const uint32_t key = (prefix << 8U) | c;
+        uint32_t slot = (key * 2654435761U) >> (32U - table_bits);
+        while (keys_[slot] != empty_key && keys_[slot] != key) {
+          slot = (slot + 1) & (table_size - 1);
+        }
+        if (keys_[slot] == key) {
+          prefix = codes_[slot];
+          continue;
+        }
+        emit(prefix);
+        if (next_code_ < 4096) {
+          keys_[slot] = key;
+          codes_[slot] = static_cast<uint16_t>(next_code_);
+          if (next_code_ == (1U << code_size_) && code_size_ < 12) {
+            ++code_size_;
+          }
+          ++next_code_;
+        } else {
+          emit(clear_code);
+          reset();
+        }
+        prefix = c;
+      }
+      emit(prefix);
+    }
+    emit(end_code);
+    if (bit_count_ > 0) {
+      bytes_.push_back(static_cast<uint8_t>(bit_buffer_));
+    }
+    out.push_back(8);
+    for (size_t i = 0; i < bytes_.size(); i += 255) {
+      const size_t len = std::min<size_t>(255, bytes_.size() - i);
+      out.push_back(static_cast<uint8_t>(len));
+      out.insert(out.end(), bytes_.begin() + i, bytes_.begin() + i + len);
+    }
+    out.push_back(0);
+  }
+
+private:
+  static constexpr uint32_t clear_code = 256;
+  static constexpr uint32_t end_code = 257;
+  static constexpr uint32_t table_bits = 14;  // about a quarter full with 4096 codes
+  static constexpr uint32_t table_size = 1U << table_bits;
+  static constexpr uint32_t empty_key = 0xFFFFFFFFU;
+
+  void reset()
+  {
+    keys_.assign(table_size, empty_key);
+    codes_.resize(table_size);
+    next_code_ = 258;
+    code_size_ = 9;
+  }
+
+  // The code width grows after the decoder has added the code of the previous step, so the
+  // width is checked when a new code is added (see encode)
+  void emit(const uint32_t code)
+  {
+    bit_buffer_ |= code << bit_count_;
+    bit_count_ += code_size_;
+    while (bit_count_ >= 8) {
+      bytes_.push_back(static_cast<uint8_t>(bit_buffer_));
+      bit_buffer_ >>= 8U;
+      bit_count_ -= 8;
+    }
+  }
+
+  std::vector<uint32_t> keys_;
+  std::vector<uint16_t> codes_;
+  std::vector<uint8_t> bytes_;
+  uint32_t next_code_{258};
+  uint32_t code_size_{9};
+  uint32_t bit_buffer_{0};
+  uint32_t bit_count_{0};
+};
+
+void put16(std::vector<uint8_t> & out, const int v)
+{
+  out.push_back(static_cast<uint8_t>(v & 0xFF));
+  out.push_back(static_cast<uint8_t>((v >> 8) & 0xFF));
+}
+
+// Graphic control extension (do not dispose) and image descriptor + data of the rectangle
+void encodeFrame(const Image & image, const Rect & rect, const int delay_cs, LzwEncoder & lzw,
+                 std::vector<uint8_t> & crop, std::vector<uint8_t> & out)
+{
+  out.insert(out.end(), {0x21, 0xF9, 0x04, 0x04});
+  put16(out, delay_cs);
+  out.insert(out.end(), {0x00, 0x00});
+  out.push_back(0x2C);
+  put16(out, rect.x0);
+  put16(out, rect.y0);
+  put16(out, rect.x1 - rect.x0);
+  put16(out, rect.y1 - rect.y0);
+  out.push_back(0x00);
+  crop.resize(static_cast<size_t>(rect.x1 - rect.x0) * (rect.y1 - rect.y0));
+  for (int y = rect.y0; y < rect.y1; ++y) {
+    std::memcpy(crop.data() + static_cast<size_t>(y - rect.y0) * (rect.x1 - rect.x0),
+                image.pixels.data() + static_cast<size_t>(y) * image.width + rect.x0,
+                static_cast<size_t>(rect.x1 - rect.x0));
+  }
+  lzw.encode(crop.data(), crop.size(), out);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Trajectory messages and frames
+// ---------------------------------------------------------------------------------------------
+struct Message
+{
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<float> vel_kmh;
+  std::optional<double> stamp;
+  std::optional<double> freq;
+};
+
+std::vector<Message> loadMessages(const std::string & path, const double t_max)
+{
+  std::vector<Message> messages;
+  TrajectoryRecordReader reader(path);
+  TrajectoryRecordReader::Record record;
+  while (reader.next(record)) {
+    Message m;
+    for (size_t i = 0; i < record.x.size(); ++i) {
+      if (t_max >= 0.0 && record.time_from_start[i] > t_max) {
+        continue;
+      }
+      m.x.push_back(record.x[i]);
+      m.y.push_back(record.y[i]);
+      m.vel_kmh.push_back(record.longitudinal_velocity_mps[i] * 3.6F);
+    }
+    if (m.x.empty()) {
+      continue;
+    }
+    m.stamp = static_cast<double>(record.stamp_ns) * 1e-9;
+    messages.push_back(std::move(m));
+  }
+  for (size_t i = 1; i < messages.size(); ++i) {
+    const double delta = *messages[i].stamp - *messages[i - 1].stamp;
+    if (delta > 0.0) {
+      messages[i].freq = 1.0 / delta;
+    }
+  }
+  return messages;
+}
+
+// Message indices of the frames, as the Python tool (every frame_step-th, at most max_frames)
+std::vector<size_t> frameIndices(const size_t num_messages, const Options & options)
+{
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < num_messages; i += std::max<size_t>(options.frame_step, 1)) {
+    indices.push_back(i);
+  }
+  if (options.max_frames > 0 && indices.size() > options.max_frames) {
+    indices.resize(options.max_frames);
+    const double stride = options.max_frames > 1 ? static_cast<double>(num_messages - 1) /
+                                                     static_cast<double>(options.max_frames - 1)
+                                                 : 0.0;
+    for (size_t k = 0; k < options.max_frames; ++k) {
+      indices[k] = static_cast<size_t>(static_cast<double>(k) * stride);
+    }
+  }
+  return indices;
+}
+
+// Vehicle silhouette in the vehicle frame (rear center origin), as create_vehicle_shape
+std::vector<std::array<double, 2>> vehicleShape(const double length = 6.0, const double width = 2.5)
+{
+  const double half_w = width * 0.5;
+  const double rear_y = width * 0.35;
+  return {{length, 0.0},          {length * 0.8, half_w},  {length * 0.3, half_w}, {0.0, rear_y},
+          {0.0, -rear_y},         {length * 0.3, -half_w}, {length * 0.8, -half_w}};
+}
+
+std::string formatFreq(const std::optional<double> freq)
+{
+  char text[32];
+  if (freq) {
+    std::snprintf(text, sizeof(text), "%7.2f [Hz]", *freq);
+  } else {
+    std::snprintf(text, sizeof(text), "%7s [Hz]", "N/A");
+  }
+  return text;
+}
+
+struct Scene
+{
+  const Viewport * view;
+  const Image * layer;  // base layer with the markers and the color bar labels of the file
+  const std::vector<Message> * messages;
+  double vmin;
+  double vmax;
+  double freq_mean;
+  int point_radius_px;
+};
+
+// Draws the overlay of one message onto the layer; returns the changed rectangle
+Rect drawFrame(const Scene & scene, const Message & m, Image & image)
+{
+  const auto & view = *scene.view;
+  Rect dirty;
+  const size_t target = std::min<size_t>(9, m.x.size() - 1);
+  const double dx = m.x[target] - m.x[0];
+  const double dy = m.y[target] - m.y[0];
+  const double yaw = dx == 0.0 && dy == 0.0 ? 0.0 : std::atan2(dy, dx);
+  std::vector<std::array<double, 2>> vehicle = vehicleShape();
+  const double c = std::cos(yaw);
+  const double s = std::sin(yaw);
+  for (auto & p : vehicle) {
+    const double wx = m.x[0] + c * p[0] - s * p[1];
+    const double wy = m.y[0] + s * p[0] + c * p[1];
+    p = {view.px(wx), view.py(wy)};
+  }
+
+  // the points are drawn over the vehicle: the vehicle is translucent in the Python tool
+  dirty.extend(image.fillPolygon(vehicle, Vehicle));
+  const double range = std::max(scene.vmax - scene.vmin, 1e-6);
+  for (size_t i = 0; i < m.x.size(); ++i) {
+    const double u = std::clamp((m.vel_kmh[i] - scene.vmin) / range, 0.0, 1.0);
+    const auto color = static_cast<uint8_t>(ColorMapBegin + std::lround(u * (color_map_size - 1)));
+    const double px = view.px(m.x[i]);
+    const double py = view.py(m.y[i]);
+    if (px < view.axes.x0 || px >= view.axes.x1 || py < view.axes.y0 || py >= view.axes.y1) {
+      continue;
+    }
+    dirty.extend(image.fillCircle(px, py, scene.point_radius_px, color));
+  }
+
+  const int scale = std::max(1, view.width / 500);
+  auto freq = m.freq;
+  if (!freq && scene.freq_mean > 0.0) {
+    freq = scene.freq_mean;
+  }
+  const int x = view.axes.x0 + 4 * scale;
+  const int y = view.axes.y0 + 4 * scale;
+  dirty.extend(image.text(x, y, formatFreq(freq), scale, Black));
+  return dirty.clipped(view.width, view.height);
+}
+
+// Bounds of compute_bounds: trajectory, reference start and markers with a margin
+std::array<double, 4> computeBounds(const std::vector<Message> & messages,
+                                    const std::vector<std::array<double, 2>> & extra)
+{
+  double xmin = ref_start_x;
+  double xmax = ref_start_x;
+  double ymin = ref_start_y;
+  double ymax = ref_start_y;
+  auto add = [&](const double x, const double y) {
+    xmin = std::min(xmin, x);
+    xmax = std::max(xmax, x);
+    ymin = std::min(ymin, y);
+    ymax = std::max(ymax, y);
+  };
+  for (const auto & m : messages) {
+    for (size_t i = 0; i < m.x.size(); ++i) {
+      add(m.x[i], m.y[i]);
+    }
+  }
+  for (const auto & p : extra) {
+    add(p[0], p[1]);
+  }
+  const double mx = std::max(5.0, 0.05 * (xmax - xmin));
+  const double my = std::max(5.0, 0.05 * (ymax - ymin));
+  return {xmin - mx, xmax + mx, ymin - my, ymax + my};
+}
+
+std::string stem(const std::string & path)
+{
+  const auto slash = path.find_last_of('/');
+  std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+  const auto dot = name.find_last_of('.');
+  return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+double msSince(const std::chrono::steady_clock::time_point start)
+{
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+class Renderer
+{
+public:
+  explicit Renderer(const Options & options) : options_(options), palette_(makePalette()) {}
+
+  bool render(const std::string & trajectory_file)
+  {
+    const auto start_time = std::chrono::steady_clock::now();
+    auto messages = loadMessages(trajectory_file, options_.t_max);
+    if (messages.empty()) {
+      std::fprintf(stderr, "No trajectory points loaded from %s\n", trajectory_file.c_str());
+      return false;
+    }
+
+    // align the trajectory start to the reference start, as the Python tool
+    const double shift_x = ref_start_x - messages[0].x[0] + options_.dx;
+    const double shift_y = ref_start_y - messages[0].y[0] + options_.dy;
+    double vmin = std::numeric_limits<double>::max();
+    double vmax = std::numeric_limits<double>::lowest();
+    for (auto & m : messages) {
+      for (size_t i = 0; i < m.x.size(); ++i) {
+        m.x[i] += shift_x;
+        m.y[i] += shift_y;
+        vmin = std::min<double>(vmin, m.vel_kmh[i]);
+        vmax = std::max<double>(vmax, m.vel_kmh[i]);
+      }
+    }
+    if (std::abs(vmax - vmin) < 1e-9) {
+      vmax = vmin + 1e-6;
+    }
+    double freq_sum = 0.0;
+    size_t freq_count = 0;
+    for (const auto & m : messages) {
+      if (m.freq) {
+        freq_sum += *m.freq;
+        ++freq_count;
+      }
+    }
+    const std::array<double, 2> start = {start_point[0] + shift_x, start_point[1] + shift_y};
+    const auto & goal_raw = goals.at(options_.scenario);
+    const std::array<double, 2> goal = {goal_raw[0] + shift_x, goal_raw[1] + shift_y};
+
+    const auto fixed = fixed_bounds.find(options_.scenario);
+    const Viewport view(
+      fixed != fixed_bounds.end() ? fixed->second : computeBounds(messages, {start, goal}),
+      options_.width, options_.height);
+    Image layer = baseLayer(view);
+    const double load_ms = msSince(start_time);
+
+    // markers and color bar labels: once per file
+    const int scale = std::max(1, view.width / 500);
+    const double marker = 0.006 * view.width;
+    const double sx = view.px(start[0]);
+    const double sy = view.py(start[1]);
+    layer.fillRect({static_cast<int>(sx - marker), static_cast<int>(sy - marker),
+                    static_cast<int>(sx + marker), static_cast<int>(sy + marker)},
+                   Marker);
+    std::vector<std::array<double, 2>> star;
+    for (int k = 0; k < 10; ++k) {
+      const double r = (k % 2 == 0 ? 1.6 : 0.65) * marker;
+      const double angle = M_PI / 2 + k * M_PI / 5;
+      star.push_back(
+        {view.px(goal[0]) + r * std::cos(angle), view.py(goal[1]) - r * std::sin(angle)});
+    }
+    layer.fillPolygon(star, Marker);
+    char label[32];
+    std::snprintf(label, sizeof(label), "%.1f", vmax);
+    layer.text(view.color_bar.x1 + 2 * scale, view.color_bar.y0, label, scale, Black);
+    std::snprintf(label, sizeof(label), "%.1f", vmin);
+    layer.text(view.color_bar.x1 + 2 * scale, view.color_bar.y1 - 7 * scale, label, scale, Black);
+    layer.text(view.color_bar.x0, view.color_bar.y1 + 3 * scale, "km/h", scale, Black);
+
+    const Scene scene{&view, &layer, &messages, vmin, vmax,
+                      freq_count > 0 ? freq_sum / freq_count : 0.0,
+                      std::max(1, static_cast<int>(std::lround(view.width / 450.0)))};
+    const auto indices = frameIndices(messages.size(), options_);
+    const auto frames_start = std::chrono::steady_clock::now();
+    const auto encoded = encodeFrames(scene, indices);
+    const double frames_ms = msSince(frames_start);
+
+    const std::string gif_path = options_.output_dir + "/" + stem(trajectory_file) + "_visual.gif";
+    std::ofstream gif(gif_path, std::ios::binary);
+    std::vector<uint8_t> header = {'G', 'I', 'F', '8', '9', 'a'};
+    put16(header, view.width);
+    put16(header, view.height);
+    header.insert(header.end(), {0xF7, 0x00, 0x00});
+    header.insert(header.end(), palette_.begin(), palette_.end());
+    // loop forever (NETSCAPE2.0 application extension)
+    header.insert(header.end(), {0x21, 0xFF, 0x0B, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E', '2', '.',
+                                 '0', 0x03, 0x01, 0x00, 0x00, 0x00});
+    gif.write(
+      reinterpret_cast<const char *>(header.data()), static_cast<std::streamsize>(header.size()));
+    size_t bytes = header.size();
+    for (const auto & frame : encoded) {
+      gif.write(
+        reinterpret_cast<const char *>(frame.data()), static_cast<std::streamsize>(frame.size()));
+      bytes += frame.size();
+    }
+    gif.put(0x3B);
+    gif.close();
+    std::printf(
+      "Saved GIF animation to %s (%zu frames, %.1f MB, setup %.0f ms, frames %.0f ms, "
+      "total %.0f ms)\n",
+      gif_path.c_str(), indices.size(), bytes / 1e6, load_ms, frames_ms, msSince(start_time));
+    return static_cast<bool>(gif);
+  }
+
+private:
+  // Base layer of the viewport: from memory, the disk cache, or rasterized from the map
+  Image baseLayer(const Viewport & view)
+  {
+    const std::string path = baseLayerPath(options_, view);
+    const auto cached = base_layers_.find(path);
+    if (cached != base_layers_.end()) {
+      return cached->second;
+    }
+    Image image{view.width, view.height, {}};
+    if (!readBaseLayer(path, image)) {
+      if (!polylines_) {
+        const auto start = std::chrono::steady_clock::now();
+        polylines_ = loadMapPolylines(options_);
+        std::printf(
+          "Loaded %s (%zu line strings) in %.0f ms\n", options_.map_path.c_str(),
+          polylines_->size(), msSince(start));
+      }
+      image = rasterizeBase(*polylines_, view);
+      ::mkdir((options_.output_dir + "/cache").c_str(), 0755);
+      writeBaseLayer(path, image);
+    }
+    base_layers_.emplace(path, image);
+    return image;
+  }
+
+  // Renders and encodes the frames on options_.threads threads, in frame order
+  std::vector<std::vector<uint8_t>> encodeFrames(
+    const Scene & scene, const std::vector<size_t> & indices)
+  {
+    const auto & view = *scene.view;
+    const size_t n = indices.size();
+    const int delay_cs = std::max(1, static_cast<int>(std::lround(100.0 / options_.fps)));
+
+    // changed rectangles first (cheap), so that every frame knows the one of its predecessor,
+    // which it has to overwrite
+    std::vector<Rect> dirty(n);
+    std::vector<std::vector<uint8_t>> encoded(n);
+    std::atomic<size_t> next{0};
+    auto worker = [&](const bool encode) {
+      Image image = *scene.layer;
+      LzwEncoder lzw;
+      std::vector<uint8_t> crop;
+      for (size_t k = next.fetch_add(1); k < n; k = next.fetch_add(1)) {
+        const Rect rect = drawFrame(scene, (*scene.messages)[indices[k]], image);
+        // restores the layer below the overlay when done with the frame
+        const auto restore = [&image, &scene, &rect] {
+          for (int y = rect.y0; y < rect.y1; ++y) {
+            const size_t row = static_cast<size_t>(y) * image.width;
+            std::memcpy(
+              image.pixels.data() + row + rect.x0, scene.layer->pixels.data() + row + rect.x0,
+              static_cast<size_t>(rect.x1 - rect.x0));
+          }
+        };
+        if (!encode) {
+          dirty[k] = rect;
+          restore();
+          continue;
+        }
+        Rect region = rect;
+        if (k == 0) {
+          region = {0, 0, view.width, view.height};
+        } else {
+          region.extend(dirty[k - 1]);
+        }
+        if (region.empty()) {
+          region = {0, 0, 1, 1};
+        }
+        encodeFrame(image, region, delay_cs, lzw, crop, encoded[k]);
+        restore();
+      }
+    };
+    for (const bool encode : {false, true}) {
+      next = 0;
+      std::vector<std::thread> threads;
+      for (unsigned t = 1; t < options_.threads; ++t) {
+        threads.emplace_back(worker, encode);
+      }
+      worker(encode);
+      for (auto & t : threads) {
+        t.join();
+      }
+    }
+    return encoded;
+  }
+
+  const Options & options_;
+  std::array<uint8_t, 768> palette_;
+  std::optional<Polylines> polylines_;
+  std::map<std::string, Image> base_layers_;
+};
+
+void usage(const char * name)
+{
+  std::fprintf(
+    stderr,
+    "Usage: %s --map <lanelet2_map.osm> --scenario <1|2|3> [options] <trajectory.trjb>...\n"
+    "  --width <px>, --height <px>  image size (default 2000x1600)\n"
+    "  --max-frames <n>             maximum number of frames (default 400)\n"
+    "  --frame-step <n>             use every n-th message as a frame (default 1)\n"
+    "  --t-max <s>                  only points with time_from_start <= t-max\n"
+    "  --dx <m>, --dy <m>           offset added to the trajectory\n"
+    "  --origin-lat/--origin-lon    origin of the map projection (default: first node)\n"
+    "  --fps <n>                    frame rate (default 20)\n"
+    "  --threads <n>                render threads (default: all cores)\n"
+    "  --output-dir <dir>           output and cache directory (default output)\n",
+    name);
+}
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--map" && has_value) {
+      options.map_path = argv[++i];
+    } else if (arg == "--scenario" && has_value) {
+      options.scenario = std::atoi(argv[++i]);
+    } else if (arg == "--width" && has_value) {
+      options.width = std::max(64, std::atoi(argv[++i]));
+    } else if (arg == "--height" && has_value) {
+      options.height = std::max(64, std::atoi(argv[++i]));
+    } else if (arg == "--max-frames" && has_value) {
+      options.max_frames = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+    } else if (arg == "--frame-step" && has_value) {
+      options.frame_step = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+    } else if (arg == "--t-max" && has_value) {
+      options.t_max = std::atof(argv[++i]);
+    } else if (arg == "--dx" && has_value) {
+      options.dx = std::atof(argv[++i]);
+    } else if (arg == "--dy" && has_value) {
+      options.dy = std::atof(argv[++i]);
+    } else if (arg == "--origin-lat" && has_value) {
+      options.origin_lat = std::atof(argv[++i]);
+    } else if (arg == "--origin-lon" && has_value) {
+      options.origin_lon = std::atof(argv[++i]);
+    } else if (arg == "--fps" && has_value) {
+      options.fps = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--threads" && has_value) {
+      options.threads = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+    } else if (arg == "--output-dir" && has_value) {
+      options.output_dir = argv[++i];
+    } else if (!arg.empty() && arg[0] != '-') {
+      options.trajectory_files.push_back(arg);
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (
+    options.map_path.empty() || options.trajectory_files.empty() ||
+    goals.count(options.scenario) == 0) {
+    usage(argv[0]);
+    return 1;
+  }
+  ::mkdir(options.output_dir.c_str(), 0755);
+
+  Renderer renderer(options);
+  int failures = 0;
+  for (const auto & file : options.trajectory_files) {
+    try {
+      failures += renderer.render(file) ? 0 : 1;
+    } catch (const std::exception & e) {
+      std::fprintf(stderr, "%s: %s\n", file.c_str(), e.what());
+      ++failures;
+    }
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""
+Switch the execution manifests of the planning executables between the default and the real-time profile.
+
+Real-time profile:
+  - SCHED_FIFO with priorities in pipeline order: a later stage gets a higher priority, so a sample that
+    is already in flight is finished before the next input is taken up.
+  - Each executable pinned to one core of --cores (round robin); keep CM, the SOME/IP daemon and logging
+    on the remaining cores.
+  - PLANNING_RT_MLOCK=1 / PLANNING_RT_PREFAULT_HEAP_MB in the environment, read by
+    lockMemoryFromEnvironment() (realtime_setup.hpp) at startup.
+
+The manifests are edited in place and keep their layout; --profile default restores the generated values.
+
+Usage:
+  python3 rt_profile.py --profile rt --cores 2 3 4 5
+  python3 rt_profile.py --profile default
+"""
+
+from __future__ import annotations
+
+import argparse
+import re
+from pathlib import Path
+from typing import Dict, List
+
+DEFAULT_OPT_DIR = Path(__file__).resolve().parent.parent / "build" / "install" / "opt"
+
+# Upstream first
+PIPELINE_ORDER = [
+    "Exe_ServiceCreator",
+    "Exe_missionplanner",
+    "Exe_behaviorpathplanner",
+    "Exe_behaviorvelocityplanner",
+    "Exe_elasticbandsmoother",
+    "Exe_motionvelocityplanner",
+    "Exe_obstaclecruiseplanner",
+]
+
+
+def parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description="Real-time profile for the planning execution manifests")
+    parser.add_argument("--profile", required=True, choices=["rt", "default"], help="Profile to apply")
+    parser.add_argument(
+        "--cores",
+        nargs="+",
+        type=int,
+        default=[1],
+        help="Cores for the planning executables, assigned round robin in pipeline order (default: 1)",
+    )
+    parser.add_argument("--base-priority", type=int, default=60, help="SCHED_FIFO priority of the first stage")
+    parser.add_argument("--prefault-heap-mb", type=int, default=64, help="Heap prefaulted at startup")
+    parser.add_argument("--opt-dir", type=Path, default=DEFAULT_OPT_DIR, help="Install opt/ directory")
+    return parser.parse_args()
+
+
+def profile_values(args: argparse.Namespace, index: int) -> Dict[str, object]:
+    if args.profile == "default":
+        return {"policy": "other", "priority": "0", "core-affinity": [], "environment": []}
+    return {
+        "policy": "fifo",
+        "priority": str(args.base_priority + index),
+        "core-affinity": [args.cores[index % len(args.cores)]],
+        "environment": [("PLANNING_RT_MLOCK", "1"), ("PLANNING_RT_PREFAULT_HEAP_MB", str(args.prefault_heap_mb))],
+    }
+
+
+def replace_once(pattern: str, replacement: str, text: str, path: Path) -> str:
+    result, count = re.subn(pattern, replacement, text, count=1, flags=re.DOTALL)
+    if count != 1:
+        raise ValueError(f"{path}: pattern {pattern!r} not found")
+    return result
+
+
+def format_list(items: List[str], indent: str) -> str:
+    if not items:
+        return "[\n" + indent + "]"
+    return "[\n" + ",\n".join(indent + "    " + item for item in items) + "\n" + indent + "]"
+
+
+def apply_profile(path: Path, values: Dict[str, object]) -> None:
+    text = path.read_text()
+    text = replace_once(r'("policy" : )"[^"]*"', rf'\1"{values["policy"]}"', text, path)
+    text = replace_once(r'("priority" : )"[^"]*"', rf'\1"{values["priority"]}"', text, path)
+    cores = [str(c) for c in values["core-affinity"]]
+    text = replace_once(
+        r'("core-affinity" : )\[.*?\]', lambda m: m.group(1) + format_list(cores, "    "), text, path
+    )
+    env = [f'{{ "key" : "{k}", "value" : "{v}" }}' for k, v in values["environment"]]
+    text = replace_once(
+        r'(\t"environment-variables" : )\[.*?\]', lambda m: m.group(1) + format_list(env, "    \t"), text, path
+    )
+    path.write_text(text)
+
+
+def main() -> None:
+    args = parse_args()
+    for index, name in enumerate(PIPELINE_ORDER):
+        manifest = args.opt_dir / name / "etc" / "exec" / f"{name}.json"
+        values = profile_values(args, index)
+        apply_profile(manifest, values)
+        print(f"{name}: policy={values['policy']} priority={values['priority']} cores={values['core-affinity']}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+"""
+Reader and converter for binary trajectory record files (.trjb) written by TrajectoryRecordWriter
+(trajectory_record.hpp).
+
+Layout (little endian):
+  header : magic b"TRAJREC1"
+  record : size (uint32, bytes after this field), stamp_ns (int64), num_points (uint32),
+           x, y, z (float64 * num_points each),
+           yaw, longitudinal_velocity_mps, acceleration_mps2, time_from_start (float32 * num_points each)
+
+Usage as a converter (existing JSONL recordings -> .trjb):
+  python3 trajectory_record.py --input Scenario_1_1.jsonl --output Scenario_1_1.trjb
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import math
+import struct
+from pathlib import Path
+from typing import Dict, Iterator, List
+
+import numpy as np
+
+MAGIC = b"TRAJREC1"
+RECORD_HEADER = struct.Struct("<IqI")
+F64_COLUMNS = ["x", "y", "z"]
+F32_COLUMNS = ["yaw", "longitudinal_velocity_mps", "acceleration_mps2", "time_from_start"]
+POINT_SIZE = 8 * len(F64_COLUMNS) + 4 * len(F32_COLUMNS)
+
+
+def iter_records(path: Path) -> Iterator[Dict[str, object]]:
+    """
+    Yield one dict per record: stamp_ns (int) and one numpy array per column.
+    The arrays are views into the file contents, so loading costs one read of the file.
+    """
+    data = path.read_bytes()
+    if data[: len(MAGIC)] != MAGIC:
+        raise ValueError(f"{path} is not a trajectory record file")
+    offset = len(MAGIC)
+    while offset < len(data):
+        if offset + RECORD_HEADER.size > len(data):
+            raise ValueError(f"Truncated record header at byte {offset} of {path}")
+        size, stamp_ns, num_points = RECORD_HEADER.unpack_from(data, offset)
+        if size != RECORD_HEADER.size - 4 + num_points * POINT_SIZE:
+            raise ValueError(f"Corrupt record size at byte {offset} of {path}")
+        body = offset + RECORD_HEADER.size
+        if body + num_points * POINT_SIZE > len(data):
+            raise ValueError(f"Truncated record at byte {offset} of {path}")
+        record: Dict[str, object] = {"stamp_ns": stamp_ns}
+        for name in F64_COLUMNS:
+            record[name] = np.frombuffer(data, dtype="<f8", count=num_points, offset=body)
+            body += 8 * num_points
+        for name in F32_COLUMNS:
+            record[name] = np.frombuffer(data, dtype="<f4", count=num_points, offset=body)
+            body += 4 * num_points
+        yield record
+        offset = body
+
+
+def load_stamps_ns(path: Path) -> List[int]:
+    """Record stamps (nanoseconds) only, without touching the point columns."""
+    data = path.read_bytes()
+    if data[: len(MAGIC)] != MAGIC:
+        raise ValueError(f"{path} is not a trajectory record file")
+    stamps: List[int] = []
+    offset = len(MAGIC)
+    while offset + RECORD_HEADER.size <= len(data):
+        size, stamp_ns, _ = RECORD_HEADER.unpack_from(data, offset)
+        stamps.append(stamp_ns)
+        offset += 4 + size
+    return stamps
+
+
+def _json_stamp_ns(record: Dict) -> int:
+    if "timestamp" in record:
+        return int(record["timestamp"])
+    stamp = record.get("message", {}).get("header", {}).get("stamp", {})
+    return int(stamp.get("sec", 0)) * 1_000_000_000 + int(stamp.get("nanosec", 0))
+
+
+def _quaternion_to_yaw(q: Dict) -> float:
+    x, y, z, w = (float(q.get(k, 0.0)) for k in ("x", "y", "z", "w"))
+    return math.atan2(2.0 * (w * z + x * y), 1.0 - 2.0 * (y * y + z * z))
+
+
+def convert_jsonl(input_path: Path, output_path: Path) -> int:
+    """Convert a JSONL trajectory recording; returns the number of records written."""
+    count = 0
+    with input_path.open() as src, output_path.open("wb") as dst:
+        dst.write(MAGIC)
+        for line_num, line in enumerate(src, start=1):
+            stripped = line.strip()
+            if not stripped:
+                continue
+            try:
+                record = json.loads(stripped)
+            except json.JSONDecodeError as exc:
+                raise ValueError(f"Invalid JSON on line {line_num}") from exc
+            points = record.get("message", record).get("points", [])
+            columns: Dict[str, List[float]] = {name: [] for name in F64_COLUMNS + F32_COLUMNS}
+            for p in points:
+                pose = p.get("pose", {})
+                pos = pose.get("position", {})
+                t = p.get("time_from_start", {})
+                for name in F64_COLUMNS:
+                    columns[name].append(float(pos.get(name, 0.0)))
+                columns["yaw"].append(_quaternion_to_yaw(pose.get("orientation", {})))
+                columns["longitudinal_velocity_mps"].append(float(p.get("longitudinal_velocity_mps", 0.0)))
+                columns["acceleration_mps2"].append(float(p.get("acceleration_mps2", 0.0)))
+                columns["time_from_start"].append(float(t.get("sec", 0)) + float(t.get("nanosec", 0)) * 1e-9)
+            n = len(points)
+            dst.write(RECORD_HEADER.pack(RECORD_HEADER.size - 4 + n * POINT_SIZE, _json_stamp_ns(record), n))
+            for name in F64_COLUMNS:
+                dst.write(np.asarray(columns[name], dtype="<f8").tobytes())
+            for name in F32_COLUMNS:
+                dst.write(np.asarray(columns[name], dtype="<f4").tobytes())
+            count += 1
+    return count
+
+
+def parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description="Convert JSONL trajectory recordings to .trjb")
+    parser.add_argument("--input", required=True, type=Path, help="Trajectory JSONL file")
+    parser.add_argument(
+        "--output",
+        type=Path,
+        default=None,
+        help="Output .trjb file (default: input path with .trjb suffix)",
+    )
+    return parser.parse_args()
+
+
+def main() -> None:
+    args = parse_args()
+    output = args.output or args.input.with_suffix(".trjb")
+    count = convert_jsonl(args.input, output)
+    print(f"Wrote {count} records to {output}")
+
+
+if __name__ == "__main__":
+    main()
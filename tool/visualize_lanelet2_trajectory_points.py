@@ -23,6 +23,8 @@ from matplotlib.patches import Polygon
 from mpl_toolkits.axes_grid1 import make_axes_locatable
 from pyproj import Transformer
 
+from trajectory_record import iter_records
+
 # User-adjustable manual translation for the lanelet map (meters), tuned on trajectory2
 MANUAL_DX = -50.4
 MANUAL_DY = 7.2
@@ -167,7 +169,7 @@ def load_trajectory_file(
     path: Path, t_max: Optional[float] = None
 ) -> Tuple[np.ndarray, np.ndarray, np.ndarray, np.ndarray, List[Dict[str, object]], float]:
     """
-    Load trajectory messages from JSON or JSONL.
+    Load trajectory messages from JSON, JSONL or a .trjb record file.
     Returns:
         all_x, all_y, all_vel_kmh, all_time_from_start (concatenated for bounds/color scaling)
         messages: list of dicts with keys xs, ys, vels (km/h), times, timestamp_sec, delta_traj_sec, freq_traj_Hz.
@@ -181,8 +183,12 @@ def load_trajectory_file(
     messages: List[Dict[str, object]] = []
 
     def _process_message(msg: Dict) -> None:
-        timestamp_sec = _extract_timestamp_sec(msg)
         xs, ys, vels, times = _extract_points_from_message(msg)
+        _add_points(_extract_timestamp_sec(msg), xs, ys, vels, times)
+
+    def _add_points(
+        timestamp_sec: Optional[float], xs: np.ndarray, ys: np.ndarray, vels: np.ndarray, times: np.ndarray
+    ) -> None:
         if t_max is not None:
             mask = times <= t_max
             xs, ys, vels, times = xs[mask], ys[mask], vels[mask], times[mask]
@@ -203,7 +209,16 @@ def load_trajectory_file(
             }
         )
 
-    if path.suffix.lower() == ".jsonl":
+    if path.suffix.lower() == ".trjb":
+        for record in iter_records(path):
+            _add_points(
+                record["stamp_ns"] * 1e-9,
+                np.asarray(record["x"], dtype=np.float64),
+                np.asarray(record["y"], dtype=np.float64),
+                np.asarray(record["longitudinal_velocity_mps"], dtype=np.float64),
+                np.asarray(record["time_from_start"], dtype=np.float64),
+            )
+    elif path.suffix.lower() == ".jsonl":
         with path.open() as f:
             for line in f:
                 line = line.strip()
@@ -551,7 +566,7 @@ def _parse_scenario(value: str) -> int:
 def parse_args() -> argparse.Namespace:
     parser = argparse.ArgumentParser(description="Plot Lanelet2 map with trajectory points (scatter).")
     parser.add_argument("--lanelet-osm", required=True, type=Path, help="Path to lanelet2 OSM file.")
-    parser.add_argument("--trajectory-file", required=True, type=Path, help="Path to trajectory JSON/JSONL file.")
+    parser.add_argument("--trajectory-file", required=True, type=Path, help="Path to trajectory JSON/JSONL/.trjb file.")
     parser.add_argument("--origin-lat", type=float, default=None, help="Origin latitude for ENU frame.")
     parser.add_argument("--origin-lon", type=float, default=None, help="Origin longitude for ENU frame.")
     parser.add_argument("--dx", type=float, default=0.0, help="Offset (meters) to add to trajectory x.")